@@ -1,5 +1,10 @@
 #include "SATComponent.h"
 #include <gtx\norm.hpp>
+#include <algorithm>
+
+#if SAT_SIMD_AVX || SAT_SIMD_SSE
+#include <immintrin.h>
+#endif
 
 namespace SAT
 {
@@ -15,6 +20,109 @@ namespace SAT
 	}
 
 	/*static*/ bool Shape::CollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV)
+	{
+		//Same axes in the same order as CollisionTest_Reference, so the resulting MTV is identical. The difference is that
+		//face normals and edge vectors come from the per-shape caches, and axes are staged in a fixed size stack buffer
+		//instead of a vector sized for every edge x edge pair; nothing here touches the heap.
+		using glm::vec4; using glm::vec3;
+
+		vec3 mtv(0.0f);		//mtv = minimum translation vector to get out of collision
+		vec3 stagedAxes[axisBatchSize];
+		size_t numStaged = 0;
+
+		//stages an axis; once the buffer is full the batch is tested. Returns false if a separating axis was found.
+		auto stageAxis = [&](const vec3& axis) -> bool
+		{
+			stagedAxes[numStaged++] = axis;
+			if (numStaged == axisBatchSize)
+			{
+				numStaged = 0;
+				return testStagedAxes(stagedAxes, axisBatchSize, moving, stationary, mtv);
+			}
+			return true;
+		};
+
+		bool bSeparated = false;
+		for (size_t faceIdx = 0; faceIdx < moving.cachedFaceAxes.size() && !bSeparated; ++faceIdx)
+		{
+			bSeparated = !stageAxis(moving.cachedFaceAxes[faceIdx]);
+		}
+		for (size_t faceIdx = 0; faceIdx < stationary.cachedFaceAxes.size() && !bSeparated; ++faceIdx)
+		{
+			bSeparated = !stageAxis(stationary.cachedFaceAxes[faceIdx]);
+		}
+		for (size_t movEdgeIdx = 0; movEdgeIdx < moving.cachedEdgeVectors.size() && !bSeparated; ++movEdgeIdx)
+		{
+			const vec3& movEdge = moving.cachedEdgeVectors[movEdgeIdx];
+			for (size_t statEdgeIdx = 0; statEdgeIdx < stationary.cachedEdgeVectors.size() && !bSeparated; ++statEdgeIdx)
+			{
+				//direction of cross product doesn't matter; projections will be consistent
+				vec3 axis = glm::normalize(glm::cross(movEdge, stationary.cachedEdgeVectors[statEdgeIdx]));
+				if (!isnan(axis.x) && !isnan(axis.y) && !isnan(axis.z))
+				{
+					bSeparated = !stageAxis(axis);
+				}
+			}
+		}
+		bSeparated = bSeparated || !testStagedAxes(stagedAxes, numStaged, moving, stationary, mtv);
+
+		if (bSeparated)
+		{
+			outMTV = vec4(0.0f);
+			return false;
+		}
+
+		outMTV = vec4(mtv, 0.0f);
+		outMTV *= floatMTVCorrectionFactor;
+		return true;
+	}
+
+	/*static*/ bool Shape::testStagedAxes(const glm::vec3* normalizedAxes, size_t numAxes, const Shape& moving, const Shape& stationary, glm::vec3& inOutMTV)
+	{
+		static_assert(axisBatchSize == 8, "staged axes are projected with projectToAxes8");
+		if (numAxes == 0)
+		{
+			return true;
+		}
+
+		//pad a partial batch with the last axis; the padded results are ignored
+		glm::vec3 paddedAxes[axisBatchSize];
+		for (size_t axisIdx = 0; axisIdx < axisBatchSize; ++axisIdx)
+		{
+			paddedAxes[axisIdx] = normalizedAxes[axisIdx < numAxes ? axisIdx : numAxes - 1];
+		}
+
+		ProjectionRanges8 movingRanges;
+		ProjectionRanges8 stationaryRanges;
+		moving.projectToAxes8(paddedAxes, movingRanges);
+		stationary.projectToAxes8(paddedAxes, stationaryRanges);
+
+		for (size_t axisIdx = 0; axisIdx < numAxes; ++axisIdx)
+		{
+			const glm::vec3& axis = normalizedAxes[axisIdx];
+			SAT::ProjectionRange movProj; movProj.min = movingRanges.min[axisIdx]; movProj.max = movingRanges.max[axisIdx];
+			SAT::ProjectionRange staProj; staProj.min = stationaryRanges.min[axisIdx]; staProj.max = stationaryRanges.max[axisIdx];
+
+			bool disjoint = movProj.max < staProj.min || staProj.max < movProj.min;
+			if (disjoint)
+			{
+				return false;
+			}
+
+			glm::vec3 candidateMTV = calculateMinimumTranslationVec(axis, movProj, staProj);
+			float newMTVLength2 = glm::length2(candidateMTV);
+			float oldMTVLength2 = glm::length2(inOutMTV);
+
+			//float zero comparision should be safe in this case; it is just to catch first MTV
+			if (newMTVLength2 < oldMTVLength2 || oldMTVLength2 == 0.0f)
+			{
+				inOutMTV = candidateMTV;
+			}
+		}
+		return true;
+	}
+
+	/*static*/ bool Shape::CollisionTest_Reference(const Shape& moving, const Shape& stationary, glm::vec4& outMTV)
 	{
 		//SAT collision test. 3d SAT requires not only the faces of the shape be tested, but
 		//also to test edge x edge pairs. Below you will see we get axes for faces and edgexedge pairs.
@@ -87,6 +195,10 @@ namespace SAT
 				transformedPoints[faceIdx.edge2.indexB]
 			);
 		}
+
+		cachedFaceAxes.resize(faces.size());
+		cachedEdgeVectors.resize(edges.size());
+		updateCachedAxes();
 	}
 
 	void Shape::updateTransform(const glm::mat4& inTransform)
@@ -102,6 +214,27 @@ namespace SAT
 			transformedPoints[pnt] = transform * localPoints[pnt];
 		}
 		transformedOrigin = transform * localOrigin;
+		updateCachedAxes();
+	}
+
+	void Shape::updateCachedAxes()
+	{
+		using glm::vec3; using glm::vec4;
+
+		//must stay in sync with the math in appendFaceAxes and appendEdgeXEdgeAxes so cached results are bit-identical
+		for (size_t faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+		{
+			const FaceRef& face = faces[faceIdx];
+			vec4 e1 = face.edge1.pntA - face.edge1.pntB;
+			vec4 e2 = face.edge2.pntA - face.edge2.pntB;
+			cachedFaceAxes[faceIdx] = glm::normalize(glm::cross(vec3(e1), vec3(e2)));
+		}
+
+		for (size_t edgeIdx = 0; edgeIdx < edges.size(); ++edgeIdx)
+		{
+			const EdgeRef& edge = edges[edgeIdx];
+			cachedEdgeVectors[edgeIdx] = vec3(edge.pntA - edge.pntB);
+		}
 	}
 
 	void Shape::appendFaceAxes(std::vector<glm::vec3>& outAxes) const
@@ -155,6 +288,127 @@ namespace SAT
 		return projRange;
 	}
 
+	/*static*/ const char* Shape::getBatchProjectionInstructionSet()
+	{
+#if SAT_SIMD_AVX
+		return "AVX";
+#elif SAT_SIMD_SSE
+		return "SSE";
+#else
+		return "scalar";
+#endif
+	}
+
+	//The kernels below compute dot(point, axis) as (x*ax + y*ay) + z*az, the same order glm::dot uses, and update min/max with the
+	//same comparisons as projectToAxis; so each lane is bit-identical to the scalar projection (assuming no FMA contraction).
+	void Shape::projectToAxes4(const glm::vec3* normalizedAxes, ProjectionRanges4& outRanges) const
+	{
+#if SAT_SIMD_SSE
+		const __m128 axisX = _mm_setr_ps(normalizedAxes[0].x, normalizedAxes[1].x, normalizedAxes[2].x, normalizedAxes[3].x);
+		const __m128 axisY = _mm_setr_ps(normalizedAxes[0].y, normalizedAxes[1].y, normalizedAxes[2].y, normalizedAxes[3].y);
+		const __m128 axisZ = _mm_setr_ps(normalizedAxes[0].z, normalizedAxes[1].z, normalizedAxes[2].z, normalizedAxes[3].z);
+
+		__m128 minProj = _mm_set1_ps(std::numeric_limits<float>::infinity());
+		__m128 maxProj = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+
+		for (const glm::vec4& pnt : transformedPoints)
+		{
+			__m128 projection = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(pnt.x), axisX), _mm_mul_ps(_mm_set1_ps(pnt.y), axisY)),
+				_mm_mul_ps(_mm_set1_ps(pnt.z), axisZ)
+			);
+
+			//operand order matters for NaN handling; max_ps(a, b) is "a > b ? a : b", matching the scalar path
+			maxProj = _mm_max_ps(maxProj, projection);
+			minProj = _mm_min_ps(minProj, projection);
+		}
+
+		_mm_store_ps(outRanges.min, minProj);
+		_mm_store_ps(outRanges.max, maxProj);
+#else
+		projectToAxesScalar(normalizedAxes, 4, outRanges.min, outRanges.max);
+#endif
+	}
+
+	void Shape::projectToAxes8(const glm::vec3* normalizedAxes, ProjectionRanges8& outRanges) const
+	{
+#if SAT_SIMD_AVX
+		const __m256 axisX = _mm256_setr_ps(
+			normalizedAxes[0].x, normalizedAxes[1].x, normalizedAxes[2].x, normalizedAxes[3].x,
+			normalizedAxes[4].x, normalizedAxes[5].x, normalizedAxes[6].x, normalizedAxes[7].x);
+		const __m256 axisY = _mm256_setr_ps(
+			normalizedAxes[0].y, normalizedAxes[1].y, normalizedAxes[2].y, normalizedAxes[3].y,
+			normalizedAxes[4].y, normalizedAxes[5].y, normalizedAxes[6].y, normalizedAxes[7].y);
+		const __m256 axisZ = _mm256_setr_ps(
+			normalizedAxes[0].z, normalizedAxes[1].z, normalizedAxes[2].z, normalizedAxes[3].z,
+			normalizedAxes[4].z, normalizedAxes[5].z, normalizedAxes[6].z, normalizedAxes[7].z);
+
+		__m256 minProj = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+		__m256 maxProj = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+
+		for (const glm::vec4& pnt : transformedPoints)
+		{
+			__m256 projection = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(pnt.x), axisX), _mm256_mul_ps(_mm256_set1_ps(pnt.y), axisY)),
+				_mm256_mul_ps(_mm256_set1_ps(pnt.z), axisZ)
+			);
+			maxProj = _mm256_max_ps(maxProj, projection);
+			minProj = _mm256_min_ps(minProj, projection);
+		}
+
+		_mm256_store_ps(outRanges.min, minProj);
+		_mm256_store_ps(outRanges.max, maxProj);
+#elif SAT_SIMD_SSE
+		//without AVX, two SSE batches
+		ProjectionRanges4 lower, upper;
+		projectToAxes4(normalizedAxes, lower);
+		projectToAxes4(normalizedAxes + 4, upper);
+		for (size_t idx = 0; idx < 4; ++idx)
+		{
+			outRanges.min[idx] = lower.min[idx];
+			outRanges.max[idx] = lower.max[idx];
+			outRanges.min[idx + 4] = upper.min[idx];
+			outRanges.max[idx + 4] = upper.max[idx];
+		}
+#else
+		projectToAxesScalar(normalizedAxes, 8, outRanges.min, outRanges.max);
+#endif
+	}
+
+	void Shape::projectToAxes(const glm::vec3* normalizedAxes, size_t numAxes, float* outMins, float* outMaxs) const
+	{
+		size_t axisIdx = 0;
+#if SAT_SIMD_AVX
+		for (; axisIdx + 8 <= numAxes; axisIdx += 8)
+		{
+			ProjectionRanges8 ranges;
+			projectToAxes8(normalizedAxes + axisIdx, ranges);
+			std::copy(ranges.min, ranges.min + 8, outMins + axisIdx);
+			std::copy(ranges.max, ranges.max + 8, outMaxs + axisIdx);
+		}
+#endif
+#if SAT_SIMD_SSE
+		for (; axisIdx + 4 <= numAxes; axisIdx += 4)
+		{
+			ProjectionRanges4 ranges;
+			projectToAxes4(normalizedAxes + axisIdx, ranges);
+			std::copy(ranges.min, ranges.min + 4, outMins + axisIdx);
+			std::copy(ranges.max, ranges.max + 4, outMaxs + axisIdx);
+		}
+#endif
+		projectToAxesScalar(normalizedAxes + axisIdx, numAxes - axisIdx, outMins + axisIdx, outMaxs + axisIdx);
+	}
+
+	void Shape::projectToAxesScalar(const glm::vec3* normalizedAxes, size_t numAxes, float* outMins, float* outMaxs) const
+	{
+		for (size_t axisIdx = 0; axisIdx < numAxes; ++axisIdx)
+		{
+			SAT::ProjectionRange projRange = projectToAxis(normalizedAxes[axisIdx]);
+			outMins[axisIdx] = projRange.min;
+			outMaxs[axisIdx] = projRange.max;
+		}
+	}
+
 	void Shape::overrideLocalOrigin(glm::vec4 newLocalOriginPoint)
 	{
 		localOrigin = newLocalOriginPoint;
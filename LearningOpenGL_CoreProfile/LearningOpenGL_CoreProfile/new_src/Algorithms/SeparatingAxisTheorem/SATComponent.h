@@ -7,6 +7,14 @@
 #include <gtc/matrix_transform.hpp>
 #include <gtc/type_ptr.hpp>
 
+//Instruction set used by Shape::projectToAxes; define SAT_SIMD_SCALAR_ONLY at a project level to force the scalar fallback
+#if !defined(SAT_SIMD_SCALAR_ONLY) && defined(__AVX__)
+#define SAT_SIMD_AVX 1
+#endif
+#if !defined(SAT_SIMD_SCALAR_ONLY) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SAT_SIMD_SSE 1
+#endif
+
 namespace SAT
 {
 
@@ -61,6 +69,16 @@ namespace SAT
 		float max = -std::numeric_limits<float>::infinity();
 	};
 
+	/** Projection intervals for a batch of axes in structure-of-arrays form; min[i] and max[i] belong to the i-th axis */
+	template<size_t NumAxes>
+	struct ProjectionRangeBatch
+	{
+		alignas(32) float min[NumAxes];
+		alignas(32) float max[NumAxes];
+	};
+	using ProjectionRanges4 = ProjectionRangeBatch<4>;
+	using ProjectionRanges8 = ProjectionRangeBatch<8>;
+
 
 	/**
 		Represents a shape (cube, polyhedron capsule, etc.)
@@ -94,6 +112,15 @@ namespace SAT
 		static bool CollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV);
 		static constexpr float floatMTVCorrectionFactor = 1.1f;
 
+		/**
+			Original collision test that derives every axis from the transformed points and gathers them into a heap vector.
+			CollisionTest produces identical results without allocating; this is kept as the reference it is validated against.
+		*/
+		static bool CollisionTest_Reference(const Shape& moving, const Shape& stationary, glm::vec4& outMTV);
+
+		/** Number of axes CollisionTest stages in its stack buffer before projecting them. */
+		static constexpr size_t axisBatchSize = 8;
+
 	public: //members
 		Shape(
 			const std::vector<glm::vec4>& inLocalPoints, 
@@ -106,6 +133,19 @@ namespace SAT
 		static void appendEdgeXEdgeAxes(const Shape& moving, const Shape& stationary, std::vector<glm::vec3>& normalizedAxes);
 		SAT::ProjectionRange projectToAxis(const glm::vec3& normalizedAxis) const;
 
+		/**
+			Projects the transformed points onto several axes in one pass over the points. Results match projectToAxis for each axis.
+			The fixed size variants read exactly 4 or 8 axes; the general variant handles any count, using the widest kernel available.
+		*/
+		void projectToAxes4(const glm::vec3* normalizedAxes, ProjectionRanges4& outRanges) const;
+		void projectToAxes8(const glm::vec3* normalizedAxes, ProjectionRanges8& outRanges) const;
+		void projectToAxes(const glm::vec3* normalizedAxes, size_t numAxes, float* outMins, float* outMaxs) const;
+		static const char* getBatchProjectionInstructionSet();
+
+		/** World space axes; refreshed whenever the transform is applied */
+		const std::vector<glm::vec3>& getCachedFaceAxes() const { return cachedFaceAxes; }
+		const std::vector<glm::vec3>& getCachedEdgeVectors() const { return cachedEdgeVectors; }
+
 		/* Not provided in ctor because normally the origin will be at the center of shapes; see default value*/
 		void overrideLocalOrigin(glm::vec4 newLocalOriginPoint);
 		glm::vec4 getTransformedOrigin() const { return transformedOrigin; }
@@ -114,6 +154,13 @@ namespace SAT
 		/** INVARIANT: Unit Axis is a normalized vector;INVARIANT: The two projections are not disjoint	*/
 		static glm::vec3 calculateMinimumTranslationVec(const glm::vec3& unitAxis, const SAT::ProjectionRange& movingProj, const SAT::ProjectionRange& stationaryProj);
 
+		/** Projects both shapes onto the axes; returns false on the first separating axis, otherwise keeps the shortest MTV in inOutMTV. */
+		static bool testStagedAxes(const glm::vec3* normalizedAxes, size_t numAxes, const Shape& moving, const Shape& stationary, glm::vec3& inOutMTV);
+
+		void updateCachedAxes();
+
+		void projectToAxesScalar(const glm::vec3* normalizedAxes, size_t numAxes, float* outMins, float* outMaxs) const;
+
 	public: //debugging helpers; provided to allow visualization of collision shapes as points and visual unique edges/faces
 		/** The following are debug methods are debug methods and not intended for normal SAT usage*/
 		const std::vector<glm::vec4>& getTransformedPoints() const { return transformedPoints; };
@@ -138,6 +185,9 @@ namespace SAT
 		std::vector<FaceRef> faces;
 		std::vector<EdgeRef> edges;
 
+		//derived from faces and edges every time the transform is applied; sized once in ctor so updates never allocate
+		std::vector<glm::vec3> cachedFaceAxes;		//normalized face normals
+		std::vector<glm::vec3> cachedEdgeVectors;	//not normalized; edge x edge axes are normalized after the cross product
 	};
 
 
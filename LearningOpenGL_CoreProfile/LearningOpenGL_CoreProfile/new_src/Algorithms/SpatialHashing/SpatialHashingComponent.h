@@ -7,6 +7,8 @@
 #define HASH_MAP_UNORDERED_MULTIMAP 1
 #define HASH_MAP_UNORDERED_SET 0
 #define HASH_MAP_MANUAL_HASH_ARRAY 0
+//FlatSpatialHashGrid is the open addressing alternative; its nodes are pooled and referred to by handle rather than
+//shared_ptr, which changes the lookup signatures -- so it is a sibling class rather than another switch above.
 
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
@@ -26,6 +28,9 @@
 #include <cstdint>
 #include <array>
 #include <limits>
+#include <algorithm>
+#include <cassert>
+#include <functional>
 
 namespace SH
 {
@@ -91,6 +96,7 @@ namespace SH
 		Acceleration structure within lookup functions to prevent adding duplicates
 			-requires scenario where single object uses multiple cells
 			results: not tested
+			-findAllOverlappingPairs sidesteps this for broadphase by only letting the first shared cell report a pair
 		
 	*/
 
@@ -128,6 +134,10 @@ namespace SH
 		return !(lhs == rhs);
 	}
 
+	/** Free functions so that alternative backing stores can map OBBs and locations exactly like SpatialHashGrid does */
+	inline uint64_t hashCellLocation(const glm::ivec3& location);
+	inline void projectOBBToCellRanges(const glm::vec3& gridCellSize, Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB);
+
 	template<typename T>
 	struct GridNode
 	{
@@ -135,6 +145,14 @@ namespace SH
 
 		//provided to help shared pointer construction
 		GridNode(T& inElement) : element(inElement) {}
+
+	private:
+		friend SpatialHashGrid<T>;
+
+		/** Mirrors the owning HashEntry's cells; lets pair queries decide which shared cell is responsible for reporting a pair */
+		Range<int> xGridCells;
+		Range<int> yGridCells;
+		Range<int> zGridCells;
 	};
 
 	/**
@@ -196,6 +214,21 @@ namespace SH
 		std::list<std::shared_ptr<GridNode<T>>> nodeBucket;
 	};
 
+	/** Line segment for batched line queries; in the grid's local space */
+	struct LineSegment
+	{
+		glm::vec3 start;
+		glm::vec3 end;
+	};
+
+	/** An element that occupies at least one cell a segment passes through; segmentIdx indexes the queried segments */
+	template<typename T>
+	struct LineSegmentCandidate
+	{
+		T* element;
+		uint32_t segmentIdx;
+	};
+
 
 	template<typename T>
 	class SpatialHashGrid : public RemoveCopies, public RemoveMoves
@@ -229,6 +262,22 @@ namespace SH
 
 		inline void findCellLocationsForLine(const glm::vec3& start_hashLocalSpace, const glm::vec3& end_hashLocalSpace, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias = 0.01f);
 		inline void lookupCellsForLine(const glm::vec3& start_hashLocalSpace, const glm::vec3& end_hashLocalSpace, std::vector<std::shared_ptr<const SH::HashCell<T>>>& outCells);
+
+		/**
+		* Batched version of lookupCellsForLine for many segments at once. Every segment is rasterized with findCellLocationsForLine,
+		* the touched cells are sorted so each occupied cell is looked up once, and each (element, segment) pair is reported once even
+		* if the segment passes through several of the element's cells. outCandidates is sorted by element and then by segment, so callers
+		* can fetch per-element data once and test every segment that reached that element together.
+		*/
+		inline void lookupNodesForLines(const std::vector<LineSegment>& segments_hashLocalSpace, std::vector<LineSegmentCandidate<T>>& outCandidates);
+
+		/** 
+		* Broadphase: single sweep over occupied cells that reports every pair of entries sharing at least one cell exactly once.
+		* A pair is only reported by the first cell (lowest x,y,z) of the overlap of the two entries' cell ranges, so entries
+		* spanning many cells do not produce duplicates and no visited set is needed. outPairs is cleared but keeps its capacity,
+		* so reusing the same vector between frames does not allocate.
+		*/
+		inline void findAllOverlappingPairs(std::vector<std::pair<T*, T*>>& outPairs);
 		inline void logDebugInformation();
 
 	private: //methods
@@ -242,6 +291,10 @@ namespace SH
 
 		inline uint64_t hash(glm::ivec3 location);
 		inline void hashInsert(std::shared_ptr<GridNode<T>>& gridNode, glm::ivec3 hashLocation);
+		inline void setNodeCells(GridNode<T>& gridNode, const Range<int>& xCellIndices, const Range<int>& yCellIndices, const Range<int>& zCellIndices);
+		inline bool ownsPair(const glm::ivec3& cellLocation, const GridNode<T>& a, const GridNode<T>& b);
+		template<typename Fn>
+		inline void forEachOccupiedCell(Fn&& visitCell);
 		inline bool hashRemove(const std::shared_ptr<GridNode<T>>& gridNode, glm::ivec3 hashLocation);
 		inline std::shared_ptr<SH::HashCell<T>> findCellForHash(uint64_t hashValue, const glm::ivec3& hashLocation);
 
@@ -249,6 +302,15 @@ namespace SH
 		const glm::vec3 gridCellSize;
 
 	private: //variables
+		/** scratch buffers for lookupNodesForLines; kept between calls so that batched queries stop allocating once warmed up */
+		struct LineCellRef
+		{
+			glm::ivec3 cell;
+			uint32_t segmentIdx;
+		};
+		std::vector<glm::ivec3> lineCellScratch;
+		std::vector<LineCellRef> lineCellRefScratch;
+
 		/** 
 		 * Remaining valid hash entries to invalidate if spatial hash is destroyed before the entries are released. Ideally this shouldn't happen, but in order to provide the simplest interface -- this behavior is allowed.
 		 * The HashEntries need to be unique pointers so that proper resource clean up occurs; having entries as unique pointers means that we cannot have validEntries use smart pointer to the entries
@@ -269,6 +331,166 @@ namespace SH
 #endif
 	};
 
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Flat open addressing backing store
+	//
+	// Cells live in a single open addressed (linear probing) array instead of buckets of shared_ptr cells.
+	// Grid nodes live in a pooled arena and are referred to by index; the nodes within a cell are an intrusive 
+	// linked list threaded through a second pooled arena of links. Once the pools have grown to the working set,
+	// insert/updateEntry/remove do not touch the heap and do not bump any reference counts.
+	////////////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	class FlatSpatialHashGrid;
+
+	constexpr uint32_t FLAT_SH_INVALID_IDX = std::numeric_limits<uint32_t>::max();
+
+	/** Handle into the node arena; generation is bumped whenever a slot is recycled so stale handles can be detected */
+	struct FlatNodeHandle
+	{
+		uint32_t index = FLAT_SH_INVALID_IDX;
+		uint32_t generation = 0;
+	};
+
+	template<typename T>
+	struct FlatHashEntry;
+
+	template<typename T>
+	struct PooledGridNode
+	{
+		T* element = nullptr;
+		FlatHashEntry<T>* entry = nullptr;			//used to invalidate entries if the grid is destroyed first
+		uint32_t generation = 0;
+		uint32_t nextFree = FLAT_SH_INVALID_IDX;
+		uint32_t queryStamp = 0;					//equal to the grid's stamp when the current lookup has already gathered this node
+	};
+
+	struct FlatCellLink
+	{
+		uint32_t node = FLAT_SH_INVALID_IDX;
+		uint32_t next = FLAT_SH_INVALID_IDX;		//next link in the cell, or the next free link while pooled
+	};
+
+	enum class FlatCellState : uint8_t { EMPTY, OCCUPIED, TOMBSTONE };
+
+	struct FlatHashCell
+	{
+		glm::ivec3 location = glm::ivec3(0);
+		uint32_t firstLink = FLAT_SH_INVALID_IDX;
+		uint32_t numNodes = 0;
+		FlatCellState state = FlatCellState::EMPTY;
+	};
+
+	/** Same RAII contract as HashEntry; destroying the entry removes it from the grid. */
+	template<typename T>
+	struct FlatHashEntry final : public RemoveCopies, public RemoveMoves
+	{
+		T& getElement() { return element; }
+		const FlatNodeHandle getNodeHandle() { return nodeHandle; }
+
+		const Range<int> getXGridCells() { return xGridCells; }
+		const Range<int> getYGridCells() { return yGridCells; }
+		const Range<int> getZGridCells() { return zGridCells; }
+
+		FlatSpatialHashGrid<T>& owningGrid;
+
+		~FlatHashEntry()
+		{
+			if (gridValid)
+			{
+				owningGrid.remove(*this);
+			}
+#ifdef LOG_LIFETIME_ERRORS
+			else
+			{
+				std::cerr << "Flat hash entry outlived spatial hash; this is probably an error as it requires slow clean up." << std::endl;
+			}
+#endif // LOG_LIFETIME_ERRORS
+		}
+
+	private:
+		/* Only allow the spatial hash grid to instantiate these objects for clean resource clean up.*/
+		friend FlatSpatialHashGrid<T>;
+
+		FlatHashEntry(
+			T& inElement, const FlatNodeHandle& inNodeHandle,
+			const Range<int>& inXGridCells, const Range<int>& inYGridCells, const Range<int>& inZGridCells,
+			FlatSpatialHashGrid<T>& inOwningGrid
+		) :
+			owningGrid(inOwningGrid), element(inElement), nodeHandle(inNodeHandle),
+			xGridCells(inXGridCells), yGridCells(inYGridCells), zGridCells(inZGridCells)
+		{ }
+
+		//only FlatSpatialHashGrid should be able to modify the below
+		T& element;
+		FlatNodeHandle nodeHandle;
+		Range<int> xGridCells;
+		Range<int> yGridCells;
+		Range<int> zGridCells;
+		bool gridValid = true;
+	};
+
+	template<typename T>
+	class FlatSpatialHashGrid : public RemoveCopies, public RemoveMoves
+	{
+	public: //methods
+		FlatSpatialHashGrid(const glm::vec3& inGridCellSize, std::size_t estimatedNumCells = 10000, std::size_t estimatedNumNodes = 1000);
+		~FlatSpatialHashGrid();
+
+		/** see SpatialHashGrid::insert; the returned entry removes itself from the grid when destroyed */
+		std::unique_ptr<FlatHashEntry<T>> insert(T& obj, const std::array<glm::vec4, 8>& OBB_hashLocalSpace);
+
+		/** only does re-hashing if there is change in cell contents */
+		void updateEntry(std::unique_ptr<FlatHashEntry<T>>& entry, const std::array<glm::vec4, 8>& newLocalSpaceOBB);
+
+		/** Each element is reported once even if it shares many cells with the source; duplicates are filtered with a stamp on the pooled node rather than a temporary set */
+		inline void lookupNodesInCells(const FlatHashEntry<T>& cellSource, std::vector<T*>& outElements, bool filterOutSource = true);
+		inline void lookupNodesForOOB(const std::array<glm::vec4, 8>& OBB_hashLocalSpace, std::vector<T*>& outElements);
+		inline void lookupCellsForEntry(const FlatHashEntry<T>& cellSource, std::vector<glm::ivec3>& outCellLocations);
+
+		std::size_t getNumOccupiedCells() const { return numOccupiedCells; }
+		std::size_t getNumLiveNodes() const { return numLiveNodes; }
+		inline void logDebugInformation();
+
+	private: //methods
+		/*give FlatHashEntry access to remove function*/
+		friend FlatHashEntry<T>::~FlatHashEntry();
+		inline void remove(FlatHashEntry<T>& toRemove);
+
+		inline uint32_t allocateNode(T& obj);
+		inline void releaseNode(uint32_t nodeIdx);
+		inline uint32_t allocateLink();
+		inline void releaseLink(uint32_t linkIdx);
+
+		inline std::size_t probeStart(const glm::ivec3& location) const;
+		inline uint32_t findCell(const glm::ivec3& location) const;
+		inline uint32_t findOrAddCell(const glm::ivec3& location);
+		inline void rehashCells(std::size_t newCapacity);
+
+		inline void hashInsert(uint32_t nodeIdx, const glm::ivec3& location);
+		inline bool hashRemove(uint32_t nodeIdx, const glm::ivec3& location);
+
+		inline void beginQuery();
+		inline void gatherCellNodes(uint32_t cellIdx, std::vector<T*>& outElements, const T* filterElement);
+
+	public: //variables
+		const glm::vec3 gridCellSize;
+
+	private: //variables
+		/** open addressed cell table; size is always a power of 2 so probing can mask rather than mod */
+		std::vector<FlatHashCell> cells;
+		std::size_t numOccupiedCells = 0;
+		std::size_t numTombstones = 0;
+
+		std::vector<PooledGridNode<T>> nodes;
+		uint32_t firstFreeNode = FLAT_SH_INVALID_IDX;
+		std::size_t numLiveNodes = 0;
+
+		std::vector<FlatCellLink> links;
+		uint32_t firstFreeLink = FLAT_SH_INVALID_IDX;
+
+		uint32_t queryStamp = 0;
+	};
+
 
 
 
@@ -398,8 +620,8 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 
-	template<typename T>
-	inline uint64_t SpatialHashGrid<T>::hash(glm::ivec3 location)
+	/** Shared by every backing store so that cell locations always hash identically */
+	inline uint64_t hashCellLocation(const glm::ivec3& location)
 	{
 		uint32_t x = static_cast<uint32_t>(location.x);
 		uint32_t y = static_cast<uint32_t>(location.y);
@@ -417,6 +639,12 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 		return hash;
 	}
 
+	template<typename T>
+	inline uint64_t SpatialHashGrid<T>::hash(glm::ivec3 location)
+	{
+		return hashCellLocation(location);
+	}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -681,6 +909,7 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 		projectOBBToCells(xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
 
 		std::shared_ptr<GridNode<T>> gridNode = std::make_shared< GridNode<T> >(obj);
+		setNodeCells(*gridNode, xCellIndices, yCellIndices, zCellIndices);
 
 		//the following doesn't use std::make_unique due to complexities around friending
 		//std::make_unique since the constructor is private; it is far simpler to do it this way
@@ -722,6 +951,7 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 			entry->xGridCells = xCellIndices;
 			entry->yGridCells = yCellIndices;
 			entry->zGridCells = zCellIndices;
+			setNodeCells(*entry->insertedNode, xCellIndices, yCellIndices, zCellIndices);
 
 			BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
 						hashInsert(entry->insertedNode, { cellX, cellY, cellZ });
@@ -1092,6 +1322,149 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 		}
 	}
 
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void SpatialHashGrid<T>::lookupNodesForLines(const std::vector<LineSegment>& segments, std::vector<LineSegmentCandidate<T>>& outCandidates)
+	{
+		outCandidates.clear();
+		lineCellRefScratch.clear();
+
+		//rasterize every segment into (cell, segment) references
+		for (uint32_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx)
+		{
+			lineCellScratch.clear();
+			findCellLocationsForLine(segments[segmentIdx].start, segments[segmentIdx].end, lineCellScratch);
+			for (const glm::ivec3& cell : lineCellScratch)
+			{
+				lineCellRefScratch.push_back({ cell, segmentIdx });
+			}
+		}
+
+		//group references by cell so that each cell is hashed and walked once for all the segments that pass through it
+		std::sort(lineCellRefScratch.begin(), lineCellRefScratch.end(),
+			[](const LineCellRef& a, const LineCellRef& b)
+			{
+				if (a.cell.x != b.cell.x) { return a.cell.x < b.cell.x; }
+				if (a.cell.y != b.cell.y) { return a.cell.y < b.cell.y; }
+				if (a.cell.z != b.cell.z) { return a.cell.z < b.cell.z; }
+				return a.segmentIdx < b.segmentIdx;
+			}
+		);
+
+		size_t groupStart = 0;
+		while (groupStart < lineCellRefScratch.size())
+		{
+			const glm::ivec3 cellLocation = lineCellRefScratch[groupStart].cell;
+			size_t groupEnd = groupStart + 1;
+			while (groupEnd < lineCellRefScratch.size() && lineCellRefScratch[groupEnd].cell == cellLocation)
+			{
+				++groupEnd;
+			}
+
+			if (std::shared_ptr<const SH::HashCell<T>> cell = findCellForHash(hash(cellLocation), cellLocation))
+			{
+				for (const std::shared_ptr<GridNode<T>>& node : cell->nodeBucket)
+				{
+					for (size_t refIdx = groupStart; refIdx < groupEnd; ++refIdx)
+					{
+						outCandidates.push_back({ &node->element, lineCellRefScratch[refIdx].segmentIdx });
+					}
+				}
+			}
+			groupStart = groupEnd;
+		}
+
+		//an element spanning several cells along one segment shows up once per cell; sort by element so duplicates are adjacent
+		std::sort(outCandidates.begin(), outCandidates.end(),
+			[](const LineSegmentCandidate<T>& a, const LineSegmentCandidate<T>& b)
+			{
+				return std::less<T*>()(a.element, b.element) || (a.element == b.element && a.segmentIdx < b.segmentIdx);
+			}
+		);
+		outCandidates.erase(
+			std::unique(outCandidates.begin(), outCandidates.end(),
+				[](const LineSegmentCandidate<T>& a, const LineSegmentCandidate<T>& b) { return a.element == b.element && a.segmentIdx == b.segmentIdx; }
+			),
+			outCandidates.end()
+		);
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void SpatialHashGrid<T>::findAllOverlappingPairs(std::vector<std::pair<T*, T*>>& outPairs)
+	{
+		outPairs.clear();
+
+		forEachOccupiedCell([&](const HashCell<T>& cell) {
+			using ListIter = typename decltype(cell.nodeBucket)::const_iterator;
+			for (ListIter nodeA_i = cell.nodeBucket.begin(); nodeA_i != cell.nodeBucket.end(); ++nodeA_i)
+			{
+				for (ListIter nodeB_i = std::next(nodeA_i); nodeB_i != cell.nodeBucket.end(); ++nodeB_i)
+				{
+					//ref to avoid touching shared_ptr reference counts
+					GridNode<T>& nodeA = **nodeA_i;
+					GridNode<T>& nodeB = **nodeB_i;
+					if (ownsPair(cell.location, nodeA, nodeB))
+					{
+						outPairs.emplace_back(&nodeA.element, &nodeB.element);
+					}
+				}
+			}
+		});
+	}
+
+	template<typename T>
+	bool SpatialHashGrid<T>::ownsPair(const glm::ivec3& cellLocation, const GridNode<T>& a, const GridNode<T>& b)
+	{
+		//both nodes are in this cell, so the overlap of their cell ranges is non-empty; its min corner is the one cell that reports the pair
+		glm::ivec3 firstSharedCell(
+			std::max(a.xGridCells.min, b.xGridCells.min),
+			std::max(a.yGridCells.min, b.yGridCells.min),
+			std::max(a.zGridCells.min, b.zGridCells.min)
+		);
+		return firstSharedCell == cellLocation;
+	}
+
+	template<typename T>
+	void SpatialHashGrid<T>::setNodeCells(GridNode<T>& gridNode, const Range<int>& xCellIndices, const Range<int>& yCellIndices, const Range<int>& zCellIndices)
+	{
+		gridNode.xGridCells = xCellIndices;
+		gridNode.yGridCells = yCellIndices;
+		gridNode.zGridCells = zCellIndices;
+	}
+
+	template<typename T>
+	template<typename Fn>
+	void SpatialHashGrid<T>::forEachOccupiedCell(Fn&& visitCell)
+	{
+#if HASH_MAP_UNORDERED_MULTIMAP
+		for (auto& hashAndCell : hashMap)
+		{
+			visitCell(*hashAndCell.second);
+		}
+#elif HASH_MAP_UNORDERED_SET
+		for (auto& hashAndBucket : hashMap)
+		{
+			for (std::shared_ptr<HashCell<T>>& cell : hashAndBucket.second)
+			{
+				visitCell(*cell);
+			}
+		}
+#elif HASH_MAP_MANUAL_HASH_ARRAY
+		for (auto& bucket : hashMap)
+		{
+			for (std::shared_ptr<HashCell<T>>& cell : bucket)
+			{
+				visitCell(*cell);
+			}
+		}
+#endif
+	}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -1150,6 +1523,11 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 ///////////////////////////////////////////////////////////////////////////////////////
 	template<typename T>
 	inline void SpatialHashGrid<T>::projectOBBToCells(Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB)
+	{
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
+	}
+
+	inline void projectOBBToCellRanges(const glm::vec3& gridCellSize, Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB)
 	{
 		//__project points onto grid cell axes__
 		Range<float> xProjRange, yProjRange, zProjRange;
@@ -1222,6 +1600,424 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+/// function implementations for flat open addressing spatial hash
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	FlatSpatialHashGrid<T>::FlatSpatialHashGrid(const glm::vec3& inGridCellSize, std::size_t estimatedNumCells, std::size_t estimatedNumNodes)
+		: gridCellSize(inGridCellSize)
+	{
+		//keep estimated number of cells under half load so probe chains stay short
+		std::size_t capacity = 16;
+		while (capacity < estimatedNumCells * 2) { capacity <<= 1; }
+		cells.resize(capacity);
+
+		nodes.reserve(estimatedNumNodes);
+		links.reserve(estimatedNumNodes * 8); //assume an average node covers a 2x2x2 block of cells
+	}
+
+	template<typename T>
+	FlatSpatialHashGrid<T>::~FlatSpatialHashGrid()
+	{
+		//Same contract as SpatialHashGrid; entries should not outlive the grid, but this is tolerated.
+		if (numLiveNodes > 0)
+		{
+#ifdef LOG_LIFETIME_ERRORS
+			std::cerr << "WARNING: flat spatial hash was outlived by " << numLiveNodes << " entries; this is likely a design issue" << std::endl;
+#endif // LOG_LIFETIME_ERRORS
+			for (PooledGridNode<T>& node : nodes)
+			{
+				if (node.element && node.entry)
+				{
+					node.entry->gridValid = false;
+				}
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	std::unique_ptr<FlatHashEntry<T>> FlatSpatialHashGrid<T>::insert(T& obj, const std::array<glm::vec4, 8>& localSpaceOBB)
+	{
+		Range<int> xCellIndices, yCellIndices, zCellIndices;
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
+
+		uint32_t nodeIdx = allocateNode(obj);
+		FlatNodeHandle handle{ nodeIdx, nodes[nodeIdx].generation };
+
+		std::unique_ptr<FlatHashEntry<T>> hashEntry = std::unique_ptr<FlatHashEntry<T>>(
+			new FlatHashEntry<T>(obj, handle, xCellIndices, yCellIndices, zCellIndices, *this)
+			);
+		nodes[nodeIdx].entry = hashEntry.get();
+
+		BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+				hashInsert(nodeIdx, { cellX, cellY, cellZ });
+		END_FOR_EVERY_CELL
+
+		return hashEntry;
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::updateEntry(std::unique_ptr<FlatHashEntry<T>>& entry, const std::array<glm::vec4, 8>& newLocalSpaceOBB)
+	{
+		assert(&entry->owningGrid == this);
+		if (&entry->owningGrid != this)
+		{
+			return;
+		}
+
+		Range<int> xCellIndices, yCellIndices, zCellIndices;
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, newLocalSpaceOBB);
+
+		//only update if there is a change in the occupied cells
+		if (xCellIndices != entry->xGridCells || yCellIndices != entry->yGridCells || zCellIndices != entry->zGridCells)
+		{
+			const uint32_t nodeIdx = entry->nodeHandle.index;
+			assert(nodes[nodeIdx].generation == entry->nodeHandle.generation);
+
+			BEGIN_FOR_EVERY_CELL(entry->xGridCells, entry->yGridCells, entry->zGridCells)
+					hashRemove(nodeIdx, { cellX, cellY, cellZ });
+			END_FOR_EVERY_CELL
+
+			entry->xGridCells = xCellIndices;
+			entry->yGridCells = yCellIndices;
+			entry->zGridCells = zCellIndices;
+
+			BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+					hashInsert(nodeIdx, { cellX, cellY, cellZ });
+			END_FOR_EVERY_CELL
+		}
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::remove(FlatHashEntry<T>& toRemove)
+	{
+		const uint32_t nodeIdx = toRemove.nodeHandle.index;
+		assert(nodeIdx < nodes.size() && nodes[nodeIdx].generation == toRemove.nodeHandle.generation);
+
+		BEGIN_FOR_EVERY_CELL(toRemove.xGridCells, toRemove.yGridCells, toRemove.zGridCells)
+				hashRemove(nodeIdx, { cellX, cellY, cellZ });
+		END_FOR_EVERY_CELL
+
+		releaseNode(nodeIdx);
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupNodesInCells(const FlatHashEntry<T>& cellSource, std::vector<T*>& outElements, bool filterOutSource)
+	{
+		outElements.clear();
+		beginQuery();
+
+		const T* filterElement = filterOutSource ? &cellSource.element : nullptr;
+		BEGIN_FOR_EVERY_CELL(cellSource.xGridCells, cellSource.yGridCells, cellSource.zGridCells)
+				uint32_t cellIdx = findCell({ cellX, cellY, cellZ });
+				if (cellIdx != FLAT_SH_INVALID_IDX)
+				{
+					gatherCellNodes(cellIdx, outElements, filterElement);
+				}
+		END_FOR_EVERY_CELL
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupNodesForOOB(const std::array<glm::vec4, 8>& localSpaceOBB, std::vector<T*>& outElements)
+	{
+		outElements.clear();
+		beginQuery();
+
+		Range<int> xCellIndices, yCellIndices, zCellIndices;
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
+
+		BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+				uint32_t cellIdx = findCell({ cellX, cellY, cellZ });
+				if (cellIdx != FLAT_SH_INVALID_IDX)
+				{
+					gatherCellNodes(cellIdx, outElements, nullptr);
+				}
+		END_FOR_EVERY_CELL
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupCellsForEntry(const FlatHashEntry<T>& cellSource, std::vector<glm::ivec3>& outCellLocations)
+	{
+		outCellLocations.clear();
+		BEGIN_FOR_EVERY_CELL(cellSource.xGridCells, cellSource.yGridCells, cellSource.zGridCells)
+				uint32_t cellIdx = findCell({ cellX, cellY, cellZ });
+				if (cellIdx != FLAT_SH_INVALID_IDX)
+				{
+					outCellLocations.push_back(cells[cellIdx].location);
+				}
+		END_FOR_EVERY_CELL
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::logDebugInformation()
+	{
+		std::cout << "cell capacity:" << cells.size() << " occupied:" << numOccupiedCells << " tombstones:" << numTombstones
+			<< " node pool:" << nodes.size() << " live nodes:" << numLiveNodes << " link pool:" << links.size() << std::endl;
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::beginQuery()
+	{
+		++queryStamp;
+		if (queryStamp == 0)
+		{
+			//stamp wrapped around; clear stale stamps so they cannot alias the new one
+			for (PooledGridNode<T>& node : nodes) { node.queryStamp = 0; }
+			queryStamp = 1;
+		}
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::gatherCellNodes(uint32_t cellIdx, std::vector<T*>& outElements, const T* filterElement)
+	{
+		for (uint32_t linkIdx = cells[cellIdx].firstLink; linkIdx != FLAT_SH_INVALID_IDX; linkIdx = links[linkIdx].next)
+		{
+			PooledGridNode<T>& node = nodes[links[linkIdx].node];
+			if (node.queryStamp != queryStamp && node.element != filterElement)
+			{
+				node.queryStamp = queryStamp;
+				outElements.push_back(node.element);
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	uint32_t FlatSpatialHashGrid<T>::allocateNode(T& obj)
+	{
+		uint32_t nodeIdx = firstFreeNode;
+		if (nodeIdx != FLAT_SH_INVALID_IDX)
+		{
+			firstFreeNode = nodes[nodeIdx].nextFree;
+		}
+		else
+		{
+			nodeIdx = static_cast<uint32_t>(nodes.size());
+			nodes.emplace_back();
+		}
+
+		PooledGridNode<T>& node = nodes[nodeIdx];
+		node.element = &obj;
+		node.entry = nullptr;
+		node.nextFree = FLAT_SH_INVALID_IDX;
+		node.queryStamp = 0;
+		++numLiveNodes;
+		return nodeIdx;
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::releaseNode(uint32_t nodeIdx)
+	{
+		PooledGridNode<T>& node = nodes[nodeIdx];
+		node.element = nullptr;
+		node.entry = nullptr;
+		++node.generation;
+		node.nextFree = firstFreeNode;
+		firstFreeNode = nodeIdx;
+		--numLiveNodes;
+	}
+
+	template<typename T>
+	uint32_t FlatSpatialHashGrid<T>::allocateLink()
+	{
+		uint32_t linkIdx = firstFreeLink;
+		if (linkIdx != FLAT_SH_INVALID_IDX)
+		{
+			firstFreeLink = links[linkIdx].next;
+		}
+		else
+		{
+			linkIdx = static_cast<uint32_t>(links.size());
+			links.emplace_back();
+		}
+		return linkIdx;
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::releaseLink(uint32_t linkIdx)
+	{
+		links[linkIdx].node = FLAT_SH_INVALID_IDX;
+		links[linkIdx].next = firstFreeLink;
+		firstFreeLink = linkIdx;
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	std::size_t FlatSpatialHashGrid<T>::probeStart(const glm::ivec3& location) const
+	{
+		//std::hash<uint64_t> may be the identity function (eg libstdc++), which would let the mask throw away the x component; 
+		//so scramble the bits first (murmur3 64bit finalizer)
+		uint64_t h = hashCellLocation(location);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return static_cast<std::size_t>(h) & (cells.size() - 1);
+	}
+
+	template<typename T>
+	uint32_t FlatSpatialHashGrid<T>::findCell(const glm::ivec3& location) const
+	{
+		const std::size_t mask = cells.size() - 1;
+		std::size_t idx = probeStart(location);
+		for (std::size_t probes = 0; probes < cells.size(); ++probes, idx = (idx + 1) & mask)
+		{
+			const FlatHashCell& cell = cells[idx];
+			if (cell.state == FlatCellState::EMPTY)
+			{
+				return FLAT_SH_INVALID_IDX;
+			}
+			if (cell.state == FlatCellState::OCCUPIED && cell.location == location)
+			{
+				return static_cast<uint32_t>(idx);
+			}
+		}
+		return FLAT_SH_INVALID_IDX;
+	}
+
+	template<typename T>
+	uint32_t FlatSpatialHashGrid<T>::findOrAddCell(const glm::ivec3& location)
+	{
+		//tombstones lengthen probe chains just like live cells, so they count towards the load factor
+		if ((numOccupiedCells + numTombstones + 1) * 10 > cells.size() * 7)
+		{
+			std::size_t newCapacity = cells.size();
+			while ((numOccupiedCells + 1) * 2 > newCapacity) { newCapacity <<= 1; }
+			rehashCells(newCapacity);
+		}
+
+		const std::size_t mask = cells.size() - 1;
+		std::size_t idx = probeStart(location);
+		std::size_t firstTombstone = cells.size();
+		for (std::size_t probes = 0; probes < cells.size(); ++probes, idx = (idx + 1) & mask)
+		{
+			FlatHashCell& cell = cells[idx];
+			if (cell.state == FlatCellState::OCCUPIED)
+			{
+				if (cell.location == location)
+				{
+					return static_cast<uint32_t>(idx);
+				}
+			}
+			else if (cell.state == FlatCellState::TOMBSTONE)
+			{
+				firstTombstone = firstTombstone == cells.size() ? idx : firstTombstone;
+			}
+			else //EMPTY; cell is not present
+			{
+				break;
+			}
+		}
+
+		//reuse the earliest tombstone in the chain if there was one
+		if (firstTombstone != cells.size())
+		{
+			idx = firstTombstone;
+			--numTombstones;
+		}
+		assert(cells[idx].state != FlatCellState::OCCUPIED);
+
+		FlatHashCell& newCell = cells[idx];
+		newCell.location = location;
+		newCell.firstLink = FLAT_SH_INVALID_IDX;
+		newCell.numNodes = 0;
+		newCell.state = FlatCellState::OCCUPIED;
+		++numOccupiedCells;
+		return static_cast<uint32_t>(idx);
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::rehashCells(std::size_t newCapacity)
+	{
+		std::vector<FlatHashCell> oldCells(newCapacity);
+		oldCells.swap(cells);
+		numTombstones = 0;
+
+		const std::size_t mask = cells.size() - 1;
+		for (const FlatHashCell& oldCell : oldCells)
+		{
+			if (oldCell.state == FlatCellState::OCCUPIED)
+			{
+				std::size_t idx = probeStart(oldCell.location);
+				while (cells[idx].state != FlatCellState::EMPTY) { idx = (idx + 1) & mask; }
+				cells[idx] = oldCell;
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::hashInsert(uint32_t nodeIdx, const glm::ivec3& location)
+	{
+		//allocate link first; adding a cell may rehash the cell table but never the link pool
+		uint32_t linkIdx = allocateLink();
+		uint32_t cellIdx = findOrAddCell(location);
+
+		FlatHashCell& cell = cells[cellIdx];
+		links[linkIdx].node = nodeIdx;
+		links[linkIdx].next = cell.firstLink;
+		cell.firstLink = linkIdx;
+		++cell.numNodes;
+	}
+
+	template<typename T>
+	bool FlatSpatialHashGrid<T>::hashRemove(uint32_t nodeIdx, const glm::ivec3& location)
+	{
+		uint32_t cellIdx = findCell(location);
+
+		//removals should always be associated with a present cell!
+		assert(cellIdx != FLAT_SH_INVALID_IDX);
+		if (cellIdx == FLAT_SH_INVALID_IDX)
+		{
+			return false;
+		}
+
+		FlatHashCell& cell = cells[cellIdx];
+		uint32_t prevLinkIdx = FLAT_SH_INVALID_IDX;
+		for (uint32_t linkIdx = cell.firstLink; linkIdx != FLAT_SH_INVALID_IDX; linkIdx = links[linkIdx].next)
+		{
+			if (links[linkIdx].node == nodeIdx)
+			{
+				if (prevLinkIdx == FLAT_SH_INVALID_IDX) { cell.firstLink = links[linkIdx].next; }
+				else { links[prevLinkIdx].next = links[linkIdx].next; }
+				releaseLink(linkIdx);
+
+				--cell.numNodes;
+				if (cell.numNodes == 0)
+				{
+					cell.state = FlatCellState::TOMBSTONE;
+					cell.firstLink = FLAT_SH_INVALID_IDX;
+					--numOccupiedCells;
+					++numTombstones;
+				}
+				return true;
+			}
+			prevLinkIdx = linkIdx;
+		}
+
+		assert(false); //node was not in the cell it claimed to occupy
+		return false;
+	}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 }
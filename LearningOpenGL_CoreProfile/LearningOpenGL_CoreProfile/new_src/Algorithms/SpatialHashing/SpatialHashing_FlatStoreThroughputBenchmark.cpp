@@ -0,0 +1,169 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "SpatialHashingComponent.h"
+
+/*
+	Headless companion to SpatialHashingVisualized_ManyObjectsPerfTest.cpp; no window or GL context is created.
+
+	Runs the same scripted scene through SH::SpatialHashGrid and SH::FlatSpatialHashGrid and reports
+	the time spent in insert, updateEntry, lookupNodesInCells, and entry removal. Both runs use the same
+	seed, so the number of neighbors found must match between the two stores.
+*/
+
+namespace
+{
+	template<template<typename> class EntryTemplate>
+	struct BenchEntity
+	{
+		SH::Transform transform;
+		glm::vec3 velocity;
+		std::unique_ptr<EntryTemplate<BenchEntity>> spatialHashEntry;
+
+		std::array<glm::vec4, 8> getOBB()
+		{
+			glm::mat4 model = transform.getModelMatrix();
+			std::array<glm::vec4, 8> OBB;
+			for (size_t idx = 0; idx < OBB.size(); ++idx)
+			{
+				OBB[idx] = model * SH::AABB[idx];
+			}
+			return OBB;
+		}
+	};
+
+	struct BenchConfig
+	{
+		size_t numEntities = 2000;
+		size_t numFrames = 300;
+		float worldHalfExtent = 200.f;
+		float maxSpeed = 40.f;
+		float maxScale = 8.f;
+		glm::vec3 cellSize = glm::vec3(4.f);
+		uint32_t seed = 0x5A5A;
+	};
+
+	struct BenchResults
+	{
+		double insertMs = 0.0;
+		double updateMs = 0.0;
+		double lookupMs = 0.0;
+		double removeMs = 0.0;
+		uint64_t neighborsFound = 0;
+	};
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	template<
+		template<typename> class GridTemplate,
+		template<typename> class EntryTemplate,
+		typename LookupVector
+	>
+	BenchResults runScene(const BenchConfig& config)
+	{
+		using Entity = BenchEntity<EntryTemplate>;
+		BenchResults results;
+
+		std::mt19937 rng(config.seed);
+		std::uniform_real_distribution<float> posDist(-config.worldHalfExtent, config.worldHalfExtent);
+		std::uniform_real_distribution<float> velDist(-config.maxSpeed, config.maxSpeed);
+		std::uniform_real_distribution<float> scaleDist(0.5f, config.maxScale);
+
+		std::vector<Entity> entities(config.numEntities);
+		for (Entity& entity : entities)
+		{
+			entity.transform.position = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+			entity.transform.scale = glm::vec3(scaleDist(rng), scaleDist(rng), scaleDist(rng));
+			entity.velocity = glm::vec3(velDist(rng), velDist(rng), velDist(rng));
+		}
+
+		GridTemplate<Entity> grid{ config.cellSize };
+
+		Clock::time_point start = Clock::now();
+		for (Entity& entity : entities)
+		{
+			entity.spatialHashEntry = grid.insert(entity, entity.getOBB());
+		}
+		results.insertMs = elapsedMs(start);
+
+		const float dt_sec = 1.f / 60.f;
+		LookupVector overlappingNodes;
+		for (size_t frame = 0; frame < config.numFrames; ++frame)
+		{
+			start = Clock::now();
+			for (Entity& entity : entities)
+			{
+				glm::vec3& pos = entity.transform.position;
+				pos += entity.velocity * dt_sec;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					if (glm::abs(pos[axis]) > config.worldHalfExtent) { entity.velocity[axis] *= -1.f; }
+				}
+				grid.updateEntry(entity.spatialHashEntry, entity.getOBB());
+			}
+			results.updateMs += elapsedMs(start);
+
+			start = Clock::now();
+			for (Entity& entity : entities)
+			{
+				grid.lookupNodesInCells(*entity.spatialHashEntry, overlappingNodes);
+				results.neighborsFound += overlappingNodes.size();
+			}
+			results.lookupMs += elapsedMs(start);
+		}
+
+		start = Clock::now();
+		for (Entity& entity : entities)
+		{
+			entity.spatialHashEntry = nullptr;
+		}
+		results.removeMs = elapsedMs(start);
+
+		return results;
+	}
+
+	void printResults(const char* storeName, const BenchConfig& config, const BenchResults& results)
+	{
+		std::cout << storeName << "\n"
+			<< "\tinsert all:           " << results.insertMs << " ms\n"
+			<< "\tupdateEntry / frame:  " << results.updateMs / config.numFrames << " ms\n"
+			<< "\tlookup / frame:       " << results.lookupMs / config.numFrames << " ms\n"
+			<< "\tremove all:           " << results.removeMs << " ms\n"
+			<< "\tneighbors found:      " << results.neighborsFound << std::endl;
+	}
+
+	template<typename T> using SharedNodeVector = std::vector<std::shared_ptr<SH::GridNode<T>>>;
+	template<typename T> using RawElementVector = std::vector<T*>;
+
+	void true_main()
+	{
+		for (size_t numEntities : { 1000, 4000, 10000 })
+		{
+			BenchConfig config;
+			config.numEntities = numEntities;
+
+			std::cout << "---- " << config.numEntities << " entities, " << config.numFrames << " frames ----" << std::endl;
+
+			BenchResults listStore = runScene<SH::SpatialHashGrid, SH::HashEntry, SharedNodeVector<BenchEntity<SH::HashEntry>>>(config);
+			printResults("SpatialHashGrid (shared_ptr node lists)", config, listStore);
+
+			BenchResults flatStore = runScene<SH::FlatSpatialHashGrid, SH::FlatHashEntry, RawElementVector<BenchEntity<SH::FlatHashEntry>>>(config);
+			printResults("FlatSpatialHashGrid (open addressing, pooled nodes)", config, flatStore);
+
+			if (listStore.neighborsFound != flatStore.neighborsFound)
+			{
+				std::cerr << "MISMATCH: backing stores found a different number of neighbors" << std::endl;
+			}
+		}
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
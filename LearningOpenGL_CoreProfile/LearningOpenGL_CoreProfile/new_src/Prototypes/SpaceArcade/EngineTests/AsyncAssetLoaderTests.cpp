@@ -0,0 +1,288 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/AssetManagement/AsyncAssetLoader.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+
+namespace SA
+{
+	namespace AsyncAssetLoaderTests
+	{
+		class AsyncAssetLoader_UnitTest : public SA::UnitTest
+		{
+		public:
+			AsyncAssetLoader_UnitTest()
+			{
+				testNamespace = "AsyncAssetLoader:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers; a mock "decode" that reads the path, and a mock "upload" that stands in for the GPU
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct MockDecoded
+		{
+			std::string contents;
+		};
+		struct MockAsset
+		{
+			std::string contents;
+			std::thread::id uploadThread;
+		};
+		using MockQueue = AsyncAssetQueue<MockDecoded, MockAsset>;
+
+		struct MockLoader
+		{
+			std::atomic<int> numDecodes{ 0 };
+			std::atomic<int> numUploads{ 0 };
+			std::atomic<bool> bDecodeOffGameThread{ true };
+			std::thread::id gameThread = std::this_thread::get_id();
+
+			MockQueue::DecodeFunc makeDecode()
+			{
+				return [this](const std::string& path) -> up<MockDecoded>
+				{
+					++numDecodes;
+					if (std::this_thread::get_id() == gameThread) { bDecodeOffGameThread = false; }
+					std::this_thread::sleep_for(std::chrono::milliseconds(5)); //widen the window for duplicate requests
+
+					if (path.find("missing") != std::string::npos)
+					{
+						return nullptr;
+					}
+					up<MockDecoded> decoded = new_up<MockDecoded>();
+					decoded->contents = "decoded:" + path;
+					return decoded;
+				};
+			}
+
+			MockQueue::UploadFunc makeUpload()
+			{
+				return [this](const std::string& path, up<MockDecoded> decoded) -> sp<MockAsset>
+				{
+					++numUploads;
+					sp<MockAsset> asset = new_sp<MockAsset>();
+					asset->contents = decoded->contents;
+					asset->uploadThread = std::this_thread::get_id();
+					return asset;
+				};
+			}
+		};
+
+		static void drain(AssetWorkerPool& pool, AsyncUploadPump& pump)
+		{
+			pool.waitIdle();
+			while (pump.hasPendingUploads())
+			{
+				pump.pumpUploads();
+			}
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// many threads requesting the same path decode and upload it exactly once
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ConcurrentRequestsDecodeOnce : public AsyncAssetLoader_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Concurrent requests for a path decode once";
+
+				MockLoader loader;
+				AssetWorkerPool pool(4);
+				MockQueue queue(pool, loader.makeDecode(), loader.makeUpload());
+				AsyncUploadPump pump(1000.0);
+				pump.addQueue(queue);
+
+				constexpr size_t numRequestThreads = 8;
+				constexpr size_t requestsPerThread = 16;
+				std::vector<std::vector<MockQueue::Handle>> handlesPerThread(numRequestThreads);
+				std::atomic<bool> bGo{ false };
+				std::vector<std::thread> requesters;
+				for (size_t threadIdx = 0; threadIdx < numRequestThreads; ++threadIdx)
+				{
+					requesters.emplace_back([&, threadIdx]()
+					{
+						while (!bGo) { std::this_thread::yield(); }
+						for (size_t requestIdx = 0; requestIdx < requestsPerThread; ++requestIdx)
+						{
+							handlesPerThread[threadIdx].push_back(queue.request("models/shared.obj"));
+							handlesPerThread[threadIdx].push_back(queue.request("models/" + std::to_string(threadIdx) + ".obj"));
+						}
+					});
+				}
+				bGo = true;
+				for (std::thread& requester : requesters) { requester.join(); }
+
+				drain(pool, pump);
+
+				//one shared path plus one path per thread
+				const int expectedDecodes = int(numRequestThreads) + 1;
+				if (loader.numDecodes != expectedDecodes || queue.getNumDecodesStarted() != size_t(expectedDecodes) || loader.numUploads != expectedDecodes)
+				{
+					errorMessage = "expected each path to be decoded and uploaded once, decodes: " + std::to_string(loader.numDecodes.load());
+					return false;
+				}
+				if (!loader.bDecodeOffGameThread)
+				{
+					errorMessage = "decode ran on the requesting thread";
+					return false;
+				}
+
+				sp<MockAsset> sharedAsset = handlesPerThread[0][0].getAsset();
+				for (const std::vector<MockQueue::Handle>& handles : handlesPerThread)
+				{
+					for (size_t handleIdx = 0; handleIdx < handles.size(); ++handleIdx)
+					{
+						const MockQueue::Handle& handle = handles[handleIdx];
+						if (!handle.isLoaded() || handle.getAsset()->contents != "decoded:" + handle.getPath())
+						{
+							errorMessage = "handle did not resolve to its decoded asset";
+							return false;
+						}
+						if (handleIdx % 2 == 0 && handle.getAsset() != sharedAsset)
+						{
+							errorMessage = "handles for the same path resolved to different assets";
+							return false;
+						}
+						if (handle.getAsset()->uploadThread != loader.gameThread)
+						{
+							errorMessage = "upload did not run on the pumping thread";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// uploads are spread over several pumps according to the time budget
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_UploadsAmortizedByBudget : public AsyncAssetLoader_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Uploads amortized by time budget";
+
+				MockLoader loader;
+				AssetWorkerPool pool(2);
+
+				//each upload advances a fake clock by 2ms; a 5ms budget fits 3 uploads (the third starts at 4ms)
+				double fakeClockMs = 0.0;
+				MockQueue::UploadFunc mockUpload = loader.makeUpload();
+				MockQueue queue(pool, loader.makeDecode(),
+					[&](const std::string& path, up<MockDecoded> decoded)
+					{
+						fakeClockMs += 2.0;
+						return mockUpload(path, std::move(decoded));
+					});
+				AsyncUploadPump pump(5.0, [&]() { return fakeClockMs; });
+				pump.addQueue(queue);
+
+				std::vector<MockQueue::Handle> handles;
+				for (int assetIdx = 0; assetIdx < 10; ++assetIdx)
+				{
+					handles.push_back(queue.request("textures/" + std::to_string(assetIdx) + ".png"));
+				}
+				pool.waitIdle();
+
+				if (loader.numUploads != 0 || handles[0].isLoaded())
+				{
+					errorMessage = "assets resolved before the game thread pumped uploads";
+					return false;
+				}
+
+				const size_t expectedPerPump[] = { 3, 3, 3, 1, 0 };
+				for (size_t expected : expectedPerPump)
+				{
+					size_t numUploaded = pump.pumpUploads();
+					if (numUploaded != expected)
+					{
+						errorMessage = "expected " + std::to_string(expected) + " uploads in pump but got " + std::to_string(numUploaded);
+						return false;
+					}
+				}
+
+				//a single upload that blows the budget still makes progress
+				pump.setBudgetMs(0.0);
+				queue.request("textures/late.png");
+				pool.waitIdle();
+				if (pump.pumpUploads() != 1)
+				{
+					errorMessage = "pump with no budget left did not upload anything";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// failed decodes resolve as failed without reaching the upload step
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_FailedDecode : public AsyncAssetLoader_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Failed decode resolves as failed";
+
+				MockLoader loader;
+				AssetWorkerPool pool(2);
+				MockQueue queue(pool, loader.makeDecode(), loader.makeUpload());
+				AsyncUploadPump pump(1000.0);
+				pump.addQueue(queue);
+
+				MockQueue::Handle missing = queue.request("sounds/missing.wav");
+				MockQueue::Handle present = queue.request("sounds/present.wav");
+				if (!missing.isLoading() || !present.isLoading())
+				{
+					errorMessage = "new requests should be loading";
+					return false;
+				}
+
+				drain(pool, pump);
+
+				if (!missing.hasFailed() || missing.getAsset() != nullptr || !present.isLoaded())
+				{
+					errorMessage = "unexpected handle status after decode";
+					return false;
+				}
+				if (loader.numUploads != 1)
+				{
+					errorMessage = "failed decode reached the upload step";
+					return false;
+				}
+
+				sp<MockAsset> preloaded = new_sp<MockAsset>();
+				if (!MockQueue::Handle::resolved("sounds/preloaded.wav", preloaded).isLoaded() || MockQueue::Handle::resolved("x", nullptr).isLoaded())
+				{
+					errorMessage = "resolved handle status incorrect";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class AsyncAssetLoaderTestSuite : public SA::TestSuite
+		{
+		public:
+			AsyncAssetLoaderTestSuite()
+			{
+				testName = "ASYNC ASSET LOADER TEST SUITE";
+
+				addTest(new_sp<Test_ConcurrentRequestsDecodeOnce>());
+				addTest(new_sp<Test_UploadsAmortizedByBudget>());
+				addTest(new_sp<Test_FailedDecode>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getAsyncAssetLoaderTestSuite()
+	{
+		return new_sp<SA::AsyncAssetLoaderTests::AsyncAssetLoaderTestSuite>();
+	}
+}
@@ -0,0 +1,266 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/Audio/AudioEmitterSelector.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace SA
+{
+	namespace AudioEmitterSelectorTests
+	{
+		class AudioEmitterSelector_UnitTest : public SA::UnitTest
+		{
+		public:
+			AudioEmitterSelector_UnitTest()
+			{
+				testNamespace = "AudioEmitterSelector:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the partial selection picks exactly what a full sort of every emitter would put first
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SelectionMatchesFullSort : public AudioEmitterSelector_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Selection matches a full sort";
+
+				std::mt19937 rng(1234);
+				std::uniform_real_distribution<float> coord(-500.f, 500.f);
+				std::uniform_real_distribution<float> radius(10.f, 400.f);
+				std::uniform_int_distribution<int> category(0, 5);
+				std::uniform_int_distribution<int> coin(0, 3);
+
+				//two listeners, like split screen
+				std::vector<glm::vec3> listeners = { glm::vec3(0.f), glm::vec3(300.f, 0.f, -200.f) };
+
+				AudioEmitterSelector selector;
+				const size_t numEmitters = 5000;
+				std::vector<glm::vec3> positions;
+				std::vector<float> radii;
+				std::vector<float> categories;
+				std::vector<bool> hasSource;
+				std::vector<bool> active;
+				for (size_t idx = 0; idx < numEmitters; ++idx)
+				{
+					positions.push_back(glm::vec3(coord(rng), coord(rng), coord(rng)));
+					radii.push_back(radius(rng));
+					categories.push_back(float(category(rng)));
+					hasSource.push_back(coin(rng) == 0);
+					active.push_back(coin(rng) != 0);
+					selector.add(positions.back(), radii.back(), categories.back(), hasSource.back(), active.back());
+				}
+				//a few exact duplicates so ties are exercised
+				for (size_t idx = 0; idx < 50; ++idx)
+				{
+					selector.add(positions[idx], radii[idx], categories[idx], hasSource[idx], active[idx]);
+				}
+				selector.score(listeners);
+
+				//scoring agrees with a direct calculation
+				for (uint32_t idx = 0; idx < uint32_t(numEmitters); ++idx)
+				{
+					size_t closest = 0;
+					for (size_t listenerIdx = 1; listenerIdx < listeners.size(); ++listenerIdx)
+					{
+						if (glm::distance(listeners[listenerIdx], positions[idx]) < glm::distance(listeners[closest], positions[idx]))
+						{
+							closest = listenerIdx;
+						}
+					}
+					const float distance = glm::distance(listeners[closest], positions[idx]);
+					const bool bExpectInRange = active[idx] && (hasSource[idx] ? distance * distance <= radii[idx] * radii[idx] * selector.rangeHysteresis : distance < radii[idx]);
+					if (selector.getClosestListener(idx) != closest || selector.isInRange(idx) != bExpectInRange)
+					{
+						errorMessage = "closest listener or range is wrong";
+						return false;
+					}
+					if (bExpectInRange && std::abs(selector.getPriority(idx) - (categories[idx] + std::min(distance / radii[idx], 1.f))) > 0.0001f)
+					{
+						errorMessage = "priority is wrong";
+						return false;
+					}
+				}
+
+				std::vector<uint32_t> fullSort;
+				for (uint32_t idx = 0; idx < uint32_t(selector.size()); ++idx)
+				{
+					if (selector.isInRange(idx)) { fullSort.push_back(idx); }
+				}
+				std::sort(fullSort.begin(), fullSort.end(), [&](uint32_t first, uint32_t second)
+				{
+					return selector.getSelectionKey(first) < selector.getSelectionKey(second)
+						|| (selector.getSelectionKey(first) == selector.getSelectionKey(second) && first < second);
+				});
+
+				for (size_t maxSelected : { size_t(0), size_t(1), size_t(16), size_t(255), size_t(100000) })
+				{
+					selector.select(maxSelected);
+					const size_t expectedCount = std::min(maxSelected, fullSort.size());
+					const std::vector<uint32_t>& selected = selector.getSelected();
+					if (selected.size() != expectedCount || !std::equal(selected.begin(), selected.end(), fullSort.begin()))
+					{
+						errorMessage = "selection differs from the front of a full sort; max selected " + std::to_string(maxSelected);
+						return false;
+					}
+
+					std::vector<bool> bSelected(selector.size(), false);
+					for (uint32_t idx : selected) { bSelected[idx] = true; }
+					size_t numExpectedEvictions = 0;
+					for (uint32_t idx = 0; idx < uint32_t(selector.size()); ++idx)
+					{
+						numExpectedEvictions += (idx < numEmitters ? hasSource[idx] : hasSource[idx - numEmitters]) && !bSelected[idx];
+					}
+					if (selector.getEvicted().size() != numExpectedEvictions)
+					{
+						errorMessage = "evicted emitters do not match the emitters with sources that lost them";
+						return false;
+					}
+					for (uint32_t idx : selector.getEvicted())
+					{
+						if (bSelected[idx])
+						{
+							errorMessage = "a selected emitter was evicted";
+							return false;
+						}
+					}
+				}
+
+				//the software mixed emitters are the next run of the full sort
+				const size_t maxSelected = 255;
+				const size_t maxSoftwareMixed = 300;
+				selector.select(maxSelected, maxSoftwareMixed);
+				std::vector<uint32_t> softwareMixed = selector.getSoftwareMixed();
+				std::sort(softwareMixed.begin(), softwareMixed.end());
+				const size_t expectedEnd = std::min(maxSelected + maxSoftwareMixed, fullSort.size());
+				std::vector<uint32_t> expectedSoftwareMixed(fullSort.begin() + std::min(maxSelected, expectedEnd), fullSort.begin() + expectedEnd);
+				std::sort(expectedSoftwareMixed.begin(), expectedSoftwareMixed.end());
+				if (!std::equal(selector.getSelected().begin(), selector.getSelected().end(), fullSort.begin()) || softwareMixed != expectedSoftwareMixed)
+				{
+					errorMessage = "software mixed emitters are not the runners up of a full sort";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// emitters holding a source keep it against slightly better emitters, and near the edge of their radius
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Hysteresis : public AudioEmitterSelector_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Hysteresis";
+
+				const std::vector<glm::vec3> listeners = { glm::vec3(0.f) };
+				const float radius = 100.f;
+				const float category = 3.f;
+
+				//holder is 5% of its radius away, challenger 4%; holder keeps the source
+				AudioEmitterSelector selector;
+				uint32_t holder = selector.add(glm::vec3(5.f, 0.f, 0.f), radius, category, true, true);
+				uint32_t challenger = selector.add(glm::vec3(4.f, 0.f, 0.f), radius, category, false, true);
+				selector.score(listeners);
+				selector.select(1);
+				if (selector.getSelected() != std::vector<uint32_t>{ holder } || !selector.getEvicted().empty())
+				{
+					errorMessage = "a slightly closer emitter took the source";
+					return false;
+				}
+
+				//clearly better challenger wins, and the holder is evicted
+				selector.clear();
+				holder = selector.add(glm::vec3(20.f, 0.f, 0.f), radius, category, true, true);
+				challenger = selector.add(glm::vec3(4.f, 0.f, 0.f), radius, category, false, true);
+				selector.score(listeners);
+				selector.select(1);
+				if (selector.getSelected() != std::vector<uint32_t>{ challenger } || selector.getEvicted() != std::vector<uint32_t>{ holder })
+				{
+					errorMessage = "a clearly closer emitter did not take the source";
+					return false;
+				}
+
+				//just outside the radius: an emitter with a source stays, one without does not get to start
+				selector.clear();
+				holder = selector.add(glm::vec3(radius * 1.004f, 0.f, 0.f), radius, category, true, true);
+				challenger = selector.add(glm::vec3(radius * 1.004f, 0.f, 0.f), radius, category, false, true);
+				uint32_t leaver = selector.add(glm::vec3(radius * 1.1f, 0.f, 0.f), radius, category, true, true);
+				selector.score(listeners);
+				selector.select(8);
+				if (!selector.isInRange(holder) || selector.isInRange(challenger) || selector.isInRange(leaver)
+					|| selector.getSelected() != std::vector<uint32_t>{ holder } || selector.getEvicted() != std::vector<uint32_t>{ leaver })
+				{
+					errorMessage = "range hysteresis is wrong";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// emitters are prioritized by the closest split screen listener, and category outranks distance
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SplitScreenListeners : public AudioEmitterSelector_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Split screen listeners";
+
+				const std::vector<glm::vec3> listeners = { glm::vec3(0.f), glm::vec3(1000.f, 0.f, 0.f) };
+
+				AudioEmitterSelector selector;
+				uint32_t nearSecond = selector.add(glm::vec3(1001.f, 0.f, 0.f), 10.f, 4.f, false, true);
+				uint32_t nearFirst = selector.add(glm::vec3(5.f, 0.f, 0.f), 10.f, 4.f, false, true);
+				uint32_t critical = selector.add(glm::vec3(0.f, 0.f, 9.f), 10.f, 0.f, false, true);
+				uint32_t unheard = selector.add(glm::vec3(500.f, 0.f, 0.f), 10.f, 0.f, false, true);
+				selector.score(listeners);
+				selector.select(3);
+
+				if (selector.getClosestListener(nearSecond) != 1 || selector.getClosestListener(nearFirst) != 0)
+				{
+					errorMessage = "emitter was not mapped to its closest listener";
+					return false;
+				}
+				if (selector.isInRange(unheard) || selector.getSelected() != std::vector<uint32_t>{ critical, nearSecond, nearFirst })
+				{
+					errorMessage = "selection order is wrong";
+					return false;
+				}
+
+				//without listeners (eg no player yet) everything active is selected by category
+				selector.score({});
+				selector.select(4);
+				if (selector.getSelected() != std::vector<uint32_t>{ critical, unheard, nearSecond, nearFirst })
+				{
+					errorMessage = "selection without listeners is wrong";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class AudioEmitterSelectorTestSuite : public SA::TestSuite
+		{
+		public:
+			AudioEmitterSelectorTestSuite()
+			{
+				testName = "AUDIO EMITTER SELECTOR TEST SUITE";
+
+				addTest(new_sp<Test_SelectionMatchesFullSort>());
+				addTest(new_sp<Test_Hysteresis>());
+				addTest(new_sp<Test_SplitScreenListeners>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getAudioEmitterSelectorTestSuite()
+	{
+		return new_sp<SA::AudioEmitterSelectorTests::AudioEmitterSelectorTestSuite>();
+	}
+}
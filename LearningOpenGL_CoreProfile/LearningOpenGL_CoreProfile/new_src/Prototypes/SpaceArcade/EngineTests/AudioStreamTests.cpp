@@ -0,0 +1,366 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/Audio/AudioStream.h"
+#include "../GameFramework/AssetManagement/AsyncAssetLoader.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SA
+{
+	namespace AudioStreamTests
+	{
+		class AudioStream_UnitTest : public SA::UnitTest
+		{
+		public:
+			AudioStream_UnitTest()
+			{
+				testNamespace = "AudioStream:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers; a decoder that produces a ramp so any reordered, repeated, or dropped sample is visible, and that can be held
+		/// at a frame to act like a slow disk
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		inline int16_t rampSample(size_t frame, size_t channel, size_t channels)
+		{
+			return int16_t((frame * channels + channel) % 32000);
+		}
+
+		struct RampControl
+		{
+			std::mutex mutex;
+			std::condition_variable gateOpened;
+			size_t framesAllowed = std::numeric_limits<size_t>::max();
+			std::atomic<bool> bWaitingAtGate{ false };
+			std::atomic<bool> bDecodedOnGameThread{ false };
+			std::thread::id gameThread = std::this_thread::get_id();
+
+			void setFramesAllowed(size_t numFrames)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					framesAllowed = numFrames;
+				}
+				gateOpened.notify_all();
+			}
+		};
+
+		class RampDecoder : public AudioStreamDecoder
+		{
+		public:
+			RampDecoder(size_t totalFrames, unsigned int channels, const sp<RampControl>& control)
+				: totalFrames(totalFrames), channels(channels), control(control)
+			{}
+
+			virtual size_t readFrames(int16_t* outSamples, size_t maxFrames) override
+			{
+				if (std::this_thread::get_id() == control->gameThread) { control->bDecodedOnGameThread = true; }
+
+				std::unique_lock<std::mutex> lock(control->mutex);
+				control->bWaitingAtGate = position >= control->framesAllowed;
+				control->gateOpened.wait(lock, [this]() { return position < control->framesAllowed; });
+				control->bWaitingAtGate = false;
+
+				const size_t numFrames = std::min({ maxFrames, totalFrames - position, control->framesAllowed - position });
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					for (size_t channel = 0; channel < channels; ++channel)
+					{
+						outSamples[frame * channels + channel] = rampSample(position + frame, channel, channels);
+					}
+				}
+				position += numFrames;
+				return numFrames;
+			}
+			virtual bool seekToStart() override { position = 0; return true; }
+			virtual unsigned int getChannels() const override { return channels; }
+			virtual unsigned int getSampleRate() const override { return 44100; }
+			virtual float getDurationSec() const override { return float(totalFrames) / 44100.f; }
+
+		private:
+			size_t totalFrames;
+			size_t position = 0;
+			unsigned int channels;
+			sp<RampControl> control;
+		};
+
+		/** samples played should be the ramp from its first frame, wrapping at the end of the sound */
+		bool playedRamp(const std::vector<int16_t>& played, size_t totalFrames, size_t channels)
+		{
+			for (size_t sampleIdx = 0; sampleIdx < played.size(); ++sampleIdx)
+			{
+				const size_t frame = sampleIdx / channels;
+				if (played[sampleIdx] != rampSample(frame % totalFrames, sampleIdx % channels, channels))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		template<typename Predicate>
+		bool waitFor(Predicate predicate)
+		{
+			for (int attempt = 0; attempt < 2000 && !predicate(); ++attempt)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			return predicate();
+		}
+
+		constexpr AudioStreamBackend::SourceId testSource = 7;
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// chunks are queued in the order they were decoded, and the whole sound is played once
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ChunkOrdering : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Chunks play in order";
+
+				const size_t totalFrames = 2600; //not a multiple of the chunk size, so the last chunk is partial
+				sp<RampControl> control = new_sp<RampControl>();
+				NullAudioStreamBackend backend;
+				AssetWorkerPool decodePool(1);
+				{
+					AudioStreamConfig config;
+					config.framesPerChunk = 256;
+					config.numBuffers = 3;
+					AudioStream stream(new_up<RampDecoder>(totalFrames, 2, control), backend, decodePool, config);
+					stream.prefetch();
+					decodePool.waitIdle();
+					stream.attach(testSource);
+
+					for (int tick = 0; tick < 100 && !stream.isFinished(); ++tick)
+					{
+						backend.playBuffers(testSource, 1);
+						decodePool.waitIdle();
+						stream.service();
+					}
+
+					if (!stream.isFinished())
+					{
+						errorMessage = "stream never finished";
+						return false;
+					}
+					const std::vector<int16_t>& played = backend.getPlayedSamples(testSource);
+					if (played.size() != totalFrames * 2 || !playedRamp(played, totalFrames, 2))
+					{
+						errorMessage = "played samples are not the sound in order";
+						return false;
+					}
+					if (stream.getStats().numChunksQueued != (totalFrames + 255) / 256 || stream.getStats().numUnderruns != 0)
+					{
+						errorMessage = "unexpected chunk or underrun count";
+						return false;
+					}
+					if (control->bDecodedOnGameThread)
+					{
+						errorMessage = "decoding happened on the game thread";
+						return false;
+					}
+				}
+				if (backend.getNumLiveBuffers() != 0)
+				{
+					errorMessage = "stream leaked buffers";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// looping continues from the start of the sound with no gap or repeat, including sounds shorter than a chunk
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_LoopingSeams : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Looping seams are sample continuous";
+
+				for (size_t totalFrames : { size_t(1000), size_t(100), size_t(256) })
+				{
+					sp<RampControl> control = new_sp<RampControl>();
+					NullAudioStreamBackend backend;
+					AssetWorkerPool decodePool(1);
+
+					AudioStreamConfig config;
+					config.framesPerChunk = 256;
+					config.numBuffers = 2;
+					config.bLooping = true;
+					AudioStream stream(new_up<RampDecoder>(totalFrames, 1, control), backend, decodePool, config);
+					stream.attach(testSource);
+
+					for (int tick = 0; tick < 40; ++tick)
+					{
+						decodePool.waitIdle();
+						stream.service();
+						backend.playBuffers(testSource, 1);
+					}
+					const std::vector<int16_t>& played = backend.getPlayedSamples(testSource);
+					if (stream.isFinished() || played.size() < totalFrames * 4 || !playedRamp(played, totalFrames, 1))
+					{
+						errorMessage = "looping stream has a discontinuity; sound length " + std::to_string(totalFrames);
+						return false;
+					}
+
+					//turning looping off lets the stream finish at the end of a pass
+					stream.setLooping(false);
+					for (int tick = 0; tick < 100 && !stream.isFinished(); ++tick)
+					{
+						decodePool.waitIdle();
+						stream.service();
+						backend.playBuffers(testSource, 1);
+					}
+					if (!stream.isFinished() || played.size() % totalFrames != 0 || !playedRamp(played, totalFrames, 1))
+					{
+						errorMessage = "stream did not finish cleanly after looping was turned off; sound length " + std::to_string(totalFrames);
+						return false;
+					}
+					if (stream.getStats().numUnderruns != 0)
+					{
+						errorMessage = "looping stream underran";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// when decoding falls behind, the source runs dry and is restarted without losing or repeating audio
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_UnderrunRecovery : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Underrun recovery";
+
+				const size_t framesPerChunk = 128;
+				const size_t totalFrames = framesPerChunk * 8;
+				sp<RampControl> control = new_sp<RampControl>();
+				control->setFramesAllowed(framesPerChunk * 2);
+
+				NullAudioStreamBackend backend;
+				AssetWorkerPool decodePool(1);
+				bool bSuccess = true;
+				{
+					AudioStreamConfig config;
+					config.framesPerChunk = framesPerChunk;
+					config.numBuffers = 2;
+					AudioStream stream(new_up<RampDecoder>(totalFrames, 1, control), backend, decodePool, config);
+					stream.prefetch();
+					decodePool.waitIdle();
+					stream.attach(testSource);
+
+					//the decoder is now stuck on the third chunk; play through what was queued
+					if (!waitFor([&]() { return control->bWaitingAtGate.load(); }))
+					{
+						errorMessage = "decoder never reached the gate";
+						bSuccess = false;
+					}
+					backend.playBuffers(testSource, 2);
+					for (int tick = 0; tick < 3 && bSuccess; ++tick)
+					{
+						stream.service();
+						if (backend.isPlaying(testSource) || stream.isFinished() || stream.getStats().numUnderruns != 0)
+						{
+							errorMessage = "a starved stream should wait for data without finishing";
+							bSuccess = false;
+						}
+					}
+
+					//decoding catches up
+					control->setFramesAllowed(std::numeric_limits<size_t>::max());
+					decodePool.waitIdle();
+					stream.service();
+					if (bSuccess && (!backend.isPlaying(testSource) || stream.getStats().numUnderruns != 1))
+					{
+						errorMessage = "stream did not restart after data arrived";
+						bSuccess = false;
+					}
+
+					for (int tick = 0; tick < 100 && bSuccess && !stream.isFinished(); ++tick)
+					{
+						backend.playBuffers(testSource, 1);
+						decodePool.waitIdle();
+						stream.service();
+					}
+					const std::vector<int16_t>& played = backend.getPlayedSamples(testSource);
+					if (bSuccess && (!stream.isFinished() || played.size() != totalFrames || !playedRamp(played, totalFrames, 1)))
+					{
+						errorMessage = "audio was lost or repeated across the underrun";
+						bSuccess = false;
+					}
+				}
+				control->setFramesAllowed(std::numeric_limits<size_t>::max()); //never leave the worker blocked
+				return bSuccess;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// a stream can go away while its decode task is still running
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_DestroyWhileDecoding : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Destroy while decoding";
+
+				sp<RampControl> control = new_sp<RampControl>();
+				control->setFramesAllowed(0);
+
+				NullAudioStreamBackend backend;
+				AssetWorkerPool decodePool(1);
+				{
+					AudioStream stream(new_up<RampDecoder>(1000, 1, control), backend, decodePool, AudioStreamConfig{});
+					stream.attach(testSource);
+					if (!waitFor([&]() { return control->bWaitingAtGate.load(); }))
+					{
+						errorMessage = "decoder never started";
+						control->setFramesAllowed(std::numeric_limits<size_t>::max());
+						return false;
+					}
+				}
+				control->setFramesAllowed(std::numeric_limits<size_t>::max());
+				decodePool.waitIdle();
+
+				if (backend.getNumLiveBuffers() != 0 || backend.getNumQueued(testSource) != 0)
+				{
+					errorMessage = "destroyed stream left buffers behind";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class AudioStreamTestSuite : public SA::TestSuite
+		{
+		public:
+			AudioStreamTestSuite()
+			{
+				testName = "AUDIO STREAM TEST SUITE";
+
+				addTest(new_sp<Test_ChunkOrdering>());
+				addTest(new_sp<Test_LoopingSeams>());
+				addTest(new_sp<Test_UnderrunRecovery>());
+				addTest(new_sp<Test_DestroyWhileDecoding>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getAudioStreamTestSuite()
+	{
+		return new_sp<SA::AudioStreamTests::AudioStreamTestSuite>();
+	}
+}
@@ -0,0 +1,610 @@
+#include "EngineTestSuite.h"
+#include "../Tools/ModelLoading/SABakedModel.h"
+
+#include <assimp/Importer.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+namespace SA
+{
+	namespace BakedModelCacheTests
+	{
+		class BakedModelCache_UnitTest : public SA::UnitTest
+		{
+		public:
+			BakedModelCache_UnitTest()
+			{
+				testNamespace = "BakedModelCache:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		/** builds meshes the way assimp hands them to Model3D after import; the mesh destructor frees the arrays */
+		static up<aiMesh> makeAssimpMesh(uint32_t numQuads, float offset, const std::vector<std::string>& boneNames)
+		{
+			up<aiMesh> mesh = new_up<aiMesh>();
+			mesh->mNumVertices = numQuads * 4;
+			mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+			mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+			mesh->mTangents = new aiVector3D[mesh->mNumVertices];
+			mesh->mBitangents = new aiVector3D[mesh->mNumVertices];
+			mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+			mesh->mNumUVComponents[0] = 2;
+			for (uint32_t vert = 0; vert < mesh->mNumVertices; ++vert)
+			{
+				float f = float(vert);
+				mesh->mVertices[vert] = aiVector3D(offset + f, -f * 0.5f, f * 0.25f - offset);
+				mesh->mNormals[vert] = aiVector3D(0.f, 1.f, 0.f);
+				mesh->mTangents[vert] = aiVector3D(2.f + f, 0.f, 0.1f); //not unit length; baking normalizes
+				mesh->mBitangents[vert] = aiVector3D(0.f, 0.3f, 3.f);
+				mesh->mTextureCoords[0][vert] = aiVector3D(f / 8.f, 1.f - f / 8.f, 0.f);
+			}
+
+			mesh->mNumFaces = numQuads * 2;
+			mesh->mFaces = new aiFace[mesh->mNumFaces];
+			for (uint32_t quad = 0; quad < numQuads; ++quad)
+			{
+				uint32_t base = quad * 4;
+				uint32_t quadIndices[2][3] = { { base, base + 1, base + 2 }, { base + 2, base + 3, base } };
+				for (uint32_t tri = 0; tri < 2; ++tri)
+				{
+					aiFace& face = mesh->mFaces[quad * 2 + tri];
+					face.mNumIndices = 3;
+					face.mIndices = new unsigned int[3];
+					std::memcpy(face.mIndices, quadIndices[tri], sizeof(quadIndices[tri]));
+				}
+			}
+
+			mesh->mNumBones = uint32_t(boneNames.size());
+			mesh->mBones = new aiBone*[mesh->mNumBones];
+			for (uint32_t boneIdx = 0; boneIdx < mesh->mNumBones; ++boneIdx)
+			{
+				aiBone* bone = new aiBone();
+				bone->mName.Set(boneNames[boneIdx]);
+				bone->mOffsetMatrix = aiMatrix4x4(aiVector3D(1.f), aiQuaternion(aiVector3D(0.f, 1.f, 0.f), 0.5f * boneIdx), aiVector3D(float(boneIdx), 0.f, -1.f));
+
+				//every vertex gets a weight from every bone, up to the 4 bone limit
+				bone->mNumWeights = mesh->mNumVertices;
+				bone->mWeights = new aiVertexWeight[bone->mNumWeights];
+				for (uint32_t vert = 0; vert < bone->mNumWeights; ++vert)
+				{
+					bone->mWeights[vert] = aiVertexWeight(vert, 1.f / (boneIdx + 1 + vert));
+				}
+				mesh->mBones[boneIdx] = bone;
+			}
+			return mesh;
+		}
+
+		template<typename T>
+		static bool bytesEqual(const std::vector<T>& a, const std::vector<T>& b)
+		{
+			return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+		}
+
+		template<typename KEY>
+		static bool keysEqual(const std::vector<KEY>& a, const std::vector<KEY>& b)
+		{
+			if (a.size() != b.size()) { return false; }
+			for (size_t keyIdx = 0; keyIdx < a.size(); ++keyIdx)
+			{
+				if (a[keyIdx].mTime != b[keyIdx].mTime || !(a[keyIdx].mValue == b[keyIdx].mValue)) { return false; }
+			}
+			return true;
+		}
+
+		static bool modelsEqual(const BakedModel& a, const BakedModel& b, std::string& outDifference)
+		{
+			if (a.aabbMin != b.aabbMin || a.aabbMax != b.aabbMax || !(a.inverseSceneTransform == b.inverseSceneTransform))
+			{
+				outDifference = "model bounds or scene transform differ";
+				return false;
+			}
+			if (a.meshes.size() != b.meshes.size())
+			{
+				outDifference = "mesh count differs";
+				return false;
+			}
+			for (size_t meshIdx = 0; meshIdx < a.meshes.size(); ++meshIdx)
+			{
+				const BakedMesh& meshA = a.meshes[meshIdx];
+				const BakedMesh& meshB = b.meshes[meshIdx];
+				if (!bytesEqual(meshA.vertices, meshB.vertices) || !bytesEqual(meshA.normalData, meshB.normalData)
+					|| !bytesEqual(meshA.indices, meshB.indices) || !bytesEqual(meshA.vertexBoneData, meshB.vertexBoneData))
+				{
+					outDifference = "vertex data differs for mesh " + std::to_string(meshIdx);
+					return false;
+				}
+				if (meshA.textures.size() != meshB.textures.size() || meshA.bones.size() != meshB.bones.size())
+				{
+					outDifference = "texture or bone count differs for mesh " + std::to_string(meshIdx);
+					return false;
+				}
+				for (size_t texIdx = 0; texIdx < meshA.textures.size(); ++texIdx)
+				{
+					if (meshA.textures[texIdx].type != meshB.textures[texIdx].type || meshA.textures[texIdx].relativePath != meshB.textures[texIdx].relativePath)
+					{
+						outDifference = "texture reference differs";
+						return false;
+					}
+				}
+				for (size_t boneIdx = 0; boneIdx < meshA.bones.size(); ++boneIdx)
+				{
+					const BakedBone& boneA = meshA.bones[boneIdx];
+					const BakedBone& boneB = meshB.bones[boneIdx];
+					if (boneA.name != boneB.name || boneA.uniqueID != boneB.uniqueID || !(boneA.meshToBoneTransform == boneB.meshToBoneTransform) || !bytesEqual(boneA.weights, boneB.weights))
+					{
+						outDifference = "bone differs";
+						return false;
+					}
+				}
+			}
+			if (a.nodes.size() != b.nodes.size())
+			{
+				outDifference = "node count differs";
+				return false;
+			}
+			for (size_t nodeIdx = 0; nodeIdx < a.nodes.size(); ++nodeIdx)
+			{
+				if (a.nodes[nodeIdx].name != b.nodes[nodeIdx].name || a.nodes[nodeIdx].parentIdx != b.nodes[nodeIdx].parentIdx || !(a.nodes[nodeIdx].transform == b.nodes[nodeIdx].transform))
+				{
+					outDifference = "node differs";
+					return false;
+				}
+			}
+			if (a.animations.size() != b.animations.size())
+			{
+				outDifference = "animation count differs";
+				return false;
+			}
+			for (size_t animIdx = 0; animIdx < a.animations.size(); ++animIdx)
+			{
+				const BakedAnimation& animA = a.animations[animIdx];
+				const BakedAnimation& animB = b.animations[animIdx];
+				if (animA.duration != animB.duration || animA.ticksPerSecond != animB.ticksPerSecond || animA.channels.size() != animB.channels.size())
+				{
+					outDifference = "animation differs";
+					return false;
+				}
+				for (size_t channelIdx = 0; channelIdx < animA.channels.size(); ++channelIdx)
+				{
+					const BakedChannel& channelA = animA.channels[channelIdx];
+					const BakedChannel& channelB = animB.channels[channelIdx];
+					if (channelA.nodeName != channelB.nodeName || !keysEqual(channelA.positionKeys, channelB.positionKeys)
+						|| !keysEqual(channelA.rotationKeys, channelB.rotationKeys) || !keysEqual(channelA.scalingKeys, channelB.scalingKeys))
+					{
+						outDifference = "animation channel differs";
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/** a model baked from assimp meshes plus a small skeleton and animation */
+		static up<BakedModel> makeBakedModel()
+		{
+			up<BakedModel> model = new_up<BakedModel>();
+			std::map<std::string, int> boneIdsByName;
+
+			up<aiMesh> hull = makeAssimpMesh(3, 1.f, { "root_bone", "turret_bone" });
+			up<aiMesh> turret = makeAssimpMesh(2, -4.f, { "turret_bone", "barrel_bone" }); //shares a bone with the hull
+			model->meshes.push_back(ModelBake::bakeMesh(*hull, boneIdsByName, model->aabbMin, model->aabbMax));
+			model->meshes.push_back(ModelBake::bakeMesh(*turret, boneIdsByName, model->aabbMin, model->aabbMax));
+			model->meshes[0].textures = { { "texture_diffuse", "hull_diffuse.png" }, { "texture_normalmap", "hull_normal.png" } };
+			model->meshes[1].textures = { { "texture_specular", "turret_spec.png" } };
+
+			model->inverseSceneTransform = aiMatrix4x4(aiVector3D(2.f), aiQuaternion(), aiVector3D(0.f, 0.f, 1.f)).Inverse();
+			model->nodes = {
+				{ "scene_root", aiMatrix4x4(), -1 },
+				{ "root_bone", aiMatrix4x4(aiVector3D(1.f), aiQuaternion(), aiVector3D(0.f, 1.f, 0.f)), 0 },
+				{ "turret_bone", aiMatrix4x4(aiVector3D(1.f), aiQuaternion(aiVector3D(0.f, 1.f, 0.f), 0.25f), aiVector3D(0.f)), 1 },
+				{ "barrel_bone", aiMatrix4x4(), 2 },
+				{ "mesh_node", aiMatrix4x4(), 0 },
+			};
+
+			BakedAnimation spin;
+			spin.duration = 48.0;
+			spin.ticksPerSecond = 24.0;
+			BakedChannel turretChannel;
+			turretChannel.nodeName = "turret_bone";
+			for (int key = 0; key < 5; ++key)
+			{
+				double time = key * 12.0;
+				turretChannel.positionKeys.push_back(aiVectorKey(time, aiVector3D(0.f, float(key), 0.f)));
+				turretChannel.rotationKeys.push_back(aiQuatKey(time, aiQuaternion(aiVector3D(0.f, 1.f, 0.f), 0.3f * key)));
+			}
+			turretChannel.scalingKeys.push_back(aiVectorKey(0.0, aiVector3D(1.f)));
+			spin.channels.push_back(turretChannel);
+			model->animations.push_back(spin);
+
+			return model;
+		}
+
+		/** scratch directory removed when the test finishes */
+		struct ScopedTempDir
+		{
+			std::filesystem::path path;
+			ScopedTempDir(const char* name)
+			{
+				path = std::filesystem::temp_directory_path() / name;
+				std::error_code ec;
+				std::filesystem::remove_all(path, ec);
+				std::filesystem::create_directories(path, ec);
+			}
+			~ScopedTempDir()
+			{
+				std::error_code ec;
+				std::filesystem::remove_all(path, ec);
+			}
+			std::string file(const char* filename) const { return (path / filename).string(); }
+		};
+
+		static void writeFile(const std::string& filepath, const std::vector<char>& bytes)
+		{
+			std::ofstream outFile(filepath, std::ios::binary | std::ios::trunc);
+			outFile.write(bytes.data(), std::streamsize(bytes.size()));
+		}
+
+		static std::vector<char> readFile(const std::string& filepath)
+		{
+			std::ifstream inFile(filepath, std::ios::binary);
+			return std::vector<char>(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// baking a model imported from game data copies assimp's mesh and material data exactly as Model3D used to read it
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BakeMatchesAssimpImport : public BakedModelCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Baked model matches assimp import";
+
+				//the turret's .mtl references a diffuse map and a bump map
+				const char* modelPath = "GameData/mods/SpaceArcade/Assets/Models3D/turret/sa_turret.obj";
+				Assimp::Importer importer;
+				const aiScene* scene = importer.ReadFile(modelPath, ModelBake::importFlags);
+				if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+				{
+					errorMessage = std::string("failed to import ") + modelPath;
+					return false;
+				}
+				up<BakedModel> baked = ModelBake::bakeScene(*scene);
+
+				std::vector<const aiMesh*> sceneMeshes; //in the order the scene graph references them, like the baked meshes
+				std::vector<const aiNode*> sourceNodes;
+				ModelBake::bakeNodes(*scene->mRootNode, &sourceNodes);
+				for (const aiNode* node : sourceNodes)
+				{
+					for (uint32_t i = 0; i < node->mNumMeshes; ++i)
+					{
+						sceneMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
+					}
+				}
+				if (sceneMeshes.empty() || baked->meshes.size() != sceneMeshes.size())
+				{
+					errorMessage = "mesh count mismatch";
+					return false;
+				}
+
+				glm::vec3 expectedMin(0.f), expectedMax(0.f); //model bounds always include the origin
+				bool bFoundDiffuse = false, bFoundNormalMap = false;
+				for (size_t meshIdx = 0; meshIdx < sceneMeshes.size(); ++meshIdx)
+				{
+					const aiMesh& mesh = *sceneMeshes[meshIdx];
+					const BakedMesh& bakedMesh = baked->meshes[meshIdx];
+					if (bakedMesh.vertices.size() != mesh.mNumVertices || bakedMesh.normalData.size() != mesh.mNumVertices || bakedMesh.indices.size() != mesh.mNumFaces * 3)
+					{
+						errorMessage = "vertex or index count mismatch for mesh " + std::to_string(meshIdx);
+						return false;
+					}
+					for (uint32_t vert = 0; vert < mesh.mNumVertices; ++vert)
+					{
+						const Vertex& v = bakedMesh.vertices[vert];
+						const aiVector3D& p = mesh.mVertices[vert];
+						const aiVector3D& n = mesh.mNormals[vert];
+						glm::vec2 expectedUV = mesh.mTextureCoords[0] ? glm::vec2(mesh.mTextureCoords[0][vert].x, mesh.mTextureCoords[0][vert].y) : glm::vec2(0.f);
+						glm::vec3 expectedTangent = glm::normalize(glm::vec3(mesh.mTangents[vert].x, mesh.mTangents[vert].y, mesh.mTangents[vert].z));
+						if (v.position != glm::vec3(p.x, p.y, p.z) || v.normal != glm::vec3(n.x, n.y, n.z) || v.textureCoords != expectedUV
+							|| std::memcmp(&bakedMesh.normalData[vert].tangent, &expectedTangent, sizeof(expectedTangent)) != 0) //bytes, so degenerate tangents compare equal
+						{
+							errorMessage = "vertex attributes do not match the imported mesh";
+							return false;
+						}
+						expectedMin = glm::min(expectedMin, v.position);
+						expectedMax = glm::max(expectedMax, v.position);
+					}
+					for (uint32_t face = 0; face < mesh.mNumFaces; ++face)
+					{
+						for (uint32_t corner = 0; corner < 3; ++corner)
+						{
+							if (bakedMesh.indices[face * 3 + corner] != mesh.mFaces[face].mIndices[corner])
+							{
+								errorMessage = "indices do not match faces";
+								return false;
+							}
+						}
+					}
+
+					const aiMaterial& material = *scene->mMaterials[mesh.mMaterialIndex];
+					std::vector<BakedTextureRef> expectedTextures;
+					const std::pair<aiTextureType, const char*> textureTypes[] = {
+						{ aiTextureType_DIFFUSE, "texture_diffuse" }, { aiTextureType_SPECULAR, "texture_specular" },
+						{ aiTextureType_AMBIENT, "texture_ambient" }, { aiTextureType_HEIGHT, "texture_normalmap" } };
+					for (const std::pair<aiTextureType, const char*>& textureType : textureTypes)
+					{
+						for (uint32_t texIdx = 0; texIdx < material.GetTextureCount(textureType.first); ++texIdx)
+						{
+							aiString texturePath;
+							material.GetTexture(textureType.first, texIdx, &texturePath);
+							expectedTextures.push_back({ textureType.second, texturePath.C_Str() });
+						}
+					}
+					if (bakedMesh.textures.size() != expectedTextures.size())
+					{
+						errorMessage = "texture count does not match the material";
+						return false;
+					}
+					for (size_t texIdx = 0; texIdx < expectedTextures.size(); ++texIdx)
+					{
+						const BakedTextureRef& texture = bakedMesh.textures[texIdx];
+						if (texture.type != expectedTextures[texIdx].type || texture.relativePath != expectedTextures[texIdx].relativePath)
+						{
+							errorMessage = "texture reference does not match the material";
+							return false;
+						}
+						bFoundDiffuse |= texture.type == "texture_diffuse" && texture.relativePath == "albedo.png";
+						bFoundNormalMap |= texture.type == "texture_normalmap" && texture.relativePath == "NormalMap_Tiled256_2046.png";
+					}
+				}
+				if (!bFoundDiffuse || !bFoundNormalMap)
+				{
+					errorMessage = "textures from the .mtl were not baked";
+					return false;
+				}
+				if (baked->aabbMin != expectedMin || baked->aabbMax != expectedMax)
+				{
+					errorMessage = "bounds do not match vertices";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// bone ids and weights; built by hand since the .obj models in game data have no skeletons
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BakeSharesBoneIds : public BakedModelCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Baked bones match assimp bones";
+
+				up<aiMesh> mesh = makeAssimpMesh(3, 1.f, { "a", "b", "c" });
+				std::map<std::string, int> boneIdsByName = { { "b", 7 } }; //"b" was already seen on an earlier mesh
+				glm::vec3 aabbMin(0.f), aabbMax(0.f);
+				BakedMesh baked = ModelBake::bakeMesh(*mesh, boneIdsByName, aabbMin, aabbMax);
+
+				if (baked.vertexBoneData.size() != mesh->mNumVertices || baked.bones.size() != 3)
+				{
+					errorMessage = "bone data count mismatch";
+					return false;
+				}
+
+				const int expectedIds[] = { 1, 7, 2 }; //new bones are numbered by how many were seen before them
+				for (uint32_t boneIdx = 0; boneIdx < 3; ++boneIdx)
+				{
+					if (baked.bones[boneIdx].uniqueID != expectedIds[boneIdx])
+					{
+						errorMessage = "bone ids not shared across meshes";
+						return false;
+					}
+					for (uint32_t vert = 0; vert < mesh->mNumVertices; ++vert)
+					{
+						const VertexBoneData& boneData = baked.vertexBoneData[vert];
+						if (boneData.boneIds[boneIdx] != unsigned(expectedIds[boneIdx]) || boneData.boneWeights[boneIdx] != mesh->mBones[boneIdx]->mWeights[vert].mWeight || boneData.currentBone != 3)
+						{
+							errorMessage = "vertex bone weights do not match assimp bones";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// a model read back from the cache is identical to the one that was written
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_CacheRoundTrip : public BakedModelCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cache round trip is exact";
+
+				ScopedTempDir tempDir("sa_baked_model_round_trip");
+				std::string cachePath = tempDir.file("ship.fbx.sabake");
+
+				up<BakedModel> original = makeBakedModel();
+				if (!ModelBake::writeCache(cachePath, *original, 1234))
+				{
+					errorMessage = "failed to write cache";
+					return false;
+				}
+
+				up<BakedModel> loaded = ModelBake::readCache(cachePath, 1234);
+				if (!loaded)
+				{
+					errorMessage = "failed to read back cache";
+					return false;
+				}
+				if (!modelsEqual(*original, *loaded, errorMessage))
+				{
+					return false;
+				}
+
+				//also through loadOrBake, which must take the cache instead of importing
+				std::string modelPath = tempDir.file("ship.fbx");
+				std::vector<char> sourceBytes = { 'n', 'o', 't', ' ', 'a', ' ', 'm', 'o', 'd', 'e', 'l' };
+				writeFile(modelPath, sourceBytes);
+				uint64_t sourceHash = 0;
+				ModelBake::hashModelSource(modelPath, sourceHash);
+				ModelBake::writeCache(modelPath + ModelBake::cacheFileExtension, *original, sourceHash);
+				up<BakedModel> viaLoad = ModelBake::loadOrBake(modelPath);
+				if (!viaLoad || !modelsEqual(*original, *viaLoad, errorMessage))
+				{
+					errorMessage = "loadOrBake did not use the cache: " + errorMessage;
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// caches for a different source, format version, or that are damaged are rejected
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_StaleCacheRejected : public BakedModelCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Stale or damaged caches rejected";
+
+				ScopedTempDir tempDir("sa_baked_model_stale");
+				std::string cachePath = tempDir.file("ship.obj.sabake");
+				up<BakedModel> original = makeBakedModel();
+				ModelBake::writeCache(cachePath, *original, 42);
+				const std::vector<char> goodBytes = readFile(cachePath);
+
+				if (ModelBake::readCache(cachePath, 43))
+				{
+					errorMessage = "cache accepted for a different source hash";
+					return false;
+				}
+
+				std::vector<char> bytes = goodBytes;
+				bytes[8] ^= 0x1; //version field follows the 8 byte magic
+				writeFile(cachePath, bytes);
+				if (ModelBake::readCache(cachePath, 42))
+				{
+					errorMessage = "cache accepted with a different format version";
+					return false;
+				}
+
+				bytes = goodBytes;
+				bytes.resize(bytes.size() - 5);
+				writeFile(cachePath, bytes);
+				if (ModelBake::readCache(cachePath, 42))
+				{
+					errorMessage = "truncated cache accepted";
+					return false;
+				}
+
+				bytes = goodBytes;
+				bytes[bytes.size() / 2] ^= 0x40;
+				writeFile(cachePath, bytes);
+				if (ModelBake::readCache(cachePath, 42))
+				{
+					errorMessage = "corrupt cache accepted";
+					return false;
+				}
+
+				writeFile(cachePath, goodBytes);
+				if (!ModelBake::readCache(cachePath, 42))
+				{
+					errorMessage = "restored cache rejected";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// editing an .obj's material library rebuilds the cache, since the texture paths come from it
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		static std::vector<char> toBytes(const std::string& text)
+		{
+			return std::vector<char>(text.begin(), text.end());
+		}
+
+		static std::string bakedDiffusePath(const BakedModel* model)
+		{
+			if (model && model->meshes.size() == 1)
+			{
+				for (const BakedTextureRef& texture : model->meshes[0].textures)
+				{
+					if (texture.type == "texture_diffuse") { return texture.relativePath; }
+				}
+			}
+			return "";
+		}
+
+		class Test_MaterialEditRebuildsCache : public BakedModelCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Material library edit rebuilds cache";
+
+				ScopedTempDir tempDir("sa_baked_model_material_edit");
+				std::string modelPath = tempDir.file("quad.obj");
+				writeFile(modelPath, toBytes(
+					"mtllib quad.mtl\n"
+					"o Quad\n"
+					"v -1.0 0.0 -1.0\nv 1.0 0.0 -1.0\nv 1.0 0.0 1.0\nv -1.0 0.0 1.0\n"
+					"vt 0.0 0.0\nvt 1.0 0.0\nvt 1.0 1.0\nvt 0.0 1.0\n"
+					"vn 0.0 1.0 0.0\n"
+					"usemtl QuadMaterial\n"
+					"f 1/1/1 2/2/1 3/3/1 4/4/1\n"));
+				writeFile(tempDir.file("quad.mtl"), toBytes("newmtl QuadMaterial\nKd 0.8 0.8 0.8\nmap_Kd first_albedo.png\n"));
+
+				if (bakedDiffusePath(ModelBake::loadOrBake(modelPath).get()) != "first_albedo.png"
+					|| !std::filesystem::exists(modelPath + ModelBake::cacheFileExtension))
+				{
+					errorMessage = "initial bake did not pick up the material texture or write a cache";
+					return false;
+				}
+				if (bakedDiffusePath(ModelBake::loadOrBake(modelPath).get()) != "first_albedo.png")
+				{
+					errorMessage = "cached load lost the material texture";
+					return false;
+				}
+
+				//only the .mtl changes; the .obj bytes are untouched
+				writeFile(tempDir.file("quad.mtl"), toBytes("newmtl QuadMaterial\nKd 0.8 0.8 0.8\nmap_Kd second_albedo.png\n"));
+				if (bakedDiffusePath(ModelBake::loadOrBake(modelPath).get()) != "second_albedo.png")
+				{
+					errorMessage = "stale cache used after the material library changed";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class BakedModelCacheTestSuite : public SA::TestSuite
+		{
+		public:
+			BakedModelCacheTestSuite()
+			{
+				testName = "BAKED MODEL CACHE TEST SUITE";
+
+				addTest(new_sp<Test_BakeMatchesAssimpImport>());
+				addTest(new_sp<Test_BakeSharesBoneIds>());
+				addTest(new_sp<Test_CacheRoundTrip>());
+				addTest(new_sp<Test_StaleCacheRejected>());
+				addTest(new_sp<Test_MaterialEditRebuildsCache>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getBakedModelCacheTestSuite()
+	{
+		return new_sp<SA::BakedModelCacheTests::BakedModelCacheTestSuite>();
+	}
+}
@@ -0,0 +1,249 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/SABehaviorTree.h"
+
+namespace SA
+{
+	namespace BehaviorTreeMemoryTests
+	{
+		using namespace BehaviorTree;
+
+		class BehaviorTreeMemory_UnitTest : public SA::UnitTest
+		{
+		public:
+			BehaviorTreeMemory_UnitTest()
+			{
+				testNamespace = "BehaviorTreeMemory:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct TestEntity : public GameEntity
+		{
+			int id = 0;
+		};
+
+		struct DelegateCounter : public GameEntity
+		{
+			void handleModified(const std::string& key, const GameEntity* value) { ++numModified; lastModifiedValue = value; }
+			void handleReplaced(const std::string& key, const GameEntity* oldValue, const GameEntity* newValue) { ++numReplaced; }
+
+			int numModified = 0;
+			int numReplaced = 0;
+			const GameEntity* lastModifiedValue = nullptr;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// keys intern to dense slots that stay valid, and string and key access reach the same entry
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_KeyInterning : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Key interning";
+
+				sp<Memory> memory = new_sp<Memory>();
+				if (memory->findKey("target").isValid())
+				{
+					errorMessage = "unused key was found";
+					return false;
+				}
+
+				MemoryKey targetKey = memory->internKey("target");
+				MemoryKey stateKey = memory->internKey("state");
+				if (targetKey.slot != 0 || stateKey.slot != 1 || memory->internKey("target").slot != 0 || memory->findKey("state").slot != 1
+					|| memory->getNumKeys() != 2 || memory->getKeyName(stateKey) != "state")
+				{
+					errorMessage = "keys not interned to dense stable slots";
+					return false;
+				}
+
+				//slots must not move as more keys are added
+				memory->setValue(stateKey, 3);
+				const int* stateValue = memory->getReadValueAs<int>(stateKey);
+				for (int keyIdx = 0; keyIdx < 1000; ++keyIdx)
+				{
+					memory->internKey("filler" + std::to_string(keyIdx));
+				}
+				if (memory->getReadValueAs<int>("state") != stateValue || *stateValue != 3)
+				{
+					errorMessage = "entry moved when memory grew";
+					return false;
+				}
+
+				sp<TestEntity> entity = new_sp<TestEntity>();
+				memory->replaceValue("target", entity);
+				if (memory->getReadValueAs<TestEntity>(targetKey) != entity.get() || memory->getMemoryReference<TestEntity>(targetKey) != entity)
+				{
+					errorMessage = "string write not visible through key";
+					return false;
+				}
+				if (memory->getReadValueAs<int>(MemoryKey{}) != nullptr || memory->hasValue(MemoryKey{}))
+				{
+					errorMessage = "invalid key returned a value";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// inline values read and write through the same calls as boxed values, with the same modify/replace rules
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_InlineValues : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Inline values";
+
+				sp<Memory> memory = new_sp<Memory>();
+				sp<DelegateCounter> counter = new_sp<DelegateCounter>();
+				MemoryKey positionKey = memory->internKey("position");
+				memory->getModifiedDelegate(positionKey).addWeakObj(counter, &DelegateCounter::handleModified);
+				memory->getReplacedDelegate(positionKey).addWeakObj(counter, &DelegateCounter::handleReplaced);
+
+				memory->replaceValue(positionKey, new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3(1.f)));
+				const glm::vec3* boxed = memory->getReadValueAs<glm::vec3>(positionKey);
+				if (!boxed || *boxed != glm::vec3(1.f) || !memory->getMemoryReference<PrimitiveWrapper<glm::vec3>>(positionKey))
+				{
+					errorMessage = "boxed value not readable";
+					return false;
+				}
+
+				//boxed to inline is a replace; inline to the same type is only a modify
+				memory->setValue(positionKey, glm::vec3(2.f));
+				memory->setValue(positionKey, glm::vec3(3.f));
+				if (counter->numReplaced != 2 || counter->numModified != 3 || counter->lastModifiedValue != nullptr)
+				{
+					errorMessage = "inline writes broadcast incorrectly";
+					return false;
+				}
+
+				{
+					ScopedUpdateNotifier<glm::vec3> position_writable;
+					if (!memory->getWriteValueAs(positionKey, position_writable))
+					{
+						errorMessage = "could not write inline value";
+						return false;
+					}
+					position_writable.get().x = 5.f;
+				}
+				if (counter->numModified != 4 || memory->getReadValueAs<glm::vec3>("position")->x != 5.f)
+				{
+					errorMessage = "scoped write to inline value did not modify";
+					return false;
+				}
+
+				if (memory->getReadValueAs<int>(positionKey) || memory->getMemoryReference<PrimitiveWrapper<glm::vec3>>(positionKey))
+				{
+					errorMessage = "inline value read as the wrong type";
+					return false;
+				}
+
+				if (!memory->removeValue(positionKey) || memory->hasValue(positionKey) || memory->getReadValueAs<glm::vec3>(positionKey) || counter->numReplaced != 3)
+				{
+					errorMessage = "inline value not removed";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// weak values do not keep entities alive
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_WeakValues : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Weak values";
+
+				sp<Memory> memory = new_sp<Memory>();
+				sp<DelegateCounter> counter = new_sp<DelegateCounter>();
+				MemoryKey targetKey = memory->internKey("target");
+				memory->getModifiedDelegate(targetKey).addWeakObj(counter, &DelegateCounter::handleModified);
+
+				sp<TestEntity> entity = new_sp<TestEntity>();
+				entity->id = 7;
+				memory->setWeakValue(targetKey, wp<TestEntity>(entity));
+
+				const TestEntity* read = memory->getReadValueAs<TestEntity>(targetKey);
+				if (!read || read->id != 7 || !memory->hasValue(targetKey) || counter->lastModifiedValue != entity.get())
+				{
+					errorMessage = "weak value not readable";
+					return false;
+				}
+
+				wp<TestEntity> observer = entity;
+				entity = nullptr;
+				if (!observer.expired() || memory->hasValue(targetKey) || memory->getReadValueAs<TestEntity>(targetKey) || memory->getMemoryReference<TestEntity>(targetKey))
+				{
+					errorMessage = "memory kept a weak entity alive";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// removing a value keeps listeners; erasing drops them but the key keeps its slot
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_RemoveAndErase : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Remove and erase";
+
+				sp<Memory> memory = new_sp<Memory>();
+				sp<DelegateCounter> counter = new_sp<DelegateCounter>();
+				MemoryKey countKey = memory->internKey("count");
+				memory->getReplacedDelegate(countKey).addWeakObj(counter, &DelegateCounter::handleReplaced);
+
+				memory->setValue(countKey, 1);
+				memory->removeValue("count");
+				memory->setValue(countKey, 2);
+				if (counter->numReplaced != 3)
+				{
+					errorMessage = "listener lost after removeValue";
+					return false;
+				}
+
+				if (!memory->eraseEntry("count") || memory->eraseEntry("count") || memory->eraseEntry("never used"))
+				{
+					errorMessage = "erase results incorrect";
+					return false;
+				}
+				memory->setValue(countKey, 3);
+				if (counter->numReplaced != 4 || memory->findKey("count").slot != countKey.slot || *memory->getReadValueAs<int>(countKey) != 3)
+				{
+					errorMessage = "erase did not drop listeners or invalidated the key";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class BehaviorTreeMemoryTestSuite : public SA::TestSuite
+		{
+		public:
+			BehaviorTreeMemoryTestSuite()
+			{
+				testName = "BEHAVIOR TREE MEMORY TEST SUITE";
+
+				addTest(new_sp<Test_KeyInterning>());
+				addTest(new_sp<Test_InlineValues>());
+				addTest(new_sp<Test_WeakValues>());
+				addTest(new_sp<Test_RemoveAndErase>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getBehaviorTreeMemoryTestSuite()
+	{
+		return new_sp<SA::BehaviorTreeMemoryTests::BehaviorTreeMemoryTestSuite>();
+	}
+}
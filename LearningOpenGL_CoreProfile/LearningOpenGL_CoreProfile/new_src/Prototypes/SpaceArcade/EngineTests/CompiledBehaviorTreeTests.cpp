@@ -0,0 +1,857 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/SACompiledBehaviorTree.h"
+#include "../GameFramework/SARandomNumberGenerationSystem.h"
+#include "../GameFramework/TimeManagement/TimerWheel.h"
+
+#include <random>
+#include <algorithm>
+
+namespace SA
+{
+	namespace CompiledBehaviorTreeTests
+	{
+		using namespace BehaviorTree;
+
+		class CompiledBehaviorTree_UnitTest : public SA::UnitTest
+		{
+		public:
+			CompiledBehaviorTree_UnitTest()
+			{
+				testNamespace = "CompiledBehaviorTree:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		///
+		/// A tree is described once as a NodeSpec and built both as interpreter nodes and as a compiled definition.
+		/// Tasks, decorators and services in both forms log the same events, so the logs can be compared tick by tick.
+		/// The interpreter's services run on a TimerWheel the test advances, and its random nodes share one seeded
+		/// generator, seeded like the compiled group's; ticks are a power of two seconds so both clocks stay exact.
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct NodeSpec
+		{
+			enum class Kind { SELECTOR, SEQUENCE, DECORATOR, SERVICE, LOOP, RANDOM, TASK };
+			Kind kind = Kind::TASK;
+			std::string name;
+			std::vector<NodeSpec> children;
+
+			//tasks
+			uint32_t ticksToComplete = 0;	//0 completes in beginTask
+			bool bSucceeds = true;
+			std::string toggleKey;			//flipped when the task begins
+
+			//decorators; pass when key's value equals bExpected
+			std::string key;
+			bool bExpected = true;
+			bool bWatchesKey = false;
+			Decorator::AbortType abortType = Decorator::AbortType::ChildTree;
+
+			//services
+			float tickSecs = 0.25f;
+			bool bServiceLoops = true;
+
+			//loops; 0 loops forever
+			uint32_t numLoops = 1;
+
+			//random nodes; per child, in child order
+			std::vector<uint32_t> chancePoints;
+		};
+
+		class InterpretedTask;
+
+		struct TraceLog : public GameEntity
+		{
+			TraceLog(size_t numInstances) : events(numInstances), deferredTasks(numInstances) {}
+
+			std::vector<std::vector<std::string>> events;					//per instance
+			std::vector<std::vector<InterpretedTask*>> deferredTasks;		//per instance; the interpreter's stand-in for timers
+		};
+
+		static const char* const KEYS[] = { "a", "b", "c" };
+
+		static MemoryInitializer makeInitialMemory()
+		{
+			return MemoryInitializer{
+				{ "a", new_sp<PrimitiveWrapper<bool>>(false) },
+				{ "b", new_sp<PrimitiveWrapper<bool>>(true) },
+				{ "c", new_sp<PrimitiveWrapper<bool>>(false) } };
+		}
+
+		static void toggle(Memory& memory, const std::string& key)
+		{
+			const bool* value = memory.getReadValueAs<bool>(key);
+			memory.setValue(key, !(value && *value));
+		}
+
+		static bool readKey(const Memory& memory, const std::string& key)
+		{
+			const bool* value = memory.getReadValueAs<bool>(key);
+			return value && *value;
+		}
+
+		///////////////////////////////////////////////////////////
+		// interpreter nodes
+		///////////////////////////////////////////////////////////
+		class InterpretedTask : public Task
+		{
+		public:
+			InterpretedTask(const NodeSpec& spec, const sp<TraceLog>& log, size_t instance)
+				: Task(spec.name), spec(spec), log(log), instance(instance) {}
+
+			/** Called before each tick, like a timer would */
+			bool advanceDeferred()
+			{
+				if (--remainingTicks == 0)
+				{
+					evaluationResult = spec.bSucceeds;
+					return true;
+				}
+				return false;
+			}
+
+		protected:
+			virtual void beginTask() override
+			{
+				log->events[instance].push_back("begin " + getName());
+				if (!spec.toggleKey.empty())
+				{
+					toggle(getMemory(), spec.toggleKey);
+				}
+				if (spec.ticksToComplete == 0)
+				{
+					evaluationResult = spec.bSucceeds;
+				}
+				else
+				{
+					remainingTicks = spec.ticksToComplete;
+					log->deferredTasks[instance].push_back(this);
+				}
+			}
+			virtual void taskCleanup() override
+			{
+				log->events[instance].push_back("cleanup " + getName());
+				std::vector<InterpretedTask*>& deferred = log->deferredTasks[instance];
+				deferred.erase(std::remove(deferred.begin(), deferred.end(), this), deferred.end());
+			}
+			virtual void handleNodeAborted() override
+			{
+				log->events[instance].push_back("abort " + getName());
+			}
+
+		private:
+			NodeSpec spec;
+			sp<TraceLog> log;
+			size_t instance;
+			uint32_t remainingTicks = 0;
+		};
+
+		class InterpretedDecorator : public Decorator
+		{
+		public:
+			InterpretedDecorator(const NodeSpec& spec, const sp<NodeBase>& child) : Decorator(spec.name, child), spec(spec) {}
+
+		protected:
+			virtual void notifyTreeEstablished() override
+			{
+				if (spec.bWatchesKey)
+				{
+					getMemory().getModifiedDelegate(spec.key).addWeakObj(sp_this(), &InterpretedDecorator::handleValueModified);
+				}
+			}
+			virtual void startBranchConditionCheck() override
+			{
+				conditionalResult = passes();
+			}
+			virtual void handleNodeAborted() override {}
+
+		private:
+			bool passes() const { return readKey(getMemory(), spec.key) == spec.bExpected; }
+
+			void handleValueModified(const std::string& key, const GameEntity* value)
+			{
+				//abort the running child tree once the condition fails, or lower priority trees once it passes
+				if (isOnExecutionStack() ? !passes() : passes())
+				{
+					abortTree(spec.abortType);
+				}
+			}
+
+		private:
+			NodeSpec spec;
+		};
+
+		class InterpretedService : public Service
+		{
+		public:
+			InterpretedService(const NodeSpec& spec, const sp<TraceLog>& log, size_t instance, const sp<NodeBase>& child)
+				: Service(spec.name, spec.tickSecs, spec.bServiceLoops, child), log(log), instance(instance) {}
+
+		private:
+			virtual void serviceTick() override { log->events[instance].push_back("service tick " + getName()); }
+			virtual void startService() override { log->events[instance].push_back("service start " + getName()); }
+			virtual void stopService() override { log->events[instance].push_back("service stop " + getName()); }
+
+		private:
+			sp<TraceLog> log;
+			size_t instance;
+		};
+
+		static sp<NodeBase> buildInterpreted(const NodeSpec& spec, const sp<TraceLog>& log, size_t instance, const sp<RNG>& rng)
+		{
+			std::vector<sp<NodeBase>> children;
+			for (const NodeSpec& child : spec.children)
+			{
+				children.push_back(buildInterpreted(child, log, instance, rng));
+			}
+
+			switch (spec.kind)
+			{
+				case NodeSpec::Kind::SELECTOR: return new_sp<Selector>(spec.name, children);
+				case NodeSpec::Kind::SEQUENCE: return new_sp<Sequence>(spec.name, children);
+				case NodeSpec::Kind::DECORATOR: return new_sp<InterpretedDecorator>(spec, children[0]);
+				case NodeSpec::Kind::SERVICE: return new_sp<InterpretedService>(spec, log, instance, children[0]);
+				case NodeSpec::Kind::LOOP: return new_sp<Loop>(spec.name, spec.numLoops, children[0]);
+				case NodeSpec::Kind::RANDOM:
+				{
+					Chances chances;
+					for (size_t childIdx = 0; childIdx < spec.children.size(); ++childIdx)
+					{
+						chances.push_back({ spec.children[childIdx].name, spec.chancePoints[childIdx] });
+					}
+					return new_sp<Random>(spec.name, chances, children, rng);
+				}
+				case NodeSpec::Kind::TASK:
+				default:
+					return new_sp<InterpretedTask>(spec, log, instance);
+			}
+		}
+
+		///////////////////////////////////////////////////////////
+		// compiled behaviors; shared by all instances, so state lives in userValue
+		///////////////////////////////////////////////////////////
+		class LoggingTask : public CompiledTask
+		{
+		public:
+			LoggingTask(const NodeSpec& spec, const sp<TraceLog>& log) : spec(spec), log(log) {}
+
+			virtual CompiledStatus begin(CompiledNodeContext& context) override
+			{
+				log->events[context.instance].push_back("begin " + spec.name);
+				if (!spec.toggleKey.empty())
+				{
+					toggle(context.memory, spec.toggleKey);
+				}
+				if (spec.ticksToComplete == 0)
+				{
+					return finished();
+				}
+				context.userValue = spec.ticksToComplete;
+				return CompiledStatus::RUNNING;
+			}
+			virtual CompiledStatus poll(CompiledNodeContext& context) override
+			{
+				return --context.userValue == 0 ? finished() : CompiledStatus::RUNNING;
+			}
+			virtual void abort(CompiledNodeContext& context) override
+			{
+				log->events[context.instance].push_back("abort " + spec.name);
+			}
+			virtual void cleanup(CompiledNodeContext& context) override
+			{
+				log->events[context.instance].push_back("cleanup " + spec.name);
+			}
+
+		private:
+			CompiledStatus finished() const { return spec.bSucceeds ? CompiledStatus::SUCCEEDED : CompiledStatus::FAILED; }
+
+		private:
+			NodeSpec spec;
+			sp<TraceLog> log;
+		};
+
+		class KeyEqualsCondition : public CompiledCondition
+		{
+		public:
+			KeyEqualsCondition(MemoryKey key, bool bExpected) : key(key), bExpected(bExpected) {}
+
+			virtual CompiledStatus check(CompiledNodeContext& context) override
+			{
+				const bool* value = context.memory.getReadValueAs<bool>(key);
+				return (value && *value) == bExpected ? CompiledStatus::SUCCEEDED : CompiledStatus::FAILED;
+			}
+
+		private:
+			MemoryKey key;
+			bool bExpected;
+		};
+
+		class LoggingService : public CompiledService
+		{
+		public:
+			LoggingService(const std::string& name, const sp<TraceLog>& log) : name(name), log(log) {}
+
+			virtual void start(CompiledNodeContext& context) override { log->events[context.instance].push_back("service start " + name); }
+			virtual void tick(CompiledNodeContext& context) override { log->events[context.instance].push_back("service tick " + name); }
+			virtual void stop(CompiledNodeContext& context) override { log->events[context.instance].push_back("service stop " + name); }
+
+		private:
+			std::string name;
+			sp<TraceLog> log;
+		};
+
+		static CompiledMemoryLayout makeLayout()
+		{
+			CompiledMemoryLayout layout;
+			for (const char* key : KEYS)
+			{
+				layout.add(key);
+			}
+			return layout;
+		}
+
+		static CompiledNodeDef buildCompiled(const NodeSpec& spec, const sp<TraceLog>& log, const CompiledMemoryLayout& layout)
+		{
+			std::vector<CompiledNodeDef> children;
+			for (const NodeSpec& child : spec.children)
+			{
+				children.push_back(buildCompiled(child, log, layout));
+			}
+
+			switch (spec.kind)
+			{
+				case NodeSpec::Kind::SELECTOR: return CompiledNodeDef::selector(spec.name, children);
+				case NodeSpec::Kind::SEQUENCE: return CompiledNodeDef::sequence(spec.name, children);
+				case NodeSpec::Kind::DECORATOR:
+				{
+					const MemoryKey key = layout.find(spec.key);
+					sp<CompiledCondition> condition = new_sp<KeyEqualsCondition>(key, spec.bExpected);
+					return spec.bWatchesKey
+						? CompiledNodeDef::abortingDecorator(spec.name, condition, key, spec.abortType, children[0])
+						: CompiledNodeDef::decorator(spec.name, condition, children[0]);
+				}
+				case NodeSpec::Kind::SERVICE: return CompiledNodeDef::service(spec.name, new_sp<LoggingService>(spec.name, log), spec.tickSecs, spec.bServiceLoops, children[0]);
+				case NodeSpec::Kind::LOOP: return CompiledNodeDef::loop(spec.name, spec.numLoops, children[0]);
+				case NodeSpec::Kind::RANDOM: return CompiledNodeDef::random(spec.name, spec.chancePoints, children);
+				case NodeSpec::Kind::TASK:
+				default:
+					return CompiledNodeDef::task(spec.name, new_sp<LoggingTask>(spec, log));
+			}
+		}
+
+		///////////////////////////////////////////////////////////
+		// tree generation and comparison
+		///////////////////////////////////////////////////////////
+		static NodeSpec makeTask(const std::string& name, uint32_t ticksToComplete, bool bSucceeds, const std::string& toggleKey = "")
+		{
+			NodeSpec spec;
+			spec.name = name;
+			spec.ticksToComplete = ticksToComplete;
+			spec.bSucceeds = bSucceeds;
+			spec.toggleKey = toggleKey;
+			return spec;
+		}
+
+		static NodeSpec makeComposite(NodeSpec::Kind kind, const std::string& name, const std::vector<NodeSpec>& children)
+		{
+			NodeSpec spec;
+			spec.kind = kind;
+			spec.name = name;
+			spec.children = children;
+			return spec;
+		}
+
+		static NodeSpec makeDecorator(const std::string& name, const std::string& key, bool bExpected, bool bWatchesKey, Decorator::AbortType abortType, const NodeSpec& child)
+		{
+			NodeSpec spec;
+			spec.kind = NodeSpec::Kind::DECORATOR;
+			spec.name = name;
+			spec.key = key;
+			spec.bExpected = bExpected;
+			spec.bWatchesKey = bWatchesKey;
+			spec.abortType = abortType;
+			spec.children.push_back(child);
+			return spec;
+		}
+
+		static NodeSpec makeService(const std::string& name, float tickSecs, bool bLoops, const NodeSpec& child)
+		{
+			NodeSpec spec;
+			spec.kind = NodeSpec::Kind::SERVICE;
+			spec.name = name;
+			spec.tickSecs = tickSecs;
+			spec.bServiceLoops = bLoops;
+			spec.children.push_back(child);
+			return spec;
+		}
+
+		static NodeSpec makeLoop(const std::string& name, uint32_t numLoops, const NodeSpec& child)
+		{
+			NodeSpec spec;
+			spec.kind = NodeSpec::Kind::LOOP;
+			spec.name = name;
+			spec.numLoops = numLoops;
+			spec.children.push_back(child);
+			return spec;
+		}
+
+		static NodeSpec makeRandom(const std::string& name, const std::vector<uint32_t>& chancePoints, const std::vector<NodeSpec>& children)
+		{
+			NodeSpec spec = makeComposite(NodeSpec::Kind::RANDOM, name, children);
+			spec.chancePoints = chancePoints;
+			return spec;
+		}
+
+		static NodeSpec makeRandomSpec(std::mt19937& rng, uint32_t depth, uint32_t& inOut_nodeCount)
+		{
+			const std::string name = "n" + std::to_string(inOut_nodeCount++);
+			std::uniform_int_distribution<int> percent(0, 99);
+			std::uniform_int_distribution<int> keyRoll(0, 2);
+
+			if (depth >= 4 || percent(rng) < 30)
+			{
+				std::uniform_int_distribution<uint32_t> ticksRoll(0, 2);
+				const bool bToggles = percent(rng) < 20;
+				return makeTask(name, ticksRoll(rng), percent(rng) < 70, bToggles ? KEYS[keyRoll(rng)] : "");
+			}
+
+			const int kindRoll = percent(rng);
+			if (kindRoll < 25)
+			{
+				std::uniform_int_distribution<int> abortRoll(0, 2);
+				NodeSpec child = makeRandomSpec(rng, depth + 1, inOut_nodeCount);
+				return makeDecorator(name, KEYS[keyRoll(rng)], percent(rng) < 50, percent(rng) < 60, Decorator::AbortType(abortRoll(rng)), child);
+			}
+			if (kindRoll < 35)
+			{
+				//includes a period shorter than a tick, so a looping service fires more than once in some ticks
+				static const float tickSecsChoices[] = { 0.0625f, 0.125f, 0.25f, 0.375f };
+				std::uniform_int_distribution<int> tickRoll(0, 3);
+				NodeSpec child = makeRandomSpec(rng, depth + 1, inOut_nodeCount);
+				return makeService(name, tickSecsChoices[tickRoll(rng)], percent(rng) < 75, child);
+			}
+			if (kindRoll < 45)
+			{
+				std::uniform_int_distribution<uint32_t> loopsRoll(0, 3);
+				NodeSpec child = makeRandomSpec(rng, depth + 1, inOut_nodeCount);
+				return makeLoop(name, loopsRoll(rng), child);
+			}
+
+			std::uniform_int_distribution<int> numChildrenRoll(1, 3);
+			const int numChildren = numChildrenRoll(rng);
+			std::vector<NodeSpec> children;
+			for (int childIdx = 0; childIdx < numChildren; ++childIdx)
+			{
+				children.push_back(makeRandomSpec(rng, depth + 1, inOut_nodeCount));
+			}
+			if (kindRoll < 55)
+			{
+				std::uniform_int_distribution<uint32_t> pointsRoll(0, 3);
+				std::vector<uint32_t> chancePoints;
+				for (int childIdx = 0; childIdx < numChildren; ++childIdx)
+				{
+					chancePoints.push_back(pointsRoll(rng));
+				}
+				chancePoints[0] += 1; //at least one child must be choosable
+				return makeRandom(name, chancePoints, children);
+			}
+			return makeComposite(kindRoll < 80 ? NodeSpec::Kind::SELECTOR : NodeSpec::Kind::SEQUENCE, name, children);
+		}
+
+		/** Runs both engines side by side with the same memory writes between ticks; fails on the first tick whose events or current node differ. */
+		static bool compareEngines(const NodeSpec& rootSpec, size_t numInstances, uint32_t numTicks, uint32_t scriptSeed, std::string& outError)
+		{
+			constexpr float tickSecs = 0.125f;
+
+			sp<TraceLog> interpretedLog = new_sp<TraceLog>(numInstances);
+			sp<TraceLog> compiledLog = new_sp<TraceLog>(numInstances);
+
+			//stands in for the level's time manager; every interpreted tree's services share it like they would share the level's
+			sp<TimerWheel> serviceTimers = new_sp<TimerWheel>();
+
+			//one generator across the interpreted trees; it is drawn from in the same order the group draws from its own
+			sp<RNG> interpretedRNG = RNGSystem::getSeededRNG(scriptSeed);
+
+			std::vector<sp<Tree>> trees;
+			for (size_t instance = 0; instance < numInstances; ++instance)
+			{
+				trees.push_back(new_sp<Tree>("interpreted", buildInterpreted(rootSpec, interpretedLog, instance, interpretedRNG), makeInitialMemory()));
+				trees.back()->setServiceTimers(serviceTimers);
+				trees.back()->start();
+			}
+
+			const CompiledMemoryLayout layout = makeLayout();
+			CompiledTreeGroup group(CompiledTreeDefinition::compile("compiled", buildCompiled(rootSpec, compiledLog, layout), layout), RNGSystem::getSeededRNG(scriptSeed));
+			for (size_t instance = 0; instance < numInstances; ++instance)
+			{
+				const uint32_t instanceIdx = group.addInstance(makeInitialMemory());
+				assert(instanceIdx == instance);
+				group.start(instanceIdx);
+			}
+
+			std::mt19937 script(scriptSeed);
+			std::uniform_int_distribution<int> percent(0, 99);
+			for (uint32_t tick = 0; tick < numTicks; ++tick)
+			{
+				//level time advances before brains tick
+				serviceTimers->advance(tickSecs);
+
+				for (size_t instance = 0; instance < numInstances; ++instance)
+				{
+					for (const char* key : KEYS)
+					{
+						if (percent(script) < 15)
+						{
+							toggle(trees[instance]->getMemory(), key);
+							toggle(group.getMemory(uint32_t(instance)), key);
+						}
+					}
+
+					std::vector<InterpretedTask*> deferred = interpretedLog->deferredTasks[instance];
+					for (InterpretedTask* task : deferred)
+					{
+						if (task->advanceDeferred())
+						{
+							std::vector<InterpretedTask*>& pending = interpretedLog->deferredTasks[instance];
+							pending.erase(std::remove(pending.begin(), pending.end(), task), pending.end());
+						}
+					}
+					trees[instance]->tick(tickSecs);
+				}
+				group.tick(tickSecs);
+
+				for (size_t instance = 0; instance < numInstances; ++instance)
+				{
+					const std::string priorityEvent = "@" + std::to_string(trees[instance]->getCurrentPriority());
+					interpretedLog->events[instance].push_back(priorityEvent);
+					compiledLog->events[instance].push_back("@" + std::to_string(group.getCurrentPriority(uint32_t(instance))));
+
+					const std::vector<std::string>& expected = interpretedLog->events[instance];
+					const std::vector<std::string>& actual = compiledLog->events[instance];
+					if (expected != actual)
+					{
+						size_t firstDifference = 0;
+						while (firstDifference < expected.size() && firstDifference < actual.size() && expected[firstDifference] == actual[firstDifference])
+						{
+							++firstDifference;
+						}
+						outError = "tick " + std::to_string(tick) + " instance " + std::to_string(instance) + ": interpreter \""
+							+ (firstDifference < expected.size() ? expected[firstDifference] : "<end>") + "\" compiled \""
+							+ (firstDifference < actual.size() ? actual[firstDifference] : "<end>") + "\"";
+						return false;
+					}
+					for (const char* key : KEYS)
+					{
+						if (readKey(trees[instance]->getMemory(), key) != readKey(group.getMemory(uint32_t(instance)), key))
+						{
+							outError = "tick " + std::to_string(tick) + " instance " + std::to_string(instance) + ": memory differs at key " + key;
+							return false;
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		static size_t countEvents(const std::vector<std::string>& events, const std::string& event)
+		{
+			return size_t(std::count(events.begin(), events.end(), event));
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// a hand written combat tree with deferred tasks, a watching decorator and memory written by tasks
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesInterpreterCombatTree : public CompiledBehaviorTree_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Matches interpreter on combat tree";
+
+				using Kind = NodeSpec::Kind;
+				const NodeSpec root = makeComposite(Kind::SELECTOR, "root", {
+					makeDecorator("has target", "a", true, true, Decorator::AbortType::ChildAndLowerPriortyTrees,
+						makeComposite(Kind::SEQUENCE, "attack", {
+							makeTask("aim", 1, true),
+							makeTask("fire", 0, true, "c"),
+							makeTask("reload", 2, true)
+						})),
+					makeDecorator("is calm", "b", true, true, Decorator::AbortType::ChildTree,
+						makeComposite(Kind::SEQUENCE, "patrol", {
+							makeTask("pick point", 0, true),
+							makeTask("fly to point", 3, true)
+						})),
+					makeTask("idle", 1, false)
+				});
+
+				std::string error;
+				for (uint32_t scriptSeed = 0; scriptSeed < 20; ++scriptSeed)
+				{
+					if (!compareEngines(root, 2, 80, scriptSeed, error))
+					{
+						errorMessage = "script " + std::to_string(scriptSeed) + " " + error;
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// shaped like FighterBrain's tree: nested services over an infinite loop, state decorators, and a looping random evade
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesInterpreterFighterTree : public CompiledBehaviorTree_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Matches interpreter on fighter tree";
+
+				using Kind = NodeSpec::Kind;
+				const NodeSpec root =
+					makeService("target finder", 1.f, true,
+					makeService("attacker setter", 0.5f, true,
+					makeService("opportunistic shots", 0.125f, true,
+						makeLoop("fighter loop", 0,
+							makeComposite(Kind::SELECTOR, "state selector", {
+								makeDecorator("evade state", "a", true, true, Decorator::AbortType::ChildAndLowerPriortyTrees,
+									makeComposite(Kind::SEQUENCE, "evade to dogfight", {
+										makeTask("find dogfight location", 0, true),
+										makeLoop("evade loop", 0,
+											makeRandom("evade pattern", { 1, 1 }, {
+												makeTask("spiral evade", 3, true),
+												makeTask("spiral spin", 2, true, "c")
+											}))
+									})),
+								makeDecorator("attack state", "b", true, true, Decorator::AbortType::ChildAndLowerPriortyTrees,
+									makeTask("dogfight", 4, false, "a")),
+								makeDecorator("wander state", "b", false, true, Decorator::AbortType::ChildAndLowerPriortyTrees,
+									makeComposite(Kind::SEQUENCE, "move to new location", {
+										makeTask("find random location", 0, true),
+										makeTask("move to location", 5, true, "b")
+									}))
+							})))));
+
+				std::string error;
+				for (uint32_t scriptSeed = 0; scriptSeed < 20; ++scriptSeed)
+				{
+					if (!compareEngines(root, 3, 120, scriptSeed, error))
+					{
+						errorMessage = "script " + std::to_string(scriptSeed) + " " + error;
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// generated trees of every node type match the interpreter step for step
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesInterpreterGeneratedTrees : public CompiledBehaviorTree_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Matches interpreter on generated trees";
+
+				std::mt19937 rng(1234);
+				std::string error;
+				for (uint32_t treeIdx = 0; treeIdx < 150; ++treeIdx)
+				{
+					uint32_t nodeCount = 0;
+					NodeSpec root = makeRandomSpec(rng, 0, nodeCount);
+					if (root.kind == NodeSpec::Kind::TASK)
+					{
+						root = makeComposite(NodeSpec::Kind::SELECTOR, "root", { root });
+					}
+
+					if (!compareEngines(root, 3, 60, treeIdx, error))
+					{
+						errorMessage = "tree " + std::to_string(treeIdx) + " " + error;
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// loops run their body once per tick, services tick on their timer, random nodes respect chance points
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class CountingService : public CompiledService
+		{
+		public:
+			virtual void start(CompiledNodeContext& context) override { ++numStarts; }
+			virtual void tick(CompiledNodeContext& context) override { ++numTicks; }
+			virtual void stop(CompiledNodeContext& context) override { ++numStops; }
+
+			int numStarts = 0;
+			int numTicks = 0;
+			int numStops = 0;
+		};
+
+		class Test_LoopServiceRandom : public CompiledBehaviorTree_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Loop, service and random nodes";
+				const CompiledMemoryLayout layout = makeLayout();
+
+				{
+					sp<TraceLog> log = new_sp<TraceLog>(1);
+					CompiledTreeGroup group(CompiledTreeDefinition::compile("loop", CompiledNodeDef::sequence("root", {
+						CompiledNodeDef::loop("loop", 3, buildCompiled(makeTask("step", 0, true), log, layout)),
+						buildCompiled(makeTask("park", 1000, true), log, layout)
+					}), layout));
+					group.start(group.addInstance());
+
+					for (int tick = 0; tick < 5; ++tick)
+					{
+						const size_t stepsBefore = countEvents(log->events[0], "begin step");
+						group.tick(0.1f);
+						const size_t steps = countEvents(log->events[0], "begin step");
+						if (steps - stepsBefore > 1)
+						{
+							errorMessage = "loop ran its body more than once in a tick";
+							return false;
+						}
+					}
+					const std::vector<std::string>& events = log->events[0];
+					auto parkBegin = std::find(events.begin(), events.end(), "begin park");
+					if (countEvents(events, "begin step") != 3 || parkBegin == events.end() || std::count(events.begin(), parkBegin, "begin step") != 3)
+					{
+						errorMessage = "loop did not run its body exactly three times before moving on";
+						return false;
+					}
+				}
+
+				{
+					//power of two times so the timer is exact: ticks on start, then every other tick once a full period has passed, until the work completes on tick 8
+					sp<TraceLog> log = new_sp<TraceLog>(1);
+					sp<CountingService> service = new_sp<CountingService>();
+					CompiledTreeGroup group(CompiledTreeDefinition::compile("service", CompiledNodeDef::sequence("root", {
+						CompiledNodeDef::service("service", service, 0.25f, true, buildCompiled(makeTask("work", 8, true), log, layout)),
+						buildCompiled(makeTask("park", 1000, true), log, layout)
+					}), layout));
+					group.start(group.addInstance());
+
+					for (int tick = 0; tick < 12; ++tick)
+					{
+						group.tick(0.125f);
+					}
+					if (service->numStarts != 1 || service->numTicks != 4 || service->numStops != 1)
+					{
+						errorMessage = "service ran " + std::to_string(service->numTicks) + " ticks, " + std::to_string(service->numStarts) + " starts, " + std::to_string(service->numStops) + " stops";
+						return false;
+					}
+				}
+
+				{
+					sp<TraceLog> log = new_sp<TraceLog>(1);
+					sp<TraceLog> sameSeedLog = new_sp<TraceLog>(1);
+					auto makeDefinition = [&layout](const sp<TraceLog>& log)
+					{
+						return CompiledTreeDefinition::compile("random", CompiledNodeDef::random("root", { 0, 3, 1 }, {
+							buildCompiled(makeTask("never", 0, true), log, layout),
+							buildCompiled(makeTask("often", 0, true), log, layout),
+							buildCompiled(makeTask("sometimes", 0, true), log, layout)
+						}), layout);
+					};
+
+					CompiledTreeGroup group(makeDefinition(log), RNGSystem::getSeededRNG(99));
+					CompiledTreeGroup sameSeedGroup(makeDefinition(sameSeedLog), RNGSystem::getSeededRNG(99));
+					group.start(group.addInstance());
+					sameSeedGroup.start(sameSeedGroup.addInstance());
+					for (int tick = 0; tick < 400; ++tick)
+					{
+						group.tick(0.1f);
+						sameSeedGroup.tick(0.1f);
+					}
+
+					const std::vector<std::string>& events = log->events[0];
+					const size_t often = countEvents(events, "begin often");
+					const size_t sometimes = countEvents(events, "begin sometimes");
+					if (countEvents(events, "begin never") != 0 || sometimes == 0 || often < 2 * sometimes)
+					{
+						errorMessage = "random choices ignored chance points";
+						return false;
+					}
+					if (events != sameSeedLog->events[0])
+					{
+						errorMessage = "same seed made different random choices";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// stopping aborts the running task, and reused instance slots start from clean state
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_StopAndReuse : public CompiledBehaviorTree_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Stop and reuse instances";
+				const CompiledMemoryLayout layout = makeLayout();
+
+				sp<TraceLog> log = new_sp<TraceLog>(2);
+				CompiledTreeGroup group(CompiledTreeDefinition::compile("stop", CompiledNodeDef::sequence("root", {
+					buildCompiled(makeTask("first", 0, true, "a"), log, layout),
+					buildCompiled(makeTask("long", 50, true), log, layout)
+				}), layout));
+
+				const uint32_t instance = group.addInstance(makeInitialMemory());
+				group.start(instance);
+				group.tick(0.1f);
+				if (group.getCurrentPriority(instance) != 2 || !readKey(group.getMemory(instance), "a"))
+				{
+					errorMessage = "tree not running the long task";
+					return false;
+				}
+
+				group.stop(instance);
+				const std::vector<std::string> expected = { "begin first", "cleanup first", "begin long", "abort long", "cleanup long" };
+				if (log->events[instance] != expected || group.isExecuting(instance) || group.getCurrentPriority(instance) != 0)
+				{
+					errorMessage = "stop did not abort the running task";
+					return false;
+				}
+
+				group.removeInstance(instance);
+				const uint32_t reused = group.addInstance();
+				log->events[reused].clear();
+				group.start(reused);
+				group.tick(0.1f);
+				if (reused != instance || readKey(group.getMemory(reused), "a") != true || log->events[reused].size() != 3 || group.getCurrentPriority(reused) != 2)
+				{
+					errorMessage = "reused instance did not start from clean state";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class CompiledBehaviorTreeTestSuite : public SA::TestSuite
+		{
+		public:
+			CompiledBehaviorTreeTestSuite()
+			{
+				testName = "COMPILED BEHAVIOR TREE TEST SUITE";
+
+				addTest(new_sp<Test_MatchesInterpreterCombatTree>());
+				addTest(new_sp<Test_MatchesInterpreterFighterTree>());
+				addTest(new_sp<Test_MatchesInterpreterGeneratedTrees>());
+				addTest(new_sp<Test_LoopServiceRandom>());
+				addTest(new_sp<Test_StopAndReuse>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getCompiledBehaviorTreeTestSuite()
+	{
+		return new_sp<SA::CompiledBehaviorTreeTests::CompiledBehaviorTreeTestSuite>();
+	}
+}
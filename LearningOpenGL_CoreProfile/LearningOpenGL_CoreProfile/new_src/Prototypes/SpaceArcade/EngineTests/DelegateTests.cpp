@@ -1,5 +1,6 @@
 #include "EngineTestSuite.h"
 #include "..\Tools\DataStructures\MultiDelegate.h"
+#include "..\Tools\DataStructures\InlineMultiDelegate.h"
 
 namespace SA
 {
@@ -12,10 +13,17 @@ namespace SA
 			{
 				testNamespace = "MultiDelegate:";
 			}
+
+			/** tests are templated on the delegate type and run once per delegate; the namespace tells the runs apart */
+			void setDelegateName(const std::string& delegateName)
+			{
+				testNamespace = delegateName + ":";
+			}
 		};
 
 		///BOILER PLATE
 		/*
+		template<template<typename...> class Delegate>
 		class Test_ : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -33,7 +41,7 @@ namespace SA
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
 
-				MultiDelegate<int> basicDelegate;
+				Delegate<int> basicDelegate;
 				return false;
 			}
 		};
@@ -43,6 +51,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		///broadcast notifies
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_BasicBroadcast : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -56,7 +65,7 @@ namespace SA
 				testName = "Basic Broadcast Tests (Weak/Strong)";
 				sp<User> weakUser = new_sp<User>();
 
-				MultiDelegate<int> basicDelegate;
+				Delegate<int> basicDelegate;
 				basicDelegate.addWeakObj(weakUser, &User::handler);
 
 				int testVal = 5;
@@ -83,12 +92,13 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// private subscription tests
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_PrivateSubscription : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
 			{
 				int myValue = 0;
-				void bindDelegate(MultiDelegate<int>& inDelegate, bool bStrong)
+				void bindDelegate(Delegate<int>& inDelegate, bool bStrong)
 				{
 					if (bStrong)
 					{
@@ -100,7 +110,7 @@ namespace SA
 					}
 				}
 
-				void removeDelegate(MultiDelegate<int>& inDelegate, bool bStrong)
+				void removeDelegate(Delegate<int>& inDelegate, bool bStrong)
 				{
 					if (bStrong)
 					{
@@ -123,7 +133,7 @@ namespace SA
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
 
-				MultiDelegate<int> basicDelegate;
+				Delegate<int> basicDelegate;
 
 				//-- STRONG ---------------------------------------
 				strongUser->bindDelegate(basicDelegate, true);
@@ -155,6 +165,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Test removal of bindings (strong and weak)
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_RemoveBindings : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -170,7 +181,7 @@ namespace SA
 
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
-				MultiDelegate<int> basicDelegate;
+				Delegate<int> basicDelegate;
 
 				//test that values update after delegate
 				basicDelegate.addStrongObj(strongUser, &User::handler);
@@ -228,6 +239,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// test inheritance subscription
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class TestInheritanceSubscription : public MultiDelegate_UnitTest
 		{
 			struct Parent : public GameEntity
@@ -241,7 +253,7 @@ namespace SA
 			struct Child : public Parent
 			{
 				/** makes the value negative, to prove that virtual function either works or doesn't work*/
-				virtual void virtual_handler(int value) override { myValue = -value; }
+				virtual void virtual_handler(int value) override { this->myValue = -value; }
 			};
 
 			virtual bool runInternal(bool stopOnFail = false) override
@@ -252,7 +264,7 @@ namespace SA
 				sp<Parent> childUser = new_sp<Child>();
 
 
-				MultiDelegate<int> basicDelegate;
+				Delegate<int> basicDelegate;
 
 				//test child class binding parent class function
 				int parentTestValue = 6;
@@ -277,7 +289,7 @@ namespace SA
 
 				//polymorphic bindings
 				const int positiveValue = 137;
-				MultiDelegate<int> virtualTestDelagate;
+				Delegate<int> virtualTestDelagate;
 
 				//virtualTestDelagate.addStrongObj(childUser, &Child::virtual_handler); //cannot mis-match parent and child classes, syntax doesn't work to deduce T
 
@@ -324,6 +336,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		///test adding same delegate twice (more ore more) and removals sequentially
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_DelegateOversubscription : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -337,7 +350,7 @@ namespace SA
 				testName = "Test Delegate Oversubscription";
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
-				MultiDelegate<int> basicDelegate;
+				Delegate<int> basicDelegate;
 				basicDelegate.addStrongObj(strongUser, &User::handler);
 				basicDelegate.addStrongObj(strongUser, &User::handler);
 
@@ -399,6 +412,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// test Lvalue/const ref bindings
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class TestDelegateParamQualitifers : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -426,7 +440,7 @@ namespace SA
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
 
-				MultiDelegate<int, double&, const char&, float&&> complexDelegate;
+				Delegate<int, double&, const char&, float&&> complexDelegate;
 				complexDelegate.addStrongObj(strongUser, &User::handler);
 				complexDelegate.addWeakObj(weakUser, &User::handler);
 				complexDelegate.broadcast(testInt, outDouble, 'z', 5.5f);
@@ -463,6 +477,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		///Test passing user types
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class TestCustomUserTypeParams : public MultiDelegate_UnitTest
 		{
 			struct UserType
@@ -496,7 +511,7 @@ namespace SA
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
 
-				MultiDelegate<UserType, UserType&, const UserType&, UserType&&> complexDelegate;
+				Delegate<UserType, UserType&, const UserType&, UserType&&> complexDelegate;
 				complexDelegate.addStrongObj(strongUser, &User::handler);
 				complexDelegate.addWeakObj(weakUser, &User::handler);
 
@@ -538,6 +553,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		///Test no argument delegate
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_NoArgParams : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -555,7 +571,7 @@ namespace SA
 				sp<User> strongUser = new_sp<User>();
 				sp<User> weakUser = new_sp<User>();
 
-				MultiDelegate<> noArgDelegate;
+				Delegate<> noArgDelegate;
 				noArgDelegate.addStrongObj(strongUser, &User::handler);
 				noArgDelegate.addWeakObj(weakUser, &User::handler);
 
@@ -573,6 +589,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Test removal during broadcast
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_RemovalDuringBroadcast : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -580,7 +597,7 @@ namespace SA
 				void handler(int value) { myValue = value; }
 				int myValue = 0;
 
-				sp<MultiDelegate<>> sharedNoArgDelegate = nullptr;
+				sp<Delegate<>> sharedNoArgDelegate = nullptr;
 				void HandleRemoveWeakDuringBroadcast()
 				{
 					myValue++;
@@ -599,7 +616,7 @@ namespace SA
 
 				sp<User> user = new_sp<User>();
 
-				sp<MultiDelegate<>> sharedNoArgDelegate = new_sp<MultiDelegate<>>();
+				sp<Delegate<>> sharedNoArgDelegate = new_sp<Delegate<>>();
 				user->sharedNoArgDelegate = sharedNoArgDelegate;
 
 				//test weak variant
@@ -648,6 +665,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Test add during broadcast
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_AddDuringBroadcast : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -655,7 +673,7 @@ namespace SA
 				void AddedCallback() { myValue++; }
 				int myValue = 0;
 
-				sp<MultiDelegate<>> addDelegate = nullptr;
+				sp<Delegate<>> addDelegate = nullptr;
 				void HandleAddDuringBroadcast()
 				{
 					//over subscribe to test that number of additions matches
@@ -671,7 +689,7 @@ namespace SA
 				testName = "Test Add During Broadcast";
 				sp<User> user = new_sp<User>();
 
-				sp<MultiDelegate<>> sharedNoArgDelegate = new_sp<MultiDelegate<>>();
+				sp<Delegate<>> sharedNoArgDelegate = new_sp<Delegate<>>();
 				user->addDelegate = sharedNoArgDelegate;
 
 				sharedNoArgDelegate->addWeakObj(user, &User::HandleAddDuringBroadcast);
@@ -707,13 +725,14 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Test broadcasting a/the delegate 
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_PassingDelegateAsParam : public MultiDelegate_UnitTest
 		{
 
 
 			struct DelegatePassingObject : public GameEntity
 			{
-				void handler(MultiDelegate<int>& InDelegate)
+				void handler(Delegate<int>& InDelegate)
 				{
 					InDelegate.broadcast(correctValue);
 				}
@@ -735,8 +754,8 @@ namespace SA
 				sp<DelegatePassingObject> user = new_sp<DelegatePassingObject>();
 				sp<SecondCallbackHandler> second = new_sp<SecondCallbackHandler>();
 
-				MultiDelegate<MultiDelegate<int>&> delegatePasser;
-				MultiDelegate<int> toPass;
+				Delegate<Delegate<int>&> delegatePasser;
+				Delegate<int> toPass;
 
 				toPass.addWeakObj(second, &SecondCallbackHandler::handler);
 				delegatePasser.addWeakObj(user, &DelegatePassingObject::handler);
@@ -756,6 +775,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Test Stale Weak Bindings Removed
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_ExpiredWeakBindingsRemoved : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -773,7 +793,7 @@ namespace SA
 
 				int storageVal;
 
-				MultiDelegate<int&> basicDelegate;
+				Delegate<int&> basicDelegate;
 				{
 					sp<User> scopedMT = new_sp<User>();
 					basicDelegate.addWeakObj(scopedMT, &User::handler);
@@ -809,6 +829,7 @@ namespace SA
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Test Has Strong Bindings
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
 		class Test_NumStrongBindings : public MultiDelegate_UnitTest
 		{
 			struct User : public GameEntity
@@ -823,7 +844,7 @@ namespace SA
 			{
 				testName = "Test querying is object strong bound";
 
-				MultiDelegate<int&> basicDelegate;
+				Delegate<int&> basicDelegate;
 				sp<User> user = new_sp<User>();
 				
 				basicDelegate.addStrongObj(user, &User::handler);
@@ -845,6 +866,124 @@ namespace SA
 			}
 		};
 
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Test more subscriptions than fit inline
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
+		class Test_SubscriptionsPastInlineCapacity : public MultiDelegate_UnitTest
+		{
+			struct User : public GameEntity
+			{
+				void handler(int value) { myValue += value; }
+				int myValue = 0;
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Test Subscriptions Past Inline Capacity";
+
+				//enough to spill past InlineMultiDelegate's inline slots; even users are strong, odd users are weak
+				const size_t numUsers = 3 * InlineMultiDelegate<int>::INLINE_CAPACITY;
+				std::vector<sp<User>> users;
+				Delegate<int> basicDelegate;
+				for (size_t idx = 0; idx < numUsers; ++idx)
+				{
+					users.push_back(new_sp<User>());
+					if (idx % 2 == 0) { basicDelegate.addStrongObj(users[idx], &User::handler); }
+					else { basicDelegate.addWeakObj(users[idx], &User::handler); }
+				}
+
+				basicDelegate.broadcast(1);
+				for (const sp<User>& user : users)
+				{
+					if (user->myValue != 1)
+					{
+						errorMessage = "not every subscription was invoked";
+						return false;
+					}
+				}
+
+				//remove from the inline and overflow storage
+				basicDelegate.removeStrong(users[0], &User::handler);
+				basicDelegate.removeWeak(users[1], &User::handler);
+				basicDelegate.removeAll(users[numUsers - 2]);
+				basicDelegate.broadcast(1);
+				for (size_t idx = 0; idx < numUsers; ++idx)
+				{
+					const bool bRemoved = idx == 0 || idx == 1 || idx == numUsers - 2;
+					if (users[idx]->myValue != (bRemoved ? 1 : 2))
+					{
+						errorMessage = "removing subscriptions changed which of the others are invoked";
+						return false;
+					}
+				}
+
+				//destroy every weak subscriber
+				for (size_t idx = 1; idx < numUsers; idx += 2) { users[idx] = nullptr; }
+				basicDelegate.broadcast(1);
+
+				const size_t numStrongLeft = numUsers / 2 - 2;
+				if (basicDelegate.numWeak() != 0 || basicDelegate.numStrong() != numStrongLeft || basicDelegate.numBound() != numStrongLeft)
+				{
+					errorMessage = "subscription counts wrong after removals and expired weak subscribers";
+					return false;
+				}
+				if (!basicDelegate.hasBoundStrong(*users[2]) || basicDelegate.hasBoundStrong(*users[0]) || basicDelegate.hasBoundWeak(*users[2]))
+				{
+					errorMessage = "bound queries wrong after removals";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Test weak subscriber destroyed by an earlier subscriber in the same broadcast
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		template<template<typename...> class Delegate>
+		class Test_WeakDestroyedDuringBroadcast : public MultiDelegate_UnitTest
+		{
+			struct Victim : public GameEntity
+			{
+				Victim(int& hits) : hits(hits) {}
+				void handler() { ++hits; }
+				int& hits;
+			};
+
+			struct Killer : public GameEntity
+			{
+				void handler() { victim = nullptr; }
+				sp<Victim> victim;
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Test Weak Subscriber Destroyed During Broadcast";
+
+				int hits = 0;
+				sp<Killer> killer = new_sp<Killer>();
+				killer->victim = new_sp<Victim>(hits);
+
+				//the killer is strong so it is invoked first by both delegates
+				Delegate<> noArgDelegate;
+				noArgDelegate.addStrongObj(killer, &Killer::handler);
+				noArgDelegate.addWeakObj(killer->victim, &Victim::handler);
+				noArgDelegate.broadcast();
+
+				if (hits != 0)
+				{
+					errorMessage = "weak subscriber was invoked after it was destroyed";
+					return false;
+				}
+				if (noArgDelegate.numWeak() != 0 || noArgDelegate.numStrong() != 1)
+				{
+					errorMessage = "destroyed weak subscriber was not removed";
+					return false;
+				}
+				return true;
+			}
+		};
+
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Container test suite
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -855,20 +994,37 @@ namespace SA
 			{
 				testName = "DELEGATE TEST SUITE";
 
+				addDelegateTests<MultiDelegate>("MultiDelegate");
+				addDelegateTests<InlineMultiDelegate>("InlineMultiDelegate");
+			}
+
+		private:
+			template<template<typename...> class Delegate>
+			void addDelegateTests(const std::string& delegateName)
+			{
 				//order these in a sensible order where later tests expect earlier tests to pass
-				addTest(new_sp<Test_BasicBroadcast>());
-				addTest(new_sp<Test_PrivateSubscription>());
-				addTest(new_sp<Test_RemoveBindings>());
-				addTest(new_sp<TestInheritanceSubscription>());
-				addTest(new_sp<Test_DelegateOversubscription>());
-				addTest(new_sp<TestDelegateParamQualitifers>());
-				addTest(new_sp<TestCustomUserTypeParams>());
-				addTest(new_sp<Test_NoArgParams>());
-				addTest(new_sp<Test_RemovalDuringBroadcast>());
-				addTest(new_sp<Test_AddDuringBroadcast>());
-				addTest(new_sp<Test_PassingDelegateAsParam>());
-				addTest(new_sp<Test_ExpiredWeakBindingsRemoved>());
-				addTest(new_sp<Test_NumStrongBindings>());
+				sp<MultiDelegate_UnitTest> tests[] = {
+					new_sp<Test_BasicBroadcast<Delegate>>(),
+					new_sp<Test_PrivateSubscription<Delegate>>(),
+					new_sp<Test_RemoveBindings<Delegate>>(),
+					new_sp<TestInheritanceSubscription<Delegate>>(),
+					new_sp<Test_DelegateOversubscription<Delegate>>(),
+					new_sp<TestDelegateParamQualitifers<Delegate>>(),
+					new_sp<TestCustomUserTypeParams<Delegate>>(),
+					new_sp<Test_NoArgParams<Delegate>>(),
+					new_sp<Test_RemovalDuringBroadcast<Delegate>>(),
+					new_sp<Test_AddDuringBroadcast<Delegate>>(),
+					new_sp<Test_PassingDelegateAsParam<Delegate>>(),
+					new_sp<Test_ExpiredWeakBindingsRemoved<Delegate>>(),
+					new_sp<Test_NumStrongBindings<Delegate>>(),
+					new_sp<Test_SubscriptionsPastInlineCapacity<Delegate>>(),
+					new_sp<Test_WeakDestroyedDuringBroadcast<Delegate>>(),
+				};
+				for (const sp<MultiDelegate_UnitTest>& test : tests)
+				{
+					test->setDelegateName(delegateName);
+					addTest(test);
+				}
 			}
 		};
 	}
@@ -5,10 +5,52 @@
 namespace SA
 {
 	sp<SA::TestSuite> getDelegateTestSuite();
+	sp<SA::TestSuite> getSpatialHashTestSuite();
+	sp<SA::TestSuite> getSATTestSuite();
+	sp<SA::TestSuite> getProjectileStoreTestSuite();
+	sp<SA::TestSuite> getInstanceUploadRingTestSuite();
+	sp<SA::TestSuite> getUniformLocationCacheTestSuite();
+	sp<SA::TestSuite> getAsyncAssetLoaderTestSuite();
+	sp<SA::TestSuite> getBakedModelCacheTestSuite();
+	sp<SA::TestSuite> getSkeletalAnimationTestSuite();
+	sp<SA::TestSuite> getJobSystemTestSuite();
+	sp<SA::TestSuite> getStressTestBenchmarkTestSuite();
+	sp<SA::TestSuite> getTeamTargetIndexTestSuite();
+	sp<SA::TestSuite> getBehaviorTreeMemoryTestSuite();
+	sp<SA::TestSuite> getCompiledBehaviorTreeTestSuite();
+	sp<SA::TestSuite> getTimerWheelTestSuite();
+	sp<SA::TestSuite> getTickDispatcherTestSuite();
+	sp<SA::TestSuite> getSlotMapTestSuite();
+	sp<SA::TestSuite> getAudioStreamTestSuite();
+	sp<SA::TestSuite> getAudioEmitterSelectorTestSuite();
+	sp<SA::TestSuite> getSoftwareMixerTestSuite();
+	sp<SA::TestSuite> getSoundBufferCacheTestSuite();
+	sp<SA::TestSuite> getParticleGroupPoolTestSuite();
 
 	EngineTestSuite::EngineTestSuite()
 	{
 		addTest(getDelegateTestSuite());
+		addTest(getSpatialHashTestSuite());
+		addTest(getSATTestSuite());
+		addTest(getProjectileStoreTestSuite());
+		addTest(getInstanceUploadRingTestSuite());
+		addTest(getUniformLocationCacheTestSuite());
+		addTest(getAsyncAssetLoaderTestSuite());
+		addTest(getBakedModelCacheTestSuite());
+		addTest(getSkeletalAnimationTestSuite());
+		addTest(getJobSystemTestSuite());
+		addTest(getStressTestBenchmarkTestSuite());
+		addTest(getTeamTargetIndexTestSuite());
+		addTest(getBehaviorTreeMemoryTestSuite());
+		addTest(getCompiledBehaviorTreeTestSuite());
+		addTest(getTimerWheelTestSuite());
+		addTest(getTickDispatcherTestSuite());
+		addTest(getSlotMapTestSuite());
+		addTest(getAudioStreamTestSuite());
+		addTest(getAudioEmitterSelectorTestSuite());
+		addTest(getSoftwareMixerTestSuite());
+		addTest(getSoundBufferCacheTestSuite());
+		addTest(getParticleGroupPoolTestSuite());
 	}
 }
 
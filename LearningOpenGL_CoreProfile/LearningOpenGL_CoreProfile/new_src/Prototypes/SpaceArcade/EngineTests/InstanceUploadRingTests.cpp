@@ -0,0 +1,377 @@
+#include "EngineTestSuite.h"
+#include "../Rendering/SAInstanceUploadRing.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace SA
+{
+	namespace InstanceUploadRingTests
+	{
+		class InstanceUploadRing_UnitTest : public SA::UnitTest
+		{
+		public:
+			InstanceUploadRing_UnitTest()
+			{
+				testNamespace = "InstanceUploadRing:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		/** 
+		 * CPU-only stand in for GLInstanceBufferBackend. The "GPU" finishes with a fenced region gpuLatencyFrames fences after it 
+		 * was fenced; a blocking wait finishes it immediately. Writes into a range whose fence has not signaled are counted as
+		 * hazards, as are overlapping mapped ranges (only one range of a GL buffer may be mapped at a time).
+		 */
+		class CPUInstanceBufferBackend : public IInstanceBufferBackend
+		{
+		public:
+			CPUInstanceBufferBackend(bool bPersistent, size_t gpuLatencyFrames) : bPersistent(bPersistent), gpuLatencyFrames(gpuLatencyFrames) {}
+
+			virtual bool allocateStorage(size_t totalBytes) override
+			{
+				storage.assign(totalBytes, 0);
+				pendingFences.clear();
+				++numAllocations;
+				return true;
+			}
+			virtual void releaseStorage() override { storage.clear(); pendingFences.clear(); }
+			virtual bool isPersistentlyMapped() const override { return bPersistent; }
+
+			virtual void* mapRange(size_t offset, size_t bytes) override
+			{
+				if (offset + bytes > storage.size() || (!bPersistent && bMapped)) { ++hazards; return nullptr; }
+				for (const PendingFence& fence : pendingFences)
+				{
+					if (offset < fence.regionEnd && fence.regionStart < offset + bytes) { ++hazards; }
+				}
+				bMapped = !bPersistent;
+				++numMaps;
+				return storage.data() + offset;
+			}
+			virtual void unmapRange(size_t offset, size_t bytes) override
+			{
+				if (!bPersistent)
+				{
+					if (!bMapped) { ++hazards; }
+					bMapped = false;
+					++numUnmaps;
+				}
+			}
+			virtual void orphan() override
+			{
+				//driver keeps the old storage alive for the GPU; new writes cannot race the old fences
+				if (bPersistent) { ++hazards; }
+				pendingFences.clear();
+				++numOrphans;
+			}
+			virtual void insertFence(size_t regionIdx) override
+			{
+				++fenceCounter;
+				retireFinishedFences();
+				pendingFences.push_back({ regionIdx, currentRegionStart(regionIdx), currentRegionEnd(regionIdx), fenceCounter });
+			}
+			virtual bool waitFence(size_t regionIdx, bool bBlock) override
+			{
+				auto fence = std::find_if(pendingFences.begin(), pendingFences.end(), [regionIdx](const PendingFence& f) { return f.regionIdx == regionIdx; });
+				if (fence == pendingFences.end())
+				{
+					return true;
+				}
+				if (bBlock)
+				{
+					++numBlockingWaits;
+					pendingFences.erase(fence);
+					return true;
+				}
+				return false;
+			}
+			virtual unsigned int getBufferId() const override { return 1; }
+
+			void retireFinishedFences()
+			{
+				pendingFences.erase(std::remove_if(pendingFences.begin(), pendingFences.end(),
+					[this](const PendingFence& f) { return fenceCounter - f.fencedAt >= gpuLatencyFrames; }), pendingFences.end());
+			}
+
+			size_t currentRegionStart(size_t regionIdx) const { return regionIdx * regionBytes; }
+			size_t currentRegionEnd(size_t regionIdx) const { return (regionIdx + 1) * regionBytes; }
+
+			struct PendingFence
+			{
+				size_t regionIdx;
+				size_t regionStart;
+				size_t regionEnd;
+				size_t fencedAt;
+			};
+
+			bool bPersistent;
+			size_t gpuLatencyFrames;
+			size_t regionBytes = 0; //kept in sync by the tests so fences know which bytes they cover
+			std::vector<char> storage;
+			std::vector<PendingFence> pendingFences;
+			size_t fenceCounter = 0;
+			bool bMapped = false;
+			size_t hazards = 0;
+			size_t numAllocations = 0;
+			size_t numMaps = 0;
+			size_t numUnmaps = 0;
+			size_t numOrphans = 0;
+			size_t numBlockingWaits = 0;
+		};
+
+		struct RingUnderTest
+		{
+			RingUnderTest(bool bPersistent, size_t gpuLatencyFrames, size_t regionBytes, size_t numRegions = 3)
+			{
+				up<CPUInstanceBufferBackend> newBackend = new_up<CPUInstanceBufferBackend>(bPersistent, gpuLatencyFrames);
+				backend = newBackend.get();
+				ring = new_up<InstanceUploadRing>(std::move(newBackend), regionBytes, numRegions);
+				ring->acquireStorage();
+				backend->regionBytes = ring->getRegionBytes();
+			}
+			~RingUnderTest() { ring->releaseStorage(); }
+
+			/** writes numUploads uploads of uploadBytes, each filled with a frame specific value; returns false if any allocation failed */
+			bool runFrame(size_t numUploads, size_t uploadBytes, char fillValue)
+			{
+				size_t frameBytes = numUploads * InstanceUploadRing::paddedSize(uploadBytes, 16);
+				ring->beginFrame(frameBytes);
+				backend->regionBytes = ring->getRegionBytes();
+
+				bool bAllValid = true;
+				for (size_t upload = 0; upload < numUploads; ++upload)
+				{
+					InstanceUploadRing::Allocation allocation = ring->allocate(uploadBytes, 16);
+					if (!allocation.isValid()) { bAllValid = false; continue; }
+					std::memset(allocation.data, fillValue, allocation.bytes);
+					ring->commit(allocation);
+				}
+				ring->endFrame();
+				return bAllValid;
+			}
+
+			CPUInstanceBufferBackend* backend;
+			up<InstanceUploadRing> ring;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// sub-allocations are aligned, stay inside the current region, and do not overlap
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SubAllocation : public InstanceUploadRing_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Sub-allocation alignment and bounds";
+
+				RingUnderTest test(true, 2, 1024);
+				InstanceUploadRing& ring = *test.ring;
+
+				for (size_t frame = 0; frame < 6; ++frame)
+				{
+					ring.beginFrame(1024);
+					const size_t regionStart = ring.getCurrentRegion() * ring.getRegionBytes();
+					const size_t regionEnd = regionStart + ring.getRegionBytes();
+
+					std::vector<InstanceUploadRing::Allocation> allocations;
+					for (size_t bytes : { 4, 64, 12, 80, 16, 100 })
+					{
+						allocations.push_back(ring.allocate(bytes, 16));
+					}
+					ring.endFrame();
+
+					for (size_t idx = 0; idx < allocations.size(); ++idx)
+					{
+						const InstanceUploadRing::Allocation& allocation = allocations[idx];
+						if (!allocation.isValid() || allocation.offset % 16 != 0 || allocation.offset < regionStart || allocation.offset + allocation.bytes > regionEnd)
+						{
+							errorMessage = "allocation misaligned or outside of the frame's region";
+							return false;
+						}
+						if (idx > 0 && allocations[idx - 1].offset + allocations[idx - 1].bytes > allocation.offset)
+						{
+							errorMessage = "allocations overlap";
+							return false;
+						}
+					}
+				}
+
+				//a request beyond what the region holds fails rather than spilling into the next region
+				ring.beginFrame(16);
+				InstanceUploadRing::Allocation tooBig = ring.allocate(ring.getRegionBytes() + 1, 16);
+				ring.endFrame();
+				if (tooBig.isValid())
+				{
+					errorMessage = "allocation larger than the region succeeded";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// frames wrap around the regions and never write a region the GPU is still reading
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_WrapAndFencing : public InstanceUploadRing_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Wrap and fencing";
+
+				//gpu keeps up; 3 regions with 2 frames of latency never stall
+				{
+					RingUnderTest test(true, 2, 512);
+					for (size_t frame = 0; frame < 30; ++frame)
+					{
+						test.runFrame(4, 64, char(frame));
+						if (test.ring->getCurrentRegion() != frame % 3)
+						{
+							errorMessage = "frames did not cycle through the regions in order";
+							return false;
+						}
+					}
+					if (test.backend->hazards != 0 || test.ring->getStats().fenceStalls != 0)
+					{
+						errorMessage = "ring stalled or wrote an in-flight region while the GPU kept up";
+						return false;
+					}
+				}
+
+				//gpu falls behind; persistent storage must stall instead of overwriting
+				{
+					RingUnderTest test(true, 5, 512);
+					for (size_t frame = 0; frame < 30; ++frame)
+					{
+						test.runFrame(4, 64, char(frame));
+					}
+					if (test.backend->hazards != 0)
+					{
+						errorMessage = "wrote to a region whose fence had not signaled";
+						return false;
+					}
+					if (test.ring->getStats().fenceStalls == 0 || test.ring->getStats().orphans != 0)
+					{
+						errorMessage = "persistent storage should wait on fences when the GPU is behind";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// without persistent mapping a busy region is orphaned rather than waited on, and every mapped range is unmapped
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_OrphanFallback : public InstanceUploadRing_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Orphaning fallback";
+
+				RingUnderTest test(false, 5, 512);
+				for (size_t frame = 0; frame < 30; ++frame)
+				{
+					if (!test.runFrame(4, 64, char(frame)))
+					{
+						errorMessage = "allocation failed";
+						return false;
+					}
+				}
+
+				const InstanceUploadRing::Stats& stats = test.ring->getStats();
+				if (test.backend->hazards != 0)
+				{
+					errorMessage = "wrote to a region whose fence had not signaled, or mapped two ranges at once";
+					return false;
+				}
+				if (stats.orphans == 0 || stats.fenceStalls != 0 || test.backend->numBlockingWaits != 0)
+				{
+					errorMessage = "expected orphaning and no stalls when the GPU is behind";
+					return false;
+				}
+				if (test.backend->numMaps != test.backend->numUnmaps)
+				{
+					errorMessage = "mapped ranges were not all unmapped";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// a frame larger than a region grows the ring before anything is mapped
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_GrowBeforeMapping : public InstanceUploadRing_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Grow before mapping";
+
+				RingUnderTest test(true, 2, 256);
+				test.runFrame(2, 64, 1);
+				test.runFrame(2, 64, 2);
+
+				if (!test.runFrame(40, 64, 3))
+				{
+					errorMessage = "allocation failed after the ring was told the frame size";
+					return false;
+				}
+				if (test.ring->getStats().regrows != 1 || test.backend->numAllocations != 2 || test.ring->getRegionBytes() < 40 * 64)
+				{
+					errorMessage = "ring did not grow to fit the frame";
+					return false;
+				}
+				if (test.backend->hazards != 0)
+				{
+					errorMessage = "grow replaced storage that the GPU was still reading";
+					return false;
+				}
+
+				//the data for the frame landed where the allocations said it would
+				const size_t regionStart = test.ring->getCurrentRegion() * test.ring->getRegionBytes();
+				if (test.backend->storage[regionStart] != 3 || test.backend->storage[regionStart + 39 * 64] != 3)
+				{
+					errorMessage = "uploaded data was not written to the current region";
+					return false;
+				}
+
+				//frames that fit do not grow again
+				for (size_t frame = 0; frame < 10; ++frame)
+				{
+					test.runFrame(40, 64, 4);
+				}
+				if (test.ring->getStats().regrows != 1)
+				{
+					errorMessage = "ring grew when the frame already fit";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class InstanceUploadRingTestSuite : public SA::TestSuite
+		{
+		public:
+			InstanceUploadRingTestSuite()
+			{
+				testName = "INSTANCE UPLOAD RING TEST SUITE";
+
+				addTest(new_sp<Test_SubAllocation>());
+				addTest(new_sp<Test_WrapAndFencing>());
+				addTest(new_sp<Test_OrphanFallback>());
+				addTest(new_sp<Test_GrowBeforeMapping>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getInstanceUploadRingTestSuite()
+	{
+		return new_sp<SA::InstanceUploadRingTests::InstanceUploadRingTestSuite>();
+	}
+}
@@ -0,0 +1,448 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/Jobs/JobSystem.h"
+#include "../GameFramework/Jobs/SystemTickGraph.h"
+#include "../GameFramework/SAGameBase.h"
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+namespace SA
+{
+	namespace JobSystemTests
+	{
+		class JobSystem_UnitTest : public SA::UnitTest
+		{
+		public:
+			JobSystem_UnitTest()
+			{
+				testNamespace = "JobSystem:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// jobs never start before the jobs they depend on have finished
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_DependenciesRespected : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Dependencies respected";
+
+				JobSystem jobSystem(4);
+				for (uint32_t iteration = 0; iteration < 200; ++iteration)
+				{
+					//diamond: a -> (b, c) -> d, plus a long chain hanging off d
+					std::atomic<uint32_t> clock{ 0 };
+					std::atomic<uint32_t> finishedA{ 0 }, startedB{ 0 }, finishedB{ 0 }, startedC{ 0 }, finishedC{ 0 }, startedD{ 0 };
+					auto stamp = [&clock]() { return clock.fetch_add(1) + 1; };
+
+					JobHandle a = jobSystem.schedule([&]() { finishedA = stamp(); });
+					JobHandle b = jobSystem.schedule([&]() { startedB = stamp(); finishedB = stamp(); }, { a });
+					JobHandle c = jobSystem.schedule([&]() { startedC = stamp(); finishedC = stamp(); }, { a });
+					JobHandle d = jobSystem.schedule([&]() { startedD = stamp(); }, { b, c });
+
+					std::atomic<uint32_t> chainValue{ 0 };
+					std::atomic<bool> bChainOrdered{ true };
+					JobHandle previous = d;
+					for (uint32_t link = 0; link < 16; ++link)
+					{
+						previous = jobSystem.schedule([&chainValue, &bChainOrdered, link]()
+						{
+							bChainOrdered = bChainOrdered && chainValue.exchange(link + 1) == link;
+						}, { previous });
+					}
+
+					jobSystem.wait(previous);
+					if (!a.isDone() || !b.isDone() || !c.isDone() || !d.isDone())
+					{
+						errorMessage = "waited job finished before its dependencies";
+						return false;
+					}
+					if (startedB < finishedA || startedC < finishedA || startedD < finishedB || startedD < finishedC)
+					{
+						errorMessage = "job started before a dependency finished";
+						return false;
+					}
+					if (!bChainOrdered || chainValue != 16)
+					{
+						errorMessage = "chained jobs ran out of order";
+						return false;
+					}
+				}
+
+				//depending on a default handle or an already finished job does not hold anything up
+				JobHandle finished = jobSystem.schedule([]() {});
+				jobSystem.wait(finished);
+				bool bRan = false;
+				jobSystem.wait(jobSystem.schedule([&bRan]() { bRan = true; }, { JobHandle{}, finished }));
+				if (!bRan)
+				{
+					errorMessage = "job with finished dependencies did not run";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// parallelFor visits every index once, including from inside other jobs
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ParallelForCoverage : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "parallelFor covers every index once";
+
+				for (size_t numWorkers : { 0, 1, 3, 7 })
+				{
+					JobSystem jobSystem(numWorkers);
+					for (size_t count : { 0, 1, 7, 1000, 100003 })
+					{
+						for (size_t minItems : { 1, 64, 5000 })
+						{
+							std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[count + 1]);
+							for (size_t idx = 0; idx < count; ++idx) { visits[idx] = 0; }
+
+							jobSystem.parallelFor(count, minItems, [&visits](size_t begin, size_t end)
+							{
+								for (size_t idx = begin; idx < end; ++idx) { visits[idx].fetch_add(1); }
+							});
+
+							for (size_t idx = 0; idx < count; ++idx)
+							{
+								if (visits[idx] != 1)
+								{
+									errorMessage = "index not visited exactly once";
+									return false;
+								}
+							}
+						}
+					}
+
+					//a job that waits on its own parallelFor helps run it rather than blocking a worker
+					std::atomic<uint32_t> total{ 0 };
+					std::vector<JobHandle> outerJobs;
+					for (uint32_t outer = 0; outer < 8; ++outer)
+					{
+						outerJobs.push_back(jobSystem.schedule([&jobSystem, &total]()
+						{
+							jobSystem.parallelFor(512, 16, [&total](size_t begin, size_t end) { total.fetch_add(uint32_t(end - begin)); });
+						}));
+					}
+					jobSystem.wait(outerJobs);
+					if (total != 8 * 512)
+					{
+						errorMessage = "nested parallelFor lost work";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// deterministic mode runs everything on the calling thread in submission order
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_DeterministicMode : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Deterministic mode is serial and ordered";
+
+				JobSystem jobSystem(4, /*bDeterministic*/ true);
+				const std::thread::id callingThread = std::this_thread::get_id();
+
+				std::vector<uint32_t> order; //not synchronized on purpose; any concurrency here is a failure anyway
+				bool bOffThread = false;
+				std::vector<JobHandle> jobs;
+				for (uint32_t jobIdx = 0; jobIdx < 100; ++jobIdx)
+				{
+					std::vector<JobHandle> dependencies;
+					if (jobIdx > 0) { dependencies.push_back(jobs[jobIdx / 2]); }
+					jobs.push_back(jobSystem.schedule([&, jobIdx]()
+					{
+						order.push_back(jobIdx);
+						bOffThread |= std::this_thread::get_id() != callingThread;
+					}, dependencies));
+				}
+				jobSystem.wait(jobs);
+
+				std::vector<std::pair<size_t, size_t>> ranges;
+				jobSystem.parallelFor(1000, 64, [&](size_t begin, size_t end)
+				{
+					ranges.emplace_back(begin, end);
+					bOffThread |= std::this_thread::get_id() != callingThread;
+				});
+
+				if (bOffThread)
+				{
+					errorMessage = "job ran on another thread";
+					return false;
+				}
+				for (uint32_t jobIdx = 0; jobIdx < order.size(); ++jobIdx)
+				{
+					if (order[jobIdx] != jobIdx)
+					{
+						errorMessage = "jobs not run in submission order";
+						return false;
+					}
+				}
+				if (order.size() != 100 || ranges.size() != 16 || ranges.front() != std::make_pair<size_t, size_t>(0, 64) || ranges.back() != std::make_pair<size_t, size_t>(960, 1000))
+				{
+					errorMessage = "unexpected serial ranges";
+					return false;
+				}
+				for (size_t rangeIdx = 1; rangeIdx < ranges.size(); ++rangeIdx)
+				{
+					if (ranges[rangeIdx].first != ranges[rangeIdx - 1].second)
+					{
+						errorMessage = "serial ranges out of order";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// system ticks only overlap when their declared dependencies allow it
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SystemTickGraph : public JobSystem_UnitTest
+		{
+			struct ResourceMonitor
+			{
+				std::atomic<int32_t> readers{ 0 };
+				std::atomic<int32_t> writers{ 0 };
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "System tick graph ordering";
+
+				enum Resource { PHYSICS, AUDIO, PARTICLES, AI, NUM_RESOURCES };
+				const char* resourceNames[] = { "physics", "audio", "particles", "ai" };
+
+				struct TestSystem
+				{
+					bool bThreadSafe;
+					std::vector<Resource> reads;
+					std::vector<Resource> writes;
+				};
+				std::vector<TestSystem> testSystems = {
+					{ true,  {},          { PHYSICS } },	//0 physics
+					{ true,  { PHYSICS }, { AI } },			//1 ai, after physics
+					{ true,  { PHYSICS }, { AUDIO } },		//2 audio, alongside ai
+					{ true,  { PHYSICS }, { PARTICLES } },	//3 particles, alongside ai and audio
+					{ false, {},          {} },				//4 main thread barrier
+					{ true,  { AI },      { AUDIO } },		//5 audio again
+					{ true,  {},          {} },				//6 touches nothing
+				};
+				const std::vector<std::vector<size_t>> expectedPrerequisites = { {}, { 0 }, { 0 }, { 0 }, { 0, 1, 2, 3 }, { 1, 2, 4 }, { 4 } };
+
+				ResourceMonitor monitors[NUM_RESOURCES];
+				std::atomic<bool> bOverlapDetected{ false };
+				std::atomic<bool> bMainThreadViolated{ false };
+				std::vector<std::atomic<uint32_t>> tickCounts(testSystems.size());
+				const std::thread::id mainThread = std::this_thread::get_id();
+
+				SystemTickGraph graph;
+				for (size_t systemIdx = 0; systemIdx < testSystems.size(); ++systemIdx)
+				{
+					const TestSystem& testSystem = testSystems[systemIdx];
+					SystemTickDependencies dependencies;
+					dependencies.bThreadSafeTick = testSystem.bThreadSafe;
+					for (Resource read : testSystem.reads) { dependencies.reads.push_back(resourceNames[read]); }
+					for (Resource write : testSystem.writes) { dependencies.writes.push_back(resourceNames[write]); }
+
+					graph.addSystem([&, systemIdx](float)
+					{
+						const TestSystem& self = testSystems[systemIdx];
+						if (!self.bThreadSafe && std::this_thread::get_id() != mainThread) { bMainThreadViolated = true; }
+
+						for (Resource read : self.reads) { monitors[read].readers.fetch_add(1); bOverlapDetected = bOverlapDetected || monitors[read].writers > 0; }
+						for (Resource write : self.writes) { bOverlapDetected = bOverlapDetected || monitors[write].writers.fetch_add(1) > 0 || monitors[write].readers > 0; }
+
+						std::this_thread::sleep_for(std::chrono::microseconds(50)); //give conflicting ticks a chance to overlap if ordering were wrong
+
+						for (Resource write : self.writes) { monitors[write].writers.fetch_sub(1); }
+						for (Resource read : self.reads) { monitors[read].readers.fetch_sub(1); }
+						tickCounts[systemIdx].fetch_add(1);
+					}, dependencies);
+				}
+
+				for (size_t systemIdx = 0; systemIdx < testSystems.size(); ++systemIdx)
+				{
+					if (graph.getPrerequisites(systemIdx) != expectedPrerequisites[systemIdx])
+					{
+						errorMessage = "unexpected prerequisites from declared dependencies";
+						return false;
+					}
+				}
+
+				JobSystem jobSystem(4);
+				const uint32_t numFrames = 200;
+				for (uint32_t frame = 0; frame < numFrames; ++frame)
+				{
+					graph.tick(jobSystem, 0.016f);
+				}
+				if (bMainThreadViolated)
+				{
+					errorMessage = "thread unsafe system ticked off the main thread";
+					return false;
+				}
+				if (bOverlapDetected)
+				{
+					errorMessage = "conflicting systems ticked at the same time";
+					return false;
+				}
+				for (std::atomic<uint32_t>& tickCount : tickCounts)
+				{
+					if (tickCount != numFrames)
+					{
+						errorMessage = "system did not tick exactly once per frame";
+						return false;
+					}
+				}
+
+				//deterministic mode ticks everything in registration order on the calling thread
+				std::vector<size_t> deterministicOrder;
+				SystemTickGraph orderGraph;
+				for (size_t systemIdx = 0; systemIdx < testSystems.size(); ++systemIdx)
+				{
+					SystemTickDependencies dependencies;
+					dependencies.bThreadSafeTick = testSystems[systemIdx].bThreadSafe;
+					orderGraph.addSystem([&deterministicOrder, systemIdx](float) { deterministicOrder.push_back(systemIdx); }, dependencies);
+				}
+				jobSystem.setDeterministic(true);
+				orderGraph.tick(jobSystem, 0.016f);
+				for (size_t systemIdx = 0; systemIdx < testSystems.size(); ++systemIdx)
+				{
+					if (deterministicOrder.size() != testSystems.size() || deterministicOrder[systemIdx] != systemIdx)
+					{
+						errorMessage = "deterministic ticks not in registration order";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the engine's systems declare what they touch, so particle and audio ticks run alongside each other once the level has ticked
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_EngineSystemTickOverlap : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Engine particle and audio ticks overlap";
+
+				const SystemTickGraph& engineGraph = GameBase::get().getSystemTickGraph();
+				const size_t levelIdx = engineGraph.findSystem("LevelSystem");
+				const size_t particleIdx = engineGraph.findSystem("ParticleSystem");
+				const size_t audioIdx = engineGraph.findSystem("AudioSystem");
+				const size_t projectileIdx = engineGraph.findSystem("ProjectileSystem");
+				const size_t numSystems = engineGraph.getNumSystems();
+				if (levelIdx == numSystems || particleIdx == numSystems || audioIdx == numSystems || projectileIdx == numSystems)
+				{
+					errorMessage = "engine system missing from the tick graph";
+					return false;
+				}
+
+				auto waitsOn = [&engineGraph](size_t systemIdx, size_t otherIdx)
+				{
+					const std::vector<size_t>& prerequisites = engineGraph.getPrerequisites(std::max(systemIdx, otherIdx));
+					return std::find(prerequisites.begin(), prerequisites.end(), std::min(systemIdx, otherIdx)) != prerequisites.end();
+				};
+				if (!waitsOn(particleIdx, levelIdx) || !waitsOn(audioIdx, levelIdx))
+				{
+					errorMessage = "particles and audio must wait for the level tick";
+					return false;
+				}
+				if (waitsOn(particleIdx, audioIdx) || waitsOn(projectileIdx, particleIdx) || waitsOn(projectileIdx, audioIdx))
+				{
+					errorMessage = "particle, audio and projectile ticks are ordered against each other";
+					return false;
+				}
+
+				//replay the engine's declarations; particles and audio each wait for the other to start, which only happens if they run at the same time
+				std::atomic<bool> bParticleStarted{ false }, bAudioStarted{ false };
+				std::atomic<bool> bParticleSawAudio{ false }, bAudioSawParticle{ false };
+				std::atomic<bool> bWaitForOther{ true };
+				std::vector<size_t> tickOrder;
+				std::mutex tickOrderMutex;
+				auto overlappingTick = [&bWaitForOther](std::atomic<bool>& bSelfStarted, const std::atomic<bool>& bOtherStarted, std::atomic<bool>& bSawOther)
+				{
+					bSelfStarted = true;
+					const std::chrono::steady_clock::time_point giveUp = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+					while (bWaitForOther && !bOtherStarted && std::chrono::steady_clock::now() < giveUp)
+					{
+						std::this_thread::yield();
+					}
+					bSawOther = bSawOther || bOtherStarted;
+				};
+
+				SystemTickGraph replay;
+				for (size_t systemIdx = 0; systemIdx < numSystems; ++systemIdx)
+				{
+					replay.addSystem([&, systemIdx](float)
+					{
+						if (systemIdx == particleIdx) { overlappingTick(bParticleStarted, bAudioStarted, bParticleSawAudio); }
+						if (systemIdx == audioIdx) { overlappingTick(bAudioStarted, bParticleStarted, bAudioSawParticle); }
+						std::lock_guard<std::mutex> lock(tickOrderMutex);
+						tickOrder.push_back(systemIdx);
+					}, engineGraph.getDependencies(systemIdx), engineGraph.getName(systemIdx));
+				}
+
+				JobSystem jobSystem(2);
+				replay.tick(jobSystem, 0.016f);
+				if (!bParticleSawAudio || !bAudioSawParticle)
+				{
+					errorMessage = "particle and audio ticks did not overlap with parallel jobs";
+					return false;
+				}
+
+				//with deterministic jobs the same graph ticks serially in registration order
+				bWaitForOther = false;
+				tickOrder.clear();
+				jobSystem.setDeterministic(true);
+				replay.tick(jobSystem, 0.016f);
+				for (size_t systemIdx = 0; systemIdx < numSystems; ++systemIdx)
+				{
+					if (tickOrder.size() != numSystems || tickOrder[systemIdx] != systemIdx)
+					{
+						errorMessage = "deterministic engine ticks not in registration order";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class JobSystemTestSuite : public SA::TestSuite
+		{
+		public:
+			JobSystemTestSuite()
+			{
+				testName = "JOB SYSTEM TEST SUITE";
+
+				addTest(new_sp<Test_DependenciesRespected>());
+				addTest(new_sp<Test_ParallelForCoverage>());
+				addTest(new_sp<Test_DeterministicMode>());
+				addTest(new_sp<Test_SystemTickGraph>());
+				addTest(new_sp<Test_EngineSystemTickOverlap>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getJobSystemTestSuite()
+	{
+		return new_sp<SA::JobSystemTests::JobSystemTestSuite>();
+	}
+}
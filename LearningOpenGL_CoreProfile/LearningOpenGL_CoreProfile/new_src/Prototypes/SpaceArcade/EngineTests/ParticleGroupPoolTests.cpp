@@ -0,0 +1,381 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/SAParticleGroupPool.h"
+
+#include <random>
+#include <vector>
+
+namespace SA
+{
+	namespace ParticleGroupPoolTests
+	{
+		class ParticleGroupPool_UnitTest : public SA::UnitTest
+		{
+		public:
+			ParticleGroupPool_UnitTest()
+			{
+				testNamespace = "ParticleGroupPool:";
+			}
+		};
+
+		/** stands in for ActiveParticleGroup; config is held like the group's particle config, effectData is sized per free list like a group's mutable effect data is per config */
+		struct TestGroup
+		{
+			sp<std::vector<float>> config;
+			size_t spawnId = 0;
+			int framesLeft = 0;
+			std::vector<float> effectData;
+
+			void onReleasedToPool() { config = nullptr; }
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// handles resolve while their group is active and never after, even once the slot is reused
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Handles : public ParticleGroupPool_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Generation checked handles";
+
+				ParticleGroupPool<TestGroup> pool;
+				const uint32_t freeList = pool.addFreeList();
+
+				if (pool.find(ParticleGroupHandle{}))
+				{
+					errorMessage = "default handle resolved";
+					return false;
+				}
+
+				ParticleGroupHandle first = pool.acquire(freeList);
+				ParticleGroupHandle second = pool.acquire(freeList);
+				TestGroup* firstGroup = pool.find(first);
+				if (!firstGroup || !pool.find(second) || firstGroup == pool.find(second))
+				{
+					errorMessage = "acquired handles did not resolve to distinct groups";
+					return false;
+				}
+
+				if (!pool.release(first) || pool.find(first) || pool.release(first))
+				{
+					errorMessage = "released handle still resolves";
+					return false;
+				}
+
+				//the slot is reused; the group object is the same one, but the old handle must stay stale
+				ParticleGroupHandle reused = pool.acquire(freeList);
+				if (reused.slot != first.slot || pool.find(reused) != firstGroup || pool.find(first))
+				{
+					errorMessage = "reused slot resolved through the stale handle";
+					return false;
+				}
+
+				//the second group moved in the dense list when the first was released; its handle still works
+				if (pool.getNumActive() != 2 || !pool.find(second))
+				{
+					errorMessage = "dense list or moved handle is wrong";
+					return false;
+				}
+
+				pool.releaseAll();
+				if (pool.getNumActive() != 0 || pool.find(second) || pool.find(reused) || pool.getNumFree(freeList) != 2)
+				{
+					errorMessage = "releaseAll left groups active";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// released groups only go back to the free list they came from
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_FreeLists : public ParticleGroupPool_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Per effect free lists";
+
+				ParticleGroupPool<TestGroup> pool;
+				const uint32_t explosion = pool.addFreeList();
+				const uint32_t engine = pool.addFreeList();
+
+				ParticleGroupHandle explosionHandle = pool.acquire(explosion);
+				TestGroup* explosionGroup = pool.find(explosionHandle);
+				pool.release(explosionHandle);
+
+				//the explosion group is free, but not for an engine effect
+				ParticleGroupHandle engineHandle = pool.acquire(engine);
+				if (pool.find(engineHandle) == explosionGroup || pool.getStats().numGroupAllocations != 2 || pool.getNumFree(explosion) != 1)
+				{
+					errorMessage = "an effect took another effect's free group";
+					return false;
+				}
+
+				if (pool.find(pool.acquire(explosion)) != explosionGroup || pool.getStats().numRecycled != 1)
+				{
+					errorMessage = "free group was not recycled";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// a free group must not keep the config it was spawned from alive (shield configs own a model and are rebuilt each level)
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ReleaseDropsConfig : public ParticleGroupPool_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Released groups drop their config";
+
+				ParticleGroupPool<TestGroup> pool;
+				const uint32_t freeList = pool.addFreeList();
+
+				wp<std::vector<float>> weakConfig;
+				ParticleGroupHandle handle;
+				{
+					sp<std::vector<float>> config = new_sp<std::vector<float>>(64);
+					weakConfig = config;
+					handle = pool.acquire(freeList);
+					pool.find(handle)->config = config;
+				}
+				if (weakConfig.expired())
+				{
+					errorMessage = "active group did not hold its config";
+					return false;
+				}
+
+				pool.release(handle);
+				if (!weakConfig.expired())
+				{
+					errorMessage = "released group kept its config alive";
+					return false;
+				}
+
+				//the same holds for groups released in bulk, as on a level change
+				sp<std::vector<float>> config = new_sp<std::vector<float>>(64);
+				weakConfig = config;
+				pool.find(pool.acquire(freeList))->config = config;
+				pool.find(pool.acquire(freeList))->config = config;
+				config = nullptr;
+				pool.releaseAll();
+				if (!weakConfig.expired() || pool.getNumFree(freeList) != 2)
+				{
+					errorMessage = "releaseAll kept a config alive";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// clearing (on level change) frees every group and free list; old handles stay stale and old free lists are a different epoch
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Clear : public ParticleGroupPool_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Clear drops groups and free lists";
+
+				ParticleGroupPool<TestGroup> pool;
+				const uint32_t oldEpoch = pool.getFreeListEpoch();
+				const uint32_t oldFreeList = pool.addFreeList();
+				ParticleGroupHandle released = pool.acquire(oldFreeList);
+				pool.release(released);
+				ParticleGroupHandle active = pool.acquire(oldFreeList);
+				ParticleGroupHandle other = pool.acquire(oldFreeList);
+
+				pool.clear();
+				if (pool.getNumGroups() != 0 || pool.getNumFreeLists() != 0 || pool.getNumActive() != 0 || pool.getFreeListEpoch() == oldEpoch)
+				{
+					errorMessage = "clear kept groups or free lists";
+					return false;
+				}
+
+				//new slots reuse the old slot indices, but never the old generations
+				const uint32_t newFreeList = pool.addFreeList();
+				ParticleGroupHandle first = pool.acquire(newFreeList);
+				ParticleGroupHandle second = pool.acquire(newFreeList);
+				if (!pool.find(first) || !pool.find(second) || pool.find(released) || pool.find(active) || pool.find(other))
+				{
+					errorMessage = "handle from before clear resolved";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// many frames of spawning and expiring, updated the way the particle system does (dense walk, swap-remove on expire);
+		/// once warm the pool stops allocating, and recycled groups already have the capacity their effect needs
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SpawnExpireStress : public ParticleGroupPool_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Spawn and expire stress";
+
+				const size_t numEffects = 4;
+				const size_t maxSpawnsPerFrame = 40;
+				const int maxLifetimeFrames = 90;
+				const size_t numFrames = 3000;
+				const size_t warmFrames = 600;
+
+				ParticleGroupPool<TestGroup> pool;
+				std::vector<uint32_t> freeLists;
+				for (size_t effect = 0; effect < numEffects; ++effect)
+				{
+					freeLists.push_back(pool.addFreeList());
+				}
+
+				std::mt19937 rng(5);
+				std::uniform_int_distribution<size_t> spawnCount(0, maxSpawnsPerFrame);
+				std::uniform_int_distribution<size_t> effectPick(0, numEffects - 1);
+				std::uniform_int_distribution<int> lifetime(1, maxLifetimeFrames);
+
+				struct Tracked
+				{
+					ParticleGroupHandle handle;
+					size_t spawnId;
+				};
+				std::vector<Tracked> live;
+				std::vector<Tracked> expired;
+
+				size_t nextSpawnId = 1;
+				size_t effectDataReallocations = 0;
+				uint64_t allocationsWhenWarm = 0;
+				uint64_t acquiresWhenWarm = 0;
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					if (frame == warmFrames)
+					{
+						allocationsWhenWarm = pool.getStats().numGroupAllocations;
+						acquiresWhenWarm = pool.getStats().numAcquired;
+						effectDataReallocations = 0;
+					}
+
+					//spawn
+					const size_t numSpawns = spawnCount(rng);
+					for (size_t spawn = 0; spawn < numSpawns; ++spawn)
+					{
+						const size_t effect = effectPick(rng);
+						ParticleGroupHandle handle = pool.acquire(freeLists[effect]);
+						TestGroup& group = *pool.find(handle);
+
+						//like generateMutableEffectData, sized by the effect; a group recycled for the same effect needs no allocation
+						const size_t effectDataSize = (effect + 1) * 16;
+						effectDataReallocations += group.effectData.capacity() < effectDataSize;
+						group.effectData.resize(effectDataSize);
+
+						group.spawnId = nextSpawnId++;
+						group.framesLeft = lifetime(rng);
+						live.push_back(Tracked{ handle, group.spawnId });
+					}
+
+					//update; expired groups are swap-removed and the moved group is updated at the same index
+					for (size_t activeIdx = 0; activeIdx < pool.getNumActive(); /*advanced in loop*/)
+					{
+						if (--pool.getActive(activeIdx).framesLeft <= 0)
+						{
+							pool.releaseActive(activeIdx);
+						}
+						else
+						{
+							++activeIdx;
+						}
+					}
+
+					//every live handle must resolve to its own group, and every expired one to nothing
+					for (size_t idx = 0; idx < live.size(); /*advanced in loop*/)
+					{
+						if (TestGroup* group = pool.find(live[idx].handle))
+						{
+							if (group->spawnId != live[idx].spawnId)
+							{
+								errorMessage = "handle resolved to the wrong group on frame " + std::to_string(frame);
+								return false;
+							}
+							++idx;
+						}
+						else
+						{
+							expired.push_back(live[idx]);
+							live[idx] = live.back();
+							live.pop_back();
+						}
+					}
+					if (live.size() != pool.getNumActive())
+					{
+						errorMessage = "dense active list does not match live groups on frame " + std::to_string(frame);
+						return false;
+					}
+					for (const Tracked& stale : expired)
+					{
+						if (pool.find(stale.handle))
+						{
+							errorMessage = "expired handle resolved on frame " + std::to_string(frame);
+							return false;
+						}
+					}
+					if (expired.size() > 4096)
+					{
+						expired.erase(expired.begin(), expired.begin() + 2048);
+					}
+				}
+
+				const ParticleGroupPoolStats& stats = pool.getStats();
+				if (stats.numAcquired != nextSpawnId - 1 || stats.numAcquired != stats.numRecycled + stats.numGroupAllocations
+					|| stats.numReleased != stats.numAcquired - pool.getNumActive())
+				{
+					errorMessage = "counters do not add up";
+					return false;
+				}
+
+				//the pool is bounded by the peak number of live groups, not by how many were spawned
+				if (pool.getNumGroups() != stats.numGroupAllocations || stats.numGroupAllocations > numEffects * maxSpawnsPerFrame * maxLifetimeFrames / 4)
+				{
+					errorMessage = "pool grew with spawn count; allocations " + std::to_string(stats.numGroupAllocations);
+					return false;
+				}
+
+				//once warm, spawns are (nearly) always recycled; a few allocations may still happen at new peaks
+				const uint64_t warmAllocations = stats.numGroupAllocations - allocationsWhenWarm;
+				if (warmAllocations * 100 > stats.numAcquired - acquiresWhenWarm)
+				{
+					errorMessage = "warm pool kept allocating; " + std::to_string(warmAllocations) + " allocations after warm up";
+					return false;
+				}
+				if (effectDataReallocations > warmAllocations)
+				{
+					errorMessage = "recycled groups had to reallocate effect data";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ParticleGroupPoolTestSuite : public SA::TestSuite
+		{
+		public:
+			ParticleGroupPoolTestSuite()
+			{
+				testName = "PARTICLE GROUP POOL TEST SUITE";
+
+				addTest(new_sp<Test_Handles>());
+				addTest(new_sp<Test_FreeLists>());
+				addTest(new_sp<Test_ReleaseDropsConfig>());
+				addTest(new_sp<Test_Clear>());
+				addTest(new_sp<Test_SpawnExpireStress>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getParticleGroupPoolTestSuite()
+	{
+		return new_sp<SA::ParticleGroupPoolTests::ParticleGroupPoolTestSuite>();
+	}
+}
@@ -0,0 +1,204 @@
+#include "EngineTestSuite.h"
+#include "../Game/GameSystems/SAProjectileStore.h"
+
+#include <random>
+#include <algorithm>
+
+namespace SA
+{
+	namespace ProjectileStoreTests
+	{
+		class ProjectileStore_UnitTest : public SA::UnitTest
+		{
+		public:
+			ProjectileStore_UnitTest()
+			{
+				testNamespace = "ProjectileStore:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct TestPayload
+		{
+			int id = -1;
+		};
+		using TestStore = ProjectileStore<TestPayload>;
+
+		static ProjectileHandle addProjectile(TestStore& store, int id, float lifetimeSec = 1.f)
+		{
+			TestStore::SpawnValues values;
+			values.position = glm::vec3(float(id), 0.f, 0.f);
+			values.direction_n = glm::vec3(0.f, 0.f, -1.f);
+			values.speed = 10.f;
+			values.lifetimeSec = lifetimeSec;
+
+			TestPayload payload;
+			payload.id = id;
+			return store.add(values, std::move(payload));
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// handles resolve to the same projectile after other projectiles are swap-removed
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_HandlesStableAcrossRemoval : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Handles stable across swap removal";
+
+				TestStore store;
+				std::vector<ProjectileHandle> handles;
+				for (int id = 0; id < 100; ++id)
+				{
+					handles.push_back(addProjectile(store, id));
+				}
+
+				//remove every third projectile in a scrambled order
+				std::mt19937 rng(3);
+				std::vector<int> toRemove;
+				for (int id = 0; id < 100; id += 3) { toRemove.push_back(id); }
+				std::shuffle(toRemove.begin(), toRemove.end(), rng);
+				for (int id : toRemove)
+				{
+					if (!store.remove(handles[id]))
+					{
+						errorMessage = "failed to remove a live projectile";
+						return false;
+					}
+				}
+
+				for (int id = 0; id < 100; ++id)
+				{
+					size_t denseIdx;
+					bool bShouldBeAlive = (id % 3) != 0;
+					if (store.resolve(handles[id], denseIdx) != bShouldBeAlive)
+					{
+						errorMessage = "handle liveness incorrect for projectile " + std::to_string(id);
+						return false;
+					}
+					if (bShouldBeAlive && (store.getColdData(denseIdx).id != id || store.getPosition(denseIdx).x != float(id)))
+					{
+						errorMessage = "handle resolved to the wrong projectile after swap removal";
+						return false;
+					}
+				}
+				if (store.size() != 66)
+				{
+					errorMessage = "unexpected number of projectiles after removal";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// stale handles do not resolve to projectiles that reuse their slot
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_StaleHandlesRejected : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Stale handles rejected after slot reuse";
+
+				TestStore store;
+				ProjectileHandle first = addProjectile(store, 1);
+				store.remove(first);
+				ProjectileHandle second = addProjectile(store, 2);
+
+				if (first.slot != second.slot)
+				{
+					errorMessage = "expected the freed slot to be reused";
+					return false;
+				}
+				if (store.isAlive(first) || store.remove(first))
+				{
+					errorMessage = "stale handle resolved after slot was reused";
+					return false;
+				}
+
+				store.clear();
+				if (store.isAlive(second) || store.size() != 0)
+				{
+					errorMessage = "handle still alive after clear";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// batch advance and expiration removal
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_AdvanceAndExpire : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Batch advance and expiration";
+
+				TestStore store;
+				for (int id = 0; id < 50; ++id)
+				{
+					//even ids expire after the first tick
+					addProjectile(store, id, (id % 2 == 0) ? 0.05f : 10.f);
+				}
+
+				const float dt_sec = 0.1f;
+				store.advance(dt_sec);
+
+				for (size_t denseIdx = 0; denseIdx < store.size(); ++denseIdx)
+				{
+					glm::vec3 expected = store.getStepStart(denseIdx) + store.getDirection(denseIdx) * (store.getSpeed(denseIdx) * dt_sec);
+					if (store.getPosition(denseIdx) != expected || store.getStepDistance(denseIdx) != store.getSpeed(denseIdx) * dt_sec)
+					{
+						errorMessage = "advance did not move projectile along its direction";
+						return false;
+					}
+				}
+
+				int numReleased = 0;
+				store.removeIf(
+					[&](size_t denseIdx) { return store.isExpired(denseIdx); },
+					[&](size_t denseIdx) { numReleased += (store.getColdData(denseIdx).id % 2 == 0) ? 1 : 1000; }
+				);
+
+				if (numReleased != 25 || store.size() != 25)
+				{
+					errorMessage = "removeIf did not release exactly the expired projectiles";
+					return false;
+				}
+				for (size_t denseIdx = 0; denseIdx < store.size(); ++denseIdx)
+				{
+					if (store.getColdData(denseIdx).id % 2 == 0 || store.getHandle(denseIdx).slot != uint32_t(store.getColdData(denseIdx).id))
+					{
+						errorMessage = "unexpected survivor after removeIf";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ProjectileStoreTestSuite : public SA::TestSuite
+		{
+		public:
+			ProjectileStoreTestSuite()
+			{
+				testName = "PROJECTILE STORE TEST SUITE";
+
+				addTest(new_sp<Test_HandlesStableAcrossRemoval>());
+				addTest(new_sp<Test_StaleHandlesRejected>());
+				addTest(new_sp<Test_AdvanceAndExpire>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getProjectileStoreTestSuite()
+	{
+		return new_sp<SA::ProjectileStoreTests::ProjectileStoreTestSuite>();
+	}
+}
@@ -0,0 +1,304 @@
+#include "EngineTestSuite.h"
+#include "..\..\..\Algorithms\SeparatingAxisTheorem\SATComponent.h"
+#include "..\..\..\Algorithms\SeparatingAxisTheorem\SATUnitTestUtils.h"
+
+#include <random>
+#include <gtx/norm.hpp>
+#include <gtc/constants.hpp>
+
+namespace SA
+{
+	namespace SATTests
+	{
+		class SAT_UnitTest : public SA::UnitTest
+		{
+		public:
+			SAT_UnitTest()
+			{
+				testNamespace = "SAT:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		static SAT::DynamicTriangleMeshShape::TriangleProcessor makeOctahedronTriangles()
+		{
+			using TriangleCCW = SAT::DynamicTriangleMeshShape::TriangleProcessor::TriangleCCW;
+			using glm::vec4;
+
+			const vec4 top(0, 1, 0, 1), bottom(0, -1, 0, 1);
+			const vec4 ring[4] = { vec4(1, 0, 0, 1), vec4(0, 0, -1, 1), vec4(-1, 0, 0, 1), vec4(0, 0, 1, 1) };
+
+			std::vector<TriangleCCW> triangles;
+			for (size_t idx = 0; idx < 4; ++idx)
+			{
+				const vec4& a = ring[idx];
+				const vec4& b = ring[(idx + 1) % 4];
+				triangles.push_back({ a, b, top });
+				triangles.push_back({ b, a, bottom });
+			}
+			return SAT::DynamicTriangleMeshShape::TriangleProcessor(triangles, 0.001f);
+		}
+
+		/** latitude/longitude sphere; gives mesh shapes with a few hundred points, which is where batch projection matters */
+		static SAT::DynamicTriangleMeshShape::TriangleProcessor makeSphereTriangles(size_t numRings, size_t numSegments)
+		{
+			using TriangleCCW = SAT::DynamicTriangleMeshShape::TriangleProcessor::TriangleCCW;
+			using glm::vec4;
+
+			auto spherePoint = [&](size_t ring, size_t segment)
+			{
+				float polar = glm::pi<float>() * float(ring) / float(numRings);
+				float azimuth = 2.f * glm::pi<float>() * float(segment) / float(numSegments);
+				return vec4(glm::sin(polar) * glm::cos(azimuth), glm::cos(polar), glm::sin(polar) * glm::sin(azimuth), 1.f);
+			};
+
+			std::vector<TriangleCCW> triangles;
+			for (size_t ring = 0; ring < numRings; ++ring)
+			{
+				for (size_t segment = 0; segment < numSegments; ++segment)
+				{
+					vec4 topLeft = spherePoint(ring, segment), topRight = spherePoint(ring, segment + 1);
+					vec4 botLeft = spherePoint(ring + 1, segment), botRight = spherePoint(ring + 1, segment + 1);
+					if (ring != 0) { triangles.push_back({ topLeft, topRight, botLeft }); }
+					if (ring + 1 != numRings) { triangles.push_back({ topRight, botRight, botLeft }); }
+				}
+			}
+			return SAT::DynamicTriangleMeshShape::TriangleProcessor(triangles, 0.001f);
+		}
+
+		static glm::vec3 randomAxis(std::mt19937& rng)
+		{
+			std::uniform_real_distribution<float> componentDist(-1.f, 1.f);
+			glm::vec3 axis(0.f);
+			while (glm::length2(axis) < 0.01f)
+			{
+				axis = glm::vec3(componentDist(rng), componentDist(rng), componentDist(rng));
+			}
+			return glm::normalize(axis);
+		}
+
+		static void randomizeTransform(SAT::Shape& shape, std::mt19937& rng, float halfExtent)
+		{
+			std::uniform_real_distribution<float> posDist(-halfExtent, halfExtent);
+			std::uniform_real_distribution<float> rotDist(0.f, 360.f);
+			std::uniform_real_distribution<float> scaleDist(0.5f, 2.f);
+
+			SAT::ColumnBasedTransform transform;
+			transform.position = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+			transform.rotQuat = SAT::convertVecOfRotationsToQuat(glm::vec3(rotDist(rng), rotDist(rng), rotDist(rng)));
+			transform.scale = glm::vec3(scaleDist(rng), scaleDist(rng), scaleDist(rng));
+			shape.updateTransform(transform.getModelMatrix());
+		}
+
+		/** returns empty string on success, otherwise the failure reason */
+		static std::string compareToReference(const SAT::Shape& moving, const SAT::Shape& stationary)
+		{
+			glm::vec4 cachedMTV(-1.f), referenceMTV(-1.f);
+			bool cachedHit = SAT::Shape::CollisionTest(moving, stationary, cachedMTV);
+			bool referenceHit = SAT::Shape::CollisionTest_Reference(moving, stationary, referenceMTV);
+
+			if (cachedHit != referenceHit)
+			{
+				return "collision result differs from reference";
+			}
+
+			//same axes are tested in the same order, so the results should match exactly rather than within a tolerance
+			if (cachedMTV != referenceMTV)
+			{
+				return "MTV differs from reference";
+			}
+			return "";
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// cached axis collision test matches the reference for random shape pairs
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_CachedAxesMatchReference : public SAT_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cached axis collision test matches reference";
+
+				SAT::CubeShape cube;
+				SAT::PolygonCapsuleShape capsule;
+				SAT::DynamicTriangleMeshShape octahedron(makeOctahedronTriangles());
+				SAT::Shape* shapes[] = { &cube, &capsule, &octahedron };
+
+				std::mt19937 rng(2019);
+				size_t numHits = 0, numMisses = 0;
+				for (int iteration = 0; iteration < 2000; ++iteration)
+				{
+					for (SAT::Shape* moving : shapes)
+					{
+						for (SAT::Shape* stationary : shapes)
+						{
+							if (moving == stationary)
+							{
+								continue;
+							}
+
+							//small extent so that roughly half of the pairs overlap
+							randomizeTransform(*moving, rng, 1.5f);
+							randomizeTransform(*stationary, rng, 1.5f);
+
+							errorMessage = compareToReference(*moving, *stationary);
+							if (!errorMessage.empty())
+							{
+								errorMessage = "iteration " + std::to_string(iteration) + ": " + errorMessage;
+								return false;
+							}
+
+							glm::vec4 mtv;
+							SAT::Shape::CollisionTest(*moving, *stationary, mtv) ? ++numHits : ++numMisses;
+						}
+					}
+				}
+
+				if (numHits == 0 || numMisses == 0)
+				{
+					errorMessage = "random scene did not exercise both overlapping and separated pairs";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// cached axes follow transform updates
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_CachedAxesFollowTransform : public SAT_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cached axes follow transform updates";
+
+				SAT::CubeShape moving;
+				SAT::CubeShape stationary;
+
+				//rotated 45 degrees, the cubes' corners overlap along x; an axis-aligned cube at the same spot would not collide
+				SAT::ColumnBasedTransform movingTransform;
+				movingTransform.position = glm::vec3(1.15f, 0.f, 0.f);
+				moving.updateTransform(movingTransform.getModelMatrix());
+
+				glm::vec4 mtv;
+				if (SAT::Shape::CollisionTest(moving, stationary, mtv))
+				{
+					errorMessage = "axis aligned cubes should be separated";
+					return false;
+				}
+
+				movingTransform.rotQuat = SAT::convertVecOfRotationsToQuat(glm::vec3(0.f, 0.f, 45.f));
+				moving.updateTransform(movingTransform.getModelMatrix());
+				if (!SAT::Shape::CollisionTest(moving, stationary, mtv))
+				{
+					errorMessage = "rotated cube should collide; cached axes were not refreshed";
+					return false;
+				}
+
+				errorMessage = compareToReference(moving, stationary);
+				return errorMessage.empty();
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// batch projection matches scalar projectToAxis
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BatchProjectionMatchesScalar : public SAT_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = std::string("Batch projection matches projectToAxis (") + SAT::Shape::getBatchProjectionInstructionSet() + ")";
+
+				SAT::CubeShape cube;
+				SAT::PolygonCapsuleShape capsule;
+				SAT::DynamicTriangleMeshShape octahedron(makeOctahedronTriangles());
+				SAT::DynamicTriangleMeshShape sphere(makeSphereTriangles(8, 12));
+				SAT::Shape* shapes[] = { &cube, &capsule, &octahedron, &sphere };
+
+				auto matchesScalar = [](const SAT::Shape& shape, const glm::vec3& axis, float min, float max)
+				{
+					//kernels use the same operation order as glm::dot, so results are compared exactly
+					SAT::ProjectionRange scalar = shape.projectToAxis(axis);
+					return scalar.min == min && scalar.max == max;
+				};
+
+				std::mt19937 rng(8);
+				std::uniform_real_distribution<float> largeExtentDist(0.f, 500.f);
+				const size_t maxAxes = 13; //covers full 8 and 4 wide batches plus a scalar remainder
+				glm::vec3 axes[maxAxes];
+				float mins[maxAxes], maxs[maxAxes];
+
+				for (int iteration = 0; iteration < 500; ++iteration)
+				{
+					for (SAT::Shape* shape : shapes)
+					{
+						randomizeTransform(*shape, rng, largeExtentDist(rng));
+						for (glm::vec3& axis : axes)
+						{
+							axis = randomAxis(rng);
+						}
+
+						SAT::ProjectionRanges4 ranges4;
+						shape->projectToAxes4(axes, ranges4);
+						for (size_t idx = 0; idx < 4; ++idx)
+						{
+							if (!matchesScalar(*shape, axes[idx], ranges4.min[idx], ranges4.max[idx]))
+							{
+								errorMessage = "projectToAxes4 differs from projectToAxis at iteration " + std::to_string(iteration);
+								return false;
+							}
+						}
+
+						SAT::ProjectionRanges8 ranges8;
+						shape->projectToAxes8(axes, ranges8);
+						for (size_t idx = 0; idx < 8; ++idx)
+						{
+							if (!matchesScalar(*shape, axes[idx], ranges8.min[idx], ranges8.max[idx]))
+							{
+								errorMessage = "projectToAxes8 differs from projectToAxis at iteration " + std::to_string(iteration);
+								return false;
+							}
+						}
+
+						for (size_t numAxes = 0; numAxes <= maxAxes; ++numAxes)
+						{
+							shape->projectToAxes(axes, numAxes, mins, maxs);
+							for (size_t idx = 0; idx < numAxes; ++idx)
+							{
+								if (!matchesScalar(*shape, axes[idx], mins[idx], maxs[idx]))
+								{
+									errorMessage = "projectToAxes with " + std::to_string(numAxes) + " axes differs from projectToAxis";
+									return false;
+								}
+							}
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SATTestSuite : public SA::TestSuite
+		{
+		public:
+			SATTestSuite()
+			{
+				testName = "SAT TEST SUITE";
+
+				addTest(new_sp<Test_CachedAxesMatchReference>());
+				addTest(new_sp<Test_CachedAxesFollowTransform>());
+				addTest(new_sp<Test_BatchProjectionMatchesScalar>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSATTestSuite()
+	{
+		return new_sp<SA::SATTests::SATTestSuite>();
+	}
+}
@@ -0,0 +1,534 @@
+#include "EngineTestSuite.h"
+#include "../Tools/ModelLoading/SASkeletalAnimator.h"
+
+#include <map>
+#include <random>
+#include <cmath>
+#include <gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace SkeletalAnimationTests
+	{
+		class SkeletalAnimation_UnitTest : public SA::UnitTest
+		{
+		public:
+			SkeletalAnimation_UnitTest()
+			{
+				testNamespace = "SkeletalAnimation:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		static aiNode* addChild(aiNode* parent, const char* name, const aiMatrix4x4& transform)
+		{
+			aiNode* child = new aiNode(name);
+			child->mTransformation = transform;
+			child->mParent = parent;
+
+			aiNode** children = new aiNode*[parent->mNumChildren + 1];
+			for (uint32_t childIdx = 0; childIdx < parent->mNumChildren; ++childIdx)
+			{
+				children[childIdx] = parent->mChildren[childIdx];
+			}
+			children[parent->mNumChildren] = child;
+			delete[] parent->mChildren;
+			parent->mChildren = children;
+			parent->mNumChildren += 1;
+			return child;
+		}
+
+		static aiMatrix4x4 makeTransform(float x, float angle, float scale)
+		{
+			return aiMatrix4x4(aiVector3D(scale), aiQuaternion(aiVector3D(0.3f, 1.f, 0.2f).Normalize(), angle), aiVector3D(x, 1.f, -0.5f * x));
+		}
+
+		/** a small rig with a few nodes that no channel drives, like the armature and mesh nodes of an imported model */
+		static up<aiNode> makeSkeleton()
+		{
+			up<aiNode> root = new_up<aiNode>("Scene");
+			root->mTransformation = makeTransform(0.f, 1.57f, 0.01f);
+
+			aiNode* armature = addChild(root.get(), "Armature", makeTransform(0.f, -0.3f, 1.f));
+			aiNode* hips = addChild(armature, "Hips", makeTransform(0.f, 0.f, 1.f));
+			aiNode* spine = addChild(hips, "Spine", makeTransform(1.f, 0.1f, 1.f));
+			addChild(spine, "Head", makeTransform(1.f, 0.2f, 1.f));
+			aiNode* armL = addChild(spine, "ArmL", makeTransform(0.5f, 0.8f, 1.f));
+			addChild(armL, "HandL", makeTransform(0.5f, -0.2f, 1.f));
+			addChild(spine, "ArmR", makeTransform(-0.5f, -0.8f, 1.f));
+			addChild(root.get(), "Prop", makeTransform(3.f, 0.4f, 2.f));
+			return root;
+		}
+
+		/** keys at irregular, strictly increasing times from 0 to duration */
+		static std::vector<double> makeKeyTimes(std::mt19937& rng, uint32_t numKeys, double duration)
+		{
+			std::vector<double> times(numKeys, 0.0);
+			if (numKeys > 1)
+			{
+				std::uniform_real_distribution<double> spacing(0.25, 1.75);
+				double total = 0.0;
+				for (uint32_t key = 1; key < numKeys; ++key)
+				{
+					total += spacing(rng);
+					times[key] = total;
+				}
+				for (double& time : times)
+				{
+					time *= duration / total;
+				}
+				times.back() = duration;
+			}
+			return times;
+		}
+
+		static aiNodeAnim* makeChannel(std::mt19937& rng, const char* nodeName, uint32_t numPositionKeys, uint32_t numRotationKeys, uint32_t numScalingKeys, double duration)
+		{
+			std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+			aiNodeAnim* channel = new aiNodeAnim();
+			channel->mNodeName.Set(nodeName);
+
+			channel->mNumPositionKeys = numPositionKeys;
+			channel->mPositionKeys = numPositionKeys ? new aiVectorKey[numPositionKeys] : nullptr;
+			std::vector<double> times = makeKeyTimes(rng, numPositionKeys, duration);
+			for (uint32_t key = 0; key < numPositionKeys; ++key)
+			{
+				channel->mPositionKeys[key] = aiVectorKey(times[key], aiVector3D(unit(rng), 1.f + unit(rng), unit(rng)));
+			}
+
+			channel->mNumRotationKeys = numRotationKeys;
+			channel->mRotationKeys = numRotationKeys ? new aiQuatKey[numRotationKeys] : nullptr;
+			times = makeKeyTimes(rng, numRotationKeys, duration);
+			for (uint32_t key = 0; key < numRotationKeys; ++key)
+			{
+				aiVector3D axis = aiVector3D(unit(rng), unit(rng), 1.f).Normalize();
+				channel->mRotationKeys[key] = aiQuatKey(times[key], aiQuaternion(axis, 1.5f * unit(rng)));
+			}
+
+			channel->mNumScalingKeys = numScalingKeys;
+			channel->mScalingKeys = numScalingKeys ? new aiVectorKey[numScalingKeys] : nullptr;
+			times = makeKeyTimes(rng, numScalingKeys, duration);
+			for (uint32_t key = 0; key < numScalingKeys; ++key)
+			{
+				channel->mScalingKeys[key] = aiVectorKey(times[key], aiVector3D(1.f + 0.25f * unit(rng)));
+			}
+			return channel;
+		}
+
+		/** covers dense channels, single key channels, and channels missing some key types entirely */
+		static up<aiAnimation> makeAnimation()
+		{
+			std::mt19937 rng(1337);
+
+			up<aiAnimation> anim = new_up<aiAnimation>();
+			anim->mDuration = 40.0;
+			anim->mTicksPerSecond = 24.0;
+
+			std::vector<aiNodeAnim*> channels = {
+				makeChannel(rng, "Hips", 41, 41, 41, anim->mDuration),
+				makeChannel(rng, "Spine", 1, 1, 1, anim->mDuration),
+				makeChannel(rng, "Head", 7, 0, 0, anim->mDuration),
+				makeChannel(rng, "ArmL", 2, 23, 3, anim->mDuration),
+				makeChannel(rng, "HandL", 17, 9, 2, anim->mDuration),
+				makeChannel(rng, "ArmR", 5, 13, 1, anim->mDuration),
+			};
+			anim->mNumChannels = uint32_t(channels.size());
+			anim->mChannels = new aiNodeAnim*[anim->mNumChannels];
+			std::copy(channels.begin(), channels.end(), anim->mChannels);
+			return anim;
+		}
+
+		static SkeletalAnimator makeAnimator(const aiNode& root, const aiAnimation& anim)
+		{
+			SkeletalAnimator animator;
+			animator.initialize(ModelBake::bakeNodes(root), { ModelBake::bakeAnimation(anim) });
+			return animator;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// reference: how Model3D evaluated animations when it walked the assimp scene directly
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		namespace Reference
+		{
+			static glm::vec3 toGlmVec3(const aiVector3D& aiVec3)
+			{
+				return glm::vec3(aiVec3.x, aiVec3.y, aiVec3.z);
+			}
+
+			static aiMatrix4x4 toAiMat4(glm::mat4 glmMat4)
+			{
+				aiMatrix4x4 result;
+				result.a1 = glmMat4[0][0]; result.a2 = glmMat4[1][0]; result.a3 = glmMat4[2][0]; result.a4 = glmMat4[3][0];
+				result.b1 = glmMat4[0][1]; result.b2 = glmMat4[1][1]; result.b3 = glmMat4[2][1]; result.b4 = glmMat4[3][1];
+				result.c1 = glmMat4[0][2]; result.c2 = glmMat4[1][2]; result.c3 = glmMat4[2][2]; result.c4 = glmMat4[3][2];
+				result.d1 = glmMat4[0][3]; result.d2 = glmMat4[1][3]; result.d3 = glmMat4[2][3]; result.d4 = glmMat4[3][3];
+				return result;
+			}
+
+			static aiMatrix4x4 rotation3x3To4x4Helper(const aiMatrix3x3& src)
+			{
+				aiMatrix4x4 result;
+				result.a1 = src.a1; result.a2 = src.a2; result.a3 = src.a3;
+				result.b1 = src.b1; result.b2 = src.b2; result.b3 = src.b3;
+				result.c1 = src.c1; result.c2 = src.c2; result.c3 = src.c3;
+				return result;
+			}
+
+			template<typename KEY_TYPE>
+			static glm::uvec2 searchForKeys(const KEY_TYPE* keys, uint32_t numKeys, float animationTimeInTicks)
+			{
+				if (numKeys == 1)
+				{
+					return glm::uvec2(0, 0);
+				}
+				for (uint32_t animKey = 0; animKey < numKeys - 1; ++animKey)
+				{
+					bool bCurrKeyBeforeTime = keys[animKey].mTime <= animationTimeInTicks;
+					bool bNextKeyAfterTime = keys[animKey + 1].mTime >= animationTimeInTicks;
+					if (bCurrKeyBeforeTime && bNextKeyAfterTime)
+					{
+						return glm::uvec2(animKey, animKey + 1);
+					}
+				}
+				return glm::uvec2(~0u, ~0u);
+			}
+
+			static aiMatrix4x4 interpolatePositionKeys(const aiNodeAnim& animNode, float animationTimeInTicks)
+			{
+				if (animNode.mNumPositionKeys == 1)
+				{
+					return toAiMat4(glm::translate(glm::mat4{ 1.0f }, toGlmVec3(animNode.mPositionKeys[0].mValue)));
+				}
+				if (animNode.mNumPositionKeys > 0)
+				{
+					glm::uvec2 keyIdxs = searchForKeys(animNode.mPositionKeys, animNode.mNumPositionKeys, animationTimeInTicks);
+					uint32_t firstKey = keyIdxs.r, secondKey = keyIdxs.g;
+
+					double delta = animationTimeInTicks - animNode.mPositionKeys[firstKey].mTime;
+					double interkeyTime = animNode.mPositionKeys[secondKey].mTime - animNode.mPositionKeys[firstKey].mTime;
+					float interpAlpha = static_cast<float>(delta / interkeyTime);
+
+					glm::vec3 first = toGlmVec3(animNode.mPositionKeys[firstKey].mValue);
+					glm::vec3 second = toGlmVec3(animNode.mPositionKeys[secondKey].mValue);
+					glm::vec3 interpolated = first + interpAlpha * (second - first);
+					return toAiMat4(glm::translate(glm::mat4{}, interpolated));
+				}
+				return aiMatrix4x4{};
+			}
+
+			static aiMatrix4x4 interpolateRotationKeys(const aiNodeAnim& animNode, float animationTimeInTicks)
+			{
+				if (animNode.mNumRotationKeys == 1)
+				{
+					return rotation3x3To4x4Helper(animNode.mRotationKeys[0].mValue.GetMatrix());
+				}
+				if (animNode.mNumRotationKeys > 0)
+				{
+					glm::uvec2 keyIdxs = searchForKeys(animNode.mRotationKeys, animNode.mNumRotationKeys, animationTimeInTicks);
+					uint32_t firstKey = keyIdxs.r, secondKey = keyIdxs.g;
+
+					double delta = animationTimeInTicks - animNode.mRotationKeys[firstKey].mTime;
+					double interkeyTime = animNode.mRotationKeys[secondKey].mTime - animNode.mRotationKeys[firstKey].mTime;
+					float interpAlpha = static_cast<float>(delta / interkeyTime);
+
+					aiQuaternion outInterpolatedQuat;
+					aiQuaternion::Interpolate(outInterpolatedQuat, animNode.mRotationKeys[firstKey].mValue, animNode.mRotationKeys[secondKey].mValue, interpAlpha);
+					return rotation3x3To4x4Helper(outInterpolatedQuat.GetMatrix());
+				}
+				return aiMatrix4x4{};
+			}
+
+			static aiMatrix4x4 interpolateScaleKeys(const aiNodeAnim& animNode, float animationTimeInTicks)
+			{
+				if (animNode.mNumScalingKeys == 1)
+				{
+					return toAiMat4(glm::scale(glm::mat4{ 1.0f }, toGlmVec3(animNode.mScalingKeys[0].mValue)));
+				}
+				if (animNode.mNumScalingKeys > 0)
+				{
+					glm::uvec2 keyIdxs = searchForKeys(animNode.mScalingKeys, animNode.mNumScalingKeys, animationTimeInTicks);
+					uint32_t firstKey = keyIdxs.r, secondKey = keyIdxs.g;
+
+					double delta = animationTimeInTicks - animNode.mScalingKeys[firstKey].mTime;
+					double interkeyTime = animNode.mScalingKeys[secondKey].mTime - animNode.mScalingKeys[firstKey].mTime;
+					float interpAlpha = static_cast<float>(delta / interkeyTime);
+
+					glm::vec3 first = toGlmVec3(animNode.mScalingKeys[firstKey].mValue);
+					glm::vec3 second = toGlmVec3(animNode.mScalingKeys[secondKey].mValue);
+					glm::vec3 interpolated = first + interpAlpha * (second - first);
+					return toAiMat4(glm::scale(glm::mat4{}, interpolated));
+				}
+				return aiMatrix4x4{};
+			}
+
+			static void calculateAnimationTransforms(const aiNode* node, float animationTimeInTicks, const aiMatrix4x4& parentTransform,
+				const std::map<std::string, const aiNodeAnim*>& nodeNameToChannel, std::map<std::string, aiMatrix4x4>& outGlobalTransforms)
+			{
+				aiMatrix4x4 nodeTransform = node->mTransformation;
+
+				auto animNodePair = nodeNameToChannel.find(node->mName.C_Str());
+				if (animNodePair != nodeNameToChannel.end())
+				{
+					const aiNodeAnim& animNode = *animNodePair->second;
+					nodeTransform = interpolatePositionKeys(animNode, animationTimeInTicks)
+						* interpolateRotationKeys(animNode, animationTimeInTicks)
+						* interpolateScaleKeys(animNode, animationTimeInTicks);
+				}
+
+				aiMatrix4x4 nodeGlobalTransform = parentTransform * nodeTransform;
+				outGlobalTransforms[node->mName.C_Str()] = nodeGlobalTransform;
+
+				for (uint32_t child = 0; child < node->mNumChildren; ++child)
+				{
+					calculateAnimationTransforms(node->mChildren[child], animationTimeInTicks, nodeGlobalTransform, nodeNameToChannel, outGlobalTransforms);
+				}
+			}
+
+			static std::map<std::string, aiMatrix4x4> evaluate(const aiNode& root, const aiAnimation& anim, float animationTimeInTicks)
+			{
+				std::map<std::string, const aiNodeAnim*> nodeNameToChannel;
+				for (uint32_t channel = 0; channel < anim.mNumChannels; ++channel)
+				{
+					nodeNameToChannel[anim.mChannels[channel]->mNodeName.C_Str()] = anim.mChannels[channel];
+				}
+
+				std::map<std::string, aiMatrix4x4> globalTransforms;
+				calculateAnimationTransforms(&root, animationTimeInTicks, aiMatrix4x4{}, nodeNameToChannel, globalTransforms);
+				return globalTransforms;
+			}
+		}
+
+		static float maxDifference(const aiMatrix4x4& a, const aiMatrix4x4& b)
+		{
+			float maxDiff = 0.f;
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				for (uint32_t col = 0; col < 4; ++col)
+				{
+					maxDiff = std::max(maxDiff, std::abs(a[row][col] - b[row][col]));
+				}
+			}
+			return maxDiff;
+		}
+
+		/** largest difference between the animator and the reference walk over all nodes at the given time */
+		static float compareToReference(const SkeletalAnimator& animator, AnimationCursor& cursor, const aiNode& root, const aiAnimation& anim, float animationTimeInTicks)
+		{
+			std::vector<aiMatrix4x4> globalTransforms;
+			animator.evaluate(0, animationTimeInTicks, cursor, globalTransforms);
+			std::map<std::string, aiMatrix4x4> expected = Reference::evaluate(root, anim, animationTimeInTicks);
+
+			float maxDiff = 0.f;
+			const std::vector<BakedNode>& nodes = animator.getNodes();
+			if (expected.size() != nodes.size() || globalTransforms.size() != nodes.size())
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+			for (size_t nodeIdx = 0; nodeIdx < nodes.size(); ++nodeIdx)
+			{
+				maxDiff = std::max(maxDiff, maxDifference(globalTransforms[nodeIdx], expected[nodes[nodeIdx].name]));
+			}
+			return maxDiff;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// cursor + binary search picks the same keys the linear scan did, whatever state the cursor was left in
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_KeySearchMatchesLinearScan : public SkeletalAnimation_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Key search matches linear scan";
+
+				std::mt19937 rng(7);
+				for (uint32_t numKeys : { 2u, 3u, 5u, 64u, 1000u })
+				{
+					std::vector<double> times = makeKeyTimes(rng, numKeys, 100.0);
+					std::vector<aiVectorKey> keys;
+					for (double time : times)
+					{
+						keys.push_back(aiVectorKey(time, aiVector3D(0.f)));
+					}
+
+					std::vector<float> queryTimes;
+					for (double time : times)
+					{
+						queryTimes.push_back(float(time)); //exact key times are where the linear scan's <= and >= matter
+					}
+					std::uniform_real_distribution<float> anyTime(0.f, 100.f);
+					for (uint32_t query = 0; query < 500; ++query)
+					{
+						queryTimes.push_back(anyTime(rng));
+					}
+
+					std::uniform_int_distribution<uint32_t> anyCursor(0, numKeys + 2);
+					for (float time : queryTimes)
+					{
+						glm::uvec2 expected = Reference::searchForKeys(keys.data(), numKeys, time);
+						if (expected.x == ~0u)
+						{
+							continue; //float rounding put time past the last key; the old scan had no answer here
+						}
+
+						uint32_t cursor = anyCursor(rng);
+						glm::uvec2 found = SkeletalAnimator::findKeys(keys.data(), numKeys, time, cursor);
+						if (found != expected || cursor != found.x)
+						{
+							errorMessage = "search disagreed with the linear scan";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// evaluating the flattened hierarchy matches walking the assimp scene, including when playback jumps around
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesSceneWalk : public SkeletalAnimation_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Animator matches assimp scene walk";
+
+				up<aiNode> root = makeSkeleton();
+				up<aiAnimation> anim = makeAnimation();
+				SkeletalAnimator animator = makeAnimator(*root, *anim);
+				AnimationCursor cursor;
+
+				const float duration = float(anim->mDuration);
+				const float tolerance = 1e-5f;
+
+				//normal playback at 60fps, twice so the cursors wrap around like a looping animation
+				const float ticksPerFrame = float(anim->mTicksPerSecond) / 60.f;
+				for (uint32_t loop = 0; loop < 2; ++loop)
+				{
+					for (float time = 0.f; time <= duration; time += ticksPerFrame)
+					{
+						if (compareToReference(animator, cursor, *root, *anim, time) > tolerance)
+						{
+							errorMessage = "playback differs from the scene walk";
+							return false;
+						}
+					}
+				}
+
+				//scrubbing back and forth, and landing exactly on keys
+				std::mt19937 rng(99);
+				std::uniform_real_distribution<float> anyTime(0.f, duration);
+				std::vector<float> times = { 0.f, duration, 0.f };
+				for (const aiNodeAnim* channel : { anim->mChannels[0], anim->mChannels[4] })
+				{
+					for (uint32_t key = 0; key < channel->mNumPositionKeys; ++key)
+					{
+						times.push_back(float(channel->mPositionKeys[key].mTime));
+					}
+				}
+				for (uint32_t jump = 0; jump < 200; ++jump)
+				{
+					times.push_back(anyTime(rng));
+				}
+				for (float time : times)
+				{
+					if (time > duration || compareToReference(animator, cursor, *root, *anim, time) > tolerance)
+					{
+						errorMessage = "scrubbing differs from the scene walk";
+						return false;
+					}
+				}
+
+				//a fresh cursor and a cursor from another animation id give the same answers
+				AnimationCursor staleCursor;
+				staleCursor.animId = 5;
+				staleCursor.keyCursors.assign(3, 1000);
+				if (compareToReference(animator, staleCursor, *root, *anim, duration * 0.5f) > tolerance)
+				{
+					errorMessage = "stale cursor was not reset";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// pre-sampled poses reproduce the keys at sample times and stay close between them
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_PresampledPoses : public SkeletalAnimation_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Pre-sampled poses approximate keys";
+
+				up<aiNode> root = makeSkeleton();
+				up<aiAnimation> anim = makeAnimation();
+				SkeletalAnimator animator = makeAnimator(*root, *anim);
+				AnimationCursor cursor;
+
+				const float samplesPerSecond = 240.f;
+				animator.bakeSamples(samplesPerSecond);
+				if (!animator.hasSamples())
+				{
+					errorMessage = "samples were not baked";
+					return false;
+				}
+
+				const float duration = float(anim->mDuration);
+				const float ticksPerSample = float(anim->mTicksPerSecond) / samplesPerSecond;
+				float worstAtSamples = 0.f;
+				float worstBetweenSamples = 0.f;
+				for (float time = 0.f; time <= duration; time += ticksPerSample * 0.25f)
+				{
+					float diff = compareToReference(animator, cursor, *root, *anim, time);
+					float samplePosition = time / ticksPerSample;
+					float& worst = std::abs(samplePosition - std::round(samplePosition)) < 1e-3f ? worstAtSamples : worstBetweenSamples;
+					worst = std::max(worst, diff);
+				}
+				if (worstAtSamples > 1e-3f)
+				{
+					errorMessage = "sampled poses differ from keys at sample times";
+					return false;
+				}
+				if (worstBetweenSamples > 0.05f)
+				{
+					errorMessage = "sampled poses drift too far from keys between samples";
+					return false;
+				}
+
+				//turning sampling off goes back to evaluating keys exactly
+				animator.bakeSamples(0.f);
+				if (animator.hasSamples() || compareToReference(animator, cursor, *root, *anim, duration * 0.37f) > 1e-5f)
+				{
+					errorMessage = "disabling samples did not restore key evaluation";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SkeletalAnimationTestSuite : public SA::TestSuite
+		{
+		public:
+			SkeletalAnimationTestSuite()
+			{
+				testName = "SKELETAL ANIMATION TEST SUITE";
+
+				addTest(new_sp<Test_KeySearchMatchesLinearScan>());
+				addTest(new_sp<Test_MatchesSceneWalk>());
+				addTest(new_sp<Test_PresampledPoses>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSkeletalAnimationTestSuite()
+	{
+		return new_sp<SA::SkeletalAnimationTests::SkeletalAnimationTestSuite>();
+	}
+}
@@ -0,0 +1,215 @@
+#include "EngineTestSuite.h"
+#include "../Tools/DataStructures/SlotMap.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+namespace SA
+{
+	namespace SlotMapTests
+	{
+		class SlotMap_UnitTest : public SA::UnitTest
+		{
+		public:
+			SlotMap_UnitTest()
+			{
+				testNamespace = "SlotMap:";
+			}
+		};
+
+		/** stands in for a spawned world entity; LevelBase stores sp<WorldEntity> the same way */
+		struct Entity : public GameEntity
+		{
+			Entity(size_t id) : id(id) {}
+			~Entity() { if (onDtor) { onDtor(); } }
+			size_t id;
+			std::function<void()> onDtor;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// spawn and unspawn 100k entities, checking every handle along the way
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SpawnUnspawnManyEntities : public SlotMap_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Spawn and unspawn 100k entities";
+
+				const size_t numEntities = 100000;
+				SlotMap<sp<Entity>> entities;
+				std::vector<SlotHandle> handles;
+				std::vector<wp<Entity>> weakEntities;
+				for (size_t id = 0; id < numEntities; ++id)
+				{
+					sp<Entity> entity = new_sp<Entity>(id);
+					weakEntities.push_back(entity);
+					handles.push_back(entities.insert(std::move(entity)));
+				}
+				for (size_t id = 0; id < numEntities; ++id)
+				{
+					const sp<Entity>* entity = entities.find(handles[id]);
+					if (!entity || (*entity)->id != id)
+					{
+						errorMessage = "handle did not resolve to the entity it was created for";
+						return false;
+					}
+				}
+
+				//unspawn every odd entity in a shuffled order, so holes are filled from everywhere in the dense array
+				std::vector<size_t> unspawnOrder;
+				for (size_t id = 1; id < numEntities; id += 2) { unspawnOrder.push_back(id); }
+				std::shuffle(unspawnOrder.begin(), unspawnOrder.end(), std::mt19937(42));
+				for (size_t id : unspawnOrder)
+				{
+					if (!entities.remove(handles[id]))
+					{
+						errorMessage = "failed to remove a live entity";
+						return false;
+					}
+				}
+				if (entities.remove(handles[1]))
+				{
+					errorMessage = "removed an entity twice";
+					return false;
+				}
+
+				for (size_t id = 0; id < numEntities; ++id)
+				{
+					const bool bSpawned = id % 2 == 0;
+					const sp<Entity>* entity = entities.find(handles[id]);
+					if (entities.contains(handles[id]) != bSpawned || (entity != nullptr) != bSpawned || (entity && (*entity)->id != id))
+					{
+						errorMessage = "handle validity wrong after unspawning; id " + std::to_string(id);
+						return false;
+					}
+					if (weakEntities[id].expired() == bSpawned)
+					{
+						errorMessage = "unspawned entity was not released, or a spawned one was";
+						return false;
+					}
+				}
+
+				//the dense walk visits every spawned entity exactly once, and dense indices map back to their handles
+				std::vector<bool> visited(numEntities, false);
+				for (size_t denseIdx = 0; denseIdx < entities.size(); ++denseIdx)
+				{
+					const size_t id = entities[denseIdx]->id;
+					if (id % 2 != 0 || visited[id] || entities.getHandle(denseIdx) != handles[id])
+					{
+						errorMessage = "dense iteration does not match the spawned entities";
+						return false;
+					}
+					visited[id] = true;
+				}
+				if (entities.size() != numEntities / 2)
+				{
+					errorMessage = "size wrong after unspawning";
+					return false;
+				}
+
+				//respawning reuses the freed slots, and the stale handles into those slots stay stale
+				const size_t numSlots = entities.getNumSlots();
+				std::vector<SlotHandle> respawnedHandles;
+				for (size_t idx = 0; idx < numEntities / 2; ++idx)
+				{
+					respawnedHandles.push_back(entities.insert(new_sp<Entity>(numEntities + idx)));
+				}
+				if (entities.getNumSlots() != numSlots)
+				{
+					errorMessage = "freed slots were not reused";
+					return false;
+				}
+				for (size_t id = 1; id < numEntities; id += 2)
+				{
+					if (entities.contains(handles[id]))
+					{
+						errorMessage = "stale handle resolves to the entity that reused its slot";
+						return false;
+					}
+				}
+				for (size_t idx = 0; idx < respawnedHandles.size(); ++idx)
+				{
+					const sp<Entity>* entity = entities.find(respawnedHandles[idx]);
+					if (!entity || (*entity)->id != numEntities + idx)
+					{
+						errorMessage = "respawned handle did not resolve";
+						return false;
+					}
+				}
+
+				entities.clear();
+				for (size_t id = 0; id < numEntities; ++id)
+				{
+					if (entities.contains(handles[id]) || !weakEntities[id].expired())
+					{
+						errorMessage = "clear left a handle valid or an entity alive";
+						return false;
+					}
+				}
+				if (!entities.empty() || entities.begin() != entities.end())
+				{
+					errorMessage = "clear left entities behind";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// releasing an entity may run code that unspawns others
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_RemovalFromDestructor : public SlotMap_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Unspawn from an entity destructor";
+
+				SlotMap<sp<Entity>> entities;
+				SlotHandle first = entities.insert(new_sp<Entity>(0));
+				SlotHandle middle = entities.insert(new_sp<Entity>(1));
+				SlotHandle last = entities.insert(new_sp<Entity>(2));
+
+				//like an entity that unspawns its children when it goes away
+				(*entities.find(first))->onDtor = [&]() { entities.remove(last); };
+				entities.remove(first);
+
+				if (entities.size() != 1 || !entities.contains(middle) || entities.contains(last) || (*entities.find(middle))->id != 1)
+				{
+					errorMessage = "map inconsistent after a removal inside a removal";
+					return false;
+				}
+
+				SlotHandle respawned = entities.insert(new_sp<Entity>(3));
+				(*entities.find(middle))->onDtor = [&]() { entities.remove(respawned); };
+				entities.clear();
+				if (!entities.empty() || entities.contains(respawned) || entities.contains(middle))
+				{
+					errorMessage = "map inconsistent after a removal inside clear";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SlotMapTestSuite : public SA::TestSuite
+		{
+		public:
+			SlotMapTestSuite()
+			{
+				testName = "SLOT MAP TEST SUITE";
+
+				addTest(new_sp<Test_SpawnUnspawnManyEntities>());
+				addTest(new_sp<Test_RemovalFromDestructor>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSlotMapTestSuite()
+	{
+		return new_sp<SA::SlotMapTests::SlotMapTestSuite>();
+	}
+}
@@ -0,0 +1,431 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/Audio/SoftwareMixer.h"
+#include "../GameFramework/Audio/SoundRawData.h"
+#include "../GameFramework/AssetManagement/AsyncAssetLoader.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace SA
+{
+	namespace SoftwareMixerTests
+	{
+		class SoftwareMixer_UnitTest : public SA::UnitTest
+		{
+		public:
+			SoftwareMixer_UnitTest()
+			{
+				testNamespace = "SoftwareMixer:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers; noise sounds, and a plain double precision render that the mixer's output is checked against
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		sp<SoundRawData> makeNoise(size_t numFrames, unsigned int channels, unsigned int sampleRate, unsigned int seed)
+		{
+			std::mt19937 rng(seed);
+			std::uniform_int_distribution<int> amplitude(-12000, 12000);
+
+			sp<SoundRawData> sound = new_sp<SoundRawData>();
+			sound->channels = channels;
+			sound->sampleRate = sampleRate;
+			sound->totalPCMFrameCount = numFrames;
+			for (size_t sampleIdx = 0; sampleIdx < numFrames * channels; ++sampleIdx)
+			{
+				sound->pcmData.push_back(uint16_t(int16_t(amplitude(rng))));
+			}
+			return sound;
+		}
+
+		struct ReferenceVoice
+		{
+			const SoundRawData* sound = nullptr;
+			bool bLooping = false;
+			double position = 0.0;
+			double step = 1.0;
+			SoftwareVoiceGains gains;
+
+			double frameAt(size_t frame) const
+			{
+				const size_t numFrames = sound->pcmData.size() / sound->channels;
+				if (frame >= numFrames)
+				{
+					if (!bLooping) { return 0.0; }
+					frame %= numFrames;
+				}
+				double sum = 0.0;
+				for (size_t channel = 0; channel < sound->channels; ++channel)
+				{
+					sum += double(int16_t(sound->pcmData[frame * sound->channels + channel]));
+				}
+				return sum / double(sound->channels);
+			}
+
+			/** gains move linearly to the target over the block */
+			void render(const SoftwareVoiceGains& target, std::vector<double>& mixLeft, std::vector<double>& mixRight)
+			{
+				const size_t numFrames = mixLeft.size();
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					const double framePosition = position + double(frame) * step;
+					const size_t sourceFrame = size_t(std::floor(framePosition));
+					const double fraction = framePosition - double(sourceFrame);
+					const double sample = frameAt(sourceFrame) * (1.0 - fraction) + frameAt(sourceFrame + 1) * fraction;
+
+					const double ramp = double(frame + 1) / double(numFrames);
+					mixLeft[frame] += sample * (gains.left + (target.left - gains.left) * ramp);
+					mixRight[frame] += sample * (gains.right + (target.right - gains.right) * ramp);
+				}
+				position += double(numFrames) * step;
+				gains = target;
+			}
+		};
+
+		/** rendered output must be within one step of the rounded reference */
+		bool matchesReference(const std::vector<int16_t>& rendered, const std::vector<double>& mixLeft, const std::vector<double>& mixRight)
+		{
+			for (size_t frame = 0; frame < mixLeft.size(); ++frame)
+			{
+				const double expected[2] = { mixLeft[frame], mixRight[frame] };
+				for (size_t channel = 0; channel < 2; ++channel)
+				{
+					const double clamped = std::min(std::max(expected[channel], -32768.0), 32767.0);
+					if (std::abs(double(rendered[frame * 2 + channel]) - clamped) > 1.0)
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// resampled, pitched, and gain ramped output matches the reference render, including loop seams and the end of a sound
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesReference : public SoftwareMixer_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Output matches reference render";
+
+				const unsigned int outputRate = 44100;
+				sp<SoundRawData> monoLoop = makeNoise(1500, 1, 22050, 1);	//upsampled 2x
+				sp<SoundRawData> stereoOneShot = makeNoise(3000, 2, 48000, 2);	//downsampled, and pitched below
+				sp<SoundRawData> monoLong = makeNoise(20000, 1, 44100, 3);
+
+				SoftwareMixer mixer(outputRate, 1);
+				std::vector<ReferenceVoice> reference(3);
+				std::vector<SoftwareVoiceGains> targets = { { 0.5f, 0.25f }, { 0.1f, 0.7f }, { 0.3f, 0.3f } };
+				std::vector<float> pitches = { 1.f, 1.37f, 0.8f };
+
+				std::vector<SoftwareVoiceHandle> voices;
+				voices.push_back(mixer.addVoice(monoLoop, true, 0, targets[0], pitches[0]));
+				voices.push_back(mixer.addVoice(stereoOneShot, false, 0, targets[1], pitches[1]));
+				voices.push_back(mixer.addVoice(monoLong, false, 700, targets[2], pitches[2]));
+
+				const sp<SoundRawData> sounds[3] = { monoLoop, stereoOneShot, monoLong };
+				for (size_t idx = 0; idx < reference.size(); ++idx)
+				{
+					reference[idx].sound = sounds[idx].get();
+					reference[idx].bLooping = idx == 0;
+					reference[idx].position = idx == 2 ? 700.0 : 0.0;
+					reference[idx].step = double(sounds[idx]->sampleRate) / double(outputRate) * double(pitches[idx]);
+				}
+
+				//odd block sizes so the scalar tail after the four wide loop is covered
+				const size_t blockSizes[] = { 1024, 1023, 517, 4096, 3, 2048 };
+				for (size_t block = 0; block < 6; ++block)
+				{
+					const size_t numFrames = blockSizes[block];
+
+					//parameters change mid stream, so ramps between two nonzero gains are covered
+					if (block == 3)
+					{
+						targets[2] = SoftwareVoiceGains{ 0.05f, 0.6f };
+						pitches[2] = 1.2f;
+						mixer.setVoiceParameters(voices[2], targets[2], pitches[2]);
+						reference[2].step = double(monoLong->sampleRate) / double(outputRate) * double(pitches[2]);
+					}
+
+					std::vector<double> mixLeft(numFrames, 0.0);
+					std::vector<double> mixRight(numFrames, 0.0);
+					for (size_t idx = 0; idx < reference.size(); ++idx)
+					{
+						reference[idx].render(targets[idx], mixLeft, mixRight);
+					}
+
+					std::vector<int16_t> rendered(numFrames * 2);
+					mixer.renderSubmix(0, rendered.data(), numFrames);
+					if (!matchesReference(rendered, mixLeft, mixRight))
+					{
+						errorMessage = "render differs from reference on block " + std::to_string(block);
+						return false;
+					}
+				}
+
+				//the stereo one shot (~2010 output frames long) has finished, the loop and long sound have not
+				if (mixer.isVoiceFinished(voices[0]) || !mixer.isVoiceFinished(voices[1]) || mixer.isVoiceFinished(voices[2]))
+				{
+					errorMessage = "voice finished state is wrong";
+					return false;
+				}
+				if (mixer.getVoiceFrame(voices[2]) != size_t(reference[2].position))
+				{
+					errorMessage = "voice frame does not match playback position";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the sse2 path produces exactly what the scalar path does
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SimdMatchesScalar : public SoftwareMixer_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Sse2 matches scalar";
+
+				SoftwareMixer simdMixer(44100, 2);
+				SoftwareMixer scalarMixer(44100, 2);
+				scalarMixer.setUseSimd(false);
+
+				std::mt19937 rng(99);
+				std::uniform_real_distribution<float> gain(0.f, 0.4f);
+				std::uniform_real_distribution<float> pitch(0.5f, 2.f);
+				std::vector<sp<SoundRawData>> sounds;
+				std::vector<SoftwareVoiceHandle> simdVoices;
+				std::vector<SoftwareVoiceHandle> scalarVoices;
+				for (unsigned int idx = 0; idx < 48; ++idx)
+				{
+					const unsigned int rates[] = { 11025, 22050, 44100, 48000 };
+					sounds.push_back(makeNoise(500 + idx * 97, 1 + idx % 2, rates[idx % 4], idx));
+					const SoftwareVoiceGains gains{ gain(rng), gain(rng) };
+					const float voicePitch = pitch(rng);
+					const bool bLooping = idx % 3 == 0;
+					simdVoices.push_back(simdMixer.addVoice(sounds.back(), bLooping, idx * 11, gains, voicePitch));
+					scalarVoices.push_back(scalarMixer.addVoice(sounds.back(), bLooping, idx * 11, gains, voicePitch));
+				}
+
+				for (size_t block = 0; block < 8; ++block)
+				{
+					const size_t numFrames = block % 2 ? 1021 : 1024;
+					if (block == 4)
+					{
+						for (size_t idx = 0; idx < simdVoices.size(); idx += 5)
+						{
+							simdMixer.removeVoice(simdVoices[idx]);
+							scalarMixer.removeVoice(scalarVoices[idx]);
+						}
+					}
+					for (size_t submixIdx = 0; submixIdx < 2; ++submixIdx)
+					{
+						std::vector<int16_t> simdOut(numFrames * 2);
+						std::vector<int16_t> scalarOut(numFrames * 2);
+						simdMixer.renderSubmix(submixIdx, simdOut.data(), numFrames);
+						scalarMixer.renderSubmix(submixIdx, scalarOut.data(), numFrames);
+						if (simdOut != scalarOut)
+						{
+							errorMessage = "sse2 and scalar output differ on block " + std::to_string(block);
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// attenuation follows OpenAL's inverse distance clamped model and panning keeps power constant
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SpatialGains : public SoftwareMixer_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Spatial gains";
+
+				const glm::vec3 listener(10.f, 0.f, 0.f);
+				const glm::vec3 right(1.f, 0.f, 0.f);
+				const float referenceDistance = 5.f;
+				const float gain = 0.8f;
+				auto near = [](float a, float b) { return std::abs(a - b) < 0.0001f; };
+
+				//inside the reference distance there is no attenuation; ahead of the listener is centered
+				SoftwareVoiceGains ahead = SoftwareMixer::calculateSpatialGains(listener + glm::vec3(0.f, 0.f, -3.f), listener, right, referenceDistance, gain);
+				if (!near(ahead.left, ahead.right) || !near(ahead.left * ahead.left + ahead.right * ahead.right, gain * gain))
+				{
+					errorMessage = "centered emitter is wrong";
+					return false;
+				}
+
+				//twice the reference distance is half the gain; fully to the right is only in the right channel
+				SoftwareVoiceGains farRight = SoftwareMixer::calculateSpatialGains(listener + glm::vec3(10.f, 0.f, 0.f), listener, right, referenceDistance, gain);
+				if (!near(farRight.left, 0.f) || !near(farRight.right, gain * 0.5f))
+				{
+					errorMessage = "attenuation or right pan is wrong";
+					return false;
+				}
+
+				//power is kept across pan positions
+				for (float angle = 0.f; angle < 6.28f; angle += 0.3f)
+				{
+					const glm::vec3 offset(std::cos(angle) * 20.f, 0.f, std::sin(angle) * 20.f);
+					SoftwareVoiceGains panned = SoftwareMixer::calculateSpatialGains(listener + offset, listener, right, referenceDistance, gain);
+					const float expected = gain * 0.25f;
+					if (!near(panned.left * panned.left + panned.right * panned.right, expected * expected) || (offset.x < -1.f && panned.left <= panned.right))
+					{
+						errorMessage = "pan is not equal power";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// voices ramp in and out rather than clicking, and removed voices are released once faded
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_VoiceFades : public SoftwareMixer_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Voices fade in and out";
+
+				//dc so the envelope is the output
+				sp<SoundRawData> dc = new_sp<SoundRawData>();
+				dc->channels = 1;
+				dc->sampleRate = 44100;
+				dc->pcmData.assign(4096, uint16_t(int16_t(10000)));
+
+				SoftwareMixer mixer(44100, 1);
+				SoftwareVoiceHandle voice = mixer.addVoice(dc, true, 0, SoftwareVoiceGains{ 1.f, 1.f }, 1.f);
+
+				const size_t numFrames = 256;
+				std::vector<int16_t> out(numFrames * 2);
+				mixer.renderSubmix(0, out.data(), numFrames);
+				if (std::abs(out[0]) > 100 || out[(numFrames - 1) * 2] != 10000)
+				{
+					errorMessage = "voice did not ramp in";
+					return false;
+				}
+
+				mixer.removeVoice(voice);
+				if (!mixer.isVoiceFinished(voice) || mixer.getNumVoices() != 1)
+				{
+					errorMessage = "removed voice should play out its fade";
+					return false;
+				}
+				mixer.renderSubmix(0, out.data(), numFrames);
+				if (out[0] < 9900 || out[(numFrames - 1) * 2] != 0 || mixer.getNumVoices() != 0)
+				{
+					errorMessage = "voice did not fade out and release";
+					return false;
+				}
+
+				//stale handles are safe to use
+				mixer.setVoiceParameters(voice, SoftwareVoiceGains{ 1.f, 1.f }, 1.f);
+				mixer.removeVoice(voice);
+				mixer.renderSubmix(0, out.data(), numFrames);
+				for (int16_t sample : out)
+				{
+					if (sample != 0)
+					{
+						errorMessage = "released voice is still heard";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// a submix played through a stream is exactly the offline render
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SubmixStream : public SoftwareMixer_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Submix streams";
+
+				sp<SoundRawData> first = makeNoise(3000, 1, 22050, 5);
+				sp<SoundRawData> second = makeNoise(5000, 2, 44100, 6);
+				auto addVoices = [&](SoftwareMixer& mixer)
+				{
+					mixer.addVoice(first, true, 0, SoftwareVoiceGains{ 0.6f, 0.2f }, 1.f);
+					mixer.addVoice(second, false, 0, SoftwareVoiceGains{ 0.3f, 0.3f }, 0.9f);
+				};
+
+				const size_t framesPerChunk = 512;
+				SoftwareMixer offline(44100, 1);
+				addVoices(offline);
+				std::vector<int16_t> expected(framesPerChunk * 2 * 12);
+				for (size_t chunk = 0; chunk < 12; ++chunk)
+				{
+					offline.renderSubmix(0, expected.data() + chunk * framesPerChunk * 2, framesPerChunk);
+				}
+
+				sp<SoftwareMixer> mixer = new_sp<SoftwareMixer>(44100, 1);
+				addVoices(*mixer);
+				NullAudioStreamBackend backend;
+				AssetWorkerPool renderPool(1);
+				const AudioStreamBackend::SourceId source = 3;
+				{
+					AudioStreamConfig config;
+					config.framesPerChunk = framesPerChunk;
+					config.numBuffers = 3;
+					AudioStream stream(new_up<SubmixStreamDecoder>(mixer, 0), backend, renderPool, config);
+					stream.attach(source);
+					while (backend.getPlayedSamples(source).size() < expected.size())
+					{
+						renderPool.waitIdle();
+						stream.service();
+						backend.playBuffers(source, 1);
+					}
+					if (stream.getStats().numUnderruns != 0 || stream.isFinished())
+					{
+						errorMessage = "submix stream should play without end";
+						return false;
+					}
+					stream.detach();
+				}
+				renderPool.stop();
+
+				std::vector<int16_t> played = backend.getPlayedSamples(source);
+				played.resize(expected.size());
+				if (played != expected)
+				{
+					errorMessage = "streamed submix differs from offline render";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SoftwareMixerTestSuite : public SA::TestSuite
+		{
+		public:
+			SoftwareMixerTestSuite()
+			{
+				testName = "SOFTWARE MIXER TEST SUITE";
+
+				addTest(new_sp<Test_MatchesReference>());
+				addTest(new_sp<Test_SimdMatchesScalar>());
+				addTest(new_sp<Test_SpatialGains>());
+				addTest(new_sp<Test_VoiceFades>());
+				addTest(new_sp<Test_SubmixStream>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSoftwareMixerTestSuite()
+	{
+		return new_sp<SA::SoftwareMixerTests::SoftwareMixerTestSuite>();
+	}
+}
@@ -0,0 +1,359 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/AssetManagement/SoundBufferCache.h"
+#include "../GameFramework/Audio/SoundRawData.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace SA
+{
+	namespace SoundBufferCacheTests
+	{
+		class SoundBufferCache_UnitTest : public SA::UnitTest
+		{
+		public:
+			SoundBufferCache_UnitTest()
+			{
+				testNamespace = "SoundBufferCache:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// stub backend; "sounds" are silent mono pcm of a size set per path, buffers are just ids
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct StubBackendState
+		{
+			std::map<std::string, size_t> soundFrames;
+			std::set<SoundBufferCacheBackend::BufferId> liveBuffers;
+			size_t numDecodes = 0;
+			size_t numDestroyedUnknownBuffers = 0;
+			SoundBufferCacheBackend::BufferId nextBuffer = 1;
+		};
+
+		class StubBackend : public SoundBufferCacheBackend
+		{
+		public:
+			StubBackend(const sp<StubBackendState>& state) : state(state) {}
+
+			virtual up<SoundRawData> decode(const std::string& path) override
+			{
+				++state->numDecodes;
+				auto findIter = state->soundFrames.find(path);
+				if (findIter == state->soundFrames.end())
+				{
+					return nullptr;
+				}
+				up<SoundRawData> sound = new_up<SoundRawData>();
+				sound->channels = 1;
+				sound->sampleRate = 44100;
+				sound->totalPCMFrameCount = findIter->second;
+				sound->pcmData.resize(findIter->second);
+				return sound;
+			}
+			virtual BufferId createBuffer(const SoundRawData& sound) override
+			{
+				BufferId buffer = state->nextBuffer++;
+				state->liveBuffers.insert(buffer);
+				return buffer;
+			}
+			virtual void destroyBuffer(BufferId buffer) override
+			{
+				state->numDestroyedUnknownBuffers += state->liveBuffers.erase(buffer) == 0;
+			}
+		private:
+			sp<StubBackendState> state;
+		};
+
+		/** each sound is 1000 frames, 2000 bytes of pcm */
+		sp<SoundBufferCache> makeCache(const sp<StubBackendState>& state, size_t budgetBytes)
+		{
+			for (const char* path : { "a", "b", "c", "d", "e" })
+			{
+				state->soundFrames[path] = 1000;
+			}
+			state->soundFrames["huge"] = 10000;
+			return new_sp<SoundBufferCache>(new_up<StubBackend>(state), budgetBytes);
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// over budget, the least recently used sound goes first; uses reorder, finds do not
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_LruEviction : public SoundBufferCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Evicts least recently used";
+
+				sp<StubBackendState> state = new_sp<StubBackendState>();
+				sp<SoundBufferCache> cache = makeCache(state, 6000);
+
+				cache->loadSound("a");
+				cache->loadSound("b");
+				cache->loadSound("c");
+				cache->loadSound("a");		//a is now the most recent; b is the oldest
+				cache->find("b");			//does not count as a use
+				cache->loadSound("d");
+
+				if (cache->isResident("b") || !cache->isResident("a") || !cache->isResident("c") || !cache->isResident("d"))
+				{
+					errorMessage = "wrong sound evicted";
+					return false;
+				}
+
+				cache->loadSound("e");
+				if (cache->isResident("c") || !cache->isResident("a"))
+				{
+					errorMessage = "second eviction did not take the next oldest";
+					return false;
+				}
+
+				const SoundBufferCacheStats& stats = cache->getStats();
+				if (stats.numHits != 1 || stats.numMisses != 5 || stats.numEvictions != 2 || state->numDecodes != 5)
+				{
+					errorMessage = "hit/miss stats are wrong";
+					return false;
+				}
+
+				//a reload of an evicted sound is a miss that decodes again
+				cache->loadSound("b");
+				if (cache->getStats().numMisses != 6 || state->numDecodes != 6)
+				{
+					errorMessage = "evicted sound was not reloaded";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// resident bytes count pcm and buffer copies, and match the budget after trimming
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ByteAccounting : public SoundBufferCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Byte accounting";
+
+				sp<StubBackendState> state = new_sp<StubBackendState>();
+				sp<SoundBufferCache> cache = makeCache(state, 100000);
+
+				cache->loadSound("a");
+				if (cache->getStats().residentBytes != 2000 || !state->liveBuffers.empty())
+				{
+					errorMessage = "pcm only load should not make a buffer";
+					return false;
+				}
+
+				const SoundBufferCache::BufferId buffer = cache->loadBuffer("a");
+				if (buffer == 0 || cache->getStats().residentBytes != 4000 || state->liveBuffers.size() != 1)
+				{
+					errorMessage = "buffer bytes were not counted";
+					return false;
+				}
+				if (cache->loadBuffer("a") != buffer || state->liveBuffers.size() != 1)
+				{
+					errorMessage = "buffer was made twice";
+					return false;
+				}
+
+				cache->loadBuffer("b");
+				cache->loadSound("c");
+				if (cache->getStats().residentBytes != 10000 || cache->getStats().numResident != 3)
+				{
+					errorMessage = "resident bytes are wrong";
+					return false;
+				}
+
+				//shrinking the budget trims down to it; c is the newest but a buffered sound costs double
+				cache->setBudget(5000);
+				if (cache->getStats().residentBytes != 2000 || !cache->isResident("c") || state->liveBuffers.size() != 0)
+				{
+					errorMessage = "budget change did not trim to fit";
+					return false;
+				}
+
+				if (!cache->unload("c") || cache->getStats().residentBytes != 0 || cache->getStats().numResident != 0)
+				{
+					errorMessage = "unload did not release bytes";
+					return false;
+				}
+				if (cache->getStats().peakResidentBytes != 10000)
+				{
+					errorMessage = "peak is wrong";
+					return false;
+				}
+
+				//failed decodes are counted, and leave nothing behind
+				if (cache->loadSound("missing") || cache->getStats().numFailedLoads != 1 || cache->getStats().numResident != 0)
+				{
+					errorMessage = "failed load left state behind";
+					return false;
+				}
+
+				//a sound bigger than the whole budget is kept while it is the one being used
+				if (cache->loadBuffer("huge") == 0 || !cache->isResident("huge"))
+				{
+					errorMessage = "oversized sound was evicted by its own load";
+					return false;
+				}
+				cache->loadSound("a");
+				if (cache->isResident("huge") || state->numDestroyedUnknownBuffers != 0)
+				{
+					errorMessage = "oversized sound was not evicted by the next load";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// pinned sounds (eg attached to a playing source) are never evicted; the cache trims once they're released
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Pinning : public SoundBufferCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Pinned sounds are not evicted";
+
+				sp<StubBackendState> state = new_sp<StubBackendState>();
+				sp<SoundBufferCache> cache = makeCache(state, 6000);
+
+				SoundBufferPin pinA = cache->pin("a", true);
+				SoundBufferPin pinB = cache->pin("b", false);
+				if (!pinA || pinA.getBuffer() == 0 || pinB.getBuffer() != 0 || !pinB.getSound())
+				{
+					errorMessage = "pins have wrong contents";
+					return false;
+				}
+				if (cache->getStats().pinnedBytes != 6000 || cache->getStats().numPinned != 2)
+				{
+					errorMessage = "pinned bytes are wrong";
+					return false;
+				}
+				if (cache->unload("a"))
+				{
+					errorMessage = "unloaded a pinned sound";
+					return false;
+				}
+
+				//a and b are the oldest, but pinned; c and d go over budget, so c is evicted
+				cache->loadSound("c");
+				cache->loadSound("d");
+				if (!cache->isResident("a") || !cache->isResident("b") || cache->isResident("c") || !cache->isResident("d"))
+				{
+					errorMessage = "eviction did not skip pinned sounds";
+					return false;
+				}
+
+				//d is evicted for e; after that everything left is pinned, so the cache stays over budget rather than evicting
+				SoundBufferPin pinE = cache->pin("e", true);
+				if (!cache->isResident("e") || cache->isResident("d") || cache->getStats().residentBytes != 10000)
+				{
+					errorMessage = "pinned loads over budget were handled wrong";
+					return false;
+				}
+
+				//pins are counted; a second pin on a keeps it pinned after the first is released
+				SoundBufferPin pinA2 = cache->pin("a", true);
+				pinA.release();
+				if (!cache->isResident("a") || cache->getStats().residentBytes != 10000)
+				{
+					errorMessage = "released one of two pins and sound was evicted";
+					return false;
+				}
+
+				//moving a pin doesn't release it
+				SoundBufferPin movedPin = std::move(pinA2);
+				if (pinA2 || !movedPin || !cache->isResident("a"))
+				{
+					errorMessage = "moving a pin released it";
+					return false;
+				}
+
+				//releasing the last pin trims back to budget
+				movedPin.release();
+				if (cache->isResident("a") || cache->getStats().residentBytes != 6000 || cache->getStats().numPinned != 2)
+				{
+					errorMessage = "releasing the last pin did not trim";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// pins that outlive their entry or the cache are inert; no buffer is destroyed twice
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_PinLifetime : public SoundBufferCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Pins outliving entries";
+
+				sp<StubBackendState> state = new_sp<StubBackendState>();
+				sp<SoundBufferCache> cache = makeCache(state, 6000);
+
+				SoundBufferPin stalePin = cache->pin("a", true);
+				cache->unloadAll();
+				if (!state->liveBuffers.empty() || cache->getStats().residentBytes != 0 || cache->getStats().pinnedBytes != 0)
+				{
+					errorMessage = "unloadAll left resources";
+					return false;
+				}
+
+				//the reloaded sound is a new entry; the stale pin must not unpin it
+				SoundBufferPin freshPin = cache->pin("a", true);
+				stalePin.release();
+				if (cache->getStats().numPinned != 1)
+				{
+					errorMessage = "stale pin unpinned a reloaded sound";
+					return false;
+				}
+
+				cache = nullptr;
+				freshPin.release();
+				if (!state->liveBuffers.empty() || state->numDestroyedUnknownBuffers != 0)
+				{
+					errorMessage = "buffers leaked or destroyed twice";
+					return false;
+				}
+
+				//sounds decoded elsewhere are adopted, unless the path is already cached
+				cache = makeCache(state, 6000);
+				up<SoundRawData> asyncDecoded = new_up<SoundRawData>();
+				asyncDecoded->pcmData.resize(500);
+				sp<SoundRawData> inserted = cache->insert("async", std::move(asyncDecoded));
+				up<SoundRawData> duplicate = new_up<SoundRawData>();
+				if (!inserted || cache->insert("async", std::move(duplicate)) != inserted || cache->getStats().residentBytes != 1000)
+				{
+					errorMessage = "insert did not keep the first sound";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SoundBufferCacheTestSuite : public SA::TestSuite
+		{
+		public:
+			SoundBufferCacheTestSuite()
+			{
+				testName = "SOUND BUFFER CACHE TEST SUITE";
+
+				addTest(new_sp<Test_LruEviction>());
+				addTest(new_sp<Test_ByteAccounting>());
+				addTest(new_sp<Test_Pinning>());
+				addTest(new_sp<Test_PinLifetime>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSoundBufferCacheTestSuite()
+	{
+		return new_sp<SA::SoundBufferCacheTests::SoundBufferCacheTestSuite>();
+	}
+}
@@ -0,0 +1,480 @@
+#include "EngineTestSuite.h"
+#include "..\..\..\Algorithms\SpatialHashing\SpatialHashingComponent.h"
+#include "../Game/GameSystems/SAProjectileCollision.h"
+
+#include <random>
+#include <algorithm>
+#include <utility>
+
+namespace SA
+{
+	namespace SpatialHashingTests
+	{
+		class SpatialHash_UnitTest : public SA::UnitTest
+		{
+		public:
+			SpatialHash_UnitTest()
+			{
+				testNamespace = "SpatialHash:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct TestBox
+		{
+			SH::Transform transform;
+			std::unique_ptr<SH::HashEntry<TestBox>> entry;
+
+			std::array<glm::vec4, 8> getOBB()
+			{
+				glm::mat4 model = transform.getModelMatrix();
+				std::array<glm::vec4, 8> OBB;
+				for (size_t idx = 0; idx < OBB.size(); ++idx)
+				{
+					OBB[idx] = model * SH::AABB[idx];
+				}
+				return OBB;
+			}
+		};
+
+		using BoxPair = std::pair<TestBox*, TestBox*>;
+
+		static BoxPair makeOrderedPair(TestBox* a, TestBox* b)
+		{
+			return a < b ? BoxPair{ a, b } : BoxPair{ b, a };
+		}
+
+		static bool rangesOverlap(const SH::Range<int>& a, const SH::Range<int>& b)
+		{
+			//ranges are [min, max); empty ranges occupy no cells
+			return a.min < a.max && b.min < b.max && a.min < b.max && b.min < a.max;
+		}
+
+		/** O(n^2) reference: two boxes are a pair if their cell ranges intersect on every axis */
+		static void bruteForcePairs(std::vector<TestBox>& boxes, std::vector<BoxPair>& outPairs)
+		{
+			outPairs.clear();
+			for (size_t a = 0; a < boxes.size(); ++a)
+			{
+				for (size_t b = a + 1; b < boxes.size(); ++b)
+				{
+					SH::HashEntry<TestBox>& entryA = *boxes[a].entry;
+					SH::HashEntry<TestBox>& entryB = *boxes[b].entry;
+					if (rangesOverlap(entryA.getXGridCells(), entryB.getXGridCells())
+						&& rangesOverlap(entryA.getYGridCells(), entryB.getYGridCells())
+						&& rangesOverlap(entryA.getZGridCells(), entryB.getZGridCells()))
+					{
+						outPairs.push_back(makeOrderedPair(&boxes[a], &boxes[b]));
+					}
+				}
+			}
+			std::sort(outPairs.begin(), outPairs.end());
+		}
+
+		static void scatterBoxes(std::vector<TestBox>& boxes, std::mt19937& rng, float halfExtent, float minScale, float maxScale)
+		{
+			std::uniform_real_distribution<float> posDist(-halfExtent, halfExtent);
+			std::uniform_real_distribution<float> scaleDist(minScale, maxScale);
+			std::uniform_real_distribution<float> angleDist(0.f, 3.14f);
+			for (TestBox& box : boxes)
+			{
+				box.transform.position = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+				box.transform.scale = glm::vec3(scaleDist(rng), scaleDist(rng), scaleDist(rng));
+				box.transform.rotQuat = glm::angleAxis(angleDist(rng), glm::normalize(glm::vec3(posDist(rng), posDist(rng), posDist(rng)) + glm::vec3(0.01f)));
+			}
+		}
+
+		/** returns empty string on success, otherwise the failure reason */
+		static std::string comparePairsToBruteForce(SH::SpatialHashGrid<TestBox>& grid, std::vector<TestBox>& boxes, std::vector<BoxPair>& gridPairs)
+		{
+			grid.findAllOverlappingPairs(gridPairs);
+
+			std::vector<BoxPair> normalized;
+			for (BoxPair& pair : gridPairs)
+			{
+				if (pair.first == pair.second)
+				{
+					return "pair contained the same entity twice";
+				}
+				normalized.push_back(makeOrderedPair(pair.first, pair.second));
+			}
+			std::sort(normalized.begin(), normalized.end());
+			if (std::adjacent_find(normalized.begin(), normalized.end()) != normalized.end())
+			{
+				return "pair was reported more than once";
+			}
+
+			std::vector<BoxPair> expected;
+			bruteForcePairs(boxes, expected);
+			if (normalized != expected)
+			{
+				return "pairs did not match brute force; found " + std::to_string(normalized.size()) + " expected " + std::to_string(expected.size());
+			}
+			return "";
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// broadphase pairs match brute force
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_OverlappingPairsMatchBruteForce : public SpatialHash_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Overlapping pairs match brute force";
+
+				//grid must outlive the entries owned by the boxes
+				SH::SpatialHashGrid<TestBox> grid{ glm::vec3(4.f) };
+				std::mt19937 rng(1337);
+				std::vector<TestBox> boxes(400);
+				scatterBoxes(boxes, rng, 40.f, 0.5f, 6.f);
+
+				//a few large boxes that span many cells; these are the ones that used to return duplicate neighbors
+				std::uniform_real_distribution<float> bigScaleDist(15.f, 30.f);
+				for (size_t idx = 0; idx < 10; ++idx)
+				{
+					boxes[idx].transform.scale = glm::vec3(bigScaleDist(rng), bigScaleDist(rng), bigScaleDist(rng));
+				}
+
+				for (TestBox& box : boxes)
+				{
+					box.entry = grid.insert(box, box.getOBB());
+				}
+
+				std::vector<BoxPair> gridPairs;
+				errorMessage = comparePairsToBruteForce(grid, boxes, gridPairs);
+				return errorMessage.empty();
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// pairs stay correct after entries are moved with updateEntry and removed
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_OverlappingPairsAfterUpdate : public SpatialHash_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Overlapping pairs after updateEntry and removal";
+
+				//grid must outlive the entries owned by the boxes
+				SH::SpatialHashGrid<TestBox> grid{ glm::vec3(3.f, 2.f, 5.f) };
+				std::mt19937 rng(42);
+				std::vector<TestBox> boxes(250);
+				scatterBoxes(boxes, rng, 20.f, 0.5f, 5.f);
+
+				for (TestBox& box : boxes)
+				{
+					box.entry = grid.insert(box, box.getOBB());
+				}
+
+				std::vector<BoxPair> gridPairs;
+				std::uniform_real_distribution<float> stepDist(-3.f, 3.f);
+				for (int frame = 0; frame < 10; ++frame)
+				{
+					for (TestBox& box : boxes)
+					{
+						box.transform.position += glm::vec3(stepDist(rng), stepDist(rng), stepDist(rng));
+						grid.updateEntry(box.entry, box.getOBB());
+					}
+
+					errorMessage = comparePairsToBruteForce(grid, boxes, gridPairs);
+					if (!errorMessage.empty())
+					{
+						errorMessage = "frame " + std::to_string(frame) + ": " + errorMessage;
+						return false;
+					}
+				}
+
+				//drop half of the entries and make sure they no longer show up
+				boxes.resize(boxes.size() / 2);
+				errorMessage = comparePairsToBruteForce(grid, boxes, gridPairs);
+				return errorMessage.empty();
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// reusing the output buffer does not reallocate
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_OverlappingPairsReuseBuffer : public SpatialHash_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Overlapping pairs reuse output buffer";
+
+				//grid must outlive the entries owned by the boxes
+				SH::SpatialHashGrid<TestBox> grid{ glm::vec3(2.f) };
+				std::mt19937 rng(7);
+				std::vector<TestBox> boxes(200);
+				scatterBoxes(boxes, rng, 15.f, 1.f, 4.f);
+
+				for (TestBox& box : boxes)
+				{
+					box.entry = grid.insert(box, box.getOBB());
+				}
+
+				std::vector<BoxPair> gridPairs;
+				grid.findAllOverlappingPairs(gridPairs);
+				const BoxPair* firstQueryBuffer = gridPairs.data();
+				size_t firstQuerySize = gridPairs.size();
+
+				for (int query = 0; query < 5; ++query)
+				{
+					grid.findAllOverlappingPairs(gridPairs);
+					if (gridPairs.data() != firstQueryBuffer || gridPairs.size() != firstQuerySize)
+					{
+						errorMessage = "repeated query on unchanged grid reallocated or changed results";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// batched line query finds the same elements as one lookupCellsForLine per segment
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BatchedLineQueryMatchesPerLine : public SpatialHash_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Batched line query matches per-line lookup";
+
+				//grid must outlive the entries owned by the boxes
+				SH::SpatialHashGrid<TestBox> grid{ glm::vec3(4.f) };
+				std::mt19937 rng(2024);
+				std::vector<TestBox> boxes(300);
+				scatterBoxes(boxes, rng, 40.f, 0.5f, 8.f);
+				for (TestBox& box : boxes)
+				{
+					box.entry = grid.insert(box, box.getOBB());
+				}
+
+				//short segments like projectile steps, plus some long ones that cross many cells; many share cells with each other
+				std::uniform_real_distribution<float> posDist(-45.f, 45.f);
+				std::uniform_real_distribution<float> offsetDist(-3.f, 3.f);
+				std::vector<SH::LineSegment> segments(500);
+				for (size_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx)
+				{
+					SH::LineSegment& segment = segments[segmentIdx];
+					segment.start = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+					segment.end = (segmentIdx % 10 == 0) ? glm::vec3(posDist(rng), posDist(rng), posDist(rng)) : segment.start + glm::vec3(offsetDist(rng), offsetDist(rng), offsetDist(rng));
+				}
+				segments[1].end = segments[1].start; //degenerate segment still touches its cell
+
+				std::vector<SH::LineSegmentCandidate<TestBox>> candidates;
+				for (int query = 0; query < 2; ++query) //second query runs on warmed up scratch buffers
+				{
+					grid.lookupNodesForLines(segments, candidates);
+
+					std::vector<std::pair<uint32_t, TestBox*>> batched;
+					for (const SH::LineSegmentCandidate<TestBox>& candidate : candidates)
+					{
+						batched.push_back({ candidate.segmentIdx, candidate.element });
+					}
+					if (!std::is_sorted(candidates.begin(), candidates.end(),
+						[](const SH::LineSegmentCandidate<TestBox>& a, const SH::LineSegmentCandidate<TestBox>& b)
+						{ return std::less<TestBox*>()(a.element, b.element); }))
+					{
+						errorMessage = "candidates were not grouped by element";
+						return false;
+					}
+					std::sort(batched.begin(), batched.end());
+					if (std::adjacent_find(batched.begin(), batched.end()) != batched.end())
+					{
+						errorMessage = "element reported more than once for the same segment";
+						return false;
+					}
+
+					std::vector<std::pair<uint32_t, TestBox*>> expected;
+					std::vector<std::shared_ptr<const SH::HashCell<TestBox>>> cells;
+					for (uint32_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx)
+					{
+						cells.clear();
+						grid.lookupCellsForLine(segments[segmentIdx].start, segments[segmentIdx].end, cells);
+						for (const std::shared_ptr<const SH::HashCell<TestBox>>& cell : cells)
+						{
+							for (const std::shared_ptr<SH::GridNode<TestBox>>& node : cell->nodeBucket)
+							{
+								expected.push_back({ segmentIdx, &node->element });
+							}
+						}
+					}
+					std::sort(expected.begin(), expected.end());
+					expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+					if (batched != expected)
+					{
+						errorMessage = "batched candidates did not match per-line lookup; found " + std::to_string(batched.size()) + " expected " + std::to_string(expected.size());
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// batched projectile collision reports the same closest hits as one lookup per projectile
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct TestTarget
+		{
+			SH::Transform transform;
+			up<CollisionData> collision;
+			std::unique_ptr<SH::HashEntry<TestTarget>> entry;
+		};
+
+		/** configures a target like a ship: an OBB pretest shape and two half-width cube shapes side by side */
+		static void configureTarget(TestTarget& target, SH::SpatialHashGrid<TestTarget>& grid, bool bWithCollision)
+		{
+			glm::mat4 model = target.transform.getModelMatrix();
+			if (bWithCollision)
+			{
+				target.collision = new_up<CollisionData>();
+				target.collision->getOBBShape()->updateTransform(model);
+				for (float xOffset : { -0.25f, 0.25f })
+				{
+					CollisionData::ShapeData shapeData;
+					shapeData.localXform = glm::scale(glm::translate(glm::mat4(1.f), glm::vec3(xOffset, 0.f, 0.f)), glm::vec3(0.5f, 1.f, 1.f));
+					shapeData.shape = new_sp<SAT::CubeShape>();
+					shapeData.shape->updateTransform(model * shapeData.localXform);
+					shapeData.shapeType = ECollisionShape::CUBE;
+					target.collision->addNewCollisionShape(shapeData);
+				}
+			}
+
+			std::array<glm::vec4, 8> OBB;
+			for (size_t idx = 0; idx < OBB.size(); ++idx)
+			{
+				OBB[idx] = model * SH::AABB[idx];
+			}
+			target.entry = grid.insert(target, OBB);
+		}
+
+		/** collision box stretched over the segment, like a projectile's collisionXform */
+		static glm::mat4 makeProjectileXform(const SH::LineSegment& segment)
+		{
+			glm::vec3 toEnd = segment.end - segment.start;
+			float length = glm::length(toEnd);
+			glm::vec3 up = glm::abs(toEnd.y / length) > 0.99f ? glm::vec3(1.f, 0.f, 0.f) : glm::vec3(0.f, 1.f, 0.f);
+			glm::mat4 lookXform = glm::inverse(glm::lookAt(segment.start + toEnd * 0.5f, segment.end, up));
+			return glm::scale(lookXform, glm::vec3(0.3f, 0.3f, length));
+		}
+
+		class Test_BatchedProjectileHitsMatchPerProjectile : public SpatialHash_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Batched projectile hits match per-projectile search";
+
+				//grid must outlive the entries owned by the targets
+				SH::SpatialHashGrid<TestTarget> grid{ glm::vec3(4.f) };
+				std::vector<up<TestTarget>> targets;
+
+				//a row of targets down -z; a projectile fired along it must hit the nearest one that isn't its owner
+				for (float z : { -10.f, -20.f, -30.f })
+				{
+					targets.push_back(new_up<TestTarget>());
+					targets.back()->transform.position = glm::vec3(0.f, 0.f, z);
+					targets.back()->transform.scale = glm::vec3(3.f);
+					targets.back()->transform.rotQuat = glm::quat(1.f, 0.f, 0.f, 0.f);
+				}
+
+				//scattered targets kept off the row; some have no collision and must be skipped
+				std::mt19937 rng(7);
+				std::uniform_real_distribution<float> rowFreePosDist(6.f, 40.f);
+				std::uniform_real_distribution<float> posDist(-40.f, 40.f);
+				std::uniform_real_distribution<float> scaleDist(1.f, 6.f);
+				std::uniform_real_distribution<float> angleDist(0.f, 3.14f);
+				for (size_t targetIdx = 0; targetIdx < 80; ++targetIdx)
+				{
+					targets.push_back(new_up<TestTarget>());
+					SH::Transform& transform = targets.back()->transform;
+					transform.position = glm::vec3(rowFreePosDist(rng), posDist(rng), posDist(rng));
+					transform.scale = glm::vec3(scaleDist(rng), scaleDist(rng), scaleDist(rng));
+					transform.rotQuat = glm::angleAxis(angleDist(rng), glm::normalize(glm::vec3(posDist(rng), posDist(rng), posDist(rng)) + glm::vec3(0.01f)));
+				}
+				for (size_t targetIdx = 0; targetIdx < targets.size(); ++targetIdx)
+				{
+					configureTarget(*targets[targetIdx], grid, targetIdx % 7 != 6);
+				}
+
+				std::vector<SH::LineSegment> segments;
+				std::vector<const TestTarget*> owners;
+				segments.push_back({ glm::vec3(0.f), glm::vec3(0.f, 0.f, -35.f) });			owners.push_back(nullptr);
+				segments.push_back({ glm::vec3(0.f), glm::vec3(0.f, 0.f, -35.f) });			owners.push_back(targets[0].get());
+				segments.push_back({ glm::vec3(100.f), glm::vec3(100.f, 100.f, 90.f) });	owners.push_back(nullptr);
+
+				//projectile sized steps plus some long shots; owners are sometimes a target the shot may pass through
+				std::uniform_real_distribution<float> stepDist(-8.f, 8.f);
+				std::uniform_int_distribution<size_t> ownerDist(0, targets.size() - 1);
+				for (size_t segmentIdx = 0; segmentIdx < 400; ++segmentIdx)
+				{
+					SH::LineSegment segment;
+					segment.start = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+					segment.end = (segmentIdx % 10 == 0) ? glm::vec3(posDist(rng), posDist(rng), posDist(rng)) : segment.start + glm::vec3(stepDist(rng), stepDist(rng), stepDist(rng));
+					if (glm::length2(segment.end - segment.start) < 0.01f) { continue; }
+					segments.push_back(segment);
+					owners.push_back(segmentIdx % 4 == 0 ? targets[ownerDist(rng)].get() : nullptr);
+				}
+
+				std::vector<up<SAT::CubeShape>> projectileShapes;
+				std::vector<ProjectileCollisionQuery<TestTarget>> expected(segments.size());
+				for (size_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx)
+				{
+					projectileShapes.push_back(new_up<SAT::CubeShape>());
+					projectileShapes.back()->updateTransform(makeProjectileXform(segments[segmentIdx]));
+					expected[segmentIdx].projectileShape = projectileShapes.back().get();
+					expected[segmentIdx].owner = owners[segmentIdx];
+				}
+				std::vector<ProjectileCollisionQuery<TestTarget>> batched = expected;
+
+				auto getCollisionData = [](TestTarget& target) -> const CollisionData* { return target.collision.get(); };
+				for (size_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx)
+				{
+					ProjectileCollision::findClosestHit(grid, segments[segmentIdx], expected[segmentIdx], getCollisionData);
+				}
+				std::vector<SH::LineSegmentCandidate<TestTarget>> candidates;
+				ProjectileCollision::findClosestHits(grid, segments, batched, candidates, getCollisionData);
+
+				if (expected[0].closestEntity != targets[0].get() || expected[1].closestEntity != targets[1].get() || expected[2].closestEntity != nullptr)
+				{
+					errorMessage = "per-projectile search did not find the expected hits on the row of targets";
+					return false;
+				}
+				for (size_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx)
+				{
+					if (batched[segmentIdx].closestEntity != expected[segmentIdx].closestEntity
+						|| batched[segmentIdx].closestDistance_2 != expected[segmentIdx].closestDistance_2)
+					{
+						errorMessage = "batched hit differs from per-projectile hit for segment " + std::to_string(segmentIdx);
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SpatialHashTestSuite : public SA::TestSuite
+		{
+		public:
+			SpatialHashTestSuite()
+			{
+				testName = "SPATIAL HASH TEST SUITE";
+
+				addTest(new_sp<Test_OverlappingPairsMatchBruteForce>());
+				addTest(new_sp<Test_OverlappingPairsAfterUpdate>());
+				addTest(new_sp<Test_OverlappingPairsReuseBuffer>());
+				addTest(new_sp<Test_BatchedLineQueryMatchesPerLine>());
+				addTest(new_sp<Test_BatchedProjectileHitsMatchPerProjectile>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSpatialHashTestSuite()
+	{
+		return new_sp<SA::SpatialHashingTests::SpatialHashTestSuite>();
+	}
+}
@@ -0,0 +1,314 @@
+#include "EngineTestSuite.h"
+#include "../Game/Levels/StressTestBenchmark.h"
+#include "../GameFramework/SATickProfiler.h"
+#include "../GameFramework/SARandomNumberGenerationSystem.h"
+#include "../Rendering/SAWindow.h"
+#include <thread>
+#include "../../../../Libraries/nlohmann/json.hpp"
+
+namespace SA
+{
+	namespace StressTestBenchmarkTests
+	{
+		class StressTestBenchmark_UnitTest : public SA::UnitTest
+		{
+		public:
+			StressTestBenchmark_UnitTest()
+			{
+				testNamespace = "StressTestBenchmark:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		static StressTestScenario makeSmallScenario()
+		{
+			StressTestScenario scenario;
+			scenario.name = "unit test";
+			scenario.numShips = 60;
+			scenario.durationSec = 3.f;
+			scenario.teamSeparation = 30.f;
+			scenario.spawnSpread = 10.f;
+			scenario.shipBrain = "continuousFire";
+			scenario.projectilesPerShipPerSec = 4.f;
+			return scenario;
+		}
+
+		/** Makes a profiler active for the enclosing block, restoring whatever was active before (eg a running benchmark's). */
+		struct ScopedActiveProfiler
+		{
+			ScopedActiveProfiler(TickProfiler& profiler) : previous(TickProfiler::getActive()) { TickProfiler::setActive(&profiler); }
+			~ScopedActiveProfiler() { TickProfiler::setActive(previous); }
+			TickProfiler* previous;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// scenarios survive a round trip through json; missing fields keep their defaults
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ScenarioJson : public StressTestBenchmark_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Scenario json";
+
+				StressTestScenario written = makeSmallScenario();
+				written.numTeams = 3;
+				written.seed = 1234;
+				written.fixedDeltaSec = 1.f / 30.f;
+				written.bSpawnCarriers = false;
+				written.numWorkerThreads = 3;
+				written.bDeterministicJobs = false;
+
+				StressTestScenario read;
+				if (!read.fromJson(written.toJson()))
+				{
+					errorMessage = "failed to read written scenario";
+					return false;
+				}
+				if (read.toJson() != written.toJson() || read.getNumFrames() != 90)
+				{
+					errorMessage = "scenario changed in round trip";
+					return false;
+				}
+
+				StressTestScenario partial;
+				const StressTestScenario defaults;
+				if (!partial.fromJson(R"({ "numShips": 7, "durationSec": 2.5 })")
+					|| partial.numShips != 7 || partial.durationSec != 2.5f || partial.seed != defaults.seed || partial.numTeams != defaults.numTeams
+					|| partial.shipBrain != defaults.shipBrain || partial.numWorkerThreads != defaults.numWorkerThreads || partial.bDeterministicJobs != defaults.bDeterministicJobs)
+				{
+					errorMessage = "partial scenario not merged with defaults";
+					return false;
+				}
+
+				if (partial.fromJson("not json") || partial.fromJson("[1, 2]"))
+				{
+					errorMessage = "accepted a scenario that is not a json object";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// percentiles are nearest rank and the report lists them per phase
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Report : public StressTestBenchmark_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Report";
+
+				StressTestPhaseTiming known;
+				for (int value = 100; value >= 1; --value) { known.frameMs.push_back(double(value)); }
+				if (known.percentile(0.5) != 50.0 || known.percentile(0.99) != 99.0 || known.percentile(1.0) != 100.0 || known.percentile(0.0) != 1.0 || known.mean() != 50.5)
+				{
+					errorMessage = "percentiles are not nearest rank";
+					return false;
+				}
+
+				StressTestReport report;
+				report.scenarioName = "unit test";
+				report.numFrames = 100;
+				report.peakProjectiles = 12;
+				report.shipsAtEnd = 60;
+				report.projectilesAtEnd = 9;
+				report.endStateHash = 0xF00DFACE12345678ull;
+				report.phases.push_back(known);
+				report.phases[0].name = "Frame";
+
+				const nlohmann::json parsed = nlohmann::json::parse(report.toJson(), nullptr, false);
+				if (parsed.is_discarded() || parsed["numFrames"] != report.numFrames || parsed["phases"].size() != report.phases.size()
+					|| parsed["phases"][0]["name"] != "Frame" || parsed["phases"][0]["p99_ms"] != 99.0
+					|| parsed["results"]["peakProjectiles"] != report.peakProjectiles || parsed["results"]["shipsAtEnd"] != report.shipsAtEnd
+					|| parsed["results"]["projectilesAtEnd"] != report.projectilesAtEnd || parsed["results"]["endStateHash"] != report.endStateHash)
+				{
+					errorMessage = "report json missing fields";
+					return false;
+				}
+				if (report.findPhase("Frame") != &report.phases[0] || report.findPhase("missing") != nullptr)
+				{
+					errorMessage = "findPhase did not match by name";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the repeat check: end states read back from report json are compared exactly; a different seed gives different ai rolls
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Repeatability : public StressTestBenchmark_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Repeatability";
+
+				StressTestReport report;
+				report.scenarioName = "unit test";
+				report.numFrames = 180;
+				report.peakProjectiles = 40;
+				report.shipsAtEnd = 58;
+				report.projectilesAtEnd = 11;
+				report.endStateHash = 0xFFFFFFFFFFFFFFF1ull; //above what a double holds exactly
+
+				StressTestReport readBack;
+				if (!readBack.readResultsJson(report.toJson()) || !readBack.sameEndState(report))
+				{
+					errorMessage = "end state changed in round trip";
+					return false;
+				}
+
+				StressTestReport diverged = readBack;
+				diverged.endStateHash ^= 1;
+				if (diverged.sameEndState(report) || readBack.readResultsJson(R"({ "scenario": "unit test" })"))
+				{
+					errorMessage = "different end state or partial report accepted";
+					return false;
+				}
+
+				//ships and behavior tree nodes draw from time influenced rngs; reseeding must make those repeat
+				sp<RNGSystem> rngA = new_sp<RNGSystem>();
+				sp<RNGSystem> rngB = new_sp<RNGSystem>();
+				rngA->reseed(1234);
+				rngB->reseed(1234);
+				for (size_t draw = 0; draw < 16; ++draw)
+				{
+					if (rngA->getTimeInfluencedRNG()->getInt<uint32_t>() != rngB->getTimeInfluencedRNG()->getInt<uint32_t>()
+						|| rngA->getNamedRNG("unit test")->getInt<uint32_t>() != rngB->getNamedRNG("unit test")->getInt<uint32_t>())
+					{
+						errorMessage = "same seed gave different generators";
+						return false;
+					}
+				}
+
+				rngB->reseed(4321);
+				rngA->reseed(1234);
+				if (rngA->getTimeInfluencedRNG()->getInt<uint32_t>() == rngB->getTimeInfluencedRNG()->getInt<uint32_t>())
+				{
+					errorMessage = "different seeds gave the same generator";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the profiler behind the report: one sample per label per frame, late labels backfilled with zeros, threads merged
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_TickProfiler : public StressTestBenchmark_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Tick profiler";
+
+				const TickProfiler::LabelId labelA = TickProfiler::internLabel("unit test A");
+				const TickProfiler::LabelId labelB = TickProfiler::internLabel("unit test B");
+				const TickProfiler::LabelId labelC = TickProfiler::internLabel("unit test C");
+				if (TickProfiler::internLabel("unit test A") != labelA || labelA == labelB)
+				{
+					errorMessage = "labels not interned by text";
+					return false;
+				}
+
+				TickProfiler profiler;
+				{
+					ScopedActiveProfiler activeProfiler(profiler);
+
+					{ TickProfiler::Scope scope(labelA); }
+					profiler.endFrame();
+
+					//a label hit twice in one frame, and a label first seen on the second frame, partly from another thread
+					{ TickProfiler::Scope scope(labelA); }
+					{ TickProfiler::Scope scope(labelA); }
+					profiler.record(labelB, 2.0);
+					std::thread worker([&profiler, labelB]() { profiler.record(labelB, 3.0); });
+					worker.join();
+					profiler.endFrame();
+
+					profiler.endFrame();
+				}
+
+				//scopes opened while the profiler is not active record nothing
+				{ TickProfiler::Scope scope(labelC); }
+
+				const std::vector<TickProfiler::Timing>& timings = profiler.getTimings();
+				if (profiler.getNumFrames() != 3 || timings.size() != 2 || timings[0].label != "unit test A" || timings[1].label != "unit test B")
+				{
+					errorMessage = "unexpected frames or labels";
+					return false;
+				}
+				for (const TickProfiler::Timing& timing : timings)
+				{
+					if (timing.frameMs.size() != profiler.getNumFrames())
+					{
+						errorMessage = "label missing samples";
+						return false;
+					}
+				}
+				if (timings[1].frameMs[0] != 0.0 || timings[1].frameMs[1] != 5.0 || timings[1].frameMs[2] != 0.0 || timings[0].frameMs[2] != 0.0)
+				{
+					errorMessage = "samples not summed per frame";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// the benchmark's window is a null backend; it answers window queries without a glfw window
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_HeadlessWindow : public StressTestBenchmark_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Headless window";
+
+				//gl is already loaded by the game's window, so this does not swap in the null gl functions
+				sp<Window> headless = new_sp<Window>(320, 180, /*bHeadless*/ true);
+				if (headless->get() != nullptr || !headless->isHeadless())
+				{
+					errorMessage = "headless window created a glfw window";
+					return false;
+				}
+				if (headless->getFramebufferSize() != std::make_pair(320, 180) || headless->getAspect() != 320.f / 180.f)
+				{
+					errorMessage = "headless window size wrong";
+					return false;
+				}
+
+				headless->markWindowForClose(true);
+				if (!headless->shouldClose())
+				{
+					errorMessage = "headless window did not keep the close request";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class StressTestBenchmarkTestSuite : public SA::TestSuite
+		{
+		public:
+			StressTestBenchmarkTestSuite()
+			{
+				testName = "STRESS TEST BENCHMARK TEST SUITE";
+
+				addTest(new_sp<Test_ScenarioJson>());
+				addTest(new_sp<Test_Report>());
+				addTest(new_sp<Test_Repeatability>());
+				addTest(new_sp<Test_TickProfiler>());
+				addTest(new_sp<Test_HeadlessWindow>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getStressTestBenchmarkTestSuite()
+	{
+		return new_sp<SA::StressTestBenchmarkTests::StressTestBenchmarkTestSuite>();
+	}
+}
@@ -0,0 +1,316 @@
+#include "EngineTestSuite.h"
+#include "../Tools/DataStructures/TeamTargetIndex.h"
+
+#include <random>
+#include <algorithm>
+
+namespace SA
+{
+	namespace TeamTargetIndexTests
+	{
+		class TeamTargetIndex_UnitTest : public SA::UnitTest
+		{
+		public:
+			TeamTargetIndex_UnitTest()
+			{
+				testNamespace = "TeamTargetIndex:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct TestTarget
+		{
+			int id = -1;
+			glm::vec3 position{ 0.f };
+			size_t team = 0;
+			uint8_t flags = TargetFlags::NONE;
+		};
+		using TestIndex = TeamTargetIndex<TestTarget>;
+		using TestResult = TestIndex::Result;
+
+		/** Two clustered teams plus a scattered third team; roughly half the targets are attackable and a few are carriers. */
+		static std::vector<TestTarget> makeTargets(size_t count, uint32_t seed)
+		{
+			std::mt19937 rng(seed);
+			std::uniform_real_distribution<float> spread(-50.f, 50.f);
+			std::uniform_int_distribution<int> teamRoll(0, 2);
+			std::uniform_int_distribution<int> flagRoll(0, 9);
+
+			std::vector<TestTarget> targets(count);
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				TestTarget& target = targets[idx];
+				target.id = int(idx);
+				target.team = size_t(teamRoll(rng));
+				const glm::vec3 center = target.team == 0 ? glm::vec3(0.f, 0.f, -150.f) : target.team == 1 ? glm::vec3(0.f, 0.f, 150.f) : glm::vec3(0.f);
+				const float scale = target.team == 2 ? 4.f : 1.f;
+				target.position = center + scale * glm::vec3(spread(rng), spread(rng), spread(rng));
+
+				const int roll = flagRoll(rng);
+				target.flags = (roll < 5 ? TargetFlags::ATTACKABLE : TargetFlags::NONE) | (roll == 0 || roll == 9 ? TargetFlags::CARRIER : TargetFlags::NONE);
+			}
+			return targets;
+		}
+
+		static void fillIndex(TestIndex& index, std::vector<TestTarget>& targets)
+		{
+			index.clear();
+			for (TestTarget& target : targets)
+			{
+				index.add(target, target.position, target.team, target.flags);
+			}
+			index.build();
+		}
+
+		/** Every matching enemy, closest first, found by walking all targets. */
+		static std::vector<TestResult> bruteForce(std::vector<TestTarget>& targets, const glm::vec3& origin, size_t searcherTeam, uint8_t requiredFlags, float maxDistance)
+		{
+			std::vector<TestResult> results;
+			for (TestTarget& target : targets)
+			{
+				const float distance2 = glm::length2(target.position - origin);
+				if (target.team != searcherTeam && (target.flags & requiredFlags) == requiredFlags && distance2 <= maxDistance * maxDistance)
+				{
+					results.push_back(TestResult{ &target, distance2, uint32_t(target.id) });
+				}
+			}
+			std::sort(results.begin(), results.end(), &TestIndex::isCloser);
+			return results;
+		}
+
+		static bool sameResults(const std::vector<TestResult>& a, const std::vector<TestResult>& b)
+		{
+			if (a.size() != b.size())
+			{
+				return false;
+			}
+			for (size_t idx = 0; idx < a.size(); ++idx)
+			{
+				if (a[idx].element != b[idx].element || a[idx].distance2 != b[idx].distance2)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// nearest enemy matches a walk over every target, with and without flag filters and distance limits
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_NearestMatchesBruteForce : public TeamTargetIndex_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Nearest matches brute force";
+
+				std::vector<TestTarget> targets = makeTargets(1500, 11);
+				TestIndex index;
+				fillIndex(index, targets);
+
+				const uint8_t flagFilters[] = { TargetFlags::NONE, TargetFlags::ATTACKABLE, TargetFlags::CARRIER, TargetFlags::ATTACKABLE | TargetFlags::CARRIER };
+				const float maxDistances[] = { std::numeric_limits<float>::infinity(), 120.f, 5.f };
+
+				std::mt19937 rng(5);
+				std::uniform_real_distribution<float> queryRange(-250.f, 250.f);
+				for (int query = 0; query < 200; ++query)
+				{
+					const glm::vec3 origin(queryRange(rng), queryRange(rng), queryRange(rng));
+					const size_t searcherTeam = size_t(query % 4); //team 3 has no entries, so every target is an enemy
+					for (uint8_t flags : flagFilters)
+					{
+						for (float maxDistance : maxDistances)
+						{
+							const std::vector<TestResult> expected = bruteForce(targets, origin, searcherTeam, flags, maxDistance);
+
+							float distance2 = -1.f;
+							TestTarget* found = index.findNearestEnemy(origin, searcherTeam, flags, maxDistance, &distance2);
+							TestTarget* expectedTarget = expected.empty() ? nullptr : expected[0].element;
+							if (found != expectedTarget || (found && distance2 != expected[0].distance2))
+							{
+								errorMessage = "nearest enemy differs from brute force on query " + std::to_string(query);
+								return false;
+							}
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// nearest k enemies come back closest first and match a full sort
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_NearestKMatchesBruteForce : public TeamTargetIndex_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Nearest k matches brute force";
+
+				std::vector<TestTarget> targets = makeTargets(800, 23);
+				TestIndex index;
+				fillIndex(index, targets);
+
+				std::mt19937 rng(8);
+				std::uniform_real_distribution<float> queryRange(-200.f, 200.f);
+				std::vector<TestResult> results;
+				const size_t kValues[] = { 1, 7, 32, 5000 };
+				for (int query = 0; query < 50; ++query)
+				{
+					const glm::vec3 origin(queryRange(rng), queryRange(rng), queryRange(rng));
+					const size_t searcherTeam = size_t(query % 3);
+					for (size_t k : kValues)
+					{
+						std::vector<TestResult> expected = bruteForce(targets, origin, searcherTeam, TargetFlags::ATTACKABLE, 150.f);
+						expected.resize(std::min(k, expected.size()));
+
+						index.findNearestEnemies(origin, searcherTeam, k, results, TargetFlags::ATTACKABLE, 150.f);
+						if (!sameResults(results, expected))
+						{
+							errorMessage = "nearest " + std::to_string(k) + " differs from brute force on query " + std::to_string(query);
+							return false;
+						}
+					}
+				}
+
+				index.findNearestEnemies(glm::vec3(0.f), 0, 0, results);
+				if (!results.empty())
+				{
+					errorMessage = "asking for zero results returned some";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// cone queries return exactly the brute force targets inside the cone
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ConeMatchesBruteForce : public TeamTargetIndex_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cone matches brute force";
+
+				std::vector<TestTarget> targets = makeTargets(1000, 31);
+				TestIndex index;
+				fillIndex(index, targets);
+
+				std::mt19937 rng(13);
+				std::uniform_real_distribution<float> queryRange(-200.f, 200.f);
+				std::uniform_real_distribution<float> angleRange(0.05f, 3.f);
+				std::vector<TestResult> results;
+				for (int query = 0; query < 100; ++query)
+				{
+					const glm::vec3 origin(queryRange(rng), queryRange(rng), queryRange(rng));
+					const glm::vec3 forward_n = glm::normalize(glm::vec3(queryRange(rng), queryRange(rng), queryRange(rng)) + glm::vec3(0.f, 0.f, 0.01f));
+					const float halfAngle = angleRange(rng);
+					const float maxDistance = 60.f + float(query);
+					const size_t searcherTeam = size_t(query % 3);
+
+					std::vector<TestResult> expected = bruteForce(targets, origin, searcherTeam, TargetFlags::NONE, maxDistance);
+					const float cosHalfAngle = std::cos(halfAngle);
+					expected.erase(std::remove_if(expected.begin(), expected.end(), [&](const TestResult& result)
+					{
+						return !TestIndex::isInCone(result.element->position - origin, result.distance2, forward_n, cosHalfAngle);
+					}), expected.end());
+
+					index.findEnemiesInCone(origin, forward_n, halfAngle, maxDistance, searcherTeam, results);
+					if (!sameResults(results, expected))
+					{
+						errorMessage = "cone differs from brute force on query " + std::to_string(query);
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// ties go to the target added first, own team is never returned, and rebuilding drops old entries
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_TiesTeamsAndRebuild : public TeamTargetIndex_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Ties, teams and rebuild";
+
+				//several targets stacked on the same spot
+				std::vector<TestTarget> targets(6);
+				for (size_t idx = 0; idx < targets.size(); ++idx)
+				{
+					targets[idx].id = int(idx);
+					targets[idx].team = idx == 0 ? 0 : 1;
+					targets[idx].position = glm::vec3(10.f, 0.f, 0.f);
+				}
+				TestIndex index;
+				fillIndex(index, targets);
+
+				if (index.findNearestEnemy(glm::vec3(0.f), 0) != &targets[1])
+				{
+					errorMessage = "tie not broken by add order";
+					return false;
+				}
+				if (index.findNearestEnemy(glm::vec3(10.f, 0.f, 0.f), 1) != &targets[0])
+				{
+					errorMessage = "searcher found a teammate";
+					return false;
+				}
+				if (index.findNearestEnemy(glm::vec3(0.f), 7) != &targets[0])
+				{
+					errorMessage = "team without entries could not search";
+					return false;
+				}
+
+				std::vector<TestResult> results;
+				index.findNearestEnemies(glm::vec3(0.f), 0, 3, results);
+				if (results.size() != 3 || results[0].element != &targets[1] || results[1].element != &targets[2] || results[2].element != &targets[3])
+				{
+					errorMessage = "nearest k ties not in add order";
+					return false;
+				}
+
+				index.clear();
+				index.add(targets[0], targets[0].position, 0);
+				index.build();
+				if (index.size() != 1 || index.findNearestEnemy(glm::vec3(0.f), 0) != nullptr || index.findNearestEnemy(glm::vec3(0.f), 1) != &targets[0])
+				{
+					errorMessage = "stale entries after rebuilding";
+					return false;
+				}
+
+				TestIndex empty;
+				empty.build();
+				if (empty.findNearestEnemy(glm::vec3(0.f), 0) != nullptr)
+				{
+					errorMessage = "empty index found something";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class TeamTargetIndexTestSuite : public SA::TestSuite
+		{
+		public:
+			TeamTargetIndexTestSuite()
+			{
+				testName = "TEAM TARGET INDEX TEST SUITE";
+
+				addTest(new_sp<Test_NearestMatchesBruteForce>());
+				addTest(new_sp<Test_NearestKMatchesBruteForce>());
+				addTest(new_sp<Test_ConeMatchesBruteForce>());
+				addTest(new_sp<Test_TiesTeamsAndRebuild>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getTeamTargetIndexTestSuite()
+	{
+		return new_sp<SA::TeamTargetIndexTests::TeamTargetIndexTestSuite>();
+	}
+}
@@ -0,0 +1,268 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/TimeManagement/TickDispatcher.h"
+
+#include <functional>
+
+namespace SA
+{
+	namespace TickDispatcherTests
+	{
+		class TickDispatcher_UnitTest : public SA::UnitTest
+		{
+		public:
+			TickDispatcher_UnitTest()
+			{
+				testNamespace = "TickDispatcher:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		///
+		/// Every ticker appends its name to a shared trace so the order of a frame can be compared against the expected order.
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		using Trace = std::vector<std::string>;
+
+		//mirrors TickGroups in TickGroupManager.h; the dispatcher receives groups already sorted by priority
+		static const char* const GROUP_NAMES[] = { "GAME", "PRE_CAMERA", "CAMERA", "POST_CAMERA", "AUDIO" };
+		static const size_t NUM_GROUPS = sizeof(GROUP_NAMES) / sizeof(GROUP_NAMES[0]);
+
+		static void addEngineTickGroups(TickDispatcher& dispatcher)
+		{
+			for (const char* name : GROUP_NAMES)
+			{
+				dispatcher.addTickGroup(name);
+			}
+		}
+
+		struct LegacyTicker : public ITickable
+		{
+			LegacyTicker(Trace& trace, const std::string& name) : trace(trace), name(name) {}
+			virtual bool tick(float dt_sec) override
+			{
+				trace.push_back(name);
+				return true;
+			}
+			Trace& trace;
+			std::string name;
+		};
+
+		struct DelegateTicker : public GameEntity
+		{
+			DelegateTicker(Trace& trace, const std::string& name) : trace(trace), name(name) {}
+			void tick(float dt_sec) { trace.push_back(name); }
+			Trace& trace;
+			std::string name;
+		};
+
+		struct ShipLike final : public GameEntity
+		{
+			ShipLike(Trace& trace, const std::string& name) : trace(trace), name(name) {}
+			bool tick(float dt_sec)
+			{
+				trace.push_back(name);
+				if (onTick) { onTick(); }
+				return ticksLeft < 0 || --ticksLeft > 0;
+			}
+			void tickLate(float dt_sec) { trace.push_back(name + ".late"); }
+
+			Trace& trace;
+			std::string name;
+			int ticksLeft = -1; //negative ticks forever
+			std::function<void()> onTick;
+		};
+
+		struct ParticleLike final : public GameEntity
+		{
+			ParticleLike(Trace& trace, const std::string& name) : trace(trace), name(name) {}
+			void tick(float dt_sec) { trace.push_back(name); }
+			Trace& trace;
+			std::string name;
+		};
+
+		static std::string describe(const Trace& trace)
+		{
+			std::string result;
+			for (const std::string& entry : trace) { result += entry + " "; }
+			return result;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// ITickables, then groups in priority order; typed batches then events within a group
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_OrderMatchesTickGroups : public TickDispatcher_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Order matches tick groups";
+
+				Trace trace;
+				TickDispatcher dispatcher;
+				addEngineTickGroups(dispatcher);
+
+				//register groups back to front and interleave types, so the order below comes from the dispatcher and not registration
+				for (size_t groupIdx = NUM_GROUPS; groupIdx-- > 0;)
+				{
+					const std::string group = GROUP_NAMES[groupIdx];
+
+					sp<DelegateTicker> event = new_sp<DelegateTicker>(trace, group + ":event");
+					dispatcher.getEvent(groupIdx).addStrongObj(event, &DelegateTicker::tick);
+
+					for (int idx = 0; idx < 2; ++idx)
+					{
+						dispatcher.registerTypedTicker<&ParticleLike::tick>(groupIdx, new_sp<ParticleLike>(trace, group + ":particle" + std::to_string(idx)));
+						dispatcher.registerTypedTicker<&ShipLike::tick>(groupIdx, new_sp<ShipLike>(trace, group + ":ship" + std::to_string(idx)));
+					}
+				}
+				dispatcher.registerTicker(new_sp<LegacyTicker>(trace, "tickable"));
+				dispatcher.registerTicker(new_sp<LegacyTicker>(trace, "tickable"));
+
+				Trace expected = { "tickable", "tickable" };
+				for (const char* group : GROUP_NAMES)
+				{
+					for (const char* entry : { ":particle0", ":particle1", ":ship0", ":ship1", ":event" })
+					{
+						expected.push_back(std::string(group) + entry);
+					}
+				}
+
+				for (int frame = 0; frame < 3; ++frame)
+				{
+					trace.clear();
+					dispatcher.tick(0.016f);
+					if (trace != expected)
+					{
+						errorMessage = "frame " + std::to_string(frame) + " ticked out of order: " + describe(trace);
+						return false;
+					}
+				}
+
+				for (size_t groupIdx = 0; groupIdx < NUM_GROUPS; ++groupIdx)
+				{
+					if (dispatcher.getNumTypedBatches(groupIdx) != 2)
+					{
+						errorMessage = "objects of the same type were not batched together";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// one type with different tick functions and groups
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BatchesKeyedByFunctionAndGroup : public TickDispatcher_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Batches keyed by tick function and group";
+
+				Trace trace;
+				TickDispatcher dispatcher;
+				addEngineTickGroups(dispatcher);
+
+				sp<ShipLike> ship = new_sp<ShipLike>(trace, "ship");
+				dispatcher.registerTypedTicker<&ShipLike::tickLate>(4, ship);
+				dispatcher.registerTypedTicker<&ShipLike::tick>(0, ship);
+				dispatcher.registerTypedTicker<&ShipLike::tick>(0, ship); //duplicate ignored
+
+				dispatcher.tick(0.016f);
+				if (trace != Trace{ "ship", "ship.late" }) { errorMessage = "unexpected ticks: " + describe(trace); return false; }
+
+				if (!dispatcher.hasTypedTicker<&ShipLike::tick>(0, ship) || dispatcher.hasTypedTicker<&ShipLike::tick>(4, ship) || !dispatcher.hasTypedTicker<&ShipLike::tickLate>(4, ship))
+				{
+					errorMessage = "registration queries wrong";
+					return false;
+				}
+
+				dispatcher.removeTypedTicker<&ShipLike::tickLate>(4, ship);
+				trace.clear();
+				dispatcher.tick(0.016f);
+				if (trace != Trace{ "ship" }) { errorMessage = "removed function still ticked: " + describe(trace); return false; }
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// registration changes made by ticks
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ChangesDuringTick : public TickDispatcher_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Registration changes during ticks";
+
+				Trace trace;
+				TickDispatcher dispatcher;
+				addEngineTickGroups(dispatcher);
+
+				sp<ShipLike> spawner = new_sp<ShipLike>(trace, "spawner");
+				sp<ShipLike> victim = new_sp<ShipLike>(trace, "victim");
+				sp<ShipLike> expiring = new_sp<ShipLike>(trace, "expiring");
+				wp<ShipLike> expiringWeak = expiring;
+				sp<ShipLike> spawned = new_sp<ShipLike>(trace, "spawned");
+				sp<ParticleLike> spawnedParticle = new_sp<ParticleLike>(trace, "spawnedParticle");
+
+				expiring->ticksLeft = 1;
+				spawner->onTick = [&]()
+				{
+					//spawn into this batch, into a batch of a type this group has never seen, and kill something later in the batch
+					dispatcher.registerTypedTicker<&ShipLike::tick>(0, spawned);
+					dispatcher.registerTypedTicker<&ParticleLike::tick>(0, spawnedParticle);
+					dispatcher.removeTypedTicker<&ShipLike::tick>(0, victim);
+					spawner->onTick = nullptr;
+				};
+
+				dispatcher.registerTypedTicker<&ShipLike::tick>(0, spawner);
+				dispatcher.registerTypedTicker<&ShipLike::tick>(0, victim);
+				dispatcher.registerTypedTicker<&ShipLike::tick>(0, expiring);
+				expiring = nullptr; //the registration keeps it alive
+
+				dispatcher.tick(0.016f);
+				if (trace != Trace{ "spawner", "expiring" }) { errorMessage = "first frame: " + describe(trace); return false; }
+				if (!expiringWeak.expired()) { errorMessage = "ticker returning false was not released"; return false; }
+				if (dispatcher.hasTypedTicker<&ShipLike::tick>(0, victim)) { errorMessage = "removed ticker still registered"; return false; }
+
+				trace.clear();
+				dispatcher.tick(0.016f);
+				if (trace != Trace{ "spawner", "spawned", "spawnedParticle" }) { errorMessage = "second frame: " + describe(trace); return false; }
+
+				//self removal followed by re-registration inside the same tick keeps the object, moved to the back
+				spawner->onTick = [&]()
+				{
+					dispatcher.removeTypedTicker<&ShipLike::tick>(0, spawner);
+					dispatcher.registerTypedTicker<&ShipLike::tick>(0, spawner);
+					spawner->onTick = nullptr;
+				};
+				trace.clear();
+				dispatcher.tick(0.016f);
+				trace.clear();
+				dispatcher.tick(0.016f);
+				if (trace != Trace{ "spawned", "spawner", "spawnedParticle" }) { errorMessage = "re-registration: " + describe(trace); return false; }
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class TickDispatcherTestSuite : public SA::TestSuite
+		{
+		public:
+			TickDispatcherTestSuite()
+			{
+				testName = "TICK DISPATCHER TEST SUITE";
+
+				addTest(new_sp<Test_OrderMatchesTickGroups>());
+				addTest(new_sp<Test_BatchesKeyedByFunctionAndGroup>());
+				addTest(new_sp<Test_ChangesDuringTick>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getTickDispatcherTestSuite()
+	{
+		return new_sp<SA::TickDispatcherTests::TickDispatcherTestSuite>();
+	}
+}
@@ -0,0 +1,412 @@
+#include "EngineTestSuite.h"
+#include "../GameFramework/TimeManagement/TimerWheel.h"
+
+#include <functional>
+#include <random>
+
+namespace SA
+{
+	namespace TimerWheelTests
+	{
+		class TimerWheel_UnitTest : public SA::UnitTest
+		{
+		public:
+			TimerWheel_UnitTest()
+			{
+				testNamespace = "TimerWheel:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		struct Listener : public GameEntity
+		{
+			void handleTimer()
+			{
+				++fireCount;
+				if (onFire) { onFire(); }
+			}
+
+			uint32_t fireCount = 0;
+			std::function<void()> onFire;
+		};
+
+		struct TimerHandle
+		{
+			TimerHandle()
+			{
+				listener = new_sp<Listener>();
+				delegate = new_sp<MultiDelegate<>>();
+				delegate->addStrongObj(listener, &Listener::handleTimer);
+			}
+			sp<Listener> listener;
+			sp<MultiDelegate<>> delegate;
+		};
+
+		/** The per-timer update TimeManager used before the wheel; the reference for what a timer should do each frame. */
+		struct LegacyTimer
+		{
+			/* @returns true when timer is complete and should be removed */
+			bool update(float dt_sec, uint32_t& outFires)
+			{
+				currentTime += dt_sec;
+				while (currentTime > durationSecs)
+				{
+					++outFires;
+					currentTime -= durationSecs;
+					if (!bLoop)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+
+			float durationSecs = 0.f;
+			float currentTime = 0.f;
+			bool bLoop = false;
+			bool bActive = false;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// create, duplicate, remove, delay and strict expiry
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BasicTimers : public TimerWheel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Create, remove, delay and strict expiry";
+
+				TimerWheel wheel;
+				TimerHandle basic, removed, delayed, unbound;
+
+				if (wheel.createTimer(basic.delegate, -1.f) != ETimerOperationResult::FAILURE_NEGATIVE_DURATION) { errorMessage = "negative duration accepted"; return false; }
+				if (wheel.createTimer(basic.delegate, 1.f) != ETimerOperationResult::SUCCESS) { errorMessage = "create failed"; return false; }
+				if (wheel.createTimer(basic.delegate, 1.f) != ETimerOperationResult::FAILURE_TIMER_FOR_DELEGATE_EXISTS) { errorMessage = "duplicate timer accepted"; return false; }
+				if (!wheel.hasTimerForDelegate(basic.delegate)) { errorMessage = "timer not found after create"; return false; }
+
+				wheel.createTimer(removed.delegate, 0.5f);
+				if (wheel.removeTimer(removed.delegate) != ETimerOperationResult::SUCCESS) { errorMessage = "remove failed"; return false; }
+				if (wheel.removeTimer(removed.delegate) != ETimerOperationResult::FAILURE_TIMER_NOT_FOUND) { errorMessage = "removed twice"; return false; }
+
+				wheel.createTimer(delayed.delegate, 0.5f, false, 0.75f);
+
+				wheel.createTimer(unbound.delegate, 0.25f);
+				unbound.delegate->removeStrong(unbound.listener, &Listener::handleTimer);
+
+				//frozen frames do not run timers down
+				for (int frame = 0; frame < 10; ++frame)
+				{
+					wheel.advance(0.f);
+				}
+
+				wheel.advance(0.5f);
+				wheel.advance(0.5f);
+				if (basic.listener->fireCount != 0) { errorMessage = "timer fired at its expiry instead of after it"; return false; }
+				if (wheel.hasTimerForDelegate(unbound.delegate)) { errorMessage = "timer with unbound delegate was not dropped"; return false; }
+
+				wheel.advance(0.125f);
+				if (basic.listener->fireCount != 1 || wheel.hasTimerForDelegate(basic.delegate)) { errorMessage = "basic timer did not fire once and clear"; return false; }
+				if (delayed.listener->fireCount != 0) { errorMessage = "delay ignored"; return false; }
+
+				wheel.advance(0.25f);
+				if (delayed.listener->fireCount != 1) { errorMessage = "delayed timer did not fire"; return false; }
+
+				wheel.advance(2.f);
+				if (removed.listener->fireCount != 0 || basic.listener->fireCount != 1 || wheel.getNumTimers() != 0)
+				{
+					errorMessage = "removed or finished timers fired";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// loops fire as many times as fit in a frame
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_LoopingTimers : public TimerWheel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Loops fire every period within a frame";
+
+				TimerWheel wheel;
+				TimerHandle loop, zeroLoop, nextFrame;
+
+				wheel.createTimer(loop.delegate, 0.25f, true);
+				wheel.createTimer(zeroLoop.delegate, 0.f, true);
+				wheel.createTimer(nextFrame.delegate, 0.f);
+
+				wheel.advance(1.f);
+				if (loop.listener->fireCount != 3) { errorMessage = "loop did not fire 3 times in one long frame"; return false; }
+				if (zeroLoop.listener->fireCount != 1) { errorMessage = "zero length loop did not fire once per frame"; return false; }
+				if (nextFrame.listener->fireCount != 1 || wheel.hasTimerForDelegate(nextFrame.delegate)) { errorMessage = "next frame timer did not fire"; return false; }
+
+				wheel.advance(0.f);
+				if (zeroLoop.listener->fireCount != 1) { errorMessage = "zero length loop fired in a frozen frame"; return false; }
+
+				for (int frame = 0; frame < 8; ++frame)
+				{
+					wheel.advance(0.125f);
+				}
+				if (loop.listener->fireCount != 7 || zeroLoop.listener->fireCount != 9) { errorMessage = "loop counts drifted"; return false; }
+
+				//a loop removing itself stops
+				loop.listener->onFire = [&]()
+				{
+					if (wheel.removeTimer(loop.delegate) != ETimerOperationResult::DEFERRED) { errorMessage = "removal while firing was not deferred"; }
+				};
+				wheel.advance(1.f);
+				if (loop.listener->fireCount != 8 || wheel.hasTimerForDelegate(loop.delegate) || !errorMessage.empty())
+				{
+					if (errorMessage.empty()) { errorMessage = "self removing loop kept firing"; }
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// callbacks creating and removing timers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ModifyWhileFiring : public TimerWheel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Creating and removing timers while firing";
+
+				TimerWheel wheel;
+				TimerHandle first, victim, added, readded;
+
+				bool bCheckedInCallback = false;
+				first.listener->onFire = [&]()
+				{
+					bCheckedInCallback = true;
+					if (wheel.createTimer(added.delegate, 0.25f) != ETimerOperationResult::SUCCESS) { errorMessage = "create while firing failed"; }
+					if (wheel.createTimer(added.delegate, 0.25f) != ETimerOperationResult::DEFER_FAILURE_DELEGATE_ALREADY_PENDING_ADD) { errorMessage = "double deferred add accepted"; }
+					if (wheel.hasTimerForDelegate(added.delegate)) { errorMessage = "deferred add visible mid-frame"; }
+
+					//non looping timers keep their delegate until the frame is over
+					if (wheel.createTimer(first.delegate, 0.25f) != ETimerOperationResult::DEFER_FAILURE_TIMER_FOR_DELEGATE_EXISTS) { errorMessage = "re-add of firing timer accepted"; }
+
+					if (wheel.removeTimer(victim.delegate) != ETimerOperationResult::DEFERRED) { errorMessage = "remove while firing not deferred"; }
+					if (!wheel.hasTimerForDelegate(victim.delegate)) { errorMessage = "deferred remove released mid-frame"; }
+				};
+				wheel.createTimer(first.delegate, 0.25f);
+				wheel.createTimer(victim.delegate, 0.375f); //due later in the same frame
+
+				wheel.advance(0.5f);
+				if (!bCheckedInCallback || !errorMessage.empty()) { if (errorMessage.empty()) { errorMessage = "callback did not run"; } return false; }
+				if (victim.listener->fireCount != 0 || wheel.hasTimerForDelegate(victim.delegate)) { errorMessage = "removed timer fired later in the frame"; return false; }
+				if (!wheel.hasTimerForDelegate(added.delegate) || wheel.hasTimerForDelegate(first.delegate)) { errorMessage = "end of frame bookkeeping wrong"; return false; }
+
+				//the deferred add starts at the end of the frame that created it, not at the callback's expiry
+				wheel.advance(0.25f);
+				if (added.listener->fireCount != 0) { errorMessage = "deferred timer started early"; return false; }
+				wheel.advance(0.125f);
+				if (added.listener->fireCount != 1) { errorMessage = "deferred timer did not fire"; return false; }
+
+				//a timer removing itself from its callback frees its delegate for reuse after the frame
+				readded.listener->onFire = [&]()
+				{
+					wheel.removeTimer(readded.delegate);
+				};
+				wheel.createTimer(readded.delegate, 0.25f);
+				wheel.advance(0.5f);
+				if (wheel.createTimer(readded.delegate, 0.25f) != ETimerOperationResult::SUCCESS) { errorMessage = "delegate not reusable after removal"; return false; }
+				wheel.advance(0.5f);
+				if (readded.listener->fireCount != 2) { errorMessage = "re-added timer did not fire"; return false; }
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// random timers against the old per-timer update; times are multiples of 1/64 so both are exact
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesLegacyTimers : public TimerWheel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Matches per-timer update";
+
+				const size_t numTimers = 300;
+				const int numFrames = 3000;
+
+				std::mt19937 rng(1337);
+				auto sixtyFourths = [&](int lo, int hi) { return float(std::uniform_int_distribution<int>(lo, hi)(rng)) / 64.f; };
+				auto chance = [&](float p) { return std::uniform_real_distribution<float>(0.f, 1.f)(rng) < p; };
+
+				TimerWheel wheel;
+				std::vector<TimerHandle> handles(numTimers);
+				std::vector<LegacyTimer> legacy(numTimers);
+				std::vector<uint32_t> legacyFires(numTimers, 0);
+
+				auto startTimer = [&](size_t idx)
+				{
+					//mostly short timers, some long enough to cascade through the upper levels
+					const float duration = chance(0.1f) ? sixtyFourths(64 * 60, 64 * 400) : sixtyFourths(1, 64 * 4);
+					const float delay = chance(0.3f) ? sixtyFourths(0, 64 * 2) : 0.f;
+					const bool bLoop = chance(0.4f);
+
+					if (wheel.createTimer(handles[idx].delegate, duration, bLoop, delay) != ETimerOperationResult::SUCCESS) { return false; }
+					legacy[idx] = LegacyTimer{ duration, -delay, bLoop, true };
+					return true;
+				};
+
+				for (size_t idx = 0; idx < numTimers; ++idx)
+				{
+					if (!startTimer(idx)) { errorMessage = "initial create failed"; return false; }
+				}
+
+				for (int frame = 0; frame < numFrames; ++frame)
+				{
+					const float dt = sixtyFourths(0, 32);
+
+					wheel.advance(dt);
+					for (size_t idx = 0; idx < numTimers; ++idx)
+					{
+						if (legacy[idx].bActive && legacy[idx].update(dt, legacyFires[idx]))
+						{
+							legacy[idx].bActive = false;
+						}
+					}
+
+					for (size_t idx = 0; idx < numTimers; ++idx)
+					{
+						if (handles[idx].listener->fireCount != legacyFires[idx] || wheel.hasTimerForDelegate(handles[idx].delegate) != legacy[idx].bActive)
+						{
+							errorMessage = "timer " + std::to_string(idx) + " diverged from legacy at frame " + std::to_string(frame);
+							return false;
+						}
+					}
+
+					//churn between frames
+					for (size_t idx = 0; idx < numTimers; ++idx)
+					{
+						if (legacy[idx].bActive && chance(0.002f))
+						{
+							wheel.removeTimer(handles[idx].delegate);
+							legacy[idx].bActive = false;
+						}
+						else if (!legacy[idx].bActive && chance(0.05f))
+						{
+							if (!startTimer(idx)) { errorMessage = "restart failed"; return false; }
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// durations past the top level are parked and still fire on time
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_LongDurations : public TimerWheel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Long durations cascade and fire on time";
+
+				TimerWheel wheel;
+				TimerHandle hours, days;
+
+				const float hoursSecs = 5000.f;		//level 3
+				const float daysSecs = 400000.f;	//beyond the wheel's span
+				wheel.createTimer(hours.delegate, hoursSecs);
+				wheel.createTimer(days.delegate, daysSecs);
+
+				const float step = 64.f;
+				while (wheel.getTimeSecs() + step <= double(daysSecs))
+				{
+					wheel.advance(step);
+					const bool bHoursShouldHaveFired = wheel.getTimeSecs() > double(hoursSecs);
+					if ((hours.listener->fireCount == 1) != bHoursShouldHaveFired || days.listener->fireCount != 0)
+					{
+						errorMessage = "long timer fired at the wrong time: " + std::to_string(wheel.getTimeSecs());
+						return false;
+					}
+				}
+
+				wheel.advance(float(double(daysSecs) - wheel.getTimeSecs()));
+				if (days.listener->fireCount != 0) { errorMessage = "parked timer fired at its expiry instead of after it"; return false; }
+				wheel.advance(1.f / 64.f);
+				if (days.listener->fireCount != 1) { errorMessage = "parked timer did not fire"; return false; }
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// frame cost follows firing timers rather than live timers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_CostScalesWithFiringTimers : public TimerWheel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Frame cost follows firing timers";
+
+				TimerWheel wheel;
+				std::mt19937 rng(7);
+				std::uniform_real_distribution<float> idleDuration(100.f, 1000.f);
+
+				const size_t numIdle = 100000;
+				std::vector<TimerHandle> idle(numIdle);
+				for (TimerHandle& handle : idle)
+				{
+					wheel.createTimer(handle.delegate, idleDuration(rng));
+				}
+
+				const size_t numBusy = 16;
+				std::vector<TimerHandle> busy(numBusy);
+				for (size_t idx = 0; idx < numBusy; ++idx)
+				{
+					wheel.createTimer(busy[idx].delegate, 0.05f + 0.01f * idx, true);
+				}
+
+				size_t maxVisited = 0;
+				for (int frame = 0; frame < 600; ++frame)
+				{
+					wheel.advance(1.f / 60.f);
+					maxVisited = std::max(maxVisited, wheel.getNumTimersVisitedLastAdvance());
+				}
+
+				if (maxVisited > 4 * numBusy)
+				{
+					errorMessage = "a frame visited " + std::to_string(maxVisited) + " timers while only " + std::to_string(numBusy) + " were looping";
+					return false;
+				}
+				if (busy[0].listener->fireCount < 190 || wheel.getNumTimers() != numIdle + numBusy)
+				{
+					errorMessage = "busy timers did not fire";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class TimerWheelTestSuite : public SA::TestSuite
+		{
+		public:
+			TimerWheelTestSuite()
+			{
+				testName = "TIMER WHEEL TEST SUITE";
+
+				addTest(new_sp<Test_BasicTimers>());
+				addTest(new_sp<Test_LoopingTimers>());
+				addTest(new_sp<Test_ModifyWhileFiring>());
+				addTest(new_sp<Test_MatchesLegacyTimers>());
+				addTest(new_sp<Test_LongDurations>());
+				addTest(new_sp<Test_CostScalesWithFiringTimers>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getTimerWheelTestSuite()
+	{
+		return new_sp<SA::TimerWheelTests::TimerWheelTestSuite>();
+	}
+}
@@ -0,0 +1,274 @@
+#include "EngineTestSuite.h"
+#include "../Rendering/SAUniformLocationCache.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace SA
+{
+	namespace UniformLocationCacheTests
+	{
+		class UniformCache_UnitTest : public SA::UnitTest
+		{
+		public:
+			UniformCache_UnitTest()
+			{
+				testNamespace = "UniformLocationCache:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// helpers
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		/** a linked program as the fake GL functions report it */
+		struct FakeUniform
+		{
+			std::string name;	//as glGetActiveUniform reports it, eg arrays end with [0]
+			GLint location;
+			GLenum type;
+			GLint arraySize;
+		};
+
+		struct FakeProgram
+		{
+			GLuint id = 0;
+			std::vector<FakeUniform> uniforms;
+			size_t numCalls = 0;
+		};
+
+		static FakeProgram* fakeProgram = nullptr;
+
+		static void APIENTRY fakeGetProgramiv(GLuint program, GLenum pname, GLint* params)
+		{
+			++fakeProgram->numCalls;
+			GLint maxLength = 0;
+			for (const FakeUniform& uniform : fakeProgram->uniforms) { maxLength = std::max(maxLength, GLint(uniform.name.size() + 1)); }
+			*params = (program != fakeProgram->id) ? 0 : (pname == GL_ACTIVE_UNIFORMS) ? GLint(fakeProgram->uniforms.size()) : (pname == GL_ACTIVE_UNIFORM_MAX_LENGTH) ? maxLength : 0;
+		}
+
+		static void APIENTRY fakeGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+		{
+			++fakeProgram->numCalls;
+			const FakeUniform& uniform = fakeProgram->uniforms[index];
+			GLsizei copied = std::min<GLsizei>(bufSize - 1, GLsizei(uniform.name.size()));
+			std::copy(uniform.name.begin(), uniform.name.begin() + copied, name);
+			name[copied] = '\0';
+			*length = copied;
+			*size = uniform.arraySize;
+			*type = uniform.type;
+		}
+
+		static GLint APIENTRY fakeGetUniformLocation(GLuint program, const GLchar* name)
+		{
+			++fakeProgram->numCalls;
+			std::string requested(name);
+			for (const FakeUniform& uniform : fakeProgram->uniforms)
+			{
+				if (uniform.name == requested) { return uniform.location; }
+
+				//array elements are laid out at consecutive locations
+				const std::string suffix = "[0]";
+				if (uniform.arraySize > 1 && uniform.name.size() > suffix.size() && uniform.name.compare(uniform.name.size() - suffix.size(), suffix.size(), suffix) == 0)
+				{
+					std::string baseName = uniform.name.substr(0, uniform.name.size() - suffix.size());
+					if (requested == baseName) { return uniform.location; }
+					for (GLint element = 1; element < uniform.arraySize; ++element)
+					{
+						if (requested == baseName + "[" + std::to_string(element) + "]") { return uniform.location + element; }
+					}
+				}
+			}
+			return -1;
+		}
+
+		static UniformGLFunctions fakeGL()
+		{
+			UniformGLFunctions gl;
+			gl.getProgramiv = &fakeGetProgramiv;
+			gl.getActiveUniform = &fakeGetActiveUniform;
+			gl.getUniformLocation = &fakeGetUniformLocation;
+			return gl;
+		}
+
+		static FakeProgram makeModelProgram(GLuint id, GLint locationOffset)
+		{
+			FakeProgram program;
+			program.id = id;
+			program.uniforms = {
+				{ "projection_view", 0 + locationOffset, GL_FLOAT_MAT4, 1 },
+				{ "model", 1 + locationOffset, GL_FLOAT_MAT4, 1 },
+				{ "lightColor", 2 + locationOffset, GL_FLOAT_VEC3, 1 },
+				{ "material.diffuse", 3 + locationOffset, GL_SAMPLER_2D, 1 },
+				{ "weights[0]", 10 + locationOffset, GL_FLOAT, 5 },
+				{ "dirLights[0].intensity", 20 + locationOffset, GL_FLOAT, 1 },
+				{ "dirLights[1].intensity", 21 + locationOffset, GL_FLOAT, 1 },
+			};
+			return program;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// cache reports the same locations glGetUniformLocation would, including array elements
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_LocationsMatchGL : public UniformCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cached locations match glGetUniformLocation";
+
+				FakeProgram program = makeModelProgram(7, 0);
+				fakeProgram = &program;
+
+				UniformLocationCache cache;
+				cache.build(program.id, fakeGL());
+
+				const char* names[] = { "projection_view", "model", "lightColor", "material.diffuse", "weights", "weights[0]", "weights[3]",
+					"weights[4]", "dirLights[0].intensity", "dirLights[1].intensity", "notInShader", "weights[5]", "", "mode", "modelz" };
+				for (const char* name : names)
+				{
+					GLint expected = fakeGetUniformLocation(program.id, name);
+					if (cache.findLocation(name) != expected)
+					{
+						errorMessage = std::string("cached location differs from GL for ") + name;
+						fakeProgram = nullptr;
+						return false;
+					}
+				}
+
+				//lookups after the build never touch GL
+				program.numCalls = 0;
+				for (int repeat = 0; repeat < 100; ++repeat)
+				{
+					for (const char* name : names) { cache.findLocation(name); }
+				}
+				fakeProgram = nullptr;
+				if (program.numCalls != 0)
+				{
+					errorMessage = "name lookup called into GL after the cache was built";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// handles follow the program through context loss and relink
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_HandlesSurviveContextLoss : public UniformCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Handles survive context loss and relink";
+
+				UniformLocationCache cache;
+
+				//handles may be requested before the program exists
+				uint32_t modelSlot = cache.registerHandle("model");
+				if (cache.getHandleLocation(modelSlot) != -1)
+				{
+					errorMessage = "handle resolved before the program was built";
+					return false;
+				}
+
+				FakeProgram firstProgram = makeModelProgram(3, 0);
+				fakeProgram = &firstProgram;
+				cache.build(firstProgram.id, fakeGL());
+				uint32_t colorSlot = cache.registerHandle("lightColor");
+				uint32_t weightSlot = cache.registerHandle("weights[2]");
+
+				if (cache.registerHandle("model") != modelSlot)
+				{
+					errorMessage = "registering the same name twice produced a second slot";
+					fakeProgram = nullptr;
+					return false;
+				}
+				if (cache.getHandleLocation(modelSlot) != 1 || cache.getHandleLocation(colorSlot) != 2 || cache.getHandleLocation(weightSlot) != 12
+					|| cache.getHandleType(colorSlot) != GL_FLOAT_VEC3)
+				{
+					errorMessage = "handles did not resolve to the program's locations";
+					fakeProgram = nullptr;
+					return false;
+				}
+
+				//context lost: program deleted, every location must stop pointing at it
+				cache.invalidate();
+				if (cache.isBuilt() || cache.getHandleLocation(modelSlot) != -1 || cache.getHandleLocation(colorSlot) != -1 || cache.findLocation("model") != -1)
+				{
+					errorMessage = "locations from the deleted program were still returned after invalidate";
+					fakeProgram = nullptr;
+					return false;
+				}
+
+				//context acquired: relinked program assigns different locations
+				FakeProgram relinkedProgram = makeModelProgram(9, 30);
+				fakeProgram = &relinkedProgram;
+				cache.build(relinkedProgram.id, fakeGL());
+				fakeProgram = nullptr;
+
+				if (cache.getHandleLocation(modelSlot) != 31 || cache.getHandleLocation(colorSlot) != 32 || cache.getHandleLocation(weightSlot) != 42)
+				{
+					errorMessage = "handles were not re-resolved against the relinked program";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// handle types are checked against what the program declares
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_HandleTypes : public UniformCache_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Handle types match declared uniform types";
+
+				FakeProgram program = makeModelProgram(5, 0);
+				fakeProgram = &program;
+				UniformLocationCache cache;
+				cache.build(program.id, fakeGL());
+				fakeProgram = nullptr;
+
+				GLenum modelType = cache.getHandleType(cache.registerHandle("model"));
+				GLenum samplerType = cache.getHandleType(cache.registerHandle("material.diffuse"));
+				GLenum weightType = cache.getHandleType(cache.registerHandle("weights"));
+
+				if (!UniformTypeTraits<glm::mat4>::accepts(modelType) || UniformTypeTraits<glm::vec4>::accepts(modelType)
+					|| !UniformTypeTraits<int>::accepts(samplerType) || UniformTypeTraits<float>::accepts(samplerType)
+					|| !UniformTypeTraits<float>::accepts(weightType))
+				{
+					errorMessage = "type traits did not match the declared uniform types";
+					return false;
+				}
+				if (cache.getHandleType(cache.registerHandle("notInShader")) != 0)
+				{
+					errorMessage = "inactive uniform reported a type";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class UniformLocationCacheTestSuite : public SA::TestSuite
+		{
+		public:
+			UniformLocationCacheTestSuite()
+			{
+				testName = "UNIFORM LOCATION CACHE TEST SUITE";
+
+				addTest(new_sp<Test_LocationsMatchGL>());
+				addTest(new_sp<Test_HandlesSurviveContextLoss>());
+				addTest(new_sp<Test_HandleTypes>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getUniformLocationCacheTestSuite()
+	{
+		return new_sp<SA::UniformLocationCacheTests::UniformLocationCacheTestSuite>();
+	}
+}
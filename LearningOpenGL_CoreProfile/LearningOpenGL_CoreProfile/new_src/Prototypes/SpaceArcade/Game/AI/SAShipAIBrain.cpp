@@ -192,22 +192,36 @@ namespace SA
 	void WanderBrain::postConstruct()
 	{
 		using namespace BehaviorTree;
-		behaviorTree =
-			new_sp<Tree>("tree-root",
-				new_sp<Selector>("RootSelector", MakeChildren{
-					new_sp<Sequence>("Sequence_MoveToNewLocation", MakeChildren{
-						//new_sp<Task_Ship_SaveShipLocation>("ship_loc", "selfBrain"),
-						new_sp<Task_FindRandomLocationNearby>("target_loc", "ship_loc", 400.0f),
-						new_sp<Task_Ship_MoveToLocation>("selfBrain", "target_loc", 45.0f)
+
+		//every wander brain shares the definition, so it is built once
+		static sp<const CompiledTreeDefinition> wanderTree = []()
+		{
+			CompiledMemoryLayout layout;
+			const MemoryKey shipKey = layout.add("ship");
+			const MemoryKey shipLocKey = layout.add("ship_loc");
+			const MemoryKey targetLocKey = layout.add("target_loc");
+			const MemoryKey moveTimeKey = layout.add("move_time");
+
+			return CompiledTreeDefinition::compile("wander-tree",
+				CompiledNodeDef::selector("RootSelector", {
+					CompiledNodeDef::sequence("Sequence_MoveToNewLocation", {
+						CompiledNodeDef::task("task_random_location_nearby", new_sp<CompiledTask_FindRandomLocationNearby>(targetLocKey, shipLocKey, 400.0f)),
+						CompiledNodeDef::task("task_ship_move_to_location", new_sp<CompiledTask_Ship_MoveToLocation>(shipKey, targetLocKey, moveTimeKey, 45.0f))
 					})
 				}),
-				MemoryInitializer
-				{
-					{"selfBrain", sp_this() },
-					{ "ship_loc", new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3{0,0,0}) },
-					{ "target_loc", new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3{0,0,0}) }
-				}
+				layout
 			);
+		}();
+		compiledTree = wanderTree;
+	}
+
+	void WanderBrain::initCompiledTreeMemory(BehaviorTree::Memory& memory)
+	{
+		//weak so that the tree does not keep the ship alive
+		memory.setWeakValue("ship", getWeakControlledTarget());
+		memory.setValue("ship_loc", glm::vec3{ 0,0,0 });
+		memory.setValue("target_loc", glm::vec3{ 0,0,0 });
+		memory.setValue("move_time", 0.f);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
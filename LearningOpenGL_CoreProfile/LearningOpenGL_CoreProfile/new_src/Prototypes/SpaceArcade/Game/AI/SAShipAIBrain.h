@@ -14,6 +14,7 @@ namespace SA
 	namespace BehaviorTree
 	{
 		class Tree;
+		class Memory;
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +80,7 @@ namespace SA
 
 	/////////////////////////////////////////////////////////////////////////////////////
 	// A behavior tree for a docile ship that randomly wanders about its local vicinity
+	//		-runs on the compiled engine; every wander brain on a level ticks in one group
 	/////////////////////////////////////////////////////////////////////////////////////
 	class WanderBrain : public ShipAIBrain
 	{
@@ -86,6 +88,7 @@ namespace SA
 		WanderBrain(const sp<Ship>& controlledShip) : ShipAIBrain(controlledShip) {}
 	protected:
 		virtual void postConstruct() override;
+		virtual void initCompiledTreeMemory(BehaviorTree::Memory& memory) override;
 	};
 
 	////////////////////////////////////////////////////////
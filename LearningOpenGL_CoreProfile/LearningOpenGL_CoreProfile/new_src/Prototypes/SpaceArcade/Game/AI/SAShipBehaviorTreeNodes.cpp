@@ -166,7 +166,7 @@ namespace SA
 						return; //early out, cannot get the target location
 					}
 				}
-				currentLevel->getWorldTimeManager()->registerTicker(sp_this());
+				currentLevel->getWorldTimeManager()->registerTypedTicker<&Task_Ship_MoveToLocation::tick>(TickGroups::get().GAME, sp_this());
 				accumulatedTime = 0;
 			}
 			else
@@ -220,7 +220,7 @@ namespace SA
 			static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
 			if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
 			{
-				currentLevel->getWorldTimeManager()->removeTicker(sp_this());
+				currentLevel->getWorldTimeManager()->removeTypedTicker<&Task_Ship_MoveToLocation::tick>(TickGroups::get().GAME, sp_this());
 			}
 		}
 
@@ -228,6 +228,102 @@ namespace SA
 		{
 		}
 
+		/////////////////////////////////////////////////////////////////////////////////////
+		// compiled find random location nearby
+		/////////////////////////////////////////////////////////////////////////////////////
+		CompiledTask_FindRandomLocationNearby::CompiledTask_FindRandomLocationNearby(MemoryKey outputLocation_MemoryKey, MemoryKey inputLocation_MemoryKey, const float radius)
+			: outputLocation_MemoryKey(outputLocation_MemoryKey),
+			inputLocation_MemoryKey(inputLocation_MemoryKey),
+			radius(radius)
+		{
+			rng = GameBase::get().getRNGSystem().getTimeInfluencedRNG();
+		}
+
+		CompiledStatus CompiledTask_FindRandomLocationNearby::begin(CompiledNodeContext& context)
+		{
+			using namespace glm;
+
+			Memory& memory = context.memory;
+			const vec3* startLocation = memory.getReadValueAs<vec3>(inputLocation_MemoryKey);
+			ScopedUpdateNotifier<vec3> writeValue;
+
+			if (startLocation && memory.getWriteValueAs<vec3>(outputLocation_MemoryKey, writeValue))
+			{
+				//same distribution as Task_FindRandomLocationNearby
+				float randomRadius = radius * rng->getFloat(0.01f, 1.f);
+				float zRotDeg = rng->getFloat(0.f, 360.f);
+				float yRotDeg = rng->getFloat(0.f, 360.f);
+
+				glm::quat rot = glm::angleAxis(Utils::DEG_TO_RADIAN_F * zRotDeg, glm::vec3(0.f, 0.f, 1.f));
+				rot = glm::angleAxis(Utils::DEG_TO_RADIAN_F * yRotDeg, glm::vec3(0.f, 1.f, 0.f)) * rot;
+				vec3 offsetDir = glm::toMat3(rot) * vec3(1, 0, 0);
+
+				writeValue.get() = offsetDir * randomRadius + (*startLocation);
+				return CompiledStatus::SUCCEEDED;
+			}
+
+			SA::log("CompiledTask_FindRandomLocationNearby", LogLevel::LOG_ERROR, "Failed to get memory location!");
+			return CompiledStatus::FAILED;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// compiled move to location
+		/////////////////////////////////////////////////////////////////////////////////////
+		CompiledStatus CompiledTask_Ship_MoveToLocation::begin(CompiledNodeContext& context)
+		{
+			Memory& memory = context.memory;
+			if (!memory.getReadValueAs<Ship>(ship_MemoryKey))
+			{
+				log("CompiledTask_Ship_MoveToLocation", LogLevel::LOG_ERROR, "could not find controlled ship");
+				return CompiledStatus::FAILED;
+			}
+			if (!memory.getReadValueAs<glm::vec3>(targetLoc_MemoryKey))
+			{
+				return CompiledStatus::FAILED;
+			}
+
+			memory.setValue(moveTime_MemoryKey, 0.f);
+			return CompiledStatus::RUNNING;
+		}
+
+		CompiledStatus CompiledTask_Ship_MoveToLocation::poll(CompiledNodeContext& context)
+		{
+			using namespace glm;
+
+			Memory& memory = context.memory;
+			ScopedUpdateNotifier<Ship> myShip;
+			ScopedUpdateNotifier<float> moveTime;
+			const vec3* moveLoc = memory.getReadValueAs<vec3>(targetLoc_MemoryKey);
+			if (!moveLoc || !memory.getWriteValueAs(ship_MemoryKey, myShip) || !memory.getWriteValueAs(moveTime_MemoryKey, moveTime))
+			{
+				//ship was destroyed while moving
+				return CompiledStatus::FAILED;
+			}
+
+			Ship& ship = myShip.get();
+			float& accumulatedTime = moveTime.get();
+			accumulatedTime += context.dt_sec;
+
+			const Transform& xform = ship.getTransform();
+			if (glm::length2(*moveLoc - xform.position) < atLocThresholdLength2)
+			{
+				return CompiledStatus::SUCCEEDED;
+			}
+			else if (accumulatedTime >= timeoutSecs)
+			{
+				return CompiledStatus::FAILED;
+			}
+
+			ship.moveTowardsPoint(*moveLoc, context.dt_sec);
+
+			if constexpr (ENABLE_DEBUG_LINES)
+			{
+				static DebugRenderSystem& debug = GameBase::get().getDebugRenderSystem();
+				debug.renderLine(vec4(xform.position, 1), vec4(*moveLoc, 1), vec4(0, 0.25f, 0, 1));
+			}
+			return CompiledStatus::RUNNING;
+		}
+
 		/////////////////////////////////////////////////////////////////////////////////////
 		// Service target finder
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -448,7 +544,7 @@ namespace SA
 		void Service_TargetFinder::resetSearchData()
 		{
 			//currentSearchMethod = SearchMethod::NEARBY_HASH_CELLS;
-			//currentSearchMethod = SearchMethod::LINEAR_SEARCH; 
+			//currentSearchMethod = SearchMethod::NEAREST_ENEMY; 
 			currentSearchMethod = SearchMethod::COMMANDER_ASSIGNED;
 		}
 
@@ -483,7 +579,8 @@ namespace SA
 							}
 							else
 							{
-								//AdvanceState(); #TODO have this check other methods by switching the current search enum or some mechanism
+								//commander has nothing queued for us; engage whatever enemy is closest rather than idle
+								bestSoFar = findNearestEnemy(*spaceLevel, myPos);
 							}
 						}
 					}
@@ -517,35 +614,11 @@ namespace SA
 					worldGrid.lookupCellsForOOB(worldSpaceBox, nearbyCells);
 
 				}
-				else if (currentSearchMethod == SearchMethod::LINEAR_SEARCH)
+				else if (currentSearchMethod == SearchMethod::NEAREST_ENEMY)
 				{
-					const std::set<sp<WorldEntity>>& worldEntities = level->getWorldEntities();
-					for (const sp<WorldEntity>& entity : worldEntities)
+					if (SpaceLevelBase* spaceLevel = dynamic_cast<SpaceLevelBase*>(level.get()))
 					{
-						if(TeamComponent* TeamCom = entity->getGameComponent<TeamComponent>())
-						{
-							if (cachedTeamIdx != TeamCom->getTeam())
-							{
-								glm::vec3 targetPos = entity->getWorldPosition();
-								float len2 = glm::length2(targetPos - myPos);
-							
-								if (!bestSoFar)
-								{
-									bestSoFar = entity;
-									bestSoFarLen2 = len2;
-								}
-								else if (len2 < bestSoFarLen2)
-								{
-									bestSoFar = entity;
-									bestSoFarLen2 = len2;
-								}
-								if (len2 < cachedPrefDist2)
-								{
-									//accept this as target
-									break;
-								}
-							}
-						}
+						bestSoFar = findNearestEnemy(*spaceLevel, myPos);
 					}
 				}
 
@@ -564,6 +637,16 @@ namespace SA
 			}
 		}
 
+		sp<WorldEntity> Service_TargetFinder::findNearestEnemy(SpaceLevelBase& spaceLevel, const glm::vec3& myPos) const
+		{
+			const TeamTargetIndex<WorldEntity>& targetIndex = spaceLevel.getTargetIndex();
+			if (WorldEntity* nearestEnemy = targetIndex.findNearestEnemy(myPos, cachedTeamIdx, TargetFlags::ATTACKABLE))
+			{
+				return nearestEnemy->requestTypedReference_Nonsafe<WorldEntity>().lock();
+			}
+			return nullptr;
+		}
+
 		void Service_TargetFinder::setTarget(const sp<WorldEntity>& target, bool bCommanderAssignment /*= false*/)
 		{
 			if (target == currentTarget)
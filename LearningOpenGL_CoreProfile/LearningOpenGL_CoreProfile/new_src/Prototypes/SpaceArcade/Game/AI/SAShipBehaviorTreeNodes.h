@@ -1,5 +1,6 @@
 #pragma once
 #include "../../GameFramework/SABehaviorTree.h"
+#include "../../GameFramework/SACompiledBehaviorTree.h"
 #include "../../GameFramework/SATimeManagementSystem.h"
 #include "../SAShip.h"
 #include "../../Tools/DataStructures/SATransform.h"
@@ -16,6 +17,7 @@ namespace SA
 	////////////////////////////////////////////////////////
 	class RNG;
 	class ShipAIBrain;
+	class SpaceLevelBase;
 	namespace BehaviorTree
 	{
 		struct DogfightNodeTickData;
@@ -117,7 +119,7 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 		/////////////////////////////////////////////////////////////////////////////////////
 		// task move to location
 		/////////////////////////////////////////////////////////////////////////////////////
-		class Task_Ship_MoveToLocation : public Task, public ITickable
+		class Task_Ship_MoveToLocation final : public Task
 		{
 		public:
 			Task_Ship_MoveToLocation(
@@ -136,7 +138,7 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 
 		protected:
 			virtual void handleNodeAborted() override;
-			virtual bool tick(float dt_sec) override;
+			bool tick(float dt_sec); //typed ticker; batched with every other move task in the GAME tick group
 
 		private:
 			//memory keys
@@ -153,6 +155,44 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			float accumulatedTime = 0;
 		};
 
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Compiled versions of the wander tasks; one object serves every brain running the tree.
+		/////////////////////////////////////////////////////////////////////////////////////
+		class CompiledTask_FindRandomLocationNearby final : public CompiledTask
+		{
+		public:
+			CompiledTask_FindRandomLocationNearby(MemoryKey outputLocation_MemoryKey, MemoryKey inputLocation_MemoryKey, const float radius);
+			virtual CompiledStatus begin(CompiledNodeContext& context) override;
+
+		private:
+			const MemoryKey outputLocation_MemoryKey;
+			const MemoryKey inputLocation_MemoryKey;
+			const float radius;
+			sp<RNG> rng;
+		};
+
+		/** Expects the ship as a weak value in memory; the time spent moving is kept in moveTime_MemoryKey rather than the task. */
+		class CompiledTask_Ship_MoveToLocation final : public CompiledTask
+		{
+		public:
+			CompiledTask_Ship_MoveToLocation(MemoryKey ship_MemoryKey, MemoryKey targetLoc_MemoryKey, MemoryKey moveTime_MemoryKey, const float timeoutSecs)
+				: ship_MemoryKey(ship_MemoryKey),
+				targetLoc_MemoryKey(targetLoc_MemoryKey),
+				moveTime_MemoryKey(moveTime_MemoryKey),
+				timeoutSecs(timeoutSecs)
+			{
+			}
+			virtual CompiledStatus begin(CompiledNodeContext& context) override;
+			virtual CompiledStatus poll(CompiledNodeContext& context) override;
+
+		private:
+			const MemoryKey ship_MemoryKey;
+			const MemoryKey targetLoc_MemoryKey;
+			const MemoryKey moveTime_MemoryKey;
+			const float timeoutSecs;
+			const float atLocThresholdLength2 = 0.1f;
+		};
+
 		/////////////////////////////////////////////////////////////////////////////////////
 		// Task that automatically registers ticker and calls a tick function
 		//
@@ -222,7 +262,7 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			{
 				COMMANDER_ASSIGNED,
 				NEARBY_HASH_CELLS, //#TODO remove these if they don't get used
-				LINEAR_SEARCH,
+				NEAREST_ENEMY, //closest attackable entity on another team, from the level's team target index; also the fallback when the commander has nothing to assign
 			};
 
 		private:
@@ -248,6 +288,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 
 			void resetSearchData();
 			void tickFindNewTarget_slow();
+			/** Closest attackable entity on another team, from the level's team target index. */
+			sp<WorldEntity> findNearestEnemy(SpaceLevelBase& spaceLevel, const glm::vec3& myPos) const;
 
 			void setTarget(const sp<WorldEntity>& target, bool bCommanderAssignment = false);
 		private: //utils
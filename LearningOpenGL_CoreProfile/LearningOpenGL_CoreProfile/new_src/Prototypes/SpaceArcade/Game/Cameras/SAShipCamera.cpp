@@ -81,7 +81,7 @@ namespace SA
 		bool bInputSuspended = false;
 		if (const sp<PlayerBase>& player = playerSystem.getPlayer(owningPlayerIndex)) { bInputSuspended = player->getInput().isInputSuspended(); }
 		
-		if (primaryWindow && myShip && !bInputSuspended)
+		if (primaryWindow && primaryWindow->get() && myShip && !bInputSuspended)
 		{
 			GLFWwindow* window = primaryWindow->get();
 			bool bCtrl = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS;
@@ -502,7 +502,7 @@ namespace SA
 			myTeamData.clear();
 
 			//loop through all ships and find the carriers, then set those; this is going to be slow
-			const std::set<sp<WorldEntity>>& worldEntities = level->getWorldEntities();
+			const SlotMap<sp<WorldEntity>>& worldEntities = level->getWorldEntities();
 			for (const sp<WorldEntity>& worldEntity : worldEntities)
 			{
 				sp<Ship> asShip = std::dynamic_pointer_cast<Ship>(worldEntity);
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <set>
+#include <limits>
+
+#include "../../../../Algorithms/SpatialHashing/SpatialHashingComponent.h"
+#include "../../../../Algorithms/SeparatingAxisTheorem/SATComponent.h"
+#include "../../GameFramework/SACollisionUtils.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Closest-hit search for projectile segments against a spatial hash of entities.
+	//
+	// The entity type is templated so the search can be run without a level; getCollisionData maps an
+	// entity to its collision (or nullptr if it has none).
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	struct ProjectileCollisionQuery
+	{
+		const SAT::Shape* projectileShape = nullptr;	//already transformed to the projectile's collision box
+		const T* owner = nullptr;						//a projectile never hits its owner
+		T* closestEntity = nullptr;
+		float closestDistance_2 = std::numeric_limits<float>::infinity();
+	};
+
+	namespace ProjectileCollision
+	{
+		/** tests the projectile against the entity's OBB, then its shapes; keeps the shape whose origin is closest to segmentStart */
+		template<typename T>
+		inline void testEntity(T& entity, const CollisionData& collisionData, const glm::vec3& segmentStart, ProjectileCollisionQuery<T>& query)
+		{
+			glm::vec4 obbMTV;
+			if (SAT::Shape::CollisionTest(*query.projectileShape, *collisionData.getOBBShape(), obbMTV))
+			{
+				//#TODO perhaps this shouldn't find the closest shape it collided with? will be redundant
+				for (const CollisionData::ConstShapeData& shapeData : collisionData.getConstShapeData())
+				{
+					glm::vec4 mtv;
+					if (SAT::Shape::CollisionTest(*query.projectileShape, *shapeData.shape, mtv))
+					{
+						glm::vec3 shapeOrigin = glm::vec3(shapeData.shape->getTransformedOrigin());
+
+						//it would be better to use distance the contact point, but that isn't available in my SAT implementation
+						//perhaps I will change that if I figure out an efficient means to get the contact point
+						float distToShapOri = glm::length2(shapeOrigin - segmentStart); //get distance from start to shape ori
+						if (distToShapOri < query.closestDistance_2)
+						{
+							query.closestDistance_2 = distToShapOri;
+							query.closestEntity = &entity;
+						}
+					}
+				}
+			}
+		}
+
+		/** One line lookup per projectile. Kept as the reference the batched search must agree with. */
+		template<typename T, typename CollisionLookupFn>
+		void findClosestHit(SH::SpatialHashGrid<T>& grid, const SH::LineSegment& segment, ProjectileCollisionQuery<T>& query, CollisionLookupFn&& getCollisionData)
+		{
+			std::vector<std::shared_ptr<const SH::HashCell<T>>> cells;
+			grid.lookupCellsForLine(segment.start, segment.end, cells);
+
+			//an entity that occupies many cells is only tested once; ordered by address like the batched candidates
+			std::set<T*> potentialCollisions;
+			for (const std::shared_ptr<const SH::HashCell<T>>& cell : cells)
+			{
+				for (const std::shared_ptr<SH::GridNode<T>>& gridNode : cell->nodeBucket)
+				{
+					potentialCollisions.insert(&gridNode->element);
+				}
+			}
+
+			for (T* entity : potentialCollisions)
+			{
+				if (entity != query.owner)
+				{
+					if (const CollisionData* collisionData = getCollisionData(*entity))
+					{
+						testEntity(*entity, *collisionData, segment.start, query);
+					}
+				}
+			}
+		}
+
+		/** One batched line lookup for every projectile; queries are parallel to segments. */
+		template<typename T, typename CollisionLookupFn>
+		void findClosestHits(
+			SH::SpatialHashGrid<T>& grid,
+			const std::vector<SH::LineSegment>& segments,
+			std::vector<ProjectileCollisionQuery<T>>& queries,
+			std::vector<SH::LineSegmentCandidate<T>>& candidatesBuffer,
+			CollisionLookupFn&& getCollisionData)
+		{
+			grid.lookupNodesForLines(segments, candidatesBuffer);
+
+			//candidates are grouped by entity, so each entity's collision data is looked up once for all projectiles near it
+			size_t groupStart = 0;
+			while (groupStart < candidatesBuffer.size())
+			{
+				T* entity = candidatesBuffer[groupStart].element;
+				size_t groupEnd = groupStart + 1;
+				while (groupEnd < candidatesBuffer.size() && candidatesBuffer[groupEnd].element == entity) { ++groupEnd; }
+
+				if (const CollisionData* collisionData = getCollisionData(*entity))
+				{
+					for (size_t candidateIdx = groupStart; candidateIdx < groupEnd; ++candidateIdx)
+					{
+						const uint32_t segmentIdx = candidatesBuffer[candidateIdx].segmentIdx;
+						ProjectileCollisionQuery<T>& query = queries[segmentIdx];
+						if (entity != query.owner)
+						{
+							testEntity(*entity, *collisionData, segments[segmentIdx].start, query);
+						}
+					}
+				}
+				groupStart = groupEnd;
+			}
+		}
+	}
+}
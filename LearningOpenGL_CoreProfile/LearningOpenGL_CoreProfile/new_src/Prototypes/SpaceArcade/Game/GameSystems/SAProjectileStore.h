@@ -0,0 +1,248 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <cassert>
+
+#include <glm.hpp>
+
+namespace SA
+{
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Stable reference to a stored projectile; stays valid while the projectile is alive, even as
+	// other projectiles are swap-removed. Once removed the handle goes stale; its slot may be reused
+	// but with a new generation, so the old handle never resolves to a different projectile.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	struct ProjectileHandle
+	{
+		static constexpr uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+		uint32_t slot = INVALID_SLOT;
+		uint32_t generation = 0;
+
+		bool isValid() const { return slot != INVALID_SLOT; }
+		bool operator==(const ProjectileHandle& other) const { return slot == other.slot && generation == other.generation; }
+		bool operator!=(const ProjectileHandle& other) const { return !(*this == other); }
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Structure-of-arrays projectile storage
+	//
+	// The per-frame movement data lives in contiguous parallel arrays that are advanced in a single
+	// loop; everything else about a projectile (render matrices, emitters, owner, etc) is ColdData.
+	// Removal is swap-and-pop, so dense indices are only valid until the next removal; hold a
+	// ProjectileHandle to refer to a projectile across frames.
+	//
+	// ColdData is kept in a deque so that references to it survive adds; eg a hit notification
+	// that spawns another projectile will not invalidate the projectile being notified about.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename ColdData>
+	class ProjectileStore
+	{
+	public:
+		struct SpawnValues
+		{
+			glm::vec3 position;
+			glm::vec3 direction_n;
+			float speed;
+			float lifetimeSec;
+		};
+
+	public:
+		void reserve(size_t numProjectiles)
+		{
+			positions.reserve(numProjectiles);
+			stepStarts.reserve(numProjectiles);
+			directions_n.reserve(numProjectiles);
+			speeds.reserve(numProjectiles);
+			stepDistances.reserve(numProjectiles);
+			timeAlive.reserve(numProjectiles);
+			lifetimeSec.reserve(numProjectiles);
+			denseToSlot.reserve(numProjectiles);
+			slotToDense.reserve(numProjectiles);
+			slotGenerations.reserve(numProjectiles);
+			freeSlots.reserve(numProjectiles);
+		}
+
+		/** Adds a projectile at the back of the dense arrays (ie at index size() - 1) */
+		ProjectileHandle add(const SpawnValues& values, ColdData&& coldData)
+		{
+			uint32_t slot;
+			if (freeSlots.size() > 0)
+			{
+				slot = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				slot = uint32_t(slotToDense.size());
+				slotToDense.push_back(ProjectileHandle::INVALID_SLOT);
+				slotGenerations.push_back(0);
+			}
+
+			slotToDense[slot] = uint32_t(positions.size());
+			denseToSlot.push_back(slot);
+
+			positions.push_back(values.position);
+			stepStarts.push_back(values.position);
+			directions_n.push_back(values.direction_n);
+			speeds.push_back(values.speed);
+			stepDistances.push_back(0.f);
+			timeAlive.push_back(0.f);
+			lifetimeSec.push_back(values.lifetimeSec);
+			cold.push_back(std::move(coldData));
+
+			return ProjectileHandle{ slot, slotGenerations[slot] };
+		}
+
+		/** Moves every projectile forward along its direction; stepStart/stepDistance record this frame's segment */
+		void advance(float dt_sec)
+		{
+			advance(dt_sec, 0, positions.size());
+		}
+
+		/** Advances dense indices [begin, end) only; ranges touch disjoint elements so they can be advanced on different threads */
+		void advance(float dt_sec, size_t begin, size_t end)
+		{
+			for (size_t idx = begin; idx < end; ++idx)
+			{
+				float step = speeds[idx] * dt_sec;
+				stepStarts[idx] = positions[idx];
+				stepDistances[idx] = step;
+				positions[idx] += directions_n[idx] * step;
+				timeAlive[idx] += dt_sec;
+			}
+		}
+
+		/** Swap-and-pop removal; the projectile previously at the back now occupies denseIdx */
+		void removeAt(size_t denseIdx)
+		{
+			assert(denseIdx < positions.size());
+			const size_t backIdx = positions.size() - 1;
+			const uint32_t removedSlot = denseToSlot[denseIdx];
+
+			if (denseIdx != backIdx)
+			{
+				positions[denseIdx] = positions[backIdx];
+				stepStarts[denseIdx] = stepStarts[backIdx];
+				directions_n[denseIdx] = directions_n[backIdx];
+				speeds[denseIdx] = speeds[backIdx];
+				stepDistances[denseIdx] = stepDistances[backIdx];
+				timeAlive[denseIdx] = timeAlive[backIdx];
+				lifetimeSec[denseIdx] = lifetimeSec[backIdx];
+				cold[denseIdx] = std::move(cold[backIdx]);
+				denseToSlot[denseIdx] = denseToSlot[backIdx];
+				slotToDense[denseToSlot[denseIdx]] = uint32_t(denseIdx);
+			}
+
+			positions.pop_back();
+			stepStarts.pop_back();
+			directions_n.pop_back();
+			speeds.pop_back();
+			stepDistances.pop_back();
+			timeAlive.pop_back();
+			lifetimeSec.pop_back();
+			cold.pop_back();
+			denseToSlot.pop_back();
+
+			slotToDense[removedSlot] = ProjectileHandle::INVALID_SLOT;
+			++slotGenerations[removedSlot]; //stale handles to this slot will no longer resolve
+			freeSlots.push_back(removedSlot);
+		}
+
+		bool remove(const ProjectileHandle& handle)
+		{
+			size_t denseIdx;
+			if (resolve(handle, denseIdx))
+			{
+				removeAt(denseIdx);
+				return true;
+			}
+			return false;
+		}
+
+		/** Removes every projectile where shouldRemove(denseIdx) is true; onRemove(denseIdx) is called first so resources can be released */
+		template<typename ShouldRemoveFn, typename OnRemoveFn>
+		void removeIf(ShouldRemoveFn shouldRemove, OnRemoveFn onRemove)
+		{
+			//walk backwards so the element swapped into a removed index has already been visited
+			for (size_t idx = positions.size(); idx > 0; --idx)
+			{
+				const size_t denseIdx = idx - 1;
+				if (shouldRemove(denseIdx))
+				{
+					onRemove(denseIdx);
+					removeAt(denseIdx);
+				}
+			}
+		}
+
+		void clear()
+		{
+			for (uint32_t slot : denseToSlot)
+			{
+				slotToDense[slot] = ProjectileHandle::INVALID_SLOT;
+				++slotGenerations[slot];
+				freeSlots.push_back(slot);
+			}
+
+			positions.clear();
+			stepStarts.clear();
+			directions_n.clear();
+			speeds.clear();
+			stepDistances.clear();
+			timeAlive.clear();
+			lifetimeSec.clear();
+			cold.clear();
+			denseToSlot.clear();
+		}
+
+		bool resolve(const ProjectileHandle& handle, size_t& outDenseIdx) const
+		{
+			if (handle.slot < slotToDense.size()
+				&& slotGenerations[handle.slot] == handle.generation
+				&& slotToDense[handle.slot] != ProjectileHandle::INVALID_SLOT)
+			{
+				outDenseIdx = slotToDense[handle.slot];
+				return true;
+			}
+			return false;
+		}
+		bool isAlive(const ProjectileHandle& handle) const { size_t unused; return resolve(handle, unused); }
+
+		size_t size() const { return positions.size(); }
+		bool isExpired(size_t denseIdx) const { return timeAlive[denseIdx] > lifetimeSec[denseIdx]; }
+		ProjectileHandle getHandle(size_t denseIdx) const { uint32_t slot = denseToSlot[denseIdx]; return ProjectileHandle{ slot, slotGenerations[slot] }; }
+
+		glm::vec3& getPosition(size_t denseIdx) { return positions[denseIdx]; }
+		const glm::vec3& getPosition(size_t denseIdx) const { return positions[denseIdx]; }
+		const glm::vec3& getStepStart(size_t denseIdx) const { return stepStarts[denseIdx]; }
+		const glm::vec3& getDirection(size_t denseIdx) const { return directions_n[denseIdx]; }
+		float getSpeed(size_t denseIdx) const { return speeds[denseIdx]; }
+		float getStepDistance(size_t denseIdx) const { return stepDistances[denseIdx]; }
+		float getTimeAlive(size_t denseIdx) const { return timeAlive[denseIdx]; }
+		float getLifetimeSec(size_t denseIdx) const { return lifetimeSec[denseIdx]; }
+		ColdData& getColdData(size_t denseIdx) { return cold[denseIdx]; }
+		const ColdData& getColdData(size_t denseIdx) const { return cold[denseIdx]; }
+
+	private:
+		//hot data; indexed by dense index
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec3> stepStarts;
+		std::vector<glm::vec3> directions_n;
+		std::vector<float> speeds;
+		std::vector<float> stepDistances;
+		std::vector<float> timeAlive;
+		std::vector<float> lifetimeSec;
+		std::deque<ColdData> cold;
+		std::vector<uint32_t> denseToSlot;
+
+		//handle indirection; indexed by slot
+		std::vector<uint32_t> slotToDense;
+		std::vector<uint32_t> slotGenerations;
+		std::vector<uint32_t> freeSlots;
+	};
+}
@@ -0,0 +1,205 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <set>
+
+#include <gtc/quaternion.hpp>
+#include <gtx/quaternion.hpp>
+
+#include "SAProjectileStore.h"
+#include "../../Tools/DataStructures/ObjectPools.h"
+
+/*
+	Headless benchmark for ProjectileStore; no window, GL context, or game systems are created.
+
+	Simulates sustained fire: every frame a batch of projectiles is spawned, all live projectiles are moved,
+	and expired projectiles are removed. The same script runs against the previous layout (pooled sp<Projectile>
+	objects in a std::set) and the structure-of-arrays store. Both runs use the same seed, so the position
+	checksums must match.
+*/
+
+namespace
+{
+	using namespace SA;
+
+	/** stand-in for the fields the old Projectile carried alongside its movement data */
+	struct FatProjectile
+	{
+		glm::vec3 position;
+		glm::vec3 direction_n;
+		glm::quat directionQuat;
+		glm::mat4 collisionXform;
+		glm::mat4 renderXform;
+		float speed;
+		float lifetimeSec;
+		float timeAlive;
+		sp<int> owner;
+		sp<int> soundEmitter;
+		sp<int> pointLight;
+	};
+
+	/** cold data the store keeps next to the hot arrays */
+	struct ColdPayload
+	{
+		glm::quat directionQuat;
+		glm::mat4 collisionXform;
+		glm::mat4 renderXform;
+		sp<int> owner;
+		sp<int> soundEmitter;
+		sp<int> pointLight;
+	};
+
+	struct BenchConfig
+	{
+		size_t numFrames = 2000;
+		size_t spawnsPerFrame = 20;
+		float dt_sec = 1.f / 60.f;
+		float minLifetime = 1.f;
+		float maxLifetime = 5.f;
+		uint32_t seed = 0xB0B;
+	};
+
+	struct BenchResults
+	{
+		double totalMs = 0.0;
+		size_t peakProjectiles = 0;
+		double positionChecksum = 0.0;
+	};
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	struct SpawnRandomizer
+	{
+		SpawnRandomizer(uint32_t seed, const BenchConfig& config)
+			: rng(seed), posDist(-500.f, 500.f), dirDist(-1.f, 1.f), speedDist(50.f, 200.f), lifetimeDist(config.minLifetime, config.maxLifetime)
+		{}
+		std::mt19937 rng;
+		std::uniform_real_distribution<float> posDist, dirDist, speedDist, lifetimeDist;
+
+		glm::vec3 position() { return glm::vec3(posDist(rng), posDist(rng), posDist(rng)); }
+		glm::vec3 direction() { return glm::normalize(glm::vec3(dirDist(rng), dirDist(rng), dirDist(rng)) + glm::vec3(0.001f)); }
+	};
+
+	BenchResults runSetOfSharedPointers(const BenchConfig& config)
+	{
+		BenchResults results;
+		SpawnRandomizer random(config.seed, config);
+		sp<int> owner = std::make_shared<int>(0);
+
+		SP_SimpleObjectPool<FatProjectile> objPool;
+		std::set<sp<FatProjectile>> activeProjectiles;
+
+		Clock::time_point start = Clock::now();
+		for (size_t frame = 0; frame < config.numFrames; ++frame)
+		{
+			for (size_t spawn = 0; spawn < config.spawnsPerFrame; ++spawn)
+			{
+				sp<FatProjectile> spawned = objPool.getInstance();
+				spawned->position = random.position();
+				spawned->direction_n = random.direction();
+				spawned->speed = random.speedDist(random.rng);
+				spawned->lifetimeSec = random.lifetimeDist(random.rng);
+				spawned->timeAlive = 0.f;
+				spawned->owner = owner;
+				activeProjectiles.insert(spawned);
+			}
+			results.peakProjectiles = std::max(results.peakProjectiles, activeProjectiles.size());
+
+			auto iter = std::begin(activeProjectiles);
+			while (iter != std::end(activeProjectiles))
+			{
+				auto iterCopy = iter;
+				++iter;
+
+				FatProjectile& projectile = **iterCopy;
+				projectile.timeAlive += config.dt_sec;
+				projectile.position += projectile.direction_n * (projectile.speed * config.dt_sec);
+
+				if (projectile.timeAlive > projectile.lifetimeSec)
+				{
+					results.positionChecksum += double(projectile.position.x + projectile.position.y + projectile.position.z);
+					objPool.releaseInstance(*iterCopy);
+					activeProjectiles.erase(iterCopy);
+				}
+			}
+		}
+		results.totalMs = elapsedMs(start);
+		return results;
+	}
+
+	BenchResults runStructureOfArrays(const BenchConfig& config)
+	{
+		BenchResults results;
+		SpawnRandomizer random(config.seed, config);
+		sp<int> owner = std::make_shared<int>(0);
+
+		ProjectileStore<ColdPayload> activeProjectiles;
+		activeProjectiles.reserve(300);
+
+		Clock::time_point start = Clock::now();
+		for (size_t frame = 0; frame < config.numFrames; ++frame)
+		{
+			for (size_t spawn = 0; spawn < config.spawnsPerFrame; ++spawn)
+			{
+				ProjectileStore<ColdPayload>::SpawnValues values;
+				values.position = random.position();
+				values.direction_n = random.direction();
+				values.speed = random.speedDist(random.rng);
+				values.lifetimeSec = random.lifetimeDist(random.rng);
+
+				ColdPayload payload;
+				payload.owner = owner;
+				activeProjectiles.add(values, std::move(payload));
+			}
+			results.peakProjectiles = std::max(results.peakProjectiles, activeProjectiles.size());
+
+			activeProjectiles.advance(config.dt_sec);
+			activeProjectiles.removeIf(
+				[&](size_t denseIdx) { return activeProjectiles.isExpired(denseIdx); },
+				[&](size_t denseIdx)
+				{
+					const glm::vec3& position = activeProjectiles.getPosition(denseIdx);
+					results.positionChecksum += double(position.x + position.y + position.z);
+				}
+			);
+		}
+		results.totalMs = elapsedMs(start);
+		return results;
+	}
+
+	void printResults(const char* storeName, const BenchConfig& config, const BenchResults& results)
+	{
+		std::cout << storeName << "\n"
+			<< "\ttotal:                " << results.totalMs << " ms\n"
+			<< "\tper frame:            " << results.totalMs / config.numFrames << " ms\n"
+			<< "\tpeak live projectiles " << results.peakProjectiles << std::endl;
+	}
+
+	void true_main()
+	{
+		for (size_t spawnsPerFrame : { 5, 20, 80 })
+		{
+			BenchConfig config;
+			config.spawnsPerFrame = spawnsPerFrame;
+			std::cout << "---- " << spawnsPerFrame << " spawns per frame, " << config.numFrames << " frames ----" << std::endl;
+
+			BenchResults setResults = runSetOfSharedPointers(config);
+			printResults("std::set<sp<Projectile>> with object pool", config, setResults);
+
+			BenchResults soaResults = runStructureOfArrays(config);
+			printResults("ProjectileStore (structure of arrays, swap and pop)", config, soaResults);
+
+			//removal order differs between the two, so sums may differ in the last bits
+			if (glm::abs(setResults.positionChecksum - soaResults.positionChecksum) > 1e-3 * glm::abs(setResults.positionChecksum) + 1.0)
+			{
+				std::cerr << "MISMATCH: position checksums differ" << std::endl;
+			}
+		}
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
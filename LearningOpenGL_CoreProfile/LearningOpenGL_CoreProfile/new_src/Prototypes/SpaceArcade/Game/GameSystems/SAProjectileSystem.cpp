@@ -20,42 +20,41 @@
 #include "../../Rendering/DeferredRendering/DeferredRendererStateMachine.h"
 #include "../../Tools/PlatformUtils.h"
 #include "../../Rendering/DeferredRendering/DeferredRenderingShaders.h"
+#include "../../GameFramework/Jobs/JobSystem.h"
+#include "../../GameFramework/Jobs/SystemTickGraph.h"
+#include "../../GameFramework/SATickProfiler.h"
 
 namespace SA
 {
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	// Actual Projectile Instances; these system is responsible for creating these instances
 	///////////////////////////////////////////////////////////////////////////////////////////////
-	void Projectile::tick(float dt_sec, LevelBase& currentLevel)
+	bool Projectile::tick(size_t denseIdx, ProjectileStorage& storage, glm::vec3& outStart)
 	{
-		using glm::mat4; using glm::vec3; using glm::quat; using glm::vec4;
-
-		//#optimize perhaps cache level system in local static for perf; profiler may cacn help to determine if this is worth it
-		timeAlive += dt_sec;
-
-		float dt_distance = dt_sec * speed;
+		//if the projectile hit its target last tick, it already stretched to the hit location
+		if (bHit)
+		{
+			forceRelease = true;
+			return false;
+		}
 
-		stretchToDistance(dt_distance, true, currentLevel);
+		//time alive and the step distance were already advanced with the rest of the batch; this pass does the stretch
+		outStart = stretchToDistance(storage.getStepStart(denseIdx), storage.getStepDistance(denseIdx), denseIdx, storage);
+		return true;
 	}
 
-	void Projectile::stretchToDistance(float dt_distance, float bDoCollisionTest, LevelBase& currentLevel)
+	glm::vec3 Projectile::stretchToDistance(glm::vec3 start, float dt_distance, size_t denseIdx, ProjectileStorage& storage)
 	{
 		using glm::mat4; using glm::vec3; using glm::quat; using glm::vec4;
 
-		//if the projectile hit its target, change logic so it just stretches to hit location
-		if (bHit)
-		{
-			forceRelease = true;
-			return;
-		}
+		const vec3& direction_n = storage.getDirection(denseIdx);
+		const float speed = storage.getSpeed(denseIdx);
 
 		//#optimize investigate whether some of the matrices below can be cached once (eg fire rotation? offsetDirection?)
-		vec3 start = xform.position;
-
 		if(bCorrectPosition)
 		{
 			vec3 originalOffset_v = offsetStartPos - traceStartPos;
-			vec3 toCurPos_v = xform.position - traceStartPos; //hypotenuse 
+			vec3 toCurPos_v = start - traceStartPos; //hypotenuse 
 			vec3 projOntoCenteredLine_v = Utils::project(toCurPos_v, direction_n); //ie the line as if we fired from center of ship, 
 
 
@@ -88,7 +87,7 @@ namespace SA
 		renderXform = glm::scale(transToEnd_rotToFireDir_zOffset, modelScaleStrech);
 
 		// models parallel to z
-		xform.position = end;
+		storage.getPosition(denseIdx) = end;
 #if _WIN32 && _DEBUG
 		if (Utils::anyValueNAN(start)){__debugbreak();}
 		if (Utils::anyValueNAN(end)) {__debugbreak();}
@@ -105,143 +104,168 @@ namespace SA
 			pointLight->setPosition(end);
 		}
 
-		//collision check
-		if (bDoCollisionTest && !bHit)
-		{
-			SH::SpatialHashGrid<WorldEntity>& worldGrid = currentLevel.getWorldGrid();
-
-			/* #optimize #alternative collision. perhaps simple ray casts would be faster; it will require that triangles for collision shapes are available
-				This method isn't going to be ideal for large structures, because the distance to the center of the shape collided with isn't going
-				to produce a distance to generate an accurate end point; a ray trace will however. Plus it will probably be more efficient than
-				a cube x cube collision test.
-			*/
-			std::vector<std::shared_ptr<const SH::HashCell<WorldEntity>>> cells;
-			worldGrid.lookupCellsForLine(start, end, cells);
-
-			//#optimize below may be slow; but don't want a bunch of collisions with same objects that occupy large # of cells (eg large ship)
-			static std::set<WorldEntity*> potentialCollisions;
-			potentialCollisions.clear(); //absolute must do this since it is a static local
-
-			for (sp<const SH::HashCell<WorldEntity>> cell : cells)
-			{
-				for (std::shared_ptr<SH::GridNode<WorldEntity>> gridNode : cell->nodeBucket)
-				{
-					potentialCollisions.insert(&gridNode->element);
-				}
-			}
-
-			static sp<SAT::Shape> projectileShape = new_sp<SAT::CubeShape>();
-			projectileShape->updateTransform(collisionXform);
-
-			float smallestDistanceCollision_2 = std::numeric_limits<float>::infinity();
-			WorldEntity* collidingEntity = nullptr;
+		return start;
+	}
 
-			for (WorldEntity* entity : potentialCollisions)
-			{
-				CollisionComponent* collisionComp = entity->getGameComponent<CollisionComponent>();
-				if (collisionComp && entity != owner.get())
-				{
-					const CollisionData* colisionData = collisionComp->getCollisionData();
-					const sp<const SAT::Shape>& OBBShape = colisionData->getOBBShape();
+	sp<WorldEntity> Projectile::findOwner() const
+	{
+		static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
+		const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel();
+		return currentLevel ? currentLevel->findEntity(owner) : nullptr;
+	}
 
-					glm::vec4 obbMTV;
-					if (SAT::Shape::CollisionTest(*projectileShape, *OBBShape, obbMTV))
-					{
-						//#TODO perhaps this shouldn't find the closest shape it collided with? will be redundant
-						for (const CollisionData::ConstShapeData& shapeData : colisionData->getConstShapeData())
-						{
-							glm::vec4 mtv;
-							if (SAT::Shape::CollisionTest(*projectileShape, *shapeData.shape, mtv))
-							{
-								vec3 shapeOrigin = vec3(shapeData.shape->getTransformedOrigin());
-
-								//it would be better to use distance the contact point, but that isn't available in my SAT implementation
-								//perhaps I will change that if I figure out an efficient means to get the contact point
-								float distToShapOri = glm::length2(shapeOrigin - start); //get distance from start to shape ori
-								if (distToShapOri < smallestDistanceCollision_2)
-								{
-									smallestDistanceCollision_2 = distToShapOri;
-									collidingEntity = entity;
-								}
-							}
-						}
-					}
-				}
-			}
+	void Projectile::applyHit(WorldEntity& hitEntity, float distanceToHitShape_2, const glm::vec3& start, size_t denseIdx, ProjectileStorage& storage)
+	{
+		//copy rather than reference; the notification below may spawn projectiles and grow the storage arrays
+		const glm::vec3 direction_n = storage.getDirection(denseIdx);
 
-			if (collidingEntity)
-			{
-				float maxHitDistance = 10.f; //I believe with large shapes this doesn't look good, so clamp it. it is using distance to shape origin.
-				float hitDistance = glm::clamp<float>(glm::sqrt(smallestDistanceCollision_2), 0.f, maxHitDistance);
-				glm::vec3 hit = start + (-offsetDir * hitDistance / 2.f); //div by 2 may not be right theoretically, but hit distance appears too far and this seems to fix
+		float maxHitDistance = 10.f; //I believe with large shapes this doesn't look good, so clamp it. it is using distance to shape origin.
+		float hitDistance = glm::clamp<float>(glm::sqrt(distanceToHitShape_2), 0.f, maxHitDistance);
+		glm::vec3 hit = start + (direction_n * hitDistance / 2.f); //div by 2 may not be right theoretically, but hit distance appears too far and this seems to fix
 
-				//#TODO #componentize this interface to be a component to avoid dynamic cast. This will require comp delegate notify owner though, which may be slower than dyn cast; profiling and optimizatin likely needed.
-				if (IProjectileHitNotifiable* toNotify = dynamic_cast<IProjectileHitNotifiable*>(collidingEntity))
-				{
-					toNotify->notifyProjectileCollision(*this, hit);
-				}
+		//#TODO #componentize this interface to be a component to avoid dynamic cast. This will require comp delegate notify owner though, which may be slower than dyn cast; profiling and optimizatin likely needed.
+		if (IProjectileHitNotifiable* toNotify = dynamic_cast<IProjectileHitNotifiable*>(&hitEntity))
+		{
+			toNotify->notifyProjectileCollision(*this, hit);
+		}
 
-				//recalculate end point etc so visuals don't go through
-				xform.position = start;
-				stretchToDistance(hitDistance, false, currentLevel);
+		//recalculate end point etc so visuals don't go through
+		stretchToDistance(start, hitDistance, denseIdx, storage);
 
-				//make sure this projectile will expire on next tick!
-				hitLocation = hit;
-				bHit = true;
-			}
-		}
+		//make sure this projectile will expire on next tick!
+		hitLocation = hit;
+		bHit = true;
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	// Projectile system
 	///////////////////////////////////////////////////////////////////////////////////////////////
 
+	//advance + stretch is a few matrix compositions per projectile; 256 splits a few hundred shots across the workers
+	//while keeping each job well above the cost of handing it out
+	static constexpr size_t projectilesPerJob = 256;
+
 	void ProjectileSystem::postGameLoopTick(float system_dt_sec)
 	{
+		static const TickProfiler::LabelId profileLabel = TickProfiler::internLabel("ProjectileSystem");
+		TickProfiler::Scope profileScope(profileLabel);
 		if (const sp<LevelBase>& currentLevel = GameBase::get().getLevelSystem().getCurrentLevel())
 		{
 			const sp<TimeManager>& worldTM = currentLevel->getWorldTimeManager();
 
 			if (!worldTM->isTimeFrozen())
 			{
-				auto iter = std::begin(activeProjectiles);
-				auto end = std::end(activeProjectiles);
-				while (iter != end)
-				{
-					//since projectiles may expire, we want need to remove them from the set of active projectiles
-					//we can do this while iterating over std::set, but we need to take care. Removing an interator
-					//only invalidates that iterator, but if it is invalidated we cannot get the next iterator from it.
-					//So, we copy the iterator and immediately get the next iterator; meaning removing the copy doesn't
-					//affect our ability to get the next iterator
-					auto iterCopy = iter;
-					++iter; 
-					
-					const sp<Projectile>& projectile = *iterCopy;
-					projectile->tick(worldTM->getDeltaTimeSecs(), *currentLevel);
-
-					if (projectile->timeAlive > projectile->lifetimeSec || projectile->forceRelease)
+				//move everything in one pass over the hot arrays, then stretch each projectile and collide them as a batch
+				const float dt_sec = worldTM->getDeltaTimeSecs();
+				JobSystem& jobSystem = GameBase::get().getJobSystem();
+				jobSystem.parallelFor(activeProjectiles.size(), projectilesPerJob,
+					[this, dt_sec](size_t begin, size_t end) { activeProjectiles.advance(dt_sec, begin, end); });
+
+				//stretching only writes the projectile's own cold data, emitter and light; results are gathered per index
+				const size_t numToTick = activeProjectiles.size();
+				stretchStarts.resize(numToTick);
+				stretchNeedsCollision.resize(numToTick);
+				jobSystem.parallelFor(numToTick, projectilesPerJob,
+					[this](size_t begin, size_t end)
 					{
-						if (projectile->soundEmitter)
+						for (size_t denseIdx = begin; denseIdx < end; ++denseIdx)
 						{
-							projectile->soundEmitter->stop();
-							sfxPool.releaseInstance(projectile->soundEmitter);
-							projectile->soundEmitter = nullptr;
+							stretchNeedsCollision[denseIdx] = activeProjectiles.getColdData(denseIdx).tick(denseIdx, activeProjectiles, stretchStarts[denseIdx]);
 						}
+					});
+
+				//compact in index order so the collision batch is the same regardless of how the jobs were split
+				pendingCollisions.clear();
+				collisionSegments.clear();
+				for (size_t denseIdx = 0; denseIdx < numToTick; ++denseIdx)
+				{
+					if (stretchNeedsCollision[denseIdx])
+					{
+						pendingCollisions.push_back(denseIdx);
+						collisionSegments.push_back(SH::LineSegment{ stretchStarts[denseIdx], activeProjectiles.getPosition(denseIdx) });
+					}
+				}
+
+				//projectiles spawned during this (eg from a hit notification) are appended and will first tick next frame
+				{
+					static const TickProfiler::LabelId collisionLabel = TickProfiler::internLabel("ProjectileCollision");
+					TickProfiler::Scope collisionScope(collisionLabel);
+					collideProjectiles(*currentLevel);
+				}
 
-						if (projectile->pointLight)
+				activeProjectiles.removeIf(
+					[this](size_t denseIdx) 
+					{
+						return activeProjectiles.isExpired(denseIdx) || activeProjectiles.getColdData(denseIdx).forceRelease;
+					},
+					[this](size_t denseIdx)
+					{
+						Projectile& projectile = activeProjectiles.getColdData(denseIdx);
+						if (projectile.soundEmitter)
 						{
-							lightPool.releaseInstance(projectile->pointLight);
-							projectile->pointLight = nullptr;
+							projectile.soundEmitter->stop();
+							sfxPool.releaseInstance(projectile.soundEmitter);
+							projectile.soundEmitter = nullptr;
 						}
-				
-						//note: this projectile will keep any sp alive, so clear before release if needed
-						objPool.releaseInstance(projectile);
 
-						//removing iterator from set does not invalidate other iterators; 
-						//IMPORANT: this must after releasing to pool, otherwise the smart pointer will be deleted
-						activeProjectiles.erase(iterCopy); //#TODO #performance swap and pop will probably greatly speed this up; there might be a reason we need it in a set though
+						if (projectile.pointLight)
+						{
+							lightPool.releaseInstance(projectile.pointLight);
+							projectile.pointLight = nullptr;
+						}
 					}
+				);
+			}
+		}
+	}
+
+	void ProjectileSystem::collideProjectiles(LevelBase& currentLevel)
+	{
+		/* #optimize #alternative collision. perhaps simple ray casts would be faster; it will require that triangles for collision shapes are available
+			This method isn't going to be ideal for large structures, because the distance to the center of the shape collided with isn't going
+			to produce a distance to generate an accurate end point; a ray trace will however. Plus it will probably be more efficient than
+			a cube x cube collision test.
+		*/
+		SH::SpatialHashGrid<WorldEntity>& worldGrid = currentLevel.getWorldGrid();
+
+		//transform each projectile's collision box once, rather than once per entity it is tested against
+		while (projectileShapes.size() < pendingCollisions.size())
+		{
+			projectileShapes.push_back(new_up<SAT::CubeShape>());
+		}
+		collisionQueries.clear();
+		collisionQueries.resize(pendingCollisions.size());
+		const SlotMap<sp<WorldEntity>>& worldEntities = currentLevel.getWorldEntities();
+		GameBase::get().getJobSystem().parallelFor(pendingCollisions.size(), projectilesPerJob,
+			[this, &worldEntities](size_t begin, size_t end)
+			{
+				for (size_t segmentIdx = begin; segmentIdx < end; ++segmentIdx)
+				{
+					const Projectile& projectile = activeProjectiles.getColdData(pendingCollisions[segmentIdx]);
+					projectileShapes[segmentIdx]->updateTransform(projectile.collisionXform);
+					collisionQueries[segmentIdx].projectileShape = projectileShapes[segmentIdx].get();
+
+					//read only lookup; nothing spawns or unspawns while projectiles collide
+					const sp<WorldEntity>* owner = worldEntities.find(projectile.owner);
+					collisionQueries[segmentIdx].owner = owner ? owner->get() : nullptr;
 				}
+			});
+
+		ProjectileCollision::findClosestHits(worldGrid, collisionSegments, collisionQueries, collisionCandidates,
+			[](WorldEntity& entity) -> const CollisionData*
+			{
+				CollisionComponent* collisionComp = entity.getGameComponent<CollisionComponent>();
+				return collisionComp ? collisionComp->getCollisionData() : nullptr;
+			});
+
+		//hits are applied after all tests; entity destruction is deferred to end of frame so the entity pointers are still valid
+		for (size_t segmentIdx = 0; segmentIdx < pendingCollisions.size(); ++segmentIdx)
+		{
+			const ProjectileCollisionQuery<WorldEntity>& query = collisionQueries[segmentIdx];
+			if (query.closestEntity)
+			{
+				const size_t denseIdx = pendingCollisions[segmentIdx];
+				activeProjectiles.getColdData(denseIdx).applyHit(*query.closestEntity, query.closestDistance_2, collisionSegments[segmentIdx].start, denseIdx, activeProjectiles);
 			}
 		}
 	}
@@ -262,7 +286,7 @@ namespace SA
 				{
 					deferedShaded_EmissiveModelShader->use();
 					deferredRenderer->configureShaderForGBufferWrite(*deferedShaded_EmissiveModelShader);
-					renderProjectiles(*deferedShaded_EmissiveModelShader);
+					renderProjectiles(*deferedShaded_EmissiveModelShader, deferedShaded_EmissiveUniforms);
 				}
 				else { STOP_DEBUGGER_HERE(); }
 			}
@@ -274,13 +298,19 @@ namespace SA
 					forwardShaded_EmissiveModelShader->use();
 					forwardShaded_EmissiveModelShader->setUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(frd->view));
 					forwardShaded_EmissiveModelShader->setUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(frd->projection));
-					renderProjectiles(*forwardShaded_EmissiveModelShader);
+					renderProjectiles(*forwardShaded_EmissiveModelShader, forwardShaded_EmissiveUniforms);
 				}
 				else { STOP_DEBUGGER_HERE(); }
 			}
 		}
 	}
 
+	void ProjectileSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		//the system tick is empty; projectiles advance and collide in postGameLoopTick, after the shots fired by player input this frame
+		outDependencies.bThreadSafeTick = true;
+	}
+
 	void ProjectileSystem::initSystem()
 	{
 		//align projectiles with camera
@@ -292,56 +322,61 @@ namespace SA
 		forwardShaded_EmissiveModelShader = new_sp<SA::Shader>(forwardShadedModel_SimpleLighting_vertSrc, forwardShadedModel_Emissive_fragSrc, false);
 		deferedShaded_EmissiveModelShader = new_sp<SA::Shader>(gbufferShader_vs, gbufferShader_emissive_fs, false);
 
+		//#TODO lightColor uniform name is very specific to emissive shader; either need a callback to configure uniforms unique to projectile or move shader here
+		forwardShaded_EmissiveUniforms.model = forwardShaded_EmissiveModelShader->getUniformHandle<glm::mat4>("model");
+		forwardShaded_EmissiveUniforms.lightColor = forwardShaded_EmissiveModelShader->getUniformHandle<glm::vec3>("lightColor");
+		deferedShaded_EmissiveUniforms.model = deferedShaded_EmissiveModelShader->getUniformHandle<glm::mat4>("model");
+		deferedShaded_EmissiveUniforms.lightColor = deferedShaded_EmissiveModelShader->getUniformHandle<glm::vec3>("lightColor");
+
 		//have pools reserve underlying memory for estimates on how many we expect to be in pool concurrently
 		size_t estimateNumberConcurrentProjectiles = 300;
-		objPool.reserve(estimateNumberConcurrentProjectiles);
+		activeProjectiles.reserve(estimateNumberConcurrentProjectiles);
 		sfxPool.reserve(estimateNumberConcurrentProjectiles);
 		lightPool.reserve(estimateNumberConcurrentProjectiles);
 	}
 
-	void ProjectileSystem::spawnProjectile(const ProjectileSystem::SpawnData& spawnData, const ProjectileConfig& projectileTypeHandle)
+	ProjectileHandle ProjectileSystem::spawnProjectile(const ProjectileSystem::SpawnData& spawnData, const ProjectileConfig& projectileTypeHandle)
 	{
-		sp<Projectile> spawned = objPool.getInstance();
+		Projectile spawned;
 
 		//#optimize note there may some optimized functions in glm to do this work
 		glm::vec3 projectileSystemForward(0, 0, -1);
 		glm::quat spawnRotation = Utils::getRotationBetween(projectileSystemForward, spawnData.direction_n);
 
-		spawned->xform.rotQuat = spawnRotation;
-		spawned->xform.position = spawnData.start;
-		spawned->damage = spawnData.damage;
-		spawned->color = spawnData.color * (GameBase::get().getRenderSystem().isUsingHDR() ? 4.f : 1.f); //make color glow if using HDR //@hdr_tweak
-		spawned->team = spawnData.team;
-		spawned->owner = spawnData.owner;
-		spawned->direction_n = spawnData.direction_n;
-		spawned->renderXform = glm::scale(glm::mat4(1.f), { 0, 0, 0 });
-
-		spawned->bHit = false;
-		spawned->forceRelease = false;
-
-		spawned->distanceStretchScale = 1;
-		spawned->directionQuat = spawnRotation;
-
-		spawned->speed = projectileTypeHandle.getSpeed();
-		spawned->model = projectileTypeHandle.getModel();
-		spawned->lifetimeSec = projectileTypeHandle.getLifetimeSecs();
-		spawned->aabbSize = projectileTypeHandle.getAABBsize();
-
-		spawned->soundEmitter = spawnSfxEffect(spawnData.sfx, spawnData.start);
-		spawned->pointLight = spawnPointLight(spawnData);
-
-		spawned->bCorrectPosition = spawnData.traceStart.has_value();
-		spawned->traceStartPos = spawnData.traceStart.value_or(glm::vec3(0.f));
-		spawned->offsetTraceCorrectionDistance = 30.f; //hardcoded for now, perhaps should be tweakable per model as size of model may vary
-		spawned->offsetStartPos = spawned->xform.position;
+		spawned.damage = spawnData.damage;
+		spawned.color = spawnData.color * (GameBase::get().getRenderSystem().isUsingHDR() ? 4.f : 1.f); //make color glow if using HDR //@hdr_tweak
+		spawned.team = spawnData.team;
+		spawned.owner = spawnData.owner ? spawnData.owner->getLevelHandle() : SlotHandle{};
+		spawned.renderXform = glm::scale(glm::mat4(1.f), { 0, 0, 0 });
+
+		spawned.bHit = false;
+		spawned.forceRelease = false;
+
+		spawned.distanceStretchScale = 1;
+		spawned.directionQuat = spawnRotation;
+
+		spawned.model = projectileTypeHandle.getModel();
+		spawned.aabbSize = projectileTypeHandle.getAABBsize();
+
+		spawned.bCorrectPosition = spawnData.traceStart.has_value();
+		spawned.traceStartPos = spawnData.traceStart.value_or(glm::vec3(0.f));
+		spawned.offsetTraceCorrectionDistance = 30.f; //hardcoded for now, perhaps should be tweakable per model as size of model may vary
+		spawned.offsetStartPos = spawnData.start;
 		
-		spawned->timeAlive = 0.f;
 #if _WIN32 && _DEBUG
-		if (Utils::anyValueNAN(spawnRotation)) { __debugbreak(); return; }
-		if (Utils::anyValueNAN(spawnData.start)) { __debugbreak(); return; }
+		if (Utils::anyValueNAN(spawnRotation)) { __debugbreak(); return ProjectileHandle{}; }
+		if (Utils::anyValueNAN(spawnData.start)) { __debugbreak(); return ProjectileHandle{}; }
 #endif
+		spawned.soundEmitter = spawnSfxEffect(spawnData.sfx, spawnData.start);
+		spawned.pointLight = spawnPointLight(spawnData);
+
+		ProjectileStorage::SpawnValues hotValues;
+		hotValues.position = spawnData.start;
+		hotValues.direction_n = spawnData.direction_n;
+		hotValues.speed = projectileTypeHandle.getSpeed();
+		hotValues.lifetimeSec = projectileTypeHandle.getLifetimeSecs();
 
-		activeProjectiles.insert( spawned );
+		return activeProjectiles.add(hotValues, std::move(spawned));
 	}
 
 	void ProjectileSystem::unspawnAllProjectiles()
@@ -349,7 +384,7 @@ namespace SA
 		activeProjectiles.clear();
 	}
 
-	void ProjectileSystem::renderProjectiles(Shader& projectileShader) const
+	void ProjectileSystem::renderProjectiles(Shader& projectileShader, const ProjectileUniforms& uniforms) const
 	{
 		//#optimize potential optimization is to use instanced rendering to reduce draw call number
 		//#TODO perhaps projectile should be made a full class and encapsulate this logic
@@ -357,19 +392,20 @@ namespace SA
 		//#TODO refactor so instance rendered, set of uniforms can define instance
 
 		//invariant: shader uniforms pre-configured
-		for (const sp<Projectile>& projectile : activeProjectiles)
+		for (size_t denseIdx = 0; denseIdx < activeProjectiles.size(); ++denseIdx)
 		{
-			projectileShader.setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(projectile->renderXform));
-			projectileShader.setUniform3f("lightColor", projectile->color); //#TODO this uniform name is very specific to emissive shader; either need a callback to configure uniforms unique to projectile or move shader here; NOTE: this perf loss scales linearly, adding this one uniform drops fps by 0.1
-			projectile->model->draw(projectileShader, false); //not binding materials projectiles don't use materials and this is causing a gl error when attempting ot bind a normal map texture
+			const Projectile& projectile = activeProjectiles.getColdData(denseIdx);
+			projectileShader.setUniform(uniforms.model, projectile.renderXform);
+			projectileShader.setUniform(uniforms.lightColor, projectile.color);
+			projectile.model->draw(projectileShader, false); //not binding materials projectiles don't use materials and this is causing a gl error when attempting ot bind a normal map texture
 		}
 	}
 
 	void ProjectileSystem::renderProjectileBoundingBoxes(Shader& debugShader, const glm::vec3& color, const glm::mat4& view, const glm::mat4& perspective) const
 	{
-		for (const sp<Projectile>& projectile : activeProjectiles)
+		for (size_t denseIdx = 0; denseIdx < activeProjectiles.size(); ++denseIdx)
 		{
-			Utils::renderDebugWireCube(debugShader, color, projectile->collisionXform, view, perspective);
+			Utils::renderDebugWireCube(debugShader, color, activeProjectiles.getColdData(denseIdx).collisionXform, view, perspective);
 		}
 	}
 
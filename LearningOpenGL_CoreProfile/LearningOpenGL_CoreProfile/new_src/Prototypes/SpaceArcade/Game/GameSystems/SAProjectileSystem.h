@@ -7,11 +7,15 @@
 #include "../../GameFramework/SASystemBase.h"
 #include "../../Tools/ModelLoading/SAModel.h"
 #include "../../../../Algorithms/SeparatingAxisTheorem/SATComponent.h"
+#include "../../../../Algorithms/SpatialHashing/SpatialHashingComponent.h"
 #include "../../Tools/DataStructures/SATransform.h"
 #include "../../Tools/DataStructures/ObjectPools.h"
 #include "../AssetConfigs/SoundEffectSubConfig.h"
 #include <optional>
 #include "../../Rendering/Lights/PointLight_Deferred.h"
+#include "SAProjectileStore.h"
+#include "SAProjectileCollision.h"
+#include "../../Tools/DataStructures/SlotMap.h"
 
 namespace SA
 {
@@ -23,18 +27,20 @@ namespace SA
 	class PointLight_Deferred;
 
 	struct SoundEffectSubConfig;
+	struct Projectile;
+	using ProjectileStorage = ProjectileStore<Projectile>;
 
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	// Actual Projectile Instances; these system is responsible for creating these instances
 	//
+	// This is the cold per-projectile data. Position, direction, speed, and lifetime live in the
+	// system's ProjectileStore arrays and are advanced in one batch before the per-projectile pass.
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	struct Projectile
 	{
 		//#note When adding a field to this struct, make sure it is properly initialized in ProjectileSystem::spawnProjectile
 
-		Transform xform; 
-		glm::vec3 direction_n;
 		glm::vec3 hitLocation;
 		glm::vec3 aabbSize;
 		glm::vec3 color;
@@ -44,11 +50,8 @@ namespace SA
 		glm::mat4 collisionXform;
 		glm::mat4 renderXform;
 		float distanceStretchScale;
-		float speed;
-		float lifetimeSec;
-		float timeAlive;
 		float offsetTraceCorrectionDistance;
-		sp<WorldEntity> owner;
+		SlotHandle owner; //level handle of the entity that fired; does not keep it alive, resolve with findOwner
 		int damage;
 		size_t team;
 		bool forceRelease;
@@ -58,8 +61,20 @@ namespace SA
 		sp<AudioEmitter> soundEmitter = nullptr;
 		sp<PointLight_Deferred> pointLight = nullptr;
 
-		void tick(float dt_sec, LevelBase&);
-		void stretchToDistance(float distance, float bDoCollisionTest, LevelBase& currentLevel);
+		/** 
+		 * storage holds this projectile at denseIdx; its position there is expected to have already been advanced this frame.
+		 * Returns true if the projectile moved and its segment [outStart, position] should be collision tested.
+		 */
+		bool tick(size_t denseIdx, ProjectileStorage& storage, glm::vec3& outStart);
+
+		/** Stretches projectile from start over distance; returns the start actually used, which may be corrected towards the center trace */
+		glm::vec3 stretchToDistance(glm::vec3 start, float distance, size_t denseIdx, ProjectileStorage& storage);
+
+		/** Notifies the entity that was hit and shortens the projectile so it stops at the hit; projectile will be released next tick */
+		void applyHit(WorldEntity& hitEntity, float distanceToHitShape_2, const glm::vec3& start, size_t denseIdx, ProjectileStorage& storage);
+
+		/** The entity that fired this, or null if it has been unspawned since */
+		sp<WorldEntity> findOwner() const;
 	};
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -105,10 +120,19 @@ namespace SA
 			std::optional<glm::vec3> traceStart;
 			sp<WorldEntity> owner = nullptr;
 		};
-		void spawnProjectile(const SpawnData& spawnData, const ProjectileConfig& projectileTypeHandle);
+		ProjectileHandle spawnProjectile(const SpawnData& spawnData, const ProjectileConfig& projectileTypeHandle);
 		void unspawnAllProjectiles();
+		bool isProjectileActive(const ProjectileHandle& handle) const { return activeProjectiles.isAlive(handle); }
+		size_t getNumActiveProjectiles() const { return activeProjectiles.size(); }
+		const glm::vec3& getActiveProjectilePosition(size_t activeIdx) const { return activeProjectiles.getPosition(activeIdx); }
 
-		void renderProjectiles(Shader& projectileShader) const;
+		/** per-projectile uniforms; resolved once when the shader is created */
+		struct ProjectileUniforms
+		{
+			UniformHandle<glm::mat4> model;
+			UniformHandle<glm::vec3> lightColor;
+		};
+		void renderProjectiles(Shader& projectileShader, const ProjectileUniforms& uniforms) const;
 		void renderProjectileBoundingBoxes(Shader& debugShader, const glm::vec3& color, const glm::mat4& view, const glm::mat4& perspective) const;
 
 		sp<AudioEmitter> spawnSfxEffect(const SoundEffectSubConfig& sfx, glm::vec3 position);
@@ -117,22 +141,32 @@ namespace SA
 	private:
 		virtual void initSystem() override;
 		virtual void tick(float dt_sec) override {};
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 		void postGameLoopTick(float dt_sec);
 		void handlePostLevelChange(const sp<LevelBase>& previousLevel, const sp<LevelBase>& newCurrentLevel);
 		void handleRenderDispatch(float dtSec);
+		void collideProjectiles(LevelBase& currentLevel);
 
 	private:
 		bool bAutomaticTickProjectiles = true;
 		bool bEnableProjectilePointLights = true;
-		SP_SimpleObjectPool<Projectile> objPool;
 		SP_SimpleObjectPool_RestrictedConstruction<AudioEmitter> sfxPool;
 		SP_SimpleObjectPool_RestrictedConstruction<PointLight_Deferred> lightPool;
 
 		sp<Shader> forwardShaded_EmissiveModelShader;
 		sp<Shader> deferedShaded_EmissiveModelShader;
-
-		//this is not the most cache coherent design, but wanting to get working prototype before spending time on optimizations
-		//one potential cache friend optimization is to not use sp, and store in a large std::vector that does swap removes (with objects maintaing idices)
-		std::set<sp<Projectile>> activeProjectiles;
+		ProjectileUniforms forwardShaded_EmissiveUniforms;
+		ProjectileUniforms deferedShaded_EmissiveUniforms;
+
+		ProjectileStorage activeProjectiles;
+
+		//batched collision state; rebuilt every tick but kept as members so the buffers are reused
+		std::vector<glm::vec3> stretchStarts;		//per dense index; written by the parallel stretch pass
+		std::vector<uint8_t> stretchNeedsCollision;	//per dense index; uint8_t rather than vector<bool> so jobs can write neighbours
+		std::vector<size_t> pendingCollisions;		//dense index of each projectile; parallel to collisionSegments
+		std::vector<SH::LineSegment> collisionSegments;
+		std::vector<ProjectileCollisionQuery<WorldEntity>> collisionQueries; //parallel to collisionSegments
+		std::vector<SH::LineSegmentCandidate<WorldEntity>> collisionCandidates;
+		std::vector<up<SAT::CubeShape>> projectileShapes;		//one per pending collision; transformed once per tick
 	};
 }
@@ -51,7 +51,8 @@ namespace SA
 		//make sure we have cleaned up the old context and have nullptr within the imguiBoundWindow
 		assert(imguiBoundWindow.expired());
 
-		if (window)
+		//imgui's backend needs a glfw window; headless windows have none, so there is no editor ui
+		if (window && window->get())
 		{
 			//set up IMGUI
 			IMGUI_CHECKVERSION();
@@ -177,7 +177,7 @@ namespace SA
 		//since camera ticking is over, it isn't going to move. Shoot a ray and see if we hit anything in hitest grid... if we're in cursor mode.
 		const sp<Window>& window = GameBase::get().getWindowSystem().getPrimaryWindow();
 		const sp<PlayerBase>& player = GameBase::get().getPlayerSystem().getPlayer(0);
-		if (window && player)
+		if (window && window->get() && player)
 		{
 			const sp<CameraBase>& camera = player->getCamera();
 			if (camera && camera->isInCursorMode())
@@ -291,16 +291,15 @@ namespace SA
 						{
 							BehaviorTreeBrain* aBrain = dynamic_cast<BehaviorTreeBrain*>(aBrainComp->getBrain());
 							BehaviorTreeBrain* bBrain = dynamic_cast<BehaviorTreeBrain*>(bBrainComp->getBrain());
-							if (aBrain && bBrain)
+							BehaviorTree::Memory* aMem = aBrain ? aBrain->getTreeMemory() : nullptr;
+							BehaviorTree::Memory* bMem = bBrain ? bBrain->getTreeMemory() : nullptr;
+							if (aMem && bMem)
 							{
-								BehaviorTree::Memory& aMem = aBrain->getBehaviorTree().getMemory();
-								BehaviorTree::Memory& bMem = bBrain->getBehaviorTree().getMemory();
-
 								sp<WorldEntity> aWE = a;
 								sp<WorldEntity> bWE = b;
 
-								WorldEntity* bAsTarget = aMem.replaceValue("target", bWE);
-								WorldEntity* aAsTarget = bMem.replaceValue("target", aWE);
+								WorldEntity* bAsTarget = aMem->replaceValue("target", bWE);
+								WorldEntity* aAsTarget = bMem->replaceValue("target", aWE);
 							}
 						}
 					}
@@ -38,6 +38,7 @@
 #include "../AI/GlobalSpaceArcadeBehaviorTreeKeys.h"
 #include "../AI/SAShipBehaviorTreeNodes.h"
 #include "../../GameFramework/RenderModelEntity.h"
+#include "../../GameFramework/Components/CollisionComponent.h"
 #include "../../GameFramework/SAWorldEntity.h"
 #include "../Cameras/SAShipCamera.h"
 #include "../Environment/Nebula.h"
@@ -668,6 +669,9 @@ namespace SA
 
 		applyLevelConfig();
 
+		//ships move during their GAME tick; the group's event fires after every ship has moved, so collisions see this frame's positions
+		getWorldTimeManager()->getEvent(TickGroups::get().GAME).addWeakObj(sp_this(), &SpaceLevelBase::tickShipCollisions);
+
 		enableStarJump(true, true); //skip to being in middle of star jump vfx
 
 		static bool bFirstLevelStarted = false; //don't show VFX on first level (ie main menu)
@@ -693,12 +697,15 @@ namespace SA
 		forwardShadedModelShader = nullptr;
 		highlightForwardModelShader = nullptr;
 
+		getWorldTimeManager()->getEvent(TickGroups::get().GAME).removeWeak(sp_this(), &SpaceLevelBase::tickShipCollisions);
+
 		LevelBase::endLevel_v();
 	}
 
 	void SpaceLevelBase::postConstruct()
 	{
 		createTypedGrid<AvoidanceSphere>(glm::vec3(128));
+		onUnspawningEntity.addWeakObj(sp_this(), &SpaceLevelBase::handleUnspawningEntity);
 
 		stencilHighlightEntities.reserve(6);
 		
@@ -736,6 +743,45 @@ namespace SA
 		}
 	}
 
+	void SpaceLevelBase::tickShipCollisions(float dt_sec)
+	{
+		if (getWorldTimeManager()->isTimeFrozen()) { return; } //ships do not move while frozen, see Ship::tickShip
+
+		//one broadphase sweep for the whole grid rather than a cell lookup per ship
+		getWorldGrid().findAllOverlappingPairs(overlappingPairs);
+
+		auto resolveShip = [this](WorldEntity* self, WorldEntity* other)
+		{
+			if (Ship* ship = dynamic_cast<Ship*>(self))
+			{
+				CollisionComponent* otherCollisionComp = other->getGameComponent<CollisionComponent>();
+				if (otherCollisionComp && otherCollisionComp->requestsCollisionChecks())
+				{
+					if (CollisionData* otherCollisionData = otherCollisionComp->getCollisionData())
+					{
+						if (ship->resolveCollisionWith(*otherCollisionData))
+						{
+							collidedShips.push_back(ship);
+						}
+					}
+				}
+			}
+		};
+
+		collidedShips.clear();
+		for (const std::pair<WorldEntity*, WorldEntity*>& pair : overlappingPairs)
+		{
+			resolveShip(pair.first, pair.second);
+			resolveShip(pair.second, pair.first);
+		}
+
+		//responses broadcast events, so apply them only after every pair has been resolved
+		for (Ship* ship : collidedShips)
+		{
+			ship->applyCollisionResponse();
+		}
+	}
+
 	sp<SA::ServerGameMode_Base> SpaceLevelBase::onServerCreateGameMode()
 	{
 		if (levelConfig)
@@ -776,6 +822,41 @@ namespace SA
 		}
 	}
 
+	void SpaceLevelBase::handleUnspawningEntity(const sp<WorldEntity>& entity)
+	{
+		bTargetIndexStale = true;
+	}
+
+	const TeamTargetIndex<WorldEntity>& SpaceLevelBase::getTargetIndex()
+	{
+		const uint64_t currentFrame = GameBase::get().getFrameNumber();
+		if (bTargetIndexStale || targetIndexFrame != currentFrame)
+		{
+			targetIndex.clear();
+			for (const sp<WorldEntity>& entity : worldEntities)
+			{
+				if (const TeamComponent* teamComp = entity->getGameComponent<TeamComponent>())
+				{
+					uint8_t flags = TargetFlags::NONE;
+					if (entity->getGameComponent<HitPointComponent>() && !entity->isPendingDestroy())
+					{
+						flags |= TargetFlags::ATTACKABLE;
+					}
+					if (const Ship* ship = dynamic_cast<const Ship*>(entity.get()); ship && ship->isCarrierShip())
+					{
+						flags |= TargetFlags::CARRIER;
+					}
+					targetIndex.add(*entity, entity->getWorldPosition(), teamComp->getTeam(), flags);
+				}
+			}
+			targetIndex.build();
+
+			targetIndexFrame = currentFrame;
+			bTargetIndexStale = false;
+		}
+		return targetIndex;
+	}
+
 	sp<SA::StarField> SpaceLevelBase::onCreateStarField()
 	{
 		//by default generate a star field, if no star field should be in the level return null in an override;
@@ -5,6 +5,7 @@
 
 #include "../Environment/Planet.h" //included for init data... probably should be refactored so we can forward declare
 #include "../../GameFramework/EngineCompileTimeFlagsAndMacros.h"
+#include "../../Tools/DataStructures/TeamTargetIndex.h"
 
 namespace SA
 {
@@ -17,6 +18,7 @@ namespace SA
 	//class Planet; //included for now so that we can functionify the init data part that takes Planet::Data (For space level editor)
 	//struct Planet::Data;
 	class SpaceLevelConfig;
+	class Ship;
 	class ServerGameMode_SpaceBase;
 	class RNG;
 	struct PlanetData;
@@ -33,6 +35,8 @@ namespace SA
 	public:
 		virtual void render(float dt_sec, const glm::mat4& view, const glm::mat4& projection) override;
 		TeamCommander* getTeamCommander(size_t teamIdx);
+		/** Every entity with a team, indexed by team for enemy searches. Rebuilt at most once a frame, on first use. */
+		const TeamTargetIndex<WorldEntity>& getTargetIndex();
 		virtual void setConfig(const sp<const SpaceLevelConfig>& config);
 		const sp<const SpaceLevelConfig>& getConfig() const { return levelConfig; }
 		const sp<RNG>& getGenerationRNG() { return generationRNG; } //non-const as user is likely about to modify state of RNG
@@ -61,6 +65,8 @@ namespace SA
 		virtual sp<ServerGameMode_Base> onServerCreateGameMode() override;
 		virtual void onEntitySpawned_v(const sp<WorldEntity>& spawned) override;
 		void handleEntityDestroyed(const sp<GameEntity>& entity);
+		void handleUnspawningEntity(const sp<WorldEntity>& entity);
+		void tickShipCollisions(float dt_sec);
 	protected:
 		//#TODO this will need to be read from a saved config file or something instead. Same for local stars.
 		virtual void onCreateLocalPlanets() {};
@@ -97,7 +103,12 @@ namespace SA
 		sp<RNG> generationRNG = nullptr;
 	private: //fields
 		std::vector<sp<TeamCommander>> commanders;
+		TeamTargetIndex<WorldEntity> targetIndex;
+		uint64_t targetIndexFrame = 0;
+		bool bTargetIndexStale = true; //set when an entity leaves the level, as the index holds raw pointers
 		sp<const SpaceLevelConfig> levelConfig = nullptr;
+		std::vector<std::pair<WorldEntity*, WorldEntity*>> overlappingPairs; //reused each frame by the ship collision pass
+		std::vector<Ship*> collidedShips;
 	private: //debug
 		std::optional<bool> useNormalMappingOverride;
 		std::optional<bool> useNormalMappingMirrorCorrectionOverride;
@@ -0,0 +1,368 @@
+#include "StressTestBenchmark.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm.hpp>
+
+#include "StressTestLevel.h"
+#include "../SpaceArcade.h"
+#include "../AssetConfigs/JsonUtils.h"
+#include "../GameSystems/SAProjectileSystem.h"
+#include "../SAShip.h"
+#include "../../Tools/DataStructures/SATransform.h"
+#include "../../GameFramework/SALevelSystem.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+	bool readFile(const std::string& path, std::string& outText)
+	{
+		std::ifstream inFile(path);
+		if (!inFile.is_open())
+		{
+			return false;
+		}
+		std::stringstream buffer;
+		buffer << inFile.rdbuf();
+		outText = buffer.str();
+		return true;
+	}
+
+	/** FNV-1a; exact bits, so any divergence between runs shows up */
+	uint64_t hashBytes(const void* data, size_t numBytes)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t idx = 0; idx < numBytes; ++idx)
+		{
+			hash ^= bytes[idx];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	/** quoted for std::system; cmd strips the outer pair of quotes from the whole line, so windows gets an extra pair */
+	std::string makeBenchmarkCommand(const std::string& executablePath, const std::string& scenarioPath, const std::string& reportPath)
+	{
+		std::string command = "\"" + executablePath + "\" --headless-benchmark \"" + scenarioPath + "\" \"" + reportPath + "\"";
+#ifdef _WIN32
+		command = "\"" + command + "\"";
+#endif
+		return command;
+	}
+}
+
+namespace SA
+{
+	uint32_t StressTestScenario::getNumFrames() const
+	{
+		return fixedDeltaSec > 0.f ? uint32_t(std::ceil(durationSec / fixedDeltaSec - 1e-4f)) : 0;
+	}
+
+	std::string StressTestScenario::toJson() const
+	{
+		json outData;
+		JSON_WRITE(name, outData);
+		JSON_WRITE(numShips, outData);
+		JSON_WRITE(numTeams, outData);
+		JSON_WRITE(durationSec, outData);
+		JSON_WRITE(fixedDeltaSec, outData);
+		JSON_WRITE(seed, outData);
+		JSON_WRITE(teamSeparation, outData);
+		JSON_WRITE(spawnSpread, outData);
+		JSON_WRITE(bSpawnCarriers, outData);
+		JSON_WRITE(shipBrain, outData);
+		JSON_WRITE(projectilesPerShipPerSec, outData);
+		JSON_WRITE(numWorkerThreads, outData);
+		JSON_WRITE(bDeterministicJobs, outData);
+		return outData.dump(4);
+	}
+
+	bool StressTestScenario::fromJson(const std::string& jsonText)
+	{
+		const json inData = json::parse(jsonText, nullptr, /*allow_exceptions*/ false);
+		if (inData.is_discarded() || !inData.is_object())
+		{
+			return false;
+		}
+
+		//floats must be written with a decimal point (eg 10.0) to be read
+		READ_JSON_STRING_OPTIONAL(name, inData);
+		READ_JSON_INT_OPTIONAL(numShips, inData);
+		READ_JSON_INT_OPTIONAL(numTeams, inData);
+		READ_JSON_FLOAT_OPTIONAL(durationSec, inData);
+		READ_JSON_FLOAT_OPTIONAL(fixedDeltaSec, inData);
+		READ_JSON_INT_OPTIONAL(seed, inData);
+		READ_JSON_FLOAT_OPTIONAL(teamSeparation, inData);
+		READ_JSON_FLOAT_OPTIONAL(spawnSpread, inData);
+		READ_JSON_BOOL_OPTIONAL(bSpawnCarriers, inData);
+		READ_JSON_STRING_OPTIONAL(shipBrain, inData);
+		READ_JSON_FLOAT_OPTIONAL(projectilesPerShipPerSec, inData);
+		READ_JSON_INT_OPTIONAL(numWorkerThreads, inData);
+		READ_JSON_BOOL_OPTIONAL(bDeterministicJobs, inData);
+		return true;
+	}
+
+	double StressTestPhaseTiming::percentile(double fraction) const
+	{
+		if (frameMs.empty())
+		{
+			return 0.0;
+		}
+
+		//nearest rank
+		std::vector<double> sorted = frameMs;
+		std::sort(sorted.begin(), sorted.end());
+		const double rank = std::ceil(glm::clamp(fraction, 0.0, 1.0) * sorted.size());
+		const size_t idx = size_t(std::max(rank, 1.0)) - 1;
+		return sorted[std::min(idx, sorted.size() - 1)];
+	}
+
+	double StressTestPhaseTiming::mean() const
+	{
+		if (frameMs.empty())
+		{
+			return 0.0;
+		}
+
+		double total = 0.0;
+		for (double ms : frameMs) { total += ms; }
+		return total / frameMs.size();
+	}
+
+	const StressTestPhaseTiming* StressTestReport::findPhase(const std::string& phaseName) const
+	{
+		for (const StressTestPhaseTiming& phase : phases)
+		{
+			if (phase.name == phaseName)
+			{
+				return &phase;
+			}
+		}
+		return nullptr;
+	}
+
+	std::string StressTestReport::toJson() const
+	{
+		json phaseArray = json::array();
+		for (const StressTestPhaseTiming& phase : phases)
+		{
+			phaseArray.push_back({
+				{"name", phase.name},
+				{"p50_ms", phase.percentile(0.5)},
+				{"p90_ms", phase.percentile(0.9)},
+				{"p99_ms", phase.percentile(0.99)},
+				{"max_ms", phase.percentile(1.0)},
+				{"mean_ms", phase.mean()},
+			});
+		}
+
+		json outData = {
+			{"scenario", scenarioName},
+			{"numFrames", numFrames},
+			{"phases", phaseArray},
+			{"results", {
+					{"peakProjectiles", peakProjectiles},
+					{"shipsAtEnd", shipsAtEnd},
+					{"projectilesAtEnd", projectilesAtEnd},
+					{"endStateHash", endStateHash},
+				}
+			}
+		};
+		return outData.dump(4);
+	}
+
+	bool StressTestReport::readResultsJson(const std::string& jsonText)
+	{
+		const json inData = json::parse(jsonText, nullptr, /*allow_exceptions*/ false);
+		if (inData.is_discarded() || !inData.is_object()
+			|| !inData.contains("scenario") || !inData.contains("numFrames") || !inData.contains("results"))
+		{
+			return false;
+		}
+
+		const json& results = inData["results"];
+		if (!results.is_object() || !results.contains("peakProjectiles") || !results.contains("shipsAtEnd")
+			|| !results.contains("projectilesAtEnd") || !results.contains("endStateHash"))
+		{
+			return false;
+		}
+
+		scenarioName = inData["scenario"].get<std::string>();
+		numFrames = inData["numFrames"].get<uint32_t>();
+		peakProjectiles = results["peakProjectiles"].get<size_t>();
+		shipsAtEnd = results["shipsAtEnd"].get<size_t>();
+		projectilesAtEnd = results["projectilesAtEnd"].get<size_t>();
+		endStateHash = results["endStateHash"].get<uint64_t>();
+		return true;
+	}
+
+	bool StressTestReport::sameEndState(const StressTestReport& other) const
+	{
+		return scenarioName == other.scenarioName
+			&& numFrames == other.numFrames
+			&& peakProjectiles == other.peakProjectiles
+			&& shipsAtEnd == other.shipsAtEnd
+			&& projectilesAtEnd == other.projectilesAtEnd
+			&& endStateHash == other.endStateHash;
+	}
+
+	void StressTestBenchmark::begin()
+	{
+		report = StressTestReport{};
+		report.scenarioName = scenario.name;
+		bFinished = false;
+
+		TickProfiler::setActive(&profiler);
+		GameBase::get().onFrameOver.addWeakObj(sp_this(), &StressTestBenchmark::handleFrameOver);
+	}
+
+	void StressTestBenchmark::handleFrameOver(uint64_t endingFrameNumber)
+	{
+		if (bFinished)
+		{
+			return; //the engine ticks a few more frames while shutting down
+		}
+
+		profiler.endFrame();
+		if (const sp<ProjectileSystem>& projectileSystem = SpaceArcade::get().getProjectileSystem())
+		{
+			report.peakProjectiles = std::max(report.peakProjectiles, projectileSystem->getNumActiveProjectiles());
+		}
+
+		if (profiler.getNumFrames() >= scenario.getNumFrames())
+		{
+			finish();
+		}
+	}
+
+	void StressTestBenchmark::finish()
+	{
+		TickProfiler::setActive(nullptr);
+		bFinished = true;
+
+		report.numFrames = uint32_t(profiler.getNumFrames());
+		report.phases.clear();
+		for (const TickProfiler::Timing& timing : profiler.getTimings())
+		{
+			report.phases.push_back(StressTestPhaseTiming{ timing.label, timing.frameMs });
+		}
+
+		captureEndState();
+
+		GameBase::get().startShutdown();
+	}
+
+	void StressTestBenchmark::captureEndState()
+	{
+		//per entity hashes are summed so the result does not depend on iteration order
+		uint64_t hash = 0;
+		if (StressTestLevel* level = dynamic_cast<StressTestLevel*>(GameBase::get().getLevelSystem().getCurrentLevel().get()))
+		{
+			report.shipsAtEnd = level->getNumSpawnedShips();
+			for (const sp<Ship>& ship : level->getSpawnedShips())
+			{
+				const Transform& xform = ship->getTransform();
+				hash += hashBytes(&xform.position, sizeof(xform.position)) ^ hashBytes(&xform.rotQuat, sizeof(xform.rotQuat));
+			}
+		}
+
+		if (const sp<ProjectileSystem>& projectileSystem = SpaceArcade::get().getProjectileSystem())
+		{
+			report.projectilesAtEnd = projectileSystem->getNumActiveProjectiles();
+			for (size_t projectileIdx = 0; projectileIdx < report.projectilesAtEnd; ++projectileIdx)
+			{
+				const glm::vec3& position = projectileSystem->getActiveProjectilePosition(projectileIdx);
+				hash += hashBytes(&position, sizeof(position));
+			}
+		}
+		report.endStateHash = hash;
+	}
+
+	int runStressTestBenchmarkFromFiles(const std::string& scenarioPath, const std::string& reportPath)
+	{
+		std::string scenarioText;
+		if (!readFile(scenarioPath, scenarioText))
+		{
+			std::cerr << "headless benchmark: could not open scenario " << scenarioPath << std::endl;
+			return 1;
+		}
+
+		StressTestScenario scenario;
+		if (!scenario.fromJson(scenarioText))
+		{
+			std::cerr << "headless benchmark: scenario is not a json object " << scenarioPath << std::endl;
+			return 1;
+		}
+
+		std::cout << "headless benchmark: " << scenario.name << ", " << scenario.numShips << " ships, " << scenario.getNumFrames() << " frames" << std::endl;
+
+		//runs the real game; start() returns once the benchmark has shut it down
+		sp<StressTestBenchmark> benchmark = new_sp<StressTestBenchmark>(scenario);
+		SpaceArcade& game = SpaceArcade::get();
+		game.setHeadlessBenchmark(benchmark);
+		game.start();
+
+		if (!benchmark->isFinished())
+		{
+			std::cerr << "headless benchmark: game exited before the scenario finished" << std::endl;
+			return 1;
+		}
+		const StressTestReport& report = benchmark->getReport();
+		const std::string reportText = report.toJson();
+
+		if (reportPath.empty())
+		{
+			std::cout << reportText << std::endl;
+			return 0;
+		}
+
+		std::ofstream outFile(reportPath);
+		if (!outFile.is_open())
+		{
+			std::cerr << "headless benchmark: could not write report " << reportPath << std::endl;
+			return 1;
+		}
+		outFile << reportText << std::endl;
+		std::cout << "headless benchmark: wrote " << reportPath << std::endl;
+		return 0;
+	}
+
+	int runStressTestRepeatabilityCheck(const std::string& executablePath, const std::string& scenarioPath, const std::string& reportPath)
+	{
+		const std::string repeatReportPath = reportPath + ".repeat.json";
+
+		StressTestReport runs[2];
+		const std::string runReportPaths[2] = { reportPath, repeatReportPath };
+		for (size_t runIdx = 0; runIdx < 2; ++runIdx)
+		{
+			std::cout << "headless benchmark repeat: run " << (runIdx + 1) << " of 2" << std::endl;
+			if (std::system(makeBenchmarkCommand(executablePath, scenarioPath, runReportPaths[runIdx]).c_str()) != 0)
+			{
+				std::cerr << "headless benchmark repeat: run " << (runIdx + 1) << " failed" << std::endl;
+				return 1;
+			}
+
+			std::string reportText;
+			if (!readFile(runReportPaths[runIdx], reportText) || !runs[runIdx].readResultsJson(reportText))
+			{
+				std::cerr << "headless benchmark repeat: could not read report " << runReportPaths[runIdx] << std::endl;
+				return 1;
+			}
+		}
+
+		if (!runs[0].sameEndState(runs[1]))
+		{
+			std::cerr << "headless benchmark repeat: end state differs between runs; compare " << reportPath << " and " << repeatReportPath << std::endl;
+			return 1;
+		}
+		std::cout << "headless benchmark repeat: end state matches, hash " << runs[0].endStateHash << std::endl;
+		return 0;
+	}
+}
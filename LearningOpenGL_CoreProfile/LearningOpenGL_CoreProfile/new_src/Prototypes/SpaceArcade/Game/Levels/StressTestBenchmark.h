@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../../GameFramework/SAGameEntity.h"
+#include "../../GameFramework/SATickProfiler.h"
+
+namespace SA
+{
+	/** Scripted replacement for StressTestLevel's imgui sliders. Read from json; fields left out keep these defaults. */
+	struct StressTestScenario
+	{
+		std::string name = "default";
+		uint32_t numShips = 500;
+		uint32_t numTeams = 2;
+		float durationSec = 10.f;
+		float fixedDeltaSec = 1.f / 60.f;
+		uint32_t seed = 28; //seeds the spawn positions and the rng system's root generators, which every ship and ai node draws from
+
+		//teams start around points spaced evenly on a circle of this radius, at their carriers
+		float teamSeparation = 150.f;
+		float spawnSpread = 50.f;
+		bool bSpawnCarriers = true;
+
+		/** "fighter" dogfights with the game's behavior tree, "continuousFire" fires straight ahead at projectilesPerShipPerSec, anything else wanders */
+		std::string shipBrain = "fighter";
+		float projectilesPerShipPerSec = 1.f;
+
+		int32_t numWorkerThreads = -1; //negative uses every hardware thread besides the game thread, like EngineConstants
+
+		/** Runs jobs inline in submission order so the end state repeats run to run; turn off to time the parallel ticks. */
+		bool bDeterministicJobs = true;
+
+		uint32_t getNumFrames() const;
+
+		std::string toJson() const;
+		/** Returns false if the text is not a json object; unknown fields are ignored. */
+		bool fromJson(const std::string& jsonText);
+	};
+
+	/** Timing for a single part of the frame, in milliseconds. */
+	struct StressTestPhaseTiming
+	{
+		std::string name;
+		std::vector<double> frameMs;
+
+		double percentile(double fraction) const;
+		double mean() const;
+	};
+
+	struct StressTestReport
+	{
+		std::string scenarioName;
+		uint32_t numFrames = 0;
+
+		/** One entry per TickProfiler scope, eg "Frame", "TimeSystem" (ai and ship ticks), each system's tick by class name,
+			"Gameloop", "ProjectileSystem", "ProjectileCollision", "ParticleSystem" and "Render". Nested scopes are also counted in their parents. */
+		std::vector<StressTestPhaseTiming> phases;
+
+		size_t peakProjectiles = 0;
+		size_t shipsAtEnd = 0;
+		size_t projectilesAtEnd = 0;
+		uint64_t endStateHash = 0; //ship transforms and projectile positions on the last frame; equal between repeated runs of a scenario
+
+		const StressTestPhaseTiming* findPhase(const std::string& phaseName) const;
+		std::string toJson() const;
+
+		/** Reads the scenario name, frame count and results back from toJson's output; timings are not read. */
+		bool readResultsJson(const std::string& jsonText);
+		bool sameEndState(const StressTestReport& other) const;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Headless StressTestLevel run for build machines without a GPU or display.
+	//
+	// SpaceArcade starts as usual, but on a null window that never touches glfw (gl calls go to NullOpenGL), stepping
+	// the scenario's fixed delta time with no framerate limit, and loads a StressTestLevel configured by the scenario.
+	// From the first frame after the level starts, the real system ticks are timed with a TickProfiler; after the
+	// scenario's number of frames the game shuts down and the report is ready.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class StressTestBenchmark : public GameEntity
+	{
+	public:
+		StressTestBenchmark(const StressTestScenario& scenario) : scenario(scenario) {}
+
+		const StressTestScenario& getScenario() const { return scenario; }
+		const StressTestReport& getReport() const { return report; }
+		bool isFinished() const { return bFinished; }
+
+		/** Starts profiling; called once the benchmark level has started. */
+		void begin();
+
+	private:
+		void handleFrameOver(uint64_t endingFrameNumber);
+		void finish();
+		void captureEndState();
+
+	private:
+		StressTestScenario scenario;
+		StressTestReport report;
+		TickProfiler profiler;
+		bool bFinished = false;
+	};
+
+	/** Entry point for `SpaceArcade --headless-benchmark <scenario.json> [report.json]`; returns the process exit code. */
+	int runStressTestBenchmarkFromFiles(const std::string& scenarioPath, const std::string& reportPath);
+
+	/** 
+		Entry point for `SpaceArcade --headless-benchmark-repeat <scenario.json> <report.json>`. Runs the benchmark twice as
+		separate processes (the game is a singleton), writing <report.json> and <report.json>.repeat.json, and fails if the 
+		end states differ.
+	*/
+	int runStressTestRepeatabilityCheck(const std::string& executablePath, const std::string& scenarioPath, const std::string& reportPath);
+}
@@ -2,6 +2,8 @@
 
 #include <random>
 #include <memory>
+#include <algorithm>
+#include <gtc/constants.hpp>
 #include "../../../../../Libraries/imgui.1.69.gl/imgui.h"
 
 #include "../SpaceArcade.h"
@@ -112,7 +114,20 @@ namespace SA
 			log("StressTestLevel", LogLevel::LOG_ERROR, "Default Spawn Configs not available.");
 		}
 
-		glm::vec3 carrierPosition_teamA = { 0,0, 150 };
+		//a benchmark scenario replaces the hard-coded interactive setup
+		const uint32_t numTeams = benchmarkScenario ? std::max<uint32_t>(benchmarkScenario->numTeams, 1) : 2;
+		const float teamDistance = benchmarkScenario ? benchmarkScenario->teamSeparation : 150.f;
+		const bool bSpawnCarriers = benchmarkScenario ? benchmarkScenario->bSpawnCarriers : true;
+
+		//teams are evenly spaced on a circle; with two teams the carriers are separated along the z axis
+		std::vector<float> teamAngles;
+		std::vector<glm::vec3> teamOrigins;
+		for (uint32_t teamIdx = 0; teamIdx < numTeams; ++teamIdx)
+		{
+			const float teamAngle = 2.f * glm::pi<float>() * teamIdx / numTeams + glm::half_pi<float>();
+			teamAngles.push_back(teamAngle);
+			teamOrigins.push_back(glm::vec3(std::cos(teamAngle), 0.f, std::sin(teamAngle)) * teamDistance);
+		}
 		//glm::vec3 carrierPosition_teamA = { 0,0, 30 }; //testing dogfight
 
 		if (const sp<PlayerBase>& player = game.getPlayerSystem().getPlayer(0))
@@ -121,19 +136,13 @@ namespace SA
 			camera->setFar(1000.f);
 
 			//camera->setPosition(glm::vec3(-300, 0, 0.f));
-			camera->setPosition(carrierPosition_teamA + glm::vec3(15, 20, 20));
+			camera->setPosition(teamOrigins[0] + glm::vec3(15, 20, 20));
 			camera->lookAt_v(camera->getPosition() + glm::vec3(0,0,-1)); //carriers are currently separated along the z axis; so look down that axis
 		}
 
 		////////////////////////////////////////////////////////
 		// Carriers
 		////////////////////////////////////////////////////////
-		constexpr bool bSpawnCarriers = true;
-		Transform carrierXform_TeamA;
-		carrierXform_TeamA.position = carrierPosition_teamA;
-		carrierXform_TeamA.rotQuat = glm::angleAxis(glm::radians(-33.0f), normalize(glm::vec3(0, 1, 0)));
-		//carrierXform_TeamA.rotQuat = glm::angleAxis(glm::radians(-47.0f), normalize(glm::vec3(1, 1, 0)));
-
 		auto disableAutoSpawn = [](const sp<Ship>& carrier)
 		{
 			if (carrier)
@@ -147,34 +156,34 @@ namespace SA
 			}
 		};
 
-		Ship::SpawnData carrierSpawnData_A;
-		carrierSpawnData_A.team = 0;
-		carrierSpawnData_A.spawnConfig = carrierSpawnConfig;
-		carrierSpawnData_A.spawnTransform = carrierXform_TeamA;
-		sp<Ship> carrierShip_TeamA = bSpawnCarriers ? spawnEntity<Ship>(carrierSpawnData_A) : nullptr;
-		disableAutoSpawn(carrierShip_TeamA);
-
-
-		//#TODO #BUG passing same carrier spawn data shouldn't influence the other ships that were spawned. copying spawn data.
-		Ship::SpawnData carrierSpawnData_B = carrierSpawnData_A;
-		Transform carrierXform_TeamB = carrierXform_TeamA;
-		carrierXform_TeamB.position.z = -carrierXform_TeamB.position.z;
-		carrierXform_TeamB.rotQuat = glm::angleAxis(glm::radians(-13.0f), glm::vec3(0, 1, 0));
-		carrierSpawnData_B.spawnTransform = carrierXform_TeamB;
-		carrierSpawnData_B.team = 1;
-		//sp<Ship> carrierShip2 = spawnEntity<Ship>(carrierModel, carrierXform_TeamB, createUnitCubeCollisionInfo());
-		sp<Ship> carrierShip_TeamB = bSpawnCarriers ? spawnEntity<Ship>(carrierSpawnData_B) : nullptr;
-		disableAutoSpawn(carrierShip_TeamB);
+		const glm::quat carrierRotations[] = {
+			glm::angleAxis(glm::radians(-33.0f), normalize(glm::vec3(0, 1, 0))),
+			glm::angleAxis(glm::radians(-13.0f), glm::vec3(0, 1, 0))
+		};
+		//carrierXform_TeamA.rotQuat = glm::angleAxis(glm::radians(-47.0f), normalize(glm::vec3(1, 1, 0)));
+
+		for (uint32_t teamIdx = 0; bSpawnCarriers && teamIdx < numTeams; ++teamIdx)
+		{
+			Ship::SpawnData carrierSpawnData;
+			carrierSpawnData.team = teamIdx;
+			carrierSpawnData.spawnConfig = carrierSpawnConfig;
+			carrierSpawnData.spawnTransform.position = teamOrigins[teamIdx];
+
+			//teams past the first two face the center
+			carrierSpawnData.spawnTransform.rotQuat = teamIdx < 2 ? carrierRotations[teamIdx] : glm::angleAxis(glm::half_pi<float>() - teamAngles[teamIdx], glm::vec3(0, 1, 0));
+			disableAutoSpawn(spawnEntity<Ship>(carrierSpawnData));
+		}
 
 		////////////////////////////////////////////////////////
 		// fighters
 		////////////////////////////////////////////////////////
 		particleSpawnOffset = glm::vec3(0,0,0);
 
-		std::random_device rng;
-		std::seed_seq seed{ 28 };
+		const float spawnSpread = benchmarkScenario ? benchmarkScenario->spawnSpread : 50.f;
+		std::seed_seq seed{ benchmarkScenario ? benchmarkScenario->seed : 28u };
 		std::mt19937 rng_eng = std::mt19937(seed);
-		std::uniform_real_distribution<float> startDist(-50.f, 50.f); //[a, b)
+		std::uniform_real_distribution<float> startDist(-spawnSpread, spawnSpread); //[a, b)
+		std::uniform_real_distribution<float> rotationDist(-50.f, 50.f); //angle is a little adhoc, but with radians it should cover full 360 possibilities
 
 		uint32_t numFighterShipsToSpawn = 5000;
 #ifdef _DEBUG
@@ -185,14 +194,12 @@ namespace SA
 		//numFighterShipsToSpawn = 4;
 		numFighterShipsToSpawn = 2;
 #endif//NDEBUG 
+		if (benchmarkScenario)
+		{
+			numFighterShipsToSpawn = benchmarkScenario->numShips;
+		}
 
-		uint32_t numTeams = 2;
-		uint32_t numFightersPerTeam = numFighterShipsToSpawn / numTeams;
-
-		std::vector< std::vector<sp<Ship>> > teamTargets = {
-			std::vector<sp<Ship>>{},
-			std::vector<sp<Ship>>{}
-		};
+		std::vector< std::vector<sp<Ship>> > teamTargets(numTeams);
 
 		auto spawnFighters = [&](size_t teamIdx, glm::vec3 teamSpawnOrigin) 
 		{
@@ -200,10 +207,12 @@ namespace SA
 			fighterShipSpawnData.team = teamIdx;
 			fighterShipSpawnData.spawnConfig = fighterSpawnConfig;
 
-			for (uint32_t fighterShip = 0; fighterShip < numFightersPerTeam; ++fighterShip)
+			//any remainder goes to the first teams
+			const uint32_t numFightersInTeam = numFighterShipsToSpawn / numTeams + (teamIdx < numFighterShipsToSpawn % numTeams ? 1 : 0);
+			for (uint32_t fighterShip = 0; fighterShip < numFightersInTeam; ++fighterShip)
 			{ 
 				glm::vec3 startPos(startDist(rng_eng), startDist(rng_eng), startDist(rng_eng));
-				glm::quat rot = glm::angleAxis(startDist(rng_eng), glm::vec3(0, 1, 0)); //angle is a little adhoc, but with radians it should cover full 360 possibilities
+				glm::quat rot = glm::angleAxis(rotationDist(rng_eng), glm::vec3(0, 1, 0));
 				startPos += teamSpawnOrigin;
 
 				//fighterShipSpawnData.spawnTransform = Transform{ startPos, rot, {0.1,0.1,0.1} };
@@ -214,15 +223,30 @@ namespace SA
 
 				//fighter->spawnNewBrain<FlyInDirectionBrain>(); 
 				//fighter->spawnNewBrain<DogfightTestBrain_VerboseTree>();
-				fighter->spawnNewBrain<WanderBrain>();
 				//fighter->spawnNewBrain<EvadeTestBrain>();
 				//fighter->spawnNewBrain<DogfightTestBrain>();
-
-				//fighter->spawnNewBrain<FighterBrain>();
+				if (benchmarkScenario && benchmarkScenario->shipBrain == "fighter")
+				{
+					fighter->spawnNewBrain<FighterBrain>();
+				}
+				else
+				{
+					fighter->spawnNewBrain<WanderBrain>();
+				}
 			}
 		};
-		spawnFighters(0, carrierXform_TeamA.position);
-		spawnFighters(1, carrierXform_TeamB.position);
+		for (uint32_t teamIdx = 0; teamIdx < numTeams; ++teamIdx)
+		{
+			spawnFighters(teamIdx, teamOrigins[teamIdx]);
+		}
+
+		if (benchmarkScenario && benchmarkScenario->shipBrain == "continuousFire" && benchmarkScenario->projectilesPerShipPerSec > 0.f)
+		{
+			//same as ticking the continuous fire box in the ui
+			forceFireRateSecs_ui = 1.f / benchmarkScenario->projectilesPerShipPerSec;
+			bForceShipsToFire_ui = true;
+			refreshShipContinuousFireState();
+		}
 
 		if(const sp<PlayerBase>& player = game.getPlayerSystem().getPlayer(0))
 		{
@@ -251,7 +275,7 @@ namespace SA
 
 		//DEBUG assign targets to each other to test dogfighting
 		bool bEnableDebugTargets = false;
-		if(bEnableDebugTargets)
+		if(bEnableDebugTargets && teamTargets.size() >= 2)
 		{
 			size_t targetsToSet = teamTargets[0].size() < teamTargets[1].size() ? teamTargets[0].size() : teamTargets[1].size();
 			for (size_t idx = 0; idx < targetsToSet ; idx++)
@@ -265,16 +289,15 @@ namespace SA
 				{
 					BehaviorTreeBrain* aBrain = dynamic_cast<BehaviorTreeBrain*>(aBrainComp->getBrain());
 					BehaviorTreeBrain* bBrain = dynamic_cast<BehaviorTreeBrain*>(bBrainComp->getBrain());
-					if (aBrain && bBrain)
+					BehaviorTree::Memory* aMem = aBrain ? aBrain->getTreeMemory() : nullptr;
+					BehaviorTree::Memory* bMem = bBrain ? bBrain->getTreeMemory() : nullptr;
+					if (aMem && bMem)
 					{
-						BehaviorTree::Memory& aMem = aBrain->getBehaviorTree().getMemory();
-						BehaviorTree::Memory& bMem = bBrain->getBehaviorTree().getMemory();
-
 						sp<WorldEntity> aWE = a;
 						sp<WorldEntity> bWE = b;
 
-						WorldEntity* bAsTarget = aMem.replaceValue("target", bWE);
-						WorldEntity* aAsTarget = bMem.replaceValue("target", aWE);
+						WorldEntity* bAsTarget = aMem->replaceValue("target", bWE);
+						WorldEntity* aAsTarget = bMem->replaceValue("target", aWE);
 					}
 				}
 			}
@@ -777,7 +800,7 @@ namespace SA
 
 		if (sp<Ship> ship = std::dynamic_pointer_cast<Ship>(spawned))
 		{
-			spawnedShips.insert(ship);
+			spawnedShips.push_back(ship);
 
 			//ship->onDestroyedEvent->addWeakObj(sp_this(), &StressTestLevel::handleEntityDestroyed);
 		}
@@ -787,7 +810,7 @@ namespace SA
 	{
 		if (sp<Ship> ship = std::dynamic_pointer_cast<Ship>(unspawned))
 		{
-			if (auto iter = spawnedShips.find(ship); iter != spawnedShips.end())
+			if (auto iter = std::find(spawnedShips.begin(), spawnedShips.end(), ship); iter != spawnedShips.end())
 			{
 				spawnedShips.erase(iter);
 			}
@@ -1,7 +1,10 @@
 #pragma once
 #include <map>
+#include <optional>
+#include <vector>
 
 #include "SASpaceLevelBase.h"
+#include "StressTestBenchmark.h"
 
 namespace SA
 {
@@ -22,6 +25,11 @@ namespace SA
 	public:
 		virtual void render(float dt_sec, const glm::mat4& view, const glm::mat4& projection) override;
 
+		/** Set before the level starts to spawn the scenario's ships, teams and brains instead of the interactive defaults. */
+		void setBenchmarkScenario(const StressTestScenario& scenario) { benchmarkScenario = scenario; }
+		size_t getNumSpawnedShips() const { return spawnedShips.size(); }
+		const std::vector<sp<Ship>>& getSpawnedShips() const { return spawnedShips; }
+
 	protected:
 		virtual void onEntitySpawned_v(const sp<WorldEntity>& spawned) override;
 		virtual void onEntityUnspawned_v(const sp<WorldEntity>& unspawned) override;
@@ -88,7 +96,9 @@ namespace SA
 		sp<ProjectileTweakerWidget> projectileWidget;
 		sp<HitboxPicker> hitboxPickerWidget;
 
-		//needs to potentially have O(n) iteration
-		std::set<sp<Ship>> spawnedShips;
+		//needs to potentially have O(n) iteration; kept in spawn order (not pointer order) so per-ship setup repeats run to run
+		std::vector<sp<Ship>> spawnedShips;
+
+		std::optional<StressTestScenario> benchmarkScenario;
 	};
 }
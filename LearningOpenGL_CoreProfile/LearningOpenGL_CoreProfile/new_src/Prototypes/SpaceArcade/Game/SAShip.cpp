@@ -76,7 +76,6 @@ namespace SA
 		}
 
 		shipConfigData = spawnData.spawnConfig;
-		overlappingNodes_SH.reserve(10);
 		primaryProjectile = spawnData.spawnConfig->getPrimaryProjectileConfig();
 		bCollisionReflectForward = shipConfigData->getCollisionReflectForward();
 
@@ -179,6 +178,9 @@ namespace SA
 			//Transform xform = getTransform();
 			//glm::mat4 xform_m = xform.getModelMatrix();
 			collisionHandle = world->getWorldGrid().insert(*this, collisionData->getWorldOBB());
+
+			//ships are the hottest world entities; tick them in one batch rather than through WorldEntity::tick
+			world->getWorldTimeManager()->registerTypedTicker<&Ship::tickShip>(TickGroups::get().GAME, sp_this());
 		}
 		else
 		{
@@ -446,6 +448,14 @@ namespace SA
 		RenderModelEntity::onDestroyed();
 		collisionHandle = nullptr; //release spatial hashing information
 
+		if (LevelBase* world = getWorld())
+		{
+			if (const sp<TimeManager>& worldTimeManager = world->getWorldTimeManager())
+			{
+				worldTimeManager->removeTypedTicker<&Ship::tickShip>(TickGroups::get().GAME, sp_this());
+			}
+		}
+
 		if (fighterSpawnComp)
 		{
 			fighterSpawnComp->setActive(false);
@@ -770,10 +780,13 @@ namespace SA
 		return false;
 	}
 
-	void Ship::tick(float dt_sec)
+	void Ship::tickShip(float dt_sec)
 	{
 		using namespace glm;
-		if (bEditorMode) {return;}
+
+		//the level does not tick entities while world time is frozen; the tick dispatcher always ticks, so match the level here
+		LevelBase* world = getWorld();
+		if (!world || world->getWorldTimeManager()->isTimeFrozen()) { return; }
 
 		energyComp->notify_tick(dt_sec);
 
@@ -1003,9 +1016,6 @@ namespace SA
 	{
 		using namespace glm;
 
-		bool bAnyCollision = false;
-		glm::vec4 lastMTV = glm::vec4(0.f);
-
 		std::optional<glm::vec3> avoidanceVelDir_n = updateAvoidance(dt_sec);
 
 		Transform xform = getTransform();
@@ -1024,91 +1034,107 @@ namespace SA
 			SH::SpatialHashGrid<WorldEntity>& worldGrid = world->getWorldGrid();
 			worldGrid.updateEntry(collisionHandle, collisionData->getWorldOBB());
 
-			//test against all overlapping grid nodes
-			overlappingNodes_SH.clear();
-			worldGrid.lookupNodesInCells(*collisionHandle, overlappingNodes_SH);
-			for (sp <SH::GridNode<WorldEntity>> node : overlappingNodes_SH)
+			//overlaps are resolved after every ship has moved, see SpaceLevelBase::tickShipCollisions
+#if SA_CAPTURE_SPATIAL_HASH_CELLS
+			SpatialHashCellDebugVisualizer::appendCells(worldGrid, *collisionHandle);
+#endif //SA_CAPTURE_SPATIAL_HASH_CELLS
+
+			setTransform(xform);
+
+#define EXTRA_SHIP_DEBUG_INFO 0
+#if EXTRA_SHIP_DEBUG_INFO
+			{
+				DebugRenderSystem& debug = GameBase::get().getDebugRenderSystem();
+				debug.renderCube(xform.getModelMatrix(), color::brightGreen());
+			}
+#endif
+		}
+	}
+
+	bool Ship::resolveCollisionWith(const CollisionData& otherCollisionData)
+	{
+		//make sure OOB's collide as an optimization
+		if (!SAT::Shape::CollisionTest(*collisionData->getOBBShape(), *otherCollisionData.getOBBShape()))
+		{
+			return false;
+		}
+
+		using ShapeData = CollisionData::ShapeData;
+		const std::vector<ShapeData>& myShapeData = collisionData->getShapeData();
+		const std::vector<ShapeData>& otherShapeData = otherCollisionData.getShapeData();
+
+		const bool bFirstCollision = !bPendingCollision;
+		Transform xform = getTransform();
+		xform.position += pendingCollisionCorrection;
+
+		bool bCollision = false;
+		size_t numAttempts = 3;
+		size_t attempt = 0;
+		do
+		{
+			attempt++;
+			bCollision = false;
+
+			glm::vec4 largestMTV = glm::vec4(0.f);
+			float largestMTV_len2 = 0.f;
+			for (const ShapeData& myShape : myShapeData)
 			{
-				CollisionComponent* otherCollisionComp = node->element.getGameComponent<CollisionComponent>();
-				if (otherCollisionComp && otherCollisionComp->requestsCollisionChecks())
+				for (const ShapeData& worldShape : otherShapeData)
 				{
-					if (CollisionData* otherCollisionData = otherCollisionComp->getCollisionData()) //#todo #optimize so component will always have this data, but it can contain no shapes, to avoid branches. similar to nullobject pattern
+					assert(myShape.shape && worldShape.shape);
+					glm::vec4 mtv;
+					if (SAT::Shape::CollisionTest(*myShape.shape, *worldShape.shape, mtv))
 					{
-						using ShapeData = CollisionData::ShapeData;
-						const std::vector<ShapeData>& myShapeData = collisionData->getShapeData();
-						const std::vector<ShapeData>& otherShapeData = otherCollisionData->getShapeData();
-
-						//make sure OOB's collide as an optimization
-						if (SAT::Shape::CollisionTest(*collisionData->getOBBShape(), *otherCollisionData->getOBBShape()))
+						float mtv_len2 = glm::length2(mtv);
+						if (mtv_len2 > largestMTV_len2)
 						{
-							bool bCollision = false;
-							size_t numAttempts = 3;
-							size_t attempt = 0;
-							do
-							{
-								attempt++;
-								bCollision = false;
-
-								glm::vec4 largestMTV = glm::vec4(0.f);
-								float largestMTV_len2 = 0.f;
-								for (const ShapeData& myShape : myShapeData)
-								{
-									for (const ShapeData& worldShape : otherShapeData)
-									{
-										assert(myShape.shape && worldShape.shape);
-										glm::vec4 mtv;
-										if (SAT::Shape::CollisionTest(*myShape.shape, *worldShape.shape, mtv))
-										{
-											float mtv_len2 = glm::length2(mtv);
-											if (mtv_len2 > largestMTV_len2)
-											{
-												largestMTV_len2 = mtv_len2;
-												largestMTV = lastMTV = mtv;
-												bCollision = bAnyCollision = true;
-											}
-										}
-									}
-								}
-								if (bCollision)
-								{
-									xform.position += glm::vec3(largestMTV);
-									collisionData->updateToNewWorldTransform(xform.getModelMatrix());
-								}
-							} while (bCollision && attempt < numAttempts);
-							//perhaps we should revert back to original xform is it fails collision tests for all attempts.
+							largestMTV_len2 = mtv_len2;
+							largestMTV = lastCollisionMTV = mtv;
+							bCollision = bPendingCollision = true;
 						}
 					}
 				}
 			}
-#if SA_CAPTURE_SPATIAL_HASH_CELLS
-			SpatialHashCellDebugVisualizer::appendCells(worldGrid, *collisionHandle);
-#endif //SA_CAPTURE_SPATIAL_HASH_CELLS
-
-			if (bAnyCollision)
+			if (bCollision)
 			{
-				if (bCollisionReflectForward)
-				{
-					//MTV in the case of faces will be something like the face normal; however this may not look to great for deflecting off of edges
-					glm::vec4 forward_n = getForwardDir();
-					glm::vec4 reflectedForward_n = normalize(glm::reflect(forward_n, glm::normalize(lastMTV))); //may not need to normalize
-					setVelocityDir(reflectedForward_n);
-					xform.rotQuat = Utils::getRotationBetween(forward_n, reflectedForward_n) * xform.rotQuat;
-				}
-				doShieldFX();
+				xform.position += glm::vec3(largestMTV);
+				pendingCollisionCorrection += glm::vec3(largestMTV);
+				collisionData->updateToNewWorldTransform(xform.getModelMatrix());
 			}
+		} while (bCollision && attempt < numAttempts);
+		//perhaps we should revert back to original xform is it fails collision tests for all attempts.
 
-			setTransform(xform); //set after collision is handled so we do not continually update/broadcast events
+		return bFirstCollision && bPendingCollision;
+	}
 
-			if (bAnyCollision && onCollided.numBound() > 0) { onCollided.broadcast(); } //broadcasting after we've updated transform
+	void Ship::applyCollisionResponse()
+	{
+		using namespace glm;
 
-#define EXTRA_SHIP_DEBUG_INFO 0
-#if EXTRA_SHIP_DEBUG_INFO
-			{
-				DebugRenderSystem& debug = GameBase::get().getDebugRenderSystem();
-				debug.renderCube(xform.getModelMatrix(), color::brightGreen());
-			}
-#endif
+		if (!bPendingCollision)
+		{
+			return;
 		}
+
+		Transform xform = getTransform();
+		xform.position += pendingCollisionCorrection;
+
+		if (bCollisionReflectForward)
+		{
+			//MTV in the case of faces will be something like the face normal; however this may not look to great for deflecting off of edges
+			glm::vec4 forward_n = getForwardDir();
+			glm::vec4 reflectedForward_n = normalize(glm::reflect(forward_n, glm::normalize(lastCollisionMTV))); //may not need to normalize
+			setVelocityDir(reflectedForward_n);
+			xform.rotQuat = Utils::getRotationBetween(forward_n, reflectedForward_n) * xform.rotQuat;
+		}
+		doShieldFX();
+
+		pendingCollisionCorrection = glm::vec3(0.f);
+		bPendingCollision = false;
+
+		setTransform(xform); //set after collision is handled so we do not continually update/broadcast events
+
+		if (onCollided.numBound() > 0) { onCollided.broadcast(); } //broadcasting after we've updated transform
 	}
 
 	void Ship::tickSounds()
@@ -1173,10 +1199,9 @@ namespace SA
 
 	void Ship::doShieldFX()
 	{
-		if (!activeShieldEffect.expired())
+		if (ActiveParticleGroup* shieldEffect = GameBase::get().getParticleSystem().getParticleGroup(activeShieldEffect))
 		{
-			sp<ActiveParticleGroup> shieldEffect_sp = activeShieldEffect.lock();
-			shieldEffect_sp->resetTimeAlive();
+			shieldEffect->resetTimeAlive();
 		}
 		else
 		{
@@ -1201,12 +1226,10 @@ namespace SA
 	void Ship::tickShieldFX()
 	{
 		const Transform& xform = getTransform();
-		if (!activeShieldEffect.expired())
+		if (ActiveParticleGroup* activeShield = GameBase::get().getParticleSystem().getParticleGroup(activeShieldEffect))
 		{
-			//locking wp may be slow as it requires atomic reference count increment; may need to use soft-ptrs if I make that system
-			sp<ActiveParticleGroup> activeShield_sp = activeShieldEffect.lock();
-			activeShield_sp->xform.rotQuat = xform.rotQuat;
-			activeShield_sp->xform.position = xform.position;
+			activeShield->xform.rotQuat = xform.rotQuat;
+			activeShield->xform.position = xform.position;
 		}
 	}
 
@@ -1461,8 +1484,8 @@ namespace SA
 			Transform modelXform = shipConfigData->getModelXform();
 			particleSpawnParams.xform.scale *= modelXform.scale;
 
-			wp<ActiveParticleGroup> weakParticle = GameBase::get().getParticleSystem().spawnParticle(particleSpawnParams);
-			if (sp<ActiveParticleGroup> engineParticle = weakParticle.lock())
+			ParticleGroupHandle engineParticle = GameBase::get().getParticleSystem().spawnParticle(particleSpawnParams);
+			if (engineParticle.isValid())
 			{
 				engineFireParticlesFX.push_back(engineParticle);
 			}
@@ -1486,12 +1509,12 @@ namespace SA
 		glm::vec3 shipWorldPos = getWorldPosition();
 		const Transform& shipXform = getTransform();
 
+		const ParticleSystem& particleSystem = GameBase::get().getParticleSystem();
 		const std::vector<EngineEffectData>& engineEffectData = shipConfigData->getEngineEffectData();
 		for (size_t engineFxIdx = 0; engineFxIdx < engineEffectData.size() && engineFxIdx < engineFireParticlesFX.size(); ++engineFxIdx)
 		{
 			const EngineEffectData& effectData = engineEffectData[engineFxIdx];
-			const sp<ActiveParticleGroup>& engineParticle = engineFireParticlesFX[engineFxIdx];
-			if (engineParticle)
+			if (ActiveParticleGroup* engineParticle = particleSystem.getParticleGroup(engineFireParticlesFX[engineFxIdx]))
 			{
 				ShipUtilLibrary::setEngineParticleOffset(engineParticle->xform, shipXform, effectData);
 
@@ -1506,9 +1529,10 @@ namespace SA
 
 	void Ship::destroyEngineVFX()
 	{
-		for (const sp<ActiveParticleGroup>& engineParticle : engineFireParticlesFX)
+		const ParticleSystem& particleSystem = GameBase::get().getParticleSystem();
+		for (const ParticleGroupHandle& engineParticleHandle : engineFireParticlesFX)
 		{
-			if (engineParticle)
+			if (ActiveParticleGroup* engineParticle = particleSystem.getParticleGroup(engineParticleHandle))
 			{
 				engineParticle->killParticle();
 			}
@@ -1579,12 +1603,11 @@ namespace SA
 			{
 				if (!isCarrierShip()) //is fighter ship
 				{
-					if (!activeShieldEffect.expired())
+					if (ActiveParticleGroup* shieldVFX = GameBase::get().getParticleSystem().getParticleGroup(activeShieldEffect))
 					{
-						sp<ActiveParticleGroup> shieldVFX = activeShieldEffect.lock();
 						shieldVFX->killParticle();
 						shieldVFX->xform.scale = glm::vec3(0.f); //particle isn't disappearing... 
-						activeShieldEffect.reset();
+						activeShieldEffect = ParticleGroupHandle{};
 					}
 
 					ParticleSystem::SpawnParams particleSpawnParams;
@@ -1606,9 +1629,10 @@ namespace SA
 						brainComp->setNewBrain(sp<AIBrain>(nullptr));
 					}
 
-					if (transientCollidingProjectile && transientCollidingProjectile->owner)
+					sp<WorldEntity> projectileOwner = transientCollidingProjectile ? transientCollidingProjectile->findOwner() : nullptr;
+					if (projectileOwner)
 					{ //if you get a crash here, did we clean this up after being hit? this should always be cleaned up within the scope that the player is hit by a projectile!
-						if (OwningPlayerComponent* playerComp = transientCollidingProjectile->owner->getGameComponent<OwningPlayerComponent>())
+						if (OwningPlayerComponent* playerComp = projectileOwner->getGameComponent<OwningPlayerComponent>())
 						{
 							if (playerComp->hasOwningPlayer())
 							{
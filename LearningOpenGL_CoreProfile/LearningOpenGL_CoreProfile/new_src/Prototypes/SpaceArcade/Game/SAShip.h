@@ -7,6 +7,7 @@
 #include "../GameFramework/SACollisionUtils.h"
 #include "../GameFramework/Components/GameplayComponents.h"
 #include "../GameFramework/Interfaces/SAIControllable.h"
+#include "../GameFramework/SAParticleGroupPool.h"
 #include "../Tools/ModelLoading/SAModel.h"
 #include "../Tools/DataStructures/SATransform.h"
 #include "../Tools/RemoveSpecialMemberFunctionUtils.h"
@@ -194,10 +195,16 @@ namespace SA
 		const sp<const SpawnConfig>& getSpawnConfig() { return shipConfigData; }
 	protected:
 		virtual void postConstruct() override;
-		virtual void tick(float deltatime) override;
 	private:
+		/** Ticked as a typed batch in the world's GAME tick group rather than by the level's virtual entity tick */
+		void tickShip(float dt_sec);
 		friend class ShipCameraTweakerWidget; //allow camera tweaker widget to modify ship properties in real time.
+		friend class SpaceLevelBase; //runs the collision pass over every overlapping pair once all ships have moved
 		void tickKinematic(float dt_sec);
+		/** Pushes this ship out of other; returns true if this is the ship's first collision of the pass. */
+		bool resolveCollisionWith(const CollisionData& otherCollisionData);
+		/** Applies the corrections and reactions (reflection, shield fx, onCollided) gathered by resolveCollisionWith. */
+		void applyCollisionResponse();
 		void tickSounds();
 		std::optional<glm::vec3> updateAvoidance(float dt_sec);
 		virtual void notifyProjectileCollision(const Projectile& hitProjectile, glm::vec3 hitLoc) override;
@@ -231,8 +238,10 @@ namespace SA
 	private: //cheat flags
 		bool bOneShotPlacements = false;
 	private:
-		//helper data structures
-		std::vector<sp<SH::GridNode<WorldEntity>>> overlappingNodes_SH;
+		//collision response gathered during the level's pair pass; applied once per frame in applyCollisionResponse
+		glm::vec3 pendingCollisionCorrection{ 0.f };
+		glm::vec4 lastCollisionMTV{ 0.f };
+		bool bPendingCollision = false;
 	private:
 		up<SH::HashEntry<WorldEntity>> collisionHandle = nullptr; //#TODO not sure if this should be on the collision component, keeping it off the component encapsulates it better.
 		const sp<CollisionData> collisionData; //#TODO perhaps just reference what's in the component so we don't have two pointers
@@ -297,10 +306,10 @@ namespace SA
 		sp<AudioEmitter> sfx_explosion;
 
 		sp<ProjectileConfig> primaryProjectile;
-		wp<ActiveParticleGroup> activeShieldEffect;
+		ParticleGroupHandle activeShieldEffect;
 
 		//some ships may have multiple engines, hence may have multiple fire particles
-		std::vector<sp<ActiveParticleGroup>> engineFireParticlesFX;
+		std::vector<ParticleGroupHandle> engineFireParticlesFX;
 
 		//where projectiles spawn from, if none specified in spawn config, projectiles will spawn immediately in front of the ship.
 		size_t fireLocationIndex = 0;
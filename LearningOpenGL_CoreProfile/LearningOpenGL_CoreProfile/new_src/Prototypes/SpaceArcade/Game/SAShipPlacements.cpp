@@ -194,7 +194,7 @@ namespace SA
 			{
 				//we were hit by a non-team member, apply game logic!
 				notifyDamagingHit(hitProjectile, hitLoc);
-				adjustHP(-float(hitProjectile.damage), hitProjectile.owner);
+				adjustHP(-float(hitProjectile.damage), hitProjectile.findOwner());
 				//WARNING: anything after adjusting HP make cause this object to be destroyed, do not make calls after it. #nextengine all destroys happen 1 frame deferred
 			}
 			else
@@ -214,9 +214,9 @@ namespace SA
 		using namespace glm;
 		if (bHasGeneratorPower)
 		{
-			if (activeShieldEffect)
+			if (ActiveParticleGroup* shieldEffect = GameBase::get().getParticleSystem().getParticleGroup(activeShieldEffect))
 			{
-				activeShieldEffect->resetTimeAlive();
+				shieldEffect->resetTimeAlive();
 			}
 			else
 			{
@@ -388,9 +388,9 @@ namespace SA
 			}
 		}
 
-		if (activeShieldEffect)
+		if (ActiveParticleGroup* shieldEffect = GameBase::get().getParticleSystem().getParticleGroup(activeShieldEffect))
 		{
-			activeShieldEffect->parentXform_m = cachedModelMat_PxL; //use the complete transform as parent transform, add a little scale to the particle itself
+			shieldEffect->parentXform_m = cachedModelMat_PxL; //use the complete transform as parent transform, add a little scale to the particle itself
 		}
 	}
 
@@ -795,10 +795,11 @@ namespace SA
 	void TurretPlacement::notifyDamagingHit(const Projectile& hitProjectile, glm::vec3 hitLoc)
 	{
 		bool bShouldSwitchTarget = false; 
+		sp<WorldEntity> attacker = hitProjectile.findOwner();
 
-		if (myTarget && hitProjectile.owner && myTarget.fastGet() != hitProjectile.owner.get())
+		if (myTarget && attacker && myTarget.fastGet() != attacker.get())
 		{
-			glm::vec3 attackerPosition = hitProjectile.owner->getWorldPosition();
+			glm::vec3 attackerPosition = attacker->getWorldPosition();
 			glm::vec3 targetPosition = myTarget->getWorldPosition();
 			glm::vec3 myPos = getWorldPosition();
 
@@ -818,9 +819,9 @@ namespace SA
 			bShouldSwitchTarget = true;
 		}
 
-		if (bShouldSwitchTarget && hitProjectile.owner)
+		if (bShouldSwitchTarget && attacker)
 		{
-			wp<TargetType> ownerAsTargetType = hitProjectile.owner->requestTypedReference_Safe<TargetType>();
+			wp<TargetType> ownerAsTargetType = attacker->requestTypedReference_Safe<TargetType>();
 			if (!ownerAsTargetType.expired())
 			{
 				setTarget(ownerAsTargetType);
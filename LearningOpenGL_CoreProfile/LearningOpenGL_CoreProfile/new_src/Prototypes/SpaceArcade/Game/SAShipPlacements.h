@@ -6,6 +6,7 @@
 #include "../Tools/DataStructures/SATransform.h"
 #include "../GameFramework/SAWorldEntity.h"
 #include "../GameFramework/RenderModelEntity.h"
+#include "../GameFramework/SAParticleGroupPool.h"
 #include "../Tools/DataStructures/AdvancedPtrs.h"
 #include "../../../Algorithms/SpatialHashing/SpatialHashingComponent.h"
 #include "AssetConfigs/SoundEffectSubConfig.h"
@@ -118,7 +119,7 @@ namespace SA
 	private:
 		up<SH::HashEntry<WorldEntity>> collisionHandle = nullptr;
 		sp<CollisionData> collisionData = nullptr;
-		fwp<ActiveParticleGroup> activeShieldEffect;
+		ParticleGroupHandle activeShieldEffect;
 		PlacementSubConfig config;
 		sp<class AudioEmitter> sfx_explosionEmitter = nullptr;
 		SoundEffectSubConfig sfx_explosionConfig;
@@ -42,6 +42,7 @@
 #include "Cheats/SpaceArcadeCheatSystem.h"
 #include "../GameFramework/developer_console/DeveloperConsole.h"
 #include "Levels/StressTestLevel.h"
+#include "Levels/StressTestBenchmark.h"
 #include "GameSystems/SAUISystem_Game.h"
 #include "UI/GameUI/Widgets3D/Widget3D_Base.h"
 #include "Levels/MainMenuLevel.h"
@@ -64,7 +65,7 @@ namespace SA
 	sp<SA::Window> SpaceArcade::makeInitialWindow()
 	{
 		int width = 1440, height = 810;
-		sp<SA::Window> window = new_sp<SA::Window>(width, height);
+		sp<SA::Window> window = new_sp<SA::Window>(width, height, /*bHeadless*/ isHeadless());
 		ec(glViewport(0, 0, width, height)); //#TODO, should we do this in the gamebase level on "glfwSetFramebufferSizeCallback" changed?
 		return window;
 	}
@@ -128,8 +129,23 @@ namespace SA
 		//sp<LevelBase> startupLevel = new_sp<EnigmaTutorialLevel>();
 		//sp<LevelBase> startupLevel = new_sp<StressTestLevel>();
 		//sp<LevelBase> startupLevel = new_sp<ModelConfigurerEditor_Level>();
+		if (headlessBenchmark)
+		{
+			//nothing is displayed, so step the scenario's fixed time as fast as possible
+			bEnableFramerateLimit = false;
+			getTimeSystem().setFixedDeltaTimeSecs(headlessBenchmark->getScenario().fixedDeltaSec);
+
+			sp<StressTestLevel> benchmarkLevel = new_sp<StressTestLevel>();
+			benchmarkLevel->setBenchmarkScenario(headlessBenchmark->getScenario());
+			startupLevel = benchmarkLevel;
+		}
 		getLevelSystem().loadLevel(startupLevel);
 
+		if (headlessBenchmark)
+		{
+			headlessBenchmark->begin();
+		}
+
 		if (bEnableDebugEngineKeybinds)
 		{
 			log(__FUNCTION__, LogLevel::LOG_WARNING, "SpaceArcade::bEnableDebugEngineKeybinds is true, this should be false for shipping builds.");
@@ -377,6 +393,17 @@ namespace SA
 		return _SATickGroups;
 	}
 
+	void SpaceArcade::onInitEngineConstants(EngineConstants& config)
+	{
+		if (headlessBenchmark)
+		{
+			const StressTestScenario& scenario = headlessBenchmark->getScenario();
+			config.JOB_WORKER_THREADS = scenario.numWorkerThreads;
+			config.DETERMINISTIC_JOBS = scenario.bDeterministicJobs;
+			config.RNG_SEED = scenario.seed;
+		}
+	}
+
 	void SpaceArcade::updateInput(float detltaTimeSec)
 	{
 		if (const sp<Window> windowObj = getWindowSystem().getPrimaryWindow())
@@ -416,7 +443,7 @@ namespace SA
 			}
 			 
 			//debug
-			if (bEnableDebugEngineKeybinds)
+			if (bEnableDebugEngineKeybinds && window)
 			{
 				if (glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS)
 				{
@@ -536,8 +563,19 @@ namespace
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
+	//build machines without a GPU run: SpaceArcade --headless-benchmark <scenario.json> [report.json]
+	if (argc >= 3 && std::string(argv[1]) == "--headless-benchmark")
+	{
+		return SA::runStressTestBenchmarkFromFiles(argv[2], argc >= 4 ? argv[3] : "");
+	}
+	//runs the above twice and checks both runs end in the same state: SpaceArcade --headless-benchmark-repeat <scenario.json> <report.json>
+	if (argc >= 4 && std::string(argv[1]) == "--headless-benchmark-repeat")
+	{
+		return SA::runStressTestRepeatabilityCheck(argv[0], argv[2], argv[3]);
+	}
+
 	int result = trueMain();
 	return result;
 }
\ No newline at end of file
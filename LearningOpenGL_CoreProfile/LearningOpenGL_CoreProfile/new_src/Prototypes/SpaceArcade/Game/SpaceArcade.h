@@ -30,6 +30,7 @@ namespace SA
 	class HUD;
 	class DeveloperConsole;
 	class PlayerPilotAssistUI;
+	class StressTestBenchmark;
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// The game implementation for the space arcade game.
@@ -49,6 +50,7 @@ namespace SA
 		virtual void onRegisterCustomSystem() override;
 		virtual sp<CheatSystemBase> createCheatSystemSubclass() override;
 		virtual sp<TickGroups> onRegisterTickGroups();
+		virtual void onInitEngineConstants(EngineConstants& config) override;
 
 		void updateInput(float detltaTimeSec);
 
@@ -102,6 +104,16 @@ namespace SA
 		bool bEscapeShouldOpenEditorMenu = true & !SHIPPING_BUILD;
 	public:
 		const sp<HUD> getHUD() const { return hud; }
+
+		//////////////////////////////////////////////////////////////////////////////////////
+		//  Headless benchmark
+		/////////////////////////////////////////////////////////////////////////////////////
+	public:
+		/** Call before start(). Runs without a gpu and loads the benchmark's StressTestLevel instead of the main menu. */
+		void setHeadlessBenchmark(const sp<StressTestBenchmark>& benchmark) { headlessBenchmark = benchmark; }
+		bool isHeadless() const { return headlessBenchmark != nullptr; }
+	private:
+		sp<StressTestBenchmark> headlessBenchmark;
 	public:
 	public:
 		UniformResourceLocators URLs;
@@ -326,7 +326,7 @@ namespace SA
 	{
 		if (const sp<LevelBase>& world = SpaceArcade::get().getLevelSystem().getCurrentLevel())
 		{
-			const std::set<sp<WorldEntity>>& worldEntities = world->getWorldEntities();
+			const SlotMap<sp<WorldEntity>>& worldEntities = world->getWorldEntities();
 			for (const sp<WorldEntity>& entity : worldEntities)
 			{
 				if(Ship* shipPtr = dynamic_cast<Ship*>(entity.get()))
@@ -441,7 +441,7 @@ namespace SA
 				// find an objective
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 				sp<Ship> enemyCarrier = nullptr;
-				const std::set<sp<WorldEntity>>& worldEntities = currentLevel->getWorldEntities();
+				const SlotMap<sp<WorldEntity>>& worldEntities = currentLevel->getWorldEntities();
 				for (const sp<WorldEntity>& worldEntity : worldEntities)
 				{
 					const FighterSpawnComponent* spawnComp = worldEntity->getGameComponent<FighterSpawnComponent>();
@@ -58,7 +58,7 @@ namespace SA
 			const sp<CameraBase>& camera = playerSys.getPlayer(0)->getCamera();
 			const sp<LevelBase>& level = levelSys.getCurrentLevel();
 			const sp<Window>& window = windowSys.getPrimaryWindow();
-			if (camera && level && window)
+			if (camera && level && window && window->get())
 			{
 				//#future perhaps these functions should be off of the window object
 
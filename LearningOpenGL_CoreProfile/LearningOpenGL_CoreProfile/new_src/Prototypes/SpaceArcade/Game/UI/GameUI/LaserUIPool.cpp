@@ -163,8 +163,7 @@ namespace SA
 
 		SpaceArcade& game = SpaceArcade::get();
 
-		//use system timer so that this works regardless of level transition
-		game.getSystemTimeManager().registerTicker(sp_this());
+		//lasers advance in one pass over activeLasers during renderGameUI; the pool does not need a per-frame tick
 		rng = game.getRNGSystem().getNamedRNG(LaserRNGKey);
 
 		laserLerpCurve = game.getCurveSystem().generateSigmoid_medp(20.f);
@@ -269,22 +268,6 @@ namespace SA
 		}
 	}
 
-	bool LaserUIPool::tick(float dt_sec)
-	{
-		//if (const sp<LevelBase>& currentLevel = GameBase::get().getLevelSystem().getCurrentLevel())
-		//{
-		//	//use dilated world time, not system time
-		//	dt_sec = currentLevel->getWorldTimeManager()->getDeltaTimeSecs();
-		//	//for (LaserUIObject* laser : activeLasers)
-		//	//{
-		//	//	laser->tick(dt_sec);
-		//	//}
-		//}
-
-		//see renderGameUI for laser updates
-		return true;
-	}
-
 	void LaserUIPool::renderGameUI(GameUIRenderData& ui_rd)
 	{
 		using namespace glm;
@@ -466,14 +449,6 @@ namespace SA
 		rng = GameBase::get().getRNGSystem().getNamedRNG(LaserRNGKey);
 	}
 
-	bool LaserUIObject::tick(float dt_sec)
-	{
-		anim_Start.curTickTimeSec += dt_sec;
-		anim_End.curTickTimeSec += dt_sec;
-
-		return true;
-	}
-
 	void LaserUIObject::LerpToGoalPositions()
 	{
 		//WARNING: be careful not to broadcast any events here! this is called from render thread
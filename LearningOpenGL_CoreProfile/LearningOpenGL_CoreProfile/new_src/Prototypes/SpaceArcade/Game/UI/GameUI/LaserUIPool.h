@@ -5,7 +5,6 @@
 
 #include "../../../GameFramework/SAGameEntity.h"
 #include "../../../Rendering/SAGPUResource.h"
-#include "../../../GameFramework/Interfaces/SATickable.h"
 #include "../../../Tools/DataStructures/SATransform.h"
 #include "../../../Tools/DataStructures/MultiDelegate.h"
 #include <optional>
@@ -57,7 +56,6 @@ namespace SA
 		virtual void postConstruct() override;
 	private:
 		friend class LaserUIPool;
-		bool tick(float dt_sec);	
 		void LerpToGoalPositions();
 		void prepareRender(GameUIRenderData& renderData, InstanceRenderData& outInstanceData);
 		void setOffscreenMode(const std::optional<ELaserOffscreenMode>& inOffscreenMode, bool bResetAnimProgress = true);
@@ -93,7 +91,7 @@ namespace SA
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// A pool to request and release LaserUIObjects to give transitions.
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	class LaserUIPool : public GPUResource, public ITickable
+	class LaserUIPool : public GPUResource
 	{
 	public:
 		static LaserUIPool& get();
@@ -111,7 +109,6 @@ namespace SA
 	protected:
 		virtual void onReleaseGPUResources() override;
 		virtual void onAcquireGPUResources() override;
-		virtual bool tick(float dt_sec) override;
 		void renderGameUI(GameUIRenderData& renderData);
 	private:
 		void handleGameShutdownStarted();
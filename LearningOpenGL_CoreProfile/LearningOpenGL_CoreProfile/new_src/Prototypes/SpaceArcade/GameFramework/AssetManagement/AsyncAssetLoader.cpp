@@ -0,0 +1,163 @@
+#include "AsyncAssetLoader.h"
+
+#include <chrono>
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Worker pool
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	AssetWorkerPool::AssetWorkerPool(size_t numThreads)
+	{
+		numThreads = numThreads > 0 ? numThreads : 1;
+		workers.reserve(numThreads);
+		for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+		{
+			workers.emplace_back([this]() { workerLoop(); });
+		}
+	}
+
+	AssetWorkerPool::~AssetWorkerPool()
+	{
+		stop();
+	}
+
+	void AssetWorkerPool::submit(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(taskMutex);
+			if (bStopping)
+			{
+				return;
+			}
+			tasks.push_back(std::move(task));
+		}
+		taskAvailable.notify_one();
+	}
+
+	void AssetWorkerPool::waitIdle()
+	{
+		std::unique_lock<std::mutex> lock(taskMutex);
+		idle.wait(lock, [this]() { return tasks.empty() && numRunningTasks == 0; });
+	}
+
+	void AssetWorkerPool::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(taskMutex);
+			if (bStopping)
+			{
+				return;
+			}
+			bStopping = true;
+			tasks.clear();
+		}
+		taskAvailable.notify_all();
+
+		for (std::thread& worker : workers)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+		idle.notify_all();
+	}
+
+	void AssetWorkerPool::workerLoop()
+	{
+		for (;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(taskMutex);
+				taskAvailable.wait(lock, [this]() { return bStopping || !tasks.empty(); });
+				if (bStopping)
+				{
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+				++numRunningTasks;
+			}
+
+			task();
+
+			{
+				std::lock_guard<std::mutex> lock(taskMutex);
+				--numRunningTasks;
+			}
+			idle.notify_all();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Upload pump
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	AsyncUploadPump::AsyncUploadPump(double budgetMsPerTick, ClockFunc clock)
+		: budgetMs(budgetMsPerTick), clock(std::move(clock))
+	{
+		if (!this->clock)
+		{
+			this->clock = []()
+			{
+				using namespace std::chrono;
+				return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+			};
+		}
+	}
+
+	size_t AsyncUploadPump::pumpUploads()
+	{
+		if (queues.empty())
+		{
+			return 0;
+		}
+
+		size_t numUploads = 0;
+		const double startMs = clock();
+		size_t numIdleQueuesInARow = 0;
+
+		//stop once every queue has been visited without finding work, or the budget is spent
+		while (numIdleQueuesInARow < queues.size())
+		{
+			if (numUploads > 0 && (clock() - startMs) >= budgetMs)
+			{
+				break;
+			}
+
+			IAsyncUploadQueue* queue = queues[nextQueueIdx];
+			nextQueueIdx = (nextQueueIdx + 1) % queues.size();
+
+			if (queue->uploadOne())
+			{
+				++numUploads;
+				numIdleQueuesInARow = 0;
+			}
+			else
+			{
+				++numIdleQueuesInARow;
+			}
+		}
+
+		return numUploads;
+	}
+
+	bool AsyncUploadPump::hasPendingUploads() const
+	{
+		for (IAsyncUploadQueue* queue : queues)
+		{
+			if (queue->hasPendingUploads())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool AsyncUploadPump::tick(float /*dt_sec*/)
+	{
+		pumpUploads();
+		return true;
+	}
+}
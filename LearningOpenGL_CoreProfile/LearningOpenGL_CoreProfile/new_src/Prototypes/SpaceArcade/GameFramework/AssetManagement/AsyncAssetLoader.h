@@ -0,0 +1,261 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+
+#include "../SAGameEntity.h"
+#include "../Interfaces/SATickable.h"
+#include "../../Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Fixed set of threads that run asset decode tasks (file io, parsing, decompression). Tasks must not touch
+	// GL, AL, or game state; whatever they produce is handed back to the game thread by an AsyncAssetQueue.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AssetWorkerPool : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		explicit AssetWorkerPool(size_t numThreads);
+		~AssetWorkerPool();
+
+		void submit(std::function<void()> task);
+
+		/** Blocks until every submitted task has finished */
+		void waitIdle();
+
+		/** Joins the workers; tasks that have not started are dropped */
+		void stop();
+
+		size_t getNumThreads() const { return workers.size(); }
+
+	private:
+		void workerLoop();
+
+	private:
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()>> tasks;
+		std::mutex taskMutex;
+		std::condition_variable taskAvailable;
+		std::condition_variable idle;
+		size_t numRunningTasks = 0;
+		bool bStopping = false;
+	};
+
+	enum class EAsyncAssetStatus : uint8_t
+	{
+		LOADING,
+		LOADED,
+		FAILED
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Handle to an asset that is being loaded in the background. Handles for the same path share their state, and
+	// the state only changes on the game thread (when the upload step runs), so polling a handle from game code
+	// is always consistent within a frame.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename Asset>
+	class AsyncAssetHandle
+	{
+	public:
+		struct State
+		{
+			std::string path;
+			std::atomic<EAsyncAssetStatus> status{ EAsyncAssetStatus::LOADING };
+			sp<Asset> asset;
+		};
+
+	public:
+		AsyncAssetHandle() = default;
+		AsyncAssetHandle(sp<State> state) : state(std::move(state)) {}
+
+		/** a handle that is already loaded; eg the asset was previously loaded synchronously */
+		static AsyncAssetHandle resolved(const std::string& path, const sp<Asset>& asset)
+		{
+			sp<State> state = new_sp<State>();
+			state->path = path;
+			state->asset = asset;
+			state->status = asset ? EAsyncAssetStatus::LOADED : EAsyncAssetStatus::FAILED;
+			return AsyncAssetHandle(state);
+		}
+
+		bool isValid() const { return state != nullptr; }
+		bool isLoading() const { return state && state->status == EAsyncAssetStatus::LOADING; }
+		bool isLoaded() const { return state && state->status == EAsyncAssetStatus::LOADED; }
+		bool hasFailed() const { return state && state->status == EAsyncAssetStatus::FAILED; }
+
+		/** nullptr until loaded */
+		sp<Asset> getAsset() const { return isLoaded() ? state->asset : nullptr; }
+		const std::string& getPath() const { static const std::string empty; return state ? state->path : empty; }
+
+	private:
+		sp<State> state;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Type erased view of an AsyncAssetQueue so one pump can amortize uploads across every asset type.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class IAsyncUploadQueue
+	{
+	public:
+		virtual ~IAsyncUploadQueue() = default;
+
+		/** Runs the upload step for one decoded asset; returns false if nothing was waiting */
+		virtual bool uploadOne() = 0;
+		virtual bool hasPendingUploads() const = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Loads one kind of asset in two steps: decode runs on the worker pool, upload runs on the game thread.
+	//
+	// Requests for a path that is already loading (or loaded) return the existing handle, so a path is decoded
+	// at most once no matter how many systems ask for it in the same frame. request may be called from any thread;
+	// uploadOne must be called on the game thread (ie through an AsyncUploadPump).
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename Decoded, typename Asset>
+	class AsyncAssetQueue : public IAsyncUploadQueue, public RemoveCopies, public RemoveMoves
+	{
+	public:
+		/** worker thread; return nullptr on failure */
+		using DecodeFunc = std::function<up<Decoded>(const std::string& path)>;
+		/** game thread; return nullptr on failure */
+		using UploadFunc = std::function<sp<Asset>(const std::string& path, up<Decoded> decoded)>;
+		using Handle = AsyncAssetHandle<Asset>;
+
+	public:
+		AsyncAssetQueue(AssetWorkerPool& workerPool, DecodeFunc decode, UploadFunc upload)
+			: workerPool(workerPool), shared(new_sp<SharedData>()), upload(std::move(upload))
+		{
+			shared->decode = std::move(decode);
+		}
+
+		Handle request(const std::string& path)
+		{
+			sp<typename Handle::State> state;
+			{
+				std::lock_guard<std::mutex> lock(requestMutex);
+				auto existing = requests.find(path);
+				if (existing != requests.end())
+				{
+					return Handle(existing->second);
+				}
+
+				state = new_sp<typename Handle::State>();
+				state->path = path;
+				requests.insert({ path, state });
+			}
+
+			++numDecodesStarted;
+
+			//tasks only hold the shared data, so the queue may be destroyed while a decode is in flight
+			sp<SharedData> sharedData = shared;
+			workerPool.submit([sharedData, state]()
+			{
+				up<Decoded> decoded = sharedData->decode(state->path);
+
+				std::lock_guard<std::mutex> lock(sharedData->decodedMutex);
+				sharedData->decoded.push_back({ state, std::move(decoded) });
+			});
+
+			return Handle(state);
+		}
+
+		/** Forgets a path so the next request decodes it again; existing handles keep their state */
+		void forget(const std::string& path)
+		{
+			std::lock_guard<std::mutex> lock(requestMutex);
+			requests.erase(path);
+		}
+
+		virtual bool uploadOne() override
+		{
+			DecodedEntry entry;
+			{
+				std::lock_guard<std::mutex> lock(shared->decodedMutex);
+				if (shared->decoded.empty())
+				{
+					return false;
+				}
+				entry = std::move(shared->decoded.front());
+				shared->decoded.pop_front();
+			}
+
+			if (entry.decoded)
+			{
+				entry.state->asset = upload(entry.state->path, std::move(entry.decoded));
+			}
+			entry.state->status = entry.state->asset ? EAsyncAssetStatus::LOADED : EAsyncAssetStatus::FAILED;
+			return true;
+		}
+
+		virtual bool hasPendingUploads() const override
+		{
+			std::lock_guard<std::mutex> lock(shared->decodedMutex);
+			return !shared->decoded.empty();
+		}
+
+		size_t getNumDecodesStarted() const { return numDecodesStarted; }
+
+	private:
+		struct DecodedEntry
+		{
+			sp<typename Handle::State> state;
+			up<Decoded> decoded;
+		};
+
+		struct SharedData
+		{
+			DecodeFunc decode;
+			mutable std::mutex decodedMutex;
+			std::deque<DecodedEntry> decoded;
+		};
+
+	private:
+		AssetWorkerPool& workerPool;
+		sp<SharedData> shared;
+		UploadFunc upload;
+
+		std::mutex requestMutex;
+		std::map<std::string, sp<typename Handle::State>> requests;
+		std::atomic<size_t> numDecodesStarted{ 0 };
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Runs upload steps on the game thread within a per-frame time budget. Registered as a ticker with a
+	// TimeManager so that a burst of finished decodes (eg at level load) is spread over several frames.
+	// At least one upload runs every tick that has work, so progress is made even if a single upload is over budget.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AsyncUploadPump : public ITickable
+	{
+	public:
+		using ClockFunc = std::function<double()>; //milliseconds
+
+	public:
+		AsyncUploadPump(double budgetMsPerTick, ClockFunc clock = nullptr);
+
+		void addQueue(IAsyncUploadQueue& queue) { queues.push_back(&queue); }
+
+		/** returns number of uploads that ran */
+		size_t pumpUploads();
+		bool hasPendingUploads() const;
+
+		void setBudgetMs(double newBudgetMs) { budgetMs = newBudgetMs; }
+		double getBudgetMs() const { return budgetMs; }
+
+	protected:
+		virtual bool tick(float dt_sec) override;
+
+	private:
+		std::vector<IAsyncUploadQueue*> queues;
+		size_t nextQueueIdx = 0;	//round robin so one asset type cannot starve the others
+		double budgetMs;
+		ClockFunc clock;
+	};
+}
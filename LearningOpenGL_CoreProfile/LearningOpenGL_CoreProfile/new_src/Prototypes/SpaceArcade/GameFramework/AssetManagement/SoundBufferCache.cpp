@@ -0,0 +1,312 @@
+#include "SoundBufferCache.h"
+
+#include <algorithm>
+
+#include "../Audio/SoundRawData.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Pin
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	SoundBufferPin::SoundBufferPin(SoundBufferPin&& move) noexcept
+	{
+		*this = std::move(move);
+	}
+
+	SoundBufferPin& SoundBufferPin::operator=(SoundBufferPin&& move) noexcept
+	{
+		if (this != &move)
+		{
+			release();
+			cache = std::move(move.cache);
+			path = std::move(move.path);
+			entrySerial = move.entrySerial;
+			sound = std::move(move.sound);
+			buffer = move.buffer;
+
+			move.cache.reset();
+			move.path.clear();
+			move.entrySerial = 0;
+			move.sound = nullptr;
+			move.buffer = 0;
+		}
+		return *this;
+	}
+
+	void SoundBufferPin::release()
+	{
+		if (sound)
+		{
+			if (sp<SoundBufferCache> pinnedCache = cache.lock())
+			{
+				pinnedCache->unpin(path, entrySerial);
+			}
+			cache.reset();
+			path.clear();
+			entrySerial = 0;
+			sound = nullptr;
+			buffer = 0;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Cache
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	SoundBufferCache::SoundBufferCache(up<SoundBufferCacheBackend> backend, size_t budgetBytes)
+		: backend(std::move(backend)), budgetBytes(budgetBytes)
+	{
+	}
+
+	SoundBufferCache::~SoundBufferCache()
+	{
+		unloadAll();
+	}
+
+	sp<SoundRawData> SoundBufferCache::loadSound(const std::string& path)
+	{
+		Entry* entry = findOrLoad(path);
+		if (!entry)
+		{
+			return nullptr;
+		}
+
+		sp<SoundRawData> sound = entry->sound;
+		trim(entry);
+		return sound;
+	}
+
+	SoundBufferCache::BufferId SoundBufferCache::loadBuffer(const std::string& path)
+	{
+		Entry* entry = findOrLoad(path);
+		if (!entry)
+		{
+			return 0;
+		}
+
+		ensureBuffer(*entry);
+		const BufferId buffer = entry->buffer;
+		trim(entry);
+		return buffer;
+	}
+
+	SoundBufferPin SoundBufferCache::pin(const std::string& path, bool bWithBuffer)
+	{
+		SoundBufferPin newPin;
+		Entry* entry = findOrLoad(path);
+		if (!entry)
+		{
+			return newPin;
+		}
+
+		if (bWithBuffer)
+		{
+			ensureBuffer(*entry);
+		}
+
+		if (entry->numPins++ == 0)
+		{
+			lru.erase(entry->lruPosition);
+			stats.pinnedBytes += entry->numBytes;
+			++stats.numPinned;
+		}
+
+		newPin.cache = sp_this();
+		newPin.path = path;
+		newPin.entrySerial = entry->serial;
+		newPin.sound = entry->sound;
+		newPin.buffer = entry->buffer;
+
+		trim();
+		return newPin;
+	}
+
+	sp<SoundRawData> SoundBufferCache::insert(const std::string& path, up<SoundRawData> sound)
+	{
+		auto findIter = entries.find(path);
+		if (findIter != entries.end())
+		{
+			return findIter->second.sound;
+		}
+		if (!sound)
+		{
+			return nullptr;
+		}
+
+		Entry& entry = addEntry(path, sp<SoundRawData>(std::move(sound)));
+		sp<SoundRawData> inserted = entry.sound;
+		trim(&entry);
+		return inserted;
+	}
+
+	sp<SoundRawData> SoundBufferCache::find(const std::string& path) const
+	{
+		auto findIter = entries.find(path);
+		return findIter != entries.end() ? findIter->second.sound : nullptr;
+	}
+
+	bool SoundBufferCache::unload(const std::string& path)
+	{
+		auto findIter = entries.find(path);
+		if (findIter == entries.end() || findIter->second.numPins > 0)
+		{
+			return false;
+		}
+		erase(findIter->second);
+		return true;
+	}
+
+	void SoundBufferCache::unloadAll()
+	{
+		for (auto& kv_pair : entries)
+		{
+			if (kv_pair.second.buffer != 0)
+			{
+				backend->destroyBuffer(kv_pair.second.buffer);
+			}
+		}
+		entries.clear();
+		lru.clear();
+		stats.residentBytes = 0;
+		stats.pinnedBytes = 0;
+		stats.numResident = 0;
+		stats.numPinned = 0;
+	}
+
+	void SoundBufferCache::setBudget(size_t newBudgetBytes)
+	{
+		budgetBytes = newBudgetBytes;
+		trim();
+	}
+
+	void SoundBufferCache::resetHitStats()
+	{
+		stats.numHits = 0;
+		stats.numMisses = 0;
+		stats.numEvictions = 0;
+		stats.numFailedLoads = 0;
+		stats.peakResidentBytes = stats.residentBytes;
+	}
+
+	SoundBufferCache::Entry* SoundBufferCache::findOrLoad(const std::string& path)
+	{
+		auto findIter = entries.find(path);
+		if (findIter != entries.end())
+		{
+			++stats.numHits;
+			touch(findIter->second);
+			return &findIter->second;
+		}
+
+		++stats.numMisses;
+		up<SoundRawData> sound = backend->decode(path);
+		if (!sound)
+		{
+			++stats.numFailedLoads;
+			return nullptr;
+		}
+		return &addEntry(path, sp<SoundRawData>(std::move(sound)));
+	}
+
+	SoundBufferCache::Entry& SoundBufferCache::addEntry(const std::string& path, sp<SoundRawData> sound)
+	{
+		Entry& entry = entries[path];
+		entry.path = path;
+		entry.sound = std::move(sound);
+		entry.numBytes = pcmBytes(*entry.sound);
+		entry.serial = nextSerial++;
+		lru.push_front(&entry);
+		entry.lruPosition = lru.begin();
+
+		stats.residentBytes += entry.numBytes;
+		stats.peakResidentBytes = std::max(stats.peakResidentBytes, stats.residentBytes);
+		++stats.numResident;
+		return entry;
+	}
+
+	void SoundBufferCache::ensureBuffer(Entry& entry)
+	{
+		if (entry.buffer == 0)
+		{
+			entry.buffer = backend->createBuffer(*entry.sound);
+			if (entry.buffer != 0)
+			{
+				//the api keeps its own copy of the samples
+				const size_t bufferBytes = pcmBytes(*entry.sound);
+				entry.numBytes += bufferBytes;
+				stats.residentBytes += bufferBytes;
+				stats.pinnedBytes += entry.numPins > 0 ? bufferBytes : 0;
+				stats.peakResidentBytes = std::max(stats.peakResidentBytes, stats.residentBytes);
+			}
+		}
+	}
+
+	void SoundBufferCache::touch(Entry& entry)
+	{
+		if (entry.numPins == 0)
+		{
+			lru.splice(lru.begin(), lru, entry.lruPosition);
+		}
+	}
+
+	void SoundBufferCache::unpin(const std::string& path, uint64_t serial)
+	{
+		auto findIter = entries.find(path);
+		if (findIter == entries.end() || findIter->second.serial != serial || findIter->second.numPins == 0)
+		{
+			return;
+		}
+
+		Entry& entry = findIter->second;
+		if (--entry.numPins == 0)
+		{
+			//it was in use until now, so it goes back in as the most recently used
+			lru.push_front(&entry);
+			entry.lruPosition = lru.begin();
+			stats.pinnedBytes -= entry.numBytes;
+			--stats.numPinned;
+
+			//anything loaded while this was pinned may have put the cache over budget
+			trim();
+		}
+	}
+
+	void SoundBufferCache::trim(const Entry* justUsed)
+	{
+		//the sound just used is the most recently used, so it is only reached when it alone is over budget; it is kept
+		//rather than handing back a buffer that has already been destroyed
+		while (stats.residentBytes > budgetBytes && !lru.empty() && lru.back() != justUsed)
+		{
+			erase(*lru.back());
+			++stats.numEvictions;
+		}
+	}
+
+	void SoundBufferCache::erase(Entry& entry)
+	{
+		if (entry.buffer != 0)
+		{
+			backend->destroyBuffer(entry.buffer);
+		}
+		if (entry.numPins == 0)
+		{
+			lru.erase(entry.lruPosition);
+		}
+		else
+		{
+			stats.pinnedBytes -= entry.numBytes;
+			--stats.numPinned;
+		}
+		stats.residentBytes -= entry.numBytes;
+		--stats.numResident;
+
+		//copy the key; it lives in the entry being erased
+		const std::string path = entry.path;
+		entries.erase(path);
+	}
+
+	size_t SoundBufferCache::pcmBytes(const SoundRawData& sound)
+	{
+		return sound.pcmData.size() * sizeof(uint16_t);
+	}
+}
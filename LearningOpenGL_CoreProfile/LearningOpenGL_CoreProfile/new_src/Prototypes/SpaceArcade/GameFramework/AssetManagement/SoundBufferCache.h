@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "../SAGameEntity.h"
+#include "../../Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	struct SoundRawData;
+	class SoundBufferCache;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Decodes sounds and owns the audio api buffers made from them. Split from the cache so the cache's
+	// policy can run without an audio device.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SoundBufferCacheBackend
+	{
+	public:
+		using BufferId = uint32_t;
+		virtual ~SoundBufferCacheBackend() = default;
+
+		/** nullptr if the sound could not be decoded */
+		virtual up<SoundRawData> decode(const std::string& path) = 0;
+
+		/** 0 if no buffer could be made (eg there is no audio device); the decoded sound stays usable by the software mixer */
+		virtual BufferId createBuffer(const SoundRawData& sound) = 0;
+		virtual void destroyBuffer(BufferId buffer) = 0;
+	};
+
+	struct SoundBufferCacheStats
+	{
+		uint64_t numHits = 0;
+		uint64_t numMisses = 0;
+		uint64_t numEvictions = 0;
+		uint64_t numFailedLoads = 0;
+		size_t residentBytes = 0;
+		size_t peakResidentBytes = 0;
+		size_t pinnedBytes = 0;
+		size_t numResident = 0;
+		size_t numPinned = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Keeps a cached sound (and its buffer) from being evicted for as long as it is held. Hold one for as long as
+	// the buffer is attached to a source, or the pcm is being mixed.
+	//
+	// Pins may safely outlive the entry (eg the cache was emptied at shutdown) or the cache itself; releasing
+	// them then does nothing.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SoundBufferPin
+	{
+	public:
+		SoundBufferPin() = default;
+		~SoundBufferPin() { release(); }
+		SoundBufferPin(SoundBufferPin&& move) noexcept;
+		SoundBufferPin& operator=(SoundBufferPin&& move) noexcept;
+		SoundBufferPin(const SoundBufferPin& copy) = delete;
+		SoundBufferPin& operator=(const SoundBufferPin& copy) = delete;
+
+		void release();
+
+		explicit operator bool() const { return sound != nullptr; }
+		SoundBufferCacheBackend::BufferId getBuffer() const { return buffer; }
+		const sp<SoundRawData>& getSound() const { return sound; }
+		const std::string& getPath() const { return path; }
+
+	private:
+		friend class SoundBufferCache;
+		wp<SoundBufferCache> cache;
+		std::string path;
+		uint64_t entrySerial = 0;		//a reloaded sound is a new entry; an old pin must not unpin it
+		sp<SoundRawData> sound;
+		SoundBufferCacheBackend::BufferId buffer = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Decoded sounds and their api buffers, keyed by path, held within a memory budget.
+	//
+	// Resident bytes count the decoded pcm and, once one is made, the buffer's copy of it. When a load puts the
+	// cache over budget, the least recently used unpinned sounds are evicted until it fits again. Pinned sounds
+	// are never evicted, so the cache can sit over budget while everything in it is playing; it trims once pins
+	// are released. Likewise a single sound bigger than the whole budget stays until something else is loaded.
+	//
+	// Buffers are only made for sounds that ask for one, as sounds that are only software mixed don't need one.
+	//
+	// Evicted sounds are released by the cache; users outside the cache that hold the pcm keep it alive
+	// (eg a voice fading out), but its buffer is destroyed.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SoundBufferCache : public GameEntity, public RemoveCopies, public RemoveMoves
+	{
+	public:
+		using BufferId = SoundBufferCacheBackend::BufferId;
+
+		SoundBufferCache(up<SoundBufferCacheBackend> backend, size_t budgetBytes);
+		~SoundBufferCache();
+
+		/** decodes on a miss; counts as a use. The result is not pinned, so a later load may evict it */
+		sp<SoundRawData> loadSound(const std::string& path);
+
+		/** loadSound, making the sound's buffer if it doesn't have one; 0 if a buffer could not be made */
+		BufferId loadBuffer(const std::string& path);
+
+		/** loads the sound (and buffer if requested) and pins it; the pin is empty if the sound failed to load */
+		SoundBufferPin pin(const std::string& path, bool bWithBuffer);
+
+		/** adds a sound decoded elsewhere (eg an async load); a sound already cached for the path wins */
+		sp<SoundRawData> insert(const std::string& path, up<SoundRawData> sound);
+
+		/** does not load, and does not count as a use */
+		sp<SoundRawData> find(const std::string& path) const;
+		bool isResident(const std::string& path) const { return entries.find(path) != entries.end(); }
+
+		/** fails if the sound is pinned */
+		bool unload(const std::string& path);
+
+		/** releases everything, pinned or not; for when the audio device goes away */
+		void unloadAll();
+
+		void setBudget(size_t budgetBytes);
+		size_t getBudget() const { return budgetBytes; }
+		const SoundBufferCacheStats& getStats() const { return stats; }
+		void resetHitStats();
+
+	private:
+		struct Entry
+		{
+			sp<SoundRawData> sound;
+			BufferId buffer = 0;
+			size_t numBytes = 0;
+			uint32_t numPins = 0;
+			uint64_t serial = 0;
+			std::list<Entry*>::iterator lruPosition;		//only valid while unpinned
+			std::string path;
+		};
+
+		Entry* findOrLoad(const std::string& path);
+		Entry& addEntry(const std::string& path, sp<SoundRawData> sound);
+		void ensureBuffer(Entry& entry);
+		void touch(Entry& entry);
+		void unpin(const std::string& path, uint64_t serial);
+		void trim(const Entry* justUsed = nullptr);
+		void erase(Entry& entry);
+		static size_t pcmBytes(const SoundRawData& sound);
+
+	private:
+		up<SoundBufferCacheBackend> backend;
+		std::unordered_map<std::string, Entry> entries;
+		std::list<Entry*> lru;		//front is most recently used; pinned entries are taken out until unpinned
+		SoundBufferCacheStats stats;
+		size_t budgetBytes = 0;
+		uint64_t nextSerial = 1;
+
+		friend class SoundBufferPin;
+	};
+}
@@ -0,0 +1,153 @@
+#include "AudioEmitterSelector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace SA
+{
+	void AudioEmitterSelector::clear()
+	{
+		numEmitters = 0;
+		selected.clear();
+		evicted.clear();
+		softwareMixed.clear();
+	}
+
+	void AudioEmitterSelector::reserve(size_t numToReserve)
+	{
+		if (numToReserve > posX.size())
+		{
+			resizeArrays(numToReserve);
+		}
+	}
+
+	uint32_t AudioEmitterSelector::add(const glm::vec3& position, float inMaxRadius, float inCategoryPriority, bool bInHasSource, bool bInActive)
+	{
+		//written by index rather than pushed, since the audio system gathers every active emitter every tick
+		const size_t idx = numEmitters++;
+		if (idx == posX.size())
+		{
+			resizeArrays(std::max<size_t>(64, posX.size() * 2));
+		}
+
+		posX[idx] = position.x;
+		posY[idx] = position.y;
+		posZ[idx] = position.z;
+		maxRadius[idx] = inMaxRadius;
+		categoryPriority[idx] = inCategoryPriority;
+		bHasSource[idx] = bInHasSource;
+		bActive[idx] = bInActive;
+		return uint32_t(idx);
+	}
+
+	void AudioEmitterSelector::resizeArrays(size_t newSize)
+	{
+		posX.resize(newSize);
+		posY.resize(newSize);
+		posZ.resize(newSize);
+		maxRadius.resize(newSize);
+		categoryPriority.resize(newSize);
+		bHasSource.resize(newSize);
+		bActive.resize(newSize);
+		priority.resize(newSize);
+		selectionKey.resize(newSize);
+		closestListener.resize(newSize);
+		bInRange.resize(newSize);
+		bSelected.resize(newSize);
+	}
+
+	void AudioEmitterSelector::score(const std::vector<glm::vec3>& listenerPositions)
+	{
+		if (listenerPositions.empty())
+		{
+			for (size_t idx = 0; idx < numEmitters; ++idx)
+			{
+				priority[idx] = categoryPriority[idx];
+				selectionKey[idx] = priority[idx] - (bHasSource[idx] ? sourceHysteresis : 0.f);
+				closestListener[idx] = 0;
+				bInRange[idx] = bActive[idx];
+			}
+			return;
+		}
+
+		for (size_t idx = 0; idx < numEmitters; ++idx)
+		{
+			//closest listener; in split screen this is the listener the emitter is remapped around
+			float closestDist2 = std::numeric_limits<float>::infinity();
+			uint32_t closestIdx = 0;
+			for (size_t listenerIdx = 0; listenerIdx < listenerPositions.size(); ++listenerIdx)
+			{
+				const float dx = listenerPositions[listenerIdx].x - posX[idx];
+				const float dy = listenerPositions[listenerIdx].y - posY[idx];
+				const float dz = listenerPositions[listenerIdx].z - posZ[idx];
+				const float dist2 = dx * dx + dy * dy + dz * dz;
+				if (dist2 < closestDist2)
+				{
+					closestDist2 = dist2;
+					closestIdx = uint32_t(listenerIdx);
+				}
+			}
+
+			const float radius2 = maxRadius[idx] * maxRadius[idx];
+			const bool bWithinRadius = bHasSource[idx] ? closestDist2 <= radius2 * rangeHysteresis : closestDist2 < radius2;
+
+			//distance only matters for emitters that can be selected, so only they pay for the square root
+			const float distanceFraction = bWithinRadius && maxRadius[idx] > 0.f ? std::min(std::sqrt(closestDist2) / maxRadius[idx], 1.f) : 1.f;
+
+			priority[idx] = categoryPriority[idx] + distanceFraction;
+			selectionKey[idx] = priority[idx] - (bHasSource[idx] ? sourceHysteresis : 0.f);
+			closestListener[idx] = closestIdx;
+			bInRange[idx] = bActive[idx] && bWithinRadius;
+		}
+	}
+
+	void AudioEmitterSelector::select(size_t maxSelected, size_t maxSoftwareMixed)
+	{
+		selected.clear();
+		evicted.clear();
+		softwareMixed.clear();
+
+		for (uint32_t idx = 0; idx < uint32_t(size()); ++idx)
+		{
+			if (bInRange[idx])
+			{
+				selected.push_back(idx);
+			}
+		}
+
+		//ties go to the emitter added first, so the result is the same as the front of a full sort
+		auto isMoreImportant = [this](uint32_t first, uint32_t second)
+		{
+			const float firstKey = selectionKey[first];
+			const float secondKey = selectionKey[second];
+			return firstKey < secondKey || (firstKey == secondKey && first < second);
+		};
+		const size_t maxCandidates = maxSelected + maxSoftwareMixed;
+		if (selected.size() > maxCandidates)
+		{
+			std::nth_element(selected.begin(), selected.begin() + maxCandidates, selected.end(), isMoreImportant);
+			selected.resize(maxCandidates);
+		}
+		if (selected.size() > maxSelected)
+		{
+			std::nth_element(selected.begin(), selected.begin() + maxSelected, selected.end(), isMoreImportant);
+			softwareMixed.assign(selected.begin() + maxSelected, selected.end());
+			selected.resize(maxSelected);
+		}
+		std::sort(selected.begin(), selected.end(), isMoreImportant);
+
+		std::fill(bSelected.begin(), bSelected.begin() + numEmitters, uint8_t(0));
+		for (uint32_t idx : selected)
+		{
+			bSelected[idx] = 1;
+		}
+		for (uint32_t idx = 0; idx < uint32_t(size()); ++idx)
+		{
+			if (bHasSource[idx] && !bSelected[idx])
+			{
+				evicted.push_back(idx);
+			}
+		}
+	}
+}
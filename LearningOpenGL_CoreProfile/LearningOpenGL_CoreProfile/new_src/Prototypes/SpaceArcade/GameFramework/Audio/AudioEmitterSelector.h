@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Picks which emitters get one of the limited hardware sources each audio tick.
+	//
+	// The state scored for every active emitter is kept in parallel arrays, so scoring thousands of emitters is a
+	// linear walk rather than a chase through every emitter's allocation. Instead of sorting every emitter, the best
+	// K are found with nth_element and only those K are sorted; emitters that lose do no further work.
+	//
+	// The next best in range emitters after the K can also be picked out (unsorted) for software mixing; see SoftwareMixer.
+	//
+	// Priority works like AudioEmitterPriority: lower is more important. The category is the whole number part and
+	// the distance to the closest listener (as a fraction of the emitter's radius) is added to it.
+	//
+	// Hysteresis keeps sources from thrashing between emitters of near equal priority:
+	//	*an emitter that already has a source is treated as sourceHysteresis more important.
+	//	*an emitter that already has a source stays in range until it is rangeHysteresis past its radius.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioEmitterSelector
+	{
+	public:
+		float sourceHysteresis = 0.05f;
+		float rangeHysteresis = 1.01f;
+
+	public:
+		void clear();
+		void reserve(size_t numEmitters);
+
+		/** returns the emitter's index for this tick; inactive emitters are never selected */
+		uint32_t add(const glm::vec3& position, float maxRadius, float categoryPriority, bool bHasSource, bool bActive);
+
+		/** finds every emitter's closest listener and priority; with no listeners, emitters are only prioritized by category */
+		void score(const std::vector<glm::vec3>& listenerPositions);
+
+		/** selects up to maxSelected in range emitters, best first, then up to maxSoftwareMixed of the runners up; must be called after score */
+		void select(size_t maxSelected, size_t maxSoftwareMixed = 0);
+
+		/** emitters that won a source, best first */
+		const std::vector<uint32_t>& getSelected() const { return selected; }
+		/** emitters that hold a source but did not win one */
+		const std::vector<uint32_t>& getEvicted() const { return evicted; }
+		/** in range emitters that just missed out on a source, in no particular order */
+		const std::vector<uint32_t>& getSoftwareMixed() const { return softwareMixed; }
+
+		size_t size() const { return numEmitters; }
+		float getPriority(uint32_t idx) const { return priority[idx]; }
+		/** priority with the source hysteresis applied; the value selection orders by */
+		float getSelectionKey(uint32_t idx) const { return selectionKey[idx]; }
+		uint32_t getClosestListener(uint32_t idx) const { return closestListener[idx]; }
+		bool isInRange(uint32_t idx) const { return bInRange[idx] != 0; }
+
+	private:
+		void resizeArrays(size_t newSize);
+
+	private:
+		//arrays only grow; numEmitters is how many are in use this tick
+		size_t numEmitters = 0;
+
+		//per emitter input
+		std::vector<float> posX, posY, posZ;
+		std::vector<float> maxRadius;
+		std::vector<float> categoryPriority;
+		std::vector<uint8_t> bHasSource;
+		std::vector<uint8_t> bActive;
+
+		//per emitter output of score
+		std::vector<float> priority;
+		std::vector<float> selectionKey;
+		std::vector<uint32_t> closestListener;
+		std::vector<uint8_t> bInRange;
+
+		std::vector<uint32_t> selected;
+		std::vector<uint32_t> evicted;
+		std::vector<uint32_t> softwareMixed;
+		std::vector<uint8_t> bSelected;
+	};
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "AudioEmitterSelector.h"
+#include "../SAGameEntity.h"
+
+/*
+	Headless benchmark for choosing which audio emitters get hardware sources; no audio device or game systems are created.
+
+	Mimics a large fight: thousands of active emitters (engine loops, projectiles) and two split screen listeners, with 255
+	sources to hand out. The "full sort" run is the pipeline this replaced: priorities are written into each separately
+	allocated emitter, then every active emitter handle is sorted, checking the handle's weak pointer in the comparator.
+	The selector run gathers into parallel arrays, scores them, and only sorts the winners.
+*/
+
+namespace
+{
+	using namespace SA;
+
+	struct HeapEmitterState
+	{
+		glm::vec3 position;
+		float maxRadius = 0.f;
+		float category = 0.f;
+		float calculatedPriority = 0.f;
+		bool bInRange = false;
+		char otherEmitterState[256]; //user data, hardware data, and the rest of the meta data sit alongside in a real emitter
+	};
+
+	/** like AudioEmitterHandle */
+	struct EmitterHandle
+	{
+		HeapEmitterState* raw;
+		wp<HeapEmitterState> weak;
+		operator bool() const { return !weak.expired(); }
+	};
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	void true_main()
+	{
+		const size_t numEmitters = 10000;
+		const size_t numSources = 255;
+		const int numTicks = 300;
+		const std::vector<glm::vec3> listeners = { glm::vec3(0.f), glm::vec3(300.f, 0.f, 0.f) };
+
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> coord(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> radius(50.f, 500.f);
+		std::uniform_int_distribution<int> category(0, 5);
+
+		std::vector<sp<HeapEmitterState>> emitters;
+		for (size_t idx = 0; idx < numEmitters; ++idx)
+		{
+			sp<HeapEmitterState> emitter = new_sp<HeapEmitterState>();
+			emitter->position = glm::vec3(coord(rng), coord(rng), coord(rng));
+			emitter->maxRadius = radius(rng);
+			emitter->category = float(category(rng));
+			emitters.push_back(emitter);
+		}
+		std::shuffle(emitters.begin(), emitters.end(), rng);
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// full sort
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		std::vector<EmitterHandle> handles;
+		for (const sp<HeapEmitterState>& emitter : emitters)
+		{
+			handles.push_back(EmitterHandle{ emitter.get(), emitter });
+		}
+
+		size_t fullSortChecksum = 0;
+		Clock::time_point start = Clock::now();
+		for (int tick = 0; tick < numTicks; ++tick)
+		{
+			for (const EmitterHandle& emitter : handles)
+			{
+				float closestDist2 = std::numeric_limits<float>::infinity();
+				for (const glm::vec3& listener : listeners)
+				{
+					const glm::vec3 delta = listener - emitter.raw->position;
+					closestDist2 = std::min(closestDist2, glm::dot(delta, delta));
+				}
+				const bool bInRange = closestDist2 < emitter.raw->maxRadius * emitter.raw->maxRadius;
+				emitter.raw->calculatedPriority = emitter.raw->category + (bInRange ? std::sqrt(closestDist2) / emitter.raw->maxRadius : 1.f);
+				emitter.raw->bInRange = bInRange;
+			}
+			std::sort(handles.begin(), handles.end(), [](const EmitterHandle& first, const EmitterHandle& second)
+			{
+				if (!second) { return true; }
+				if (!first) { return false; }
+				return first.raw->calculatedPriority < second.raw->calculatedPriority;
+			});
+			for (size_t idx = 0; idx < numSources && idx < handles.size(); ++idx)
+			{
+				fullSortChecksum += handles[idx].raw->bInRange;
+			}
+		}
+		const double fullSortMs = elapsedMs(start);
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// selector; gathering is included since the audio system gathers every tick
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		AudioEmitterSelector selector;
+		selector.rangeHysteresis = 1.f;
+		selector.sourceHysteresis = 0.f;
+		size_t selectorChecksum = 0;
+		start = Clock::now();
+		for (int tick = 0; tick < numTicks; ++tick)
+		{
+			selector.clear();
+			for (const EmitterHandle& handle : handles)
+			{
+				HeapEmitterState* emitter = handle.raw;
+				selector.add(emitter->position, emitter->maxRadius, emitter->category, /*bHasSource*/false, /*bActive*/true);
+			}
+			selector.score(listeners);
+			selector.select(numSources);
+			selectorChecksum += selector.getSelected().size();
+		}
+		const double selectorMs = elapsedMs(start);
+
+		//the full sort ranked out of range emitters by category too, so some of its sources went to emitters nobody could hear
+		std::cout << numEmitters << " emitters, " << numSources << " sources, " << listeners.size() << " listeners\n"
+			<< "\tfull sort: " << fullSortMs / numTicks << " ms per tick; in range emitters given sources " << fullSortChecksum / numTicks << "\n"
+			<< "\tselector:  " << selectorMs / numTicks << " ms per tick; in range emitters given sources " << selectorChecksum / numTicks << std::endl;
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
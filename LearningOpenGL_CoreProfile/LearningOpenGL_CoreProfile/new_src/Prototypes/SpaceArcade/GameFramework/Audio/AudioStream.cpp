@@ -0,0 +1,293 @@
+#include "AudioStream.h"
+#include "../AssetManagement/AsyncAssetLoader.h"
+
+#include <algorithm>
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Null backend
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	AudioStreamBackend::BufferId NullAudioStreamBackend::createBuffer()
+	{
+		BufferId buffer = nextBufferId++;
+		buffers[buffer] = {};
+		return buffer;
+	}
+
+	void NullAudioStreamBackend::destroyBuffer(BufferId buffer)
+	{
+		buffers.erase(buffer);
+	}
+
+	void NullAudioStreamBackend::fillBuffer(BufferId buffer, unsigned int channels, unsigned int sampleRate, const int16_t* samples, size_t numSamples)
+	{
+		buffers[buffer].assign(samples, samples + numSamples);
+	}
+
+	void NullAudioStreamBackend::queueBuffer(SourceId source, BufferId buffer)
+	{
+		sources[source].queued.push_back(buffer);
+	}
+
+	bool NullAudioStreamBackend::unqueueProcessedBuffer(SourceId source, BufferId& outBuffer)
+	{
+		NullSource& nullSource = sources[source];
+		if (nullSource.numProcessed == 0)
+		{
+			return false;
+		}
+		outBuffer = nullSource.queued.front();
+		nullSource.queued.pop_front();
+		--nullSource.numProcessed;
+		return true;
+	}
+
+	void NullAudioStreamBackend::stopAndUnqueueAll(SourceId source)
+	{
+		NullSource& nullSource = sources[source];
+		nullSource.queued.clear();
+		nullSource.numProcessed = 0;
+		nullSource.bPlaying = false;
+	}
+
+	void NullAudioStreamBackend::play(SourceId source)
+	{
+		NullSource& nullSource = sources[source];
+		if (!nullSource.bPlaying)
+		{
+			//like OpenAL, playing a stopped source starts over from the first queued buffer, even if it was already processed
+			nullSource.numProcessed = 0;
+			nullSource.bPlaying = !nullSource.queued.empty();
+		}
+	}
+
+	bool NullAudioStreamBackend::isPlaying(SourceId source)
+	{
+		return sources[source].bPlaying;
+	}
+
+	size_t NullAudioStreamBackend::playBuffers(SourceId source, size_t numBuffers)
+	{
+		NullSource& nullSource = sources[source];
+		size_t numPlayed = 0;
+		while (nullSource.bPlaying && numPlayed < numBuffers && nullSource.numProcessed < nullSource.queued.size())
+		{
+			const std::vector<int16_t>& samples = buffers[nullSource.queued[nullSource.numProcessed]];
+			nullSource.played.insert(nullSource.played.end(), samples.begin(), samples.end());
+			++nullSource.numProcessed;
+			++numPlayed;
+		}
+		if (nullSource.numProcessed == nullSource.queued.size())
+		{
+			nullSource.bPlaying = false;
+		}
+		return numPlayed;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Audio stream
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	AudioStream::AudioStream(up<AudioStreamDecoder> decoder, AudioStreamBackend& backend, AssetWorkerPool& decodePool, const AudioStreamConfig& config)
+		: backend(backend), decodePool(decodePool), decodeState(new_sp<DecodeState>())
+	{
+		channels = decoder->getChannels();
+		sampleRate = decoder->getSampleRate();
+		durationSec = decoder->getDurationSec();
+
+		const size_t numBuffers = std::max<size_t>(config.numBuffers, 2); //one playing while the other is refilled
+		decodeState->decoder = std::move(decoder);
+		decodeState->framesPerChunk = std::max<size_t>(config.framesPerChunk, 1);
+		decodeState->bLooping = config.bLooping;
+		decodeState->freeChunks.resize(numBuffers);
+
+		for (size_t bufferIdx = 0; bufferIdx < numBuffers; ++bufferIdx)
+		{
+			allBuffers.push_back(backend.createBuffer());
+		}
+		freeBuffers = allBuffers;
+	}
+
+	AudioStream::~AudioStream()
+	{
+		decodeState->bCancelled = true;
+		if (bAttached)
+		{
+			detach();
+		}
+		for (AudioStreamBackend::BufferId buffer : allBuffers)
+		{
+			backend.destroyBuffer(buffer);
+		}
+	}
+
+	void AudioStream::prefetch()
+	{
+		requestDecode();
+	}
+
+	void AudioStream::attach(SourceId inSource)
+	{
+		if (bAttached)
+		{
+			detach();
+		}
+
+		source = inSource;
+		bAttached = true;
+		bStartedPlaying = false;
+
+		//a pooled source may still hold buffers from the last sound it played
+		backend.stopAndUnqueueAll(source);
+		service();
+	}
+
+	void AudioStream::detach()
+	{
+		if (bAttached)
+		{
+			backend.stopAndUnqueueAll(source);
+			freeBuffers = allBuffers;
+			numQueued = 0;
+			bAttached = false;
+		}
+	}
+
+	void AudioStream::service()
+	{
+		if (!bAttached)
+		{
+			return;
+		}
+
+		const bool bStarved = bStartedPlaying && !backend.isPlaying(source);
+
+		AudioStreamBackend::BufferId playedBuffer = 0;
+		while (backend.unqueueProcessedBuffer(source, playedBuffer))
+		{
+			freeBuffers.push_back(playedBuffer);
+			--numQueued;
+		}
+
+		queueDecodedChunks();
+		requestDecode();
+
+		if (numQueued > 0 && !backend.isPlaying(source))
+		{
+			stats.numUnderruns += bStarved;
+			backend.play(source);
+			bStartedPlaying = true;
+		}
+		bFinished = bQueuedLast && numQueued == 0;
+	}
+
+	void AudioStream::setLooping(bool bLooping)
+	{
+		//only affects chunks that have not been decoded yet
+		decodeState->bLooping = bLooping;
+	}
+
+	void AudioStream::queueDecodedChunks()
+	{
+		while (!freeBuffers.empty())
+		{
+			Chunk chunk;
+			{
+				std::lock_guard<std::mutex> lock(decodeState->mutex);
+				if (decodeState->decodedChunks.empty())
+				{
+					return;
+				}
+				chunk = std::move(decodeState->decodedChunks.front());
+				decodeState->decodedChunks.pop_front();
+			}
+
+			//the backend copies the samples, so the chunk can go straight back to the decoder
+			if (chunk.numFrames > 0)
+			{
+				AudioStreamBackend::BufferId buffer = freeBuffers.back();
+				freeBuffers.pop_back();
+				backend.fillBuffer(buffer, channels, sampleRate, chunk.samples.data(), chunk.numFrames * channels);
+				backend.queueBuffer(source, buffer);
+				++numQueued;
+				++stats.numChunksQueued;
+			}
+			bQueuedLast |= chunk.bLast;
+
+			std::lock_guard<std::mutex> lock(decodeState->mutex);
+			decodeState->freeChunks.push_back(std::move(chunk));
+		}
+	}
+
+	void AudioStream::requestDecode()
+	{
+		{
+			std::lock_guard<std::mutex> lock(decodeState->mutex);
+			if (decodeState->bTaskInFlight || decodeState->bReachedEnd || decodeState->freeChunks.empty())
+			{
+				return;
+			}
+			decodeState->bTaskInFlight = true;
+		}
+
+		sp<DecodeState> state = decodeState;
+		decodePool.submit([state]() { decodeChunks(state); });
+	}
+
+	void AudioStream::decodeChunks(const sp<DecodeState>& state)
+	{
+		//one task decodes until every free chunk is full, so chunks are always decoded in order
+		while (true)
+		{
+			Chunk chunk;
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (state->bCancelled || state->bReachedEnd || state->freeChunks.empty())
+				{
+					state->bTaskInFlight = false;
+					return;
+				}
+				chunk = std::move(state->freeChunks.back());
+				state->freeChunks.pop_back();
+			}
+
+			decodeChunk(*state, chunk);
+
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->bReachedEnd = chunk.bLast;
+			state->decodedChunks.push_back(std::move(chunk));
+		}
+	}
+
+	void AudioStream::decodeChunk(DecodeState& state, Chunk& chunk)
+	{
+		AudioStreamDecoder& decoder = *state.decoder;
+		const size_t channels = decoder.getChannels();
+
+		chunk.samples.resize(state.framesPerChunk * channels);
+		chunk.numFrames = 0;
+		chunk.bLast = false;
+
+		bool bJustLooped = false;
+		while (chunk.numFrames < state.framesPerChunk)
+		{
+			const size_t numRead = decoder.readFrames(&chunk.samples[chunk.numFrames * channels], state.framesPerChunk - chunk.numFrames);
+			chunk.numFrames += numRead;
+
+			if (chunk.numFrames < state.framesPerChunk)
+			{
+				//end of the sound; when looping keep filling this chunk from the start so the seam has no gap
+				const bool bEmptySound = bJustLooped && numRead == 0;
+				if (state.bLooping && !bEmptySound && decoder.seekToStart())
+				{
+					bJustLooped = true;
+				}
+				else
+				{
+					chunk.bLast = true;
+					break;
+				}
+			}
+		}
+	}
+}
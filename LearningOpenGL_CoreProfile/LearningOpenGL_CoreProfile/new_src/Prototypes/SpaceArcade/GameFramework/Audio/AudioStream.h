@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+#include "../SAGameEntity.h"
+#include "../../Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class AssetWorkerPool;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Produces interleaved 16 bit pcm a piece at a time. Only ever used by one decode task at a time, so
+	// implementations do not need to be thread safe.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioStreamDecoder
+	{
+	public:
+		virtual ~AudioStreamDecoder() = default;
+
+		/** returns the number of frames written; fewer than maxFrames means the end of the sound was reached */
+		virtual size_t readFrames(int16_t* outSamples, size_t maxFrames) = 0;
+		virtual bool seekToStart() = 0;
+
+		virtual unsigned int getChannels() const = 0;
+		virtual unsigned int getSampleRate() const = 0;
+		virtual float getDurationSec() const = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// The audio api calls a stream makes; lets a stream run against a null device (eg headless tests).
+	// Mirrors the OpenAL buffer queue: buffers are queued on a source in order, the source marks them processed as
+	// it plays through them, and a source that plays through every queued buffer stops.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioStreamBackend
+	{
+	public:
+		using BufferId = uint32_t;
+		using SourceId = uint32_t;
+
+	public:
+		virtual ~AudioStreamBackend() = default;
+
+		virtual BufferId createBuffer() = 0;
+		virtual void destroyBuffer(BufferId buffer) = 0;
+		virtual void fillBuffer(BufferId buffer, unsigned int channels, unsigned int sampleRate, const int16_t* samples, size_t numSamples) = 0;
+
+		virtual void queueBuffer(SourceId source, BufferId buffer) = 0;
+		/** pops the oldest buffer the source has finished playing; returns false if there is none */
+		virtual bool unqueueProcessedBuffer(SourceId source, BufferId& outBuffer) = 0;
+		/** stops the source and removes every queued buffer, processed or not */
+		virtual void stopAndUnqueueAll(SourceId source) = 0;
+
+		virtual void play(SourceId source) = 0;
+		virtual bool isPlaying(SourceId source) = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Backend without a device. Playback only advances when playBuffers is called, and everything played is
+	// recorded, so tests can check exactly what a listener would have heard.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class NullAudioStreamBackend : public AudioStreamBackend
+	{
+	public:
+		virtual BufferId createBuffer() override;
+		virtual void destroyBuffer(BufferId buffer) override;
+		virtual void fillBuffer(BufferId buffer, unsigned int channels, unsigned int sampleRate, const int16_t* samples, size_t numSamples) override;
+		virtual void queueBuffer(SourceId source, BufferId buffer) override;
+		virtual bool unqueueProcessedBuffer(SourceId source, BufferId& outBuffer) override;
+		virtual void stopAndUnqueueAll(SourceId source) override;
+		virtual void play(SourceId source) override;
+		virtual bool isPlaying(SourceId source) override;
+
+		/** Plays up to numBuffers of the source's pending buffers; returns the number played. The source stops if it runs out. */
+		size_t playBuffers(SourceId source, size_t numBuffers);
+
+		const std::vector<int16_t>& getPlayedSamples(SourceId source) { return sources[source].played; }
+		size_t getNumQueued(SourceId source) { return sources[source].queued.size(); }
+		size_t getNumLiveBuffers() const { return buffers.size(); }
+
+	private:
+		struct NullSource
+		{
+			std::deque<BufferId> queued;
+			size_t numProcessed = 0;
+			bool bPlaying = false;
+			std::vector<int16_t> played;
+		};
+		std::map<BufferId, std::vector<int16_t>> buffers;
+		std::map<SourceId, NullSource> sources;
+		BufferId nextBufferId = 1;
+	};
+
+	struct AudioStreamConfig
+	{
+		size_t framesPerChunk = 16384;	//~0.37s at 44.1khz
+		size_t numBuffers = 4;			//buffers queued on the source; the same number of chunks are decoded ahead of them
+		bool bLooping = false;
+	};
+
+	struct AudioStreamStats
+	{
+		uint64_t numChunksQueued = 0;
+		uint64_t numUnderruns = 0;		//times the source ran dry and had to be restarted
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Plays a long sound without decoding it up front. Fixed size chunks are decoded on a worker pool and queued on
+	// the source a few buffers at a time; buffers the source has played are refilled with the next chunk.
+	//
+	// Looping is done by the decoder rather than the source, so the seam between the end and the start of the
+	// sound falls inside a chunk and is sample continuous.
+	//
+	// Everything except decoding happens on the thread that owns the source (the audio pipeline). The decode task
+	// only holds the decode state, so a stream may be destroyed while a chunk is being decoded.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioStream : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		using SourceId = AudioStreamBackend::SourceId;
+
+	public:
+		AudioStream(up<AudioStreamDecoder> decoder, AudioStreamBackend& backend, AssetWorkerPool& decodePool, const AudioStreamConfig& config);
+		~AudioStream();
+
+		/** Starts decoding so chunks are ready by the time a source is attached */
+		void prefetch();
+
+		/** Queues whatever has been decoded on source and plays it once there is something to play */
+		void attach(SourceId source);
+
+		/** Stops the source and takes back every buffer. Audio that was queued but not yet heard is skipped; decoded chunks not yet queued are kept. */
+		void detach();
+
+		/** Call every audio tick while attached; refills played buffers and restarts the source after an underrun */
+		void service();
+
+		void setLooping(bool bLooping);
+
+		bool isAttached() const { return bAttached; }
+		/** true once a non looping stream has played its last chunk */
+		bool isFinished() const { return bFinished; }
+
+		unsigned int getChannels() const { return channels; }
+		unsigned int getSampleRate() const { return sampleRate; }
+		float getDurationSec() const { return durationSec; }
+		const AudioStreamStats& getStats() const { return stats; }
+
+	private:
+		struct Chunk
+		{
+			std::vector<int16_t> samples;
+			size_t numFrames = 0;
+			bool bLast = false;			//the end of a non looping sound
+		};
+
+		struct DecodeState
+		{
+			up<AudioStreamDecoder> decoder;
+			size_t framesPerChunk = 0;
+			std::atomic<bool> bLooping{ false };
+			std::atomic<bool> bCancelled{ false };
+
+			std::mutex mutex;
+			std::deque<Chunk> decodedChunks;	//in play order
+			std::vector<Chunk> freeChunks;		//decoded and queued chunks come back here to reuse their storage
+			bool bTaskInFlight = false;
+			bool bReachedEnd = false;
+		};
+
+		static void decodeChunks(const sp<DecodeState>& state);
+		static void decodeChunk(DecodeState& state, Chunk& chunk);
+
+		void requestDecode();
+		void queueDecodedChunks();
+
+	private:
+		AudioStreamBackend& backend;
+		AssetWorkerPool& decodePool;
+		sp<DecodeState> decodeState;
+
+		std::vector<AudioStreamBackend::BufferId> allBuffers;
+		std::vector<AudioStreamBackend::BufferId> freeBuffers;
+		size_t numQueued = 0;
+		SourceId source = 0;
+		AudioStreamStats stats;
+
+		unsigned int channels = 0;
+		unsigned int sampleRate = 0;
+		float durationSec = 0.f;
+		bool bAttached = false;
+		bool bStartedPlaying = false;
+		bool bQueuedLast = false;
+		bool bFinished = false;
+	};
+}
@@ -0,0 +1,71 @@
+#include "OpenALStreamBackend.h"
+
+#if USE_OPENAL_API
+#include "OpenALUtilities.h"
+
+namespace SA
+{
+	AudioStreamBackend::BufferId OpenALStreamBackend::createBuffer()
+	{
+		ALuint buffer = 0;
+		alec(alGenBuffers(1, &buffer));
+		return buffer;
+	}
+
+	void OpenALStreamBackend::destroyBuffer(BufferId buffer)
+	{
+		ALuint alBuffer = buffer;
+		alec(alDeleteBuffers(1, &alBuffer));
+	}
+
+	void OpenALStreamBackend::fillBuffer(BufferId buffer, unsigned int channels, unsigned int sampleRate, const int16_t* samples, size_t numSamples)
+	{
+		alec(alBufferData(buffer,
+			channels > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16,
+			samples,
+			ALsizei(numSamples * 2) /*two bytes per sample*/,
+			ALsizei(sampleRate)
+		));
+	}
+
+	void OpenALStreamBackend::queueBuffer(SourceId source, BufferId buffer)
+	{
+		ALuint alBuffer = buffer;
+		alec(alSourceQueueBuffers(source, 1, &alBuffer));
+	}
+
+	bool OpenALStreamBackend::unqueueProcessedBuffer(SourceId source, BufferId& outBuffer)
+	{
+		ALint numProcessed = 0;
+		alec(alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessed));
+		if (numProcessed <= 0)
+		{
+			return false;
+		}
+
+		ALuint alBuffer = 0;
+		alec(alSourceUnqueueBuffers(source, 1, &alBuffer));
+		outBuffer = alBuffer;
+		return true;
+	}
+
+	void OpenALStreamBackend::stopAndUnqueueAll(SourceId source)
+	{
+		//a stopped source marks every buffer processed; clearing AL_BUFFER then releases the whole queue
+		alec(alSourceStop(source));
+		alec(alSourcei(source, AL_BUFFER, 0));
+	}
+
+	void OpenALStreamBackend::play(SourceId source)
+	{
+		alec(alSourcePlay(source));
+	}
+
+	bool OpenALStreamBackend::isPlaying(SourceId source)
+	{
+		ALint sourceState = 0;
+		alec(alGetSourcei(source, AL_SOURCE_STATE, &sourceState));
+		return sourceState == AL_PLAYING;
+	}
+}
+#endif //USE_OPENAL_API
@@ -0,0 +1,29 @@
+#pragma once
+#include "../BuildConfiguration/SAPreprocessorDefines.h"
+
+#if USE_OPENAL_API
+#include <AL/al.h>
+
+#include "AudioStream.h"
+
+namespace SA
+{
+	static_assert(sizeof(ALuint) == sizeof(AudioStreamBackend::BufferId), "stream backend ids must be able to hold OpenAL names");
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Streams through OpenAL's source buffer queue (alSourceQueueBuffers / alSourceUnqueueBuffers).
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class OpenALStreamBackend : public AudioStreamBackend
+	{
+	public:
+		virtual BufferId createBuffer() override;
+		virtual void destroyBuffer(BufferId buffer) override;
+		virtual void fillBuffer(BufferId buffer, unsigned int channels, unsigned int sampleRate, const int16_t* samples, size_t numSamples) override;
+		virtual void queueBuffer(SourceId source, BufferId buffer) override;
+		virtual bool unqueueProcessedBuffer(SourceId source, BufferId& outBuffer) override;
+		virtual void stopAndUnqueueAll(SourceId source) override;
+		virtual void play(SourceId source) override;
+		virtual bool isPlaying(SourceId source) override;
+	};
+}
+#endif //USE_OPENAL_API
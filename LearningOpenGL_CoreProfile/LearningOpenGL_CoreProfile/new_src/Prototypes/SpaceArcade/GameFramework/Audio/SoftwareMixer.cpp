@@ -0,0 +1,324 @@
+#include "SoftwareMixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <gtc/constants.hpp>
+
+#include "SoundRawData.h"
+#include "../BuildConfiguration/SAPreprocessorDefines.h"
+
+#if USE_SSE2_AUDIO_MIXING
+#include <emmintrin.h>
+#endif
+
+namespace SA
+{
+	namespace
+	{
+		/** stereo sounds are folded to mono; the mixer pans every voice itself */
+		inline float fetchFrame(const int16_t* samples, size_t numFrames, unsigned int channels, bool bLooping, size_t frame)
+		{
+			if (frame >= numFrames)
+			{
+				if (!bLooping || numFrames == 0)
+				{
+					return 0.f;
+				}
+				frame %= numFrames;
+			}
+			if (channels == 2)
+			{
+				return (float(samples[frame * 2]) + float(samples[frame * 2 + 1])) * 0.5f;
+			}
+			return float(samples[frame * channels]);
+		}
+	}
+
+#if USE_SSE2_AUDIO_MIXING
+	const bool SoftwareMixer::bSimdAvailable = true;
+#else
+	const bool SoftwareMixer::bSimdAvailable = false;
+#endif
+
+	SoftwareMixer::SoftwareMixer(unsigned int outputSampleRate, size_t numSubmixes)
+		: outputSampleRate(outputSampleRate)
+	{
+		for (size_t idx = 0; idx < std::max<size_t>(numSubmixes, 1); ++idx)
+		{
+			submixes.push_back(new_up<Submix>());
+		}
+		bUseSimd = bSimdAvailable;
+	}
+
+	SoftwareVoiceHandle SoftwareMixer::addVoice(const sp<const SoundRawData>& sound, bool bLooping, size_t startFrame, const SoftwareVoiceGains& gains, float pitch)
+	{
+		Voice voice;
+		voice.sound = sound;
+		voice.samples = reinterpret_cast<const int16_t*>(sound->pcmData.data());
+		voice.channels = std::max(sound->channels, 1u);
+		voice.numFrames = sound->pcmData.size() / voice.channels;
+		voice.sampleRate = sound->sampleRate;
+		voice.bLooping = bLooping;
+		voice.position = double(bLooping && voice.numFrames > 0 ? startFrame % voice.numFrames : startFrame);
+		voice.pitch = pitch;
+		voice.targetGains = gains;		//starts silent and ramps in
+		voice.bFinished = !bLooping && startFrame >= voice.numFrames;
+
+		//round robin keeps submixes close in size as long as voices live for similar times
+		const uint32_t submixIdx = nextSubmix++ % uint32_t(submixes.size());
+		Submix& submix = *submixes[submixIdx];
+		std::lock_guard<std::mutex> lock(submix.mutex);
+		return SoftwareVoiceHandle{ submix.voices.insert(std::move(voice)), submixIdx };
+	}
+
+	void SoftwareMixer::removeVoice(const SoftwareVoiceHandle& handle)
+	{
+		Submix& submix = *submixes[handle.submixIdx];
+		std::lock_guard<std::mutex> lock(submix.mutex);
+		if (Voice* voice = submix.voices.find(handle.slot))
+		{
+			voice->bStopping = true;
+			voice->targetGains = SoftwareVoiceGains{};
+		}
+	}
+
+	void SoftwareMixer::setVoiceParameters(const SoftwareVoiceHandle& handle, const SoftwareVoiceGains& gains, float pitch)
+	{
+		Submix& submix = *submixes[handle.submixIdx];
+		std::lock_guard<std::mutex> lock(submix.mutex);
+		if (Voice* voice = submix.voices.find(handle.slot))
+		{
+			if (!voice->bStopping)
+			{
+				voice->targetGains = gains;
+				voice->pitch = pitch;
+			}
+		}
+	}
+
+	bool SoftwareMixer::isVoiceFinished(const SoftwareVoiceHandle& handle)
+	{
+		Submix& submix = *submixes[handle.submixIdx];
+		std::lock_guard<std::mutex> lock(submix.mutex);
+		const Voice* voice = submix.voices.find(handle.slot);
+		return !voice || voice->bFinished || voice->bStopping;
+	}
+
+	size_t SoftwareMixer::getVoiceFrame(const SoftwareVoiceHandle& handle)
+	{
+		Submix& submix = *submixes[handle.submixIdx];
+		std::lock_guard<std::mutex> lock(submix.mutex);
+		const Voice* voice = submix.voices.find(handle.slot);
+		return voice ? size_t(voice->position) : 0;
+	}
+
+	size_t SoftwareMixer::getNumVoices()
+	{
+		size_t numVoices = 0;
+		for (const up<Submix>& submix : submixes)
+		{
+			std::lock_guard<std::mutex> lock(submix->mutex);
+			numVoices += submix->voices.size();
+		}
+		return numVoices;
+	}
+
+	void SoftwareMixer::renderSubmix(size_t submixIdx, int16_t* outStereoSamples, size_t numFrames)
+	{
+		Submix& submix = *submixes[submixIdx];
+		std::lock_guard<std::mutex> lock(submix.mutex);
+
+		if (submix.mixLeft.size() < numFrames)
+		{
+			submix.mixLeft.resize(numFrames);
+			submix.mixRight.resize(numFrames);
+		}
+		std::fill(submix.mixLeft.begin(), submix.mixLeft.begin() + numFrames, 0.f);
+		std::fill(submix.mixRight.begin(), submix.mixRight.begin() + numFrames, 0.f);
+
+		submix.stopped.clear();
+		for (size_t idx = 0; idx < submix.voices.size(); ++idx)
+		{
+			Voice& voice = submix.voices[idx];
+			if (!voice.bFinished)
+			{
+				mixVoice(voice, submix.mixLeft.data(), submix.mixRight.data(), numFrames);
+			}
+			if (voice.bStopping)
+			{
+				//has now faded out
+				submix.stopped.push_back(submix.voices.getHandle(idx));
+			}
+		}
+		for (const SlotHandle& stopped : submix.stopped)
+		{
+			submix.voices.remove(stopped);
+		}
+
+		writeOutput(submix.mixLeft.data(), submix.mixRight.data(), outStereoSamples, numFrames);
+	}
+
+	void SoftwareMixer::mixVoice(Voice& voice, float* mixLeft, float* mixRight, size_t numFrames) const
+	{
+		if (numFrames == 0 || voice.numFrames == 0 || outputSampleRate == 0)
+		{
+			voice.bFinished = !voice.bLooping;
+			return;
+		}
+
+		//frame i of this render plays source position (position + i * step), and has gain (gain + (i + 1) * delta); the target is reached on the last frame
+		const double step = double(voice.sampleRate) / double(outputSampleRate) * double(std::max(voice.pitch, 0.f));
+		const float leftDelta = (voice.targetGains.left - voice.gains.left) / float(numFrames);
+		const float rightDelta = (voice.targetGains.right - voice.gains.right) / float(numFrames);
+
+		const bool bSilent = voice.gains.left == 0.f && voice.gains.right == 0.f && voice.targetGains.left == 0.f && voice.targetGains.right == 0.f;
+		size_t frame = 0;
+#if USE_SSE2_AUDIO_MIXING
+		//positions are converted with 32 bit integers, so very long sounds use the scalar path
+		if (bUseSimd && !bSilent && voice.numFrames < size_t(std::numeric_limits<int32_t>::max() / 2))
+		{
+			const __m128d startPosition = _mm_set1_pd(voice.position);
+			const __m128d frameStep = _mm_set1_pd(step);
+			const __m128 startLeft = _mm_set1_ps(voice.gains.left);
+			const __m128 startRight = _mm_set1_ps(voice.gains.right);
+			const __m128 deltaLeft = _mm_set1_ps(leftDelta);
+			const __m128 deltaRight = _mm_set1_ps(rightDelta);
+			alignas(16) int32_t sourceFrame[4];
+			alignas(16) float first[4];
+			alignas(16) float second[4];
+
+			for (; frame + 4 <= numFrames; frame += 4)
+			{
+				//positions stay in double precision like the scalar path; truncation matches its size_t conversion as positions are never negative
+				const __m128d position01 = _mm_add_pd(startPosition, _mm_mul_pd(_mm_set_pd(double(frame + 1), double(frame)), frameStep));
+				const __m128d position23 = _mm_add_pd(startPosition, _mm_mul_pd(_mm_set_pd(double(frame + 3), double(frame + 2)), frameStep));
+				const __m128i frame01 = _mm_cvttpd_epi32(position01);
+				const __m128i frame23 = _mm_cvttpd_epi32(position23);
+				const __m128 fraction = _mm_movelh_ps(
+					_mm_cvtpd_ps(_mm_sub_pd(position01, _mm_cvtepi32_pd(frame01))),
+					_mm_cvtpd_ps(_mm_sub_pd(position23, _mm_cvtepi32_pd(frame23))));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(sourceFrame), frame01);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(sourceFrame + 2), frame23);
+
+				//sse2 has no gather, so source frames are fetched one at a time; positions only increase, so checking the last lane covers all four
+				if (size_t(sourceFrame[3]) + 1 < voice.numFrames && voice.channels == 1)
+				{
+					for (size_t lane = 0; lane < 4; ++lane)
+					{
+						first[lane] = float(voice.samples[sourceFrame[lane]]);
+						second[lane] = float(voice.samples[sourceFrame[lane] + 1]);
+					}
+				}
+				else
+				{
+					for (size_t lane = 0; lane < 4; ++lane)
+					{
+						first[lane] = fetchFrame(voice.samples, voice.numFrames, voice.channels, voice.bLooping, size_t(sourceFrame[lane]));
+						second[lane] = fetchFrame(voice.samples, voice.numFrames, voice.channels, voice.bLooping, size_t(sourceFrame[lane]) + 1);
+					}
+				}
+				const __m128 a = _mm_load_ps(first);
+				const __m128 b = _mm_load_ps(second);
+				const __m128 sample = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction));
+
+				const __m128 ramp = _mm_set_ps(float(frame + 4), float(frame + 3), float(frame + 2), float(frame + 1));
+				const __m128 gainLeft = _mm_add_ps(startLeft, _mm_mul_ps(deltaLeft, ramp));
+				const __m128 gainRight = _mm_add_ps(startRight, _mm_mul_ps(deltaRight, ramp));
+
+				_mm_storeu_ps(mixLeft + frame, _mm_add_ps(_mm_loadu_ps(mixLeft + frame), _mm_mul_ps(sample, gainLeft)));
+				_mm_storeu_ps(mixRight + frame, _mm_add_ps(_mm_loadu_ps(mixRight + frame), _mm_mul_ps(sample, gainRight)));
+			}
+		}
+#endif //USE_SSE2_AUDIO_MIXING
+		if (!bSilent)
+		{
+			mixVoiceScalar(voice, mixLeft, mixRight, frame, numFrames, step, leftDelta, rightDelta);
+		}
+
+		voice.gains = voice.targetGains;
+		voice.position += double(numFrames) * step;
+		if (voice.position >= double(voice.numFrames))
+		{
+			if (voice.bLooping)
+			{
+				voice.position = std::fmod(voice.position, double(voice.numFrames));
+			}
+			else
+			{
+				voice.bFinished = true;
+			}
+		}
+	}
+
+	void SoftwareMixer::mixVoiceScalar(Voice& voice, float* mixLeft, float* mixRight, size_t startFrame, size_t numFrames, double step, float leftDelta, float rightDelta) const
+	{
+		//same operations in the same order as the sse2 path, so both produce the same output
+		for (size_t frame = startFrame; frame < numFrames; ++frame)
+		{
+			const double position = voice.position + double(frame) * step;
+			const size_t sourceFrame = size_t(position);
+			const float fraction = float(position - double(sourceFrame));
+			const float a = fetchFrame(voice.samples, voice.numFrames, voice.channels, voice.bLooping, sourceFrame);
+			const float b = fetchFrame(voice.samples, voice.numFrames, voice.channels, voice.bLooping, sourceFrame + 1);
+			const float sample = a + (b - a) * fraction;
+
+			const float ramp = float(frame + 1);
+			mixLeft[frame] += sample * (voice.gains.left + leftDelta * ramp);
+			mixRight[frame] += sample * (voice.gains.right + rightDelta * ramp);
+		}
+	}
+
+	void SoftwareMixer::writeOutput(const float* mixLeft, const float* mixRight, int16_t* outStereoSamples, size_t numFrames) const
+	{
+		const float minSample = float(std::numeric_limits<int16_t>::min());
+		const float maxSample = float(std::numeric_limits<int16_t>::max());
+
+		size_t frame = 0;
+#if USE_SSE2_AUDIO_MIXING
+		if (bUseSimd)
+		{
+			const __m128 low = _mm_set1_ps(minSample);
+			const __m128 high = _mm_set1_ps(maxSample);
+			for (; frame + 4 <= numFrames; frame += 4)
+			{
+				//clamped before converting, as out of range floats convert to INT_MIN rather than saturating
+				const __m128i left = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(mixLeft + frame), low), high));
+				const __m128i right = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(mixRight + frame), low), high));
+				const __m128i interleaved = _mm_packs_epi32(_mm_unpacklo_epi32(left, right), _mm_unpackhi_epi32(left, right));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outStereoSamples + frame * 2), interleaved);
+			}
+		}
+#endif //USE_SSE2_AUDIO_MIXING
+		for (; frame < numFrames; ++frame)
+		{
+			//lrint rounds to nearest even like the sse2 conversion
+			outStereoSamples[frame * 2] = int16_t(std::lrint(std::min(std::max(mixLeft[frame], minSample), maxSample)));
+			outStereoSamples[frame * 2 + 1] = int16_t(std::lrint(std::min(std::max(mixRight[frame], minSample), maxSample)));
+		}
+	}
+
+	SoftwareVoiceGains SoftwareMixer::calculateSpatialGains(const glm::vec3& emitterPosition, const glm::vec3& listenerPosition, const glm::vec3& listenerRight_n, float referenceDistance, float gain)
+	{
+		const glm::vec3 toEmitter = emitterPosition - listenerPosition;
+		const float distance = glm::length(toEmitter);
+
+		//AL_INVERSE_DISTANCE_CLAMPED: ref / (ref + rolloff * (clamp(distance, ref, max) - ref)); max distance is left at infinity like the hardware sources
+		const float ref = std::max(referenceDistance, 0.0001f);
+		const float attenuation = ref / std::max(distance, ref);
+
+		const float pan = distance > 0.0001f ? glm::clamp(glm::dot(toEmitter / distance, listenerRight_n), -1.f, 1.f) : 0.f;
+		const float angle = (pan + 1.f) * glm::quarter_pi<float>();
+
+		SoftwareVoiceGains gains;
+		gains.left = std::cos(angle) * gain * attenuation;
+		gains.right = std::sin(angle) * gain * attenuation;
+		return gains;
+	}
+
+	size_t SubmixStreamDecoder::readFrames(int16_t* outSamples, size_t maxFrames)
+	{
+		mixer->renderSubmix(submixIdx, outSamples, maxFrames);
+		return maxFrames;
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <glm.hpp>
+
+#include "../SAGameEntity.h"
+#include "../../Tools/DataStructures/SlotMap.h"
+#include "../../Tools/RemoveSpecialMemberFunctionUtils.h"
+#include "AudioStream.h"
+
+namespace SA
+{
+	struct SoundRawData;
+
+	struct SoftwareVoiceHandle
+	{
+		SlotHandle slot;
+		uint32_t submixIdx = 0;
+	};
+
+	/** Gain applied to each output channel; see SoftwareMixer::calculateSpatialGains */
+	struct SoftwareVoiceGains
+	{
+		float left = 0.f;
+		float right = 0.f;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Mixes voices on the cpu for emitters that did not win a hardware source, so distant and quiet sounds keep
+	// playing rather than cutting out when the source limit is reached.
+	//
+	// Voices are spread over a few stereo submixes. Each submix is rendered on its own (see SubmixStreamDecoder),
+	// which lets submixes be rendered in parallel and played through an ordinary streaming source.
+	//
+	// Voices are resampled with linear interpolation and panned by the gains the owner sets. Gains are ramped across
+	// each render so changes (including voices starting and stopping) do not click. Resampling and mixing is done
+	// four output frames at a time with sse2 when it is available; the scalar path produces the same output.
+	//
+	// Voice parameters are set on the audio pipeline thread, rendering happens on the stream decode threads; each
+	// submix is guarded by its own mutex.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SoftwareMixer : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		SoftwareMixer(unsigned int outputSampleRate, size_t numSubmixes);
+
+		/** sound is not copied, the voice holds it until released; pitch is a playback rate multiplier */
+		SoftwareVoiceHandle addVoice(const sp<const SoundRawData>& sound, bool bLooping, size_t startFrame, const SoftwareVoiceGains& gains, float pitch);
+
+		/** the voice fades out over the next render and is then released */
+		void removeVoice(const SoftwareVoiceHandle& voice);
+
+		void setVoiceParameters(const SoftwareVoiceHandle& voice, const SoftwareVoiceGains& gains, float pitch);
+
+		/** true once a non looping voice has played to its end, or once the voice has been released */
+		bool isVoiceFinished(const SoftwareVoiceHandle& voice);
+
+		/** the source frame the voice plays next; lets a sound move to a hardware source without restarting */
+		size_t getVoiceFrame(const SoftwareVoiceHandle& voice);
+
+		/** Mixes every voice of the submix into interleaved stereo */
+		void renderSubmix(size_t submixIdx, int16_t* outStereoSamples, size_t numFrames);
+
+		/** the scalar path is always available; this is for comparing the two */
+		void setUseSimd(bool bUse) { bUseSimd = bUse && bSimdAvailable; }
+		bool isUsingSimd() const { return bUseSimd; }
+
+		size_t getNumSubmixes() const { return submixes.size(); }
+		unsigned int getOutputSampleRate() const { return outputSampleRate; }
+		size_t getNumVoices();
+
+		/** Equal power panning across the listener's right vector, with OpenAL's inverse distance clamped attenuation (rolloff 1) */
+		static SoftwareVoiceGains calculateSpatialGains(const glm::vec3& emitterPosition, const glm::vec3& listenerPosition, const glm::vec3& listenerRight_n, float referenceDistance, float gain);
+
+	private:
+		struct Voice
+		{
+			sp<const SoundRawData> sound;		//kept alive while the voice fades out, even if the sound is unloaded
+			const int16_t* samples = nullptr;
+			size_t numFrames = 0;
+			unsigned int channels = 1;
+			unsigned int sampleRate = 0;
+			bool bLooping = false;
+
+			double position = 0.0;		//in source frames
+			float pitch = 1.f;
+
+			SoftwareVoiceGains gains;		//reached by the end of the last render
+			SoftwareVoiceGains targetGains;
+
+			bool bStopping = false;
+			bool bFinished = false;
+		};
+
+		struct Submix
+		{
+			std::mutex mutex;
+			SlotMap<Voice> voices;
+			std::vector<float> mixLeft;
+			std::vector<float> mixRight;
+			std::vector<SlotHandle> stopped;
+		};
+
+		void mixVoice(Voice& voice, float* mixLeft, float* mixRight, size_t numFrames) const;
+		void mixVoiceScalar(Voice& voice, float* mixLeft, float* mixRight, size_t startFrame, size_t numFrames, double step, float leftDelta, float rightDelta) const;
+		void writeOutput(const float* mixLeft, const float* mixRight, int16_t* outStereoSamples, size_t numFrames) const;
+
+	private:
+		std::vector<up<Submix>> submixes;
+		unsigned int outputSampleRate = 44100;
+		uint32_t nextSubmix = 0;
+		bool bUseSimd = false;
+		static const bool bSimdAvailable;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Renders one submix as an endless stereo stream, so it can be played through an AudioStream.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SubmixStreamDecoder : public AudioStreamDecoder
+	{
+	public:
+		SubmixStreamDecoder(const sp<SoftwareMixer>& mixer, size_t submixIdx) : mixer(mixer), submixIdx(submixIdx) {}
+
+		virtual size_t readFrames(int16_t* outSamples, size_t maxFrames) override;
+		virtual bool seekToStart() override { return true; }
+
+		virtual unsigned int getChannels() const override { return 2; }
+		virtual unsigned int getSampleRate() const override { return mixer->getOutputSampleRate(); }
+		virtual float getDurationSec() const override { return 0.f; }
+
+	private:
+		//held strongly; the decode task may still be rendering after the audio system lets go of the mixer
+		sp<SoftwareMixer> mixer;
+		size_t submixIdx = 0;
+	};
+}
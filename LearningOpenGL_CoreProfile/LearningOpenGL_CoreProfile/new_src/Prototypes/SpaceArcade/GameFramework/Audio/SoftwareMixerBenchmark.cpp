@@ -0,0 +1,86 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "SoftwareMixer.h"
+#include "SoundRawData.h"
+#include "../SAGameEntity.h"
+
+/*
+	Headless benchmark for the software mixer; no audio device is created.
+
+	Renders the default software voice budget (128 voices of mixed sample rates, some looping, all pitched) into two
+	submixes in 1024 frame chunks, the size the audio system streams submixes in. Runs once with the scalar path and
+	once with sse2, and reports the time per chunk and how much of a chunk's playback time the render costs.
+*/
+
+namespace
+{
+	using namespace SA;
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	double renderMs(bool bUseSimd, const std::vector<sp<SoundRawData>>& sounds, size_t numChunks, size_t framesPerChunk)
+	{
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> gain(0.f, 0.2f);
+		std::uniform_real_distribution<float> pitch(0.7f, 1.5f);
+
+		SoftwareMixer mixer(44100, 2);
+		mixer.setUseSimd(bUseSimd);
+		for (size_t idx = 0; idx < sounds.size(); ++idx)
+		{
+			mixer.addVoice(sounds[idx], idx % 2 == 0, 0, SoftwareVoiceGains{ gain(rng), gain(rng) }, pitch(rng));
+		}
+
+		std::vector<int16_t> out(framesPerChunk * 2);
+		Clock::time_point start = Clock::now();
+		for (size_t chunk = 0; chunk < numChunks; ++chunk)
+		{
+			for (size_t submixIdx = 0; submixIdx < mixer.getNumSubmixes(); ++submixIdx)
+			{
+				mixer.renderSubmix(submixIdx, out.data(), framesPerChunk);
+			}
+		}
+		return elapsedMs(start);
+	}
+
+	void true_main()
+	{
+		const size_t numVoices = 128;
+		const size_t framesPerChunk = 1024;
+		const size_t numChunks = 400;
+
+		std::mt19937 rng(11);
+		std::uniform_int_distribution<int> amplitude(-8000, 8000);
+		const unsigned int rates[] = { 22050, 44100, 48000 };
+		std::vector<sp<SoundRawData>> sounds;
+		for (size_t idx = 0; idx < numVoices; ++idx)
+		{
+			sp<SoundRawData> sound = new_sp<SoundRawData>();
+			sound->channels = 1;
+			sound->sampleRate = rates[idx % 3];
+			sound->pcmData.resize(44100 * 4);
+			for (uint16_t& sample : sound->pcmData)
+			{
+				sample = uint16_t(int16_t(amplitude(rng)));
+			}
+			sounds.push_back(sound);
+		}
+
+		const double scalarMs = renderMs(false, sounds, numChunks, framesPerChunk);
+		const double simdMs = renderMs(true, sounds, numChunks, framesPerChunk);
+		const double chunkPlaybackMs = 1000.0 * double(framesPerChunk) / 44100.0;
+
+		std::cout << numVoices << " voices, " << framesPerChunk << " frame chunks (" << chunkPlaybackMs << " ms of audio)\n"
+			<< "\tscalar: " << scalarMs / numChunks << " ms per chunk\n"
+			<< "\tsse2:   " << simdMs / numChunks << " ms per chunk" << std::endl;
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
@@ -0,0 +1,38 @@
+#include "WavStreamDecoder.h"
+
+namespace SA
+{
+	up<WavStreamDecoder> WavStreamDecoder::open(const std::string& relative_filepath)
+	{
+		up<WavStreamDecoder> decoder(new WavStreamDecoder());
+		decoder->bOpen = drwav_init_file(&decoder->wav, relative_filepath.c_str(), /*allocation callbacks*/nullptr);
+		if (!decoder->bOpen || decoder->wav.channels == 0 || decoder->wav.sampleRate == 0)
+		{
+			return nullptr;
+		}
+		return decoder;
+	}
+
+	WavStreamDecoder::~WavStreamDecoder()
+	{
+		if (bOpen)
+		{
+			drwav_uninit(&wav);
+		}
+	}
+
+	size_t WavStreamDecoder::readFrames(int16_t* outSamples, size_t maxFrames)
+	{
+		return size_t(drwav_read_pcm_frames_s16(&wav, maxFrames, outSamples));
+	}
+
+	bool WavStreamDecoder::seekToStart()
+	{
+		return drwav_seek_to_pcm_frame(&wav, 0);
+	}
+
+	float WavStreamDecoder::getDurationSec() const
+	{
+		return float(wav.totalPCMFrameCount) / float(wav.sampleRate);
+	}
+}
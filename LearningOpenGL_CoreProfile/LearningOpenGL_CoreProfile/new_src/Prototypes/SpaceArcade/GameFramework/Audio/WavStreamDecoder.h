@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <dr_lib/dr_wav.h>
+
+#include "AudioStream.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Reads a wav file from disk as it is played, rather than decoding the whole file up front.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class WavStreamDecoder : public AudioStreamDecoder, public RemoveCopies, public RemoveMoves
+	{
+	public:
+		/** nullptr if the file cannot be opened; only the header is read */
+		static up<WavStreamDecoder> open(const std::string& relative_filepath);
+		~WavStreamDecoder();
+
+		virtual size_t readFrames(int16_t* outSamples, size_t maxFrames) override;
+		virtual bool seekToStart() override;
+
+		virtual unsigned int getChannels() const override { return wav.channels; }
+		virtual unsigned int getSampleRate() const override { return wav.sampleRate; }
+		virtual float getDurationSec() const override;
+
+	private:
+		WavStreamDecoder() = default;
+
+	private:
+		drwav wav = {};
+		bool bOpen = false;
+	};
+}
@@ -58,7 +58,7 @@ namespace SA
 			virtual void startBranchConditionCheck()
 			{
 				Memory& memory = getMemory();
-				const T* memoryValue = memory.getReadValueAs<T>(memoryKey);
+				const T* memoryValue = memory.getReadValueAs<T>(memorySlot);
 
 				//short circuit evaluate
 				conditionalResult = doConditionCheck(memoryValue, &value);
@@ -70,12 +70,18 @@ namespace SA
 				return (runtimeValue != nullptr) && opFunc(*runtimeValue, *nodePropertyValue);
 			}
 
+			virtual void notifyTreeEstablished() override
+			{
+				memorySlot = getMemory().internKey(memoryKey);
+			}
+
 		private:
 			virtual void handleNodeAborted() override {}
 
 		protected: //node properties
 			const std::string memoryKey;
 			const T value;
+			MemoryKey memorySlot;
 		private: //node properties
 			std::function<bool(T, T)> opFunc;
 			
@@ -102,11 +108,11 @@ namespace SA
 					bSubscribedDelegates = true;
 					if (abortPref == AbortPreference::ABORT_ON_MODIFY)
 					{
-						memory.getModifiedDelegate(this->memoryKey).addStrongObj<Decorator_Aborting_Is<T>>(sp_this(), &Decorator_Aborting_Is<T>::handleValueModified);
+						memory.getModifiedDelegate(this->memorySlot).addStrongObj<Decorator_Aborting_Is<T>>(sp_this(), &Decorator_Aborting_Is<T>::handleValueModified);
 					}
 					else if (abortPref == AbortPreference::ABORT_ON_REPLACE)
 					{
-						memory.getReplacedDelegate(this->memoryKey).addStrongObj<Decorator_Aborting_Is<T>>(sp_this(), &Decorator_Aborting_Is<T>::handleValueReplaced);
+						memory.getReplacedDelegate(this->memorySlot).addStrongObj<Decorator_Aborting_Is<T>>(sp_this(), &Decorator_Aborting_Is<T>::handleValueReplaced);
 					}
 					else if (abortPref == AbortPreference::NO_ABORT)
 					{
@@ -140,7 +146,7 @@ namespace SA
 			void abortIfValueChanged()
 			{
 				Memory& memory = NodeBase::getMemory();
-				const T* newValue = memory.getReadValueAs<T>(this->memoryKey);
+				const T* newValue = memory.getReadValueAs<T>(this->memorySlot);
 
 				if (!this->doConditionCheck(newValue, &this->value))
 				{
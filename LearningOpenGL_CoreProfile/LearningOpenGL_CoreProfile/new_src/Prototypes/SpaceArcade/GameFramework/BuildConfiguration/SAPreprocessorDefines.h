@@ -2,3 +2,11 @@
 
 //see optional compilation macros for more defines
 #define USE_OPENAL_API 1
+
+//sse2 is part of every x64 target; without it the software audio mixer uses its scalar path
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SA_SSE2_AVAILABLE 1
+#else
+#define SA_SSE2_AVAILABLE 0
+#endif
+#define USE_SSE2_AUDIO_MIXING (1 & SA_SSE2_AVAILABLE)
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include "../Tools/DataStructures/MultiDelegate.h"
 #include "SALog.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -25,6 +26,11 @@ namespace SA
 		}
 	}
 
+	void CheatSystemBase::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		outDependencies.bThreadSafeTick = true; //cheats run when the console parses them, not on a tick
+	}
+
 	bool CheatSystemBase::parseCheat(const std::string& cheatString)
 	{
 		bool bFoundCheat = false;
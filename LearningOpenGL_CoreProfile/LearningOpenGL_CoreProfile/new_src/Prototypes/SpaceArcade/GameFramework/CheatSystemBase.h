@@ -18,6 +18,8 @@ namespace SA
 	protected:
 		//having cheats forward to delegates allows you to parse string into types before broadcasting to subscribers
 		void registerCheat(std::string cheat, sp<CheatDelegate> cheatDelegate);
+	private:
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 	private:
 		std::unordered_map<
 			std::string,
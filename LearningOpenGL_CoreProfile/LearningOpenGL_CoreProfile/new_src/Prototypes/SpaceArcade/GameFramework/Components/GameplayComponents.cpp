@@ -39,7 +39,7 @@ namespace SA
 		cachedBehaviorTree = nullptr;
 		if(BehaviorTreeBrain* btBrain = dynamic_cast<BehaviorTreeBrain*>(newBrain.get()))
 		{
-			cachedBehaviorTree = &btBrain->getBehaviorTree();
+			cachedBehaviorTree = btBrain->findBehaviorTree();
 		}
 	}
 
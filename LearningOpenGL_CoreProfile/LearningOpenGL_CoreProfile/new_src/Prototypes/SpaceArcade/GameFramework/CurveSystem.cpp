@@ -1,4 +1,5 @@
 #include "CurveSystem.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -15,6 +16,11 @@ namespace SA
 
 	}
 
+	void CurveSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		outDependencies.bThreadSafeTick = true; //curves are immutable once generated
+	}
+
 	float CurveSystem::sampleAnalyticSigmoid(float a, float tuning)
 	{
 		// math: https://stats.stackexchange.com/questions/214877/is-there-a-formula-for-an-s-shaped-curve-with-domain-and-range-0-1
@@ -63,6 +63,8 @@ namespace SA
 		CurveSystem();
 	protected:
 		virtual void initSystem() override;
+	private:
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 	public:
 		static float sampleAnalyticSigmoid(float a, float tuning = 3.0f);
 	private:
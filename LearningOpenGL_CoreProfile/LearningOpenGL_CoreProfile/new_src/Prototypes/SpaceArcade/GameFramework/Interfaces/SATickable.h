@@ -9,6 +9,7 @@ namespace SA
 	class ITickable
 	{
 		friend class TimeManager;
+		friend class TickDispatcher;
 	protected:
 		/*  Ticks the current object with the dilated delta time seconds.
 				@note: protected access, not private, to allow sub classes to call their super's tick.
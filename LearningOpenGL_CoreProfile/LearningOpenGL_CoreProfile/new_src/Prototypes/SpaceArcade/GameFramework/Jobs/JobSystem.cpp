@@ -0,0 +1,273 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace SA
+{
+	struct JobHandle::Job
+	{
+		std::function<void()> work;
+		std::atomic<uint32_t> numUnfinishedDependencies{ 1 };	//starts at 1 so the job cannot be queued while dependencies are still being linked
+		std::atomic<bool> bDone{ false };
+
+		std::mutex dependentsMutex;	//guards dependents and the transition to done
+		std::vector<sp<Job>> dependents;
+	};
+
+	//which queue the current thread owns; threads that are not workers of a system use its shared queue
+	static thread_local const JobSystem* tl_workerOf = nullptr;
+	static thread_local size_t tl_workerQueueIdx = 0;
+
+	bool JobHandle::isDone() const
+	{
+		return !job || job->bDone.load(std::memory_order_acquire);
+	}
+
+	JobSystem::JobSystem(size_t numWorkerThreads, bool bDeterministic)
+		: bDeterministic(bDeterministic)
+	{
+		for (size_t queueIdx = 0; queueIdx < numWorkerThreads + 1; ++queueIdx)
+		{
+			queues.push_back(new_up<WorkQueue>());
+		}
+
+		workers.reserve(numWorkerThreads);
+		for (size_t threadIdx = 0; threadIdx < numWorkerThreads; ++threadIdx)
+		{
+			workers.emplace_back([this, threadIdx]() { workerLoop(threadIdx); });
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		stop();
+	}
+
+	JobHandle JobSystem::schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies)
+	{
+		sp<JobHandle::Job> job = new_sp<JobHandle::Job>();
+		job->work = std::move(work);
+
+		if (bDeterministic)
+		{
+			//everything scheduled before this has already run, unless the mode was switched with jobs in flight
+			wait(dependencies);
+			job->work();
+			job->work = nullptr;
+			job->bDone.store(true, std::memory_order_release);
+			return JobHandle(job);
+		}
+
+		for (const JobHandle& dependency : dependencies)
+		{
+			if (dependency.job)
+			{
+				std::lock_guard<std::mutex> lock(dependency.job->dependentsMutex);
+				if (!dependency.job->bDone.load(std::memory_order_acquire))
+				{
+					dependency.job->dependents.push_back(job);
+					job->numUnfinishedDependencies.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		//release the linking reference; if every dependency already finished the job is ready now
+		if (job->numUnfinishedDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			enqueue(job);
+		}
+		return JobHandle(job);
+	}
+
+	void JobSystem::wait(const JobHandle& handle)
+	{
+		if (!handle.job)
+		{
+			return;
+		}
+
+		const size_t queueIdx = getCurrentQueueIdx();
+		while (!handle.job->bDone.load(std::memory_order_acquire))
+		{
+			if (sp<JobHandle::Job> job = findJob(queueIdx))
+			{
+				execute(job);
+			}
+			else
+			{
+				std::this_thread::yield(); //the job is running (or about to be queued) on another thread
+			}
+		}
+	}
+
+	void JobSystem::wait(const std::vector<JobHandle>& jobs)
+	{
+		for (const JobHandle& job : jobs)
+		{
+			wait(job);
+		}
+	}
+
+	void JobSystem::parallelFor(size_t count, size_t minItemsPerJob, const RangeFunction& body)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		minItemsPerJob = std::max<size_t>(minItemsPerJob, 1);
+
+		if (bDeterministic)
+		{
+			//ranges do not depend on the number of workers, so results are the same on every machine
+			for (size_t begin = 0; begin < count; begin += minItemsPerJob)
+			{
+				body(begin, std::min(begin + minItemsPerJob, count));
+			}
+			return;
+		}
+
+		//a few ranges per thread lets threads that finish early steal the remainder
+		const size_t maxJobs = (workers.size() + 1) * 4;
+		size_t numJobs = std::min((count + minItemsPerJob - 1) / minItemsPerJob, maxJobs);
+		const size_t itemsPerJob = (count + numJobs - 1) / numJobs;
+		numJobs = (count + itemsPerJob - 1) / itemsPerJob;
+
+		if (numJobs == 1)
+		{
+			body(0, count);
+			return;
+		}
+
+		std::vector<JobHandle> jobs;
+		jobs.reserve(numJobs - 1);
+		for (size_t jobIdx = 1; jobIdx < numJobs; ++jobIdx)
+		{
+			const size_t begin = jobIdx * itemsPerJob;
+			const size_t end = std::min(begin + itemsPerJob, count);
+			jobs.push_back(schedule([&body, begin, end]() { body(begin, end); }));
+		}
+
+		//the calling thread takes the first range rather than waiting idle
+		body(0, itemsPerJob);
+		wait(jobs);
+	}
+
+	void JobSystem::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			if (bStopping)
+			{
+				return;
+			}
+			bStopping = true;
+		}
+		jobsAvailable.notify_all();
+
+		for (std::thread& worker : workers)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+		workers.clear(); //from here on jobs run on the threads that wait for them
+	}
+
+	void JobSystem::workerLoop(size_t queueIdx)
+	{
+		tl_workerOf = this;
+		tl_workerQueueIdx = queueIdx;
+
+		for (;;)
+		{
+			if (sp<JobHandle::Job> job = findJob(queueIdx))
+			{
+				execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			jobsAvailable.wait(lock, [this]() { return bStopping || numQueuedJobs.load() > 0; });
+			if (bStopping && numQueuedJobs.load() == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	size_t JobSystem::getCurrentQueueIdx() const
+	{
+		return tl_workerOf == this ? tl_workerQueueIdx : queues.size() - 1;
+	}
+
+	void JobSystem::enqueue(sp<JobHandle::Job> job)
+	{
+		WorkQueue& queue = *queues[getCurrentQueueIdx()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+		numQueuedJobs.fetch_add(1);
+
+		//taking the lock orders this with a worker that checked the count and is about to sleep
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		jobsAvailable.notify_one();
+	}
+
+	sp<JobHandle::Job> JobSystem::findJob(size_t queueIdx)
+	{
+		sp<JobHandle::Job> job;
+
+		//newest job from our own queue first
+		{
+			WorkQueue& queue = *queues[queueIdx];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+			}
+		}
+
+		//otherwise steal the oldest job of another queue
+		for (size_t offset = 1; !job && offset < queues.size(); ++offset)
+		{
+			WorkQueue& queue = *queues[(queueIdx + offset) % queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+			}
+		}
+
+		if (job)
+		{
+			numQueuedJobs.fetch_sub(1);
+		}
+		return job;
+	}
+
+	void JobSystem::execute(const sp<JobHandle::Job>& job)
+	{
+		job->work();
+		job->work = nullptr; //release anything the job captured before its dependents run
+
+		std::vector<sp<JobHandle::Job>> readyCandidates;
+		{
+			std::lock_guard<std::mutex> lock(job->dependentsMutex);
+			job->bDone.store(true, std::memory_order_release);
+			readyCandidates.swap(job->dependents);
+		}
+
+		for (sp<JobHandle::Job>& dependent : readyCandidates)
+		{
+			if (dependent->numUnfinishedDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				enqueue(std::move(dependent));
+			}
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+
+#include "../SAGameEntity.h"
+#include "../../Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class JobSystem;
+
+	/** Refers to a scheduled job so other jobs can depend on it or a thread can wait for it. A default handle counts as already finished. */
+	class JobHandle
+	{
+	public:
+		JobHandle() = default;
+		bool isValid() const { return job != nullptr; }
+		bool isDone() const;
+
+	private:
+		friend class JobSystem;
+		struct Job;
+		explicit JobHandle(const sp<Job>& job) : job(job) {}
+
+		sp<Job> job;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Work-stealing job system
+	//
+	// Every worker has its own queue; it runs its newest job first (whatever it just scheduled is likely still in
+	// cache) and when empty steals the oldest job from another queue. Threads that are not workers, such as the
+	// game thread, schedule into a shared queue and run jobs themselves while they wait, so waiting never idles a
+	// core and nested waits cannot deadlock.
+	//
+	// In deterministic mode every job runs on the scheduling thread at the moment it is scheduled, so jobs run in
+	// submission order; regression tests use this to get identical results from run to run.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class JobSystem : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		using RangeFunction = std::function<void(size_t /*begin*/, size_t /*end*/)>;
+
+		/** With no worker threads, jobs run on whichever thread waits for them. */
+		explicit JobSystem(size_t numWorkerThreads, bool bDeterministic = false);
+		~JobSystem();
+
+		/** The job will not start until every dependency has finished. */
+		JobHandle schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies = {});
+
+		/** Runs other jobs until job has finished. */
+		void wait(const JobHandle& job);
+		void wait(const std::vector<JobHandle>& jobs);
+
+		/** Splits [0, count) into ranges of at least minItemsPerJob and runs body on each; returns once all ranges are done.
+			Ranges may run concurrently, so body must only write to data owned by its range. */
+		void parallelFor(size_t count, size_t minItemsPerJob, const RangeFunction& body);
+
+		/** Only change this while no jobs are in flight. */
+		void setDeterministic(bool bEnable) { bDeterministic = bEnable; }
+		bool isDeterministic() const { return bDeterministic; }
+
+		size_t getNumWorkerThreads() const { return workers.size(); }
+
+		/** Finishes queued jobs and joins the workers; afterwards jobs only run on threads that wait for them. */
+		void stop();
+
+	private:
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<sp<JobHandle::Job>> jobs;
+		};
+
+		void workerLoop(size_t queueIdx);
+		size_t getCurrentQueueIdx() const;
+		void enqueue(sp<JobHandle::Job> job);
+		sp<JobHandle::Job> findJob(size_t queueIdx);
+		void execute(const sp<JobHandle::Job>& job);
+
+	private:
+		std::vector<std::thread> workers;
+		std::vector<up<WorkQueue>> queues;	//one per worker, then one shared by every other thread
+		std::atomic<size_t> numQueuedJobs{ 0 };
+
+		std::mutex sleepMutex;
+		std::condition_variable jobsAvailable;
+		bool bStopping = false;
+		bool bDeterministic = false;
+	};
+}
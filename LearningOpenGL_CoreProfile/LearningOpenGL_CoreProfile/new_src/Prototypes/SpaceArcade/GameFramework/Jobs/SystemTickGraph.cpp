@@ -0,0 +1,140 @@
+#include "SystemTickGraph.h"
+#include <algorithm>
+
+namespace SA
+{
+	static bool sharesResource(const std::vector<std::string>& first, const std::vector<std::string>& second)
+	{
+		for (const std::string& resource : first)
+		{
+			if (std::find(second.begin(), second.end(), resource) != second.end())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool touchesEverything(const SystemTickDependencies& dependencies)
+	{
+		return !dependencies.bThreadSafeTick && dependencies.reads.empty() && dependencies.writes.empty();
+	}
+
+	bool SystemTickGraph::conflicts(const SystemTickDependencies& first, const SystemTickDependencies& second)
+	{
+		if (touchesEverything(first) || touchesEverything(second))
+		{
+			return true;
+		}
+		return sharesResource(first.writes, second.writes)
+			|| sharesResource(first.writes, second.reads)
+			|| sharesResource(first.reads, second.writes);
+	}
+
+	void SystemTickGraph::addSystem(TickFunction tick, const SystemTickDependencies& dependencies, const std::string& name)
+	{
+		SystemNode node;
+		node.tick = std::move(tick);
+		node.dependencies = dependencies;
+		node.name = name;
+		for (size_t earlierIdx = 0; earlierIdx < systems.size(); ++earlierIdx)
+		{
+			if (conflicts(systems[earlierIdx].dependencies, dependencies))
+			{
+				node.prerequisites.push_back(earlierIdx);
+			}
+		}
+		systems.push_back(std::move(node));
+	}
+
+	size_t SystemTickGraph::findSystem(const std::string& name) const
+	{
+		for (size_t systemIdx = 0; systemIdx < systems.size(); ++systemIdx)
+		{
+			if (systems[systemIdx].name == name)
+			{
+				return systemIdx;
+			}
+		}
+		return systems.size();
+	}
+
+	void SystemTickGraph::clear()
+	{
+		systems.clear();
+		tickJobs.clear();
+		prerequisiteJobs.clear();
+		bStarted.clear();
+	}
+
+	void SystemTickGraph::tick(JobSystem& jobSystem, float deltaSec)
+	{
+		tickJobs.assign(systems.size(), JobHandle{});
+		bStarted.assign(systems.size(), 0);
+
+		for (size_t systemIdx = 0; systemIdx < systems.size(); ++systemIdx)
+		{
+			if (bStarted[systemIdx])
+			{
+				continue; //already scheduled ahead of a main thread system
+			}
+
+			SystemNode& system = systems[systemIdx];
+			if (system.dependencies.bThreadSafeTick)
+			{
+				gatherPrerequisiteJobs(systemIdx);
+				tickJobs[systemIdx] = jobSystem.schedule([&system, deltaSec]() { system.tick(deltaSec); }, prerequisiteJobs);
+			}
+			else
+			{
+				//deterministic jobs run the moment they are scheduled, so scheduling ahead would break registration order
+				if (!jobSystem.isDeterministic())
+				{
+					scheduleReadyThreadSafeSystems(jobSystem, deltaSec, systemIdx + 1);
+				}
+
+				//main thread systems leave a default (already finished) handle behind, since they are done before anything that waits on them is scheduled
+				gatherPrerequisiteJobs(systemIdx);
+				jobSystem.wait(prerequisiteJobs);
+				system.tick(deltaSec);
+			}
+			bStarted[systemIdx] = 1;
+		}
+
+		jobSystem.wait(tickJobs);
+	}
+
+	void SystemTickGraph::scheduleReadyThreadSafeSystems(JobSystem& jobSystem, float deltaSec, size_t firstSystemIdx)
+	{
+		//prerequisites always come earlier, so one pass also picks up systems that wait on systems scheduled earlier in the pass
+		for (size_t systemIdx = firstSystemIdx; systemIdx < systems.size(); ++systemIdx)
+		{
+			SystemNode& system = systems[systemIdx];
+			if (bStarted[systemIdx] || !system.dependencies.bThreadSafeTick)
+			{
+				continue;
+			}
+
+			bool bReady = true;
+			for (size_t prerequisiteIdx : system.prerequisites)
+			{
+				bReady = bReady && bStarted[prerequisiteIdx];
+			}
+			if (bReady)
+			{
+				gatherPrerequisiteJobs(systemIdx);
+				tickJobs[systemIdx] = jobSystem.schedule([&system, deltaSec]() { system.tick(deltaSec); }, prerequisiteJobs);
+				bStarted[systemIdx] = 1;
+			}
+		}
+	}
+
+	void SystemTickGraph::gatherPrerequisiteJobs(size_t systemIdx)
+	{
+		prerequisiteJobs.clear();
+		for (size_t prerequisiteIdx : systems[systemIdx].prerequisites)
+		{
+			prerequisiteJobs.push_back(tickJobs[prerequisiteIdx]);
+		}
+	}
+}
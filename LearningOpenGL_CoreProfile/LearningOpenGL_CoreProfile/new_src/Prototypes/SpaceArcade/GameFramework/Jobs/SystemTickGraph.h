@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "JobSystem.h"
+
+namespace SA
+{
+	/** What a system's tick touches. Resources are just names that systems agree on, eg "world" or "audio". */
+	struct SystemTickDependencies
+	{
+		/** Ticks that are not thread safe run on the main thread, in registration order with the other main thread ticks.
+			A main thread tick that declares no resources is assumed to touch everything, so it waits for every earlier system
+			and every later one waits for it; this is what systems that do not declare anything get. A thread safe tick that
+			declares no resources touches nothing. */
+		bool bThreadSafeTick = false;
+		std::vector<std::string> reads;
+		std::vector<std::string> writes;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Runs system ticks as jobs, ordered only where their declared dependencies conflict.
+	//
+	// A system waits for every earlier system that writes something it reads or writes, or that reads something
+	// it writes. Everything else may tick at the same time. Systems that are not thread safe tick inline on the
+	// thread calling tick(), in registration order. Before each of those, every later thread safe system that does
+	// not wait on it is scheduled, so worker threads tick them alongside the main thread.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SystemTickGraph
+	{
+	public:
+		using TickFunction = std::function<void(float /*deltaSec*/)>;
+
+		/** Systems tick in the order they are added, whenever their dependencies allow it. */
+		void addSystem(TickFunction tick, const SystemTickDependencies& dependencies, const std::string& name = "");
+		void clear();
+
+		/** In deterministic mode every system ticks in registration order. */
+		void tick(JobSystem& jobSystem, float deltaSec);
+
+		size_t getNumSystems() const { return systems.size(); }
+		/** indices of the earlier systems that systemIdx waits on */
+		const std::vector<size_t>& getPrerequisites(size_t systemIdx) const { return systems[systemIdx].prerequisites; }
+		const SystemTickDependencies& getDependencies(size_t systemIdx) const { return systems[systemIdx].dependencies; }
+		const std::string& getName(size_t systemIdx) const { return systems[systemIdx].name; }
+		/** Returns getNumSystems() if no system has the name. */
+		size_t findSystem(const std::string& name) const;
+
+		static bool conflicts(const SystemTickDependencies& first, const SystemTickDependencies& second);
+
+	private:
+		void scheduleReadyThreadSafeSystems(JobSystem& jobSystem, float deltaSec, size_t firstSystemIdx);
+		void gatherPrerequisiteJobs(size_t systemIdx);
+
+	private:
+		struct SystemNode
+		{
+			TickFunction tick;
+			SystemTickDependencies dependencies;
+			std::string name;
+			std::vector<size_t> prerequisites;
+		};
+		std::vector<SystemNode> systems;
+
+		//scratch reused every frame
+		std::vector<JobHandle> tickJobs;
+		std::vector<JobHandle> prerequisiteJobs;
+		std::vector<uint8_t> bStarted;	//thread safe systems once scheduled, main thread systems once ticked
+	};
+}
@@ -9,6 +9,7 @@ namespace SA
 
 	class RenderModelEntity : public WorldEntity
 	{
+		friend LevelBase;
 	public:
 		RenderModelEntity(const sp<Model3D>& inModel, const Transform& spawnTransform = Transform{})
 			: WorldEntity(spawnTransform),
@@ -24,6 +25,7 @@ namespace SA
 	private:
 		sp<Model3D> model;
 		sp<const Model3D> constView;
+		SlotHandle levelRenderHandle; //handle into the level's render entities
 	};
 
 
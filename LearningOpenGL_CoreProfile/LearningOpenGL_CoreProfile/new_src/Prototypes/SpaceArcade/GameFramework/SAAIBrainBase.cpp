@@ -6,6 +6,7 @@
 #include "SAGameBase.h"
 #include "SALevel.h"
 #include "SABehaviorTree.h"
+#include "SACompiledBehaviorTree.h"
 #include "SATimeManagementSystem.h"
 
 namespace SA
@@ -22,13 +23,104 @@ namespace SA
 		bActive = false;
 	}
 
-	bool BehaviorTreeBrain::onAwaken()
+	/////////////////////////////////////////////////////////////////////////////////////
+	// One compiled tree group per definition per level, ticked by the level's world time manager like a brain.
+	//		-brains join and leave on awaken/sleep; ship spawns and destroys are deferred out of the tick, so never while the group ticks.
+	/////////////////////////////////////////////////////////////////////////////////////
+	class CompiledTreeBrainGroup : public GameEntity, public ITickable
 	{
+	public:
+		CompiledTreeBrainGroup(const sp<const BehaviorTree::CompiledTreeDefinition>& definition, const sp<LevelBase>& level)
+			: group(definition), level(level)
+		{}
+
+		static sp<CompiledTreeBrainGroup> findOrCreate(const sp<const BehaviorTree::CompiledTreeDefinition>& definition, const sp<LevelBase>& level)
+		{
+			static std::vector<wp<CompiledTreeBrainGroup>> groups;
+
+			sp<CompiledTreeBrainGroup> found = nullptr;
+			for (size_t idx = 0; idx < groups.size();)
+			{
+				sp<CompiledTreeBrainGroup> existing = groups[idx].lock();
+				if (!existing || existing->level.expired())
+				{
+					groups[idx] = groups.back();
+					groups.pop_back();
+					continue;
+				}
+				if (&existing->group.getDefinition() == definition.get() && existing->level.lock() == level)
+				{
+					found = existing;
+				}
+				++idx;
+			}
+
+			if (!found)
+			{
+				found = new_sp<CompiledTreeBrainGroup>(definition, level);
+				groups.push_back(found);
+			}
+			return found;
+		}
+
+		/** The new instance is not started, so the brain can fill in its memory first. */
+		uint32_t join()
+		{
+			assert(!bTicking);
+			const uint32_t instance = group.addInstance();
 
+			if (group.getNumInstances() == 1)
+			{
+				level.lock()->getWorldTimeManager()->registerTicker(sp_this());
+			}
+			return instance;
+		}
+
+		void leave(uint32_t instance)
+		{
+			assert(!bTicking);
+			group.removeInstance(instance);
+
+			if (group.getNumInstances() == 0 && !level.expired())
+			{
+				level.lock()->getWorldTimeManager()->removeTicker(sp_this());
+			}
+		}
+
+		void start(uint32_t instance) { group.start(instance); }
+		BehaviorTree::Memory& getMemory(uint32_t instance) { return group.getMemory(instance); }
+
+	protected:
+		virtual bool tick(float dt_sec) override
+		{
+			bTicking = true;
+			group.tick(dt_sec);
+			bTicking = false;
+			return true;
+		}
+
+	private:
+		BehaviorTree::CompiledTreeGroup group;
+		wp<LevelBase> level;
+		bool bTicking = false;
+	};
+
+	bool BehaviorTreeBrain::onAwaken()
+	{
 		if (const sp<LevelBase>& currentLevel = GameBase::get().getLevelSystem().getCurrentLevel())
 		{
-			behaviorTree->start();
-			currentLevel->getWorldTimeManager()->registerTicker(sp_this());
+			if (compiledTree)
+			{
+				compiledGroup = CompiledTreeBrainGroup::findOrCreate(compiledTree, currentLevel);
+				compiledInstance = compiledGroup->join();
+				initCompiledTreeMemory(compiledGroup->getMemory(compiledInstance));
+				compiledGroup->start(compiledInstance);
+			}
+			else
+			{
+				behaviorTree->start();
+				currentLevel->getWorldTimeManager()->registerTicker(sp_this());
+			}
 			tickingOnLevel = currentLevel;
 			return true;
 		}
@@ -37,6 +129,13 @@ namespace SA
 
 	void BehaviorTreeBrain::onSleep()
 	{
+		if (compiledGroup)
+		{
+			compiledGroup->leave(compiledInstance);
+			compiledGroup = nullptr;
+			return;
+		}
+
 		behaviorTree->stop();
 
 		if (!tickingOnLevel.expired())
@@ -45,11 +144,19 @@ namespace SA
 		}
 	}
 
+	BehaviorTree::Memory* BehaviorTreeBrain::getTreeMemory()
+	{
+		if (behaviorTree)
+		{
+			return &behaviorTree->getMemory();
+		}
+		return compiledGroup ? &compiledGroup->getMemory(compiledInstance) : nullptr;
+	}
+
 	bool BehaviorTreeBrain::tick(float dt_sec)
 	{
 		behaviorTree->tick(dt_sec);
 		return true;
 	}
 
-}
-
+}
\ No newline at end of file
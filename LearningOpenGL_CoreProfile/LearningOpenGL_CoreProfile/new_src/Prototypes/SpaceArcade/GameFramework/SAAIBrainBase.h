@@ -14,8 +14,11 @@ namespace SA
 	namespace BehaviorTree
 	{
 		class Tree;
+		class Memory;
+		class CompiledTreeDefinition;
 	}
 	class LevelBase;
+	class CompiledTreeBrainGroup;
 
 	//#TODO this probably needs to exist separately in another header, so  player can do pattern of having protected member return a key
 	/** Special key to allows brains (ai/player) to access methods
@@ -52,6 +55,8 @@ namespace SA
 	/////////////////////////////////////////////////////////////////////////////////////
 	// 	A brain that uses a behavior tree to make decisions
 	//		-expects behavior tree to be set in the child postConstruct method
+	//		-a child may set compiledTree instead; every awake brain on a level running the same
+	//			compiled definition is one instance of a shared CompiledTreeGroup, ticked together.
 	/////////////////////////////////////////////////////////////////////////////////////
 	class BehaviorTreeBrain : public AIBrain, public ITickable
 	{
@@ -62,15 +67,28 @@ namespace SA
 		virtual bool onAwaken() override;
 		virtual void onSleep() override;
 
-		BehaviorTree::Tree& getBehaviorTree() { return *behaviorTree.get(); }
-		const BehaviorTree::Tree& getBehaviorTree() const { return *behaviorTree.get(); }
+		/** Null if this brain runs a compiled tree. */
+		BehaviorTree::Tree* findBehaviorTree() { return behaviorTree.get(); }
+		const BehaviorTree::Tree* findBehaviorTree() const { return behaviorTree.get(); }
+
+		/** Memory of whichever tree this brain runs; null for a compiled tree while the brain is asleep. */
+		BehaviorTree::Memory* getTreeMemory();
 
 	protected:
 		virtual bool tick(float dt_sec) override;
 
+		/** Called for compiled trees once the brain's instance memory exists, before the tree starts. Use it for values
+			a MemoryInitializer cannot hold, like inline primitives and weak handles. */
+		virtual void initCompiledTreeMemory(BehaviorTree::Memory& memory) {}
+
 	protected:
 		sp<BehaviorTree::Tree> behaviorTree;
+		sp<const BehaviorTree::CompiledTreeDefinition> compiledTree;
 		wp<LevelBase> tickingOnLevel;
+
+	private:
+		sp<CompiledTreeBrainGroup> compiledGroup;
+		uint32_t compiledInstance = 0;
 	};
 
 }
\ No newline at end of file
@@ -9,15 +9,242 @@
 #include "../Rendering/Camera/Texture_2D.h"
 #include <dr_lib/dr_wav.h>
 #include "Audio/SoundRawData.h"
+#include "Audio/WavStreamDecoder.h"
 #include "Audio/OpenALUtilities.h"
 #include "SAAudioSystem.h"
 #include "SAGameBase.h"
 #include "SALog.h"
+#include "SATimeManagementSystem.h"
+#include "Jobs/SystemTickGraph.h"
+
+#include <thread>
+#include <algorithm>
 
 namespace SA
 {
+	/** pixels decoded by stb on a worker thread, waiting to be uploaded */
+	struct DecodedImageData
+	{
+		unsigned char* pixels = nullptr;
+		int width = 0;
+		int height = 0;
+		int numChannels = 0;
+
+		~DecodedImageData()
+		{
+			if (pixels)
+			{
+				stbi_image_free(pixels);
+			}
+		}
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Decodes wavs with dr_wav and makes OpenAL buffers for the sound cache
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AssetSystem::SoundCacheBackend : public SoundBufferCacheBackend
+	{
+	public:
+		virtual up<SoundRawData> decode(const std::string& path) override
+		{
+			up<SoundRawData> sound = decodeSoundFile(path);
+			if (!sound)
+			{
+				logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "Failed to load sound %s", path.c_str());
+				STOP_DEBUGGER_HERE();
+			}
+			return sound;
+		}
+
+		virtual BufferId createBuffer(const SoundRawData& soundData) override
+		{
+#ifdef USE_OPENAL_API
+			AudioSystem& audioSystem = GameBase::get().getAudioSystem();
+			if (!audioSystem.hasValidOpenALDevice())
+			{
+				return 0;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			//clear previous errors so we can safely read if we had an error creating a buffer
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			constexpr size_t numAlErrorsBeforeGiveup = 100;
+			size_t errorNumber = 0;
+			ALenum error = alGetError(); //clear any error
+			while (error != AL_NO_ERROR && errorNumber < numAlErrorsBeforeGiveup)
+			{
+				//log that we had a previous error before we attempted to fill a buffer
+				logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "previous OpenAL errors before attempting to create buffer! %d", int(error));
+				error = alGetError(); //clear any error
+				++errorNumber;
+			}
+
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			//create buffer
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			//manual error checking so we know if we created a buffer
+			ALuint buffer = 0;
+			alGenBuffers(1, &buffer);
+			error = alGetError(); //see if creating buffer threw an error
+
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			// fill buffer
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			if (error == AL_NO_ERROR)
+			{
+				alBufferData(buffer,
+					soundData.channels > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16,
+					soundData.pcmData.data(),
+					ALsizei(soundData.pcmData.size() * 2) /*two bytes per sample*/,
+					soundData.sampleRate
+				);
+				error = alGetError(); //see if we failed to fill the buffer
+				if (error == AL_NO_ERROR)
+				{
+					return buffer;
+				}
+				else
+				{
+					alec(alDeleteBuffers(1, &buffer)); //clean up buffer since we created it but couldn't populate it
+					logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "failed to populate AL buffer %d", int(error));
+				}
+			}
+			else
+			{
+				logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "failed to create AL buffer %d", int(error));
+			}
+#endif //USE_OPENAL_API
+			return 0;
+		}
+
+		virtual void destroyBuffer(BufferId buffer) override
+		{
+#ifdef USE_OPENAL_API
+			ALuint alBuffer = buffer;
+			alec(alDeleteBuffers(1, &alBuffer));
+#endif //USE_OPENAL_API
+		}
+	};
+
+	AssetSystem::AssetSystem()
+	{
+		soundCache = new_sp<SoundBufferCache>(new_up<SoundCacheBackend>(), defaultSoundCacheBudgetBytes);
+
+		//leave a core for the game thread; decoding is io heavy so a few threads is plenty
+		size_t hardwareThreads = size_t(std::thread::hardware_concurrency());
+		size_t numWorkers = std::clamp<size_t>(hardwareThreads > 1 ? hardwareThreads - 1 : 1, 1, 4);
+		assetWorkerPool = new_up<AssetWorkerPool>(numWorkers);
+
+		asyncModelQueue = new_up<AsyncAssetQueue<BakedModel, Model3D>>(*assetWorkerPool,
+			[](const std::string& path) { return ModelBake::loadOrBake(path); },
+			[this](const std::string& path, up<BakedModel> bakedModel) -> sp<Model3D>
+			{
+				//a synchronous load may have finished first
+				if (sp<Model3D> existing = getModel(path))
+				{
+					return existing;
+				}
+				try
+				{
+					sp<Model3D> loadedModel = new_sp<Model3D>(path.c_str(), std::move(bakedModel));
+					loadedModel3Ds[path] = loadedModel;
+					if (!loadedModel->bindLoadedTextures())
+					{
+						modelsAwaitingTextures.push_back(loadedModel);
+					}
+					return loadedModel;
+				}
+				catch (std::runtime_error&)
+				{
+					return nullptr;
+				}
+			});
+
+		asyncTextureQueue = new_up<AsyncAssetQueue<DecodedImageData, TextureAsset>>(*assetWorkerPool,
+			[](const std::string& path) -> up<DecodedImageData>
+			{
+				up<DecodedImageData> image = new_up<DecodedImageData>();
+				image->pixels = stbi_load(path.c_str(), &image->width, &image->height, &image->numChannels, 0);
+				if (!image->pixels)
+				{
+					std::cerr << "failed to load texture" << path << std::endl;
+					return nullptr;
+				}
+				if (image->numChannels != 1 && image->numChannels != 3 && image->numChannels != 4)
+				{
+					std::cerr << "unsupported image format for texture at " << path << " there are " << image->numChannels << "channels" << std::endl;
+					return nullptr;
+				}
+				return image;
+			},
+			[this](const std::string& path, up<DecodedImageData> image) -> sp<TextureAsset>
+			{
+				sp<TextureAsset> texture = new_sp<TextureAsset>();
+				auto previousLoadTextureIter = loadedTextureIds.find(path);
+				if (previousLoadTextureIter != loadedTextureIds.end())
+				{
+					texture->textureId = previousLoadTextureIter->second;
+					return texture;
+				}
+				if (!loadTexture_internal(image->pixels, image->width, image->height, image->numChannels, path.c_str(), texture->textureId))
+				{
+					return nullptr;
+				}
+				loadedTextureIds.insert({ path, texture->textureId });
+				return texture;
+			});
+
+		asyncSoundQueue = new_up<AsyncAssetQueue<SoundRawData, SoundRawData>>(*assetWorkerPool,
+			[](const std::string& path) { return decodeSoundFile(path); },
+			[this](const std::string& path, up<SoundRawData> soundData) -> sp<SoundRawData>
+			{
+				//a synchronous load may have finished first, in which case that one is kept
+				return soundCache->insert(path, std::move(soundData));
+			});
+
+		asyncUploadPump = new_sp<AsyncUploadPump>(asyncUploadBudgetMs);
+		asyncUploadPump->addQueue(*asyncModelQueue);
+		asyncUploadPump->addQueue(*asyncTextureQueue);
+		asyncUploadPump->addQueue(*asyncSoundQueue);
+	}
+
+	AssetSystem::~AssetSystem()
+	{
+		//join workers before the queues they deliver to are destroyed
+		assetWorkerPool->stop();
+	}
+
+	void AssetSystem::initSystem()
+	{
+		//system time is not dilated, so uploads continue while the game is paused or in slow motion
+		GameBase::get().getSystemTimeManager().registerTicker(asyncUploadPump);
+	}
+
+	void AssetSystem::tick(float deltaSec)
+	{
+		//material textures of async models are uploaded after the model itself; hand their ids to the meshes once they are
+		modelsAwaitingTextures.erase(
+			std::remove_if(modelsAwaitingTextures.begin(), modelsAwaitingTextures.end(),
+				[](const wp<Model3D>& weakModel)
+				{
+					sp<Model3D> model = weakModel.lock();
+					return !model || model->bindLoadedTextures();
+				}),
+			modelsAwaitingTextures.end());
+	}
+
+	void AssetSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		//binds gl textures to models; async loads are pumped by a system time manager ticker, not here
+		outDependencies.writes = { "assets" };
+	}
+
 	void AssetSystem::shutdown()
 	{
+		//no more uploads may happen once GPU resources start being released
+		assetWorkerPool->stop();
+		GameBase::get().getSystemTimeManager().removeTicker(asyncUploadPump);
+
 		for (const auto& textureMapIter : loadedTextureIds)
 		{
 			GLuint textureId = textureMapIter.second;
@@ -75,7 +302,7 @@ namespace SA
 		}
 	}
 
-	AssetHandle<SoundRawData> AssetSystem::loadSound(const std::string& relative_filepath)
+	up<SoundRawData> AssetSystem::decodeSoundFile(const std::string& relative_filepath)
 	{
 		SoundRawData loadedData;
 		drwav_int16* pSampleData = drwav_open_file_and_read_pcm_frames_s16(relative_filepath.c_str(), &loadedData.channels, &loadedData.sampleRate, &loadedData.totalPCMFrameCount, nullptr);
@@ -92,25 +319,18 @@ namespace SA
 			bSuccess = false;
 		}
 
-		sp<SoundRawData> loadedDataPtr = nullptr;
+		up<SoundRawData> loadedDataPtr = nullptr;
 
 		if (bSuccess)
 		{
 			loadedData.pcmData.resize(size_t(loadedData.getTotalSamples()));
 			std::memcpy(loadedData.pcmData.data(), pSampleData, loadedData.pcmData.size() * /*twobytes_in_s16*/2);
-			loadedDataPtr = new_sp<SoundRawData>(std::move(loadedData));
+			loadedDataPtr = new_up<SoundRawData>(std::move(loadedData));
 			//loadedData should now be considered empty!
 
 			//sample rate is samples per sec (generally 44100 hz)
 			//total frame count should be the same regardless if it is mono,stereo, etc.
 			loadedDataPtr->durationSec = float(loadedDataPtr->totalPCMFrameCount) / float(loadedDataPtr->sampleRate);
-
-			loadedSoundPcmData.insert({ relative_filepath, loadedDataPtr });
-		}
-		else
-		{
-			logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "Failed to load sound %s", relative_filepath.c_str());
-			STOP_DEBUGGER_HERE();
 		}
 
 		drwav_free(pSampleData, /*allocation callbacks*/nullptr);
@@ -118,16 +338,59 @@ namespace SA
 		return loadedDataPtr;
 	}
 
+	AssetHandle<SoundRawData> AssetSystem::loadSound(const std::string& relative_filepath)
+	{
+		return soundCache->loadSound(relative_filepath);
+	}
+
 	AssetHandle<SoundRawData> AssetSystem::getSound(const std::string& relative_filepath)
 	{
-		auto findIter = loadedSoundPcmData.find(relative_filepath);
-		if (findIter != loadedSoundPcmData.end())
+		return soundCache->find(relative_filepath);
+	}
+
+	SoundBufferPin AssetSystem::pinSound(const std::string& relative_filepath, bool bWithBuffer)
+	{
+		return soundCache->pin(relative_filepath, bWithBuffer);
+	}
+
+	void AssetSystem::setSoundCacheBudget(size_t budgetBytes)
+	{
+		soundCache->setBudget(budgetBytes);
+	}
+
+	const SoundBufferCacheStats& AssetSystem::getSoundCacheStats() const
+	{
+		return soundCache->getStats();
+	}
+
+	AsyncAssetHandle<Model3D> AssetSystem::loadModelAsync(const std::string& relative_filepath)
+	{
+		if (sp<Model3D> loadedModel = getModel(relative_filepath))
 		{
-			const sp<SoundRawData>& foundResult = findIter->second;
-			return foundResult;
+			return AsyncAssetHandle<Model3D>::resolved(relative_filepath, loadedModel);
 		}
+		return asyncModelQueue->request(relative_filepath);
+	}
 
-		return nullptr;
+	AsyncAssetHandle<TextureAsset> AssetSystem::loadTextureAsync(const std::string& relative_filepath)
+	{
+		auto previousLoadTextureIter = loadedTextureIds.find(relative_filepath);
+		if (previousLoadTextureIter != loadedTextureIds.end())
+		{
+			sp<TextureAsset> texture = new_sp<TextureAsset>();
+			texture->textureId = previousLoadTextureIter->second;
+			return AsyncAssetHandle<TextureAsset>::resolved(relative_filepath, texture);
+		}
+		return asyncTextureQueue->request(relative_filepath);
+	}
+
+	AsyncAssetHandle<SoundRawData> AssetSystem::loadSoundAsync(const std::string& relative_filepath)
+	{
+		if (sp<SoundRawData> loadedSound = soundCache->find(relative_filepath))
+		{
+			return AsyncAssetHandle<SoundRawData>::resolved(relative_filepath, loadedSound);
+		}
+		return asyncSoundQueue->request(relative_filepath);
 	}
 
 	sp<SA::Texture_2D> AssetSystem::getNullBlackTexture() const
@@ -186,105 +449,40 @@ namespace SA
 		return bSuccess;
 	}
 
-#ifdef USE_OPENAL_API
-	ALBufferWrapper AssetSystem::loadOpenAlBuffer(const std::string& relative_filepath)
+	up<AudioStreamDecoder> AssetSystem::openSoundStream(const std::string& relative_filepath)
 	{
-		auto previousLoad = assetPathToloadedAlBuffers.find(relative_filepath);
-		if (previousLoad != assetPathToloadedAlBuffers.end())
+		up<AudioStreamDecoder> decoder = WavStreamDecoder::open(relative_filepath);
+		if (!decoder)
 		{
-			return previousLoad->second;
+			logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "Failed to open sound stream %s", relative_filepath.c_str());
 		}
-		else
-		{
-			AudioSystem& audioSystem = GameBase::get().getAudioSystem();
-			if (audioSystem.hasValidOpenALDevice())
-			{
-				AssetHandle<SoundRawData> soundPcmAsset = loadSound(relative_filepath);
-				if (const SA::SoundRawData* soundData = soundPcmAsset.getAsset())
-				{
-					ALBufferWrapper alWrapper = {};
-					alWrapper.durationSec = soundData->durationSec;
-
-					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					//clear previous errors so we can safely read if we had an error creating a buffer
-					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					constexpr size_t numAlErrorsBeforeGiveup = 100;
-					size_t errorNumber = 0;
-					ALenum error = alGetError(); //clear any error
-					while (error != AL_NO_ERROR && errorNumber < numAlErrorsBeforeGiveup)
-					{
-						//log that we had a previous error before we attempted to fill a buffer
-						logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "previous OpenAL errors before attempting to create buffer! %d", int(error));
-						error = alGetError(); //clear any error
-						++errorNumber;
-					}
+		return decoder;
+	}
 
-					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					//create buffer
-					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					//manual error checking so we know if we created a buffer
-					alGenBuffers(1, &alWrapper.buffer);
-					error = alGetError(); //see if creating buffer threw an error
-
-					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					// fill buffer
-					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					if (error == AL_NO_ERROR)
-					{
-						alBufferData(alWrapper.buffer,
-							soundData->channels > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16,
-							soundData->pcmData.data(),
-							soundData->pcmData.size() * 2 /*two bytes per sample*/,
-							soundData->sampleRate
-						);
-						error = alGetError(); //see if we failed to fill the buffer
-						if (error == AL_NO_ERROR)
-						{
-							assetPathToloadedAlBuffers.insert({ relative_filepath, alWrapper});
-							return alWrapper;
-						}
-						else
-						{
-							alec(alDeleteBuffers(1, &alWrapper.buffer)); //clean up buffer since we created it but couldn't populate it
-							logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "failed to populate AL buffer %d", int(error));
-						}
-					}
-					else
-					{
-						logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "failed to create AL buffer %d", int(error));
-					}
-				}
-			}
+#ifdef USE_OPENAL_API
+	ALBufferWrapper AssetSystem::loadOpenAlBuffer(const std::string& relative_filepath)
+	{
+		ALBufferWrapper alWrapper = {};
+		alWrapper.buffer = soundCache->loadBuffer(relative_filepath);
+		if (sp<SoundRawData> soundData = soundCache->find(relative_filepath))
+		{
+			alWrapper.durationSec = soundData->durationSec;
 		}
-
-		ALBufferWrapper nullBuffer;
-		return nullBuffer;
+		return alWrapper;
 	}
 
 	bool AssetSystem::unloadOpenALBuffer(const std::string& relative_filepath)
 	{
-		auto previousLoad = assetPathToloadedAlBuffers.find(relative_filepath);
-		if (previousLoad != assetPathToloadedAlBuffers.end())
-		{
-			ALuint alBuffer = previousLoad->second.buffer;
-			alec(alDeleteBuffers(1, &alBuffer))
-
-			assetPathToloadedAlBuffers.erase(relative_filepath);
-
-			return true;
-		}
-		return false;
+		return soundCache->unload(relative_filepath);
 	}
 
 	void AssetSystem::unloadAllOpenALBuffers()
 	{
 		log(__FUNCTION__, LogLevel::LOG, "Cleaning up audio buffers from asset system");
-		for (auto& kv_pair : assetPathToloadedAlBuffers)
-		{
-			ALuint buffer = kv_pair.second.buffer;
-			alec(alDeleteBuffers(1, &buffer));
-		}
-		assetPathToloadedAlBuffers.clear();
+		const SoundBufferCacheStats& stats = soundCache->getStats();
+		logf_sa(__FUNCTION__, LogLevel::LOG, "sound cache: hits %d misses %d evictions %d peak bytes %d",
+			int(stats.numHits), int(stats.numMisses), int(stats.numEvictions), int(stats.peakResidentBytes));
+		soundCache->unloadAll();
 		log(__FUNCTION__, LogLevel::LOG, "complete");
 	}
 
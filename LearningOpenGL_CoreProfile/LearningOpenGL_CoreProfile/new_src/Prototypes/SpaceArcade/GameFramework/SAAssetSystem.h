@@ -11,15 +11,27 @@
 #include<GLFW/glfw3.h>
 #include <set>
 #include <map>
+#include <vector>
 #include <string>
 #include "../Tools/DataStructures/SATransform.h" //glm
 #include "AssetManagement/AssetHandle.h"
+#include "AssetManagement/AsyncAssetLoader.h"
+#include "AssetManagement/SoundBufferCache.h"
 
 namespace SA
 {
 	class Model3D;
 	class Texture_2D;
 	struct SoundRawData;
+	class AudioStreamDecoder;
+	struct BakedModel;
+	struct DecodedImageData;
+
+	/** GL texture produced by an asynchronous texture load; the texture is owned by the AssetSystem like synchronously loaded textures */
+	struct TextureAsset
+	{
+		GLuint textureId = 0;
+	};
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// System for managing load/unload of game assets such as models, textures, and sounds.
@@ -27,9 +39,13 @@ namespace SA
 	class AssetSystem : public SystemBase
 	{
 	public:
+		AssetSystem();
+		~AssetSystem();
+
 		sp<Model3D> loadModel(const char* relative_filepath);
 		sp<Model3D> loadModel(const std::string& relative_filepath);
 		sp<Model3D> getModel(const std::string& key) const;
+		/** Sounds are cached within a memory budget (see SoundBufferCache); handles expire if the sound is evicted */
 		AssetHandle<SoundRawData> loadSound(const std::string& relative_filepath);
 		AssetHandle<SoundRawData> getSound(const std::string& relative_filepath);
 		sp<Texture_2D> getNullBlackTexture() const;
@@ -37,22 +53,49 @@ namespace SA
 		bool loadTexture(const char* relative_filepath, GLuint& outTexId, int texture_unit = -1, bool useGammaCorrection = false);
 		bool loadTexture(glm::vec3 solidColor, GLuint& outTexId, int texture_unit = -1, bool useGammaCorrection = false);
 
+		/** Asynchronous loading: file io and decoding happen on worker threads; GPU uploads happen on the game thread
+			a few per frame (see asyncUploadBudgetMs). Poll the returned handle; loads already done synchronously resolve immediately.
+			Requests for a path that is still loading share the same handle. */
+		AsyncAssetHandle<Model3D> loadModelAsync(const std::string& relative_filepath);
+		AsyncAssetHandle<TextureAsset> loadTextureAsync(const std::string& relative_filepath);
+		AsyncAssetHandle<SoundRawData> loadSoundAsync(const std::string& relative_filepath);
+
+		/** Opens a sound to be decoded as it plays (see AudioStream); nothing is cached, each call gets its own decoder */
+		up<AudioStreamDecoder> openSoundStream(const std::string& relative_filepath);
+
+		/** Loads the sound and keeps it from being evicted while the pin is held; bWithBuffer also creates its api buffer.
+			Hold one while the buffer is attached to a source, or the pcm is in use. */
+		SoundBufferPin pinSound(const std::string& relative_filepath, bool bWithBuffer);
+		void setSoundCacheBudget(size_t budgetBytes);
+		const SoundBufferCacheStats& getSoundCacheStats() const;
+
 #ifdef USE_OPENAL_API
+		/** the buffer is not pinned; see pinSound */
 		ALBufferWrapper loadOpenAlBuffer(const std::string& relative_filepath);
 		bool unloadOpenALBuffer(const std::string& relative_filepath);
 		void unloadAllOpenALBuffers();
 #endif
 	private:
+		class SoundCacheBackend;
+		static up<SoundRawData> decodeSoundFile(const std::string& relative_filepath);
 		bool loadTexture_internal(unsigned char* textureDataBytes, int img_width, int img_height, int img_nrChannels, const char* relative_filepath, GLuint& outTexId, int texture_unit = -1, bool useGammaCorrection = false);
 	private:
+		virtual void initSystem() override;
 		virtual void shutdown() override;
-		virtual void tick(float deltaSec) {};
+		virtual void tick(float deltaSec) override;
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
+	private:
+		static constexpr double asyncUploadBudgetMs = 2.0;
+		static constexpr size_t defaultSoundCacheBudgetBytes = 256 * 1024 * 1024;
+		up<AssetWorkerPool> assetWorkerPool;
+		up<AsyncAssetQueue<BakedModel, Model3D>> asyncModelQueue;
+		up<AsyncAssetQueue<DecodedImageData, TextureAsset>> asyncTextureQueue;
+		up<AsyncAssetQueue<SoundRawData, SoundRawData>> asyncSoundQueue;
+		sp<AsyncUploadPump> asyncUploadPump;
 	private:
 		std::map<std::string, sp<Model3D>> loadedModel3Ds;
+		std::vector<wp<Model3D>> modelsAwaitingTextures; //async models whose material textures are still loading
 		std::map<std::string, GLuint> loadedTextureIds; //open question as to whether asset system should be managing API memory
-		std::map<std::string, sp<SoundRawData>> loadedSoundPcmData;
-#ifdef USE_OPENAL_API
-		std::map<std::string, ALBufferWrapper> assetPathToloadedAlBuffers;
-#endif
+		sp<SoundBufferCache> soundCache;
 	};
 }
\ No newline at end of file
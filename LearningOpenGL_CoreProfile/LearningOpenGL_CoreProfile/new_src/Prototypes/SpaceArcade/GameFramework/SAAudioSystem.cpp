@@ -2,6 +2,10 @@
 #include "SAGameBase.h"
 #include "SAGameEntity.h"
 #include "Audio/OpenALUtilities.h"
+#include "Audio/AudioStream.h"
+#include "Audio/SoundRawData.h"
+#include "Audio/OpenALStreamBackend.h"
+#include "AssetManagement/AsyncAssetLoader.h"
 #include "SALog.h"
 #include "SAAssetSystem.h"
 #include "SALevel.h"
@@ -16,6 +20,7 @@
 #include "TimeManagement/TickGroupManager.h"
 #include "SADebugRenderSystem.h"
 #include "SARandomNumberGenerationSystem.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -82,6 +87,10 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 	void AudioEmitter::setLooping(bool bLooping)
 	{
 		this->userData.bLooping = bLooping;
+		if (hardwareData.stream)
+		{
+			hardwareData.stream->setLooping(bLooping);
+		}
 
 		if (this->systemMetaData.bPlaying)
 		{
@@ -174,6 +183,18 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		setGain(gain);
 	}
 
+	void AudioEmitter::setStreaming(bool bStreaming)
+	{
+		if (userData.bStreaming != bStreaming)
+		{
+			userData.bStreaming = bStreaming;
+			if (!userData.sfxAssetPath.empty())
+			{
+				GameBase::get().getAudioSystem().trySetEmitterBuffer(*this, AudioSystem::EmitterPrivateKey{});
+			}
+		}
+	}
+
 	void AudioEmitter::stop()
 	{
 		AudioSystem& audioSystem = GameBase::get().getAudioSystem();
@@ -188,6 +209,7 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 
 		//for non-looping sounds, the start time can be used to auto-deactivate sounds that never had the priority to play
 		systemMetaData.playStartTimeStamp.reset();
+		systemMetaData.resumeFrame = 0;
 		if (const sp<LevelBase>& currentLevel = GameBase::get().getLevelSystem().getCurrentLevel())
 		{
 			const sp<TimeManager>& worldTM = currentLevel->getWorldTimeManager();
@@ -234,27 +256,32 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 	void AudioSystem::trySetEmitterBuffer(AudioEmitter& emitter, const EmitterPrivateKey&)
 	{
 #if USE_OPENAL_API
-		const std::string& path = emitter.userData.sfxAssetPath;
+		if (emitter.userData.bStreaming)
+		{
+			trySetEmitterStream(emitter);
+			return;
+		}
+		emitter.hardwareData.stream = nullptr; //stops the stream if this emitter was previously streaming
+		emitter.hardwareData.streamAssetPath.clear();
 
-		ALBufferWrapper bufferData;
+		const std::string& path = emitter.userData.sfxAssetPath;
+		AssetSystem& assetSystem = GameBase::get().getAssetSystem();
 
-		auto findResult = audioBuffers.find(path);
-		if (findResult == audioBuffers.end())
+		if (!emitter.hardwareData.sourceIdx.has_value())
 		{
-			//sync load
-			bufferData = GameBase::get().getAssetSystem().loadOpenAlBuffer(path);
-			audioBuffers.insert({ path, bufferData });
+			//sync decode only; the buffer is created when the emitter is given a source, so software mixed sounds never get one
+			AssetHandle<SoundRawData> soundData = assetSystem.loadSound(path);
+			const SoundRawData* sound = soundData.getAsset();
+			emitter.hardwareData.bufferIdx.reset();
+			emitter.systemMetaData.audioDurationSec = sound ? sound->durationSec : 0.f;
 		}
 		else
 		{
-			bufferData = findResult->second;
-		}
+			//pinned while it is attached to the source, as OpenAL can't delete a buffer a source is using
+			SoundBufferPin bufferPin = assetSystem.pinSound(path, /*bWithBuffer*/true);
+			emitter.hardwareData.bufferIdx = bufferPin.getBuffer();
+			emitter.systemMetaData.audioDurationSec = bufferPin ? bufferPin.getSound()->durationSec : 0.f;
 
-		emitter.hardwareData.bufferIdx = bufferData.buffer;
-		emitter.systemMetaData.audioDurationSec = bufferData.durationSec;
-
-		if (emitter.hardwareData.sourceIdx.has_value() && emitter.hardwareData.bufferIdx.has_value())
-		{
 #define DIAGNOSTIC_SOURCE_BUFFER_SETTING 1
 #if DIAGNOSTIC_SOURCE_BUFFER_SETTING & VERBOSE_AUDIO_RESOURCE_LOGGING 
 			ALuint source = *emitter.hardwareData.sourceIdx;
@@ -275,11 +302,60 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 			// not sure if changing sound on an emitter will be an active use case though as it will require probably tweaking all emitter properties
 			// so for now just setting source's value directly
 			alec(alSourcei(*emitter.hardwareData.sourceIdx, AL_BUFFER, *emitter.hardwareData.bufferIdx)); //#audiothreads update to listener should happen in dedicated audio thread processing
+
+			//the previous sound is unpinned only now that its buffer is off the source
+			emitter.hardwareData.bufferPin = std::move(bufferPin);
 		}
 
 #endif //USE_OPENAL_API
 	}
 
+	void AudioSystem::trySetEmitterStream(AudioEmitter& emitter)
+	{
+#if USE_OPENAL_API
+		EmitterHardwareData& hardwareData = emitter.hardwareData;
+		const std::string& path = emitter.userData.sfxAssetPath;
+		hardwareData.bufferIdx.reset();
+
+		if (!hardwareData.stream || hardwareData.streamAssetPath != path)
+		{
+			hardwareData.stream = nullptr;
+			hardwareData.streamAssetPath = path;
+			if (streamBackend && streamDecodePool && hasValidOpenALDevice())
+			{
+				//only the header is read here; the sound is decoded on the stream decode thread as it plays
+				if (up<AudioStreamDecoder> decoder = GameBase::get().getAssetSystem().openSoundStream(path))
+				{
+					AudioStreamConfig config;
+					config.bLooping = emitter.userData.bLooping;
+					hardwareData.stream = new_sp<AudioStream>(std::move(decoder), *streamBackend, *streamDecodePool, config);
+					hardwareData.stream->prefetch();
+				}
+			}
+		}
+
+		if (hardwareData.stream)
+		{
+			emitter.systemMetaData.audioDurationSec = hardwareData.stream->getDurationSec();
+			if (hardwareData.sourceIdx.has_value() && !hardwareData.stream->isAttached())
+			{
+				//the stream plays the source itself once it has chunks queued
+				hardwareData.stream->attach(*hardwareData.sourceIdx);
+			}
+		}
+
+		//the stream replaces the buffer (attaching clears the source's buffer), so it no longer needs to be kept loaded
+		if (hardwareData.bufferPin)
+		{
+			if (hardwareData.sourceIdx.has_value() && !(hardwareData.stream && hardwareData.stream->isAttached()))
+			{
+				alec(alSourcei(*hardwareData.sourceIdx, AL_BUFFER, 0));
+			}
+			hardwareData.bufferPin.release();
+		}
+#endif //USE_OPENAL_API
+	}
+
 	void AudioSystem::stopEmitter(AudioEmitter& emitter, const EmitterPrivateKey&)
 	{
 #if USE_OPENAL_API
@@ -290,12 +366,19 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 
 			//if user requested stop, then stop immediately; don't let system fade it out
 			alec(alSourceStop(source));
+			if (emitter.hardwareData.stream)
+			{
+				emitter.hardwareData.stream->detach();
+			}
+			alec(alSourcei(source, AL_BUFFER, 0));
+			emitter.hardwareData.bufferPin.release(); //buffer is off the source, so the sound may be evicted again
 
 			//if we stopped this source, then clear the resource so it will have to be given a new source to play again
 			sourcePool.releaseInstance(source);
 			CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("releaseing source %d to free pool from emitter %p", source, &emitter);
 			emitter.hardwareData.sourceIdx = std::nullopt;
 		}
+		releaseSoftwareVoice(emitter);
 #endif //USE_OPENAL_API
 	}
 
@@ -356,22 +439,41 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		// Stats
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		logf_sa(__FUNCTION__, LogLevel::LOG, "STATS: UserActiveList[%d] TotalEmitters[%d] TotalSources[%d], TotalPlayingSound[%d]", list_userActivatedSounds.size(), allEmitters.size(), generatedSources.size(), numSourcesPlaying);
+		logf_sa(__FUNCTION__, LogLevel::LOG, "STATS: SoftwareMixedEmitters[%d] SoftwareVoices[%d]", list_softwareMixed.size(), softwareMixer ? softwareMixer->getNumVoices() : size_t(0));
 #else
 		AUDIO_API_NEEDS_DEBUG_IMPLEMENTATION;
 #endif 
 	}
 
+	void AudioSystem::tick(float deltaSec)
+	{
+		//the pipeline runs on world time; levels are only changed by the level system's tick, which this waits on
+		if (const sp<LevelBase>& currentLevel = GameBase::get().getLevelSystem().getCurrentLevel())
+		{
+			tickAudioPipeline(currentLevel->getWorldTimeManager()->getDeltaTimeSecs());
+		}
+	}
+
+	void AudioSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		//emitters are played and stopped from the main thread during entity ticks and gameplay events, all of which write "audio"
+		outDependencies.bThreadSafeTick = true;
+		outDependencies.reads = { "level" };
+		outDependencies.writes = { "audio", "assets", "debug_render" }; //pins sounds in the asset system's cache; may draw emitter locations
+	}
+
 	void AudioSystem::tickAudioPipeline(float dt_sec)
 	{
 		//trying out a pipelined approach to writing this function; primary goal is to communicate the highlevel via code not comments
 		audioTick_beginPipeline();
 		audioTick_updateListenerStates();
 		audioTick_updateActiveUserEmitterStates(dt_sec);
-		audioTick_sortActivatedEmitters();				
+		audioTick_selectAudibleEmitters();				
 		audioTick_cullEmitters();							
 		audioTick_releaseHardwareResources();						
 		audioTick_assignHardwareResources();						
 		audioTick_updateEmittersWithHardwareResources();
+		audioTick_mixSoftwareVoices();
 		audioTick_emitterGarbageCollection();
 		audioTick_endPipeline();
 	}
@@ -462,7 +564,8 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 			}
 			if (md.dirtyFlags.bLooping) 
 			{ 
-				alec(alSourcei(src, AL_LOOPING, ALint(ud.bLooping)));
+				//streams loop by decoding the start of the sound again; a looping source would replay its queue instead
+				alec(alSourcei(src, AL_LOOPING, ALint(ud.bLooping && !emitterSource.hardwareData.stream)));
 				md.dirtyFlags.bLooping = false; 
 			}
 			if (md.dirtyFlags.bReferenceDistance)
@@ -502,7 +605,6 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 
 	void AudioSystem::initSystem()
 	{
-		//have audio system register its tick to be after the camera
 		LevelSystem& levelSystem = GameBase::get().getLevelSystem();
 		levelSystem.onPreLevelChange.addWeakObj(sp_this(), &AudioSystem::handlePreLevelChange);
 		if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
@@ -551,6 +653,9 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		}
 		OpenAL_ErrorCheck("Make context current"); //NOTE: we shouldn't error check until we have a nonnull context
 
+		streamBackend = new_sp<OpenALStreamBackend>();
+		streamDecodePool = new_sp<AssetWorkerPool>(2); //software submixes are rendered here too, so keep one thread free of file decoding
+
 		//query device data
 		ALCint numAttributes;
 		alec(alcGetIntegerv(device, ALC_ATTRIBUTES_SIZE, 1, &numAttributes));
@@ -588,6 +693,46 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 					log(__FUNCTION__, LogLevel::LOG_ERROR, "cannot read max stereo sources attribute value as value index is invalid"); STOP_DEBUGGER_HERE();
 				}
 			}
+			else if (attribute == ALC_FREQUENCY)
+			{
+				if (Utils::isValidIndex(contextAttributes, valueIdx) && contextAttributes[valueIdx] > 0)
+				{
+					api_OutputSampleRate = static_cast<unsigned int>(contextAttributes[valueIdx]);
+				}
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Software mixing: emitters that miss out on a source are mixed into a few stereo streams, each played on its own source.
+		// Those sources come out of the stereo source budget, so the mono sources handed to emitters are unchanged.
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		const size_t numSubmixes = glm::min(api_MaxStereoSources, maxSoftwareSubmixes);
+		if (numSubmixes > 0)
+		{
+			softwareMixer = new_sp<SoftwareMixer>(api_OutputSampleRate, numSubmixes);
+			for (size_t submixIdx = 0; submixIdx < numSubmixes; ++submixIdx)
+			{
+				ALuint source = 0;
+				alec(alGenSources(1, &source));
+				if (!source)
+				{
+					log(__FUNCTION__, LogLevel::LOG_ERROR, "failed to create a source for a software submix"); STOP_DEBUGGER_HERE();
+					continue;
+				}
+				//the mixer has already panned and attenuated everything, so the submix plays at the listener unaltered
+				alec(alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE));
+				alec(alSource3f(source, AL_POSITION, 0.f, 0.f, 0.f));
+
+				//short chunks, since parameter changes are only heard once the chunks rendered before them have played
+				AudioStreamConfig submixConfig;
+				submixConfig.framesPerChunk = 1024;
+				submixConfig.numBuffers = 3;
+				sp<AudioStream> submixStream = new_sp<AudioStream>(new_up<SubmixStreamDecoder>(softwareMixer, submixIdx), *streamBackend, *streamDecodePool, submixConfig);
+				submixStream->attach(source);
+
+				submixSources.push_back(source);
+				submixStreams.push_back(submixStream);
+			}
 		}
 #endif //USE_OPENAL_API
 #endif //ENABLE_AUDIO
@@ -609,11 +754,33 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		logf_sa(__FUNCTION__, LogLevel::LOG, "begin cleaning up openal sources");
 		for (sp<AudioEmitter>& emitter : allEmitters)
 		{
+			if (emitter && emitter->hardwareData.stream)
+			{
+				//stream buffers must be deleted while the context is alive, and after they're unqueued from the source
+				emitter->hardwareData.stream->detach();
+				emitter->hardwareData.stream = nullptr;
+			}
 			if (emitter && emitter->hardwareData.sourceIdx.has_value())
 			{
 				teardownALSource(*emitter->hardwareData.sourceIdx);
 			}
+			if (emitter)
+			{
+				emitter->hardwareData.bufferPin.release();
+			}
+		}
+		for (size_t submixIdx = 0; submixIdx < submixStreams.size(); ++submixIdx)
+		{
+			submixStreams[submixIdx]->detach();
+			alec(alDeleteSources(1, &submixSources[submixIdx]));
 		}
+		submixStreams.clear();
+		submixSources.clear();
+		if (streamDecodePool)
+		{
+			streamDecodePool->stop();
+		}
+		softwareMixer = nullptr;
 
 		//drain the pool of sources that can be claimed
 		while (std::optional<ALuint> optionalSource= sourcePool.getInstance())
@@ -665,6 +832,7 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		const std::vector<sp<PlayerBase>>& allPlayers = GameBase::get().getPlayerSystem().getAllPlayers();
 		listenerData.clear();
+		listenerPositions.clear();
 
 		for (const sp<PlayerBase>& player : allPlayers)
 		{
@@ -679,6 +847,7 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 				listener.rotation = camera->getQuat();
 				listener.inverseRotation = glm::inverse(listener.rotation);
 				listenerData.push_back(listener);
+				listenerPositions.push_back(listener.position);
 			}
 		}
 
@@ -714,6 +883,9 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		}
 		set_pendingUserActivation.clear();
 
+		emitterSelector.clear();
+		selectorEmitters.clear();
+
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		//walk the list backwards so we can do swap-and-pop on deactivated sounds
 		//starting from the back means that we can count on the last elements already having their state recalculated
@@ -742,17 +914,36 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 #if USE_OPENAL_API
 					if (emitter->hardwareData.sourceIdx.has_value())
 					{
-						ALuint source = *emitter->hardwareData.sourceIdx;
-						ALint sourceState = 0;
-						alec(alGetSourcei(source, AL_SOURCE_STATE, &sourceState));
+						bool bPlaying = false;
+						if (const sp<AudioStream>& stream = emitter->hardwareData.stream)
+						{
+							//a stream's source stops whenever decoding falls behind; the stream is only over once its last chunk has played
+							bPlaying = !stream->isFinished();
+						}
+						else
+						{
+							ALuint source = *emitter->hardwareData.sourceIdx;
+							ALint sourceState = 0;
+							alec(alGetSourcei(source, AL_SOURCE_STATE, &sourceState));
+							bPlaying = sourceState == AL_PLAYING;
+						}
 
 						//this is assuming that when something is given a hardware source, then it will be played immediately
-						if (sourceState != AL_PLAYING)
+						if (!bPlaying)
 						{
 							CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("detected emitter is no longer playing, flagging for deactivation %p %s", emitter.get(), emitter->userData.sfxAssetPath.c_str());
 							emitter->systemMetaData.bActive = false;
 						}
 					}
+					else if (emitter->hardwareData.softwareVoice.has_value())
+					{
+						//mixed on the cpu; a one shot is over once the mixer has played it through
+						if (emitter->isOneShotSample() && softwareMixer->isVoiceFinished(*emitter->hardwareData.softwareVoice))
+						{
+							CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("detected software voice is no longer playing, flagging for deactivation %p %s", emitter.get(), emitter->userData.sfxAssetPath.c_str());
+							emitter->systemMetaData.bActive = false;
+						}
+					}
 					else  //if it doesn't have hardware resource yet, has it been too long to give it one?
 					{
 						if (emitter->isOneShotSample() || emitter->userData.tryPlayWindowSeconds.has_value())
@@ -778,55 +969,11 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 #endif
 
 					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-					// Prioritize this sound so that it can be culled if resources are required for higher priority sounds
+					// Gather what prioritization needs into the selector; sounds deactivated above are still gathered so they release their sources
 					////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-					//calculate new priority; start a 0 and add to priority
-					soundMetaData.calculatedPriority = 0;
-
-					ListenerData* closestListener = nullptr;
-					float closestDist2 = std::numeric_limits<float>::infinity();
-					size_t closestListenerIdx = 0;
-					for (size_t listernIdx = 0; listernIdx < listenerData.size(); ++listernIdx)
-					{
-						ListenerData& listenerDatum = listenerData[listernIdx];
-						float length2 = glm::length2(listenerDatum.position - soundUserData.position);
-						if (length2 < closestDist2)
-						{
-							closestListener = &listenerDatum;
-							closestDist2 = length2;
-							closestListenerIdx = listernIdx;
-						}
-					}
-
-					//0.X000 <-takes this position on priority assignment. 
-					float proximityValue = 0.f;
-					bool bOutOfRange = true;
-
-					//did we find any close listener? (basically always true unless we don't have a player)
-					if (closestListener)
-					{
-						const float radiusSquared = Utils::square(soundUserData.maxRadius);
-						soundMetaData.closestListenerIdx = closestListenerIdx;
-						if (closestDist2 < radiusSquared)
-						{
-							bOutOfRange = false;
-							float distance = glm::length(soundUserData.position - closestListener->position);
-							float distanceAlpha = 1.0f - glm::clamp(distance / soundUserData.maxRadius, 0.f, 1.f); 
-
-							//may need to rethink this a bit, perhaps multiplying things by 10,100,1000 based on priority level.
-							soundMetaData.calculatedPriority += distanceAlpha; //[0,1] range already is in the tenths position
-							soundMetaData.bOutOfRange = false;
-						}
-						else
-						{
-							//change the distance max distance when trying to drop sounds so that sounds on border of radius do not flicker in/out
-							soundMetaData.bOutOfRange = closestDist2 * 1.01 < radiusSquared;
-							soundMetaData.calculatedPriority += 1.f; //max distance alpha
-						}
-					}
-					
-					soundMetaData.calculatedPriority += float(soundUserData.priority);
+					selectorEmitters.push_back(emitter.get());
+					emitterSelector.add(soundUserData.position, soundUserData.maxRadius, float(soundUserData.priority),
+						emitter->hardwareData.sourceIdx.has_value(), soundMetaData.bActive);
 				}
 				else
 				{
@@ -842,27 +989,14 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 
 	}
 
-	void AudioSystem::audioTick_sortActivatedEmitters()
+	void AudioSystem::audioTick_selectAudibleEmitters()
 	{
-		std::sort(
-			list_userActivatedSounds.begin(),
-			list_userActivatedSounds.end(),
-			[](const AudioEmitterHandle& first, const AudioEmitterHandle& second)
-			{
-				//shouldn't hit nullptrs, but adding to reduce code fragility
-				if(!second)
-				{
-					return true; //put second nullptr after
-				}
-				if (!first) 
-				{
-					return false;//put second before first (second is not nullptr)
-				}
-
-				//see if first is less than last.
-				return first->systemMetaData.calculatedPriority < second->systemMetaData.calculatedPriority;
-			}
-		);
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Only the best api_MaxMonoSources can play, so only they are sorted; see AudioEmitterSelector
+		// The runners up within the software voice budget are mixed on the cpu instead of going silent.
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		emitterSelector.score(listenerPositions);
+		emitterSelector.select(api_MaxMonoSources, softwareMixer ? softwareVoiceBudget : 0);
 	}
 
 	void AudioSystem::audioTick_cullEmitters()
@@ -871,56 +1005,52 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		// Changes to state should be done before this step in pipeline, emitters should be just moved to appropriate lists
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-		size_t availableSources = api_MaxMonoSources;
-
 		list_hardwarePermitted.clear();
 		list_pendingRemoveHardwareSource.clear();
 		list_pendingAssignHardwareSource.clear(); 
 
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// Walk over user list. 
+		// Emitters that won a source; these are the only emitters that get their full state updated
 		// NOTE: this is not applied to all emitters, it is just the user activated list.
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		for (size_t idx = 0; idx < list_userActivatedSounds.size(); ++idx)
+		for (uint32_t selectorIdx : emitterSelector.getSelected())
 		{
-			const AudioEmitterHandle& sound = list_userActivatedSounds[idx];
+			AudioEmitter* sound = selectorEmitters[selectorIdx];
+			EmitterAudioSystemMetaData& soundMetaData = sound->systemMetaData;
 
-			if (sound)
+			//always reset fade state to fade up; we will fade out if needed. But this restores things that may haev filpped from a fade out to a fadein
+			soundMetaData.fadeDirection = 1.f;
+			soundMetaData.calculatedPriority = emitterSelector.getPriority(selectorIdx);
+			soundMetaData.closestListenerIdx = emitterSelector.getClosestListener(selectorIdx); //used to remap position for split screen listeners
+			soundMetaData.bOutOfRange = false;
+
+			// if this doesn't have a hardware source, then give it one
+			if (!sound->hardwareData.sourceIdx.has_value())
 			{
-				//always reset fade state to fade up; we will fade out if needed. But this restores things that may haev filpped from a fade out to a fadein
-				sound->systemMetaData.fadeDirection = 1.f;
-
-				//use ordering of priority to determine if a sound should be given/keep hardware resources
-				bool bSoundShouldPlay = //ie don't cull
-					idx < availableSources 
-					&& !sound->systemMetaData.bOutOfRange 
-					&& sound->systemMetaData.bActive;
-				if (bSoundShouldPlay)
-				{
-					// if this doesn't have a hardware source, then give it one
-					if (!sound->hardwareData.sourceIdx.has_value())
-					{
-						list_pendingAssignHardwareSource.push_back(sound.get());
-						CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("sound requesting hardware resource %p", sound.get());
-					}
-					else
-					{
-						//since this has hardware resources, add it to the list that will have their sources updated
-						list_hardwarePermitted.push_back(sound.get());
-						CONDITIONAL_VERYVERBOSE_RESOURCE_LOG_MESSAGE("sound with resource adding to hardware list %p", sound.get());
-					}
-				}
-				else // cull this sound
-				{
-					//if this sound has a hardware source, then we need to take it away and give it to a higher priority sound
-					if (sound->hardwareData.sourceIdx.has_value())
-					{
-						list_pendingRemoveHardwareSource.push_back(sound.get());
-						CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("culling sound with hardware resource %p", sound.get());
-					}
-				}
+				list_pendingAssignHardwareSource.push_back(sound);
+				CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("sound requesting hardware resource %p", sound);
+			}
+			else
+			{
+				//since this has hardware resources, add it to the list that will have their sources updated
+				list_hardwarePermitted.push_back(sound);
+				CONDITIONAL_VERYVERBOSE_RESOURCE_LOG_MESSAGE("sound with resource adding to hardware list %p", sound);
 			}
 		}
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Cull emitters that hold a source but lost it to a higher priority sound, went out of range, or were deactivated
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		for (uint32_t selectorIdx : emitterSelector.getEvicted())
+		{
+			AudioEmitter* sound = selectorEmitters[selectorIdx];
+			sound->systemMetaData.fadeDirection = 1.f;
+			sound->systemMetaData.calculatedPriority = emitterSelector.getPriority(selectorIdx);
+			sound->systemMetaData.bOutOfRange = !emitterSelector.isInRange(selectorIdx);
+
+			list_pendingRemoveHardwareSource.push_back(sound);
+			CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("culling sound with hardware resource %p", sound);
+		}
 	}
 
 	void AudioSystem::audioTick_releaseHardwareResources()
@@ -999,10 +1129,25 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 
 						trySetEmitterBuffer(*emitter, EmitterPrivateKey{});
 
+						//a sound that was being mixed in software carries on from the same place on its source
+						if (emitter->hardwareData.softwareVoice.has_value())
+						{
+							const size_t voiceFrame = softwareMixer->getVoiceFrame(*emitter->hardwareData.softwareVoice);
+							releaseSoftwareVoice(*emitter);
+							if (!emitter->hardwareData.stream)
+							{
+								alec(alSourcei(source, AL_SAMPLE_OFFSET, ALint(voiceFrame)));
+							}
+						}
+						emitter->systemMetaData.resumeFrame = 0;
+
 						//set all flags to dirty by writing 0xff to every byte
 						std::memset(reinterpret_cast<uint8_t*>(&emitter->systemMetaData.dirtyFlags), 0xFF, sizeof(decltype(emitter->systemMetaData.dirtyFlags)));
 
-						alec(alSourcePlay(source));
+						if (!emitter->hardwareData.stream)
+						{
+							alec(alSourcePlay(source));
+						}
 
 						//this now has a hardware resource, add it to list of sources we will update at the end of the pipeline
 						list_hardwarePermitted.push_back(emitter);
@@ -1029,6 +1174,10 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 			if (emitterSource)
 			{
 #if USE_OPENAL_API
+				if (emitterSource->hardwareData.stream)
+				{
+					emitterSource->hardwareData.stream->service();
+				}
 				updateSourceProperties(*emitterSource);
 			}
 #else
@@ -1037,6 +1186,128 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		}
 	}
 
+	void AudioSystem::audioTick_mixSoftwareVoices()
+	{
+#if USE_OPENAL_API
+		if (!softwareMixer)
+		{
+			return;
+		}
+		++audioTickCount;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Mixed this tick: the runners up for a source, and winners that did not get one because sources are still fading out
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		mixCandidates.clear();
+		for (uint32_t selectorIdx : emitterSelector.getSoftwareMixed())
+		{
+			AudioEmitter* emitter = selectorEmitters[selectorIdx];
+			emitter->systemMetaData.calculatedPriority = emitterSelector.getPriority(selectorIdx);
+			emitter->systemMetaData.closestListenerIdx = emitterSelector.getClosestListener(selectorIdx);
+			mixCandidates.push_back(emitter);
+		}
+		for (AudioEmitter* emitter : list_pendingAssignHardwareSource)
+		{
+			if (!emitter->hardwareData.sourceIdx.has_value())
+			{
+				mixCandidates.push_back(emitter);
+			}
+		}
+		for (AudioEmitter* emitter : mixCandidates)
+		{
+			emitter->systemMetaData.softwareMixedTick = audioTickCount;
+		}
+
+		//emitters mixed last tick that were not picked this tick; the mixer fades them out
+		for (const AudioEmitterHandle& emitter : list_softwareMixed)
+		{
+			if (emitter && emitter->systemMetaData.softwareMixedTick != audioTickCount)
+			{
+				releaseSoftwareVoice(*emitter);
+			}
+		}
+		list_softwareMixed.clear();
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Start or update a voice for each one
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		for (AudioEmitter* emitter : mixCandidates)
+		{
+			const EmitterUserData& ud = emitter->userData;
+			EmitterAudioSystemMetaData& md = emitter->systemMetaData;
+
+			//emitters still holding a source are fading out on it; streams are never fully decoded, so they can't be mixed
+			if (emitter->hardwareData.sourceIdx.has_value() || emitter->hardwareData.stream)
+			{
+				releaseSoftwareVoice(*emitter);
+				continue;
+			}
+
+			//split screen listeners each hear the emitter from their own view, so there is no need to remap like hardware sources
+			glm::vec3 listenerPosition = ud.position;
+			glm::vec3 listenerRight_n = glm::vec3(1.f, 0.f, 0.f);
+			if (Utils::isValidIndex(listenerData, md.closestListenerIdx))
+			{
+				const ListenerData& listener = listenerData[md.closestListenerIdx];
+				listenerPosition = listener.position;
+				listenerRight_n = glm::normalize(glm::cross(listener.front_n, listener.up_n));
+			}
+			const float gain = glm::clamp(calculateGain(ud.volume, ud.bIsMusic), 0.f, 1.f);
+			const SoftwareVoiceGains gains = SoftwareMixer::calculateSpatialGains(ud.position, listenerPosition, listenerRight_n, md.referenceDistance, gain);
+
+			if (emitter->hardwareData.softwareVoice.has_value())
+			{
+				softwareMixer->setVoiceParameters(*emitter->hardwareData.softwareVoice, gains, calculatePitch(ud.pitch + md.calculatedPitchVariation));
+			}
+			else
+			{
+				//pinned so the cache keeps it while it may be promoted back to a source; usually a hit, as the emitter loaded it when it started
+				if (!emitter->hardwareData.bufferPin)
+				{
+					emitter->hardwareData.bufferPin = GameBase::get().getAssetSystem().pinSound(ud.sfxAssetPath, /*bWithBuffer*/false);
+				}
+				if (!emitter->hardwareData.bufferPin)
+				{
+					continue;
+				}
+				if (ud.pitchVariationRange != 0.f && md.resumeFrame == 0)
+				{
+					float halfRange = ud.pitchVariationRange / 2.f;
+					md.calculatedPitchVariation = pitchVariabilityRNG->getFloat(-halfRange, halfRange);
+				}
+				emitter->hardwareData.softwareVoice = softwareMixer->addVoice(emitter->hardwareData.bufferPin.getSound(), ud.bLooping, md.resumeFrame, gains, calculatePitch(ud.pitch + md.calculatedPitchVariation));
+				CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("software mixing emitter %p from frame %d", emitter, md.resumeFrame);
+			}
+			list_softwareMixed.push_back(emitter->requestTypedReference_Nonsafe<AudioEmitter>().lock());
+		}
+
+		for (const sp<AudioStream>& submixStream : submixStreams)
+		{
+			submixStream->service();
+		}
+#endif //USE_OPENAL_API
+	}
+
+	void AudioSystem::releaseSoftwareVoice(AudioEmitter& emitter)
+	{
+#if USE_OPENAL_API
+		if (emitter.hardwareData.softwareVoice.has_value())
+		{
+			if (softwareMixer)
+			{
+				softwareMixer->removeVoice(*emitter.hardwareData.softwareVoice);
+			}
+			emitter.hardwareData.softwareVoice.reset();
+
+			//the voice keeps the pcm alive while it fades; a source's buffer stays pinned until the source is released
+			if (!emitter.hardwareData.sourceIdx.has_value())
+			{
+				emitter.hardwareData.bufferPin.release();
+			}
+		}
+#endif //USE_OPENAL_API
+	}
+
 	void AudioSystem::audioTick_emitterGarbageCollection()
 	{
 		//amortized walk over allEmitters to find use_count of 1, this means no one has a reference to the sound anymore and we should clean it up and delete it.
@@ -1066,6 +1337,10 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 				{
 					gcIndices.push_back(idx);
 
+					if (emitter->hardwareData.stream)
+					{
+						emitter->hardwareData.stream->detach();
+					}
 					if (emitter->hardwareData.sourceIdx.has_value())
 					{
 						ALuint source = *emitter->hardwareData.sourceIdx;
@@ -1073,6 +1348,9 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 					}
 					emitter->hardwareData.sourceIdx.reset();
 					emitter->hardwareData.bufferIdx.reset();
+					emitter->hardwareData.stream = nullptr;
+					releaseSoftwareVoice(*emitter);
+					emitter->hardwareData.bufferPin.release();
 				}
 			}
 		}
@@ -1130,6 +1408,13 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 				{
 					removeHardwareResources(*emitter);
 				}
+
+				//streams start over from the beginning the next time the emitter plays
+				emitter->hardwareData.stream = nullptr;
+				emitter->hardwareData.streamAssetPath.clear();
+
+				releaseSoftwareVoice(*emitter);
+				emitter->systemMetaData.resumeFrame = 0;
 			}
 			
 			Utils::swapAndPopback(list_userActivatedSounds, idx);
@@ -1152,9 +1437,27 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 			CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("releaseing source %d to free pool from emitter %p", source, &emitter);
 			sourcePool.releaseInstance(source);
 
+			//if the sound is handed to the software mixer, it picks up where the source was
+			ALint sampleOffset = 0;
+			if (!emitter.hardwareData.stream)
+			{
+				alec(alGetSourcei(source, AL_SAMPLE_OFFSET, &sampleOffset));
+			}
+			emitter.systemMetaData.resumeFrame = size_t(glm::max(sampleOffset, 0));
+
 			//make sure the source is no longer player, when this is pulled from the pool it will be played if necessary
 			alec(alSourceStop(source));
 
+			//a culled stream keeps decoding where it left off; it is queued on its next source
+			if (emitter.hardwareData.stream)
+			{
+				emitter.hardwareData.stream->detach();
+			}
+
+			//once off the source the buffer may be evicted; a software voice pins the sound again if it picks this up
+			alec(alSourcei(source, AL_BUFFER, 0));
+			emitter.hardwareData.bufferPin.release();
+
 #if AUDIO_TRACK_SOURCES
 			ALSourceData sourceData;
 			sourceData.source = source;
@@ -1170,21 +1473,11 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 
 	void AudioSystem::handlePreLevelChange(const sp<LevelBase>& currentLevel, const sp<LevelBase>& newLevel)
 	{
-		if (currentLevel)
-		{
-			currentLevel->getWorldTimeManager()->getEvent(TickGroups::get().AUDIO).removeWeak(sp_this(), &AudioSystem::tickAudioPipeline);
-		}
-
 		for(const sp<AudioEmitter>& emitter : allEmitters)
 		{
 			//stop all emitters for level transition
 			emitter->stop();
 		}
-
-		if (newLevel)
-		{
-			newLevel->getWorldTimeManager()->getEvent(TickGroups::get().AUDIO).addWeakObj(sp_this(), &AudioSystem::tickAudioPipeline);
-		}
 	}
 
 }
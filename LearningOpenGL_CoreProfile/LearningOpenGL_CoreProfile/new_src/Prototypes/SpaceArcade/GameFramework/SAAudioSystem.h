@@ -17,6 +17,9 @@
 #include "../Tools/Algorithms/AmortizeLoopTool.h"
 #include "../Tools/DataStructures/ObjectPools.h"
 #include "Audio/ALBufferWrapper.h"
+#include "Audio/AudioEmitterSelector.h"
+#include "Audio/SoftwareMixer.h"
+#include "AssetManagement/SoundBufferCache.h"
 
 #define COMPILE_AUDIO 1
 #define COMPILE_AUDIO_DEBUG_RENDERING_CODE 1
@@ -24,6 +27,9 @@
 namespace SA
 {
 	class LevelBase;
+	class AudioStream;
+	class AudioStreamBackend;
+	class AssetWorkerPool;
 
 
 	enum class AudioEmitterPriority : uint8_t
@@ -49,6 +55,7 @@ namespace SA
 		std::optional<float> tryPlayWindowSeconds = std::nullopt; //if audio can't play because of hardware contention, this is amount of time before it gives up because sound wouldn't make sense to play
 		bool bLooping = false;
 		bool bIsMusic = false;
+		bool bStreaming = false; //decode while playing rather than up front; for music and long ambient loops
 	};
 
 	/** These are really API resources, but can be limited by hardware. So code refers to them as hardware resources
@@ -59,6 +66,10 @@ namespace SA
 		std::optional<ALuint> bufferIdx;
 		std::optional<ALuint> sourceIdx;
 #endif
+		sp<AudioStream> stream;				//replaces the buffer for streaming emitters
+		std::string streamAssetPath;
+		std::optional<SoftwareVoiceHandle> softwareVoice; //mixed on the cpu while the emitter has no source
+		SoundBufferPin bufferPin;			//held while the buffer is on the source or the pcm is being mixed, so the sound cache can't evict it
 	};
 
 	struct EmitterAudioSystemMetaData
@@ -69,6 +80,8 @@ namespace SA
 		float fadeRateSecs = 0.25f;
 		float referenceDistance = 1.f;
 		float calculatedPitchVariation = 0.f;
+		size_t resumeFrame = 0; //where the emitter's source was when it was culled, so a software voice carries on from there
+		uint64_t softwareMixedTick = 0; //last audio tick this was picked for software mixing
 		std::optional<float> playStartTimeStamp = std::nullopt;
 		std::optional<float> audioDurationSec = std::nullopt; //optional because have to load to find this information
 		bool bActive = false;
@@ -113,6 +126,7 @@ namespace SA
 		void setPitch(float newPitch);
 		void setGain(float gain);
 		void setVolume(float gain);
+		void setStreaming(bool bStreaming); //set before setSoundAssetPath to avoid loading the whole sound
 		bool isOneShotSample() const { return !userData.bLooping; }
 	private:
 		EmitterUserData userData = {};
@@ -183,6 +197,9 @@ namespace SA
 	private:
 		size_t api_MaxMonoSources = 16;		//this value is updated by the audio api
 		size_t api_MaxStereoSources = 16;	//this value is updated by the audio api
+		unsigned int api_OutputSampleRate = 44100; //this value is updated by the audio api
+		size_t softwareVoiceBudget = 128;	//emitters beyond the source limit that are still mixed on the cpu
+		static constexpr size_t maxSoftwareSubmixes = 2;
 	public:
 		sp<AudioEmitter> createEmitter();
 		void activateEmitter(const sp<AudioEmitter>& emitter, bool bNewActivation);
@@ -207,23 +224,28 @@ namespace SA
 	private:	
 		virtual void initSystem() override;
 		virtual void shutdown() override;
+		virtual void tick(float deltaSec) override;
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 	public:
 		void tickAudioPipeline(float dt_sec);
 	private:
 		void audioTick_beginPipeline();
 		void audioTick_updateListenerStates();
 		void audioTick_updateActiveUserEmitterStates(float dt_sec);
-		void audioTick_sortActivatedEmitters();
+		void audioTick_selectAudibleEmitters();
 		void audioTick_cullEmitters();
 		void audioTick_releaseHardwareResources();
 		void audioTick_assignHardwareResources();
 		void audioTick_updateEmittersWithHardwareResources();
+		void audioTick_mixSoftwareVoices();
 		void audioTick_emitterGarbageCollection();
 		void audioTick_endPipeline();
 	private:
 		void addToUserActiveList(const sp<AudioEmitter>& emitter);
 		void removeFromActiveList(size_t idx);
 		void removeHardwareResources(AudioEmitter& emitter);
+		void trySetEmitterStream(AudioEmitter& emitter);
+		void releaseSoftwareVoice(AudioEmitter& emitter);
 	private:
 		void handlePreLevelChange(const sp<LevelBase>& currentLevel, const sp<LevelBase>& newLevel);
 	private:
@@ -244,14 +266,24 @@ namespace SA
 		std::vector<AudioEmitter*> list_pendingRemoveHardwareSource;
 		std::vector<sp<AudioEmitter>> allEmitters;					
 		std::vector<ListenerData> listenerData;
+		std::vector<glm::vec3> listenerPositions;
+		AudioEmitterSelector emitterSelector;
+		std::vector<AudioEmitter*> selectorEmitters;					//parallel to the emitter selector's arrays
+		std::vector<AudioEmitterHandle> list_softwareMixed;				//emitters given to the software mixer last tick
+		std::vector<AudioEmitter*> mixCandidates;
+		uint64_t audioTickCount = 0;
 		AmortizeLoopTool amortizeGarbageCollectionCheck;
 		std::vector<size_t> gcIndices;
 #if USE_OPENAL_API
 		ALCdevice* device = nullptr;
 		ALCcontext* context = nullptr; //for now, split screen will share context, and manual source fixup required; perahps multiple contexts
-		std::unordered_map</*filePath*/std::string, ALBufferWrapper> audioBuffers; 
 		std::set<ALSourceData> generatedSources;
 		PrimitivePool<ALuint> sourcePool;
+		sp<AudioStreamBackend> streamBackend;
+		sp<AssetWorkerPool> streamDecodePool;
+		sp<SoftwareMixer> softwareMixer;
+		std::vector<sp<AudioStream>> submixStreams;
+		std::vector<ALuint> submixSources;
 #endif //USE_OPENAL_API
 		sp<class RNG> pitchVariabilityRNG = nullptr;
 		float cachedTimeDilation = 1.f;
@@ -8,6 +8,7 @@
 #include "SALevel.h"
 #include <map>
 #include "SARandomNumberGenerationSystem.h"
+#include "TimeManagement/TimerWheel.h"
 
 
 
@@ -26,6 +27,8 @@ namespace SA
 		{
 			memory = new_sp<Memory>();
 			this->assignedMemory = this->memory.get(); //make sure that if this is accessed as a node, it returns correct memory.
+
+			//initial memory takes the first slots; nodes intern the rest of their keys as the tree is established below
 			for (const auto& kv_pair : initializedMemory)
 			{
 				memory->replaceValue(kv_pair.first, kv_pair.second);
@@ -116,6 +119,7 @@ namespace SA
 		void Tree::tick(float delta_sec)
 		{
 			frame_dt_sec = delta_sec;
+			++tickNumber;
 			/*
 			Design considerations:
 				-only a single tree walk should be permitted per tick; otherwise a tree can get into an inifite loop.
@@ -511,18 +515,25 @@ namespace SA
 		void Service::resetNode()
 		{
 			NodeBase::resetNode();
-			static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
 
 			//remove binding from delegate to be extra sure this will not be called
 			timerDelegate->removeWeak(sp_this(), &Service::serviceTick);
-			if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
+			if (const sp<TimerWheel>& serviceTimers = getTree().getServiceTimers())
 			{
-				//invariant that levels must have timer manager
-				currentLevel->getWorldTimeManager()->removeTimer(timerDelegate);
+				serviceTimers->removeTimer(timerDelegate);
 			}
 			else
 			{
-				log("BehaviorTree::Service", LogLevel::LOG_WARNING, "failure: no level to use for enforce service tick");
+				static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
+				if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
+				{
+					//invariant that levels must have timer manager
+					currentLevel->getWorldTimeManager()->removeTimer(timerDelegate);
+				}
+				else
+				{
+					log("BehaviorTree::Service", LogLevel::LOG_WARNING, "failure: no level to use for enforce service tick");
+				}
 			}
 
 			stopService();
@@ -530,16 +541,22 @@ namespace SA
 
 		void Service::evaluate()
 		{
-			static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
-
 			timerDelegate->addWeakObj(sp_this(), &Service::serviceTick);
-			const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel();
-			const sp<TimeManager>& timerManager = currentLevel ? currentLevel->getWorldTimeManager() : nullptr;
-			if (currentLevel && timerManager)
+			if (const sp<TimerWheel>& serviceTimers = getTree().getServiceTimers())
+			{
+				serviceTimers->createTimer(timerDelegate, tickSecs, bLoop);
+			}
+			else
 			{
-				timerManager->createTimer(timerDelegate, tickSecs, bLoop);
+				static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
+				const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel();
+				const sp<TimeManager>& timerManager = currentLevel ? currentLevel->getWorldTimeManager() : nullptr;
+				if (currentLevel && timerManager)
+				{
+					timerManager->createTimer(timerDelegate, tickSecs, bLoop);
+				}
+				else { log("BehaviorTree::Service", LogLevel::LOG_WARNING, "failure: no level/timermanager to use for enforce service tick"); }
 			}
-			else { log("BehaviorTree::Service", LogLevel::LOG_WARNING, "failure: no level/timermanager to use for enforce service tick"); }
 
 			startService();
 
@@ -628,27 +645,27 @@ namespace SA
 		{
 			/*
 				The loop node itself will only have its "isProcessing" checked once its child returns.
-				Here we limit the loop body to a single frame to avoid running a small loop many times in a single frame.
+				Here we limit the loop body to a single tree tick to avoid running a small loop many times in a single frame.
+				Brains tick their tree once per frame, so this is also once per frame.
 				So the execution sequence should go like this:
-					frame:0
+					tick:0
 						push loop
 						loop processing is false
 						push loop child
 						pop loop child
-						loop processing is true (this frame already checked)
-					frame:1
+						loop processing is true (this tick already checked)
+					tick:1
 						loop processing is false
 						push loop child
 						...
 			*/
 
-			static GameBase& game = GameBase::get();
-			uint64_t thisFrame = game.getFrameNumber();
+			const uint64_t thisTick = getTree().getTickNumber();
 
-			//signal this node is processing if it already looped this frame
-			bool bAlreadyTickedThisFrame = lastFrameTicked == thisFrame;
+			//signal this node is processing if it already looped this tick
+			bool bAlreadyTickedThisFrame = lastTickProcessed == thisTick;
 
-			lastFrameTicked = thisFrame;
+			lastTickProcessed = thisTick;
 
 			return bAlreadyTickedThisFrame;
 		}
@@ -665,10 +682,11 @@ namespace SA
 		Random::Random(
 			const std::string& name,
 			const std::vector<ChildChance> childChances,
-			const std::vector<sp<NodeBase>>& inChildren) 
+			const std::vector<sp<NodeBase>>& inChildren,
+			const sp<RNG>& inRNG /*= nullptr*/)
 			: MultiChildNode(name, inChildren)
 		{
-			rng = GameBase::get().getRNGSystem().getTimeInfluencedRNG();
+			rng = inRNG ? inRNG : GameBase::get().getRNGSystem().getTimeInfluencedRNG();
 
 			std::map<std::string, NodeBase*> nameToNodeMap;
 
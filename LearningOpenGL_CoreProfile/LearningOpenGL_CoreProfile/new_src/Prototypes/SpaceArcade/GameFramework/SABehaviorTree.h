@@ -5,14 +5,19 @@
 #include "SAGameEntity.h"
 #include <string>
 #include <vector>
+#include <deque>
+#include <limits>
+#include <variant>
 #include <optional>
 #include <unordered_map>
 #include <assert.h>
+#include <glm.hpp>
 #include "../Tools/DataStructures/MultiDelegate.h"
 
 namespace SA
 {
 	class RNG;
+	class TimerWheel;
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Behavior Trees
@@ -286,7 +291,7 @@ namespace SA
 			const uint32_t numLoops = 1;
 			const bool bInifinteLoop = false;
 			uint32_t currentLoop = 0;
-			mutable uint64_t lastFrameTicked = 0;
+			mutable uint64_t lastTickProcessed = 0;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -307,7 +312,8 @@ namespace SA
 			};
 
 		public:
-			Random(const std::string& name, const std::vector<ChildChance> childChances, const std::vector<sp<NodeBase>>& children);
+			/** Choices are drawn from rng; null takes a time influenced generator from the RNG system. */
+			Random(const std::string& name, const std::vector<ChildChance> childChances, const std::vector<sp<NodeBase>>& children, const sp<RNG>& rng = nullptr);
 
 			virtual bool isProcessing() const { return false; }; //children may be processing, but the RandomNode should always be immediately complete
 			virtual void evaluate() { /* Nothing to do here, get next child does random selection*/}
@@ -345,6 +351,25 @@ namespace SA
 			T value;
 		};
 
+		////////////////////////////////////////////////////////
+		// Dense index of a key in a tree's memory. Keys are interned
+		// when first used and keep their index for the life of the tree,
+		// so nodes can resolve their keys once (eg in notifyTreeEstablished)
+		// rather than hashing key strings on every access.
+		////////////////////////////////////////////////////////
+		struct MemoryKey
+		{
+			static constexpr uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+			uint32_t slot = INVALID_SLOT;
+
+			bool isValid() const { return slot != INVALID_SLOT; }
+		};
+
+		/** Values of these types can be stored inline in memory with Memory::setValue, rather than boxed in a PrimitiveWrapper. */
+		template<typename T>
+		constexpr bool isInlineMemoryType = std::is_same_v<T, bool> || std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, glm::vec3>;
+		using InlineMemoryValue = std::variant<std::monostate, bool, int, float, glm::vec3, wp<GameEntity>>;
+
 		////////////////////////////////////////////////////////
 		// The entry used for holding memory. This allows memory
 		// values to have auxiliary data such as update delegates 
@@ -352,12 +377,60 @@ namespace SA
 		////////////////////////////////////////////////////////
 		using Modified_MemoryDelegate = MultiDelegate<const std::string& /*key*/, const GameEntity* /*value*/>;
 		using Replaced_MemoryDelegate = MultiDelegate<const std::string& /*key*/, const GameEntity* /*oldValue*/, const GameEntity* /*newValue*/>;
-		struct MemoryEntry : public GameEntity
+		struct MemoryEntry
 		{
 			std::string key;
-			sp<GameEntity> value;
-			Modified_MemoryDelegate onValueModified;
-			Replaced_MemoryDelegate onValueReplaced;
+			sp<GameEntity> value;				//boxed values: game entities and PrimitiveWrapper<T>
+			InlineMemoryValue inlineValue;		//primitives and weak entity handles; only used when value is null
+
+			//delegates are only created once something subscribes, so entries nobody listens to never broadcast.
+			//held by shared pointer so that a broadcast survives a listener erasing the entry.
+			sp<Modified_MemoryDelegate> onValueModified;
+			sp<Replaced_MemoryDelegate> onValueReplaced;
+
+			/** Bumped on every modify or replace, whether or not anything is subscribed; lets pollers notice changes without delegates. */
+			uint32_t version = 0;
+
+			/** The entity in this entry, whether it is boxed or held weakly; null for inline primitives. */
+			sp<GameEntity> getEntity() const
+			{
+				if (value)
+				{
+					return value;
+				}
+				if (const wp<GameEntity>* weakEntity = std::get_if<wp<GameEntity>>(&inlineValue))
+				{
+					return weakEntity->lock();
+				}
+				return nullptr;
+			}
+
+			bool hasValue() const
+			{
+				if (const wp<GameEntity>* weakEntity = std::get_if<wp<GameEntity>>(&inlineValue))
+				{
+					return !weakEntity->expired();
+				}
+				return value != nullptr || !std::holds_alternative<std::monostate>(inlineValue);
+			}
+
+			void broadcastModified()
+			{
+				++version; //every write path ends in a modified broadcast
+				if (sp<Modified_MemoryDelegate> delegate = onValueModified)
+				{
+					sp<GameEntity> currentEntity = getEntity();
+					delegate->broadcast(key, currentEntity.get());
+				}
+			}
+
+			void broadcastReplaced(const GameEntity* oldValue, const GameEntity* newValue)
+			{
+				if (sp<Replaced_MemoryDelegate> delegate = onValueReplaced)
+				{
+					delegate->broadcast(key, oldValue, newValue);
+				}
+			}
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -392,7 +465,7 @@ namespace SA
 				//important that accesssed is checked; if copy-elision isn't used this will broadcast on returning copies
 				if (bAccessed && memoryEntry)
 				{
-					memoryEntry->onValueModified.broadcast(memoryEntry->key, memoryEntry->value.get());
+					memoryEntry->broadcastModified();
 				}
 			}
 
@@ -407,8 +480,8 @@ namespace SA
 			}
 		private:
 			//These are "raw" pointers because they should never outlive the scope of this object; if they do then this is being misused (which should be hard to do)
-			T* castValue;
-			MemoryEntry* memoryEntry;
+			T* castValue = nullptr;
+			MemoryEntry* memoryEntry = nullptr;
 			bool bAccessed = false;
 		};
 
@@ -428,15 +501,60 @@ namespace SA
 		//		-"modify value" means the object in memory has its properties changed, but it is still the same object.
 		//		-users of delegates "modify" and "replace" may not want to resubscribe,
 		//			-hence many memory entries themselves are not replaced, only what they point to.
+		//		-keys are interned to dense slots; every string keyed method is a key lookup followed by the MemoryKey version.
+		//			-hot paths should resolve a MemoryKey once and skip hashing strings every tick.
+		//		-bool, int, float, vec3 and weak entity handles can be stored inline in the slot (see setValue) so writing them does not allocate.
+		//			-inline values are not GameEntities; delegates are passed null for them, and getMemoryReference cannot return them.
+		//			-boxed PrimitiveWrapper<T> values still work, and are read through the same getReadValueAs/getWriteValueAs calls.
 		/////////////////////////////////////////////////////////////////////////////////////
 		class Memory : public GameEntity
 		{
-			//hashmap of keys to values
-			std::unordered_map<std::string, sp<MemoryEntry>> memory;
+			//entries are never removed, so slots (and pointers to entries) stay valid; deque so growing does not move entries.
+			//mutable because const reads hand out entries, see "const correct" above.
+			mutable std::deque<MemoryEntry> slots;
+			std::unordered_map<std::string, uint32_t> keyToSlot;
+
+		public:
+			/** Returns an invalid key if nothing has used this key yet. */
+			MemoryKey findKey(const std::string& key) const
+			{
+				auto findResult = keyToSlot.find(key);
+				return findResult != keyToSlot.end() ? MemoryKey{ findResult->second } : MemoryKey{};
+			}
+
+			/** Returns the key's slot, creating an empty one if this key has not been used yet. */
+			MemoryKey internKey(const std::string& key)
+			{
+				auto findResult = keyToSlot.find(key);
+				if (findResult != keyToSlot.end())
+				{
+					return MemoryKey{ findResult->second };
+				}
+
+				const uint32_t newSlot = static_cast<uint32_t>(slots.size());
+				slots.emplace_back().key = key;
+				keyToSlot.insert({ key, newSlot });
+				return MemoryKey{ newSlot };
+			}
+
+			const std::string& getKeyName(MemoryKey key) const
+			{
+				assert(key.isValid() && key.slot < slots.size());
+				return slots[key.slot].key;
+			}
+
+			size_t getNumKeys() const { return slots.size(); }
+
+			/** Changes whenever the key's value is modified or replaced. */
+			uint32_t getVersion(MemoryKey key) const
+			{
+				const MemoryEntry* memEntry = _getMemoryEntry(key);
+				return memEntry ? memEntry->version : 0;
+			}
 
 		public:
 			template<typename T>
-			const T* getReadValueAs(const std::string& key) const
+			const T* getReadValueAs(MemoryKey key) const
 			{
 				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
@@ -448,10 +566,16 @@ namespace SA
 				return nullptr;
 			}
 
+			template<typename T>
+			const T* getReadValueAs(const std::string& key) const
+			{
+				return getReadValueAs<T>(findKey(key));
+			}
+
 			/* This does not return the scoped wrapper because that requires exposing move/copy ctor; which could accidently be
 				abused to cache this value and hence allow dangling pointers */
 			template<typename T>
-			bool getWriteValueAs(const std::string& key, ScopedUpdateNotifier<T>& outWriteAccess)
+			bool getWriteValueAs(MemoryKey key, ScopedUpdateNotifier<T>& outWriteAccess)
 			{
 				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
@@ -466,11 +590,18 @@ namespace SA
 				return false;
 			}
 
+			template<typename T>
+			bool getWriteValueAs(const std::string& key, ScopedUpdateNotifier<T>& outWriteAccess)
+			{
+				return getWriteValueAs<T>(findKey(key), outWriteAccess);
+			}
+
 			/* Returns a copy of pointer to the memory value for caching purposes. 
 				NOTES:
 					-Must return const pointer so that user cannot modify it without OnModified/OnReplaced delegates firing
 					-must provide PrimitiveWrapper<T> as argument for non gameentity values
 					-do not const-cast the result; doing so will bypass the modified/replaced delegates; instead get writeable reference if you need to call non-const functions
+					-inline values (see setValue) have no shared object to reference, so this returns null for them; weak entity handles are locked.
 				REFACTOR CONSIDERATION:
 					-it has become clear, through use, that reading/writing memory every frame is expensive. Perhaps there should be a smart interface where
 						one can cache memory values (since I'm doing that anyways in space arcade through the backdoor or requesting a reference). Such an interface should expose a way to broadcast
@@ -478,89 +609,163 @@ namespace SA
 
 			*/
 			template<typename T>
-			sp<const T> getMemoryReference(const std::string& key)
+			sp<const T> getMemoryReference(MemoryKey key)
 			{
 				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
 					//profiling suggests just using dynamic cast is faster than caching rtti info in hash_set<std::type_index> and bypassing with static casts. 
-					return std::dynamic_pointer_cast<T>(memEntry->value);
+					return std::dynamic_pointer_cast<T>(memEntry->getEntity());
 				}
 
 				return sp<const T>(nullptr);
 			}
 
+			template<typename T>
+			sp<const T> getMemoryReference(const std::string& key)
+			{
+				return getMemoryReference<T>(findKey(key));
+			}
+
 			/** Warning: modifying values in response to this delegate will lead to infinite recursion; if required use next tick */
+			Modified_MemoryDelegate& getModifiedDelegate(MemoryKey key)
+			{
+				MemoryEntry& memEntry = _getSlot(key);
+				if (!memEntry.onValueModified)
+				{
+					memEntry.onValueModified = new_sp<Modified_MemoryDelegate>();
+				}
+				return *memEntry.onValueModified;
+			}
+
 			Modified_MemoryDelegate& getModifiedDelegate(const std::string& key)
 			{
-				MemoryEntry& memEntry = _findOrMakeMemoryEntry(key);
-				return memEntry.onValueModified;
+				return getModifiedDelegate(internKey(key));
 			}
 
 			/** Warning: replacing values in response to this delegate will lead to infinite recursion; if required use next tick */
+			Replaced_MemoryDelegate& getReplacedDelegate(MemoryKey key)
+			{
+				MemoryEntry& memEntry = _getSlot(key);
+				if (!memEntry.onValueReplaced)
+				{
+					memEntry.onValueReplaced = new_sp<Replaced_MemoryDelegate>();
+				}
+				return *memEntry.onValueReplaced;
+			}
+
 			Replaced_MemoryDelegate& getReplacedDelegate(const std::string& key)
 			{
-				MemoryEntry& memEntry = _findOrMakeMemoryEntry(key);
-				return memEntry.onValueReplaced;
+				return getReplacedDelegate(internKey(key));
+			}
+
+			template<typename T>
+			T* replaceValue(MemoryKey key, const sp<T>& newValue)
+			{
+				static_assert(std::is_base_of<GameEntity, T>(), "Value must be of GameEntity. For primitive/integral values, use provided PrimitiveWrapper or setValue");
+
+				MemoryEntry& memoryEntry = _getSlot(key);
+
+				//must take care that old value is not ref collected before this; storing old value as shared pointer will do the trick
+				sp<GameEntity> oldValue = memoryEntry.getEntity();
+				memoryEntry.value = newValue;
+				memoryEntry.inlineValue = std::monostate{};
+
+				memoryEntry.broadcastReplaced(oldValue.get(), newValue.get());
+				memoryEntry.broadcastModified();
+
+				return newValue.get();
 			}
 
 			template<typename T>
 			T* replaceValue(const std::string& key, const sp<T>& newValue)
 			{
-				static_assert(std::is_base_of<GameEntity, T>(), "Value must be of GameEntity. For primitive/integral values, use provided PrimitiveWrapper");
+				return replaceValue(internKey(key), newValue);
+			}
 
-				sp<MemoryEntry> memoryEntry = nullptr;
-				sp<GameEntity> oldValue = nullptr;
+			/** Stores a value inline. Writing a value of the type already held is a modify; anything else is a replace. */
+			template<typename T>
+			void setValue(MemoryKey key, const T& newValue)
+			{
+				static_assert(isInlineMemoryType<T>, "Only bool, int, float and glm::vec3 are stored inline; use replaceValue for other types");
 
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
+				MemoryEntry& memoryEntry = _getSlot(key);
+				if (T* currentValue = std::get_if<T>(&memoryEntry.inlineValue))
 				{
-					memoryEntry = findResult->second;
-					oldValue = memoryEntry->value;
+					*currentValue = newValue;
 				}
 				else
 				{
-					memoryEntry = new_sp<MemoryEntry>();
-					memoryEntry->key = key;
+					sp<GameEntity> oldValue = memoryEntry.getEntity();
+					memoryEntry.value = nullptr;
+					memoryEntry.inlineValue = newValue;
+					memoryEntry.broadcastReplaced(oldValue.get(), nullptr);
 				}
-				memoryEntry->value = newValue;
-				memory.insert({ key, memoryEntry });
+				memoryEntry.broadcastModified();
+			}
 
-				//must take care that old value is not ref collected before this; storing old value as shared pointer will do the trick
-				memoryEntry->onValueReplaced.broadcast(key, oldValue.get(), newValue.get());
-				memoryEntry->onValueModified.broadcast(key, memoryEntry->value.get());
+			template<typename T>
+			void setValue(const std::string& key, const T& newValue)
+			{
+				setValue(internKey(key), newValue);
+			}
 
-				return newValue.get();
+			/** Stores a weak handle to an entity; unlike replaceValue, memory will not keep the entity alive. Always a replace. */
+			template<typename T>
+			void setWeakValue(MemoryKey key, const wp<T>& newValue)
+			{
+				static_assert(std::is_base_of<GameEntity, T>(), "Weak values must be GameEntities");
+
+				MemoryEntry& memoryEntry = _getSlot(key);
+				sp<GameEntity> oldValue = memoryEntry.getEntity();
+				sp<GameEntity> newEntity = newValue.lock();
+				memoryEntry.value = nullptr;
+				memoryEntry.inlineValue = wp<GameEntity>(newEntity);
+
+				memoryEntry.broadcastReplaced(oldValue.get(), newEntity.get());
+				memoryEntry.broadcastModified();
 			}
 
-			bool hasValue(const std::string& key)
+			template<typename T>
+			void setWeakValue(const std::string& key, const wp<T>& newValue)
 			{
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
-				{
-					return findResult->second->value.get() != nullptr;
-				}
-				return false;
+				setWeakValue(internKey(key), newValue);
+			}
+
+			bool hasValue(MemoryKey key) const
+			{
+				const MemoryEntry* memEntry = _getMemoryEntry(key);
+				return memEntry && memEntry->hasValue();
+			}
+
+			bool hasValue(const std::string& key) const
+			{
+				return hasValue(findKey(key));
 			}
 
 			/**
 				Prefer this method for removing values; it will let listeners know that value has been replaced.
 				It will also not corrupt listeners to memory entries.
 			*/
-			bool removeValue(const std::string& key)
+			bool removeValue(MemoryKey key)
 			{
 				//we do not want to clear subscribers to memory value modified/replaced. So insert a null.
-				MemoryEntry* MemEntry = _getMemoryEntry(key);
-				bool bHadMemValue = MemEntry ? (MemEntry->value != nullptr) : false;
+				bool bHadMemValue = hasValue(key);
 				bool bNewValueIsNull = replaceValue(key, sp<GameEntity>{nullptr}) == nullptr; //replace value this will broadcast events
 				return bHadMemValue && bNewValueIsNull;
 			}
 
+			bool removeValue(const std::string& key)
+			{
+				return removeValue(internKey(key));
+			}
+
 			/**
 				Avoid using this method, prefer removeValue so delegates are not lost; this will have sideeffects on decorators
 				Removing entry will remove all delegate listeners; this option should NOT be checked generally.
 				It mostly exists in case a task wants to create new memory values at run time then clean them up.
 				The normal behavior tree workflow is to specify all the memory that will be used up front.
 				Then remove values as it sees fit, but leaving delegate listeners in tack so they can react
+				The key keeps its slot, so MemoryKeys resolved for it stay valid.
 			*/
 			bool eraseEntry(const std::string& key)
 			{
@@ -568,19 +773,31 @@ namespace SA
 				// /*onErasing.broadcast(key);*/	//I want to avoid making this a thing because then users will have to subscrib to it to be safe
 				//in reality removing they memory entry should be discouraged unless under very niche scenarios (task creates and them)
 				//in fact, this method should probably be removed. But then there is a way to create memory entries but no way to remove them, which seems strange.
-				removeValue(key);
-				return memory.erase(key) > 0;
+				MemoryKey memoryKey = findKey(key);
+				if (!memoryKey.isValid())
+				{
+					return false;
+				}
+				MemoryEntry& memoryEntry = _getSlot(memoryKey);
+				bool bHadEntry = memoryEntry.hasValue() || memoryEntry.onValueModified || memoryEntry.onValueReplaced;
+
+				removeValue(memoryKey);
+				memoryEntry.onValueModified = nullptr;
+				memoryEntry.onValueReplaced = nullptr;
+				return bHadEntry;
 			}
 
 		private:
-			inline MemoryEntry* _getMemoryEntry(const std::string key) const
+			inline MemoryEntry* _getMemoryEntry(MemoryKey key) const
 			{
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
-				{
-					return findResult->second.get();
-				}
-				return nullptr;
+				return key.slot < slots.size() ? &slots[key.slot] : nullptr;
+			}
+
+			/** For writes; the key must have come from this memory. */
+			inline MemoryEntry& _getSlot(MemoryKey key)
+			{
+				assert(key.slot < slots.size());
+				return slots[key.slot];
 			}
 
 			template<typename T>
@@ -589,10 +806,25 @@ namespace SA
 				if constexpr (std::is_base_of<GameEntity, T>())
 				{
 					//profiling suggests just using dynamic cast is faster than caching rtti info in hash_set<std::type_index> and bypassing with static casts. 
-					return dynamic_cast<T*>(memoryEntry.value.get());
+					if (memoryEntry.value)
+					{
+						return dynamic_cast<T*>(memoryEntry.value.get());
+					}
+					else if (wp<GameEntity>* weakEntity = std::get_if<wp<GameEntity>>(&memoryEntry.inlineValue))
+					{
+						//memory does not own weak entities; the pointer is valid for as long as whatever owns the entity keeps it
+						return dynamic_cast<T*>(weakEntity->lock().get());
+					}
 				}
 				else
 				{
+					if constexpr (isInlineMemoryType<T>)
+					{
+						if (T* inlineValue = std::get_if<T>(&memoryEntry.inlineValue))
+						{
+							return inlineValue;
+						}
+					}
 					if (PrimitiveWrapper<T>* wrappedObj = dynamic_cast<PrimitiveWrapper<T>*>(memoryEntry.value.get()))
 					{
 						return &(wrappedObj->value);
@@ -600,22 +832,6 @@ namespace SA
 				}
 				return nullptr;
 			}
-
-			MemoryEntry& _findOrMakeMemoryEntry(const std::string& key)
-			{
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
-				{
-					return *(findResult->second.get());
-				}
-				else
-				{
-					replaceValue<GameEntity>(key, sp <GameEntity>{ nullptr });
-					auto findNewValue = memory.find(key);
-					assert(findNewValue != memory.end());
-					return *(findNewValue->second.get());
-				}
-			}
 		};
 
 		using MemoryInitializer = std::vector<std::pair<std::string, sp<GameEntity>>>;
@@ -647,6 +863,13 @@ namespace SA
 			uint32_t getCurrentPriority();
 			Memory& getMemory() const;	//marked as const and memory should be considered mutable
 			float getFrameDeltaTimeSecs() const { return frame_dt_sec; }
+			/** Incremented at the start of every tick; nodes use it to do work at most once per tick (see Loop). */
+			uint64_t getTickNumber() const { return tickNumber; }
+
+			/** Services schedule their ticks here rather than on the current level's world time manager; lets whoever
+				owns the tree advance its service time (eg tests stepping time by hand). Set before starting the tree. */
+			void setServiceTimers(const sp<TimerWheel>& inServiceTimers) { serviceTimers = inServiceTimers; }
+			const sp<TimerWheel>& getServiceTimers() const { return serviceTimers; }
 
 		public: //debug utils
 			void makeTreeDebugTarget() { targetDebugTree = this; }
@@ -684,6 +907,8 @@ namespace SA
 			std::optional<ResumeStateData> resumeData;
 
 			float frame_dt_sec = 1.f;
+			uint64_t tickNumber = 0;
+			sp<TimerWheel> serviceTimers = nullptr;
 		};
 
 	}
@@ -0,0 +1,296 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "SABehaviorTree.h"
+
+/*
+	Headless benchmark for behavior tree memory; no window, GL context, or game systems are created.
+
+	Simulates the memory traffic of many ship trees ticking: every tick each tree reads a handful of values
+	(a target, positions, a state and a few numbers) and writes two of them back. The same script runs
+	against the previous layout (string keyed map of entries with their delegates, primitives boxed in
+	PrimitiveWrapper), the current memory through string keys, and the current memory through MemoryKeys with
+	values stored inline. All runs compute the same checksum.
+*/
+
+namespace
+{
+	using namespace SA;
+	using namespace SA::BehaviorTree;
+
+	/** the memory layout before keys were interned; each entry was its own allocation with eagerly constructed delegates */
+	class LegacyMemory
+	{
+		struct LegacyEntry : public GameEntity
+		{
+			std::string key;
+			sp<GameEntity> value;
+			Modified_MemoryDelegate onValueModified;
+			Replaced_MemoryDelegate onValueReplaced;
+		};
+		std::unordered_map<std::string, sp<LegacyEntry>> memory;
+
+	public:
+		template<typename T>
+		const T* getReadValueAs(const std::string& key) const
+		{
+			auto findResult = memory.find(key);
+			if (findResult != memory.end())
+			{
+				if constexpr (std::is_base_of<GameEntity, T>())
+				{
+					return dynamic_cast<T*>(findResult->second->value.get());
+				}
+				else if (PrimitiveWrapper<T>* wrappedObj = dynamic_cast<PrimitiveWrapper<T>*>(findResult->second->value.get()))
+				{
+					return &wrappedObj->value;
+				}
+			}
+			return nullptr;
+		}
+
+		template<typename T>
+		void write(const std::string& key, const T& newValue)
+		{
+			auto findResult = memory.find(key);
+			if (findResult != memory.end())
+			{
+				if (PrimitiveWrapper<T>* wrappedObj = dynamic_cast<PrimitiveWrapper<T>*>(findResult->second->value.get()))
+				{
+					wrappedObj->value = newValue;
+					findResult->second->onValueModified.broadcast(key, wrappedObj);
+				}
+			}
+		}
+
+		void replaceValue(const std::string& key, const sp<GameEntity>& newValue)
+		{
+			sp<LegacyEntry>& entry = memory[key];
+			if (!entry)
+			{
+				entry = new_sp<LegacyEntry>();
+				entry->key = key;
+			}
+			sp<GameEntity> oldValue = entry->value;
+			entry->value = newValue;
+			entry->onValueReplaced.broadcast(key, oldValue.get(), newValue.get());
+			entry->onValueModified.broadcast(key, newValue.get());
+		}
+	};
+
+	struct TargetEntity : public GameEntity
+	{
+		glm::vec3 position{ 0.f };
+	};
+
+	struct BenchConfig
+	{
+		size_t numTrees = 2000;
+		size_t numTicks = 300;
+		uint32_t seed = 0xB7;
+	};
+
+	struct BenchResults
+	{
+		double totalMs = 0.0;
+		double checksum = 0.0;
+	};
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	//the keys a fighter tree touches each tick
+	const char* const targetKey = "target";
+	const char* const destinationKey = "destination";
+	const char* const avoidanceKey = "avoidance";
+	const char* const stateKey = "state";
+	const char* const attackersKey = "attackers";
+	const char* const throttleKey = "throttle";
+	const char* const bFiringKey = "bFiring";
+
+	std::vector<sp<TargetEntity>> makeTargets(const BenchConfig& config)
+	{
+		std::mt19937 rng(config.seed);
+		std::uniform_real_distribution<float> posDist(-500.f, 500.f);
+		std::vector<sp<TargetEntity>> targets;
+		for (size_t idx = 0; idx < config.numTrees; ++idx)
+		{
+			targets.push_back(new_sp<TargetEntity>());
+			targets.back()->position = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+		}
+		return targets;
+	}
+
+	BenchResults runLegacy(const BenchConfig& config, const std::vector<sp<TargetEntity>>& targets)
+	{
+		BenchResults results;
+		std::vector<LegacyMemory> memories(config.numTrees);
+		for (size_t treeIdx = 0; treeIdx < config.numTrees; ++treeIdx)
+		{
+			LegacyMemory& memory = memories[treeIdx];
+			memory.replaceValue(targetKey, targets[(treeIdx + 1) % targets.size()]);
+			memory.replaceValue(destinationKey, new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3(float(treeIdx))));
+			memory.replaceValue(avoidanceKey, new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3(0.f)));
+			memory.replaceValue(stateKey, new_sp<PrimitiveWrapper<int>>(0));
+			memory.replaceValue(attackersKey, new_sp<PrimitiveWrapper<int>>(int(treeIdx % 4)));
+			memory.replaceValue(throttleKey, new_sp<PrimitiveWrapper<float>>(1.f));
+			memory.replaceValue(bFiringKey, new_sp<PrimitiveWrapper<bool>>(false));
+		}
+
+		Clock::time_point start = Clock::now();
+		for (size_t tick = 0; tick < config.numTicks; ++tick)
+		{
+			for (LegacyMemory& memory : memories)
+			{
+				const TargetEntity* target = memory.getReadValueAs<TargetEntity>(targetKey);
+				const glm::vec3 destination = *memory.getReadValueAs<glm::vec3>(destinationKey) + *memory.getReadValueAs<glm::vec3>(avoidanceKey);
+				const int state = *memory.getReadValueAs<int>(stateKey);
+				const float throttle = *memory.getReadValueAs<float>(throttleKey) * (*memory.getReadValueAs<int>(attackersKey) > 1 ? 0.5f : 1.f);
+				const bool bFiring = *memory.getReadValueAs<bool>(bFiringKey);
+
+				const glm::vec3 toTarget = target->position - destination;
+				memory.write<glm::vec3>(destinationKey, destination + toTarget * (0.01f * throttle));
+				memory.write<int>(stateKey, (state + (bFiring ? 2 : 1)) % 7);
+				results.checksum += double(toTarget.x) + double(state);
+			}
+		}
+		results.totalMs = elapsedMs(start);
+		return results;
+	}
+
+	BenchResults runStringKeys(const BenchConfig& config, const std::vector<sp<TargetEntity>>& targets)
+	{
+		BenchResults results;
+		std::vector<sp<Memory>> memories;
+		for (size_t treeIdx = 0; treeIdx < config.numTrees; ++treeIdx)
+		{
+			sp<Memory> memory = new_sp<Memory>();
+			memory->replaceValue(targetKey, targets[(treeIdx + 1) % targets.size()]);
+			memory->replaceValue(destinationKey, new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3(float(treeIdx))));
+			memory->replaceValue(avoidanceKey, new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3(0.f)));
+			memory->replaceValue(stateKey, new_sp<PrimitiveWrapper<int>>(0));
+			memory->replaceValue(attackersKey, new_sp<PrimitiveWrapper<int>>(int(treeIdx % 4)));
+			memory->replaceValue(throttleKey, new_sp<PrimitiveWrapper<float>>(1.f));
+			memory->replaceValue(bFiringKey, new_sp<PrimitiveWrapper<bool>>(false));
+			memories.push_back(memory);
+		}
+
+		Clock::time_point start = Clock::now();
+		for (size_t tick = 0; tick < config.numTicks; ++tick)
+		{
+			for (const sp<Memory>& memory : memories)
+			{
+				const TargetEntity* target = memory->getReadValueAs<TargetEntity>(targetKey);
+				const glm::vec3 destination = *memory->getReadValueAs<glm::vec3>(destinationKey) + *memory->getReadValueAs<glm::vec3>(avoidanceKey);
+				const int state = *memory->getReadValueAs<int>(stateKey);
+				const float throttle = *memory->getReadValueAs<float>(throttleKey) * (*memory->getReadValueAs<int>(attackersKey) > 1 ? 0.5f : 1.f);
+				const bool bFiring = *memory->getReadValueAs<bool>(bFiringKey);
+
+				const glm::vec3 toTarget = target->position - destination;
+				{
+					ScopedUpdateNotifier<glm::vec3> destination_writable;
+					ScopedUpdateNotifier<int> state_writable;
+					if (memory->getWriteValueAs(destinationKey, destination_writable) && memory->getWriteValueAs(stateKey, state_writable))
+					{
+						destination_writable.get() = destination + toTarget * (0.01f * throttle);
+						state_writable.get() = (state + (bFiring ? 2 : 1)) % 7;
+					}
+				}
+				results.checksum += double(toTarget.x) + double(state);
+			}
+		}
+		results.totalMs = elapsedMs(start);
+		return results;
+	}
+
+	BenchResults runInternedKeys(const BenchConfig& config, const std::vector<sp<TargetEntity>>& targets)
+	{
+		struct TreeKeys
+		{
+			MemoryKey target, destination, avoidance, state, attackers, throttle, bFiring;
+		};
+
+		BenchResults results;
+		std::vector<sp<Memory>> memories;
+		std::vector<TreeKeys> treeKeys;
+		for (size_t treeIdx = 0; treeIdx < config.numTrees; ++treeIdx)
+		{
+			sp<Memory> memory = new_sp<Memory>();
+			TreeKeys keys;
+			keys.target = memory->internKey(targetKey);
+			keys.destination = memory->internKey(destinationKey);
+			keys.avoidance = memory->internKey(avoidanceKey);
+			keys.state = memory->internKey(stateKey);
+			keys.attackers = memory->internKey(attackersKey);
+			keys.throttle = memory->internKey(throttleKey);
+			keys.bFiring = memory->internKey(bFiringKey);
+
+			memory->setWeakValue(keys.target, wp<TargetEntity>(targets[(treeIdx + 1) % targets.size()]));
+			memory->setValue(keys.destination, glm::vec3(float(treeIdx)));
+			memory->setValue(keys.avoidance, glm::vec3(0.f));
+			memory->setValue(keys.state, 0);
+			memory->setValue(keys.attackers, int(treeIdx % 4));
+			memory->setValue(keys.throttle, 1.f);
+			memory->setValue(keys.bFiring, false);
+			memories.push_back(memory);
+			treeKeys.push_back(keys);
+		}
+
+		Clock::time_point start = Clock::now();
+		for (size_t tick = 0; tick < config.numTicks; ++tick)
+		{
+			for (size_t treeIdx = 0; treeIdx < memories.size(); ++treeIdx)
+			{
+				Memory& memory = *memories[treeIdx];
+				const TreeKeys& keys = treeKeys[treeIdx];
+
+				const TargetEntity* target = memory.getReadValueAs<TargetEntity>(keys.target);
+				const glm::vec3 destination = *memory.getReadValueAs<glm::vec3>(keys.destination) + *memory.getReadValueAs<glm::vec3>(keys.avoidance);
+				const int state = *memory.getReadValueAs<int>(keys.state);
+				const float throttle = *memory.getReadValueAs<float>(keys.throttle) * (*memory.getReadValueAs<int>(keys.attackers) > 1 ? 0.5f : 1.f);
+				const bool bFiring = *memory.getReadValueAs<bool>(keys.bFiring);
+
+				const glm::vec3 toTarget = target->position - destination;
+				memory.setValue(keys.destination, destination + toTarget * (0.01f * throttle));
+				memory.setValue(keys.state, (state + (bFiring ? 2 : 1)) % 7);
+				results.checksum += double(toTarget.x) + double(state);
+			}
+		}
+		results.totalMs = elapsedMs(start);
+		return results;
+	}
+
+	void printResults(const char* memoryName, const BenchConfig& config, const BenchResults& results)
+	{
+		std::cout << memoryName << "\n"
+			<< "\ttotal:     " << results.totalMs << " ms\n"
+			<< "\tper tick:  " << results.totalMs / config.numTicks << " ms for " << config.numTrees << " trees\n"
+			<< "\tchecksum:  " << results.checksum << std::endl;
+	}
+
+	void true_main()
+	{
+		BenchConfig config;
+		std::vector<sp<TargetEntity>> targets = makeTargets(config);
+
+		BenchResults legacyResults = runLegacy(config, targets);
+		printResults("string keyed map, boxed primitives (previous layout)", config, legacyResults);
+
+		BenchResults stringResults = runStringKeys(config, targets);
+		printResults("interned slots through string keys, boxed primitives", config, stringResults);
+
+		BenchResults internedResults = runInternedKeys(config, targets);
+		printResults("interned slots through MemoryKey, inline values", config, internedResults);
+
+		if (legacyResults.checksum != stringResults.checksum || legacyResults.checksum != internedResults.checksum)
+		{
+			std::cerr << "MISMATCH: checksums differ" << std::endl;
+		}
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
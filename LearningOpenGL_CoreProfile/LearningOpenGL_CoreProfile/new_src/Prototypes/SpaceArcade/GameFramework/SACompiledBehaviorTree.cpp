@@ -0,0 +1,799 @@
+#include "SACompiledBehaviorTree.h"
+#include "SAGameBase.h"
+#include "SARandomNumberGenerationSystem.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace SA
+{
+	namespace BehaviorTree
+	{
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Memory layout
+		/////////////////////////////////////////////////////////////////////////////////////
+		MemoryKey CompiledMemoryLayout::add(const std::string& keyName)
+		{
+			MemoryKey key = find(keyName);
+			if (!key.isValid())
+			{
+				key.slot = uint32_t(keyNames.size());
+				keyNames.push_back(keyName);
+			}
+			return key;
+		}
+
+		MemoryKey CompiledMemoryLayout::find(const std::string& keyName) const
+		{
+			for (size_t keyIdx = 0; keyIdx < keyNames.size(); ++keyIdx)
+			{
+				if (keyNames[keyIdx] == keyName)
+				{
+					return MemoryKey{ uint32_t(keyIdx) };
+				}
+			}
+			return MemoryKey{};
+		}
+
+		void CompiledMemoryLayout::internInto(Memory& memory) const
+		{
+			for (size_t keyIdx = 0; keyIdx < keyNames.size(); ++keyIdx)
+			{
+				MemoryKey key = memory.internKey(keyNames[keyIdx]);
+				assert(key.slot == keyIdx); //memory must be fresh, otherwise layout keys will not match this instance's slots
+				(void)key;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Node definitions
+		/////////////////////////////////////////////////////////////////////////////////////
+		CompiledNodeDef CompiledNodeDef::selector(const std::string& name, const std::vector<CompiledNodeDef>& children)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::SELECTOR;
+			def.children = children;
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::sequence(const std::string& name, const std::vector<CompiledNodeDef>& children)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::SEQUENCE;
+			def.children = children;
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::decorator(const std::string& name, const sp<CompiledCondition>& condition, const CompiledNodeDef& child)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::DECORATOR;
+			def.conditionBehavior = condition;
+			def.children.push_back(child);
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::abortingDecorator(const std::string& name, const sp<CompiledCondition>& condition, MemoryKey watchedKey, Decorator::AbortType abortType, const CompiledNodeDef& child)
+		{
+			CompiledNodeDef def = decorator(name, condition, child);
+			def.watchedKey = watchedKey;
+			def.abortType = abortType;
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::service(const std::string& name, const sp<CompiledService>& service, float tickSecs, bool bLoop, const CompiledNodeDef& child)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::SERVICE;
+			def.serviceBehavior = service;
+			def.tickSecs = tickSecs;
+			def.bLoop = bLoop;
+			def.children.push_back(child);
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::loop(const std::string& name, uint32_t numLoops, const CompiledNodeDef& child)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::LOOP;
+			def.numLoops = numLoops;
+			def.children.push_back(child);
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::random(const std::string& name, const std::vector<uint32_t>& chancePoints, const std::vector<CompiledNodeDef>& children)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::RANDOM;
+			def.chancePoints = chancePoints;
+			def.children = children;
+			return def;
+		}
+
+		CompiledNodeDef CompiledNodeDef::task(const std::string& name, const sp<CompiledTask>& task)
+		{
+			CompiledNodeDef def;
+			def.name = name;
+			def.type = CompiledNodeType::TASK;
+			def.taskBehavior = task;
+			return def;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Tree definition
+		/////////////////////////////////////////////////////////////////////////////////////
+		sp<const CompiledTreeDefinition> CompiledTreeDefinition::compile(const std::string& name, const CompiledNodeDef& root, const CompiledMemoryLayout& memoryLayout)
+		{
+			sp<CompiledTreeDefinition> definition = new_sp<CompiledTreeDefinition>();
+			definition->name = name;
+			definition->memoryLayout = memoryLayout;
+			definition->flatten(root, TREE_NODE);
+			return definition;
+		}
+
+		uint32_t CompiledTreeDefinition::flatten(const CompiledNodeDef& def, uint32_t parent)
+		{
+			//pre-order, matching Tree::possessNodes, so an index is also the node's priority
+			const uint32_t nodeIdx = uint32_t(nodes.size());
+			nodes.emplace_back();
+			nodeNames.push_back(def.name);
+			{
+				Node& node = nodes.back();
+				node.parent = parent;
+				node.type = def.type;
+				node.watchedKey = def.watchedKey;
+				node.abortType = def.abortType;
+				node.tickSecs = def.tickSecs;
+				node.bLoop = def.bLoop;
+				node.numLoops = def.numLoops;
+			}
+
+			const bool bMultiChild = def.type == CompiledNodeType::SELECTOR || def.type == CompiledNodeType::SEQUENCE || def.type == CompiledNodeType::RANDOM;
+			const bool bSingleChild = def.type == CompiledNodeType::DECORATOR || def.type == CompiledNodeType::SERVICE || def.type == CompiledNodeType::LOOP;
+			if ((bMultiChild && def.children.empty()) || (bSingleChild && def.children.size() != 1) || (def.type == CompiledNodeType::TASK && !def.children.empty()))
+			{
+				throw std::runtime_error("invalid compiled behavior tree node \"" + def.name + "\"; wrong number of children for its type.");
+			}
+			if ((def.type == CompiledNodeType::TASK && !def.taskBehavior)
+				|| (def.type == CompiledNodeType::DECORATOR && !def.conditionBehavior)
+				|| (def.type == CompiledNodeType::SERVICE && !def.serviceBehavior))
+			{
+				throw std::runtime_error("invalid compiled behavior tree node \"" + def.name + "\"; missing its behavior.");
+			}
+
+			switch (def.type)
+			{
+				case CompiledNodeType::TASK:
+					nodes[nodeIdx].behaviorIdx = uint32_t(tasks.size());
+					tasks.push_back(def.taskBehavior);
+					break;
+				case CompiledNodeType::DECORATOR:
+					nodes[nodeIdx].behaviorIdx = uint32_t(conditions.size());
+					conditions.push_back(def.conditionBehavior);
+					if (def.watchedKey.isValid())
+					{
+						watchingNodes.push_back(nodeIdx);
+					}
+					break;
+				case CompiledNodeType::SERVICE:
+					nodes[nodeIdx].behaviorIdx = uint32_t(services.size());
+					services.push_back(def.serviceBehavior);
+					break;
+				default:
+					break;
+			}
+
+			//children are flattened first so their indices are known; then their range is written in one block
+			std::vector<uint32_t> children;
+			children.reserve(def.children.size());
+			for (const CompiledNodeDef& childDef : def.children)
+			{
+				children.push_back(flatten(childDef, nodeIdx));
+			}
+
+			Node& node = nodes[nodeIdx];
+			node.childBegin = uint32_t(childIndices.size());
+			childIndices.insert(childIndices.end(), children.begin(), children.end());
+			node.childEnd = uint32_t(childIndices.size());
+
+			if (def.type == CompiledNodeType::RANDOM)
+			{
+				if (def.chancePoints.size() != children.size())
+				{
+					throw std::runtime_error("invalid compiled random node \"" + def.name + "\"; every child needs chance points.");
+				}
+				node.chanceBegin = uint32_t(chanceBuckets.size());
+				for (size_t childIdx = 0; childIdx < children.size(); ++childIdx)
+				{
+					chanceBuckets.insert(chanceBuckets.end(), def.chancePoints[childIdx], children[childIdx]);
+				}
+				node.chanceEnd = uint32_t(chanceBuckets.size());
+				if (node.chanceBegin == node.chanceEnd)
+				{
+					throw std::runtime_error("invalid compiled random node \"" + def.name + "\"; no chance points.");
+				}
+			}
+			return nodeIdx;
+		}
+
+		uint32_t CompiledTreeDefinition::findNode(const std::string& nodeName) const
+		{
+			for (size_t nodeIdx = 0; nodeIdx < nodeNames.size(); ++nodeIdx)
+			{
+				if (nodeNames[nodeIdx] == nodeName)
+				{
+					return uint32_t(nodeIdx);
+				}
+			}
+			return TREE_NODE;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Tree group
+		/////////////////////////////////////////////////////////////////////////////////////
+		CompiledTreeGroup::CompiledTreeGroup(const sp<const CompiledTreeDefinition>& definition, const sp<RNG>& inRNG)
+			: definition(definition), nodes(definition->nodes.data()), numNodes(definition->getNumNodes())
+		{
+			//only trees with random nodes need a generator; the others do not touch the RNG system
+			rng = inRNG;
+			if (!rng && !definition->chanceBuckets.empty())
+			{
+				rng = GameBase::get().getRNGSystem().getTimeInfluencedRNG();
+			}
+		}
+
+		uint32_t CompiledTreeGroup::addInstance(const MemoryInitializer& initializedMemory)
+		{
+			uint32_t instance = 0;
+			if (!freeInstances.empty())
+			{
+				instance = freeInstances.back();
+				freeInstances.pop_back();
+			}
+			else
+			{
+				instance = uint32_t(instances.size());
+				instances.emplace_back();
+				memories.emplace_back();
+				nodeStates.resize(nodeStates.size() + numNodes);
+			}
+
+			instances[instance] = CompiledInstanceState{};
+			instances[instance].bAlive = true;
+			CompiledNodeState* states = getStates(instance);
+			std::fill(states, states + numNodes, CompiledNodeState{});
+
+			sp<Memory> memory = new_sp<Memory>();
+			definition->memoryLayout.internInto(*memory);
+			for (const auto& kv_pair : initializedMemory)
+			{
+				memory->replaceValue(kv_pair.first, kv_pair.second);
+			}
+			memories[instance] = memory;
+
+			//watching starts now, like decorators subscribing when their tree is established
+			for (uint32_t nodeIdx : definition->watchingNodes)
+			{
+				states[nodeIdx].aux = memory->getVersion(nodes[nodeIdx].watchedKey);
+			}
+			return instance;
+		}
+
+		void CompiledTreeGroup::removeInstance(uint32_t instance)
+		{
+			if (instance < instances.size() && instances[instance].bAlive)
+			{
+				stop(instance);
+				instances[instance].bAlive = false;
+				memories[instance] = nullptr;
+				freeInstances.push_back(instance);
+			}
+		}
+
+		void CompiledTreeGroup::start(uint32_t instance)
+		{
+			CompiledInstanceState& inst = instances[instance];
+			if (inst.bAlive && !inst.bExecuting)
+			{
+				inst.bExecuting = true;
+				inst.currentNode = CompiledTreeDefinition::TREE_NODE;
+			}
+		}
+
+		void CompiledTreeGroup::stop(uint32_t instance)
+		{
+			CompiledInstanceState& inst = instances[instance];
+			if (inst.bExecuting)
+			{
+				//clear execution path using abort, like Tree::stop
+				abort(instance, 0);
+				ExecutionState mockState;
+				processAborts(instance, getStates(instance), mockState, 0.f);
+
+				inst.bExecuting = false;
+				inst.bHasResumeData = false;
+				inst.bAborting = false;
+			}
+		}
+
+		void CompiledTreeGroup::abort(uint32_t instance, uint32_t priority)
+		{
+			CompiledInstanceState& inst = instances[instance];
+			if (inst.bAborting && inst.abortPriority <= priority)
+			{
+				return; //already aborting a higher priority, do not stomp this value.
+			}
+			inst.bAborting = true;
+			inst.abortPriority = priority;
+		}
+
+		uint32_t CompiledTreeGroup::getCurrentPriority(uint32_t instance) const
+		{
+			return getPriority(instances[instance].currentNode);
+		}
+
+		void CompiledTreeGroup::tick(float delta_sec)
+		{
+			++tickNumber;
+			for (uint32_t instance = 0; instance < uint32_t(instances.size()); ++instance)
+			{
+				if (instances[instance].bExecuting)
+				{
+					tickInstance(instance, delta_sec);
+				}
+			}
+		}
+
+		void CompiledTreeGroup::tickInstance(uint32_t instance, float delta_sec)
+		{
+			//this mirrors Tree::tick; see there for the design considerations
+			CompiledInstanceState& inst = instances[instance];
+			CompiledNodeState* states = getStates(instance);
+
+			tickRunningBehaviors(instance, states, delta_sec);
+
+			ExecutionState currentState = ExecutionState::STARTING;
+			bool bNodeCompletedSuccessfully = false;
+			if (inst.bHasResumeData)
+			{
+				currentState = inst.resumeState;
+				bNodeCompletedSuccessfully = inst.bResumeChildResult;
+			}
+
+			uint32_t nodesVisited = 0;
+			bool bReachedMaxNodesThisTick = false;
+
+			processAborts(instance, states, currentState, delta_sec);
+
+			while (!isProcessing(inst.currentNode, states) && !bReachedMaxNodesThisTick)
+			{
+				const uint32_t currentNode = inst.currentNode;
+
+				//USE PREVIOUS STATE
+				if (currentState == ExecutionState::POPPED_CHILD)
+				{
+					notifyCurrentChildResult(currentNode, states, bNodeCompletedSuccessfully);
+				}
+				else if (currentState == ExecutionState::PUSHED_CHILD)
+				{
+					evaluate(instance, currentNode, states, delta_sec);
+				}
+
+				//PREPARE NEXT STATE
+				if (hasPendingChildren(currentNode, states))
+				{
+					const uint32_t child = getNextChild(currentNode, states);
+					states[child].flags |= CompiledNodeState::ON_STACK;
+					currentState = ExecutionState::PUSHED_CHILD;
+					inst.currentNode = child;
+					nodesVisited++;
+				}
+				else if (resultReady(currentNode, states))
+				{
+					bNodeCompletedSuccessfully = result(currentNode, states);
+					resetNode(instance, currentNode, states, delta_sec);
+					if (currentNode != CompiledTreeDefinition::TREE_NODE) { inst.currentNode = nodes[currentNode].parent; }
+					else { nodesVisited++; }
+					bReachedMaxNodesThisTick = nodesVisited >= numNodes;
+					currentState = ExecutionState::POPPED_CHILD;
+				}
+				else
+				{
+					currentState = ExecutionState::CHILD_EXECUTING;
+				}
+
+				processAborts(instance, states, currentState, delta_sec);
+			}
+
+			inst.bHasResumeData = true;
+			inst.resumeState = currentState;
+			inst.bResumeChildResult = bNodeCompletedSuccessfully;
+		}
+
+		void CompiledTreeGroup::tickRunningBehaviors(uint32_t instance, CompiledNodeState* states, float delta_sec)
+		{
+			const uint32_t currentNode = instances[instance].currentNode;
+
+			//services run while anything below them is on the execution path
+			dueServices.clear();
+			for (uint32_t nodeIdx = currentNode; nodeIdx != CompiledTreeDefinition::TREE_NODE; nodeIdx = nodes[nodeIdx].parent)
+			{
+				CompiledNodeState& state = states[nodeIdx];
+				if (nodes[nodeIdx].type == CompiledNodeType::SERVICE && (state.flags & CompiledNodeState::STARTED))
+				{
+					state.timerSec -= delta_sec;
+					if (state.timerSec < 0.f)
+					{
+						dueServices.push_back(nodeIdx);
+					}
+				}
+			}
+
+			//same order as TimerWheel::fireSlot; earliest expiry first, ties go to the older timer, which is the outer service
+			std::sort(dueServices.begin(), dueServices.end(),
+				[states](uint32_t a, uint32_t b)
+				{
+					return states[a].timerSec != states[b].timerSec ? states[a].timerSec < states[b].timerSec : a < b;
+				});
+
+			for (uint32_t nodeIdx : dueServices)
+			{
+				//like TimerWheel::fire, a looping timer fires as many times as it came due
+				const Node& node = nodes[nodeIdx];
+				CompiledNodeState& state = states[nodeIdx];
+				while ((state.flags & CompiledNodeState::STARTED) && state.timerSec < 0.f)
+				{
+					if (node.bLoop) { state.timerSec = node.tickSecs > 0.f ? state.timerSec + node.tickSecs : 0.f; }
+					else { state.flags &= ~CompiledNodeState::STARTED; }
+
+					CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+					definition->services[node.behaviorIdx]->tick(context);
+				}
+			}
+
+			//only the current node can be waiting on a deferred result
+			if (currentNode != CompiledTreeDefinition::TREE_NODE)
+			{
+				const Node& node = nodes[currentNode];
+				CompiledNodeState& state = states[currentNode];
+				if ((state.flags & CompiledNodeState::STARTED) && !(state.flags & CompiledNodeState::HAS_RESULT))
+				{
+					CompiledStatus status = CompiledStatus::RUNNING;
+					CompiledNodeContext context = makeContext(instance, currentNode, states, delta_sec);
+					if (node.type == CompiledNodeType::TASK) { status = definition->tasks[node.behaviorIdx]->poll(context); }
+					else if (node.type == CompiledNodeType::DECORATOR) { status = definition->conditions[node.behaviorIdx]->poll(context); }
+
+					if (status != CompiledStatus::RUNNING)
+					{
+						state.flags |= CompiledNodeState::HAS_RESULT | (status == CompiledStatus::SUCCEEDED ? CompiledNodeState::RESULT : 0);
+					}
+				}
+			}
+
+			//covers memory written outside of tree execution
+			checkWatchedKeys(instance, states, delta_sec);
+		}
+
+		void CompiledTreeGroup::processAborts(uint32_t instance, CompiledNodeState* states, ExecutionState& inOut_currentState, float delta_sec)
+		{
+			CompiledInstanceState& inst = instances[instance];
+			if (inst.bAborting)
+			{
+				while (getPriority(inst.currentNode) >= inst.abortPriority
+					&& inst.currentNode != CompiledTreeDefinition::TREE_NODE)
+				{
+					handleNodeAborted(instance, inst.currentNode, states, delta_sec);
+					resetNode(instance, inst.currentNode, states, delta_sec);
+					inst.currentNode = nodes[inst.currentNode].parent;
+				}
+				inst.bAborting = false;
+
+				resetNode(instance, inst.currentNode, states, delta_sec);
+				inOut_currentState = ExecutionState::PUSHED_CHILD;
+			}
+		}
+
+		void CompiledTreeGroup::checkWatchedKeys(uint32_t instance, CompiledNodeState* states, float delta_sec)
+		{
+			const Memory& memory = *memories[instance];
+			for (uint32_t nodeIdx : definition->watchingNodes)
+			{
+				const Node& node = nodes[nodeIdx];
+				CompiledNodeState& state = states[nodeIdx];
+				const uint32_t version = memory.getVersion(node.watchedKey);
+				if (version == state.aux)
+				{
+					continue;
+				}
+				state.aux = version;
+
+				CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+				const CompiledStatus status = definition->conditions[node.behaviorIdx]->check(context);
+
+				//same rules as Decorator::abortTree
+				const bool bAbortsChild = node.abortType == Decorator::AbortType::ChildTree || node.abortType == Decorator::AbortType::ChildAndLowerPriortyTrees;
+				const bool bAbortsLower = node.abortType == Decorator::AbortType::LowerPriortyTrees || node.abortType == Decorator::AbortType::ChildAndLowerPriortyTrees;
+				if (state.flags & CompiledNodeState::ON_STACK)
+				{
+					if (bAbortsChild && status == CompiledStatus::FAILED)
+					{
+						abort(instance, nodeIdx);
+					}
+				}
+				else if (bAbortsLower && status == CompiledStatus::SUCCEEDED && getCurrentPriority(instance) > nodeIdx)
+				{
+					abort(instance, nodeIdx + 1);
+				}
+			}
+		}
+
+		CompiledNodeContext CompiledTreeGroup::makeContext(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec)
+		{
+			return CompiledNodeContext{ *this, *memories[instance], instance, nodeIdx, delta_sec, states[nodeIdx].value };
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Node state machine methods; each case matches the virtual of the interpreter node type.
+		/////////////////////////////////////////////////////////////////////////////////////
+		bool CompiledTreeGroup::isProcessing(uint32_t nodeIdx, CompiledNodeState* states)
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return false;
+			}
+
+			CompiledNodeState& state = states[nodeIdx];
+			switch (nodes[nodeIdx].type)
+			{
+				case CompiledNodeType::DECORATOR:
+				case CompiledNodeType::TASK:
+					return (state.flags & CompiledNodeState::STARTED) && !(state.flags & CompiledNodeState::HAS_RESULT);
+				case CompiledNodeType::LOOP:
+				{
+					//limits the loop body to once per tick; see Loop::isProcessing
+					const bool bAlreadyTickedThisFrame = state.aux == tickNumber;
+					state.aux = tickNumber;
+					return bAlreadyTickedThisFrame;
+				}
+				default:
+					return false;
+			}
+		}
+
+		bool CompiledTreeGroup::hasPendingChildren(uint32_t nodeIdx, const CompiledNodeState* states) const
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return true;
+			}
+
+			const Node& node = nodes[nodeIdx];
+			const CompiledNodeState& state = states[nodeIdx];
+			const bool bChildReturned = state.flags & CompiledNodeState::CHILD_RETURNED;
+			const bool bChildResult = state.flags & CompiledNodeState::CHILD_RESULT;
+			const uint32_t lastChild = node.childEnd - node.childBegin - 1;
+			switch (node.type)
+			{
+				case CompiledNodeType::SELECTOR:
+					return bChildReturned ? (!bChildResult && state.value != lastChild) : true;
+				case CompiledNodeType::SEQUENCE:
+					return bChildReturned ? (bChildResult && state.value != lastChild) : true;
+				case CompiledNodeType::DECORATOR:
+					assert(state.flags & CompiledNodeState::STARTED);
+					return !bChildReturned && (state.flags & CompiledNodeState::HAS_RESULT) && (state.flags & CompiledNodeState::RESULT);
+				case CompiledNodeType::SERVICE:
+					return !bChildReturned;
+				case CompiledNodeType::LOOP:
+					return !resultReady(nodeIdx, states);
+				case CompiledNodeType::RANDOM:
+					return !(state.flags & CompiledNodeState::HAS_RESULT);
+				case CompiledNodeType::TASK:
+				default:
+					return false;
+			}
+		}
+
+		bool CompiledTreeGroup::resultReady(uint32_t nodeIdx, const CompiledNodeState* states) const
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return false;
+			}
+
+			const Node& node = nodes[nodeIdx];
+			const CompiledNodeState& state = states[nodeIdx];
+			switch (node.type)
+			{
+				case CompiledNodeType::SELECTOR:
+				case CompiledNodeType::SEQUENCE:
+					return !hasPendingChildren(nodeIdx, states);
+				case CompiledNodeType::DECORATOR:
+				case CompiledNodeType::TASK:
+					return !((state.flags & CompiledNodeState::STARTED) && !(state.flags & CompiledNodeState::HAS_RESULT));
+				case CompiledNodeType::LOOP:
+					return node.numLoops == 0 ? false : state.value >= node.numLoops; //infinite loops only end by aborting
+				case CompiledNodeType::SERVICE:
+				case CompiledNodeType::RANDOM:
+				default:
+					return state.flags & CompiledNodeState::CHILD_RETURNED;
+			}
+		}
+
+		bool CompiledTreeGroup::result(uint32_t nodeIdx, const CompiledNodeState* states) const
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return true;
+			}
+
+			const CompiledNodeState& state = states[nodeIdx];
+			if (nodes[nodeIdx].type == CompiledNodeType::TASK)
+			{
+				assert(state.flags & CompiledNodeState::HAS_RESULT);
+				return state.flags & CompiledNodeState::RESULT;
+			}
+			return state.flags & CompiledNodeState::CHILD_RESULT;
+		}
+
+		uint32_t CompiledTreeGroup::getNextChild(uint32_t nodeIdx, CompiledNodeState* states)
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return 0; //root
+			}
+
+			const Node& node = nodes[nodeIdx];
+			CompiledNodeState& state = states[nodeIdx];
+			const bool bChildReturned = state.flags & CompiledNodeState::CHILD_RETURNED;
+			const bool bChildResult = state.flags & CompiledNodeState::CHILD_RESULT;
+			switch (node.type)
+			{
+				case CompiledNodeType::SELECTOR:
+				case CompiledNodeType::SEQUENCE:
+				{
+					//selectors move on when a child failed, sequences when it succeeded
+					const bool bMoveOn = node.type == CompiledNodeType::SELECTOR ? !bChildResult : bChildResult;
+					if (bChildReturned && bMoveOn && state.value < node.childEnd - node.childBegin - 1)
+					{
+						state.value++;
+						state.flags &= ~(CompiledNodeState::CHILD_RETURNED | CompiledNodeState::CHILD_RESULT);
+					}
+					return definition->childIndices[node.childBegin + state.value];
+				}
+				case CompiledNodeType::RANDOM:
+				{
+					//same draw as Random::getNextChild, so both engines make the same choices from equally seeded generators
+					state.value = uint32_t(rng->getInt<size_t>(0, size_t(node.chanceEnd - node.chanceBegin) - 1));
+					state.flags |= CompiledNodeState::HAS_RESULT;
+					return definition->chanceBuckets[node.chanceBegin + state.value];
+				}
+				default:
+					return definition->childIndices[node.childBegin];
+			}
+		}
+
+		void CompiledTreeGroup::notifyCurrentChildResult(uint32_t nodeIdx, CompiledNodeState* states, bool childResult)
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE || nodes[nodeIdx].type == CompiledNodeType::TASK)
+			{
+				return;
+			}
+
+			CompiledNodeState& state = states[nodeIdx];
+			if (nodes[nodeIdx].type == CompiledNodeType::LOOP)
+			{
+				state.value++;
+			}
+			state.flags |= CompiledNodeState::CHILD_RETURNED;
+			state.flags = childResult ? (state.flags | CompiledNodeState::CHILD_RESULT) : (state.flags & ~CompiledNodeState::CHILD_RESULT);
+		}
+
+		void CompiledTreeGroup::evaluate(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec)
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return;
+			}
+
+			const Node& node = nodes[nodeIdx];
+			CompiledNodeState& state = states[nodeIdx];
+			CompiledStatus status = CompiledStatus::RUNNING;
+			switch (node.type)
+			{
+				case CompiledNodeType::DECORATOR:
+				{
+					state.flags |= CompiledNodeState::STARTED;
+					CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+					status = definition->conditions[node.behaviorIdx]->check(context);
+					break;
+				}
+				case CompiledNodeType::TASK:
+				{
+					state.flags |= CompiledNodeState::STARTED;
+					CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+					status = definition->tasks[node.behaviorIdx]->begin(context);
+					break;
+				}
+				case CompiledNodeType::SERVICE:
+				{
+					//services tick once on start, then at their tick rate
+					state.flags |= CompiledNodeState::STARTED;
+					state.timerSec = node.tickSecs;
+					CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+					definition->services[node.behaviorIdx]->start(context);
+					definition->services[node.behaviorIdx]->tick(context);
+					break;
+				}
+				default:
+					return; //nothing to evaluate; no behavior ran
+			}
+
+			if (status != CompiledStatus::RUNNING)
+			{
+				state.flags |= CompiledNodeState::HAS_RESULT | (status == CompiledStatus::SUCCEEDED ? CompiledNodeState::RESULT : 0);
+			}
+			checkWatchedKeys(instance, states, delta_sec);
+		}
+
+		void CompiledTreeGroup::resetNode(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec)
+		{
+			if (nodeIdx == CompiledTreeDefinition::TREE_NODE)
+			{
+				return;
+			}
+
+			const Node& node = nodes[nodeIdx];
+			CompiledNodeState& state = states[nodeIdx];
+			switch (node.type)
+			{
+				case CompiledNodeType::SELECTOR:
+				case CompiledNodeType::SEQUENCE:
+				case CompiledNodeType::LOOP:
+					state.value = 0;
+					state.flags = 0;
+					break;
+				case CompiledNodeType::DECORATOR:
+					state.flags = 0;
+					break;
+				case CompiledNodeType::RANDOM:
+					state.flags &= CompiledNodeState::ON_STACK; //Random::resetNode leaves the execution stack flag alone
+					break;
+				case CompiledNodeType::SERVICE:
+				{
+					//Service::resetNode only resets the base node, so the child result is kept
+					state.flags &= ~(CompiledNodeState::ON_STACK | CompiledNodeState::STARTED);
+					CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+					definition->services[node.behaviorIdx]->stop(context);
+					checkWatchedKeys(instance, states, delta_sec);
+					break;
+				}
+				case CompiledNodeType::TASK:
+				{
+					CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+					definition->tasks[node.behaviorIdx]->cleanup(context);
+					state.flags = 0;
+					checkWatchedKeys(instance, states, delta_sec);
+					break;
+				}
+			}
+		}
+
+		void CompiledTreeGroup::handleNodeAborted(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec)
+		{
+			const Node& node = nodes[nodeIdx];
+			if (node.type == CompiledNodeType::TASK)
+			{
+				CompiledNodeContext context = makeContext(instance, nodeIdx, states, delta_sec);
+				definition->tasks[node.behaviorIdx]->abort(context);
+				checkWatchedKeys(instance, states, delta_sec);
+			}
+		}
+	}
+}
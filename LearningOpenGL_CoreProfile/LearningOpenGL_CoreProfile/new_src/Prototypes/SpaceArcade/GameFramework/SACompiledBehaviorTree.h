@@ -0,0 +1,271 @@
+#pragma once
+#include "SABehaviorTree.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace SA
+{
+	namespace BehaviorTree
+	{
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Compiled behavior trees
+		//
+		//	A tree definition is flattened once into a contiguous node array (pre-order, so a node's index is the same
+		//	priority the interpreter gives it) with child ranges into a shared index array. Every brain running that
+		//	definition only owns a small block of plain per-node state and its memory; a CompiledTreeGroup keeps all of
+		//	those blocks for one definition together and ticks them in a single loop.
+		//
+		//	The state machine mirrors Tree::tick step for step. Differences from the interpreter:
+		//		-behaviors are shared by every instance, so per-instance task state lives in memory or the node's userValue.
+		//		-deferred tasks and conditions are polled at the start of the tick rather than completed by timers.
+		//		-service timers count down group tick time rather than using the level's TimeManager; they fire with the
+		//			same rules as TimerWheel (strictly after expiry, in expiry order, looping timers as often as fit in a tick).
+		//		-decorators watching a memory key compare the key's version after each behavior callback instead of
+		//			subscribing to memory delegates; several writes within one callback are seen as one change.
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		class CompiledTreeGroup;
+
+		enum class CompiledNodeType : uint8_t { SELECTOR, SEQUENCE, DECORATOR, SERVICE, LOOP, RANDOM, TASK };
+
+		/** RUNNING means the task or condition will finish on a later tick; it is polled at the start of each tick until it does. */
+		enum class CompiledStatus : uint8_t { RUNNING, SUCCEEDED, FAILED };
+
+		/** What a behavior callback can see of the instance it is running for. */
+		struct CompiledNodeContext
+		{
+			CompiledTreeGroup& group;
+			Memory& memory;
+			uint32_t instance;
+			uint32_t node;
+			float dt_sec;
+			uint32_t& userValue; //per instance, per node storage; free for tasks, services and conditions to use
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Behaviors shared by every instance of a compiled tree; must not hold per-instance state.
+		/////////////////////////////////////////////////////////////////////////////////////
+		class CompiledTask
+		{
+		public:
+			virtual ~CompiledTask() = default;
+			virtual CompiledStatus begin(CompiledNodeContext& context) = 0;
+			virtual CompiledStatus poll(CompiledNodeContext& context) { return CompiledStatus::RUNNING; }
+			virtual void abort(CompiledNodeContext& context) {}		//called before cleanup when the task is aborted
+			virtual void cleanup(CompiledNodeContext& context) {}	//called whenever the node is reset, like Task::taskCleanup
+		};
+
+		class CompiledCondition
+		{
+		public:
+			virtual ~CompiledCondition() = default;
+			virtual CompiledStatus check(CompiledNodeContext& context) = 0;
+			virtual CompiledStatus poll(CompiledNodeContext& context) { return CompiledStatus::RUNNING; }
+		};
+
+		class CompiledService
+		{
+		public:
+			virtual ~CompiledService() = default;
+			virtual void start(CompiledNodeContext& context) {}
+			virtual void tick(CompiledNodeContext& context) = 0;
+			virtual void stop(CompiledNodeContext& context) {}
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Memory keys used by a compiled tree. Every instance interns these first and in order,
+		//		so a key returned here is valid in every instance's memory.
+		/////////////////////////////////////////////////////////////////////////////////////
+		class CompiledMemoryLayout
+		{
+		public:
+			MemoryKey add(const std::string& keyName);
+			MemoryKey find(const std::string& keyName) const;
+			const std::vector<std::string>& getKeyNames() const { return keyNames; }
+			void internInto(Memory& memory) const;
+		private:
+			std::vector<std::string> keyNames;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Tree description that gets compiled; reads like nested node construction.
+		/////////////////////////////////////////////////////////////////////////////////////
+		struct CompiledNodeDef
+		{
+			static CompiledNodeDef selector(const std::string& name, const std::vector<CompiledNodeDef>& children);
+			static CompiledNodeDef sequence(const std::string& name, const std::vector<CompiledNodeDef>& children);
+			static CompiledNodeDef decorator(const std::string& name, const sp<CompiledCondition>& condition, const CompiledNodeDef& child);
+			/** Re-checks the condition whenever watchedKey changes and aborts like Decorator::abortTree: the child tree if the
+				condition now fails while running, lower priority trees if it now passes while they run. */
+			static CompiledNodeDef abortingDecorator(const std::string& name, const sp<CompiledCondition>& condition, MemoryKey watchedKey, Decorator::AbortType abortType, const CompiledNodeDef& child);
+			static CompiledNodeDef service(const std::string& name, const sp<CompiledService>& service, float tickSecs, bool bLoop, const CompiledNodeDef& child);
+			/** 0 loops means loop forever */
+			static CompiledNodeDef loop(const std::string& name, uint32_t numLoops, const CompiledNodeDef& child);
+			/** chancePoints are per child, in child order; see Random::ChildChance */
+			static CompiledNodeDef random(const std::string& name, const std::vector<uint32_t>& chancePoints, const std::vector<CompiledNodeDef>& children);
+			static CompiledNodeDef task(const std::string& name, const sp<CompiledTask>& task);
+
+			std::string name;
+			CompiledNodeType type = CompiledNodeType::TASK;
+			std::vector<CompiledNodeDef> children;
+			sp<CompiledTask> taskBehavior;
+			sp<CompiledCondition> conditionBehavior;
+			sp<CompiledService> serviceBehavior;
+			MemoryKey watchedKey;
+			Decorator::AbortType abortType = Decorator::AbortType::ChildTree;
+			float tickSecs = 0.1f;
+			bool bLoop = true;
+			uint32_t numLoops = 1;
+			std::vector<uint32_t> chancePoints;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// A flattened tree; immutable once compiled and shared by every instance running it.
+		/////////////////////////////////////////////////////////////////////////////////////
+		class CompiledTreeDefinition
+		{
+		public:
+			static constexpr uint32_t TREE_NODE = std::numeric_limits<uint32_t>::max(); //stands in for the Tree node at the bottom of the execution stack
+
+			struct Node
+			{
+				uint32_t parent = TREE_NODE;
+				uint32_t childBegin = 0;		//range into childIndices
+				uint32_t childEnd = 0;
+				uint32_t chanceBegin = 0;		//range into chanceBuckets; random nodes only
+				uint32_t chanceEnd = 0;
+				uint32_t behaviorIdx = 0;		//index into the array matching the node type
+				uint32_t numLoops = 0;
+				float tickSecs = 0.f;
+				MemoryKey watchedKey;
+				CompiledNodeType type = CompiledNodeType::TASK;
+				Decorator::AbortType abortType = Decorator::AbortType::ChildTree;
+				bool bLoop = false;
+			};
+
+		public:
+			static sp<const CompiledTreeDefinition> compile(const std::string& name, const CompiledNodeDef& root, const CompiledMemoryLayout& memoryLayout);
+
+			const std::string& getName() const { return name; }
+			uint32_t getNumNodes() const { return uint32_t(nodes.size()); }
+			const Node& getNode(uint32_t nodeIdx) const { return nodes[nodeIdx]; }
+			const std::string& getNodeName(uint32_t nodeIdx) const { return nodeNames[nodeIdx]; }
+			uint32_t findNode(const std::string& nodeName) const;
+			const CompiledMemoryLayout& getMemoryLayout() const { return memoryLayout; }
+
+		private:
+			friend class CompiledTreeGroup;
+			uint32_t flatten(const CompiledNodeDef& def, uint32_t parent);
+
+		private:
+			std::string name;
+			std::vector<Node> nodes;
+			std::vector<std::string> nodeNames;
+			std::vector<uint32_t> childIndices;
+			std::vector<uint32_t> chanceBuckets;	//child node indices repeated by chance points
+			std::vector<uint32_t> watchingNodes;	//decorators with a watched key
+			std::vector<sp<CompiledTask>> tasks;
+			std::vector<sp<CompiledCondition>> conditions;
+			std::vector<sp<CompiledService>> services;
+			CompiledMemoryLayout memoryLayout;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Plain per-instance state; one per node per instance, stored contiguously per instance.
+		/////////////////////////////////////////////////////////////////////////////////////
+		struct CompiledNodeState
+		{
+			enum Flags : uint8_t
+			{
+				ON_STACK = 1 << 0,
+				STARTED = 1 << 1,			//task begun, decorator checking, service timer running
+				HAS_RESULT = 1 << 2,		//task result or decorator condition available; random has a choice
+				RESULT = 1 << 3,
+				CHILD_RETURNED = 1 << 4,
+				CHILD_RESULT = 1 << 5,
+			};
+			uint32_t value = 0;		//child index for selectors/sequences; loop count; random choice; userValue for leaf behaviors
+			uint32_t aux = 0;		//last tick a loop ran; version a decorator last saw of its watched key
+			float timerSec = 0.f;	//time until a service's next tick
+			uint8_t flags = 0;
+		};
+
+		struct CompiledInstanceState
+		{
+			uint32_t currentNode = CompiledTreeDefinition::TREE_NODE;
+			uint32_t abortPriority = 0;
+			ExecutionState resumeState = ExecutionState::STARTING;
+			bool bHasResumeData = false;
+			bool bResumeChildResult = false;
+			bool bAborting = false;
+			bool bExecuting = false;
+			bool bAlive = false;
+		};
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// All instances of one compiled tree, ticked together.
+		/////////////////////////////////////////////////////////////////////////////////////
+		class CompiledTreeGroup
+		{
+		public:
+			/** Random nodes draw from rng the same way Random does; null takes a time influenced generator from the RNG system if the tree has random nodes. */
+			CompiledTreeGroup(const sp<const CompiledTreeDefinition>& definition, const sp<RNG>& rng = nullptr);
+
+			/** Creates memory with the definition's keys, then the initialized values, like the Tree constructor. Indices of removed instances are reused. */
+			uint32_t addInstance(const MemoryInitializer& initializedMemory = {});
+			void removeInstance(uint32_t instance);
+
+			void start(uint32_t instance);
+			void stop(uint32_t instance);
+			/* Aborts all nodes with this priority or larger magnitude values; see Tree::abort */
+			void abort(uint32_t instance, uint32_t priority);
+			/** Ticks every executing instance once */
+			void tick(float delta_sec);
+
+			uint32_t getCurrentPriority(uint32_t instance) const;
+			Memory& getMemory(uint32_t instance) const { return *memories[instance]; }
+			bool isExecuting(uint32_t instance) const { return instances[instance].bExecuting; }
+			size_t getNumInstances() const { return instances.size() - freeInstances.size(); }
+			const CompiledTreeDefinition& getDefinition() const { return *definition; }
+
+		private:
+			using Node = CompiledTreeDefinition::Node;
+
+			void tickInstance(uint32_t instance, float delta_sec);
+			void tickRunningBehaviors(uint32_t instance, CompiledNodeState* states, float delta_sec);
+			void processAborts(uint32_t instance, CompiledNodeState* states, ExecutionState& inOut_currentState, float delta_sec);
+			void checkWatchedKeys(uint32_t instance, CompiledNodeState* states, float delta_sec);
+
+			bool isProcessing(uint32_t nodeIdx, CompiledNodeState* states);
+			bool hasPendingChildren(uint32_t nodeIdx, const CompiledNodeState* states) const;
+			bool resultReady(uint32_t nodeIdx, const CompiledNodeState* states) const;
+			bool result(uint32_t nodeIdx, const CompiledNodeState* states) const;
+			uint32_t getNextChild(uint32_t nodeIdx, CompiledNodeState* states);
+			void notifyCurrentChildResult(uint32_t nodeIdx, CompiledNodeState* states, bool childResult);
+			void evaluate(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec);
+			void resetNode(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec);
+			void handleNodeAborted(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec);
+
+			uint32_t getPriority(uint32_t nodeIdx) const { return nodeIdx == CompiledTreeDefinition::TREE_NODE ? 0 : nodeIdx; }
+			CompiledNodeState* getStates(uint32_t instance) { return nodeStates.data() + size_t(instance) * numNodes; }
+			CompiledNodeContext makeContext(uint32_t instance, uint32_t nodeIdx, CompiledNodeState* states, float delta_sec);
+
+		private:
+			sp<const CompiledTreeDefinition> definition;
+			const Node* nodes = nullptr;
+			uint32_t numNodes = 0;
+
+			std::vector<CompiledInstanceState> instances;
+			std::vector<CompiledNodeState> nodeStates;	//numNodes entries per instance
+			std::vector<sp<Memory>> memories;
+			std::vector<uint32_t> freeInstances;
+
+			std::vector<uint32_t> dueServices;	//scratch for tickRunningBehaviors
+
+			sp<RNG> rng;
+			uint32_t tickNumber = 0;
+		};
+	}
+}
@@ -11,6 +11,7 @@
 #include "../Tools/Geometry/SimpleShapes.h" //#TODO remove this once the sphereutils is mvoed to another file and include that.
 #include "../Tools/SAUtilities.h"
 #include "SARenderSystem.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -25,6 +26,11 @@ namespace SA
 		gameBase.onFrameOver.addWeakObj(sp_this(), &DebugRenderSystem::handleFrameOver);
 	}
 
+	void DebugRenderSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		outDependencies.bThreadSafeTick = true; //debug shapes are drawn on render dispatch and expire on frame over
+	}
+
 	void DebugRenderSystem::handleRenderDispatch(float dt_sec_system)
 	{
 		if (FrameData_VisualDebugging* readFrame = frameSwitcher.getReadFrame())
@@ -272,6 +272,7 @@ namespace SA
 		void renderRay(const glm::vec3& dir, const glm::vec3& start, const glm::vec3 color);
 	private:
 		virtual void initSystem() override;
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 		virtual void handleRenderDispatch(float dt_sec_system);
 		virtual void handleFrameOver(uint64_t endingFrameNumber);
 		void writeTimedDataToFrame();
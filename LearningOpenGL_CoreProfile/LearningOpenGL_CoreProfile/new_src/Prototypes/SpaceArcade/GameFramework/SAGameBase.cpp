@@ -20,8 +20,13 @@
 #include "TimeManagement/TickGroupManager.h"
 #include "../Tools/PlatformUtils.h"
 #include "SAAudioSystem.h"
+#include "Jobs/JobSystem.h"
+#include "Jobs/SystemTickGraph.h"
+#include "SATickProfiler.h"
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <typeinfo>
 #include "../../../../Libraries/nlohmann/json.hpp"
 
 namespace SA
@@ -70,9 +75,14 @@ namespace SA
 		{
 			onInitEngineConstants(configuredConstants);	//this should happen before the subclass game has started. this means systems can read it.
 			registerTickGroups();						//tick groups created very early, these are effectively static and not intended to be initialized with dnyamic logic from systems. Thus these are created before systems.
+
+			size_t numJobWorkers = configuredConstants.JOB_WORKER_THREADS >= 0 ? size_t(configuredConstants.JOB_WORKER_THREADS) : size_t(std::max(1u, std::thread::hardware_concurrency()) - 1);
+			jobSystem = new_sp<JobSystem>(numJobWorkers, configuredConstants.DETERMINISTIC_JOBS); //available to systems from their ctors onward
+
 			createEngineSystems();
 			//systems are initialized after all systems have been created; this way cross-system interaction can be achieved during initailization (ie subscribing to events, etc.)
 			for (const sp<SystemBase>& system : systems) { system->initSystem(); }
+			buildSystemTickGraph();
 
  			windowSystem->makeWindowPrimary(makeInitialWindow());
 			startUp();
@@ -96,6 +106,7 @@ namespace SA
 			for (size_t shutdownTick = 0; shutdownTick < 3; ++shutdownTick){ tickGameloop_GameBase(); }
 
 			onShutdownGameloopTicksOver.broadcast();
+			jobSystem->stop();
 		}
 	}
 
@@ -114,30 +125,47 @@ namespace SA
 
 	void GameBase::tickGameloop_GameBase()
 	{
-		timeSystem.updateTime(TimeSystem::PrivateKey{});
-		float deltaTimeSecs = systemTimeManager->getDeltaTimeSecs();
+		{ //profiled frame; does not include the frame over broadcast, which is where a profiler's frame is closed
+			static const TickProfiler::LabelId frameLabel = TickProfiler::internLabel("Frame");
+			TickProfiler::Scope frameScope(frameLabel);
 
-		GameEntity::cleanupPendingDestroy(GameEntity::CleanKey{});
+			float deltaTimeSecs = 0.f;
+			{
+				//timers, tickers and tick groups of every time manager; this is where ai and ships tick
+				static const TickProfiler::LabelId timeSystemLabel = TickProfiler::internLabel("TimeSystem");
+				TickProfiler::Scope timeScope(timeSystemLabel);
+				timeSystem.updateTime(TimeSystem::PrivateKey{});
+				deltaTimeSecs = systemTimeManager->getDeltaTimeSecs();
+			}
 
-		//the engine will tick a few times after shutdown to clean up deferred tasks.
-		if (!bExitGame)
-		{
-			//#consider having system pass a reference to the system time manager, rather than a float; That way critical systems can ignore manipulation time effects or choose to use time affects. Passing raw time means systems will be forced to use time effects (such as dilation)
-			for (const sp<SystemBase>& system : systems) { system->tick(deltaTimeSecs);	}
-
-			//NOTE: there probably needs to be a priority based pre/post loop; but not needed yet so it is not implemented (priorities should probably be defined in a single file via template specliazations)
-			onPreGameloopTick.broadcast(deltaTimeSecs);
-			tickGameLoop(deltaTimeSecs);
-			onPostGameloopTick.broadcast(deltaTimeSecs);
-
-			cacheRenderDataForCurrentFrame(*renderSystem->getFrameRenderData_Write(frameNumber, identityKey));
-			renderLoop_begin(deltaTimeSecs);
-			onRenderDispatch.broadcast(deltaTimeSecs); //perhaps this needs to be a sorted structure with prioritizes; but that may get hard to maintain. Needs to be a systematic way for UI to come after other rendering.
-			renderLoop_end(deltaTimeSecs);
-			onRenderDispatchEnded.broadcast(deltaTimeSecs); 
-
-			//perhaps this should be a subscription service since few systems care about post render //TODO this sytem should probably be removed and instead just subscribe to delegate
-			for (const sp<SystemBase>& system : postRenderNotifys) { system->handlePostRender();}
+			GameEntity::cleanupPendingDestroy(GameEntity::CleanKey{});
+
+			//the engine will tick a few times after shutdown to clean up deferred tasks.
+			if (!bExitGame)
+			{
+				//#consider having system pass a reference to the system time manager, rather than a float; That way critical systems can ignore manipulation time effects or choose to use time affects. Passing raw time means systems will be forced to use time effects (such as dilation)
+				systemTickGraph->tick(*jobSystem, deltaTimeSecs); //systems whose declared dependencies do not conflict may tick in parallel
+
+				//NOTE: there probably needs to be a priority based pre/post loop; but not needed yet so it is not implemented (priorities should probably be defined in a single file via template specliazations)
+				{
+					static const TickProfiler::LabelId gameloopLabel = TickProfiler::internLabel("Gameloop");
+					TickProfiler::Scope gameloopScope(gameloopLabel);
+					onPreGameloopTick.broadcast(deltaTimeSecs);
+					tickGameLoop(deltaTimeSecs);
+					onPostGameloopTick.broadcast(deltaTimeSecs);
+				}
+
+				static const TickProfiler::LabelId renderLabel = TickProfiler::internLabel("Render");
+				TickProfiler::Scope renderScope(renderLabel);
+				cacheRenderDataForCurrentFrame(*renderSystem->getFrameRenderData_Write(frameNumber, identityKey));
+				renderLoop_begin(deltaTimeSecs);
+				onRenderDispatch.broadcast(deltaTimeSecs); //perhaps this needs to be a sorted structure with prioritizes; but that may get hard to maintain. Needs to be a systematic way for UI to come after other rendering.
+				renderLoop_end(deltaTimeSecs);
+				onRenderDispatchEnded.broadcast(deltaTimeSecs); 
+
+				//perhaps this should be a subscription service since few systems care about post render //TODO this sytem should probably be removed and instead just subscribe to delegate
+				for (const sp<SystemBase>& system : postRenderNotifys) { system->handlePostRender();}
+			}
 		}
 
 		//broadcast current frame and increment the frame number.
@@ -155,49 +183,80 @@ namespace SA
 
 		//create and register systems
 		windowSystem = new_sp<WindowSystem>();
-		systems.insert(windowSystem);
+		registerSystem(windowSystem);
 
 		assetSystem = new_sp<AssetSystem>();
-		systems.insert(assetSystem);
+		registerSystem(assetSystem);
 
 		levelSystem = new_sp<LevelSystem>();
-		systems.insert(levelSystem);
+		registerSystem(levelSystem);
 
 		playerSystem = new_sp<PlayerSystem>();
-		systems.insert(playerSystem);
+		registerSystem(playerSystem);
 
 		particleSystem = new_sp<ParticleSystem>();
-		systems.insert(particleSystem);
+		registerSystem(particleSystem);
 
 		systemRNG = new_sp<RNGSystem>();
-		systems.insert(systemRNG);
+		registerSystem(systemRNG);
 
 		debugRenderSystem = new_sp<DebugRenderSystem>();
-		systems.insert(debugRenderSystem);
+		registerSystem(debugRenderSystem);
 
 		renderSystem = new_sp<RenderSystem>();
-		systems.insert(renderSystem);
-
-		automatedTestSystem = new_sp<AutomatedTestSystem>();
-		systems.insert(automatedTestSystem);
+		registerSystem(renderSystem);
 
 		cheatSystem = createCheatSystemSubclass();
 		cheatSystem = cheatSystem ? cheatSystem : new_sp<CheatSystemBase>();
-		systems.insert(cheatSystem);
+		registerSystem(cheatSystem);
 
 		curveSystem = createCurveSystemSubclass();
 		curveSystem = curveSystem ? curveSystem : new_sp<CurveSystem>();
-		systems.insert(curveSystem);
+		registerSystem(curveSystem);
 
 		audioSystem = createAudioSystemSubclass();
 		audioSystem = audioSystem ? audioSystem : new_sp<AudioSystem>();
-		systems.insert(audioSystem);
+		registerSystem(audioSystem);
 
 		//initialize custom subclass systems; 
 		//ctor warning: this is not done in gamebase ctor because it systems may call gamebase virtuals
 		bCustomSystemRegistrationAllowedTimeWindow = true;
 		onRegisterCustomSystem();
 		bCustomSystemRegistrationAllowedTimeWindow = false;
+
+		//live tests may touch anything, so their tick waits for every other system; registered last so that does not hold back the systems before it
+		automatedTestSystem = new_sp<AutomatedTestSystem>();
+		registerSystem(automatedTestSystem);
+	}
+
+	void GameBase::registerSystem(const sp<SystemBase>& system)
+	{
+		if (std::find(systems.begin(), systems.end(), system) == systems.end())
+		{
+			systems.push_back(system);
+		}
+	}
+
+	void GameBase::buildSystemTickGraph()
+	{
+		systemTickGraph = new_sp<SystemTickGraph>();
+		for (const sp<SystemBase>& system : systems)
+		{
+			SystemTickDependencies tickDependencies;
+			system->declareTickDependencies(tickDependencies);
+
+			//profiled under the class name; msvc names read "class SA::LevelSystem"
+			std::string profileLabel = typeid(*system).name();
+			size_t namespaceEnd = profileLabel.rfind("::");
+			profileLabel = namespaceEnd != std::string::npos ? profileLabel.substr(namespaceEnd + 2) : profileLabel;
+
+			const TickProfiler::LabelId profileLabelId = TickProfiler::internLabel(profileLabel);
+			systemTickGraph->addSystem([system, profileLabelId](float deltaSec)
+			{
+				TickProfiler::Scope systemScope(profileLabelId);
+				system->tick(deltaSec);
+			}, tickDependencies, profileLabel);
+		}
 	}
 
 	sp<SA::CurveSystem> GameBase::createCurveSystemSubclass()
@@ -263,7 +322,7 @@ namespace SA
 	{
 		if (bCustomSystemRegistrationAllowedTimeWindow)
 		{
-			systems.insert(system);
+			registerSystem(system);
 		}
 		else
 		{
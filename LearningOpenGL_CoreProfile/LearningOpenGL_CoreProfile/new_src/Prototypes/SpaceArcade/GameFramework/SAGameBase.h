@@ -1,5 +1,6 @@
 #pragma once
 #include <set>
+#include <vector>
 
 #include "SAGameEntity.h"
 #include "../Tools/RemoveSpecialMemberFunctionUtils.h"
@@ -29,11 +30,17 @@ namespace SA
 	struct TickGroups;
 	class TickGroupManager;
 
+	class JobSystem;
+	class SystemTickGraph;
+
 	//////////////////////////////////////////////////////////////////////////////////////
 	struct EngineConstants
 	{
 		int8_t RENDER_DELAY_FRAMES = 0;
 		uint32_t MAX_DIR_LIGHTS = 4;
+		int32_t JOB_WORKER_THREADS = -1;	//negative uses every hardware thread besides the game thread
+		bool DETERMINISTIC_JOBS = false;	//runs every job serially in submission order; for regression tests
+		int64_t RNG_SEED = -1;				//non-negative replaces the rng system's root seeds (time based in shipping builds) so runs repeat
 	};
 	//////////////////////////////////////////////////////////////////////////////////////
 	struct GamebaseIdentityKey : public RemoveCopies, public RemoveMoves
@@ -133,6 +140,8 @@ namespace SA
 		inline AudioSystem& getAudioSystem() { return *audioSystem; }
 	private:
 		void createEngineSystems();
+		void registerSystem(const sp<SystemBase>& system);
+		void buildSystemTickGraph();
 		/**polymorphic systems require virtual override to define class. If nullptr detected these systems should create a default instance.*/
 		virtual sp<CheatSystemBase> createCheatSystemSubclass(){ return nullptr;}
 		virtual sp<CurveSystem> createCurveSystemSubclass();
@@ -159,8 +168,19 @@ namespace SA
 		sp<CurveSystem> curveSystem;
 		sp<AudioSystem> audioSystem;
 
-		std::set< sp<SystemBase> > systems;
+		std::vector< sp<SystemBase> > systems; //registration order; systems are initialized and ticked in this order
 		std::set< sp<SystemBase> > postRenderNotifys;
+		sp<SystemTickGraph> systemTickGraph;
+
+	//////////////////////////////////////////////////////////////////////////////////////
+	//  Jobs
+	//////////////////////////////////////////////////////////////////////////////////////
+	public:
+		JobSystem& getJobSystem() { return *jobSystem; }
+		/** System ticks by class name, with the dependencies each declared; built once systems are initialized. */
+		const SystemTickGraph& getSystemTickGraph() const { return *systemTickGraph; }
+	private:
+		sp<JobSystem> jobSystem;
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Constants
@@ -83,6 +83,39 @@ namespace SA
 	{
 	}
 
+	sp<WorldEntity> LevelBase::findEntity(const SlotHandle& handle) const
+	{
+		const sp<WorldEntity>* entity = worldEntities.find(handle);
+		return entity ? *entity : nullptr;
+	}
+
+	void LevelBase::addSpawnedEntity(const sp<RenderModelEntity>& entity)
+	{
+		entity->levelHandle = worldEntities.insert(entity);
+		entity->levelRenderHandle = renderEntities.insert(entity);
+	}
+
+	bool LevelBase::removeSpawnedEntity(RenderModelEntity& entity)
+	{
+		//handles only mean something to the level that spawned the entity, so confirm they resolve back to it
+		const sp<WorldEntity>* worldEntry = worldEntities.find(entity.levelHandle);
+		const sp<RenderModelEntity>* renderEntry = renderEntities.find(entity.levelRenderHandle);
+		const bool bInWorldEntities = worldEntry && worldEntry->get() == &entity;
+		const bool bInRenderEntities = renderEntry && renderEntry->get() == &entity;
+
+		if (bInWorldEntities)
+		{
+			worldEntities.remove(entity.levelHandle);
+			entity.levelHandle = SlotHandle{};
+		}
+		if (bInRenderEntities)
+		{
+			renderEntities.remove(entity.levelRenderHandle);
+			entity.levelRenderHandle = SlotHandle{};
+		}
+		return bInWorldEntities && bInRenderEntities;
+	}
+
 	void LevelBase::onEntitySpawned_v(const sp<WorldEntity>& spawned)
 	{
 	}
@@ -102,9 +135,15 @@ namespace SA
 
 		if (!worldTimeManager->isTimeFrozen())
 		{
-			for (const sp<WorldEntity>& entity : worldEntities)
+			//index rather than iterate; ticks may spawn, which can reallocate the entity array
+			for (size_t entityIdx = 0; entityIdx < worldEntities.size();)
 			{
+				WorldEntity* entity = worldEntities[entityIdx].get();
 				entity->tick(dilated_dt_sec);
+
+				//an entity that unspawned itself had the last entity moved into its place; tick that one next
+				if (entityIdx < worldEntities.size() && worldEntities[entityIdx].get() != entity) { continue; }
+				++entityIdx;
 			}
 
 			tick_v(dilated_dt_sec);
@@ -14,6 +14,7 @@
 #include "mix_ins/CustomGrid_MixIn.h"
 #include "../../../Algorithms/SpatialHashing/SpatialHashingComponent.h"
 #include "../Tools/DataStructures/MultiDelegate.h"
+#include "../Tools/DataStructures/SlotMap.h"
 #include "../Rendering/Lights/SADirectionLight.h"
 
 namespace SA
@@ -62,7 +63,11 @@ namespace SA
 
 		/** returns const to prevent modification; use spawn and unspawn entity to add/remove. 
 			#concern this may be an encapsulation issue. Perhaps accessing entities should only be done through the world grid.*/
-		const std::set<sp<WorldEntity>>& getWorldEntities() { return worldEntities; }
+		const SlotMap<sp<WorldEntity>>& getWorldEntities() { return worldEntities; }
+
+		/** @return the spawned entity for a handle from WorldEntity::getLevelHandle, or null if it has since been unspawned */
+		sp<WorldEntity> findEntity(const SlotHandle& handle) const;
+
 		const std::vector<DirectionLight>& getDirectionalLights() const { return dirLights; }
 		glm::vec3 getAmbientLight() const { return ambientLight; }
 
@@ -77,6 +82,9 @@ namespace SA
 		virtual void onEntityUnspawned_v(const sp<WorldEntity>& unspawned);
 		virtual bool isLevelActive() { return bLevelActive; }
 		virtual sp<ServerGameMode_Base> onServerCreateGameMode();
+	private:
+		void addSpawnedEntity(const sp<RenderModelEntity>& entity);
+		bool removeSpawnedEntity(RenderModelEntity& entity);
 	protected:
 		virtual void tick_v(float dt_sec) {}
 	private: //virtuals; private indicates subclasses inherit when function called, but not how function is completed.
@@ -84,8 +92,8 @@ namespace SA
 	public:
 		virtual void render(float dt_sec, const glm::mat4& view, const glm::mat4& projection) {}; //#TODO #replace this with function that takes as parameter render data
 	protected: 
-		std::set<sp<WorldEntity>> worldEntities; //O(n) walks, but walks will not be very cache friendly as a lot of indirection. 
-		std::set<sp<RenderModelEntity>> renderEntities;
+		SlotMap<sp<WorldEntity>> worldEntities; //contiguous walks; order changes as entities are unspawned
+		SlotMap<sp<RenderModelEntity>> renderEntities;
 		SH::SpatialHashGrid<WorldEntity> worldCollisionGrid;
 		sp<TimeManager> worldTimeManager;
 		sp<ServerGameMode_Base> gameModeBase = nullptr; //only valid on server
@@ -103,8 +111,7 @@ namespace SA
 		{
 			spawnCompileCheck<T>();
 			sp<T> entity = new_sp<T>(std::forward<Args>(args)...);
-			worldEntities.insert(entity);
-			renderEntities.insert(entity);
+			addSpawnedEntity(entity);
 			onEntitySpawned_v(entity);
 			onSpawnedEntity.broadcast(entity);
 			return entity;
@@ -116,9 +123,7 @@ namespace SA
 			spawnCompileCheck<T>();
 			sp<T> tempCopy = entity;
 
-			bool foundInAllLocations = renderEntities.find(entity) != renderEntities.end() && worldEntities.find(entity) != worldEntities.end();
-			worldEntities.erase(entity);
-			renderEntities.erase(entity);
+			bool foundInAllLocations = removeSpawnedEntity(*entity);
 
 			onEntityUnspawned_v(entity);
 			onUnspawningEntity.broadcast(entity);
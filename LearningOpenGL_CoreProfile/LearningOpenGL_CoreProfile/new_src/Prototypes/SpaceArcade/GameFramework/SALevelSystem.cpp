@@ -3,6 +3,7 @@
 #include <iostream>
 #include "SAGameBase.h"
 #include "SATimeManagementSystem.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -75,6 +76,12 @@ namespace SA
 		}
 	}
 
+	void LevelSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		//entity and game mode ticks may spawn and destroy anything in the world, along with its effects and sounds; level changes happen here too
+		outDependencies.writes = { "level", "world", "particles", "audio", "assets", "debug_render" };
+	}
+
 	void LevelSystem::shutdown()
 	{
 		if (loadedLevel)
@@ -29,6 +29,7 @@ namespace SA
 		
 	private:
 		virtual void tick(float deltaSec);
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 		virtual void shutdown() override;
 	private: //implementation
 		bool bTickingLevel = false;
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+
+#include "SAGameEntity.h"
+
+namespace SA
+{
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Reference to a spawned particle group. Goes stale once the group finishes or is cleared; its
+	// slot is reused with a new generation, so an old handle never resolves to a different group.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	struct ParticleGroupHandle
+	{
+		static constexpr uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+		uint32_t slot = INVALID_SLOT;
+		uint32_t generation = 0;
+
+		bool isValid() const { return slot != INVALID_SLOT; }
+		bool operator==(const ParticleGroupHandle& other) const { return slot == other.slot && generation == other.generation; }
+		bool operator!=(const ParticleGroupHandle& other) const { return !(*this == other); }
+	};
+
+	struct ParticleGroupPoolStats
+	{
+		uint64_t numAcquired = 0;
+		uint64_t numRecycled = 0;			//acquires served by a free list
+		uint64_t numGroupAllocations = 0;	//acquires that had to create a group; stops growing once the pool is warm
+		uint64_t numReleased = 0;
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Pool of particle groups
+	//
+	// Groups are created once and recycled. Released groups go back on the free list they were
+	// acquired from; the particle system keeps a free list per particle config, so a recycled group's
+	// effect data already has the shape (and capacity) of what it is reused for.
+	//
+	// Active groups are listed densely for the per-frame update. Releasing swap-removes from that list,
+	// so active indices are only valid until the next release; hold a ParticleGroupHandle across frames.
+	// Group addresses are stable for as long as the group is active.
+	//
+	// Group must provide onReleasedToPool(); it should drop references to anything the group was
+	// spawned from (eg its config), so a free group does not keep that alive. Free lists belong to
+	// the epoch they were added in; clear() destroys every group and free list and starts a new epoch.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename Group>
+	class ParticleGroupPool
+	{
+	public:
+		uint32_t addFreeList()
+		{
+			freeLists.emplace_back();
+			return static_cast<uint32_t>(freeLists.size() - 1);
+		}
+
+		/** The group is left as it was when released (or default constructed); the caller resets it */
+		ParticleGroupHandle acquire(uint32_t freeListIdx)
+		{
+			assert(freeListIdx < freeLists.size());
+			++stats.numAcquired;
+
+			uint32_t slotIdx;
+			std::vector<uint32_t>& freeList = freeLists[freeListIdx];
+			if (freeList.size() > 0)
+			{
+				slotIdx = freeList.back();
+				freeList.pop_back();
+				++stats.numRecycled;
+			}
+			else
+			{
+				slotIdx = static_cast<uint32_t>(slots.size());
+				slots.emplace_back();
+				slots.back().group = new_up<Group>();
+				slots.back().generation = firstGeneration;
+				slots.back().freeListIdx = freeListIdx;
+				++stats.numGroupAllocations;
+			}
+
+			Slot& slot = slots[slotIdx];
+			slot.activeIdx = static_cast<uint32_t>(active.size());
+			active.push_back(slot.group.get());
+			activeSlots.push_back(slotIdx);
+
+			return ParticleGroupHandle{ slotIdx, slot.generation };
+		}
+
+		/** nullptr if the group has been released */
+		Group* find(const ParticleGroupHandle& handle) const
+		{
+			if (handle.slot < slots.size())
+			{
+				const Slot& slot = slots[handle.slot];
+				if (slot.generation == handle.generation && slot.activeIdx != INACTIVE)
+				{
+					return slot.group.get();
+				}
+			}
+			return nullptr;
+		}
+
+		bool release(const ParticleGroupHandle& handle)
+		{
+			if (find(handle))
+			{
+				releaseActive(slots[handle.slot].activeIdx);
+				return true;
+			}
+			return false;
+		}
+
+		/** Swap-removes; the last active group moves into activeIdx */
+		void releaseActive(size_t activeIdx)
+		{
+			assert(activeIdx < active.size());
+			const uint32_t slotIdx = activeSlots[activeIdx];
+			const size_t lastIdx = active.size() - 1;
+			if (activeIdx != lastIdx)
+			{
+				active[activeIdx] = active[lastIdx];
+				activeSlots[activeIdx] = activeSlots[lastIdx];
+				slots[activeSlots[activeIdx]].activeIdx = static_cast<uint32_t>(activeIdx);
+			}
+			active.pop_back();
+			activeSlots.pop_back();
+
+			Slot& slot = slots[slotIdx];
+			slot.group->onReleasedToPool();
+			slot.activeIdx = INACTIVE;
+			++slot.generation;
+			freeLists[slot.freeListIdx].push_back(slotIdx);
+			++stats.numReleased;
+		}
+
+		void releaseAll()
+		{
+			while (active.size() > 0)
+			{
+				releaseActive(active.size() - 1);
+			}
+		}
+
+		/** Releases and destroys every group and free list. Handles stay stale; free list indices from earlier epochs must not be used */
+		void clear()
+		{
+			releaseAll();
+
+			//slots are rebuilt from zero, so start generations past every handle given out so far
+			for (const Slot& slot : slots)
+			{
+				firstGeneration = std::max(firstGeneration, slot.generation);
+			}
+			slots.clear();
+			freeLists.clear();
+			++freeListEpoch;
+		}
+
+		uint32_t getFreeListEpoch() const { return freeListEpoch; }
+		size_t getNumActive() const { return active.size(); }
+		Group& getActive(size_t activeIdx) { return *active[activeIdx]; }
+		ParticleGroupHandle getActiveHandle(size_t activeIdx) const
+		{
+			const uint32_t slotIdx = activeSlots[activeIdx];
+			return ParticleGroupHandle{ slotIdx, slots[slotIdx].generation };
+		}
+
+		size_t getNumGroups() const { return slots.size(); }
+		size_t getNumFree(uint32_t freeListIdx) const { return freeLists[freeListIdx].size(); }
+		size_t getNumFreeLists() const { return freeLists.size(); }
+		const ParticleGroupPoolStats& getStats() const { return stats; }
+
+	private:
+		static constexpr uint32_t INACTIVE = std::numeric_limits<uint32_t>::max();
+
+		struct Slot
+		{
+			up<Group> group;
+			uint32_t generation = 0;
+			uint32_t activeIdx = INACTIVE;
+			uint32_t freeListIdx = 0;
+		};
+
+		std::vector<Slot> slots;
+		std::vector<Group*> active;
+		std::vector<uint32_t> activeSlots;
+		std::vector<std::vector<uint32_t>> freeLists;
+		uint32_t firstGeneration = 0;
+		uint32_t freeListEpoch = 0;
+		ParticleGroupPoolStats stats;
+	};
+}
@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <stack>
+#include <cstring>
 #include "SAAssetSystem.h"
 #include "SALevelSystem.h"
 #include "SALog.h"
@@ -13,8 +14,10 @@
 #include "../Tools/SAUtilities.h"
 #include "../Rendering/Camera/SACameraBase.h"
 #include "../Rendering/OpenGLHelpers.h"
+#include "../Rendering/SAGLInstanceBufferBackend.h"
 #include "../Rendering/DeferredRendering/DeferredRendererStateMachine.h"
 #include "SARenderSystem.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -28,13 +31,15 @@ namespace SA
 
 	void ParticleConfig::generateMutableEffectData(std::vector<MutableEffectData>& outEffectData) const
 	{
-		outEffectData.clear();
-		outEffectData.reserve(effects.size());
+		//recycled particle groups already have data for this config; clearing rather than reallocating keeps its capacity
+		outEffectData.resize(effects.size());
 
-		for (const sp<Particle::Effect>& effect : effects)
+		for (MutableEffectData& med : outEffectData)
 		{
-			outEffectData.emplace_back();
-			MutableEffectData& med = outEffectData.back();
+			med.floatsArray.clear();
+			med.vec3Array.clear();
+			med.vec4Array.clear();
+			med.mat4Array.clear();
 
 			//Reserve built-in locations
 			med.vec3Array.resize(3);
@@ -84,9 +89,9 @@ namespace SA
 	// Particle System 
 	/////////////////////////////////////////////////////////////////////////////
 
-	wp<ActiveParticleGroup> ParticleSystem::spawnParticle(const SpawnParams& params)
+	ParticleGroupHandle ParticleSystem::spawnParticle(const SpawnParams& params)
 	{
-		wp<ActiveParticleGroup> spawnResult;
+		ParticleGroupHandle spawnResult;
 #if DISABLE_PARTICLE_SYSTEM
 		return spawnResult;
 #endif //DISABLE_PARTICLE_SYSTEM
@@ -141,23 +146,28 @@ namespace SA
 				int dataIdx = findIter->second; //#TODO might no longer need this
 			}
 
-			//Configure Active Particle
-			sp<ActiveParticleGroup> newParticlePtr = new_sp<ActiveParticleGroup>(); //#optimize perhaps pool or write memory manager using large pool of memory for these?
-			activeParticles.insert({ newParticlePtr.get(), newParticlePtr });
-			ActiveParticleGroup& newParticle = *newParticlePtr;
+			//Configure Active Particle; groups are recycled, so every field is reset
+			if (!params.particle->groupFreeListIdx.has_value() || params.particle->groupFreeListEpoch != particleGroups.getFreeListEpoch())
+			{
+				params.particle->groupFreeListIdx = particleGroups.addFreeList();
+				params.particle->groupFreeListEpoch = particleGroups.getFreeListEpoch();
+			}
+			spawnResult = particleGroups.acquire(*params.particle->groupFreeListIdx);
+			ActiveParticleGroup& newParticle = *particleGroups.find(spawnResult);
 			newParticle.particle = params.particle;
 			newParticle.velocity = params.velocity;
 			newParticle.xform = params.xform;
 			newParticle.durationDilation = params.durationDilation;
 			newParticle.parentXform_m = params.parentXform;
+			newParticle.timeAlive = 0.f;
+			newParticle.bLoopCount = 0;
+			newParticle.bAlive = true;
 			params.particle->generateMutableEffectData(newParticle.mutableEffectData);
 			assert(newParticle.mutableEffectData.size() == params.particle->effects.size());
 
 			//update particle and populate add to effect instance data
 			updateActiveParticleGroup(newParticle, 0);
 
-			//#concern perhaps particle alias? user can corrupt data with bad memory access. But user needs to modify transform directly and stop loops.
-			spawnResult = newParticlePtr;
 			return spawnResult;
 		}
 		return spawnResult;
@@ -170,6 +180,39 @@ namespace SA
 
 	void ParticleSystem::tick(float deltaSec)
 	{
+		using KeyFrameChain = Particle::KeyFrameChain;
+
+		static PlayerSystem& playerSystem = GameBase::get().getPlayerSystem();
+		const sp<PlayerBase>& player = playerSystem.getPlayer(0);
+		const sp<CameraBase> camera = player ? player->getCamera() : sp<CameraBase>(nullptr); //#TODO perhaps just listen to camera changing
+
+
+		if (currentLevel && camera)
+		{
+			const sp<TimeManager>& worldTimeManager = currentLevel->getWorldTimeManager();
+			float dt_sec_world = worldTimeManager->isTimeFrozen() ? 0 : worldTimeManager->getDeltaTimeSecs();
+
+			for (size_t activeIdx = 0; activeIdx < particleGroups.getNumActive(); /*advanced in loop*/)
+			{
+				if (updateActiveParticleGroup(particleGroups.getActive(activeIdx), dt_sec_world))
+				{
+					//swap-removed; the last group moves into this index and still needs its update
+					particleGroups.releaseActive(activeIdx);
+				}
+				else
+				{
+					++activeIdx;
+				}
+			}
+		}
+	}
+
+	void ParticleSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		//groups are only spawned and released from the main thread, so updates can run on a worker once the level has ticked
+		outDependencies.bThreadSafeTick = true;
+		outDependencies.reads = { "level" };
+		outDependencies.writes = { "particles" };
 	}
 
 	bool ParticleSystem::updateActiveParticleGroup(ActiveParticleGroup& activeParticle, float dt_sec_world)
@@ -267,13 +310,25 @@ namespace SA
 		const sp<PlayerBase>& player = playerSystem.getPlayer(0);
 		const sp<CameraBase> camera = player ? player->getCamera() : sp<CameraBase>(nullptr); //#TODO perhaps just listen to camera changing
 
-		if (instanceMat4VBO_opt.has_value() && instanceVec4VBO_opt.has_value() && camera)
+		if (instanceUploadRing && instanceUploadRing->hasStorage() && camera)
 		{
 			const glm::mat4 projection_view = camera->getPerspective() * camera->getView(); //calculate early 
 			const glm::vec3 camPos = camera->getPosition();
 
-			GLuint instanceMat4VBO = *instanceMat4VBO_opt;
-			GLuint instanceVec4VBO = *instanceVec4VBO_opt;
+			//size the whole frame's uploads up front so the ring can grow before anything is mapped
+			size_t frameUploadBytes = 0;
+			for (const EffectInstanceData& eid : instancedEffectsData)
+			{
+				if (eid.numInstancesThisFrame > 0 && eid.effectData->mesh->getVAOs().size() > 0)
+				{
+					frameUploadBytes += InstanceUploadRing::paddedSize(sizeof(glm::mat4) * eid.mat4Data.size(), instanceUploadAlignment);
+					frameUploadBytes += InstanceUploadRing::paddedSize(sizeof(glm::vec4) * eid.vec4Data.size(), instanceUploadAlignment);
+				}
+			}
+
+			InstanceUploadRing& uploadRing = *instanceUploadRing;
+			uploadRing.beginFrame(frameUploadBytes);
+			GLuint instanceVBO = uploadRing.getBufferId();
 
 			for (EffectInstanceData& eid : instancedEffectsData)
 			{
@@ -292,13 +347,27 @@ namespace SA
 					// attribute 12-15 //last remaining attributes
 
 					// ---- BUFFER data ---- before binding it to all VAOs (model's may have multiple meshes, each with their own VAO)
-					//#TODO check sizes of EID data before trying to bind optional buffers
-					//#TODO investigate using glBufferSubData and glMapBuffer and GL_DYNAMIC_DRAW here; may be more efficient if we're not reallocating each time? It appears glBufferData will re-allocate
-					ec(glBindBuffer(GL_ARRAY_BUFFER, instanceMat4VBO));
-					ec(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * eid.mat4Data.size(), &eid.mat4Data[0], GL_STATIC_DRAW)); //#TODO this needs to go before binding of VAOs
+					// each upload is committed before the next allocation; a non-persistent buffer can only have one mapped range at a time
+					InstanceUploadRing::Allocation mat4Upload = uploadRing.allocate(sizeof(glm::mat4) * eid.mat4Data.size(), instanceUploadAlignment);
+					if (mat4Upload.isValid())
+					{
+						std::memcpy(mat4Upload.data, eid.mat4Data.data(), mat4Upload.bytes);
+						uploadRing.commit(mat4Upload);
+					}
 
-					ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVec4VBO));
-					ec(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * eid.vec4Data.size(), &eid.vec4Data[0], GL_STATIC_DRAW));
+					InstanceUploadRing::Allocation vec4Upload = uploadRing.allocate(sizeof(glm::vec4) * eid.vec4Data.size(), instanceUploadAlignment);
+					if (vec4Upload.isValid())
+					{
+						std::memcpy(vec4Upload.data, eid.vec4Data.data(), vec4Upload.bytes);
+						uploadRing.commit(vec4Upload);
+					}
+
+					if (!mat4Upload.isValid() || !vec4Upload.isValid())
+					{
+						log("ParticleSystem", LogLevel::LOG_ERROR, "Failed to upload particle instance data; skipping effect this frame");
+						eid.clearFrameData();
+						continue;
+					}
 
 					for (GLuint effectVAO : eid.effectData->mesh->getVAOs())
 					{
@@ -307,7 +376,7 @@ namespace SA
 
 						{ //set up mat4 buffer
 
-							ec(glBindBuffer(GL_ARRAY_BUFFER, instanceMat4VBO));
+							ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVBO));
 							GLsizei numVec4AttribsInBuffer = 4 * eid.numMat4PerInstance;
 							size_t packagedVec4Idx_matbuffer = 0;
 
@@ -321,10 +390,10 @@ namespace SA
 									ec(glEnableVertexAttribArray(10));
 									ec(glEnableVertexAttribArray(11));
 
-									ec(glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
-									ec(glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
-									ec(glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
-									ec(glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
+									ec(glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(mat4Upload.offset + packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
+									ec(glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(mat4Upload.offset + packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
+									ec(glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(mat4Upload.offset + packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
+									ec(glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(mat4Upload.offset + packagedVec4Idx_matbuffer++ * sizeof(glm::vec4))));
 
 									ec(glVertexAttribDivisor(8, 1));
 									ec(glVertexAttribDivisor(9, 1));
@@ -340,7 +409,7 @@ namespace SA
 						}
 
 						{ //set up vec4 buffer
-							ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVec4VBO));
+							ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVBO));
 
 							//#TODO set num vec4s in stride based on custom data
 							GLsizei numVec4AttribsInBuffer = eid.numVec4PerInstance;
@@ -349,7 +418,7 @@ namespace SA
 							{
 								//package built-in vec4s
 								ec(glEnableVertexAttribArray(7));
-								ec(glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(packagedVec4Idx_v4buffer++ * sizeof(glm::vec4))));
+								ec(glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, numVec4AttribsInBuffer * sizeof(glm::vec4), reinterpret_cast<void*>(vec4Upload.offset + packagedVec4Idx_v4buffer++ * sizeof(glm::vec4))));
 								ec(glVertexAttribDivisor(7, 1));
 							}
 
@@ -393,42 +462,11 @@ namespace SA
 					eid.clearFrameData();
 				}
 			}
-		}
-		ec(glBindVertexArray(0));//unbind VAO's
-	}
-
-	void ParticleSystem::handlePostGameloopTick(float deltaSec)
-	{
-		using KeyFrameChain = Particle::KeyFrameChain;
-
-		static PlayerSystem& playerSystem = GameBase::get().getPlayerSystem();
-		const sp<PlayerBase>& player = playerSystem.getPlayer(0);
-		const sp<CameraBase> camera = player ? player->getCamera() : sp<CameraBase>(nullptr); //#TODO perhaps just listen to camera changing
-
-
-		static std::vector<sp<ActiveParticleGroup>> removeParticleContainer;
-		static int oneTimeReserve = [](std::vector<sp<ActiveParticleGroup>> toRemoveContainer) { toRemoveContainer.reserve(100); return 0; }(removeParticleContainer);
-
-		if (currentLevel && camera)
-		{
-			const sp<TimeManager>& worldTimeManager = currentLevel->getWorldTimeManager();
-			float dt_sec_world = worldTimeManager->isTimeFrozen() ? 0 : worldTimeManager->getDeltaTimeSecs();
-
-			for (auto& mapIter : activeParticles)
-			{
-				const sp<ActiveParticleGroup>& activeParticle = mapIter.second;
-				if (updateActiveParticleGroup(*activeParticle, dt_sec_world))
-				{
-					removeParticleContainer.push_back(activeParticle);
-				}
-			}
-		}
 
-		for (sp<ActiveParticleGroup>& particle : removeParticleContainer)
-		{
-			activeParticles.erase(particle.get());
+			//fence after the draws so the region is not rewritten until the GPU has read it
+			uploadRing.endFrame();
 		}
-		removeParticleContainer.clear();
+		ec(glBindVertexArray(0));//unbind VAO's
 	}
 
 	void ParticleSystem::initSystem()
@@ -446,7 +484,6 @@ namespace SA
 		}
 
 		GameBase& game = GameBase::get();
-		game.onPostGameloopTick.addStrongObj(sp_this(), &ParticleSystem::handlePostGameloopTick); 
 		game.onRenderDispatch.addStrongObj(sp_this(), &ParticleSystem::handleRenderDispatch);
 		//game.subscribePostRender(sp_this());
 	}
@@ -454,7 +491,6 @@ namespace SA
 	void ParticleSystem::shutdown()
 	{
 		GameBase& game = GameBase::get();
-		game.onPostGameloopTick.removeStrong(sp_this(), &ParticleSystem::handlePostGameloopTick);
 		game.onRenderDispatch.removeStrong(sp_this(), &ParticleSystem::handleRenderDispatch);
 	}
 
@@ -462,35 +498,30 @@ namespace SA
 	{
 		log("ParticleSystem", LogLevel::LOG, "Detected level change, clearing particles");
 
-		activeParticles.clear();
+		//configs are rebuilt per level (eg shields by ParticleCache::resetCache), so free lists keyed by the old configs would never be reused
+		particleGroups.clear();
 		currentLevel = newCurrentLevel;
 	}
 
 	void ParticleSystem::handleLosingOpenglContext(const sp<Window>& window)
 	{
-		if (instanceMat4VBO_opt.has_value())
+		if (instanceUploadRing)
 		{
-			ec(glDeleteBuffers(1, &(*instanceMat4VBO_opt)));
-			instanceMat4VBO_opt.reset();
-
-			ec(glDeleteBuffers(1, &(*instanceVec4VBO_opt)));
-			instanceVec4VBO_opt.reset();
+			instanceUploadRing->releaseStorage();
 		}
 	}
 
 	void ParticleSystem::handleAcquiredOpenglContext(const sp<Window>& window)
 	{
-		if (!instanceMat4VBO_opt.has_value())
+		if (!instanceUploadRing || !instanceUploadRing->hasStorage())
 		{
-			unsigned int mat4InstanceVBO;
-			ec(glGenBuffers(1, &mat4InstanceVBO));
-			ec(glBindBuffer(GL_ARRAY_BUFFER, mat4InstanceVBO));
-			instanceMat4VBO_opt = mat4InstanceVBO;
-
-			unsigned int vec4InstanceVBO;
-			ec(glGenBuffers(1, &vec4InstanceVBO));
-			ec(glBindBuffer(GL_ARRAY_BUFFER, vec4InstanceVBO));
-			instanceVec4VBO_opt = vec4InstanceVBO;
+			if (!instanceUploadRing)
+			{
+				//a model matrix and a built-in vec4 per instance; the ring grows if a frame needs more
+				const size_t initialRegionBytes = 1024 * (sizeof(glm::mat4) + sizeof(glm::vec4));
+				instanceUploadRing = new_up<InstanceUploadRing>(new_up<GLInstanceBufferBackend>(), initialRegionBytes);
+			}
+			instanceUploadRing->acquireStorage();
 
 			ec(glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertAttributes));
 			//log("ParticleSystem", LogLevel::LOG, "Max Vertex Attributes To Use");
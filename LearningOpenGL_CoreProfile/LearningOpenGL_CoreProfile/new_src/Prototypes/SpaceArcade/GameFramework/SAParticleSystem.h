@@ -11,8 +11,10 @@
 #include <gtx/quaternion.hpp>
 
 #include "SAGameEntity.h"
+#include "SAParticleGroupPool.h"
 #include "../Tools/DataStructures/SATransform.h"
 #include "../Game/AssetConfigs/SAConfigBase.h"
+#include "../Rendering/SAInstanceUploadRing.h"
 
 #define DISABLE_PARTICLE_SYSTEM 0
 
@@ -180,7 +182,7 @@ namespace SA
 
 		virtual std::string getRepresentativeFilePath() override;
 
-		/* Generates data for the effect that can be manipulated over time */
+		/* Generates data for the effect that can be manipulated over time; reuses the storage already in outEffectData */
 		void generateMutableEffectData(std::vector<MutableEffectData>& outEffectData) const;
 		float getDurationSecs();
 
@@ -195,6 +197,8 @@ namespace SA
 		std::optional<int> numLoops;
 		std::vector<sp<Particle::Effect>> effects;
 		std::optional<float> totalTime;
+		std::optional<uint32_t> groupFreeListIdx; //particle system managed; groups spawned from this config are recycled through this free list
+		uint32_t groupFreeListEpoch = 0; //groupFreeListIdx is only valid in the pool epoch it was added in
 	};
 
 	struct MutableEffectData
@@ -212,15 +216,17 @@ namespace SA
 		std::vector<glm::mat4> mat4Array;
 	};
 
-	/* Represents a particle that is actively being rendered */
+	/* Represents a particle that is actively being rendered; pooled by the particle system, refer to it with a ParticleGroupHandle */
 	class ActiveParticleGroup : public RemoveCopies, public RemoveMoves
 	{
 		friend class ParticleSystem; //#TODO may not should be treated as a struct; will see when system fleshes out
 		
 	public:
 		void resetTimeAlive() { timeAlive = 0.f; }
-		//killing a particle will disable it and remove it from system, pointer should be discarded after doing this
+		//killing a particle will disable it and remove it from system once its effects finish; its handle then goes stale
 		void killParticle() { bAlive = false; } 
+		//called by the pool; a free group must not keep its config (and whatever the config holds, eg a shield's model) alive
+		void onReleasedToPool() { particle = nullptr; }
 
 		////////////////////////////////////////////////////////
 		// data
@@ -267,16 +273,20 @@ namespace SA
 			Transform xform{};
 		};
 
-		wp<ActiveParticleGroup> spawnParticle(const SpawnParams& params);
+		ParticleGroupHandle spawnParticle(const SpawnParams& params);
+
+		/** nullptr once the group has finished; groups are recycled, so do not hold the pointer, hold the handle */
+		ActiveParticleGroup* getParticleGroup(const ParticleGroupHandle& handle) const { return particleGroups.find(handle); }
+		const ParticleGroupPoolStats& getParticleGroupStats() const { return particleGroups.getStats(); }
 
 	private:
 		virtual void postConstruct() override;
 		virtual void initSystem() override;
 		virtual void shutdown() override;
 		virtual void tick(float deltaSec) override;
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 		inline bool updateActiveParticleGroup(ActiveParticleGroup& particleGroup, float dt_sec_world);
 		void handleRenderDispatch(float deltaSec);
-		void handlePostGameloopTick(float deltaSec);
 
 	private: //utility functions
 	
@@ -287,8 +297,11 @@ namespace SA
 		void handleLosingOpenglContext(const sp<Window>& window);
 		void handleAcquiredOpenglContext(const sp<Window>& window);
 
-		//currently the active particle and its spawn params are identical; so just renaming the type
-		std::map<ActiveParticleGroup*, sp<ActiveParticleGroup>> activeParticles;
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Spawned groups are recycled through a free list per particle config, and updated 
+		// from a dense list of the active ones. 
+		/////////////////////////////////////////////////////////////////////////////////////
+		ParticleGroupPool<ActiveParticleGroup> particleGroups;
 
 		/////////////////////////////////////////////////////////////////////////////////////
 		// Map from shader instance to index in array of EffectInstanceData
@@ -302,8 +315,13 @@ namespace SA
 		// frame and used for drawing a large number of particles. 
 		/////////////////////////////////////////////////////////////////////////////////////
 		std::vector<EffectInstanceData> instancedEffectsData;
-		std::optional<unsigned int> instanceMat4VBO_opt;
-		std::optional<unsigned int> instanceVec4VBO_opt;
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// instance data for every effect is uploaded into a single triple-buffered ring; 
+		// attribute pointers are offset to each effect's allocation within the buffer.
+		/////////////////////////////////////////////////////////////////////////////////////
+		up<InstanceUploadRing> instanceUploadRing;
+		static constexpr size_t instanceUploadAlignment = 16;
 		int maxVertAttributes;
 	};
 
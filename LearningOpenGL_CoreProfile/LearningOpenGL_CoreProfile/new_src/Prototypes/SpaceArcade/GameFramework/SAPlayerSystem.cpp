@@ -1,4 +1,5 @@
 #include "SAPlayerSystem.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -14,5 +15,10 @@ namespace SA
 		//returning just nullptr will become a local temporary -- don't return local temporary reference
 		return NULL_PLAYER;
 	}
+
+	void PlayerSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		outDependencies.bThreadSafeTick = true; //players are driven by input and cameras, not a system tick
+	}
 }
 
@@ -40,6 +40,8 @@ namespace SA
 		/** prefer static_cast if player hierarchy is always known */
 		MultiDelegate<const sp<PlayerBase>& /*player*/, uint32_t /*idx*/> onPlayerCreated;
 
+	private:
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 	private:
 		std::vector<sp<PlayerBase>> players;
 	};
@@ -1,6 +1,8 @@
 #include <ctime>
 
 #include "SARandomNumberGenerationSystem.h"
+#include "Jobs/SystemTickGraph.h"
+#include "SAGameBase.h"
 #include <assimp\Compiler\pstdint.h>
 
 namespace SA
@@ -45,6 +47,21 @@ namespace SA
 			rootNamedRNG = sp<RNG>(new RNG{ std::initializer_list {7u, 54u, 11u, 29u, 0u} });
 			rootTimeInfluencedRNG = sp<RNG>(new RNG{ std::initializer_list {19u, 3u, 107u, 67u, 9u} });
 		}
+
+		//systems are constructed after the engine constants are configured, so this is before any generator is handed out
+		const int64_t configuredSeed = GameBase::getConstants().RNG_SEED;
+		if (configuredSeed >= 0)
+		{
+			reseed(uint32_t(configuredSeed));
+		}
+	}
+
+	void RNGSystem::reseed(uint32_t seed)
+	{
+		//same seed, different sequences; mirrors the 2x used for the time seeds
+		rootNamedRNG = sp<RNG>(new RNG{ std::initializer_list			{ seed, 1u } });
+		rootTimeInfluencedRNG = sp<RNG>(new RNG{ std::initializer_list	{ seed, 2u } });
+		namedGenerators.clear();
 	}
 
 	sp<RNG> RNGSystem::createNewRNG(sp<RNG>& seedSrcRNG)
@@ -54,5 +71,10 @@ namespace SA
 		return newRNG;
 	}
 
+	void RNGSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		outDependencies.bThreadSafeTick = true; //generators are handed out on request; nothing ticks
+	}
+
 }
 
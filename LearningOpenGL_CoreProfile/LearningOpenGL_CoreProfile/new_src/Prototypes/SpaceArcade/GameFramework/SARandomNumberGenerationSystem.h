@@ -37,11 +37,16 @@ namespace SA
 		use this creation method to isolate them from the predictable named generators.*/
 		sp<RNG> getTimeInfluencedRNG();
 		sp<RNG> getNamedRNG(const std::string rngName);
-		sp<RNG> getSeededRNG(uint32_t seed);
+		/** Seeded generators do not depend on the system's state, so this can be used without a running game (eg engine tests). */
+		static sp<RNG> getSeededRNG(uint32_t seed);
+
+		/** Restarts both root generators from one seed and forgets the named generators; generators already handed out are unaffected. */
+		void reseed(uint32_t seed);
 
 	protected:
 		virtual void postConstruct();
 	private:
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 		sp<RNG> createNewRNG(sp<RNG>& seedSrcRNG);
 	private:
 		sp<RNG> rootNamedRNG;		//generator that spawns seeds for named generators
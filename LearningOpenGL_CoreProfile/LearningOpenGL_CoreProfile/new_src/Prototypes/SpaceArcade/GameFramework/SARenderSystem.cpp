@@ -8,6 +8,7 @@
 #include "../Rendering/SAShader.h"
 #include "../Rendering/Lights/PointLight_Deferred.h"
 #include "../Rendering/ForwardRendering/ForwardRenderingStateMachine.h"
+#include "Jobs/SystemTickGraph.h"
 
 namespace SA
 {
@@ -110,6 +111,11 @@ namespace SA
 		}
 	}
 
+	void RenderSystem::declareTickDependencies(SystemTickDependencies& outDependencies) const
+	{
+		outDependencies.writes = { "point_lights" }; //main thread, as lights are created from the main thread
+	}
+
 	const SA::sp<SA::PointLight_Deferred> RenderSystem::createPointLight()
 	{
 		sp<PointLight_Deferred> newPointLight = new_sp<PointLight_Deferred>(PointLight_Deferred::PrivateConstructionKey{});
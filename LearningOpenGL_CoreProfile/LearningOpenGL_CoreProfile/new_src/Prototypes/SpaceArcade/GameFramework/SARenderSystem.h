@@ -38,6 +38,7 @@ namespace SA
 		bool isUsingHDR();
 	protected:
 		virtual void tick(float dt_sec) override;;
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const override;
 	private:
 		/** Private to allow deciding whether to return this as constant data or mutable data.*/
 		RenderData* getFrameRenderData(uint64_t frameNumber);
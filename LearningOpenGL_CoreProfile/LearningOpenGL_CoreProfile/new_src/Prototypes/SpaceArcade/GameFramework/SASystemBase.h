@@ -6,6 +6,7 @@
 namespace SA
 {
 	class GameBase;
+	struct SystemTickDependencies;
 
 	/**
 		INVARIANT: No system shall attempt to retrieve another system within its constructor; handle that in "initSystem" virtuals
@@ -19,6 +20,9 @@ namespace SA
 
 		virtual void tick(float deltaSec){};
 
+		/** Systems that leave this alone tick on the main thread, ordered against every other system; see SystemTickGraph */
+		virtual void declareTickDependencies(SystemTickDependencies& outDependencies) const {}
+
 		/** Called when main game systems can safely be accessed; though not all may be initialized */
 		virtual void initSystem() {};
 
@@ -0,0 +1,145 @@
+#include "SATickProfiler.h"
+
+#include <atomic>
+#include <unordered_map>
+
+namespace
+{
+	struct LabelRegistry
+	{
+		std::mutex mutex;
+		std::vector<std::string> labels;
+		std::unordered_map<std::string, SA::TickProfiler::LabelId> labelToId;
+	};
+
+	LabelRegistry& getLabelRegistry()
+	{
+		static LabelRegistry registry;
+		return registry;
+	}
+
+	std::atomic<uint64_t> nextProfilerInstanceId{ 1 };
+}
+
+namespace SA
+{
+	TickProfiler* TickProfiler::active = nullptr;
+
+	TickProfiler::Scope::Scope(LabelId labelId)
+		: profiler(TickProfiler::getActive()),
+		labelId(labelId)
+	{
+		if (profiler)
+		{
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	TickProfiler::Scope::~Scope()
+	{
+		if (profiler)
+		{
+			profiler->record(labelId, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+	}
+
+	TickProfiler::TickProfiler()
+		: instanceId(nextProfilerInstanceId++)
+	{
+	}
+
+	TickProfiler::~TickProfiler()
+	{
+		if (active == this)
+		{
+			active = nullptr;
+		}
+	}
+
+	/*static*/ TickProfiler::LabelId TickProfiler::internLabel(const std::string& label)
+	{
+		LabelRegistry& registry = getLabelRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		auto iter = registry.labelToId.find(label);
+		if (iter == registry.labelToId.end())
+		{
+			iter = registry.labelToId.insert({ label, LabelId(registry.labels.size()) }).first;
+			registry.labels.push_back(label);
+		}
+		return iter->second;
+	}
+
+	TickProfiler::ThreadSamples& TickProfiler::getThreadSamples()
+	{
+		//each thread remembers the samples of the last profiler it recorded into; switching back and forth only registers another buffer
+		thread_local uint64_t cachedInstanceId = 0;
+		thread_local ThreadSamples* cachedSamples = nullptr;
+
+		if (cachedInstanceId != instanceId)
+		{
+			std::lock_guard<std::mutex> lock(threadSamplesMutex);
+			threadSamples.push_back(std::make_unique<ThreadSamples>());
+			cachedSamples = threadSamples.back().get();
+			cachedInstanceId = instanceId;
+		}
+		return *cachedSamples;
+	}
+
+	void TickProfiler::record(LabelId labelId, double ms)
+	{
+		ThreadSamples& samples = getThreadSamples();
+		if (labelId >= samples.frameMs.size())
+		{
+			samples.frameMs.resize(labelId + 1, 0.0);
+			samples.bRecorded.resize(labelId + 1, 0);
+		}
+		samples.frameMs[labelId] += ms;
+		samples.bRecorded[labelId] = 1;
+	}
+
+	void TickProfiler::endFrame()
+	{
+		std::lock_guard<std::mutex> lock(threadSamplesMutex);
+
+		for (const std::unique_ptr<ThreadSamples>& samples : threadSamples)
+		{
+			for (LabelId labelId = 0; labelId < samples->frameMs.size(); ++labelId)
+			{
+				if (!samples->bRecorded[labelId])
+				{
+					continue;
+				}
+
+				if (labelId >= labelToTimingIdx.size())
+				{
+					labelToTimingIdx.resize(labelId + 1, std::string::npos);
+				}
+				if (labelToTimingIdx[labelId] == std::string::npos)
+				{
+					//first time this label is seen; earlier frames did not run it
+					LabelRegistry& registry = getLabelRegistry();
+					std::lock_guard<std::mutex> registryLock(registry.mutex);
+
+					Timing newTiming;
+					newTiming.label = registry.labels[labelId];
+					newTiming.frameMs.assign(numFrames, 0.0);
+					labelToTimingIdx[labelId] = timings.size();
+					timings.push_back(std::move(newTiming));
+					currentFrameMs.push_back(0.0);
+				}
+
+				currentFrameMs[labelToTimingIdx[labelId]] += samples->frameMs[labelId];
+				samples->frameMs[labelId] = 0.0;
+				samples->bRecorded[labelId] = 0;
+			}
+		}
+
+		for (size_t timingIdx = 0; timingIdx < timings.size(); ++timingIdx)
+		{
+			timings[timingIdx].frameMs.push_back(currentFrameMs[timingIdx]);
+			currentFrameMs[timingIdx] = 0.0;
+		}
+		++numFrames;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Tick profiler
+	//
+	//		Records wall clock time per labelled scope, one sample per frame. Scopes do nothing unless a profiler
+	//		has been made active, so they can be left in engine code; when inactive the cost is a null check.
+	//		Labels are interned once per scope site, and each thread sums its samples into its own buffer, so a
+	//		record is an index and an add; systems ticking in parallel on job workers never contend. The
+	//		buffers are merged when the frame ends.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class TickProfiler
+	{
+	public:
+		using LabelId = uint32_t;
+
+		struct Timing
+		{
+			std::string label;
+			std::vector<double> frameMs; //a scope hit several times in a frame is summed into one sample
+		};
+
+		/** Times the enclosing block under the label, if a profiler is active when the scope opens. */
+		class Scope
+		{
+		public:
+			explicit Scope(LabelId labelId);
+			~Scope();
+		private:
+			TickProfiler* profiler;
+			LabelId labelId;
+			std::chrono::steady_clock::time_point start;
+		};
+
+	public:
+		TickProfiler();
+		~TickProfiler();
+
+		/** 
+			Returns the id for a label, shared by every profiler; the same text always gets the same id. Takes a lock,
+			so call it once per scope site, eg `static const TickProfiler::LabelId label = TickProfiler::internLabel("Render");`
+		*/
+		static LabelId internLabel(const std::string& label);
+
+		/** Only change the active profiler between frames, while no jobs are running. */
+		static void setActive(TickProfiler* profiler) { active = profiler; }
+		static TickProfiler* getActive() { return active; }
+
+		void record(LabelId labelId, double ms);
+
+		/** 
+			Closes the frame; every label seen so far gets a sample, 0 if its scope was not hit this frame.
+			Must be called while no scopes are open on other threads, eg at frame over once the tick jobs are done. 
+		*/
+		void endFrame();
+
+		size_t getNumFrames() const { return numFrames; }
+		const std::vector<Timing>& getTimings() const { return timings; }
+
+	private:
+		/** Written only by its thread; read and cleared by endFrame. Indexed by label id. */
+		struct ThreadSamples
+		{
+			std::vector<double> frameMs;
+			std::vector<uint8_t> bRecorded;
+		};
+		ThreadSamples& getThreadSamples();
+
+	private:
+		static TickProfiler* active;
+
+		const uint64_t instanceId;						//thread local caches key on this rather than the address, which may be reused
+		std::mutex threadSamplesMutex;					//only taken the first time a thread records into this profiler, and by endFrame
+		std::vector<std::unique_ptr<ThreadSamples>> threadSamples;
+
+		std::vector<Timing> timings;					//first-seen order
+		std::vector<double> currentFrameMs;				//parallel to timings; scratch for merging the threads' samples
+		std::vector<size_t> labelToTimingIdx;			//indexed by label id; npos until first recorded
+		size_t numFrames = 0;
+	};
+}
@@ -7,6 +7,9 @@
 #include "../Tools/DataStructures/IterableHashSet.h"
 #include <unordered_map>
 #include "Interfaces/SATickable.h"
+#include "TimeManagement/TimerWheel.h"
+#include "TimeManagement/TickDispatcher.h"
+#include "TimeManagement/TickGroupManager.h"
 
 namespace SA
 {
@@ -16,34 +19,6 @@ namespace SA
 
 	struct TickGroupDefinition;
 
-	//#consider this may be better suited as bit-vector for masking operations (eg SUCCESS = DEFERRED | REMOVED | ADDED) 
-	enum class ETimerOperationResult : char
-	{
-		SUCCESS = 0,
-		FAILURE_TIMER_FOR_DELEGATE_EXISTS,
-		FAILURE_TIMER_NOT_FOUND,
-		FAILURE_NEGATIVE_DURATION,
-		DEFER_FAILURE_TIMER_FOR_DELEGATE_EXISTS,
-		DEFER_FAILURE_DELEGATE_ALREADY_PENDING_ADD,
-		DEFERRED
-	};
-
-	struct Timer
-	{
-	public:
-		/* @returns true when timer is complete and should be removed */
-		bool update(float dt_sec_dilated);
-		void reset();
-		void set(const sp<MultiDelegate<>>& callbackDelegate, float duration, bool bLoop, float delaySecs);
-		const sp<MultiDelegate<>>& getUserCallback() { return userCallback; }
-
-	private:
-		float durationSecs = 0.f;
-		float currentTime = 0.f;
-		bool bLoop = false;
-		sp<MultiDelegate<>> userCallback;
-	};
-
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	//An object that manipulates time; this allows creating time systems based on the true time, but with effects like 
 	//time dilation and time stepping and setting timers influenced on those effects
@@ -78,16 +53,27 @@ namespace SA
 		/** timer functions returning bool indicate success/failure */
 		ETimerOperationResult createTimer(const sp<MultiDelegate<>>& callbackDelegate, float durationSec, bool bLoop = false, float delaySecs = 0.f);
 
-		/* notes: will if timer is going to tick this frame, the timer will tick regardless of if timer is removed */
+		/* notes: removing while timers are firing is deferred to the end of the frame, but the removed timer will not fire again */
 		ETimerOperationResult removeTimer(const sp<MultiDelegate<>>& callbackDelegate);
 		bool hasTimerForDelegate(const sp<MultiDelegate<>>& timerBoundDelegate);
+		inline const TimerWheel& getTimers() const { return timers; }
 
 	public: //tickers
-		//#optimize ticking using virtual dispatch is probably an unneccsary perf hit. 
+		/** ITickables tick before every tick group, through virtual dispatch, one object at a time. */
 		void registerTicker(const sp<ITickable>& tickable);
 		void removeTicker(const sp<ITickable>& tickable);
 		bool hasRegisteredTicker(const sp<ITickable>& tickable);
 
+		/** Ticks tickable in tickGroup's slot, batched with every other object of type T using the same tick function.
+			eg: registerTypedTicker<&Task_Ship_MoveToLocation::tick>(TickGroups::get().GAME, sp_this());
+			TickFn returns void, or bool where false unregisters the object. The registration keeps tickable alive. */
+		template<auto TickFn, typename T>
+		void registerTypedTicker(const TickGroupDefinition& tickGroup, const sp<T>& tickable) { tickDispatcher.registerTypedTicker<TickFn>(tickGroup.sortIdx(), tickable); }
+		template<auto TickFn, typename T>
+		void removeTypedTicker(const TickGroupDefinition& tickGroup, const sp<T>& tickable) { tickDispatcher.removeTypedTicker<TickFn>(tickGroup.sortIdx(), tickable); }
+		template<auto TickFn, typename T>
+		bool hasTypedTicker(const TickGroupDefinition& tickGroup, const sp<T>& tickable) { return tickDispatcher.hasTypedTicker<TickFn>(tickGroup.sortIdx(), tickable); }
+
 	private:
 		//next frame pattern prevents affects from happening mid-frame
 		float dt_undilatedSecs = 0.f;
@@ -101,39 +87,11 @@ namespace SA
 		float timeDilationFactor = 1.f;
 		float DilationFactor_nextFrame = 1.f;
 
-		bool bTickingTimers = false;
-
-		IterableHashSet<sp<Timer>> timers;
-		std::unordered_map<MultiDelegate<>*, sp<Timer>> delegateToTimerMap;
-
-		////////////////////////////////////////////////////////
-		//Timer helper data structures; 
-		////////////////////////////////////////////////////////
-		//helpers to add timers if user attempts to set timer while the timers are ticking
-		IterableHashSet<sp<Timer>> deferredTimersToAdd;
-		std::unordered_map<MultiDelegate<>*, sp<Timer>> deferredTimerDelegatesToAdd;
-		//deferred removes
-		std::vector<sp<Timer>> timersToRemoveWhenTickingOver;
-		uint32_t removeTimerReservationSpace = 20;
-		uint32_t tickerDeferredRegistrationMinBufferSize = 100;
-
-		////////////////////////////////////////////////////////
-		// Ticker helper data structures
-		////////////////////////////////////////////////////////
-		bool bIsTickingTickables = false;
-		IterableHashSet<sp<ITickable>> tickables;
-		IterableHashSet<sp<ITickable>> pendingRemovalTickables;
-		IterableHashSet<sp<ITickable>> pendingAddTickables;
-
-		//#todo perhaps replace ITickable and only have tick groups. I think ITickable currently has better performance.
-		struct TickGroupEntry 
-		{
-			std::string name;
-			float priority = 0.f;
-			size_t sortIdx = 0;
-			sp<MultiDelegate<float /*dt_sec*/>> onTick = nullptr;
-		};
-		std::vector<TickGroupEntry> tickGroups;
+		//timers are bucketed by expiry; only timers coming due are touched each frame
+		TimerWheel timers;
+
+		//ITickables, then tick groups in priority order
+		TickDispatcher tickDispatcher;
 	};
 
 
@@ -150,6 +108,9 @@ namespace SA
 		inline float getMAX_DELTA_TIME_SECS() const { return MAX_DELTA_TIME_SECS; };
 		inline bool isUpdatingTime() const { return bUpdatingTime; }
 
+		/** Advances every frame by exactly this much instead of by wall clock time; 0 uses the wall clock. For repeatable runs like the headless benchmark. */
+		inline void setFixedDeltaTimeSecs(float inFixedDeltaTimeSecs) { fixedDeltaTimeSecs = inFixedDeltaTimeSecs; }
+
 		/* Private key only allows friends to call ctor*/
 		struct PrivateKey { private: friend class GameBase; PrivateKey() {}; };
 		void updateTime(PrivateKey);
@@ -165,6 +126,7 @@ namespace SA
 		float rawDeltaTimeSecs = 0;
 		float deltaTimeSecs = 0.f;
 		float MAX_DELTA_TIME_SECS = 0.5f;
+		float fixedDeltaTimeSecs = 0.f;
 
 		bool bUpdatingTime = false;
 
@@ -11,7 +11,10 @@ namespace SA
 		onWindowLosingOpenglContext.broadcast(focusedWindow);
 		if (window)
 		{
-			glfwMakeContextCurrent(window->get());
+			if (!window->isHeadless())
+			{
+				glfwMakeContextCurrent(window->get());
+			}
 
 			focusedWindow = window; //make sure assignment happens before event broadcast
 
@@ -26,7 +29,11 @@ namespace SA
 
 	void WindowSystem::tick(float deltaSec)
 	{
-		glfwPollEvents();
+		//a headless window is not backed by glfw, so there are no events to poll
+		if (!focusedWindow || !focusedWindow->isHeadless())
+		{
+			glfwPollEvents();
+		}
 
 		if (focusedWindow)
 		{
@@ -49,7 +56,7 @@ namespace SA
 	void WindowSystem::handlePostRender()
 	{
 		//will need to do this for all windows that were rendered to if supporting more than a single window
-		if (focusedWindow)
+		if (focusedWindow && !focusedWindow->isHeadless())
 		{
 			glfwSwapBuffers(focusedWindow->get());
 		}
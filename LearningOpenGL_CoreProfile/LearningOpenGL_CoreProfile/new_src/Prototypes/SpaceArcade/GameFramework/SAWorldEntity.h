@@ -2,6 +2,8 @@
 #include "SAGameEntity.h"
 #include "../Tools/DataStructures/SATransform.h"
 #include "../Tools/DataStructures/MultiDelegate.h"
+#include "../Tools/DataStructures/InlineMultiDelegate.h"
+#include "../Tools/DataStructures/SlotMap.h"
 #include "Interfaces/SATickable.h"
 #include "Components/SAComponentEntity.h"
 
@@ -24,6 +26,7 @@ namespace SA
 	*/
 	class WorldEntity : public GameplayComponentEntity, public Tickable
 	{
+		friend LevelBase;
 	public:
 		WorldEntity(Transform spawnTransform = Transform{})
 			: transform(spawnTransform)
@@ -37,14 +40,18 @@ namespace SA
 		virtual glm::vec3 getWorldPosition() const { return transform.position; } //#scenenodes todo update
 		glm::mat4 getModelMatrix() const { return transform.getModelMatrix(); } //#scenenodes todo update
 
+		/** Handle to this entity in the level that spawned it; see LevelBase::findEntity. Stale once unspawned. */
+		const SlotHandle& getLevelHandle() const { return levelHandle; }
+
 	protected:
 		/** World returns a raw pointer because caching a world sp will often result cyclic references. 
 			A raw pointer should make a programmer think about how to safely cache it and find this message.*/
 		LevelBase* getWorld();
 	public:
-		MultiDelegate<const Transform& /*xform*/> onTransformUpdated;
+		InlineMultiDelegate<const Transform& /*xform*/> onTransformUpdated; //broadcast by every moving entity, every frame
 
 	private:
 		Transform transform; //#TODO #scenenodes #componentize
+		SlotHandle levelHandle;
 	};
 }
@@ -0,0 +1,97 @@
+#include "TickDispatcher.h"
+
+namespace SA
+{
+	size_t TickDispatcher::addTickGroup(const std::string& name)
+	{
+		tickGroups.emplace_back();
+		TickGroupEntry& tickGroup = tickGroups.back();
+		tickGroup.name = name;
+		tickGroup.onTick = new_sp<MultiDelegate<float /*dt_sec*/>>(); //this makes copies shallow, which is what we want. Currently no copies should be possible.
+		return tickGroups.size() - 1;
+	}
+
+	void TickDispatcher::tick(float dt_sec)
+	{
+		////////////////////////////////////////////////////////
+		// Tick Tickables
+		////////////////////////////////////////////////////////
+		bIsTickingTickables = true;
+		for (const sp<ITickable>& tickable : tickables)
+		{
+			bool bKeepTicking = tickable->tick(dt_sec);
+			if (!bKeepTicking) { pendingRemovalTickables.insert(tickable); }
+		}
+		bIsTickingTickables = false;
+		for (const sp<ITickable>& tickable : pendingAddTickables)
+		{
+			tickables.insert(tickable);
+		}
+		for (const sp<ITickable>& tickable : pendingRemovalTickables)
+		{
+			tickables.remove(tickable);
+		}
+		pendingAddTickables.clear();
+		pendingRemovalTickables.clear();
+
+		////////////////////////////////////////////////////////
+		// Tick Groups
+		////////////////////////////////////////////////////////
+		for (size_t groupIdx = 0; groupIdx < tickGroups.size(); ++groupIdx)
+		{
+			//index batches; a tick may register the first object of a new type and grow this array. That batch starts next frame.
+			const size_t numBatches = tickGroups[groupIdx].typedBatches.size();
+			for (size_t batchIdx = 0; batchIdx < numBatches; ++batchIdx)
+			{
+				tickGroups[groupIdx].typedBatches[batchIdx]->tickBatch(dt_sec);
+			}
+
+			//delegate already cover subscription/removal edge cases, they do not need to be covered here. Just let someone attempt to register to event and it will be applied after broadcast.
+			tickGroups[groupIdx].onTick->broadcast(dt_sec);
+		}
+
+		//removals from any group may happen during any other group's tick, so compact once everything has ticked
+		for (TickGroupEntry& tickGroup : tickGroups)
+		{
+			for (const up<TypedTickBatchBase>& batch : tickGroup.typedBatches)
+			{
+				batch->compact();
+			}
+		}
+	}
+
+	void TickDispatcher::registerTicker(const sp<ITickable>& tickable)
+	{
+		//WARNING: don't check tickables contains the new tickable and early out if it does; if you do removing then adding in same tick frame will break.
+		//^^Since we're dealing with sets, it isn't really necessary to do that check anyways. This has a test case in the unit tests "readdition test".
+		if (bIsTickingTickables)
+		{
+			pendingAddTickables.insert(tickable);
+			pendingRemovalTickables.remove(tickable); //remove previous attempt to clear! Last operation will be the valid one.
+		}
+		else
+		{
+			tickables.insert(tickable);
+		}
+	}
+
+	void TickDispatcher::removeTicker(const sp<ITickable>& tickable)
+	{
+		if (bIsTickingTickables)
+		{
+			pendingRemovalTickables.insert(tickable);
+			pendingAddTickables.remove(tickable); //remove previous attempt to add this frame! Last operation will be the valid one.
+		}
+		else
+		{
+			tickables.remove(tickable);
+		}
+	}
+
+	bool TickDispatcher::hasRegisteredTicker(const sp<ITickable>& tickable)
+	{
+		//return tickables.contains(tickable);
+		return (tickables.contains(tickable) || pendingAddTickables.contains(tickable))
+			&& !pendingRemovalTickables.contains(tickable);
+	}
+}
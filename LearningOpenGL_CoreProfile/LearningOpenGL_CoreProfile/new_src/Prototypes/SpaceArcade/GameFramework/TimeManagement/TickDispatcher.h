@@ -0,0 +1,99 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../SAGameEntity.h"
+#include "../Interfaces/SATickable.h"
+#include "../../Tools/DataStructures/MultiDelegate.h"
+#include "../../Tools/DataStructures/IterableHashSet.h"
+#include "TypedTickBatch.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Runs everything a TimeManager ticks each frame, in this order:
+	//		1. ITickables registered with registerTicker (unordered among themselves)
+	//		2. each tick group in the order it was added (TimeManager adds them sorted by priority); within a group
+	//			a. typed batches, in the order their type was first registered to the group; objects in registration order
+	//			b. the group's event (getEvent) subscribers
+	//
+	//	Typed registration groups objects of the same concrete type into one contiguous batch per tick group;
+	//	see TypedTickBatch.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class TickDispatcher final
+	{
+	public:
+		/** @return index of the new group; groups tick in the order they are added */
+		size_t addTickGroup(const std::string& name);
+		size_t getNumTickGroups() const { return tickGroups.size(); }
+		MultiDelegate<float /*dt_sec*/>& getEvent(size_t groupIdx) { return *tickGroups[groupIdx].onTick; }
+
+		void tick(float dt_sec);
+
+	public: //ITickables
+		void registerTicker(const sp<ITickable>& tickable);
+		void removeTicker(const sp<ITickable>& tickable);
+		bool hasRegisteredTicker(const sp<ITickable>& tickable);
+
+	public: //typed tickers
+		/** eg registerTypedTicker<&Ship::tickAI>(groupIdx, sp_this()); registering an object twice with the same function is ignored. */
+		template<auto TickFn, typename T>
+		void registerTypedTicker(size_t groupIdx, const sp<T>& tickable)
+		{
+			TickGroupEntry& group = tickGroups[groupIdx];
+			const void* batchKey = TypedTickBatch<T, TickFn>::key();
+
+			auto findResult = group.batchIndices.find(batchKey);
+			if (findResult == group.batchIndices.end())
+			{
+				//appending while the group is ticking is fine; tick() indexes batches and only ticks the ones that existed when the group started
+				findResult = group.batchIndices.insert({ batchKey, group.typedBatches.size() }).first;
+				group.typedBatches.push_back(new_up<TypedTickBatch<T, TickFn>>());
+			}
+			static_cast<TypedTickBatch<T, TickFn>&>(*group.typedBatches[findResult->second]).add(tickable);
+		}
+
+		template<auto TickFn, typename T>
+		void removeTypedTicker(size_t groupIdx, const sp<T>& tickable)
+		{
+			if (TypedTickBatch<T, TickFn>* batch = findBatch<T, TickFn>(groupIdx))
+			{
+				batch->remove(tickable.get());
+			}
+		}
+
+		template<auto TickFn, typename T>
+		bool hasTypedTicker(size_t groupIdx, const sp<T>& tickable)
+		{
+			TypedTickBatch<T, TickFn>* batch = findBatch<T, TickFn>(groupIdx);
+			return batch && batch->contains(tickable.get());
+		}
+
+		size_t getNumTypedBatches(size_t groupIdx) const { return tickGroups[groupIdx].typedBatches.size(); }
+
+	private:
+		template<typename T, auto TickFn>
+		TypedTickBatch<T, TickFn>* findBatch(size_t groupIdx)
+		{
+			TickGroupEntry& group = tickGroups[groupIdx];
+			auto findResult = group.batchIndices.find(TypedTickBatch<T, TickFn>::key());
+			return findResult != group.batchIndices.end() ? static_cast<TypedTickBatch<T, TickFn>*>(group.typedBatches[findResult->second].get()) : nullptr;
+		}
+
+	private:
+		bool bIsTickingTickables = false;
+		IterableHashSet<sp<ITickable>> tickables;
+		IterableHashSet<sp<ITickable>> pendingRemovalTickables;
+		IterableHashSet<sp<ITickable>> pendingAddTickables;
+
+		struct TickGroupEntry
+		{
+			std::string name;
+			sp<MultiDelegate<float /*dt_sec*/>> onTick = nullptr;
+			std::vector<up<TypedTickBatchBase>> typedBatches;
+			std::unordered_map<const void*, size_t> batchIndices;
+		};
+		std::vector<TickGroupEntry> tickGroups;
+	};
+}
@@ -0,0 +1,339 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <assert.h>
+
+namespace SA
+{
+	static constexpr uint32_t SLOT_MASK = TimerWheel::SLOTS_PER_LEVEL - 1;
+
+	TimerWheel::TimerWheel()
+	{
+		slotHeads.resize(NUM_LEVELS * SLOTS_PER_LEVEL, INVALID);
+	}
+
+	ETimerOperationResult TimerWheel::createTimer(const sp<MultiDelegate<>>& callbackDelegate, float durationSec, bool bLoop /*= false*/, float delaySecs /*= 0.f*/)
+	{
+		if (durationSec < 0) //setting duration equal to 0 is like a "next tick" timer
+		{
+			return ETimerOperationResult::FAILURE_NEGATIVE_DURATION;
+		}
+
+		const bool bExists = delegateToTimer.find(callbackDelegate.get()) != delegateToTimer.end();
+		if (bFiring)
+		{
+			//technically this timer could be pending remove after its tick, but if user wants that then they should be looping
+			if (bExists) { return ETimerOperationResult::DEFER_FAILURE_TIMER_FOR_DELEGATE_EXISTS; }
+			if (pendingAdds.find(callbackDelegate.get()) != pendingAdds.end()) { return ETimerOperationResult::DEFER_FAILURE_DELEGATE_ALREADY_PENDING_ADD; }
+		}
+		else if (bExists)
+		{
+			return ETimerOperationResult::FAILURE_TIMER_FOR_DELEGATE_EXISTS;
+		}
+
+		uint32_t entryIdx = allocateEntry();
+		TimerEntry& entry = entries[entryIdx];
+		entry.userCallback = callbackDelegate;
+		entry.durationSecs = durationSec;
+		entry.bLoop = bLoop;
+		entry.order = nextOrder++;
+
+		//now is already the end of the current frame while firing, so deferred timers start from the same point they would after the frame
+		entry.expirySecs = nowSecs + double(delaySecs) + double(durationSec);
+
+		if (bFiring)
+		{
+			/*! adding during firing would let the new timer fire within the frame that created it */
+			pendingAdds.insert({ callbackDelegate.get(), entryIdx });
+			pendingAddOrder.push_back(entryIdx);
+		}
+		else
+		{
+			delegateToTimer.insert({ callbackDelegate.get(), entryIdx });
+			schedule(entryIdx);
+		}
+
+		return ETimerOperationResult::SUCCESS;
+	}
+
+	ETimerOperationResult TimerWheel::removeTimer(const sp<MultiDelegate<>>& callbackDelegate)
+	{
+		auto findResult = delegateToTimer.find(callbackDelegate.get());
+		if (findResult == delegateToTimer.end())
+		{
+			return ETimerOperationResult::FAILURE_TIMER_NOT_FOUND;
+		}
+
+		uint32_t entryIdx = findResult->second;
+		if (!bFiring)
+		{
+			unlink(entryIdx);
+			release(entryIdx);
+			return ETimerOperationResult::SUCCESS;
+		}
+
+		//keep the delegate mapped until firing is over so the timer cannot be replaced mid-frame
+		TimerEntry& entry = entries[entryIdx];
+		if (!entry.bRemoved)
+		{
+			entry.bRemoved = true;
+			unlink(entryIdx);
+			pendingRelease.push_back(entryIdx);
+		}
+		return ETimerOperationResult::DEFERRED;
+	}
+
+	bool TimerWheel::hasTimerForDelegate(const sp<MultiDelegate<>>& timerBoundDelegate) const
+	{
+		if (timerBoundDelegate)
+		{
+			return delegateToTimer.find(timerBoundDelegate.get()) != delegateToTimer.end();
+		}
+		return false;
+	}
+
+	void TimerWheel::advance(float dt_sec)
+	{
+		numVisitedLastAdvance = 0;
+		if (dt_sec <= 0.f)
+		{
+			//timers fire strictly after their expiry, so nothing can come due without time passing
+			return;
+		}
+
+		nowSecs += double(dt_sec);
+		const uint64_t targetTick = toTick(nowSecs);
+
+		bFiring = true;
+		{
+			//the current tick may still hold timers that were not due at the end of the last frame
+			fireSlot(uint32_t(currentTick & SLOT_MASK));
+
+			while (currentTick < targetTick)
+			{
+				++currentTick;
+
+				//redistribute higher levels top down, so a slot cascaded out of level 2 can cascade again out of level 1 on the same tick
+				for (uint32_t level = NUM_LEVELS - 1; level > 0; --level)
+				{
+					const uint64_t levelSpanMask = (uint64_t(1) << (SLOT_BITS * level)) - 1;
+					if ((currentTick & levelSpanMask) == 0)
+					{
+						cascade(level);
+					}
+				}
+
+				fireSlot(uint32_t(currentTick & SLOT_MASK));
+			}
+		}
+		bFiring = false;
+
+		////////////////////////////////////////////////////////
+		//release finished timers before adding deferred timers
+		////////////////////////////////////////////////////////
+		for (uint32_t entryIdx : pendingRelease)
+		{
+			release(entryIdx);
+		}
+		pendingRelease.clear();
+
+		////////////////////////////////////////////////////////
+		//add deferred timers
+		////////////////////////////////////////////////////////
+		for (uint32_t entryIdx : pendingAddOrder)
+		{
+			delegateToTimer.insert({ entries[entryIdx].userCallback.get(), entryIdx });
+			schedule(entryIdx);
+		}
+		pendingAddOrder.clear();
+		pendingAdds.clear();
+	}
+
+	uint64_t TimerWheel::toTick(double timeSecs) const
+	{
+		return timeSecs > 0.0 ? uint64_t(timeSecs * TICKS_PER_SEC) : 0;
+	}
+
+	uint32_t TimerWheel::allocateEntry()
+	{
+		if (!freeEntries.empty())
+		{
+			uint32_t entryIdx = freeEntries.back();
+			freeEntries.pop_back();
+			return entryIdx;
+		}
+		entries.emplace_back();
+		return uint32_t(entries.size() - 1);
+	}
+
+	void TimerWheel::schedule(uint32_t entryIdx)
+	{
+		//timers due in the past (eg negative delays) go in the current tick and fire on the next advance
+		const uint64_t tick = std::max(toTick(entries[entryIdx].expirySecs), currentTick);
+
+		//place the timer in the lowest level whose span still contains both the cursor and the expiry
+		const uint32_t topLevel = NUM_LEVELS - 1;
+		for (uint32_t level = 0; level < topLevel; ++level)
+		{
+			const uint32_t aboveLevelShift = SLOT_BITS * (level + 1);
+			if ((tick >> aboveLevelShift) == (currentTick >> aboveLevelShift))
+			{
+				link(entryIdx, level * SLOTS_PER_LEVEL + uint32_t((tick >> (SLOT_BITS * level)) & SLOT_MASK));
+				return;
+			}
+		}
+
+		//the top level wraps; its slots are cascaded when the cursor reaches them. Timers further out than a full turn are
+		//parked in the slot that will be cascaded last and are re-placed from there, which is always before they are due.
+		const uint32_t topShift = SLOT_BITS * topLevel;
+		const uint64_t topSlotsAhead = (tick >> topShift) - (currentTick >> topShift);
+		const uint64_t topSlot = topSlotsAhead < SLOTS_PER_LEVEL ? (tick >> topShift) : (currentTick >> topShift) + SLOT_MASK;
+		link(entryIdx, topLevel * SLOTS_PER_LEVEL + uint32_t(topSlot & SLOT_MASK));
+	}
+
+	void TimerWheel::link(uint32_t entryIdx, uint32_t slot)
+	{
+		TimerEntry& entry = entries[entryIdx];
+		assert(entry.slot == NOT_LINKED);
+
+		entry.slot = slot;
+		entry.prev = INVALID;
+		entry.next = slotHeads[slot];
+		if (entry.next != INVALID)
+		{
+			entries[entry.next].prev = entryIdx;
+		}
+		slotHeads[slot] = entryIdx;
+	}
+
+	void TimerWheel::unlink(uint32_t entryIdx)
+	{
+		TimerEntry& entry = entries[entryIdx];
+		if (entry.slot == NOT_LINKED)
+		{
+			return;
+		}
+
+		if (entry.prev != INVALID) { entries[entry.prev].next = entry.next; }
+		else { slotHeads[entry.slot] = entry.next; }
+		if (entry.next != INVALID) { entries[entry.next].prev = entry.prev; }
+
+		entry.prev = INVALID;
+		entry.next = INVALID;
+		entry.slot = NOT_LINKED;
+	}
+
+	void TimerWheel::cascade(uint32_t level)
+	{
+		const uint32_t slot = level * SLOTS_PER_LEVEL + uint32_t((currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+
+		uint32_t entryIdx = slotHeads[slot];
+		slotHeads[slot] = INVALID;
+		while (entryIdx != INVALID)
+		{
+			++numVisitedLastAdvance;
+
+			TimerEntry& entry = entries[entryIdx];
+			uint32_t next = entry.next;
+			entry.prev = INVALID;
+			entry.next = INVALID;
+			entry.slot = NOT_LINKED;
+
+			schedule(entryIdx);
+			entryIdx = next;
+		}
+	}
+
+	void TimerWheel::fireSlot(uint32_t slot)
+	{
+		dueScratch.clear();
+		for (uint32_t entryIdx = slotHeads[slot]; entryIdx != INVALID; )
+		{
+			++numVisitedLastAdvance;
+
+			uint32_t next = entries[entryIdx].next;
+			if (nowSecs > entries[entryIdx].expirySecs)
+			{
+				unlink(entryIdx);
+				dueScratch.push_back(entryIdx);
+			}
+			entryIdx = next;
+		}
+
+		//a slot spans a whole tick, fire in expiry order within it
+		std::sort(dueScratch.begin(), dueScratch.end(),
+			[this](uint32_t a, uint32_t b)
+			{
+				const TimerEntry& entryA = entries[a];
+				const TimerEntry& entryB = entries[b];
+				return entryA.expirySecs != entryB.expirySecs ? entryA.expirySecs < entryB.expirySecs : entryA.order < entryB.order;
+			});
+
+		//callbacks may create or remove timers; creations are deferred so this scratch list stays valid, removals flag the entry
+		for (size_t dueIdx = 0; dueIdx < dueScratch.size(); ++dueIdx)
+		{
+			fire(dueScratch[dueIdx]);
+		}
+		dueScratch.clear();
+	}
+
+	void TimerWheel::fire(uint32_t entryIdx)
+	{
+		//if timer should have ticked twice in time-frame, then tick it twice.
+		//the alternative may cause unexpected behavior for user
+		//note: entries may reallocate during broadcast (deferred adds), so do not hold references across it
+		while (!entries[entryIdx].bRemoved && nowSecs > entries[entryIdx].expirySecs)
+		{
+			sp<MultiDelegate<>> userCallback = entries[entryIdx].userCallback;
+			if (!userCallback || userCallback->numBound() == 0)
+			{
+				break;
+			}
+
+			userCallback->broadcast();
+
+			TimerEntry& entry = entries[entryIdx];
+			if (entry.bRemoved)
+			{
+				return; //removed by its own callback; removeTimer already queued the release
+			}
+			if (!entry.bLoop)
+			{
+				break;
+			}
+
+			//zero length loops fire once per frame rather than spinning forever
+			entry.expirySecs = entry.durationSecs > 0.f ? entry.expirySecs + double(entry.durationSecs) : nowSecs;
+		}
+
+		TimerEntry& entry = entries[entryIdx];
+		if (entry.bRemoved)
+		{
+			return;
+		}
+
+		if (entry.bLoop && entry.userCallback && entry.userCallback->numBound() > 0)
+		{
+			schedule(entryIdx);
+		}
+		else
+		{
+			//finished; the delegate keeps its timer until firing is over, like a removal during firing
+			entry.bRemoved = true;
+			pendingRelease.push_back(entryIdx);
+		}
+	}
+
+	void TimerWheel::release(uint32_t entryIdx)
+	{
+		TimerEntry& entry = entries[entryIdx];
+
+		auto findResult = delegateToTimer.find(entry.userCallback.get());
+		if (findResult != delegateToTimer.end() && findResult->second == entryIdx)
+		{
+			delegateToTimer.erase(findResult);
+		}
+
+		entry = TimerEntry{};
+		freeEntries.push_back(entryIdx);
+	}
+}
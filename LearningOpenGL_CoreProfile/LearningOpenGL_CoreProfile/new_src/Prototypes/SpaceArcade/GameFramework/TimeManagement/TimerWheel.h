@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+
+#include "../SAGameEntity.h"
+#include "../../Tools/DataStructures/MultiDelegate.h"
+
+namespace SA
+{
+	//#consider this may be better suited as bit-vector for masking operations (eg SUCCESS = DEFERRED | REMOVED | ADDED)
+	enum class ETimerOperationResult : char
+	{
+		SUCCESS = 0,
+		FAILURE_TIMER_FOR_DELEGATE_EXISTS,
+		FAILURE_TIMER_NOT_FOUND,
+		FAILURE_NEGATIVE_DURATION,
+		DEFER_FAILURE_TIMER_FOR_DELEGATE_EXISTS,
+		DEFER_FAILURE_DELEGATE_ALREADY_PENDING_ADD,
+		DEFERRED
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Hierarchical timing wheel; the timer storage behind TimeManager.
+	//
+	//	Timers are bucketed by the tick (1/TICKS_PER_SEC of a second) they expire on. Level 0 holds the next
+	//	SLOTS_PER_LEVEL ticks one slot per tick; each level above covers SLOTS_PER_LEVEL times the span of the one below.
+	//	When the cursor crosses a level boundary, that level's slot is redistributed into the levels below it.
+	//	advance() only visits slots the cursor passes, so its cost follows the number of timers firing (plus the
+	//	occasional cascade) rather than the number of live timers.
+	//
+	//	Semantics match the old per-timer update:
+	//		-a timer fires once the time advanced since it was created exceeds delay + duration; looping timers fire
+	//			as many times as fit in a frame.
+	//		-timers created while timers are firing are added after firing completes, and start from that point.
+	//		-removing while timers are firing is deferred; the delegate keeps its timer until the end of the frame.
+	//		-a timer whose delegate has no bindings when it comes due is dropped without firing.
+	//	Removed timers never fire, even when they were due later in the same frame.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class TimerWheel final
+	{
+	public:
+		static constexpr uint32_t TICKS_PER_SEC = 64;
+		static constexpr uint32_t SLOT_BITS = 6;
+		static constexpr uint32_t SLOTS_PER_LEVEL = 1 << SLOT_BITS;
+		static constexpr uint32_t NUM_LEVELS = 4; //about 73 hours before timers start parking in the top level
+
+	public:
+		TimerWheel();
+
+		ETimerOperationResult createTimer(const sp<MultiDelegate<>>& callbackDelegate, float durationSec, bool bLoop = false, float delaySecs = 0.f);
+		ETimerOperationResult removeTimer(const sp<MultiDelegate<>>& callbackDelegate);
+		bool hasTimerForDelegate(const sp<MultiDelegate<>>& timerBoundDelegate) const;
+
+		/** Advances time and fires every timer that came due. dt_sec should already be dilated; pass 0 while time is frozen. */
+		void advance(float dt_sec);
+
+		size_t getNumTimers() const { return delegateToTimer.size(); }
+		double getTimeSecs() const { return nowSecs; }
+		/** Timers looked at by the last advance; fired timers, timers sharing their slot, and cascaded timers. */
+		size_t getNumTimersVisitedLastAdvance() const { return numVisitedLastAdvance; }
+
+	private:
+		static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+		static constexpr uint32_t NOT_LINKED = std::numeric_limits<uint32_t>::max();
+
+		struct TimerEntry
+		{
+			sp<MultiDelegate<>> userCallback;
+			double expirySecs = 0.0;
+			float durationSecs = 0.f;
+			uint32_t prev = INVALID;
+			uint32_t next = INVALID;
+			uint32_t slot = NOT_LINKED;		//flat index into slotHeads
+			uint64_t order = 0;				//creation order; ties between equal expiries fire oldest first
+			bool bLoop = false;
+			bool bRemoved = false;			//removed or finished; freed at the end of the frame
+		};
+
+	private:
+		uint64_t toTick(double timeSecs) const;
+		uint32_t allocateEntry();
+		void schedule(uint32_t entryIdx);
+		void link(uint32_t entryIdx, uint32_t slot);
+		void unlink(uint32_t entryIdx);
+		void cascade(uint32_t level);
+		void fireSlot(uint32_t slot);
+		void fire(uint32_t entryIdx);
+		void release(uint32_t entryIdx);
+
+	private:
+		std::vector<TimerEntry> entries;
+		std::vector<uint32_t> freeEntries;
+		std::vector<uint32_t> slotHeads;		//NUM_LEVELS * SLOTS_PER_LEVEL intrusive lists
+		std::unordered_map<MultiDelegate<>*, uint32_t> delegateToTimer;
+
+		//deferred work while firing
+		std::unordered_map<MultiDelegate<>*, uint32_t> pendingAdds;
+		std::vector<uint32_t> pendingAddOrder;
+		std::vector<uint32_t> pendingRelease;
+		std::vector<uint32_t> dueScratch;
+
+		double nowSecs = 0.0;
+		uint64_t currentTick = 0;		//cascades for this tick are done; its level 0 slot may still hold timers due later this tick
+		uint64_t nextOrder = 0;
+		size_t numVisitedLastAdvance = 0;
+		bool bFiring = false;
+	};
+}
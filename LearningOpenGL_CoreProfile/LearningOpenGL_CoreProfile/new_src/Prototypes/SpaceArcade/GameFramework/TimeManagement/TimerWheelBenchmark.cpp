@@ -0,0 +1,175 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+
+#include "TimerWheel.h"
+#include "../../Tools/DataStructures/IterableHashSet.h"
+
+/*
+	Headless benchmark for timers; no window, GL context, or game systems are created.
+
+	Mimics the timer load of a busy level: many long lived timers (projectile lifetimes, audio GC) that are mostly
+	waiting, plus a few hundred short looping timers (AI services). Every frame a batch of one-shot timers is created
+	to replace the ones that fired. The same script runs against the previous TimeManager storage (a hash set of pooled
+	timers, each updated every frame) and the timer wheel. Both runs count the same number of fired callbacks.
+*/
+
+namespace
+{
+	using namespace SA;
+
+	struct Counter : public GameEntity
+	{
+		void handleFired() { ++fired; }
+		uint64_t fired = 0;
+	};
+
+	/** the timer storage before the wheel; every timer is visited every frame */
+	class LegacyTimers
+	{
+		struct Timer
+		{
+			bool update(float dt_sec)
+			{
+				if (userCallback->numBound() == 0) { return true; }
+				currentTime += dt_sec;
+				while (currentTime > durationSecs)
+				{
+					userCallback->broadcast();
+					currentTime -= durationSecs;
+					if (!bLoop) { return true; }
+				}
+				return false;
+			}
+
+			float durationSecs = 0.f;
+			float currentTime = 0.f;
+			bool bLoop = false;
+			sp<MultiDelegate<>> userCallback;
+		};
+		IterableHashSet<sp<Timer>> timers;
+		std::unordered_map<MultiDelegate<>*, sp<Timer>> delegateToTimerMap;
+		std::vector<sp<Timer>> toRemove;
+
+	public:
+		void createTimer(const sp<MultiDelegate<>>& callbackDelegate, float durationSec, bool bLoop)
+		{
+			sp<Timer> timer = new_sp<Timer>();
+			timer->durationSecs = durationSec;
+			timer->bLoop = bLoop;
+			timer->userCallback = callbackDelegate;
+			timers.insert(timer);
+			delegateToTimerMap.insert({ callbackDelegate.get(), timer });
+		}
+
+		void advance(float dt_sec)
+		{
+			for (const sp<Timer>& timer : timers)
+			{
+				if (timer->update(dt_sec)) { toRemove.push_back(timer); }
+			}
+			for (const sp<Timer>& timer : toRemove)
+			{
+				delegateToTimerMap.erase(timer->userCallback.get());
+				timers.remove(timer);
+			}
+			toRemove.clear();
+		}
+	};
+
+	struct BenchConfig
+	{
+		size_t numIdleTimers = 100000;
+		size_t numLoopingTimers = 500;
+		size_t numOneShotsPerFrame = 200;
+		int numFrames = 600;
+		float dt_sec = 1.f / 60.f;
+	};
+
+	struct BenchResults
+	{
+		double totalMs = 0.0;
+		uint64_t fired = 0;
+	};
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	/** delegates are made up front so both runs measure timer bookkeeping, not delegate construction */
+	std::vector<sp<MultiDelegate<>>> makeDelegates(size_t count, const sp<Counter>& counter)
+	{
+		std::vector<sp<MultiDelegate<>>> delegates;
+		delegates.reserve(count);
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			delegates.push_back(new_sp<MultiDelegate<>>());
+			delegates.back()->addStrongObj(counter, &Counter::handleFired);
+		}
+		return delegates;
+	}
+
+	template<typename TimerStorage>
+	BenchResults run(const BenchConfig& config, TimerStorage& timers)
+	{
+		sp<Counter> counter = new_sp<Counter>();
+		const size_t numOneShots = config.numOneShotsPerFrame * config.numFrames;
+		std::vector<sp<MultiDelegate<>>> delegates = makeDelegates(config.numIdleTimers + config.numLoopingTimers + numOneShots, counter);
+
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> idleDuration(30.f, 600.f);
+		std::uniform_real_distribution<float> loopDuration(0.1f, 2.f);
+		std::uniform_real_distribution<float> oneShotDuration(0.05f, 3.f);
+
+		size_t nextDelegate = 0;
+		for (size_t idx = 0; idx < config.numIdleTimers; ++idx) { timers.createTimer(delegates[nextDelegate++], idleDuration(rng), false); }
+		for (size_t idx = 0; idx < config.numLoopingTimers; ++idx) { timers.createTimer(delegates[nextDelegate++], loopDuration(rng), true); }
+
+		BenchResults results;
+		Clock::time_point start = Clock::now();
+		for (int frame = 0; frame < config.numFrames; ++frame)
+		{
+			for (size_t idx = 0; idx < config.numOneShotsPerFrame; ++idx)
+			{
+				timers.createTimer(delegates[nextDelegate++], oneShotDuration(rng), false);
+			}
+			timers.advance(config.dt_sec);
+		}
+		results.totalMs = elapsedMs(start);
+		results.fired = counter->fired;
+		return results;
+	}
+
+	void printResults(const char* storageName, const BenchConfig& config, const BenchResults& results)
+	{
+		std::cout << storageName << "\n"
+			<< "\ttotal:     " << results.totalMs << " ms\n"
+			<< "\tper frame: " << results.totalMs / config.numFrames << " ms with " << config.numIdleTimers + config.numLoopingTimers << "+ live timers\n"
+			<< "\tfired:     " << results.fired << std::endl;
+	}
+
+	void true_main()
+	{
+		BenchConfig config;
+
+		LegacyTimers legacy;
+		BenchResults legacyResults = run(config, legacy);
+		printResults("hash set of timers, all updated every frame (previous storage)", config, legacyResults);
+
+		TimerWheel wheel;
+		BenchResults wheelResults = run(config, wheel);
+		printResults("timer wheel", config, wheelResults);
+
+		//float accumulation in the legacy timers can move a timer across a frame boundary, so allow a little slack
+		const uint64_t difference = legacyResults.fired > wheelResults.fired ? legacyResults.fired - wheelResults.fired : wheelResults.fired - legacyResults.fired;
+		if (difference > legacyResults.fired / 100)
+		{
+			std::cerr << "MISMATCH: fired counts differ" << std::endl;
+		}
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
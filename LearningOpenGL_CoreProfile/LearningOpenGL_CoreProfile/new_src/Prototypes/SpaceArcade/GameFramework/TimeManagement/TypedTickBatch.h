@@ -0,0 +1,140 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+
+#include "../SAGameEntity.h"
+
+namespace SA
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Type erased handle to a batch; the tick group makes one call per batch per frame.
+	/////////////////////////////////////////////////////////////////////////////////////
+	class TypedTickBatchBase
+	{
+	public:
+		virtual ~TypedTickBatchBase() = default;
+		virtual void tickBatch(float dt_sec) = 0;
+		/** Drops entries removed this frame; never called while any batch is ticking so indices stay stable during ticks. */
+		virtual void compact() = 0;
+		virtual size_t size() const = 0;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Every object of type T registered to a tick group with the same tick function.
+	//
+	//	Objects are kept in a contiguous array in registration order and ticked by one loop calling
+	//	TickFn through a compile time constant, so the call can be inlined instead of dispatched
+	//	through each object's vtable (when TickFn is non-virtual or T is final).
+	//	TickFn may return void, or bool like ITickable::tick where false unregisters the object.
+	//
+	//	Registering during a tick appends; the new object starts ticking on its group's next tick.
+	//	Removing during a tick takes effect immediately; a removed object is not ticked again.
+	/////////////////////////////////////////////////////////////////////////////////////
+	template<typename T, auto TickFn>
+	class TypedTickBatch final : public TypedTickBatchBase
+	{
+		using TickReturn = decltype((std::declval<T*>()->*TickFn)(0.f));
+		static_assert(std::is_same_v<TickReturn, bool> || std::is_same_v<TickReturn, void>, "typed tick functions take (float dt_sec) and return bool or void");
+
+	public:
+		/** Unique per T/TickFn pair; used to find this batch within a tick group. */
+		static const void* key()
+		{
+			static const char batchKey = 0;
+			return &batchKey;
+		}
+
+		bool add(const sp<T>& object)
+		{
+			if (!object || indices.find(object.get()) != indices.end())
+			{
+				return false;
+			}
+			indices.insert({ object.get(), objects.size() });
+			objects.push_back(object.get());
+			owners.push_back(object);
+			return true;
+		}
+
+		bool remove(T* object)
+		{
+			auto findResult = indices.find(object);
+			if (findResult == indices.end())
+			{
+				return false;
+			}
+			removeAt(findResult->second);
+			return true;
+		}
+
+		bool contains(T* object) const { return indices.find(object) != indices.end(); }
+
+		virtual void tickBatch(float dt_sec) override
+		{
+			//objects added by ticks are appended past numToTick; index rather than iterate since appending may reallocate
+			const size_t numToTick = objects.size();
+			for (size_t idx = 0; idx < numToTick; ++idx)
+			{
+				if (T* object = objects[idx])
+				{
+					if constexpr (std::is_same_v<TickReturn, bool>)
+					{
+						if (!(object->*TickFn)(dt_sec) && objects[idx] == object)
+						{
+							removeAt(idx);
+						}
+					}
+					else
+					{
+						(object->*TickFn)(dt_sec);
+					}
+				}
+			}
+		}
+
+		virtual void compact() override
+		{
+			if (numRemoved == 0)
+			{
+				return;
+			}
+
+			size_t writeIdx = 0;
+			for (size_t readIdx = 0; readIdx < objects.size(); ++readIdx)
+			{
+				if (objects[readIdx])
+				{
+					if (writeIdx != readIdx)
+					{
+						objects[writeIdx] = objects[readIdx];
+						owners[writeIdx] = std::move(owners[readIdx]);
+						indices[objects[writeIdx]] = writeIdx;
+					}
+					++writeIdx;
+				}
+			}
+			objects.resize(writeIdx);
+			owners.resize(writeIdx); //releases the owners of removed objects; may destroy them
+			numRemoved = 0;
+		}
+
+		virtual size_t size() const override { return indices.size(); }
+
+	private:
+		void removeAt(size_t idx)
+		{
+			//keep the owner until compaction, the object may be removing itself from within its own tick
+			indices.erase(objects[idx]);
+			objects[idx] = nullptr;
+			++numRemoved;
+		}
+
+	private:
+		std::vector<T*> objects;			//hot array walked each tick; null marks a removed object
+		std::vector<sp<T>> owners;			//parallel to objects; registration keeps objects alive like registerTicker
+		std::unordered_map<T*, size_t> indices;
+		size_t numRemoved = 0;
+	};
+}
@@ -71,7 +71,7 @@ namespace SA
 	{
 		static WindowSystem& windowSystem = GameBase::get().getWindowSystem();
 		const sp<Window>& primaryWindow = windowSystem.getPrimaryWindow();
-		if (primaryWindow)
+		if (primaryWindow && primaryWindow->get())
 		{
 			GLFWwindow* window = primaryWindow->get();
 
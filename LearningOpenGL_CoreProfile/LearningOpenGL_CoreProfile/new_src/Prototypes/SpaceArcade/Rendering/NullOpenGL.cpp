@@ -0,0 +1,365 @@
+#include "NullOpenGL.h"
+
+#include <glad/glad.h>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+
+namespace
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// State the stand-ins need to give believable answers; everything is only touched from the game thread like real gl.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	GLuint nextObjectName = 1;
+	std::unordered_map<GLenum, GLuint> boundBuffers;			//target -> buffer
+	std::unordered_map<GLuint, std::vector<char>> bufferMemory;	//buffer -> cpu backing for mapping
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	GLint scissorBox[4] = { 0, 0, 0, 0 };
+	int fenceSyncDummy = 0;
+	bool bNullOpenGLLoaded = false;
+
+	void genNames(GLsizei n, GLuint* names)
+	{
+		for (GLsizei idx = 0; idx < n; ++idx)
+		{
+			names[idx] = nextObjectName++;
+		}
+	}
+
+	void* mapBoundBuffer(GLenum target, size_t offset, size_t length)
+	{
+		std::vector<char>& memory = bufferMemory[boundBuffers[target]];
+		if (memory.size() < offset + length)
+		{
+			memory.resize(offset + length);
+		}
+		return memory.empty() ? nullptr : memory.data() + offset;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// object creation and deletion
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_GenBuffers(GLsizei n, GLuint* buffers) { genNames(n, buffers); }
+	void APIENTRY null_GenFramebuffers(GLsizei n, GLuint* framebuffers) { genNames(n, framebuffers); }
+	void APIENTRY null_GenRenderbuffers(GLsizei n, GLuint* renderbuffers) { genNames(n, renderbuffers); }
+	void APIENTRY null_GenTextures(GLsizei n, GLuint* textures) { genNames(n, textures); }
+	void APIENTRY null_GenVertexArrays(GLsizei n, GLuint* arrays) { genNames(n, arrays); }
+	GLuint APIENTRY null_CreateProgram() { return nextObjectName++; }
+	GLuint APIENTRY null_CreateShader(GLenum type) { return nextObjectName++; }
+	GLsync APIENTRY null_FenceSync(GLenum condition, GLbitfield flags) { return reinterpret_cast<GLsync>(&fenceSyncDummy); }
+
+	void APIENTRY null_DeleteBuffers(GLsizei n, const GLuint* buffers)
+	{
+		for (GLsizei idx = 0; idx < n; ++idx)
+		{
+			bufferMemory.erase(buffers[idx]);
+		}
+	}
+	void APIENTRY null_DeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {}
+	void APIENTRY null_DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {}
+	void APIENTRY null_DeleteTextures(GLsizei n, const GLuint* textures) {}
+	void APIENTRY null_DeleteVertexArrays(GLsizei n, const GLuint* arrays) {}
+	void APIENTRY null_DeleteProgram(GLuint program) {}
+	void APIENTRY null_DeleteShader(GLuint shader) {}
+	void APIENTRY null_DeleteSync(GLsync sync) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// buffers
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_BindBuffer(GLenum target, GLuint buffer) { boundBuffers[target] = buffer; }
+	void APIENTRY null_BindBufferBase(GLenum target, GLuint index, GLuint buffer) { boundBuffers[target] = buffer; }
+	void APIENTRY null_BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) { boundBuffers[target] = buffer; }
+
+	void APIENTRY null_BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		std::vector<char>& memory = bufferMemory[boundBuffers[target]];
+		memory.assign(size_t(size), 0);
+		if (data && size > 0)
+		{
+			std::memcpy(memory.data(), data, size_t(size));
+		}
+	}
+
+	void APIENTRY null_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		if (void* dst = mapBoundBuffer(target, size_t(offset), size_t(size)))
+		{
+			if (data && size > 0) { std::memcpy(dst, data, size_t(size)); }
+		}
+	}
+
+	void* APIENTRY null_MapBuffer(GLenum target, GLenum access) { return mapBoundBuffer(target, 0, bufferMemory[boundBuffers[target]].size()); }
+	void* APIENTRY null_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) { return mapBoundBuffer(target, size_t(offset), size_t(length)); }
+	GLboolean APIENTRY null_UnmapBuffer(GLenum target) { return GL_TRUE; }
+	GLenum APIENTRY null_ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) { return GL_ALREADY_SIGNALED; }
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// shaders
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {}
+	void APIENTRY null_CompileShader(GLuint shader) {}
+	void APIENTRY null_AttachShader(GLuint program, GLuint shader) {}
+	void APIENTRY null_DetachShader(GLuint program, GLuint shader) {}
+	void APIENTRY null_LinkProgram(GLuint program) {}
+	void APIENTRY null_UseProgram(GLuint program) {}
+
+	/** compile and link always succeed, with an empty log */
+	void APIENTRY null_GetShaderiv(GLuint shader, GLenum pname, GLint* params) { *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0; }
+	void APIENTRY null_GetProgramiv(GLuint program, GLenum pname, GLint* params) { *params = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0; }
+	void APIENTRY null_GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+	{
+		if (length) { *length = 0; }
+		if (infoLog && bufSize > 0) { infoLog[0] = '\0'; }
+	}
+	void APIENTRY null_GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+	{
+		if (length) { *length = 0; }
+		if (infoLog && bufSize > 0) { infoLog[0] = '\0'; }
+	}
+
+	GLint APIENTRY null_GetUniformLocation(GLuint program, const GLchar* name) { return 0; }
+	GLint APIENTRY null_GetAttribLocation(GLuint program, const GLchar* name) { return 0; }
+	GLuint APIENTRY null_GetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName) { return 0; }
+	void APIENTRY null_UniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) {}
+	void APIENTRY null_Uniform1f(GLint location, GLfloat v0) {}
+	void APIENTRY null_Uniform1i(GLint location, GLint v0) {}
+	void APIENTRY null_Uniform2f(GLint location, GLfloat v0, GLfloat v1) {}
+	void APIENTRY null_Uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {}
+	void APIENTRY null_Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {}
+	void APIENTRY null_UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// vertex arrays and drawing
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_BindVertexArray(GLuint array) {}
+	void APIENTRY null_EnableVertexAttribArray(GLuint index) {}
+	void APIENTRY null_VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {}
+	void APIENTRY null_VertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) {}
+	void APIENTRY null_VertexAttribDivisor(GLuint index, GLuint divisor) {}
+	void APIENTRY null_DrawArrays(GLenum mode, GLint first, GLsizei count) {}
+	void APIENTRY null_DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {}
+	void APIENTRY null_DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {}
+	void APIENTRY null_DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// textures
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_ActiveTexture(GLenum texture) {}
+	void APIENTRY null_BindTexture(GLenum target, GLuint texture) {}
+	void APIENTRY null_BindSampler(GLuint unit, GLuint sampler) {}
+	void APIENTRY null_TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {}
+	void APIENTRY null_TexImage2DMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations) {}
+	void APIENTRY null_TexParameteri(GLenum target, GLenum pname, GLint param) {}
+	void APIENTRY null_TexParameterfv(GLenum target, GLenum pname, const GLfloat* params) {}
+	void APIENTRY null_GenerateMipmap(GLenum target) {}
+	void APIENTRY null_PixelStorei(GLenum pname, GLint param) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// framebuffers
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_BindFramebuffer(GLenum target, GLuint framebuffer) {}
+	void APIENTRY null_BindRenderbuffer(GLenum target, GLuint renderbuffer) {}
+	void APIENTRY null_RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {}
+	void APIENTRY null_RenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height) {}
+	void APIENTRY null_FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {}
+	void APIENTRY null_FramebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) {}
+	void APIENTRY null_FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {}
+	GLenum APIENTRY null_CheckFramebufferStatus(GLenum target) { return GL_FRAMEBUFFER_COMPLETE; }
+	void APIENTRY null_BlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter) {}
+	void APIENTRY null_DrawBuffer(GLenum buf) {}
+	void APIENTRY null_DrawBuffers(GLsizei n, const GLenum* bufs) {}
+	void APIENTRY null_ReadBuffer(GLenum src) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// fixed function state
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	void APIENTRY null_Enable(GLenum cap) {}
+	void APIENTRY null_Disable(GLenum cap) {}
+	GLboolean APIENTRY null_IsEnabled(GLenum cap) { return GL_FALSE; }
+	void APIENTRY null_Clear(GLbitfield mask) {}
+	void APIENTRY null_ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {}
+	void APIENTRY null_ClearDepth(GLdouble depth) {}
+	void APIENTRY null_ClearStencil(GLint s) {}
+	void APIENTRY null_BlendEquation(GLenum mode) {}
+	void APIENTRY null_BlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {}
+	void APIENTRY null_BlendFunc(GLenum sfactor, GLenum dfactor) {}
+	void APIENTRY null_BlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha) {}
+	void APIENTRY null_CullFace(GLenum mode) {}
+	void APIENTRY null_FrontFace(GLenum mode) {}
+	void APIENTRY null_DepthFunc(GLenum func) {}
+	void APIENTRY null_DepthMask(GLboolean flag) {}
+	void APIENTRY null_StencilFunc(GLenum func, GLint ref, GLuint mask) {}
+	void APIENTRY null_StencilMask(GLuint mask) {}
+	void APIENTRY null_StencilOp(GLenum fail, GLenum zfail, GLenum zpass) {}
+	void APIENTRY null_StencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) {}
+	void APIENTRY null_PolygonMode(GLenum face, GLenum mode) {}
+	void APIENTRY null_PointSize(GLfloat size) {}
+	void APIENTRY null_Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		viewport[0] = x; viewport[1] = y; viewport[2] = width; viewport[3] = height;
+	}
+	void APIENTRY null_Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		scissorBox[0] = x; scissorBox[1] = y; scissorBox[2] = width; scissorBox[3] = height;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// queries
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	GLenum APIENTRY null_GetError() { return GL_NO_ERROR; }
+
+	const GLubyte* APIENTRY null_GetString(GLenum name)
+	{
+		switch (name)
+		{
+			case GL_VENDOR: return reinterpret_cast<const GLubyte*>("SpaceArcade");
+			case GL_RENDERER: return reinterpret_cast<const GLubyte*>("null renderer");
+			case GL_VERSION: return reinterpret_cast<const GLubyte*>("3.3 null");
+			case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte*>("3.30 null");
+			default: return reinterpret_cast<const GLubyte*>("");
+		}
+	}
+	const GLubyte* APIENTRY null_GetStringi(GLenum name, GLuint index) { return reinterpret_cast<const GLubyte*>(""); }
+
+	void APIENTRY null_GetIntegerv(GLenum pname, GLint* data)
+	{
+		switch (pname)
+		{
+			case GL_VIEWPORT: std::memcpy(data, viewport, sizeof(viewport)); break;
+			case GL_SCISSOR_BOX: std::memcpy(data, scissorBox, sizeof(scissorBox)); break;
+			case GL_POLYGON_MODE: data[0] = GL_FILL; data[1] = GL_FILL; break;
+			case GL_MAX_VERTEX_ATTRIBS: *data = 16; break;
+			case GL_ACTIVE_TEXTURE: *data = GL_TEXTURE0; break;
+			case GL_ARRAY_BUFFER_BINDING: *data = GLint(boundBuffers[GL_ARRAY_BUFFER]); break;
+			case GL_MAJOR_VERSION: *data = 3; break;
+			case GL_MINOR_VERSION: *data = 3; break;
+			default: *data = 0; break;
+		}
+	}
+
+	void APIENTRY null_GetFloatv(GLenum pname, GLfloat* data) { *data = (pname == GL_POINT_SIZE) ? 1.f : 0.f; }
+}
+
+namespace SA
+{
+	void loadNullOpenGL()
+	{
+		glad_glGenBuffers = &null_GenBuffers;
+		glad_glGenFramebuffers = &null_GenFramebuffers;
+		glad_glGenRenderbuffers = &null_GenRenderbuffers;
+		glad_glGenTextures = &null_GenTextures;
+		glad_glGenVertexArrays = &null_GenVertexArrays;
+		glad_glCreateProgram = &null_CreateProgram;
+		glad_glCreateShader = &null_CreateShader;
+		glad_glFenceSync = &null_FenceSync;
+		glad_glDeleteBuffers = &null_DeleteBuffers;
+		glad_glDeleteFramebuffers = &null_DeleteFramebuffers;
+		glad_glDeleteRenderbuffers = &null_DeleteRenderbuffers;
+		glad_glDeleteTextures = &null_DeleteTextures;
+		glad_glDeleteVertexArrays = &null_DeleteVertexArrays;
+		glad_glDeleteProgram = &null_DeleteProgram;
+		glad_glDeleteShader = &null_DeleteShader;
+		glad_glDeleteSync = &null_DeleteSync;
+
+		glad_glBindBuffer = &null_BindBuffer;
+		glad_glBindBufferBase = &null_BindBufferBase;
+		glad_glBindBufferRange = &null_BindBufferRange;
+		glad_glBufferData = &null_BufferData;
+		glad_glBufferSubData = &null_BufferSubData;
+		glad_glMapBuffer = &null_MapBuffer;
+		glad_glMapBufferRange = &null_MapBufferRange;
+		glad_glUnmapBuffer = &null_UnmapBuffer;
+		glad_glClientWaitSync = &null_ClientWaitSync;
+
+		glad_glShaderSource = &null_ShaderSource;
+		glad_glCompileShader = &null_CompileShader;
+		glad_glAttachShader = &null_AttachShader;
+		glad_glDetachShader = &null_DetachShader;
+		glad_glLinkProgram = &null_LinkProgram;
+		glad_glUseProgram = &null_UseProgram;
+		glad_glGetShaderiv = &null_GetShaderiv;
+		glad_glGetProgramiv = &null_GetProgramiv;
+		glad_glGetShaderInfoLog = &null_GetShaderInfoLog;
+		glad_glGetProgramInfoLog = &null_GetProgramInfoLog;
+		glad_glGetUniformLocation = &null_GetUniformLocation;
+		glad_glGetAttribLocation = &null_GetAttribLocation;
+		glad_glGetUniformBlockIndex = &null_GetUniformBlockIndex;
+		glad_glUniformBlockBinding = &null_UniformBlockBinding;
+		glad_glUniform1f = &null_Uniform1f;
+		glad_glUniform1i = &null_Uniform1i;
+		glad_glUniform2f = &null_Uniform2f;
+		glad_glUniform3f = &null_Uniform3f;
+		glad_glUniform4f = &null_Uniform4f;
+		glad_glUniformMatrix4fv = &null_UniformMatrix4fv;
+
+		glad_glBindVertexArray = &null_BindVertexArray;
+		glad_glEnableVertexAttribArray = &null_EnableVertexAttribArray;
+		glad_glVertexAttribPointer = &null_VertexAttribPointer;
+		glad_glVertexAttribIPointer = &null_VertexAttribIPointer;
+		glad_glVertexAttribDivisor = &null_VertexAttribDivisor;
+		glad_glDrawArrays = &null_DrawArrays;
+		glad_glDrawArraysInstanced = &null_DrawArraysInstanced;
+		glad_glDrawElements = &null_DrawElements;
+		glad_glDrawElementsInstanced = &null_DrawElementsInstanced;
+
+		glad_glActiveTexture = &null_ActiveTexture;
+		glad_glBindTexture = &null_BindTexture;
+		glad_glBindSampler = &null_BindSampler;
+		glad_glTexImage2D = &null_TexImage2D;
+		glad_glTexImage2DMultisample = &null_TexImage2DMultisample;
+		glad_glTexParameteri = &null_TexParameteri;
+		glad_glTexParameterfv = &null_TexParameterfv;
+		glad_glGenerateMipmap = &null_GenerateMipmap;
+		glad_glPixelStorei = &null_PixelStorei;
+
+		glad_glBindFramebuffer = &null_BindFramebuffer;
+		glad_glBindRenderbuffer = &null_BindRenderbuffer;
+		glad_glRenderbufferStorage = &null_RenderbufferStorage;
+		glad_glRenderbufferStorageMultisample = &null_RenderbufferStorageMultisample;
+		glad_glFramebufferRenderbuffer = &null_FramebufferRenderbuffer;
+		glad_glFramebufferTexture = &null_FramebufferTexture;
+		glad_glFramebufferTexture2D = &null_FramebufferTexture2D;
+		glad_glCheckFramebufferStatus = &null_CheckFramebufferStatus;
+		glad_glBlitFramebuffer = &null_BlitFramebuffer;
+		glad_glDrawBuffer = &null_DrawBuffer;
+		glad_glDrawBuffers = &null_DrawBuffers;
+		glad_glReadBuffer = &null_ReadBuffer;
+
+		glad_glEnable = &null_Enable;
+		glad_glDisable = &null_Disable;
+		glad_glIsEnabled = &null_IsEnabled;
+		glad_glClear = &null_Clear;
+		glad_glClearColor = &null_ClearColor;
+		glad_glClearDepth = &null_ClearDepth;
+		glad_glClearStencil = &null_ClearStencil;
+		glad_glBlendEquation = &null_BlendEquation;
+		glad_glBlendEquationSeparate = &null_BlendEquationSeparate;
+		glad_glBlendFunc = &null_BlendFunc;
+		glad_glBlendFuncSeparate = &null_BlendFuncSeparate;
+		glad_glCullFace = &null_CullFace;
+		glad_glFrontFace = &null_FrontFace;
+		glad_glDepthFunc = &null_DepthFunc;
+		glad_glDepthMask = &null_DepthMask;
+		glad_glStencilFunc = &null_StencilFunc;
+		glad_glStencilMask = &null_StencilMask;
+		glad_glStencilOp = &null_StencilOp;
+		glad_glStencilOpSeparate = &null_StencilOpSeparate;
+		glad_glPolygonMode = &null_PolygonMode;
+		glad_glPointSize = &null_PointSize;
+		glad_glViewport = &null_Viewport;
+		glad_glScissor = &null_Scissor;
+
+		glad_glGetError = &null_GetError;
+		glad_glGetString = &null_GetString;
+		glad_glGetStringi = &null_GetStringi;
+		glad_glGetIntegerv = &null_GetIntegerv;
+		glad_glGetFloatv = &null_GetFloatv;
+
+		bNullOpenGLLoaded = true;
+	}
+
+	bool isNullOpenGLLoaded()
+	{
+		return bNullOpenGLLoaded;
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace SA
+{
+	/**
+		Points glad's function pointers at stand-ins that do no rendering, for running the game without a GPU (eg the headless benchmark).
+
+		Only entry points this engine (and imgui) calls are provided. Objects get unique names, shaders always compile,
+		framebuffers are always complete, and mapped buffers are backed by cpu memory so upload code still runs.
+	*/
+	void loadNullOpenGL();
+
+	/** True once loadNullOpenGL has run; there is then no glfw context to query for extensions. */
+	bool isNullOpenGLLoaded();
+}
@@ -0,0 +1,168 @@
+#include "SAGLInstanceBufferBackend.h"
+#include "OpenGLHelpers.h"
+#include "NullOpenGL.h"
+
+//glad is generated for the 3.3 core profile, so buffer storage (GL 4.4 / ARB_buffer_storage) is loaded by hand
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace
+{
+	typedef void (APIENTRYP PFN_BufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+	PFN_BufferStorage loadBufferStorage()
+	{
+		if (!SA::isNullOpenGLLoaded() && glfwExtensionSupported("GL_ARB_buffer_storage"))
+		{
+			return reinterpret_cast<PFN_BufferStorage>(glfwGetProcAddress("glBufferStorage"));
+		}
+		return nullptr;
+	}
+
+	//time a blocking fence wait gives the GPU before giving up; the ring only blocks when the GPU is several frames behind
+	constexpr GLuint64 blockingWaitTimeoutNs = 1000000000;
+}
+
+namespace SA
+{
+	GLInstanceBufferBackend::GLInstanceBufferBackend(bool bAllowPersistentMapping)
+		: bAllowPersistentMapping(bAllowPersistentMapping)
+	{
+	}
+
+	GLInstanceBufferBackend::~GLInstanceBufferBackend()
+	{
+		//owner releases storage while the context is still current; by now there may be no context to delete with
+	}
+
+	bool GLInstanceBufferBackend::allocateStorage(size_t totalBytes)
+	{
+		releaseStorage();
+
+		static PFN_BufferStorage bufferStorage = loadBufferStorage();
+
+		ec(glGenBuffers(1, &buffer));
+		ec(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+		storageBytes = totalBytes;
+
+		if (bufferStorage && bAllowPersistentMapping)
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			ec(bufferStorage(GL_ARRAY_BUFFER, GLsizeiptr(totalBytes), nullptr, flags));
+			ec(persistentMapping = reinterpret_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, GLsizeiptr(totalBytes), flags)));
+
+			if (!persistentMapping)
+			{
+				//immutable storage cannot be respecified with glBufferData; start over with a regular buffer
+				ec(glDeleteBuffers(1, &buffer));
+				ec(glGenBuffers(1, &buffer));
+				ec(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+				ec(glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(totalBytes), nullptr, GL_STREAM_DRAW));
+			}
+		}
+		else
+		{
+			ec(glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(totalBytes), nullptr, GL_STREAM_DRAW));
+		}
+
+		return buffer != 0;
+	}
+
+	void GLInstanceBufferBackend::releaseStorage()
+	{
+		deleteFences();
+		if (buffer != 0)
+		{
+			if (persistentMapping)
+			{
+				ec(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+				ec(glUnmapBuffer(GL_ARRAY_BUFFER));
+				persistentMapping = nullptr;
+			}
+			ec(glDeleteBuffers(1, &buffer));
+			buffer = 0;
+			storageBytes = 0;
+		}
+	}
+
+	void* GLInstanceBufferBackend::mapRange(size_t offset, size_t bytes)
+	{
+		if (persistentMapping)
+		{
+			return persistentMapping + offset;
+		}
+
+		//the ring guarantees the GPU is done with this range (or the storage was orphaned), so skip the driver's synchronization
+		void* mapped = nullptr;
+		ec(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+		ec(mapped = glMapBufferRange(GL_ARRAY_BUFFER, GLintptr(offset), GLsizeiptr(bytes), GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+		return mapped;
+	}
+
+	void GLInstanceBufferBackend::unmapRange(size_t /*offset*/, size_t /*bytes*/)
+	{
+		//coherent persistent mappings are visible to the GPU without an unmap or flush
+		if (!persistentMapping)
+		{
+			ec(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+			ec(glUnmapBuffer(GL_ARRAY_BUFFER));
+		}
+	}
+
+	void GLInstanceBufferBackend::orphan()
+	{
+		if (!persistentMapping)
+		{
+			ec(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+			ec(glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(storageBytes), nullptr, GL_STREAM_DRAW));
+			deleteFences();
+		}
+	}
+
+	void GLInstanceBufferBackend::insertFence(size_t regionIdx)
+	{
+		if (regionIdx >= fences.size())
+		{
+			fences.resize(regionIdx + 1, nullptr);
+		}
+		if (fences[regionIdx])
+		{
+			ec(glDeleteSync(fences[regionIdx]));
+		}
+		ec(fences[regionIdx] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+
+	bool GLInstanceBufferBackend::waitFence(size_t regionIdx, bool bBlock)
+	{
+		if (regionIdx >= fences.size() || !fences[regionIdx])
+		{
+			return true;
+		}
+
+		GLenum result = GL_WAIT_FAILED;
+		ec(result = glClientWaitSync(fences[regionIdx], bBlock ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, bBlock ? blockingWaitTimeoutNs : 0));
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+		{
+			ec(glDeleteSync(fences[regionIdx]));
+			fences[regionIdx] = nullptr;
+			return true;
+		}
+		return false;
+	}
+
+	void GLInstanceBufferBackend::deleteFences()
+	{
+		for (GLsync& fence : fences)
+		{
+			if (fence)
+			{
+				ec(glDeleteSync(fence));
+				fence = nullptr;
+			}
+		}
+	}
+}
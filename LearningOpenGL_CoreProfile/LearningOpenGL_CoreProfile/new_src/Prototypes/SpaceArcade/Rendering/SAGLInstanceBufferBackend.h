@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+
+#include "SAInstanceUploadRing.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// OpenGL storage for an InstanceUploadRing.
+	//
+	// If GL_ARB_buffer_storage is available the buffer is created with glBufferStorage and mapped once, persistently
+	// and coherently, so uploads are plain memcpys. Otherwise it is a GL_STREAM_DRAW buffer where each range is mapped
+	// with glMapBufferRange(GL_MAP_UNSYNCHRONIZED_BIT); the ring's fences keep those writes away from ranges the GPU
+	// is still reading. Requires a current context for every call.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class GLInstanceBufferBackend : public IInstanceBufferBackend
+	{
+	public:
+		/** bAllowPersistentMapping = false forces the glMapBufferRange path, even where buffer storage is supported */
+		GLInstanceBufferBackend(bool bAllowPersistentMapping = true);
+		virtual ~GLInstanceBufferBackend();
+
+		virtual bool allocateStorage(size_t totalBytes) override;
+		virtual void releaseStorage() override;
+		virtual bool isPersistentlyMapped() const override { return persistentMapping != nullptr; }
+		virtual void* mapRange(size_t offset, size_t bytes) override;
+		virtual void unmapRange(size_t offset, size_t bytes) override;
+		virtual void orphan() override;
+		virtual void insertFence(size_t regionIdx) override;
+		virtual bool waitFence(size_t regionIdx, bool bBlock) override;
+		virtual unsigned int getBufferId() const override { return buffer; }
+
+	private:
+		void deleteFences();
+
+	private:
+		GLuint buffer = 0;
+		size_t storageBytes = 0;
+		char* persistentMapping = nullptr;
+		bool bAllowPersistentMapping;
+		std::vector<GLsync> fences;
+	};
+}
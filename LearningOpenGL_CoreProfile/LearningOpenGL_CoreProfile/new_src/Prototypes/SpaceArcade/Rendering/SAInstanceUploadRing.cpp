@@ -0,0 +1,141 @@
+#include "SAInstanceUploadRing.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	//regions start on this boundary so any alignment up to it is also aligned relative to the buffer
+	constexpr size_t regionAlignment = 256;
+
+	size_t roundUp(size_t value, size_t alignment)
+	{
+		return ((value + alignment - 1) / alignment) * alignment;
+	}
+}
+
+namespace SA
+{
+	InstanceUploadRing::InstanceUploadRing(up<IInstanceBufferBackend> backend, size_t initialRegionBytes, size_t numRegions)
+		: backend(std::move(backend)),
+		regionFenced(std::max<size_t>(numRegions, 1), false),
+		regionBytes(roundUp(std::max<size_t>(initialRegionBytes, 1), regionAlignment)),
+		currentRegion(regionFenced.size() - 1) //first beginFrame wraps to region 0
+	{
+	}
+
+	bool InstanceUploadRing::acquireStorage()
+	{
+		bHasStorage = backend->allocateStorage(regionBytes * regionFenced.size());
+		std::fill(regionFenced.begin(), regionFenced.end(), false);
+		currentRegion = regionFenced.size() - 1;
+		regionCursor = 0;
+		bFrameOpen = false;
+		return bHasStorage;
+	}
+
+	void InstanceUploadRing::releaseStorage()
+	{
+		if (bHasStorage)
+		{
+			backend->releaseStorage();
+			bHasStorage = false;
+		}
+		std::fill(regionFenced.begin(), regionFenced.end(), false);
+		bFrameOpen = false;
+	}
+
+	void InstanceUploadRing::beginFrame(size_t bytesNeededThisFrame)
+	{
+		assert(bHasStorage && !bFrameOpen);
+		++stats.framesBegun;
+
+		if (bytesNeededThisFrame > regionBytes)
+		{
+			grow(bytesNeededThisFrame);
+		}
+
+		currentRegion = (currentRegion + 1) % regionFenced.size();
+		regionCursor = 0;
+		bFrameOpen = true;
+
+		if (regionFenced[currentRegion])
+		{
+			if (!backend->waitFence(currentRegion, false))
+			{
+				if (backend->isPersistentlyMapped())
+				{
+					//the GPU is more than numRegions frames behind; nothing to do but wait for it
+					backend->waitFence(currentRegion, true);
+					++stats.fenceStalls;
+				}
+				else
+				{
+					//fresh storage from the driver rather than a stall; the other regions' fences refer to the old storage
+					backend->orphan();
+					std::fill(regionFenced.begin(), regionFenced.end(), false);
+					++stats.orphans;
+				}
+			}
+			regionFenced[currentRegion] = false;
+		}
+	}
+
+	InstanceUploadRing::Allocation InstanceUploadRing::allocate(size_t bytes, size_t alignment)
+	{
+		assert(bFrameOpen);
+		assert(alignment > 0 && alignment <= regionAlignment);
+
+		Allocation allocation;
+		size_t alignedCursor = roundUp(regionCursor, alignment);
+		if (bytes == 0 || alignedCursor + bytes > regionBytes)
+		{
+			return allocation;
+		}
+
+		allocation.offset = currentRegion * regionBytes + alignedCursor;
+		allocation.bytes = bytes;
+		allocation.data = backend->mapRange(allocation.offset, bytes);
+		if (allocation.data)
+		{
+			regionCursor = alignedCursor + bytes;
+		}
+		return allocation;
+	}
+
+	void InstanceUploadRing::commit(const Allocation& allocation)
+	{
+		if (allocation.isValid())
+		{
+			backend->unmapRange(allocation.offset, allocation.bytes);
+		}
+	}
+
+	void InstanceUploadRing::endFrame()
+	{
+		assert(bFrameOpen);
+		if (regionCursor > 0)
+		{
+			backend->insertFence(currentRegion);
+			regionFenced[currentRegion] = true;
+		}
+		bFrameOpen = false;
+	}
+
+	void InstanceUploadRing::grow(size_t bytesNeededThisFrame)
+	{
+		//every region may still be in flight; the new storage replaces all of them
+		for (size_t regionIdx = 0; regionIdx < regionFenced.size(); ++regionIdx)
+		{
+			if (regionFenced[regionIdx])
+			{
+				backend->waitFence(regionIdx, true);
+				regionFenced[regionIdx] = false;
+			}
+		}
+
+		regionBytes = roundUp(std::max(bytesNeededThisFrame, regionBytes * 2), regionAlignment);
+		bHasStorage = backend->allocateStorage(regionBytes * regionFenced.size());
+		++stats.regrows;
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "../GameFramework/SAGameEntity.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Storage that an InstanceUploadRing sub-allocates from.
+	//
+	// The ring only decides where data goes and when a region may be reused; the backend owns the actual buffer.
+	// The GL implementation is GLInstanceBufferBackend; tests use a CPU-only backend so the ring logic can run
+	// without an OpenGL context.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class IInstanceBufferBackend
+	{
+	public:
+		virtual ~IInstanceBufferBackend() = default;
+
+		/** (Re)creates the storage; previous contents and fences are discarded. */
+		virtual bool allocateStorage(size_t totalBytes) = 0;
+		virtual void releaseStorage() = 0;
+
+		/** Persistently mapped storage stays mapped for its whole lifetime and cannot be orphaned; regions must be fenced instead. */
+		virtual bool isPersistentlyMapped() const = 0;
+
+		/** Returns a write pointer for [offset, offset + bytes). Unless persistently mapped, unmapRange must be called before drawing from it. */
+		virtual void* mapRange(size_t offset, size_t bytes) = 0;
+		virtual void unmapRange(size_t offset, size_t bytes) = 0;
+
+		/** Hands the storage back to the driver and receives fresh storage of the same size, so writes never wait on the GPU. */
+		virtual void orphan() = 0;
+
+		/** Fences are tracked per region; a region's fence signals once the GPU is done with the draws issued before it. */
+		virtual void insertFence(size_t regionIdx) = 0;
+		virtual bool waitFence(size_t regionIdx, bool bBlock) = 0;
+
+		virtual unsigned int getBufferId() const = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Multi-buffered ring of upload regions for per-frame instance data.
+	//
+	// Each frame writes into its own region, so the CPU fills region N while the GPU may still be reading
+	// regions N-1 and N-2. Before a region is reused its fence is checked; persistently mapped storage waits on
+	// the fence, other storage is orphaned instead of stalling. Within a frame, allocations are sub-allocated
+	// linearly from the region; beginFrame must be told how many bytes the frame needs so the ring can grow
+	// before anything is mapped.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class InstanceUploadRing
+	{
+	public:
+		struct Allocation
+		{
+			void* data = nullptr;
+			size_t offset = 0;	//offset from the start of the buffer; use this as the attribute pointer offset
+			size_t bytes = 0;
+			bool isValid() const { return data != nullptr; }
+		};
+
+		struct Stats
+		{
+			size_t framesBegun = 0;
+			size_t fenceStalls = 0;		//beginFrame had to block until the GPU released the region
+			size_t orphans = 0;
+			size_t regrows = 0;
+		};
+
+	public:
+		InstanceUploadRing(up<IInstanceBufferBackend> backend, size_t initialRegionBytes, size_t numRegions = 3);
+
+		/** storage is not released on destruction since that needs a context; call releaseStorage when the context is lost */
+		bool acquireStorage();
+		void releaseStorage();
+		bool hasStorage() const { return bHasStorage; }
+
+		/** Moves to the next region, growing every region first if the frame needs more than a region holds. */
+		void beginFrame(size_t bytesNeededThisFrame);
+
+		/** Returns an invalid allocation if the region does not have room; beginFrame should have been given enough bytes. */
+		Allocation allocate(size_t bytes, size_t alignment = 16);
+		void commit(const Allocation& allocation);
+
+		/** Fences the current region; call after the draws that read from it have been issued. */
+		void endFrame();
+
+		/** worst case number of bytes an allocation uses once alignment padding is included; sum these for beginFrame */
+		static size_t paddedSize(size_t bytes, size_t alignment) { return bytes + alignment - 1; }
+
+		unsigned int getBufferId() const { return backend->getBufferId(); }
+		size_t getRegionBytes() const { return regionBytes; }
+		size_t getNumRegions() const { return regionFenced.size(); }
+		size_t getCurrentRegion() const { return currentRegion; }
+		const Stats& getStats() const { return stats; }
+		IInstanceBufferBackend& getBackend() { return *backend; }
+
+	private:
+		void grow(size_t bytesNeededThisFrame);
+
+	private:
+		up<IInstanceBufferBackend> backend;
+		std::vector<bool> regionFenced;
+		size_t regionBytes;
+		size_t currentRegion;
+		size_t regionCursor = 0;
+		bool bHasStorage = false;
+		bool bFrameOpen = false;
+		Stats stats;
+	};
+}
@@ -12,6 +12,19 @@
 
 //#todo #nextengine hot reload and compile shaders (requires tracking uniforms) from files
 
+namespace
+{
+	SA::UniformGLFunctions loadedUniformGLFunctions()
+	{
+		//read the glad pointers at call time; they are not loaded until a context exists
+		SA::UniformGLFunctions gl;
+		gl.getProgramiv = glGetProgramiv;
+		gl.getActiveUniform = glGetActiveUniform;
+		gl.getUniformLocation = glGetUniformLocation;
+		return gl;
+	}
+}
+
 namespace SA
 {
 	/**
@@ -148,6 +161,7 @@ namespace SA
 			std::cerr << "failed to link shader program" << std::endl;
 			return;
 		}
+		uniformCache.build(linkedProgram, loadedUniformGLFunctions());
 
 		//CLEAN UP
 		ec(glDeleteShader(vertexShader));
@@ -162,6 +176,9 @@ namespace SA
 			ec(glDeleteProgram(linkedProgram));
 			linkedProgram = 0;
 		}
+
+		//locations belong to the deleted program; handles resolve again when the next program links
+		uniformCache.invalidate();
 	}
 
 	void Shader::onAcquireGPUResources()
@@ -265,6 +282,7 @@ namespace SA
 				std::cerr << "failed to link shader program" << std::endl;
 				return;
 			}
+			uniformCache.build(linkedProgram, loadedUniformGLFunctions());
 
 			//CLEAN UP
 			ec(glDeleteShader(vertexShader));
@@ -336,7 +354,7 @@ namespace SA
 		RAII_ScopedShaderSwitcher scoped(linkedProgram);
 
 		//do not need to be using shader to query location of uniform
-		int uniformLocation = glGetUniformLocation(linkedProgram, uniform);
+		int uniformLocation = uniformCache.findLocation(uniform);
 
 		//must be using the shader to update uniform value
 		ec(glUseProgram(linkedProgram));
@@ -352,7 +370,7 @@ namespace SA
 	{
 		RAII_ScopedShaderSwitcher scoped(linkedProgram);
 
-		int uniformLocation = glGetUniformLocation(linkedProgram, uniform);
+		int uniformLocation = uniformCache.findLocation(uniform);
 		ec(glUseProgram(linkedProgram));
 		ec(glUniform3f(uniformLocation, red, green, blue));
 	}
@@ -361,7 +379,7 @@ namespace SA
 	{
 		RAII_ScopedShaderSwitcher scoped(linkedProgram);
 
-		int uniformLocation = glGetUniformLocation(linkedProgram, uniform);
+		int uniformLocation = uniformCache.findLocation(uniform);
 		ec(glUseProgram(linkedProgram));
 		ec(glUniform3f(uniformLocation, vals.r, vals.g, vals.b));
 	}
@@ -370,7 +388,7 @@ namespace SA
 	{
 		RAII_ScopedShaderSwitcher scoped(linkedProgram);
 
-		int uniformLocation = glGetUniformLocation(linkedProgram, uniform);
+		int uniformLocation = uniformCache.findLocation(uniform);
 		ec(glUseProgram(linkedProgram));
 		ec(glUniform1i(uniformLocation, newValue));
 	}
@@ -380,18 +398,48 @@ namespace SA
 	{
 		RAII_ScopedShaderSwitcher scoped(linkedProgram);
 
-		int uniformLocation = glGetUniformLocation(linkedProgram, uniform);
+		int uniformLocation = uniformCache.findLocation(uniform);
 		ec(glUseProgram(linkedProgram));
 		ec(glUniformMatrix4fv(uniformLocation, numberMatrices, transpose, data));
 	}
 
 	void Shader::setUniform1f(const char* uniformName, float value)
 	{
-		GLuint uniformLocationInShader = glGetUniformLocation(getId(), uniformName);
+		GLint uniformLocationInShader = uniformCache.findLocation(uniformName);
 		ec(glUseProgram(linkedProgram));
 		ec(glUniform1f(uniformLocationInShader, value));
 	}
 
+	void Shader::setUniform(UniformHandle<float> handle, float value)
+	{
+		ec(glUseProgram(linkedProgram));
+		ec(glUniform1f(uniformCache.getHandleLocation(handle.slot), value));
+	}
+
+	void Shader::setUniform(UniformHandle<int> handle, int value)
+	{
+		ec(glUseProgram(linkedProgram));
+		ec(glUniform1i(uniformCache.getHandleLocation(handle.slot), value));
+	}
+
+	void Shader::setUniform(UniformHandle<glm::vec3> handle, const glm::vec3& values)
+	{
+		ec(glUseProgram(linkedProgram));
+		ec(glUniform3f(uniformCache.getHandleLocation(handle.slot), values.r, values.g, values.b));
+	}
+
+	void Shader::setUniform(UniformHandle<glm::vec4> handle, const glm::vec4& values)
+	{
+		ec(glUseProgram(linkedProgram));
+		ec(glUniform4f(uniformCache.getHandleLocation(handle.slot), values.r, values.g, values.b, values.a));
+	}
+
+	void Shader::setUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix)
+	{
+		ec(glUseProgram(linkedProgram));
+		ec(glUniformMatrix4fv(uniformCache.getHandleLocation(handle.slot), 1, GL_FALSE, glm::value_ptr(matrix)));
+	}
+
 	bool Shader::shaderCompileSuccess(GLuint shaderID)
 	{
 		char infolog[256];
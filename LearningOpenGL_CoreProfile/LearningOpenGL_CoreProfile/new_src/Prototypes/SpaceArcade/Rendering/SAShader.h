@@ -10,7 +10,9 @@
 
 #include "../Tools/RemoveSpecialMemberFunctionUtils.h"
 #include "SAGPUResource.h"
+#include "SAUniformLocationCache.h"
 #include <optional>
+#include <iostream>
 
 class Texture2D;
 
@@ -27,6 +29,9 @@ namespace SA
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Represents a hardware shader program (eg, the combination of verex, fragment, and other shaders
 	//
+	// Uniform locations are cached when the program links; setting by name is a lookup in that table rather than a GL query.
+	// For uniforms set every draw, get a UniformHandle once and set through it.
+	//
 	// known issues/lack of features
 	//		-uniforms do not persist if context information is lost, or if uniforms are assigned before context is present.
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,14 +59,41 @@ namespace SA
 		void setUniform1i(const char* uniformname, int newValue);
 		void setUniformMatrix4fv(const char* uniform, int numberMatrices, GLuint normalize, const float* data);
 
+		/** Handles stay valid when the context is lost; they resolve to the uniform again once the program is relinked */
+		template<typename T>
+		UniformHandle<T> getUniformHandle(const char* uniformName);
+
+		void setUniform(UniformHandle<float> handle, float value);
+		void setUniform(UniformHandle<int> handle, int value);
+		void setUniform(UniformHandle<glm::vec3> handle, const glm::vec3& values);
+		void setUniform(UniformHandle<glm::vec4> handle, const glm::vec4& values);
+		void setUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix);
+
+		const UniformLocationCache& getUniformCache() const { return uniformCache; }
+
 	private:
 		bool failed;
 		bool active;
 		GLuint linkedProgram;
 	private:
 		ShaderInit initData;
+		UniformLocationCache uniformCache;
 	private:
 		bool shaderCompileSuccess(GLuint shaderID);
 		bool programLinkSuccess(GLuint programID);
 	};
+
+	template<typename T>
+	UniformHandle<T> Shader::getUniformHandle(const char* uniformName)
+	{
+		UniformHandle<T> handle;
+		handle.slot = uniformCache.registerHandle(uniformName);
+
+		GLenum glType = uniformCache.getHandleType(handle.slot);
+		if (glType != 0 && !UniformTypeTraits<T>::accepts(glType))
+		{
+			std::cerr << "uniform handle type does not match uniform in shader: " << uniformName << std::endl;
+		}
+		return handle;
+	}
 }
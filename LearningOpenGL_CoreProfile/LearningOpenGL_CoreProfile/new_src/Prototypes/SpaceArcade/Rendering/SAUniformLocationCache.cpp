@@ -0,0 +1,117 @@
+#include "SAUniformLocationCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	bool entryNameLess(const SA::UniformLocationCache::Entry& entry, const char* name)
+	{
+		return std::strcmp(entry.name.c_str(), name) < 0;
+	}
+}
+
+namespace SA
+{
+	void UniformLocationCache::build(GLuint program, const UniformGLFunctions& gl)
+	{
+		entries.clear();
+
+		GLint numActiveUniforms = 0;
+		GLint maxNameLength = 0;
+		gl.getProgramiv(program, GL_ACTIVE_UNIFORMS, &numActiveUniforms);
+		gl.getProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::vector<GLchar> nameBuffer(size_t(std::max(maxNameLength, 1)) + 1, '\0');
+		for (GLint uniformIdx = 0; uniformIdx < numActiveUniforms; ++uniformIdx)
+		{
+			GLsizei nameLength = 0;
+			GLint arraySize = 0;
+			GLenum type = 0;
+			gl.getActiveUniform(program, GLuint(uniformIdx), GLsizei(nameBuffer.size()), &nameLength, &arraySize, &type, nameBuffer.data());
+
+			std::string name(nameBuffer.data(), size_t(nameLength));
+			GLint location = gl.getUniformLocation(program, name.c_str());
+			if (location < 0)
+			{
+				continue; //uniform block members have no location
+			}
+			entries.push_back({ name, location, type, arraySize });
+
+			//arrays are reported as "name[0]"; also allow "name" and every "name[i]"
+			const char arraySuffix[] = "[0]";
+			const size_t suffixLength = sizeof(arraySuffix) - 1;
+			if (name.size() > suffixLength && name.compare(name.size() - suffixLength, suffixLength, arraySuffix) == 0)
+			{
+				std::string baseName = name.substr(0, name.size() - suffixLength);
+				entries.push_back({ baseName, location, type, arraySize });
+				for (GLint element = 1; element < arraySize; ++element)
+				{
+					std::string elementName = baseName + "[" + std::to_string(element) + "]";
+					GLint elementLocation = gl.getUniformLocation(program, elementName.c_str());
+					if (elementLocation >= 0)
+					{
+						entries.push_back({ elementName, elementLocation, type, 1 });
+					}
+				}
+			}
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.name < b.name; });
+		bBuilt = true;
+
+		for (uint32_t slot = 0; slot < handleNames.size(); ++slot)
+		{
+			resolveHandle(slot);
+		}
+	}
+
+	void UniformLocationCache::invalidate()
+	{
+		entries.clear();
+		bBuilt = false;
+		std::fill(handleLocations.begin(), handleLocations.end(), -1);
+		std::fill(handleTypes.begin(), handleTypes.end(), 0);
+	}
+
+	const UniformLocationCache::Entry* UniformLocationCache::findEntry(const char* name) const
+	{
+		auto found = std::lower_bound(entries.begin(), entries.end(), name, &entryNameLess);
+		if (found != entries.end() && found->name == name)
+		{
+			return &(*found);
+		}
+		return nullptr;
+	}
+
+	GLint UniformLocationCache::findLocation(const char* name) const
+	{
+		const Entry* entry = findEntry(name);
+		return entry ? entry->location : -1;
+	}
+
+	uint32_t UniformLocationCache::registerHandle(const char* name)
+	{
+		for (uint32_t slot = 0; slot < handleNames.size(); ++slot)
+		{
+			if (handleNames[slot] == name)
+			{
+				return slot;
+			}
+		}
+
+		uint32_t slot = uint32_t(handleNames.size());
+		handleNames.emplace_back(name);
+		handleLocations.push_back(-1);
+		handleTypes.push_back(0);
+		resolveHandle(slot);
+		return slot;
+	}
+
+	void UniformLocationCache::resolveHandle(uint32_t slot)
+	{
+		const Entry* entry = bBuilt ? findEntry(handleNames[slot].c_str()) : nullptr;
+		handleLocations[slot] = entry ? entry->location : -1;
+		handleTypes[slot] = entry ? entry->type : 0;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm.hpp>
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// The GL entry points the uniform cache needs; tests supply fakes so the cache can run without a context.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct UniformGLFunctions
+	{
+		PFNGLGETPROGRAMIVPROC getProgramiv = nullptr;
+		PFNGLGETACTIVEUNIFORMPROC getActiveUniform = nullptr;
+		PFNGLGETUNIFORMLOCATIONPROC getUniformLocation = nullptr;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Typed reference to a uniform of a Shader; resolving it is an array index, with no string compares or GL queries.
+	// Handles stay valid across context loss; their location is re-resolved when the program is relinked.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	struct UniformHandle
+	{
+		static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+		uint32_t slot = INVALID_SLOT;
+		bool isValid() const { return slot != INVALID_SLOT; }
+	};
+
+	/** which GL uniform types may be set from a C++ value type */
+	template<typename T> struct UniformTypeTraits;
+	template<> struct UniformTypeTraits<float> { static bool accepts(GLenum glType) { return glType == GL_FLOAT; } };
+	template<> struct UniformTypeTraits<glm::vec3> { static bool accepts(GLenum glType) { return glType == GL_FLOAT_VEC3; } };
+	template<> struct UniformTypeTraits<glm::vec4> { static bool accepts(GLenum glType) { return glType == GL_FLOAT_VEC4; } };
+	template<> struct UniformTypeTraits<glm::mat4> { static bool accepts(GLenum glType) { return glType == GL_FLOAT_MAT4; } };
+	template<> struct UniformTypeTraits<int>
+	{
+		//samplers and bools are set with glUniform1i as well
+		static bool accepts(GLenum glType)
+		{
+			return glType == GL_INT || glType == GL_BOOL
+				|| glType == GL_SAMPLER_2D || glType == GL_SAMPLER_3D || glType == GL_SAMPLER_CUBE
+				|| glType == GL_SAMPLER_2D_SHADOW || glType == GL_SAMPLER_2D_MULTISAMPLE;
+		}
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Per-program table of uniform locations, filled once after link from glGetActiveUniform.
+	//
+	// Names are kept sorted so string lookups are a binary search without allocating. Handle slots are
+	// registered by name and outlive the program; rebuild re-resolves every slot, invalidate sets them all to -1
+	// (which GL silently ignores), so code holding handles does not need to know about context loss.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class UniformLocationCache
+	{
+	public:
+		struct Entry
+		{
+			std::string name;
+			GLint location;
+			GLenum type;
+			GLint arraySize;
+		};
+
+	public:
+		void build(GLuint program, const UniformGLFunctions& gl);
+		void invalidate();
+		bool isBuilt() const { return bBuilt; }
+
+		/** -1 if the uniform is not active in the program, like glGetUniformLocation */
+		GLint findLocation(const char* name) const;
+		const Entry* findEntry(const char* name) const;
+		const std::vector<Entry>& getEntries() const { return entries; }
+
+		/** registering the same name twice returns the same slot */
+		uint32_t registerHandle(const char* name);
+		GLint getHandleLocation(uint32_t slot) const { return handleLocations[slot]; }
+		/** 0 if the uniform is not active in the program (or the cache is not built) */
+		GLenum getHandleType(uint32_t slot) const { return handleTypes[slot]; }
+		const std::string& getHandleName(uint32_t slot) const { return handleNames[slot]; }
+
+	private:
+		void resolveHandle(uint32_t slot);
+
+	private:
+		std::vector<Entry> entries;			//sorted by name
+		std::vector<std::string> handleNames;
+		std::vector<GLint> handleLocations;
+		std::vector<GLenum> handleTypes;
+		bool bBuilt = false;
+	};
+}
@@ -9,6 +9,7 @@
 #include <gtx/quaternion.hpp>
 
 #include "OpenGLHelpers.h"
+#include "NullOpenGL.h"
 #include "../GameFramework/SALog.h"
 
 #define MAP_GLFWWINDOW_TO_WINDOWOBJ
@@ -196,11 +197,25 @@ namespace SA
 	// Window Instances
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	Window::Window(uint32_t width, uint32_t height)
+	Window::Window(uint32_t width, uint32_t height, bool bHeadless)
+		: bHeadless(bHeadless)
 	{
+		if (bHeadless)
+		{
+			//null backend; glfw is left uninitialized so this works on build machines with no display server or GPU
+			headlessFramebufferSize = std::make_pair((int)width, (int)height);
+			if (!gladLoaded)
+			{
+				gladLoaded = true;
+				loadNullOpenGL();
+			}
+			return;
+		}
+
 		startUp();
 
 		window = glfwCreateWindow((int)width, (int)height, "OpenGL Window", nullptr, nullptr);
+
 		if (!window)
 		{
 			glfwTerminate();
@@ -238,28 +253,37 @@ namespace SA
 
 	Window::~Window()
 	{
-		windowStatics.stopTrackingWindow(window);
-		glfwDestroyWindow(window);
-		tryShutDown();
+		if (window)
+		{
+			windowStatics.stopTrackingWindow(window);
+			glfwDestroyWindow(window);
+			tryShutDown();
+		}
 	}
 
 	void Window::markWindowForClose(bool bClose)
 	{
-		glfwSetWindowShouldClose(window, bClose);
+		if (window)
+		{
+			glfwSetWindowShouldClose(window, bClose);
+		}
+		else
+		{
+			bHeadlessCloseRequested = bClose;
+		}
 	}
 
 	bool Window::shouldClose()
 	{
-		return glfwWindowShouldClose(window);
+		return window ? glfwWindowShouldClose(window) : bHeadlessCloseRequested;
 	}
 
 	float Window::getAspect()
 	{
 		static bool bLoggedAspectError = false;
-		int width, height;
 
 		//unsure if this should be framebuffer size or actual window size
-		glfwGetFramebufferSize(window, &width, &height);
+		auto [width, height] = getFramebufferSize();
 		//glfwGetWindowSize(window, &width, &height);
 
 		float aspect = static_cast<float>(width) / height;
@@ -284,7 +308,11 @@ namespace SA
 
 	std::pair<int, int> Window::getFramebufferSize()
 	{
-		static bool bLoggedAspectError = false;
+		if (!window)
+		{
+			return headlessFramebufferSize;
+		}
+
 		int width, height;
 		glfwGetFramebufferSize(window, &width, &height);
 		return std::make_pair(width, height);
@@ -292,8 +320,7 @@ namespace SA
 
 	void Window::setViewportToWindowSize()
 	{
-		int width, height;
-		glfwGetFramebufferSize(window, &width, &height);
+		auto [width, height] = getFramebufferSize();
 		ec(glViewport(0, 0, width, height));
 	}
 
@@ -48,11 +48,16 @@ namespace SA
 
 	//window instances
 	public:
-		Window(uint32_t width, uint32_t height);
+		/** A headless window is a null backend: glfw is never initialized and there is no gl context, so it runs without a
+			display or GPU; gl calls go to the null implementation (see NullOpenGL.h) and no input events arrive.
+			A process is expected to create only headless windows or only real windows, since gl is loaded once. */
+		Window(uint32_t width, uint32_t height, bool bHeadless = false);
 		virtual void postConstruct() override;
 		~Window();
 
+		/** nullptr for headless windows; glfw calls must be skipped for those */
 		inline GLFWwindow* get() { return window; }
+		inline bool isHeadless() const { return bHeadless; }
 		void markWindowForClose(bool bClose);
 		bool shouldClose();
 		float getAspect();
@@ -64,7 +69,12 @@ namespace SA
 		void handleFramebufferSizeChanged(int width, int height);
 
 	private:
-		GLFWwindow* window;
+		GLFWwindow* window = nullptr;
+		bool bHeadless = false;
+
+		//stand in for glfw's window state when headless
+		std::pair<int, int> headlessFramebufferSize;
+		bool bHeadlessCloseRequested = false;
 	};
 
 }
\ No newline at end of file
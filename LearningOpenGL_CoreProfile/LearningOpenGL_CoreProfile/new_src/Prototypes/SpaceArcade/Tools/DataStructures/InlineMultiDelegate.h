@@ -0,0 +1,302 @@
+#pragma once
+
+#include "../../GameFramework/SAGameEntity.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <assert.h>
+
+namespace SA
+{
+	/**
+		InlineMultiDelegate has the same API and broadcast rules as MultiDelegate, but is built for delegates that are
+		broadcast at a high rate; eg WorldEntity::onTransformUpdated fires for every moving entity every frame.
+
+		Differences from MultiDelegate:
+			*the first INLINE_CAPACITY subscriptions are stored inside the delegate; nothing is heap allocated until it overflows.
+			*each subscription stores a function pointer stamped out for its bound type, rather than a heap allocated subscriber with a virtual invoke.
+			*weak subscriptions are checked with weak_ptr::expired (a load) rather than locked (two atomic read-modify-writes).
+			*subscribers are invoked in the order they subscribed; MultiDelegate invokes strong then weak subscribers, ordered by address.
+
+		Shared with MultiDelegate:
+			*subscriptions added during a broadcast are first invoked by the next broadcast.
+			*subscriptions removed during a broadcast still finish the current broadcast.
+			*weak subscriptions to destroyed objects are removed after a broadcast finds them.
+
+		Built for single threaded usage, like MultiDelegate. Since weak subscribers are not locked for the duration of their
+		callback, a callback must not release the last reference to its own object.
+	*/
+	template<typename... Args>
+	class InlineMultiDelegate /*intentionally not a game entity; see MultiDelegate*/
+	{
+	public:
+		static constexpr size_t INLINE_CAPACITY = 4;
+
+		void broadcast(Args... args)
+		{
+			//NOTE WHEN CHANGING: preserve that repeatedly "step into" when debugging quickly gets to callbacks and not other functions
+
+			if (broadcastDepth++ == 0)
+			{
+				numSlotsAtBroadcast = numSlots;
+			}
+
+			//subscriptions added by callbacks are appended past numToInvoke; index rather than hold references since the overflow may reallocate
+			const size_t numToInvoke = numSlots;
+			for (size_t idx = 0; idx < numToInvoke; ++idx)
+			{
+				Slot& slot = slotAt(idx);
+				if (slot.bStrong || !slot.weakObj.expired())
+				{
+					slot.invoker(slot.object, slot.boundFunc, std::forward<Args>(args)...);
+				}
+				else if (!slot.bRemoved)
+				{
+					markRemoved(slot);
+				}
+			}
+
+			if (--broadcastDepth == 0 && numPendingRemoves > 0)
+			{
+				compact();
+			}
+		}
+
+		/** Binds object without keeping it alive; see MultiDelegate::addWeakObj. */
+		template<typename T>
+		void addWeakObj(const sp<T>& obj, void(T::*fptr)(Args...))
+		{
+			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
+
+			Slot& slot = appendSlot(obj, fptr);
+			slot.weakObj = obj;
+			++numWeakBound;
+		}
+
+		/** Binds object and keeps it alive until removed; see MultiDelegate::addStrongObj. */
+		template<typename T>
+		void addStrongObj(const sp<T>& obj, void(T::*fptr)(Args...))
+		{
+			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
+
+			Slot& slot = appendSlot(obj, fptr);
+			slot.strongObj = obj;
+			slot.bStrong = true;
+			++numStrongBound;
+		}
+
+		template<typename T>
+		void removeAll(const sp<T>& obj)
+		{
+			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
+
+			SA::GameEntity* key = obj.get();
+			const size_t numSearched = numRemovableSlots();
+			for (size_t idx = 0; idx < numSearched; ++idx)
+			{
+				Slot& slot = slotAt(idx);
+				if (slot.key == key && !slot.bRemoved)
+				{
+					markRemoved(slot);
+				}
+			}
+			compactIfNotBroadcasting();
+		}
+
+		template<typename T>
+		void removeStrong(const sp<T>& obj, void(T::*fptr)(Args...))
+		{
+			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
+			removeFirstMatch(obj, fptr, true);
+		}
+
+		template<typename T>
+		void removeWeak(const sp<T>& obj, void(T::*fptr)(Args...))
+		{
+			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
+			removeFirstMatch(obj, fptr, false);
+		}
+
+		bool hasBoundStrong(const GameEntity& const_obj) const { return hasBound(const_obj, true); }
+		bool hasBoundWeak(const GameEntity& const_obj) const { return hasBound(const_obj, false); }
+
+		std::size_t numBound() const { return numStrongBound + numWeakBound; }
+		std::size_t numStrong() const { return numStrongBound; }
+		std::size_t numWeak() const { return numWeakBound; }
+
+	public:
+		InlineMultiDelegate() = default;
+
+		//see MultiDelegate for reasons copies and moves are not supported
+		InlineMultiDelegate(const InlineMultiDelegate<Args...>& copy) = delete;
+		InlineMultiDelegate<Args...>& operator=(const InlineMultiDelegate<Args...>& copy) = delete;
+		InlineMultiDelegate(InlineMultiDelegate<Args...>&& move) = delete;
+		InlineMultiDelegate<Args...>& operator=(InlineMultiDelegate<Args...>&& move) = delete;
+
+	private:
+		/** Member function pointers to an incomplete class use the most general representation, so every bound function fits in this. */
+		class UnknownInheritance;
+		static constexpr size_t BOUND_FUNC_SIZE = sizeof(void(UnknownInheritance::*)());
+
+		using Invoker = void(*)(void* /*object*/, const unsigned char* /*boundFunc*/, Args&&...);
+
+		template<typename T>
+		using MemberFunc = void(T::*)(Args...);
+
+		struct Slot
+		{
+			Invoker invoker = nullptr;
+			void* object = nullptr;				//the bound T*; only dereferenced through an invoker created for that T
+			SA::GameEntity* key = nullptr;		//identity used by removal and queries
+			sp<SA::GameEntity> strongObj;
+			wp<SA::GameEntity> weakObj;
+			alignas(void*) unsigned char boundFunc[BOUND_FUNC_SIZE];
+			bool bStrong = false;
+			bool bRemoved = false;
+		};
+
+		template<typename T>
+		static void invokeBound(void* object, const unsigned char* boundFunc, Args&&... args)
+		{
+			MemberFunc<T> fptr;
+			std::memcpy(&fptr, boundFunc, sizeof(fptr));
+			(static_cast<T*>(object)->*fptr)(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		static bool isBoundTo(const Slot& slot, MemberFunc<T> fptr)
+		{
+			//the invoker is unique per T, which makes comparing the stored function pointer as a MemberFunc<T> safe
+			if (slot.invoker != &invokeBound<T>)
+			{
+				return false;
+			}
+			MemberFunc<T> boundFptr;
+			std::memcpy(&boundFptr, slot.boundFunc, sizeof(boundFptr));
+			return boundFptr == fptr;
+		}
+
+		template<typename T>
+		Slot& appendSlot(const sp<T>& obj, MemberFunc<T> fptr)
+		{
+			static_assert(sizeof(MemberFunc<T>) <= BOUND_FUNC_SIZE, "member function pointer does not fit in inline storage");
+
+			const size_t idx = numSlots++;
+			if (idx >= INLINE_CAPACITY && idx - INLINE_CAPACITY == overflowSlots.size())
+			{
+				overflowSlots.emplace_back();
+			}
+
+			Slot& slot = slotAt(idx);
+			slot = Slot{};
+			slot.invoker = &invokeBound<T>;
+			slot.object = obj.get();
+			slot.key = obj.get();
+			std::memcpy(slot.boundFunc, &fptr, sizeof(fptr));
+			return slot;
+		}
+
+		template<typename T>
+		void removeFirstMatch(const sp<T>& obj, MemberFunc<T> fptr, bool bStrong)
+		{
+			SA::GameEntity* key = obj.get();
+			const size_t numSearched = numRemovableSlots();
+			for (size_t idx = 0; idx < numSearched; ++idx)
+			{
+				Slot& slot = slotAt(idx);
+				if (slot.key == key && slot.bStrong == bStrong && !slot.bRemoved && isBoundTo<T>(slot, fptr))
+				{
+					markRemoved(slot);
+					compactIfNotBroadcasting();
+					return; //early out, duplicate adds should be handled with duplicate removes
+				}
+			}
+		}
+
+		bool hasBound(const GameEntity& const_obj, bool bStrong) const
+		{
+			for (size_t idx = 0; idx < numSlots; ++idx)
+			{
+				const Slot& slot = slotAt(idx);
+				if (slot.key == &const_obj && slot.bStrong == bStrong && !slot.bRemoved)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/** Like MultiDelegate, removals during a broadcast do not see subscriptions added by that broadcast. */
+		size_t numRemovableSlots() const { return broadcastDepth > 0 ? numSlotsAtBroadcast : numSlots; }
+
+		void markRemoved(Slot& slot)
+		{
+			slot.bRemoved = true;
+			--(slot.bStrong ? numStrongBound : numWeakBound);
+			++numPendingRemoves;
+		}
+
+		void compactIfNotBroadcasting()
+		{
+			if (broadcastDepth == 0)
+			{
+				compact();
+			}
+		}
+
+		void compact()
+		{
+			assert(broadcastDepth == 0);
+
+			//stable partition so removed slots end up at the back still holding their references
+			size_t writeIdx = 0;
+			for (size_t readIdx = 0; readIdx < numSlots; ++readIdx)
+			{
+				if (!slotAt(readIdx).bRemoved)
+				{
+					if (writeIdx != readIdx)
+					{
+						std::swap(slotAt(writeIdx), slotAt(readIdx));
+					}
+					++writeIdx;
+				}
+			}
+			size_t releaseIdx = numSlots;
+			numSlots = writeIdx;
+			numPendingRemoves = 0;
+
+			//release back to front after the delegate is consistent; dropping a strong reference may run a destructor that
+			//subscribes to this delegate, which reuses the slot at numSlots and ends the release early.
+			while (releaseIdx > numSlots)
+			{
+				Slot released = std::move(slotAt(--releaseIdx));
+				slotAt(releaseIdx) = Slot{};
+			}
+
+			if (numSlots <= INLINE_CAPACITY)
+			{
+				overflowSlots.clear();
+			}
+			else
+			{
+				overflowSlots.resize(numSlots - INLINE_CAPACITY);
+			}
+		}
+
+		Slot& slotAt(size_t idx) { return idx < INLINE_CAPACITY ? inlineSlots[idx] : overflowSlots[idx - INLINE_CAPACITY]; }
+		const Slot& slotAt(size_t idx) const { return idx < INLINE_CAPACITY ? inlineSlots[idx] : overflowSlots[idx - INLINE_CAPACITY]; }
+
+	private:
+		Slot inlineSlots[INLINE_CAPACITY];
+		std::vector<Slot> overflowSlots;		//subscriptions past INLINE_CAPACITY, in order
+
+		size_t numSlots = 0;					//includes removed slots waiting for the broadcast to finish
+		size_t numSlotsAtBroadcast = 0;
+		size_t numPendingRemoves = 0;
+		size_t numStrongBound = 0;
+		size_t numWeakBound = 0;
+		uint32_t broadcastDepth = 0;
+	};
+}
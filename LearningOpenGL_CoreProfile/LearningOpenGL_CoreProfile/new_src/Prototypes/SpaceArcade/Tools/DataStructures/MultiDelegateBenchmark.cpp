@@ -0,0 +1,114 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+#include "MultiDelegate.h"
+#include "InlineMultiDelegate.h"
+
+/*
+	Headless benchmark for delegate broadcasts; no window, GL context, or game systems are created.
+
+	Mimics transform update events: a few thousand entities each own a delegate with one or two subscribers (eg a camera
+	following a ship) and broadcast it every frame. The same script runs against MultiDelegate and InlineMultiDelegate,
+	once with weak subscribers and once with strong subscribers. Both delegates count the same number of callbacks.
+*/
+
+namespace
+{
+	using namespace SA;
+
+	struct Listener : public GameEntity
+	{
+		void handleMoved(const float& value) { sum += value; ++calls; }
+		double sum = 0.0;
+		uint64_t calls = 0;
+	};
+
+	struct BenchConfig
+	{
+		size_t numDelegates = 5000;
+		size_t numSubscribersPerDelegate = 2;
+		int numFrames = 600;
+	};
+
+	struct BenchResults
+	{
+		double totalMs = 0.0;
+		uint64_t calls = 0;
+	};
+
+	using Clock = std::chrono::high_resolution_clock;
+	double elapsedMs(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+	template<template<typename...> class Delegate>
+	BenchResults run(const BenchConfig& config, bool bWeak)
+	{
+		//delegates live in separate allocations, like delegates owned by separately allocated entities
+		std::vector<sp<Delegate<const float&>>> delegates;
+		std::vector<sp<Listener>> listeners;
+		for (size_t idx = 0; idx < config.numDelegates; ++idx)
+		{
+			delegates.push_back(new_sp<Delegate<const float&>>());
+			for (size_t subIdx = 0; subIdx < config.numSubscribersPerDelegate; ++subIdx)
+			{
+				listeners.push_back(new_sp<Listener>());
+				if (bWeak) { delegates.back()->addWeakObj(listeners.back(), &Listener::handleMoved); }
+				else { delegates.back()->addStrongObj(listeners.back(), &Listener::handleMoved); }
+			}
+		}
+
+		Clock::time_point start = Clock::now();
+		for (int frame = 0; frame < config.numFrames; ++frame)
+		{
+			const float value = float(frame);
+			for (const sp<Delegate<const float&>>& delegate : delegates)
+			{
+				if (delegate->numBound() > 0)
+				{
+					delegate->broadcast(value);
+				}
+			}
+		}
+
+		BenchResults results;
+		results.totalMs = elapsedMs(start);
+		for (const sp<Listener>& listener : listeners) { results.calls += listener->calls; }
+		return results;
+	}
+
+	void printResults(const char* delegateName, const BenchConfig& config, const BenchResults& results)
+	{
+		const uint64_t numBroadcasts = uint64_t(config.numDelegates) * config.numFrames;
+		std::cout << delegateName << "\n"
+			<< "\ttotal:         " << results.totalMs << " ms\n"
+			<< "\tper frame:     " << results.totalMs / config.numFrames << " ms for " << config.numDelegates << " broadcasts\n"
+			<< "\tper broadcast: " << results.totalMs * 1000000.0 / numBroadcasts << " ns\n"
+			<< "\tcallbacks:     " << results.calls << std::endl;
+	}
+
+	void true_main()
+	{
+		BenchConfig config;
+
+		for (bool bWeak : { true, false })
+		{
+			std::cout << (bWeak ? "---- weak subscribers ----" : "---- strong subscribers ----") << std::endl;
+
+			BenchResults legacyResults = run<MultiDelegate>(config, bWeak);
+			printResults("MultiDelegate (heap allocated subscribers, virtual invoke)", config, legacyResults);
+
+			BenchResults inlineResults = run<InlineMultiDelegate>(config, bWeak);
+			printResults("InlineMultiDelegate", config, inlineResults);
+
+			if (legacyResults.calls != inlineResults.calls)
+			{
+				std::cerr << "MISMATCH: callback counts differ" << std::endl;
+			}
+		}
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
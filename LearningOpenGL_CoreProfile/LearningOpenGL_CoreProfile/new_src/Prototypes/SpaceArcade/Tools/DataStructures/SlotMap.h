@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace SA
+{
+	/** Generation checked reference to a value in a SlotMap; safe to test after the value has been removed. */
+	struct SlotHandle
+	{
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		uint32_t index = INVALID_INDEX;
+		uint32_t generation = 0;
+
+		bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Unordered container with O(1) insert, remove, and lookup by handle; values are packed contiguously for iteration.
+	//
+	//								 slot map		std::set
+	// insertion:					  o(1*)			o(log(n))
+	// removal:						  o(1)			o(log(n))
+	// lookup:						  o(1)			o(log(n))
+	// iterate						  o(n) over one array, rather than a walk of tree nodes
+	//
+	//	Values live in a dense array. Removing moves the last value into the hole, so iteration order changes on removal.
+	//	Handles index a sparse array of slots that track where their value is in the dense array. Removing a value bumps
+	//	its slot's generation so handles to it stop resolving, even once the slot is reused.
+	//
+	//	Inserting may reallocate the dense array; loops that may insert should index rather than hold iterators.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	class SlotMap
+	{
+	public:
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		/** O(1*) */
+		SlotHandle insert(T value)
+		{
+			uint32_t slotIdx = freeListHead;
+			if (slotIdx != SlotHandle::INVALID_INDEX)
+			{
+				freeListHead = slots[slotIdx].nextFree;
+			}
+			else
+			{
+				slotIdx = static_cast<uint32_t>(slots.size());
+				slots.emplace_back();
+			}
+
+			Slot& slot = slots[slotIdx];
+			slot.denseIdx = static_cast<uint32_t>(dense.size());
+			dense.push_back(std::move(value));
+			denseToSlot.push_back(slotIdx);
+			return SlotHandle{ slotIdx, slot.generation };
+		}
+
+		/** O(1); returns false if the handle is stale */
+		bool remove(const SlotHandle& handle)
+		{
+			if (!contains(handle))
+			{
+				return false;
+			}
+
+			//hold the value until the map is consistent; releasing it may run a destructor that uses this map
+			T removed = std::move(dense[slots[handle.index].denseIdx]);
+
+			Slot& slot = slots[handle.index];
+			const uint32_t lastIdx = static_cast<uint32_t>(dense.size() - 1);
+			if (slot.denseIdx != lastIdx)
+			{
+				dense[slot.denseIdx] = std::move(dense[lastIdx]);
+				denseToSlot[slot.denseIdx] = denseToSlot[lastIdx];
+				slots[denseToSlot[slot.denseIdx]].denseIdx = slot.denseIdx;
+			}
+			dense.pop_back();
+			denseToSlot.pop_back();
+
+			releaseSlot(handle.index);
+			return true;
+		}
+
+		/** O(1) */
+		bool contains(const SlotHandle& handle) const
+		{
+			//freed slots have already moved on to the generation of their next value
+			return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+		}
+
+		/** O(1); null if the handle is stale */
+		T* find(const SlotHandle& handle) { return contains(handle) ? &dense[slots[handle.index].denseIdx] : nullptr; }
+		const T* find(const SlotHandle& handle) const { return contains(handle) ? &dense[slots[handle.index].denseIdx] : nullptr; }
+
+		/** Invalidates every handle; slots are kept for reuse */
+		void clear()
+		{
+			for (uint32_t slotIdx : denseToSlot)
+			{
+				releaseSlot(slotIdx);
+			}
+			denseToSlot.clear();
+
+			//see remove, values are released after the map is consistent
+			std::vector<T> removed = std::move(dense);
+			dense.clear();
+		}
+
+		void reserve(size_t count)
+		{
+			dense.reserve(count);
+			denseToSlot.reserve(count);
+			slots.reserve(count);
+		}
+
+		size_t size() const { return dense.size(); }
+		bool empty() const { return dense.empty(); }
+
+		/** Number of slots ever created; this only grows when there are no free slots to reuse. */
+		size_t getNumSlots() const { return slots.size(); }
+
+		/** Dense index access, for loops that must tolerate inserts. */
+		T& operator[](size_t denseIdx) { return dense[denseIdx]; }
+		const T& operator[](size_t denseIdx) const { return dense[denseIdx]; }
+		SlotHandle getHandle(size_t denseIdx) const { return SlotHandle{ denseToSlot[denseIdx], slots[denseToSlot[denseIdx]].generation }; }
+
+		const_iterator begin() const { return dense.begin(); }
+		const_iterator end() const { return dense.end(); }
+
+	private:
+		void releaseSlot(uint32_t slotIdx)
+		{
+			Slot& slot = slots[slotIdx];
+			slot.denseIdx = SlotHandle::INVALID_INDEX;
+			++slot.generation;
+			slot.nextFree = freeListHead;
+			freeListHead = slotIdx;
+		}
+
+	private:
+		struct Slot
+		{
+			uint32_t denseIdx = SlotHandle::INVALID_INDEX;
+			uint32_t generation = 0;
+			uint32_t nextFree = SlotHandle::INVALID_INDEX;
+		};
+
+		std::vector<T> dense;					//values; the array walked by iteration
+		std::vector<uint32_t> denseToSlot;		//parallel to dense; lets removal fix up the slot of the value moved into the hole
+		std::vector<Slot> slots;
+		uint32_t freeListHead = SlotHandle::INVALID_INDEX;
+	};
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include <glm.hpp>
+#include <gtx/norm.hpp>
+
+namespace SA
+{
+	/** Flags that queries can require; an entry matches when it has every required flag. */
+	namespace TargetFlags
+	{
+		constexpr uint8_t NONE = 0;
+		constexpr uint8_t ATTACKABLE = 1 << 0;
+		constexpr uint8_t CARRIER = 1 << 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Team partitioned spatial index for finding enemies.
+	//
+	// Each team's entries form a k-d tree stored in a flat array (each node is the median of its range, split along
+	// the range's widest axis, and keeps the bounds of its subtree). Searches only visit teams other than the
+	// searcher's, skip subtrees whose bounds cannot hold anything closer than what was already found, and skip
+	// subtrees that have no entry with the required flags.
+	//
+	// Meant to be refilled and rebuilt once per frame: clear(), add() everything, build(), then query.
+	// build is O(n log n); a nearest enemy query is O(log n) on average rather than a walk over every entity.
+	//
+	// Results are ordered by distance; equal distances are ordered by the order entries were added.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	class TeamTargetIndex
+	{
+	public:
+		struct Result
+		{
+			T* element = nullptr;
+			float distance2 = 0.f;
+			uint32_t addOrder = 0;
+		};
+
+	public:
+		void clear()
+		{
+			for (TeamTree& team : teams)
+			{
+				team.nodes.clear();
+			}
+			numEntries = 0;
+			bBuilt = false;
+		}
+
+		void add(T& element, const glm::vec3& position, size_t team, uint8_t flags = TargetFlags::NONE)
+		{
+			if (team >= teams.size())
+			{
+				teams.resize(team + 1);
+			}
+			Node node;
+			node.position = position;
+			node.element = &element;
+			node.addOrder = numEntries++;
+			node.flags = flags;
+			teams[team].nodes.push_back(node);
+			bBuilt = false;
+		}
+
+		void build()
+		{
+			for (TeamTree& team : teams)
+			{
+				buildRange(team.nodes, 0, team.nodes.size());
+			}
+			bBuilt = true;
+		}
+
+		bool isBuilt() const { return bBuilt; }
+		size_t size() const { return numEntries; }
+
+		/** Closest entry on any team other than searcherTeam; null if nothing matches within maxDistance. */
+		T* findNearestEnemy(const glm::vec3& origin, size_t searcherTeam, uint8_t requiredFlags = TargetFlags::NONE,
+			float maxDistance = std::numeric_limits<float>::infinity(), float* outDistance2 = nullptr) const
+		{
+			Result best;
+			size_t numFound = 0;
+			searchNearestEnemies(origin, searcherTeam, requiredFlags, maxDistance, &best, 1, numFound);
+			if (numFound > 0 && outDistance2)
+			{
+				*outDistance2 = best.distance2;
+			}
+			return numFound > 0 ? best.element : nullptr;
+		}
+
+		/** Up to k closest enemies, closest first. */
+		void findNearestEnemies(const glm::vec3& origin, size_t searcherTeam, size_t k, std::vector<Result>& outResults,
+			uint8_t requiredFlags = TargetFlags::NONE, float maxDistance = std::numeric_limits<float>::infinity()) const
+		{
+			outResults.resize(k);
+			size_t numFound = 0;
+			if (k > 0)
+			{
+				searchNearestEnemies(origin, searcherTeam, requiredFlags, maxDistance, outResults.data(), k, numFound);
+			}
+			outResults.resize(numFound);
+			std::sort_heap(outResults.begin(), outResults.end(), &isCloser);
+		}
+
+		/** Enemies within maxDistance whose direction from origin is at most halfAngleRadians from forward_n, closest first. */
+		void findEnemiesInCone(const glm::vec3& origin, const glm::vec3& forward_n, float halfAngleRadians, float maxDistance,
+			size_t searcherTeam, std::vector<Result>& outResults, uint8_t requiredFlags = TargetFlags::NONE) const
+		{
+			outResults.clear();
+			ConeQuery query;
+			query.origin = origin;
+			query.forward_n = forward_n;
+			query.cosHalfAngle = std::cos(halfAngleRadians);
+			query.maxDistance2 = maxDistance * maxDistance;
+			query.requiredFlags = requiredFlags;
+
+			for (size_t teamIdx = 0; teamIdx < teams.size(); ++teamIdx)
+			{
+				if (teamIdx != searcherTeam)
+				{
+					const std::vector<Node>& nodes = teams[teamIdx].nodes;
+					searchCone(nodes, 0, nodes.size(), query, outResults);
+				}
+			}
+			std::sort(outResults.begin(), outResults.end(), &isCloser);
+		}
+
+		/** The rule every query uses to decide whether a candidate is inside a cone; exposed so callers can match it. */
+		static bool isInCone(const glm::vec3& toCandidate, float distance2, const glm::vec3& forward_n, float cosHalfAngle)
+		{
+			return glm::dot(toCandidate, forward_n) >= cosHalfAngle * std::sqrt(distance2);
+		}
+
+		static bool isCloser(const Result& a, const Result& b)
+		{
+			return a.distance2 < b.distance2 || (a.distance2 == b.distance2 && a.addOrder < b.addOrder);
+		}
+
+	private:
+		struct Node
+		{
+			glm::vec3 position;
+			glm::vec3 subtreeMin;
+			glm::vec3 subtreeMax;
+			T* element = nullptr;
+			uint32_t addOrder = 0;
+			uint8_t flags = 0;
+			uint8_t subtreeFlags = 0; //every flag found in this node's subtree, so filtered queries can skip whole subtrees
+			uint8_t splitAxis = 0;
+		};
+
+		struct TeamTree
+		{
+			std::vector<Node> nodes; //implicit tree; the node for range [lo, hi) lives at the middle of the range
+		};
+
+		struct ConeQuery
+		{
+			glm::vec3 origin;
+			glm::vec3 forward_n;
+			float cosHalfAngle;
+			float maxDistance2;
+			uint8_t requiredFlags;
+		};
+
+		static size_t middle(size_t lo, size_t hi) { return lo + (hi - lo) / 2; }
+
+		static float distance2ToBounds(const glm::vec3& point, const Node& node)
+		{
+			const glm::vec3 closest = glm::clamp(point, node.subtreeMin, node.subtreeMax);
+			return glm::length2(closest - point);
+		}
+
+		/** Returns the flags found in the range. */
+		static uint8_t buildRange(std::vector<Node>& nodes, size_t lo, size_t hi)
+		{
+			if (lo >= hi)
+			{
+				return 0;
+			}
+
+			glm::vec3 minBound = nodes[lo].position;
+			glm::vec3 maxBound = nodes[lo].position;
+			for (size_t idx = lo + 1; idx < hi; ++idx)
+			{
+				minBound = glm::min(minBound, nodes[idx].position);
+				maxBound = glm::max(maxBound, nodes[idx].position);
+			}
+			const glm::vec3 extent = maxBound - minBound;
+			const uint8_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+			const size_t mid = middle(lo, hi);
+			std::nth_element(nodes.begin() + lo, nodes.begin() + mid, nodes.begin() + hi,
+				[axis](const Node& a, const Node& b) { return a.position[axis] < b.position[axis]; });
+
+			Node& node = nodes[mid];
+			node.splitAxis = axis;
+			node.subtreeMin = minBound;
+			node.subtreeMax = maxBound;
+			node.subtreeFlags = node.flags | buildRange(nodes, lo, mid) | buildRange(nodes, mid + 1, hi);
+			return node.subtreeFlags;
+		}
+
+		void searchNearestEnemies(const glm::vec3& origin, size_t searcherTeam, uint8_t requiredFlags, float maxDistance,
+			Result* heap, size_t k, size_t& inOut_heapSize) const
+		{
+			const float maxDistance2 = maxDistance * maxDistance;
+			for (size_t teamIdx = 0; teamIdx < teams.size(); ++teamIdx)
+			{
+				if (teamIdx != searcherTeam)
+				{
+					const std::vector<Node>& nodes = teams[teamIdx].nodes;
+					searchNearest(nodes, 0, nodes.size(), origin, requiredFlags, maxDistance2, heap, k, inOut_heapSize);
+				}
+			}
+		}
+
+		/** heap is a max heap on distance, so its front is the candidate to replace */
+		static void searchNearest(const std::vector<Node>& nodes, size_t lo, size_t hi, const glm::vec3& origin, uint8_t requiredFlags,
+			float maxDistance2, Result* heap, size_t k, size_t& inOut_heapSize)
+		{
+			if (lo >= hi)
+			{
+				return;
+			}
+
+			const size_t mid = middle(lo, hi);
+			const Node& node = nodes[mid];
+			if ((node.subtreeFlags & requiredFlags) != requiredFlags)
+			{
+				return;
+			}
+
+			//nothing in this subtree can be closer than its bounds
+			const float bound2 = inOut_heapSize < k ? maxDistance2 : heap[0].distance2;
+			if (distance2ToBounds(origin, node) > bound2)
+			{
+				return;
+			}
+
+			if ((node.flags & requiredFlags) == requiredFlags)
+			{
+				Result candidate{ node.element, glm::length2(node.position - origin), node.addOrder };
+				if (candidate.distance2 <= maxDistance2)
+				{
+					if (inOut_heapSize < k)
+					{
+						heap[inOut_heapSize++] = candidate;
+						std::push_heap(heap, heap + inOut_heapSize, &isCloser);
+					}
+					else if (isCloser(candidate, heap[0]))
+					{
+						std::pop_heap(heap, heap + inOut_heapSize, &isCloser);
+						heap[inOut_heapSize - 1] = candidate;
+						std::push_heap(heap, heap + inOut_heapSize, &isCloser);
+					}
+				}
+			}
+
+			//near side first so the far side is more likely to be rejected by its bounds
+			const bool bOriginBelow = origin[node.splitAxis] < node.position[node.splitAxis];
+			searchNearest(nodes, bOriginBelow ? lo : mid + 1, bOriginBelow ? mid : hi, origin, requiredFlags, maxDistance2, heap, k, inOut_heapSize);
+			searchNearest(nodes, bOriginBelow ? mid + 1 : lo, bOriginBelow ? hi : mid, origin, requiredFlags, maxDistance2, heap, k, inOut_heapSize);
+		}
+
+		static void searchCone(const std::vector<Node>& nodes, size_t lo, size_t hi, const ConeQuery& query, std::vector<Result>& outResults)
+		{
+			if (lo >= hi)
+			{
+				return;
+			}
+
+			const size_t mid = middle(lo, hi);
+			const Node& node = nodes[mid];
+			if ((node.subtreeFlags & query.requiredFlags) != query.requiredFlags || distance2ToBounds(query.origin, node) > query.maxDistance2)
+			{
+				return;
+			}
+
+			if ((node.flags & query.requiredFlags) == query.requiredFlags)
+			{
+				const glm::vec3 toNode = node.position - query.origin;
+				const float distance2 = glm::length2(toNode);
+				if (distance2 <= query.maxDistance2 && isInCone(toNode, distance2, query.forward_n, query.cosHalfAngle))
+				{
+					outResults.push_back(Result{ node.element, distance2, node.addOrder });
+				}
+			}
+
+			searchCone(nodes, lo, mid, query, outResults);
+			searchCone(nodes, mid + 1, hi, query, outResults);
+		}
+
+	private:
+		std::vector<TeamTree> teams;
+		uint32_t numEntries = 0;
+		bool bBuilt = false;
+	};
+}
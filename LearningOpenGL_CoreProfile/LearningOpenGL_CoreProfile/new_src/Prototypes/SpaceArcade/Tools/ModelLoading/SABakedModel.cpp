@@ -0,0 +1,694 @@
+#include "SABakedModel.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <type_traits>
+#include <cassert>
+#include <cctype>
+#include <algorithm>
+
+#include "../SAMappedFile.h"
+
+namespace SA
+{
+	namespace
+	{
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Cache layout: a fixed header followed by the payload. The payload is a sequence of counts, raw arrays of
+		// trivially copyable structs, and length-prefixed strings, written in little-endian host order.
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		constexpr char cacheMagic[8] = { 'S', 'A', 'B', 'A', 'K', 'E', '\0', '\0' };
+
+		struct CacheHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t layoutSignature;	//catches struct layout changes (eg a new vertex attribute) that did not bump the version
+			uint64_t sourceHash;
+			uint64_t payloadBytes;
+			uint64_t payloadHash;
+		};
+
+		/** aiVectorKey is not trivially copyable (aiVector3D declares its own copy constructor), so it is stored as this instead */
+		struct SerializedVectorKey
+		{
+			double time;
+			float value[3];
+		};
+
+		uint32_t computeLayoutSignature()
+		{
+			return uint32_t(sizeof(Vertex)) | uint32_t(sizeof(NormalData)) << 8 | uint32_t(sizeof(VertexBoneData)) << 16 | uint32_t(MAX_NUM_BONES) << 24;
+		}
+
+		class CacheWriter
+		{
+		public:
+			template<typename T>
+			void writePod(const T& value)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written directly");
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+				buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+			}
+
+			template<typename T>
+			void writeArray(const std::vector<T>& values)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written directly");
+				writePod(uint64_t(values.size()));
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+				buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+			}
+
+			void writeString(const std::string& value)
+			{
+				writePod(uint32_t(value.size()));
+				buffer.insert(buffer.end(), value.begin(), value.end());
+			}
+
+			void writeVectorKeys(const std::vector<aiVectorKey>& keys)
+			{
+				std::vector<SerializedVectorKey> serialized(keys.size());
+				for (size_t keyIdx = 0; keyIdx < keys.size(); ++keyIdx)
+				{
+					serialized[keyIdx] = { keys[keyIdx].mTime, { keys[keyIdx].mValue.x, keys[keyIdx].mValue.y, keys[keyIdx].mValue.z } };
+				}
+				writeArray(serialized);
+			}
+
+			std::vector<uint8_t> buffer;
+		};
+
+		/** every read is bounds checked; after any failure all reads fail so callers can check once at the end */
+		class CacheReader
+		{
+		public:
+			CacheReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+			template<typename T>
+			bool readPod(T& outValue)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read directly");
+				if (!bValid || size - cursor < sizeof(T))
+				{
+					bValid = false;
+					return false;
+				}
+				std::memcpy(&outValue, data + cursor, sizeof(T));
+				cursor += sizeof(T);
+				return true;
+			}
+
+			template<typename T>
+			bool readArray(std::vector<T>& outValues)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read directly");
+				uint64_t count = 0;
+				if (!readPod(count) || count > (size - cursor) / sizeof(T))
+				{
+					bValid = false;
+					return false;
+				}
+				outValues.resize(size_t(count));
+				std::memcpy(outValues.data(), data + cursor, size_t(count) * sizeof(T));
+				cursor += size_t(count) * sizeof(T);
+				return true;
+			}
+
+			bool readString(std::string& outValue)
+			{
+				uint32_t length = 0;
+				if (!readPod(length) || length > size - cursor)
+				{
+					bValid = false;
+					return false;
+				}
+				outValue.assign(reinterpret_cast<const char*>(data + cursor), length);
+				cursor += length;
+				return true;
+			}
+
+			bool readVectorKeys(std::vector<aiVectorKey>& outKeys)
+			{
+				std::vector<SerializedVectorKey> serialized;
+				if (!readArray(serialized))
+				{
+					return false;
+				}
+				outKeys.resize(serialized.size());
+				for (size_t keyIdx = 0; keyIdx < serialized.size(); ++keyIdx)
+				{
+					outKeys[keyIdx].mTime = serialized[keyIdx].time;
+					outKeys[keyIdx].mValue = aiVector3D(serialized[keyIdx].value[0], serialized[keyIdx].value[1], serialized[keyIdx].value[2]);
+				}
+				return true;
+			}
+
+			/** counts are validated against the remaining bytes so a corrupt count cannot trigger a huge allocation */
+			bool readCount(uint64_t& outCount, size_t minBytesPerElement)
+			{
+				if (!readPod(outCount) || outCount > (size - cursor) / minBytesPerElement)
+				{
+					bValid = false;
+					return false;
+				}
+				return true;
+			}
+
+			bool isValid() const { return bValid; }
+			bool isFullyConsumed() const { return bValid && cursor == size; }
+
+		private:
+			const uint8_t* data;
+			size_t size;
+			size_t cursor = 0;
+			bool bValid = true;
+		};
+
+		void writeModel(CacheWriter& writer, const BakedModel& model)
+		{
+			writer.writePod(model.aabbMin);
+			writer.writePod(model.aabbMax);
+			writer.writePod(model.inverseSceneTransform);
+
+			writer.writePod(uint64_t(model.meshes.size()));
+			for (const BakedMesh& mesh : model.meshes)
+			{
+				writer.writeArray(mesh.vertices);
+				writer.writeArray(mesh.normalData);
+				writer.writeArray(mesh.indices);
+				writer.writeArray(mesh.vertexBoneData);
+
+				writer.writePod(uint64_t(mesh.textures.size()));
+				for (const BakedTextureRef& texture : mesh.textures)
+				{
+					writer.writeString(texture.type);
+					writer.writeString(texture.relativePath);
+				}
+
+				writer.writePod(uint64_t(mesh.bones.size()));
+				for (const BakedBone& bone : mesh.bones)
+				{
+					writer.writeString(bone.name);
+					writer.writePod(bone.meshToBoneTransform);
+					writer.writePod(int32_t(bone.uniqueID));
+					writer.writeArray(bone.weights);
+				}
+			}
+
+			writer.writePod(uint64_t(model.nodes.size()));
+			for (const BakedNode& node : model.nodes)
+			{
+				writer.writeString(node.name);
+				writer.writePod(node.transform);
+				writer.writePod(node.parentIdx);
+			}
+
+			writer.writePod(uint64_t(model.animations.size()));
+			for (const BakedAnimation& animation : model.animations)
+			{
+				writer.writePod(animation.duration);
+				writer.writePod(animation.ticksPerSecond);
+				writer.writePod(uint64_t(animation.channels.size()));
+				for (const BakedChannel& channel : animation.channels)
+				{
+					writer.writeString(channel.nodeName);
+					writer.writeVectorKeys(channel.positionKeys);
+					writer.writeArray(channel.rotationKeys);
+					writer.writeVectorKeys(channel.scalingKeys);
+				}
+			}
+		}
+
+		bool readModel(CacheReader& reader, BakedModel& model)
+		{
+			//smallest possible encodings of each element; used to reject corrupt counts before allocating
+			constexpr size_t minMeshBytes = 6 * sizeof(uint64_t);
+			constexpr size_t minTextureBytes = 2 * sizeof(uint32_t);
+			constexpr size_t minBoneBytes = sizeof(uint32_t) + sizeof(aiMatrix4x4) + sizeof(int32_t) + sizeof(uint64_t);
+			constexpr size_t minNodeBytes = sizeof(uint32_t) + sizeof(aiMatrix4x4) + sizeof(int32_t);
+			constexpr size_t minAnimationBytes = 2 * sizeof(double) + sizeof(uint64_t);
+			constexpr size_t minChannelBytes = sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+			reader.readPod(model.aabbMin);
+			reader.readPod(model.aabbMax);
+			reader.readPod(model.inverseSceneTransform);
+
+			uint64_t numMeshes = 0;
+			if (!reader.readCount(numMeshes, minMeshBytes)) { return false; }
+			model.meshes.resize(size_t(numMeshes));
+			for (BakedMesh& mesh : model.meshes)
+			{
+				reader.readArray(mesh.vertices);
+				reader.readArray(mesh.normalData);
+				reader.readArray(mesh.indices);
+				reader.readArray(mesh.vertexBoneData);
+
+				uint64_t numTextures = 0;
+				if (!reader.readCount(numTextures, minTextureBytes)) { return false; }
+				mesh.textures.resize(size_t(numTextures));
+				for (BakedTextureRef& texture : mesh.textures)
+				{
+					reader.readString(texture.type);
+					reader.readString(texture.relativePath);
+				}
+
+				uint64_t numBones = 0;
+				if (!reader.readCount(numBones, minBoneBytes)) { return false; }
+				mesh.bones.resize(size_t(numBones));
+				for (BakedBone& bone : mesh.bones)
+				{
+					int32_t uniqueID = -1;
+					reader.readString(bone.name);
+					reader.readPod(bone.meshToBoneTransform);
+					reader.readPod(uniqueID);
+					reader.readArray(bone.weights);
+					bone.uniqueID = uniqueID;
+				}
+
+				if (!reader.isValid()) { return false; }
+			}
+
+			uint64_t numNodes = 0;
+			if (!reader.readCount(numNodes, minNodeBytes)) { return false; }
+			model.nodes.resize(size_t(numNodes));
+			for (size_t nodeIdx = 0; nodeIdx < model.nodes.size(); ++nodeIdx)
+			{
+				BakedNode& node = model.nodes[nodeIdx];
+				reader.readString(node.name);
+				reader.readPod(node.transform);
+				reader.readPod(node.parentIdx);
+				if (node.parentIdx >= int32_t(nodeIdx) || (node.parentIdx < 0 && nodeIdx != 0))
+				{
+					return false; //parents must come before children, and only the root has no parent
+				}
+			}
+
+			uint64_t numAnimations = 0;
+			if (!reader.readCount(numAnimations, minAnimationBytes)) { return false; }
+			model.animations.resize(size_t(numAnimations));
+			for (BakedAnimation& animation : model.animations)
+			{
+				reader.readPod(animation.duration);
+				reader.readPod(animation.ticksPerSecond);
+
+				uint64_t numChannels = 0;
+				if (!reader.readCount(numChannels, minChannelBytes)) { return false; }
+				animation.channels.resize(size_t(numChannels));
+				for (BakedChannel& channel : animation.channels)
+				{
+					reader.readString(channel.nodeName);
+					reader.readVectorKeys(channel.positionKeys);
+					reader.readArray(channel.rotationKeys);
+					reader.readVectorKeys(channel.scalingKeys);
+				}
+			}
+
+			return reader.isFullyConsumed();
+		}
+
+		void bakeMaterialTextures(const aiMaterial& material, aiTextureType type, const char* typeName, std::vector<BakedTextureRef>& outTextures)
+		{
+			uint32_t textureCount = material.GetTextureCount(type);
+			for (uint32_t i = 0; i < textureCount; i++)
+			{
+				aiString str;
+				material.GetTexture(type, i, &str);
+				outTextures.push_back({ typeName, std::string(str.C_Str()) });
+			}
+		}
+
+		/** names after each `mtllib` statement; like assimp, the rest of the line is the file name */
+		void findMaterialLibraries(const uint8_t* objBytes, size_t numBytes, std::vector<std::string>& outLibraries)
+		{
+			const char* text = reinterpret_cast<const char*>(objBytes);
+			size_t lineStart = 0;
+			while (lineStart < numBytes)
+			{
+				size_t lineEnd = lineStart;
+				while (lineEnd < numBytes && text[lineEnd] != '\n') { ++lineEnd; }
+
+				size_t cursor = lineStart;
+				while (cursor < lineEnd && (text[cursor] == ' ' || text[cursor] == '\t')) { ++cursor; }
+				constexpr size_t keywordLength = 6;
+				if (lineEnd - cursor > keywordLength && std::memcmp(text + cursor, "mtllib", keywordLength) == 0
+					&& (text[cursor + keywordLength] == ' ' || text[cursor + keywordLength] == '\t'))
+				{
+					size_t nameStart = cursor + keywordLength;
+					size_t nameEnd = lineEnd;
+					while (nameStart < nameEnd && std::isspace(static_cast<unsigned char>(text[nameStart]))) { ++nameStart; }
+					while (nameEnd > nameStart && std::isspace(static_cast<unsigned char>(text[nameEnd - 1]))) { --nameEnd; }
+					if (nameEnd > nameStart)
+					{
+						outLibraries.emplace_back(text + nameStart, nameEnd - nameStart);
+					}
+				}
+				lineStart = lineEnd + 1;
+			}
+		}
+
+		bool isObjFile(const std::string& filepath)
+		{
+			std::string extension = std::filesystem::path(filepath).extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+			return extension == ".obj";
+		}
+	}
+
+	namespace ModelBake
+	{
+		BakedMesh bakeMesh(const aiMesh& mesh, std::map<std::string, int>& boneIdsByName, glm::vec3& inOut_aabbMin, glm::vec3& inOut_aabbMax)
+		{
+			BakedMesh baked;
+			baked.vertices.reserve(mesh.mNumVertices);
+			baked.normalData.reserve(mesh.mNumVertices);
+
+			for (uint32_t i = 0; i < mesh.mNumVertices; ++i)
+			{
+				Vertex vertex;
+				vertex.position.x = mesh.mVertices[i].x;
+				vertex.position.y = mesh.mVertices[i].y;
+				vertex.position.z = mesh.mVertices[i].z;
+				inOut_aabbMin = glm::min(inOut_aabbMin, vertex.position);
+				inOut_aabbMax = glm::max(inOut_aabbMax, vertex.position);
+
+				vertex.normal.x = mesh.mNormals[i].x;
+				vertex.normal.y = mesh.mNormals[i].y;
+				vertex.normal.z = mesh.mNormals[i].z;
+
+				//check if model has texture coordinates
+				if (mesh.mTextureCoords[0])
+				{
+					vertex.textureCoords.x = mesh.mTextureCoords[0][i].x;
+					vertex.textureCoords.y = mesh.mTextureCoords[0][i].y;
+				}
+				else
+				{
+					vertex.textureCoords = { 0.f, 0.f };
+				}
+
+				NormalData nmData;
+				nmData.tangent.x = mesh.mTangents[i].x;
+				nmData.tangent.y = mesh.mTangents[i].y;
+				nmData.tangent.z = mesh.mTangents[i].z;
+				nmData.tangent = glm::normalize(nmData.tangent);
+
+				nmData.bitangent.x = mesh.mBitangents[i].x;
+				nmData.bitangent.y = mesh.mBitangents[i].y;
+				nmData.bitangent.z = mesh.mBitangents[i].z;
+				nmData.bitangent = glm::normalize(nmData.bitangent);
+
+				baked.vertices.push_back(vertex);
+				baked.normalData.push_back(nmData);
+			}
+
+			for (uint32_t i = 0; i < mesh.mNumFaces; ++i)
+			{
+				//loader forces faces to be triangles, so these indices should be valid for drawing triangles
+				const aiFace& face = mesh.mFaces[i];
+				for (uint32_t j = 0; j < face.mNumIndices; ++j)
+				{
+					baked.indices.push_back(face.mIndices[j]);
+				}
+			}
+
+			baked.vertexBoneData.resize(baked.vertices.size()); //default constructor all bone weights to 0
+
+			for (uint32_t boneIdx = 0; boneIdx < mesh.mNumBones; ++boneIdx)
+			{
+				const aiBone* bone = mesh.mBones[boneIdx];
+
+				BakedBone bakedBone;
+				bakedBone.name = bone->mName.C_Str();
+				bakedBone.meshToBoneTransform = bone->mOffsetMatrix;
+				bakedBone.weights.assign(bone->mWeights, bone->mWeights + bone->mNumWeights);
+
+				//meshes sharing bones need correct ids
+				auto existingId = boneIdsByName.find(bakedBone.name);
+				if (existingId != boneIdsByName.end())
+				{
+					bakedBone.uniqueID = existingId->second;
+				}
+				else
+				{
+					bakedBone.uniqueID = static_cast<int>(boneIdsByName.size());
+					boneIdsByName[bakedBone.name] = bakedBone.uniqueID;
+				}
+
+				for (uint32_t wgt = 0; wgt < bone->mNumWeights; ++wgt)
+				{
+					uint32_t vertId = bone->mWeights[wgt].mVertexId;
+					VertexBoneData& vertexBones = baked.vertexBoneData[vertId];
+					int curBone = vertexBones.currentBone;
+
+					assert(curBone != MAX_NUM_BONES); //assert if we're about to go out of bounds
+
+					//to vertex data, add an influencing bone and its weight; these will be used to lookup into bone transforms array
+					vertexBones.boneWeights[curBone] = bone->mWeights[wgt].mWeight;
+					vertexBones.boneIds[curBone] = bakedBone.uniqueID;
+					vertexBones.currentBone++;
+				}
+
+				baked.bones.push_back(std::move(bakedBone));
+			}
+
+			return baked;
+		}
+
+		std::vector<BakedNode> bakeNodes(const aiNode& rootNode, std::vector<const aiNode*>* outSourceNodes)
+		{
+			std::vector<BakedNode> nodes;
+
+			//walk the graph depth first so nodes are stored parent-before-child
+			std::vector<std::pair<const aiNode*, int32_t>> nodeStack = { { &rootNode, -1 } };
+			while (!nodeStack.empty())
+			{
+				const aiNode* node = nodeStack.back().first;
+				int32_t parentIdx = nodeStack.back().second;
+				nodeStack.pop_back();
+
+				int32_t nodeIdx = int32_t(nodes.size());
+				nodes.push_back({ std::string(node->mName.C_Str()), node->mTransformation, parentIdx });
+				if (outSourceNodes)
+				{
+					outSourceNodes->push_back(node);
+				}
+
+				//push in reverse so children pop in their original order
+				for (uint32_t child = node->mNumChildren; child > 0; --child)
+				{
+					nodeStack.push_back({ node->mChildren[child - 1], nodeIdx });
+				}
+			}
+			return nodes;
+		}
+
+		BakedAnimation bakeAnimation(const aiAnimation& anim)
+		{
+			BakedAnimation bakedAnimation;
+			bakedAnimation.duration = anim.mDuration;
+			bakedAnimation.ticksPerSecond = anim.mTicksPerSecond;
+			for (uint32_t channelIdx = 0; channelIdx < anim.mNumChannels; ++channelIdx)
+			{
+				const aiNodeAnim* nodeAnim = anim.mChannels[channelIdx];
+
+				BakedChannel channel;
+				channel.nodeName = nodeAnim->mNodeName.C_Str();
+				channel.positionKeys.assign(nodeAnim->mPositionKeys, nodeAnim->mPositionKeys + nodeAnim->mNumPositionKeys);
+				channel.rotationKeys.assign(nodeAnim->mRotationKeys, nodeAnim->mRotationKeys + nodeAnim->mNumRotationKeys);
+				channel.scalingKeys.assign(nodeAnim->mScalingKeys, nodeAnim->mScalingKeys + nodeAnim->mNumScalingKeys);
+				bakedAnimation.channels.push_back(std::move(channel));
+			}
+			return bakedAnimation;
+		}
+
+		up<BakedModel> bakeScene(const aiScene& scene)
+		{
+			up<BakedModel> model = new_up<BakedModel>();
+			std::map<std::string, int> boneIdsByName;
+
+			model->inverseSceneTransform = scene.mRootNode->mTransformation;
+			model->inverseSceneTransform.Inverse();
+
+			//meshes are baked in the order the depth first walk reaches the nodes referencing them
+			std::vector<const aiNode*> sourceNodes;
+			model->nodes = bakeNodes(*scene.mRootNode, &sourceNodes);
+			for (const aiNode* node : sourceNodes)
+			{
+				for (uint32_t i = 0; i < node->mNumMeshes; ++i)
+				{
+					const aiMesh* mesh = scene.mMeshes[node->mMeshes[i]];
+					BakedMesh bakedMesh = bakeMesh(*mesh, boneIdsByName, model->aabbMin, model->aabbMax);
+
+					const aiMaterial* material = scene.mMaterials[mesh->mMaterialIndex];
+					bakeMaterialTextures(*material, aiTextureType_DIFFUSE, "texture_diffuse", bakedMesh.textures);
+					bakeMaterialTextures(*material, aiTextureType_SPECULAR, "texture_specular", bakedMesh.textures);
+					bakeMaterialTextures(*material, aiTextureType_AMBIENT, "texture_ambient", bakedMesh.textures);
+					bakeMaterialTextures(*material, aiTextureType_HEIGHT, "texture_normalmap", bakedMesh.textures); //aiTextureType seems to load normal maps from aiTextureType_HEIGHT, rather than aiTextureType_NORMAL
+
+					model->meshes.push_back(std::move(bakedMesh));
+				}
+			}
+
+			for (uint32_t animIdx = 0; animIdx < scene.mNumAnimations; ++animIdx)
+			{
+				model->animations.push_back(bakeAnimation(*scene.mAnimations[animIdx]));
+			}
+
+			return model;
+		}
+
+		uint64_t hashBytes(const uint8_t* bytes, size_t numBytes)
+		{
+			//FNV-1a; only needs to detect changed files, not resist tampering
+			uint64_t hash = 14695981039346656037ull;
+			for (size_t byteIdx = 0; byteIdx < numBytes; ++byteIdx)
+			{
+				hash ^= bytes[byteIdx];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		bool hashModelSource(const std::string& modelFilepath, uint64_t& outHash)
+		{
+			std::vector<uint64_t> fileHashes;
+			std::vector<std::string> materialLibraries;
+			{
+				MappedFile sourceFile;
+				if (!sourceFile.open(modelFilepath))
+				{
+					return false;
+				}
+				fileHashes.push_back(hashBytes(sourceFile.getData(), sourceFile.getSize()));
+				if (isObjFile(modelFilepath))
+				{
+					findMaterialLibraries(sourceFile.getData(), sourceFile.getSize(), materialLibraries);
+				}
+			}
+
+			//assimp resolves libraries next to the model; a missing library hashes as 0 so adding it later rebuilds the cache
+			std::filesystem::path modelDirectory = std::filesystem::path(modelFilepath).parent_path();
+			for (const std::string& library : materialLibraries)
+			{
+				MappedFile libraryFile;
+				fileHashes.push_back(libraryFile.open((modelDirectory / library).string()) ? hashBytes(libraryFile.getData(), libraryFile.getSize()) : 0);
+			}
+
+			outHash = hashBytes(reinterpret_cast<const uint8_t*>(fileHashes.data()), fileHashes.size() * sizeof(uint64_t));
+			return true;
+		}
+
+		bool writeCache(const std::string& cacheFilepath, const BakedModel& model, uint64_t sourceHash)
+		{
+			CacheWriter writer;
+			writeModel(writer, model);
+
+			CacheHeader header;
+			std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+			header.version = cacheFormatVersion;
+			header.layoutSignature = computeLayoutSignature();
+			header.sourceHash = sourceHash;
+			header.payloadBytes = writer.buffer.size();
+			header.payloadHash = hashBytes(writer.buffer.data(), writer.buffer.size());
+
+			//write next to the destination then swap it in, so a crash mid-write never leaves a truncated cache behind
+			std::string tempFilepath = cacheFilepath + ".tmp";
+			{
+				std::ofstream outFile(tempFilepath, std::ios::binary | std::ios::trunc);
+				if (!outFile)
+				{
+					return false;
+				}
+				outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				outFile.write(reinterpret_cast<const char*>(writer.buffer.data()), std::streamsize(writer.buffer.size()));
+				if (!outFile)
+				{
+					outFile.close();
+					std::error_code removeError;
+					std::filesystem::remove(tempFilepath, removeError);
+					return false;
+				}
+			}
+
+			std::error_code renameError;
+			std::filesystem::rename(tempFilepath, cacheFilepath, renameError);
+			if (renameError)
+			{
+				std::error_code removeError;
+				std::filesystem::remove(tempFilepath, removeError);
+				return false;
+			}
+			return true;
+		}
+
+		up<BakedModel> readCache(const std::string& cacheFilepath, uint64_t expectedSourceHash)
+		{
+			MappedFile cacheFile;
+			if (!cacheFile.open(cacheFilepath) || cacheFile.getSize() < sizeof(CacheHeader))
+			{
+				return nullptr;
+			}
+
+			CacheHeader header;
+			std::memcpy(&header, cacheFile.getData(), sizeof(header));
+			if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0
+				|| header.version != cacheFormatVersion
+				|| header.layoutSignature != computeLayoutSignature()
+				|| header.sourceHash != expectedSourceHash
+				|| header.payloadBytes != cacheFile.getSize() - sizeof(CacheHeader))
+			{
+				return nullptr;
+			}
+
+			const uint8_t* payload = cacheFile.getData() + sizeof(CacheHeader);
+			if (hashBytes(payload, size_t(header.payloadBytes)) != header.payloadHash)
+			{
+				return nullptr;
+			}
+
+			up<BakedModel> model = new_up<BakedModel>();
+			CacheReader reader(payload, size_t(header.payloadBytes));
+			if (!readModel(reader, *model))
+			{
+				return nullptr;
+			}
+			return model;
+		}
+
+		up<BakedModel> loadOrBake(const std::string& modelFilepath)
+		{
+			uint64_t sourceHash = 0;
+			bool bHashedSource = hashModelSource(modelFilepath, sourceHash);
+
+			std::string cacheFilepath = modelFilepath + cacheFileExtension;
+			if (bHashedSource)
+			{
+				if (up<BakedModel> cachedModel = readCache(cacheFilepath, sourceHash))
+				{
+					return cachedModel;
+				}
+			}
+
+			Assimp::Importer importer;
+			const aiScene* scene = importer.ReadFile(modelFilepath, importFlags);
+			if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+			{
+				std::cerr << "Assimp: error importing model: ERROR::" << importer.GetErrorString() << std::endl;
+				return nullptr;
+			}
+
+			up<BakedModel> model = bakeScene(*scene);
+			if (bHashedSource && !writeCache(cacheFilepath, *model, sourceHash))
+			{
+				std::cerr << "failed to write model cache " << cacheFilepath << std::endl; //not fatal, the model is just imported again next launch
+			}
+			return model;
+		}
+	}
+}
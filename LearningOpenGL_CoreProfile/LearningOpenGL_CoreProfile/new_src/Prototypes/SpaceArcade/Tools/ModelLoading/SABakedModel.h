@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include "SAMesh.h"
+#include "../../GameFramework/SAGameEntity.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Baked models are the CPU side of a Model3D with everything assimp produced flattened into plain arrays.
+	// They are what Model3D is built from, and what is written to the binary model cache so later launches can
+	// skip assimp entirely.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	struct BakedTextureRef
+	{
+		std::string type;			//eg "texture_diffuse"
+		std::string relativePath;	//relative to the model's directory, as stored in the material
+	};
+
+	struct BakedBone
+	{
+		std::string name;
+		aiMatrix4x4 meshToBoneTransform;
+		int uniqueID = -1;
+		std::vector<aiVertexWeight> weights;
+	};
+
+	struct BakedMesh
+	{
+		std::vector<Vertex> vertices;
+		std::vector<NormalData> normalData;
+		std::vector<unsigned int> indices;
+		std::vector<VertexBoneData> vertexBoneData;
+		std::vector<BakedTextureRef> textures;	//diffuse, specular, ambient, then normal maps
+		std::vector<BakedBone> bones;
+	};
+
+	/** node of the scene graph; nodes are stored parent-before-child in depth first order */
+	struct BakedNode
+	{
+		std::string name;
+		aiMatrix4x4 transform;
+		int32_t parentIdx = -1;
+	};
+
+	struct BakedChannel
+	{
+		std::string nodeName;
+		std::vector<aiVectorKey> positionKeys;
+		std::vector<aiQuatKey> rotationKeys;
+		std::vector<aiVectorKey> scalingKeys;
+	};
+
+	struct BakedAnimation
+	{
+		double duration = 0.0;
+		double ticksPerSecond = 0.0;
+		std::vector<BakedChannel> channels;
+	};
+
+	struct BakedModel
+	{
+		std::vector<BakedMesh> meshes;	//one per mesh reference in node order, matching how the scene graph is walked
+		glm::vec3 aabbMin{ 0.f };
+		glm::vec3 aabbMax{ 0.f };
+		aiMatrix4x4 inverseSceneTransform;
+		std::vector<BakedNode> nodes;
+		std::vector<BakedAnimation> animations;
+	};
+
+	namespace ModelBake
+	{
+		/** bump when the layout of the cache or the way meshes are baked changes; old caches are then rebuilt */
+		constexpr uint32_t cacheFormatVersion = 1;
+		constexpr const char* cacheFileExtension = ".sabake";
+
+		//smooth normals required for bob model, adding aiProcessJointIdenticavertices to better match tutorial
+		constexpr unsigned int importFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices;
+
+		/** Flattens a single assimp mesh. Bone ids are shared across meshes through boneIdsByName. Does not fill textures. */
+		BakedMesh bakeMesh(const aiMesh& mesh, std::map<std::string, int>& boneIdsByName, glm::vec3& inOut_aabbMin, glm::vec3& inOut_aabbMax);
+
+		/** Flattens the scene graph under rootNode parent-before-child. Optionally reports the assimp node each baked node came from. */
+		std::vector<BakedNode> bakeNodes(const aiNode& rootNode, std::vector<const aiNode*>* outSourceNodes = nullptr);
+
+		BakedAnimation bakeAnimation(const aiAnimation& anim);
+
+		/** Flattens an imported scene; the scene may be released afterwards. */
+		up<BakedModel> bakeScene(const aiScene& scene);
+
+		uint64_t hashBytes(const uint8_t* bytes, size_t numBytes);
+
+		/** Hash of the model file and every material library it references (.obj mtllib), as the libraries hold the baked texture paths.
+			Returns false if the model file can't be read. */
+		bool hashModelSource(const std::string& modelFilepath, uint64_t& outHash);
+
+		bool writeCache(const std::string& cacheFilepath, const BakedModel& model, uint64_t sourceHash);
+
+		/** Returns nullptr if the cache is missing, from another format version, built from a different source file, or corrupt. */
+		up<BakedModel> readCache(const std::string& cacheFilepath, uint64_t expectedSourceHash);
+
+		/** Loads the model from its cache if the cache matches the source files (see hashModelSource); otherwise imports with assimp and writes the cache.
+			Does not touch GPU or game state, so it is safe to call from a worker thread. Returns nullptr on failure. */
+		up<BakedModel> loadOrBake(const std::string& modelFilepath);
+	}
+}
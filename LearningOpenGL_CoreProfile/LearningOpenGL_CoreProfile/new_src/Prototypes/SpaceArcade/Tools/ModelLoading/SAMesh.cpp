@@ -237,6 +237,17 @@ namespace SA
 		ec(glBindVertexArray(0));
 	}
 
+	void Mesh3D::setTextureId(const std::string& texturePath, unsigned int textureId)
+	{
+		for (MaterialTexture& texture : textures)
+		{
+			if (texture.path == texturePath)
+			{
+				texture.id = textureId;
+			}
+		}
+	}
+
 	void Mesh3D::releaseGPUData()
 	{
 		//if you get stuck in this function on shutdown, you probably didn't manage your model through the asset system.
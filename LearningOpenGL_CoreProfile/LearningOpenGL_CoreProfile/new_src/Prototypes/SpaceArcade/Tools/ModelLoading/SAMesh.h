@@ -73,6 +73,8 @@ namespace SA
 		GLuint getVAO();
 		void setInstancedModelMatrixVBO(GLuint modelVBO);
 		void setInstancedModelMatricesData(glm::mat4* modelMatrices, unsigned int count);
+		/** for textures that finish loading after the mesh is created */
+		void setTextureId(const std::string& texturePath, unsigned int textureId);
 
 		const std::vector<Vertex>& getVertices() const { return vertices; }
 		const std::vector<unsigned int>& getIndices() const { return indices; }
@@ -25,6 +25,17 @@ namespace SA
 		loadModel(path);
 	}
 
+	Model3D::Model3D(const char* path, up<BakedModel> bakedModel)
+	{
+		cachedAABB = std::make_tuple(glm::vec3{ 0,0,0 }, glm::vec3{ 0,0,0 });
+		if (!bakedModel)
+		{
+			throw std::runtime_error("failed to load required model");
+		}
+		bAsyncTextures = true;
+		loadFromBaked(path, std::move(bakedModel));
+	}
+
 	Model3D::~Model3D()
 	{
 		releaseGPUData();
@@ -87,21 +98,21 @@ namespace SA
 		using std::chrono::milliseconds;
 		using std::chrono::nanoseconds;
 
-		if (cachedScene && cachedScene->HasAnimations() && inOut_AnimationData.animId < cachedScene->mNumAnimations)
+		if (inOut_AnimationData.animId < skeletalAnimator.getNumAnimations())
 		{
 			auto currentTimePoint = std::chrono::system_clock::now(); //#TODO: this may should be handled externally so we only make this system call once
 			auto duration = duration_cast<milliseconds>(currentTimePoint - inOut_AnimationData.startTime); //use miliseconds to get milisecond precision
 			float animCurSeconds = static_cast<float>(duration.count()) / 1000.0f;
 
-			aiAnimation* anim = cachedScene->mAnimations[inOut_AnimationData.animId];
-			assert(anim->mDuration != 0);
-			assert(anim->mTicksPerSecond != 0);
+			const BakedAnimation& anim = skeletalAnimator.getAnimation(inOut_AnimationData.animId);
+			assert(anim.duration != 0);
+			assert(anim.ticksPerSecond != 0);
 
-			float animCurTicks = static_cast<float>(animCurSeconds * anim->mTicksPerSecond);
+			float animCurTicks = static_cast<float>(animCurSeconds * anim.ticksPerSecond);
 
 			//handle if current time is passed animation duration (doing this in seconds because of ease for timepoints
 			//float animDuration = static_cast<float>(anim->mTicksPerSecond * anim->mDuration);
-			float animDurationSecs = static_cast<float>(anim->mDuration / anim->mTicksPerSecond);
+			float animDurationSecs = static_cast<float>(anim.duration / anim.ticksPerSecond);
 			if (animCurSeconds > animDurationSecs)
 			{
 				if (inOut_AnimationData.bLoop)
@@ -119,17 +130,14 @@ namespace SA
 			}
 
 			//now that looping time points are complete, convert new time to ticks 
-			float animInTicks = static_cast<float>(animCurSeconds * anim->mTicksPerSecond);
+			float animInTicks = static_cast<float>(animCurSeconds * anim.ticksPerSecond);
 
-			//create a mapping of channel name to animation node for quick lookup; (animation node contains bone transform data)
-			std::map<std::string, aiNodeAnim*> nodeNameToChannel;
-			for (uint32_t channel = 0; channel < anim->mNumChannels; ++channel)
+			skeletalAnimator.evaluate(inOut_AnimationData.animId, animInTicks, inOut_AnimationData.cursor, nodeGlobalTransforms);
+			for (const std::pair<int32_t, Bone*>& nodeBone : animatedBones)
 			{
-				nodeNameToChannel[std::string(anim->mChannels[channel]->mNodeName.C_Str())] = anim->mChannels[channel];
+				Bone& bone = *nodeBone.second;
+				bone.finalAnimatedBoneTransform = inverseSceneTransform * nodeGlobalTransforms[nodeBone.first] * bone.meshToBoneTransform;
 			}
-
-			aiMatrix4x4 identity; //use aiMatrix internally to prevent tedious conversions
-			calculateAnimationTransforms(anim, animInTicks, cachedScene->mRootNode, identity, nodeNameToChannel);
 		}
 	}
 
@@ -150,158 +158,6 @@ namespace SA
 		}
 	}
 
-	void Model3D::calculateAnimationTransforms(
-		aiAnimation* anim, float animationTimeInTicks,
-		aiNode* node, const aiMatrix4x4& parentTransform, const std::map<std::string, aiNodeAnim*>& nodeNameToChannel)
-	{
-		aiMatrix4x4 nodeTransform;
-
-		std::string nodeName = std::string(node->mName.C_Str());
-		auto animNodePair = nodeNameToChannel.find(nodeName);
-		if (animNodePair != nodeNameToChannel.end())
-		{
-			aiNodeAnim* animNode = animNodePair->second;
-
-			aiMatrix4x4 translationMatrix = interpolatePositionKeys(animNode, animationTimeInTicks);
-			aiMatrix4x4 rotationMatrix = interpolateRotationKeys(animNode, animationTimeInTicks);
-			aiMatrix4x4 scaleMatrix = interpolateScaleKeys(animNode, animationTimeInTicks);
-
-			nodeTransform = translationMatrix * rotationMatrix * scaleMatrix;
-		}
-		else
-		{
-			//use default transform since this node assists structuring
-			nodeTransform = node->mTransformation;
-		}
-
-		aiMatrix4x4 nodeGlobalTransform = parentTransform * nodeTransform;
-		//aiMatrix4x4 nodeGlobalTransform = nodeTransform;
-
-		auto KV_NameBone = allBonesByName.find(nodeName);
-		if (KV_NameBone != allBonesByName.end())
-		{
-			Bone& bone = KV_NameBone->second;
-			const aiMatrix4x4& meshToBone = bone.meshToBoneTransform;
-			//bone.finalAnimatedBoneTransform = nodeGlobalTransform * meshToBone;
-			bone.finalAnimatedBoneTransform = inverseSceneTransform * nodeGlobalTransform * meshToBone;
-
-			//bone.finalAnimatedBoneTransform = inverseSceneTransform * nodeGlobalTransform;
-			//bone.finalAnimatedBoneTransform = nodeGlobalTransform * aiMatrix4x4(meshToBone).Inverse();
-			//bone.finalAnimatedBoneTransform = inverseSceneTransform * nodeGlobalTransform;
-		}
-
-		for (uint32_t chld = 0; chld < node->mNumChildren; ++chld)
-		{
-			calculateAnimationTransforms(anim, animationTimeInTicks, node->mChildren[chld], nodeGlobalTransform, nodeNameToChannel);
-		}
-	}
-
-	aiMatrix4x4 Model3D::interpolatePositionKeys(aiNodeAnim* animNode, float animationTimeInTicks)
-	{
-		if (animNode->mNumPositionKeys == 1)
-		{ //edge case where there is only 1 animation key, just directly convert the translation of the bone by taking first key
-			return toAiMat4(glm::translate(glm::mat4{ 1.0f }, toGlmVec3(animNode->mPositionKeys[0].mValue))); //slightly compressed, but just translates via GLM, then converts mat4 to aimat4. Real applications will probably just stick to 1 matrix library and not do these silly conversions
-		}
-
-		if (animNode->mNumPositionKeys > 0)
-		{
-			glm::uvec2 keyIdxs = searchForKeys(animNode->mPositionKeys, animNode->mNumPositionKeys, animationTimeInTicks);
-			uint32_t firstKey = keyIdxs.r, secondKey = keyIdxs.g;
-
-			double delta = animationTimeInTicks - animNode->mPositionKeys[firstKey].mTime;
-			double interkeyTime = animNode->mPositionKeys[secondKey].mTime - animNode->mPositionKeys[firstKey].mTime;
-			float interpAlpha = static_cast<float>(delta / interkeyTime);
-
-			glm::vec3 first = toGlmVec3(animNode->mPositionKeys[firstKey].mValue);
-			glm::vec3 second = toGlmVec3(animNode->mPositionKeys[secondKey].mValue);
-			glm::vec3 toSecond = second - first;
-			glm::vec3 interpolated = first + interpAlpha * toSecond;
-
-			glm::mat4 transMat;
-			transMat = glm::translate(transMat, interpolated);
-
-			return toAiMat4(transMat);
-		}
-
-		return aiMatrix4x4{}; //documentation says no-arg constructor creates an idenity matrix
-	}
-
-	static aiMatrix4x4 rotation3x3To4x4Helper(const aiMatrix3x3& src)
-	{
-		aiMatrix4x4 result; //this is an identity matrix, the last column and last row are (0,0,0,1), which is what we need for those places in the rotation matrix.
-
-		result.a1 = src.a1;
-		result.a2 = src.a2;
-		result.a3 = src.a3;
-
-		result.b1 = src.b1;
-		result.b2 = src.b2;
-		result.b3 = src.b3;
-
-		result.c1 = src.c1;
-		result.c2 = src.c2;
-		result.c3 = src.c3;
-
-		return result;
-	}
-
-	aiMatrix4x4 Model3D::interpolateRotationKeys(aiNodeAnim* animNode, float animationTimeInTicks)
-	{
-		if (animNode->mNumRotationKeys == 1)
-		{
-			return rotation3x3To4x4Helper(animNode->mRotationKeys[0].mValue.GetMatrix());
-		}
-		if (animNode->mNumRotationKeys > 0)
-		{
-
-			glm::uvec2 keyIdxs = searchForKeys(animNode->mRotationKeys, animNode->mNumRotationKeys, animationTimeInTicks);
-			uint32_t firstKey = keyIdxs.r, secondKey = keyIdxs.g;
-
-			double delta = animationTimeInTicks - animNode->mRotationKeys[firstKey].mTime;
-			double interkeyTime = animNode->mRotationKeys[secondKey].mTime - animNode->mRotationKeys[firstKey].mTime;
-			float interpAlpha = static_cast<float>(delta / interkeyTime);
-
-			aiQuaternion outInterpolatedQuat;
-			const aiQuaternion firstKeyQuat = animNode->mRotationKeys[firstKey].mValue;
-			const aiQuaternion secondKeyQuat = animNode->mRotationKeys[secondKey].mValue;
-			aiQuaternion::Interpolate(outInterpolatedQuat, firstKeyQuat, secondKeyQuat, interpAlpha);
-			//outInterpolatedQuat.Normalize();
-
-			aiMatrix3x3 itpMat3 = outInterpolatedQuat.GetMatrix();
-			return rotation3x3To4x4Helper(itpMat3);
-		}
-		return aiMatrix4x4{}; //return identity
-	}
-
-	aiMatrix4x4 Model3D::interpolateScaleKeys(aiNodeAnim* animNode, float animationTimeInTicks)
-	{
-		if (animNode->mNumScalingKeys == 1)
-		{
-			return toAiMat4(glm::scale(glm::mat4{ 1.0f }, toGlmVec3(animNode->mScalingKeys[0].mValue)));
-		}
-
-		if (animNode->mNumScalingKeys > 0)
-		{
-			glm::uvec2 keyIdxs = searchForKeys(animNode->mScalingKeys, animNode->mNumScalingKeys, animationTimeInTicks);
-			uint32_t firstKey = keyIdxs.r, secondKey = keyIdxs.g;
-
-			double delta = animationTimeInTicks - animNode->mScalingKeys[firstKey].mTime;
-			double interkeyTime = animNode->mScalingKeys[secondKey].mTime - animNode->mScalingKeys[firstKey].mTime;
-			float interpAlpha = static_cast<float>(delta / interkeyTime);
-
-			glm::vec3 first = toGlmVec3(animNode->mScalingKeys[firstKey].mValue);
-			glm::vec3 second = toGlmVec3(animNode->mScalingKeys[secondKey].mValue);
-			glm::vec3 toSecond = second - first;
-			glm::vec3 interpolated = first + interpAlpha * toSecond;
-
-			glm::mat4 scaleMat;
-			scaleMat = glm::scale(scaleMat, interpolated);
-
-			return toAiMat4(scaleMat);
-		}
-		return aiMatrix4x4{}; //idenity matrix
-	}
-
 	glm::vec3 Model3D::toGlmVec3(const aiVector3D& aiVec3)
 	{
 		return glm::vec3(aiVec3.x, aiVec3.y, aiVec3.z);
@@ -393,39 +249,30 @@ namespace SA
 
 	void Model3D::loadModel(std::string path)
 	{
-		//--------------------------------------------------------------------------------------------
-		//const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-		//const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals); //smooth normals required for bob model
-		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices); //smooth normals required for bob model, adding aiProcessJointIdenticavertices to better match tutorial
-		//--------------------------------------------------------------------------------------------
-
-		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		//first load imports with assimp and writes a baked cache next to the model; later loads read the cache
+		up<BakedModel> bakedModel = ModelBake::loadOrBake(path);
+		if (!bakedModel)
 		{
-			std::cerr << "Assimp: error importing model: ERROR::" << importer.GetErrorString() << std::endl;
 			throw std::runtime_error("failed to load required model");
 		}
 
-		directory = path.substr(0, path.find_last_of('/'));
-		this->cachedScene = scene;
-
-		this->inverseSceneTransform = scene->mRootNode->mTransformation;
-		this->inverseSceneTransform.Inverse();
-
-		processNode(scene->mRootNode, scene);
+		loadFromBaked(path, std::move(bakedModel));
 	}
 
-	void Model3D::processNode(aiNode* node, const aiScene* scene)
+	void Model3D::loadFromBaked(const std::string& path, up<BakedModel> bakedModel)
 	{
-		for (uint32_t i = 0; i < node->mNumMeshes; ++i)
-		{
-			aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-			meshes.push_back(processMesh(mesh, scene, node));
-		}
+		directory = path.substr(0, path.find_last_of('/'));
+
+		this->inverseSceneTransform = bakedModel->inverseSceneTransform;
+		skeletalAnimator.initialize(std::move(bakedModel->nodes), std::move(bakedModel->animations));
+		this->cachedAABB = std::make_tuple(bakedModel->aabbMin, bakedModel->aabbMax);
 
-		for (uint32_t i = 0; i < node->mNumChildren; ++i)
+		meshes.reserve(bakedModel->meshes.size());
+		for (BakedMesh& bakedMesh : bakedModel->meshes)
 		{
-			processNode(node->mChildren[i], scene);
+			meshes.push_back(processMesh(bakedMesh));
 		}
+		resolveAnimatedBones();
 	}
 
 	MaterialTexture generateDefaultNormalMapTextures()
@@ -441,226 +288,142 @@ namespace SA
 	}
 
 
-	Mesh3D Model3D::processMesh(aiMesh* mesh, const aiScene* scene, const aiNode* parentNode)
+	Mesh3D Model3D::processMesh(BakedMesh& bakedMesh)
 	{
-		std::vector<Vertex> vertices;
-		std::vector<uint32_t> indices;
 		std::vector<MaterialTexture> textures;
-		std::vector<NormalData> normalData;
-		std::vector<VertexBoneData> vertexBoneData;
-
-		for (uint32_t i = 0; i < mesh->mNumVertices; ++i)
+		bool bHasNormalMap = false;
+		for (const BakedTextureRef& textureRef : bakedMesh.textures)
 		{
-			Vertex vertex;
-			vertex.position.x = mesh->mVertices[i].x;
-			vertex.position.y = mesh->mVertices[i].y;
-			vertex.position.z = mesh->mVertices[i].z;
-			updateCachedAABB(vertex.position);
-
-			vertex.normal.x = mesh->mNormals[i].x;
-			vertex.normal.y = mesh->mNormals[i].y;
-			vertex.normal.z = mesh->mNormals[i].z;
-
-			//check if model has texture coordinates
-			if (mesh->mTextureCoords[0])
-			{
-				vertex.textureCoords.x = mesh->mTextureCoords[0][i].x;
-				vertex.textureCoords.y = mesh->mTextureCoords[0][i].y;
+			textures.push_back(loadMaterialTexture(textureRef));
+			bHasNormalMap |= textureRef.type == "texture_normalmap";
+		}
+		if (!bHasNormalMap)
+		{
+			textures.push_back(generateDefaultNormalMapTextures());
+		}
 
-			}
+		std::map<std::string, Bone> nameToBoneMap;
+		for (BakedBone& bakedBone : bakedMesh.bones)
+		{
+			//cache bone information
+			Bone cacheBone;
+			cacheBone.name = bakedBone.name;
+			cacheBone.meshToBoneTransform = bakedBone.meshToBoneTransform;
+			cacheBone.weights = std::move(bakedBone.weights);
+			cacheBone.uniqueID = bakedBone.uniqueID; //meshes sharing bones were given the same id when baked
+
+			//#todo: may need to switch these over the shared pointers since each data structure has its own copy of its bone
+			if (nameToBoneMap.find(cacheBone.name) == nameToBoneMap.end())
+				nameToBoneMap[cacheBone.name] = cacheBone;
 			else
-			{
-				vertex.textureCoords = { 0.f, 0.f };
-			}
-
-			NormalData nmData;
-			nmData.tangent.x = mesh->mTangents[i].x;
-			nmData.tangent.y = mesh->mTangents[i].y;
-			nmData.tangent.z = mesh->mTangents[i].z;
-			nmData.tangent = glm::normalize(nmData.tangent);
-
-			nmData.bitangent.x = mesh->mBitangents[i].x;
-			nmData.bitangent.y = mesh->mBitangents[i].y;
-			nmData.bitangent.z = mesh->mBitangents[i].z;
-			nmData.bitangent = glm::normalize(nmData.bitangent);
-
-			vertices.push_back(vertex);
-			normalData.push_back(nmData);
+				std::cerr << "duplicate bone " << cacheBone.name << " found when loading mesh" << std::endl;
 
-			//glm::vec3 calcNormal = glm::normalize(glm::cross(nmData.tangent, nmData.bitangent));
-			//float normalMatch = glm::dot(calcNormal, vertex.normal);
-			//std::cout << normalMatch << std::endl;
+			//globally cache bone
+			if (allBonesByName.find(cacheBone.name) == allBonesByName.end())
+				allBonesByName[cacheBone.name] = cacheBone; //there probably needs to be a different struct for the global bones, since data like "cachedWeights' is not relevant not accurate for all models; not sure but it seems meshToBone will be dependent upon mesh and cannot be used globally
+			else
+				std::cerr << "duplicate global bone " << cacheBone.name << " found when loading mesh" << std::endl;
+			markNodesForBone(cacheBone.name);
 		}
 
-		for (uint32_t i = 0; i < mesh->mNumFaces; ++i)
-		{
-			//loader forces faces to be triangles, so these indices should be valid for drawing triangles
-			const aiFace& face = mesh->mFaces[i];
-			for (uint32_t j = 0; j < face.mNumIndices; ++j)
-			{
-				indices.push_back(face.mIndices[j]);
-			}
-		}
+		return Mesh3D(bakedMesh.vertices, textures, bakedMesh.indices, bakedMesh.normalData, bakedMesh.vertexBoneData, nameToBoneMap);
+	}
 
-		if (mesh->mMaterialIndex >= 0)
+	MaterialTexture Model3D::loadMaterialTexture(const BakedTextureRef& textureRef)
+	{
+		for (uint32_t textureIdx = 0; textureIdx < texturesLoaded.size(); ++textureIdx)
 		{
-			aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-			std::vector<MaterialTexture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-			std::vector<MaterialTexture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-			std::vector<MaterialTexture> ambientMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_ambient");
-			std::vector<MaterialTexture> normalMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normalmap"); //aiTextureType seems to load normal maps from aiTextureType_HEIGHT, rather than aiTextureType_NORMAL
-			if (normalMaps.size() == 0) 
+			if (texturesLoaded[textureIdx].path == textureRef.relativePath)
 			{
-				normalMaps = { generateDefaultNormalMapTextures() };
+				//already loaded this texture, just the cached texture information
+				return texturesLoaded[textureIdx];
 			}
-
-			textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-			textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-			textures.insert(textures.end(), ambientMaps.begin(), ambientMaps.end());
-			textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
 		}
 
-		vertexBoneData.resize(vertices.size()); //default constructor all bone weights to 0
+		std::string filepath = directory + std::string("/") + textureRef.relativePath;
 
-		std::map<std::string, Bone> nameToBoneMap;
-		if (mesh->HasBones())
+		MaterialTexture texture;
+		texture.type = textureRef.type;
+		texture.path = textureRef.relativePath;
+		if (bAsyncTextures)
 		{
-			for (uint32_t boneIdx = 0; boneIdx < mesh->mNumBones; ++boneIdx)
+			//file read and decode happen on the asset workers; the id is filled in by bindLoadedTextures
+			AsyncAssetHandle<TextureAsset> textureHandle = GameBase::get().getAssetSystem().loadTextureAsync(filepath);
+			if (sp<TextureAsset> loadedTexture = textureHandle.getAsset())
 			{
-				aiBone* bone = mesh->mBones[boneIdx];
-
-				//cache bone information
-				Bone cacheBone;
-				cacheBone.name = bone->mName.C_Str();
-				cacheBone.meshToBoneTransform = bone->mOffsetMatrix;
-				cacheBone.weights.resize(0);
-				cacheBone.weights.reserve(bone->mNumWeights);
-				//cacheBone.uniqueID = static_cast<int>(allBones.size());
-				cacheBone.uniqueID = static_cast<int>(allBonesByName.size());
-				//meshes sharing bones need correct ids
-				if (allBonesByName.find(cacheBone.name) != allBonesByName.end())
-					cacheBone.uniqueID = allBonesByName[cacheBone.name].uniqueID;
-
-				for (uint32_t wgt = 0; wgt < bone->mNumWeights; ++wgt)
-				{
-					cacheBone.weights.push_back(bone->mWeights[wgt]);
-
-					uint32_t vertId = bone->mWeights[wgt].mVertexId;
-					int curBone = vertexBoneData[vertId].currentBone;
-
-					assert(curBone != MAX_NUM_BONES); //assert if we're about to go out of bounds
-
-					//to vertex data, add an influencing bone and its weight; these will be used to lookup into bone transforms array
-					vertexBoneData[vertId].boneWeights[curBone] = bone->mWeights[wgt].mWeight;
-					vertexBoneData[vertId].boneIds[curBone] = cacheBone.uniqueID;
-					vertexBoneData[vertId].currentBone++;
-				}
-
-				//#todo: may need to switch these over the shared pointers since each data structure has its own copy of its bone
-				if (nameToBoneMap.find(cacheBone.name) == nameToBoneMap.end())
-					nameToBoneMap[cacheBone.name] = cacheBone;
-				else
-					std::cerr << "duplicate bone " << cacheBone.name << " found when loading mesh" << std::endl;
-
-				//globally cache bone
-				if (allBonesByName.find(cacheBone.name) == allBonesByName.end())
-					allBonesByName[cacheBone.name] = cacheBone; //there probably needs to be a different struct for the global bones, since data like "cachedWeights' is not relevant not accurate for all models; not sure but it seems meshToBone will be dependent upon mesh and cannot be used globally
-				else
-					std::cerr << "duplicate global bone " << cacheBone.name << " found when loading mesh" << std::endl;
-				//allBones.push_back(cacheBone);
-				markNodesForBone(cacheBone.name);
+				texture.id = loadedTexture->textureId;
 			}
+			else
+			{
+				texture.id = 0;
+				pendingTextures.push_back(PendingMaterialTexture{ textureHandle, texturesLoaded.size() });
+			}
+		}
+		else
+		{
+			texture.id = Utils::loadTextureToOpengl(filepath.c_str());
 		}
 
-		return Mesh3D(vertices, textures, indices, normalData, vertexBoneData, nameToBoneMap);
+		//cache for later texture loads
+		texturesLoaded.push_back(texture);
+		return texture;
 	}
 
-	std::vector<MaterialTexture> Model3D::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName)
+	bool Model3D::bindLoadedTextures()
 	{
-		std::vector<MaterialTexture> textures;
-
-		uint32_t textureCount = mat->GetTextureCount(type);
-		for (uint32_t i = 0; i < textureCount; i++)
+		for (size_t pendingIdx = 0; pendingIdx < pendingTextures.size();)
 		{
-			aiString str;
-			mat->GetTexture(type, i, &str);
-			std::string relativePath = std::string(str.C_Str());
-
-			std::string filepath = directory + std::string("/") + relativePath;
+			PendingMaterialTexture& pending = pendingTextures[pendingIdx];
+			if (pending.handle.isLoading())
+			{
+				++pendingIdx;
+				continue;
+			}
 
-			bool bShouldSkip = false;
-			for (uint32_t textureIdx = 0; textureIdx < texturesLoaded.size(); ++textureIdx)
+			if (sp<TextureAsset> loadedTexture = pending.handle.getAsset())
 			{
-				if (texturesLoaded[textureIdx].path == relativePath)
+				MaterialTexture& texture = texturesLoaded[pending.textureIdx];
+				texture.id = loadedTexture->textureId;
+				for (Mesh3D& mesh : meshes)
 				{
-					//already loaded this texture, just the cached texture information
-					textures.push_back(texturesLoaded[textureIdx]);
-					bShouldSkip = true;
-					break;
+					mesh.setTextureId(texture.path, texture.id);
 				}
 			}
-
-			if (!bShouldSkip)
+			else
 			{
-				MaterialTexture texture;
-				texture.id = Utils::loadTextureToOpengl(filepath.c_str());
-				texture.type = typeName;
-				texture.path = relativePath;
-				textures.push_back(texture);
-
-				//cache for later texture loads
-				texturesLoaded.push_back(texture);
+				std::cerr << "failed to load model texture " << pending.handle.getPath() << std::endl;
 			}
-		}
-		return textures;
-	}
-
-	void Model3D::updateCachedAABB(const glm::vec3& vertexPosition)
-	{
-		glm::vec3& min = std::get<0>(cachedAABB);
-		glm::vec3& max = std::get<1>(cachedAABB);
-
-		if (min.x > vertexPosition.x) min.x = vertexPosition.x;
-		if (min.y > vertexPosition.y) min.y = vertexPosition.y;
-		if (min.z > vertexPosition.z) min.z = vertexPosition.z;
 
-		if (max.x < vertexPosition.x) max.x = vertexPosition.x;
-		if (max.y < vertexPosition.y) max.y = vertexPosition.y;
-		if (max.z < vertexPosition.z) max.z = vertexPosition.z;
+			pendingTextures[pendingIdx] = std::move(pendingTextures.back());
+			pendingTextures.pop_back();
+		}
+		return pendingTextures.empty();
 	}
 
 	void Model3D::markNodesForBone(const std::string& boneName)
 	{
 		//this can probably be optimized, instead do a single walk over the entire graph of the model when each node is arived, check data structure for referencing bone
-		aiNode* node = findNamedNode(boneName.c_str(), cachedScene->mRootNode);
+		int32_t nodeIdx = skeletalAnimator.findNode(boneName.c_str());
 
 		//assimp documentation recommends stopping once we reach the node for the owning mesh, but i'm not sure that things are properly managed to start animation updates from mesh nodes so I'm deferring siad check for now; if I add this later, said node should be available at this function's callsite
-		while (node && node != cachedScene->mRootNode) //root node should never be null
+		while (nodeIdx > 0) //root node is index 0
 		{
-			skeletonRelevantNode.insert(node);
-			node = node->mParent;
+			skeletonRelevantNode.insert(nodeIdx);
+			nodeIdx = skeletalAnimator.getNodes()[nodeIdx].parentIdx;
 		}
 	}
 
-	aiNode* Model3D::findNamedNode(const char* name, aiNode* startNode)
+	void Model3D::resolveAnimatedBones()
 	{
-		/** Essentially BFS to find a named node; bones/animations should have unique names according to assimp documentation */
-		if (strcmp(startNode->mName.C_Str(), name) == 0)
-		{
-			return startNode;
-		}
-
-		for (uint32_t child = 0; child < startNode->mNumChildren; ++child)
+		//animation updates write bones directly rather than looking every node up by name each frame
+		animatedBones.clear();
+		for (std::pair<const std::string, Bone>& KVPair : allBonesByName)
 		{
-			if (aiNode* namedNode = findNamedNode(name, startNode->mChildren[child]))
+			int32_t nodeIdx = skeletalAnimator.findNode(KVPair.first.c_str());
+			if (nodeIdx >= 0)
 			{
-				return namedNode;
+				animatedBones.emplace_back(nodeIdx, &KVPair.second);
 			}
 		}
-		return nullptr;
 	}
-
-
-
-}
\ No newline at end of file
+}
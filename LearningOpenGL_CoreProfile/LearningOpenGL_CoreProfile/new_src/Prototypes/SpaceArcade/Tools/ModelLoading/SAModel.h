@@ -12,9 +12,13 @@
 #include <chrono>
 #include "..\..\Rendering\SAShader.h"
 #include "SAMesh.h"
+#include "SABakedModel.h"
+#include "SASkeletalAnimator.h"
+#include "../../GameFramework/AssetManagement/AsyncAssetLoader.h"
 
 namespace SA
 {
+	struct TextureAsset;
 
 	/** This probably isn't the ideal system for animations, but more a first pass to get interpolation working */
 	struct AnimationData
@@ -22,6 +26,7 @@ namespace SA
 		uint32_t animId = 0;
 		bool bLoop = true;
 		std::chrono::time_point<std::chrono::system_clock> startTime; //this value will change if looping is enabled
+		AnimationCursor cursor; //where this instance is in each channel's keys
 	};
 
 	class Model3D
@@ -30,6 +35,9 @@ namespace SA
 	public:
 
 		Model3D(const char* path);
+		/** Builds from data produced by ModelBake::loadOrBake; lets the file loading happen off the game thread.
+			Material textures are loaded through the asset system's async texture queue and bound as they resolve. */
+		Model3D(const char* path, up<BakedModel> bakedModel);
 		~Model3D();
 		void draw(Shader& shader, bool bBindMaterials = true) const;
 		void drawInstanced(Shader& shader, uint32_t instanceCount, bool bBindMaterials = true) const;
@@ -40,6 +48,8 @@ namespace SA
 		void prepareAnimationsForData(AnimationData& animationData);
 		void sendBoneTransformsToShader(Shader& shader, const char* uniformMat4ArrayName);
 		AnimationData startAnimation(uint32_t animationID, bool bLoop);
+		/** Trades a little accuracy between keys for evaluation cost that doesn't depend on key counts; 0 goes back to sampling keys directly. */
+		void setAnimationSampleRate(float samplesPerSecond) { skeletalAnimator.bakeSamples(samplesPerSecond); }
 
 		//helper conversions
 		static glm::vec3 toGlmVec3(const aiVector3D& aiVec3);
@@ -56,84 +66,47 @@ namespace SA
 	private://model/mesh methods
 
 		void loadModel(std::string path);
+		void loadFromBaked(const std::string& path, up<BakedModel> bakedModel);
 
-		void processNode(aiNode* node, const aiScene* scene);
-		Mesh3D processMesh(aiMesh* mesh, const aiScene* scene, const aiNode* parentNode);
+		Mesh3D processMesh(BakedMesh& bakedMesh);
 
-		std::vector<MaterialTexture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+		MaterialTexture loadMaterialTexture(const BakedTextureRef& textureRef);
+
+		/** gives meshes the ids of async textures that have finished uploading; returns true once none are pending */
+		bool bindLoadedTextures();
 
 	private: 
 		void releaseGPUData();
-		void updateCachedAABB(const glm::vec3& vertexPosition);
 
 	private: //bone methods
 		void markNodesForBone(const std::string& boneName);
-		aiNode* findNamedNode(const char* name, aiNode* startNode);
-		void calculateAnimationTransforms(aiAnimation* anim, float animationTimeInTicks, aiNode* node, const aiMatrix4x4& parentTransform, const std::map<std::string, aiNodeAnim*>& nodeNameToChannel);
-
-		template<typename KEY_TYPE> //there are vector keys and quaternion keys, code is the same for both
-		glm::uvec2 searchForKeys(KEY_TYPE* keys, uint32_t numKeys, float animationTimeInSec);
-
-		aiMatrix4x4 interpolatePositionKeys(aiNodeAnim* animNode, float animationTimeInTicks);
-		aiMatrix4x4 interpolateRotationKeys(aiNodeAnim* animNode, float animationTimeInTicks);
-		aiMatrix4x4 interpolateScaleKeys(aiNodeAnim* animNode, float animationTimeInTicks);
+		void resolveAnimatedBones();
 
 	private: //members
 		std::string directory;
 		bool bGPUReleased = false;
 		std::vector<Mesh3D> meshes;
 		std::vector<MaterialTexture> texturesLoaded;
+
+		/** material textures still being decoded; their meshes bind no texture until they resolve */
+		struct PendingMaterialTexture
+		{
+			AsyncAssetHandle<TextureAsset> handle;
+			size_t textureIdx; //into texturesLoaded
+		};
+		bool bAsyncTextures = false;
+		std::vector<PendingMaterialTexture> pendingTextures;
 		std::map<std::string, Bone> allBonesByName;
 
 
-		/** This dtor will clean up graphs loaded; thus, this is a member variable to make lifetime of assimp graphs the same as the instance of this object.*/
-		Assimp::Importer importer;
-		std::set<aiNode*> skeletonRelevantNode;		//memory managed by importer
-		const aiScene* cachedScene;					//memory managed by importer
+		/** scene graph and animations are kept from the baked model; mesh data is released once uploaded */
+		SkeletalAnimator skeletalAnimator;
+		std::vector<std::pair<int32_t, Bone*>> animatedBones;	//node index driving each bone; pointers into allBonesByName, which never moves its values
+		std::vector<aiMatrix4x4> nodeGlobalTransforms;			//scratch for animation updates, indexed like the animator's nodes
+		std::set<int32_t> skeletonRelevantNode;					//indices into the animator's nodes
 		aiMatrix4x4 inverseSceneTransform;
 
 		std::tuple<glm::vec3, glm::vec3> cachedAABB;
 	};
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-	// --------------- template definitions --------------------
-	template<typename KEY_TYPE> //there are vector keys and quaternion keys, code is the same for both
-	glm::uvec2 Model3D::searchForKeys(KEY_TYPE* keys, uint32_t numKeys, float animationTimeInTicks)
-	{
-		if (numKeys == 1)
-		{
-			return glm::uvec2(0, 0);
-		}
-
-		//in real applications we probably want a way to speed up this us so that we don't have to search all frames.
-		//perhaps binary search on time, or subdivide all animations into ticks based on animations total time with correct frames for given tick
-		for (uint32_t animKey = 0; animKey < numKeys; ++animKey)
-		{
-			bool bCurrKeyBeforeTime = keys[animKey].mTime <= animationTimeInTicks; //<= to catch edge case of animation time: 0.0f
-			bool bNextKeyAfterTime = keys[animKey + 1].mTime >= animationTimeInTicks; //>= to cover edge case where time is exactly the last frame
-			if (bCurrKeyBeforeTime && bNextKeyAfterTime)
-			{
-				return glm::uvec2(animKey, animKey + 1);
-			}
-		}
-
-		assert(0); //we should never "not find" a pair of keys 	
-		throw std::runtime_error("Model::searchForKeys did not find keys in animation");
-	}
-
 }
\ No newline at end of file
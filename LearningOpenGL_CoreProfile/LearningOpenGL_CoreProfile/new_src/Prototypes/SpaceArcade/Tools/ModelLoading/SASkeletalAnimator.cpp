@@ -0,0 +1,271 @@
+#include "SASkeletalAnimator.h"
+#include <cmath>
+#include <cstring>
+#include <cassert>
+
+namespace SA
+{
+	static glm::vec3 toGlmVec3(const aiVector3D& aiVec3)
+	{
+		return glm::vec3(aiVec3.x, aiVec3.y, aiVec3.z);
+	}
+
+	/** keeps the interpolation arithmetic identical to what Model3D did before keys were found by search */
+	template<typename KEY_TYPE>
+	static float interpolationAlpha(const KEY_TYPE& firstKey, const KEY_TYPE& secondKey, float animationTimeInTicks)
+	{
+		double delta = animationTimeInTicks - firstKey.mTime;
+		double interkeyTime = secondKey.mTime - firstKey.mTime;
+		float interpAlpha = static_cast<float>(delta / interkeyTime);
+
+		//times outside of the keys hold the first/last key rather than extrapolating
+		interpAlpha = interpAlpha < 0.f ? 0.f : interpAlpha;
+		interpAlpha = interpAlpha > 1.f ? 1.f : interpAlpha;
+		return interpAlpha;
+	}
+
+	static aiVector3D lerpVectorKeys(const std::vector<aiVectorKey>& keys, float animationTimeInTicks, uint32_t& inOut_cursor, const aiVector3D& defaultValue)
+	{
+		if (keys.size() == 1)
+		{
+			return keys[0].mValue;
+		}
+		if (keys.size() > 0)
+		{
+			glm::uvec2 keyIdxs = SkeletalAnimator::findKeys(keys.data(), uint32_t(keys.size()), animationTimeInTicks, inOut_cursor);
+			const aiVectorKey& firstKey = keys[keyIdxs.r];
+			const aiVectorKey& secondKey = keys[keyIdxs.g];
+			float interpAlpha = interpolationAlpha(firstKey, secondKey, animationTimeInTicks);
+
+			glm::vec3 first = toGlmVec3(firstKey.mValue);
+			glm::vec3 second = toGlmVec3(secondKey.mValue);
+			glm::vec3 toSecond = second - first;
+			glm::vec3 interpolated = first + interpAlpha * toSecond;
+			return aiVector3D(interpolated.x, interpolated.y, interpolated.z);
+		}
+		return defaultValue;
+	}
+
+	void SkeletalAnimator::initialize(std::vector<BakedNode> inNodes, std::vector<BakedAnimation> inAnimations)
+	{
+		nodes = std::move(inNodes);
+		animations = std::move(inAnimations);
+
+		//resolve which channel drives each node once, rather than matching names every frame
+		resolvedAnimations.clear();
+		resolvedAnimations.resize(animations.size());
+		for (size_t animIdx = 0; animIdx < animations.size(); ++animIdx)
+		{
+			const BakedAnimation& anim = animations[animIdx];
+			ResolvedAnimation& resolved = resolvedAnimations[animIdx];
+			resolved.channelForNode.assign(nodes.size(), -1);
+
+			for (size_t channelIdx = 0; channelIdx < anim.channels.size(); ++channelIdx)
+			{
+				int32_t nodeIdx = findNode(anim.channels[channelIdx].nodeName.c_str());
+				if (nodeIdx >= 0)
+				{
+					//the name lookup this replaces kept the last channel for a name, so later channels win here too
+					resolved.channelForNode[nodeIdx] = int32_t(channelIdx);
+				}
+			}
+		}
+
+		if (hasSamples())
+		{
+			bakeSamples(samplesPerSecond);
+		}
+	}
+
+	int32_t SkeletalAnimator::findNode(const char* name) const
+	{
+		/** nodes are flattened depth first, so a linear scan finds the same node the recursive search did; bones/animations should have unique names according to assimp documentation */
+		for (size_t nodeIdx = 0; nodeIdx < nodes.size(); ++nodeIdx)
+		{
+			if (strcmp(nodes[nodeIdx].name.c_str(), name) == 0)
+			{
+				return int32_t(nodeIdx);
+			}
+		}
+		return -1;
+	}
+
+	void SkeletalAnimator::evaluate(uint32_t animId, float animationTimeInTicks, AnimationCursor& cursor, std::vector<aiMatrix4x4>& outNodeGlobalTransforms) const
+	{
+		assert(animId < animations.size());
+		const BakedAnimation& anim = animations[animId];
+		const ResolvedAnimation& resolved = resolvedAnimations[animId];
+
+		if (cursor.animId != animId || cursor.keyCursors.size() != anim.channels.size() * 3)
+		{
+			cursor.animId = animId;
+			cursor.keyCursors.assign(anim.channels.size() * 3, 0);
+		}
+
+		//nodes are stored parent-before-child, so every parent's global transform is ready before its children need it
+		outNodeGlobalTransforms.resize(nodes.size());
+		for (size_t nodeIdx = 0; nodeIdx < nodes.size(); ++nodeIdx)
+		{
+			const BakedNode& node = nodes[nodeIdx];
+			const int32_t channelIdx = resolved.channelForNode[nodeIdx];
+
+			aiMatrix4x4 nodeTransform;
+			if (channelIdx < 0)
+			{
+				//use default transform since this node assists structuring
+				nodeTransform = node.transform;
+			}
+			else if (resolved.numSamples > 0)
+			{
+				nodeTransform = evaluateSampledChannel(resolved, size_t(channelIdx), animationTimeInTicks);
+			}
+			else
+			{
+				nodeTransform = evaluateChannel(anim.channels[channelIdx], animationTimeInTicks, &cursor.keyCursors[channelIdx * 3]);
+			}
+
+			if (node.parentIdx >= 0)
+			{
+				outNodeGlobalTransforms[nodeIdx] = outNodeGlobalTransforms[node.parentIdx] * nodeTransform;
+			}
+			else
+			{
+				outNodeGlobalTransforms[nodeIdx] = nodeTransform;
+			}
+		}
+	}
+
+	aiMatrix4x4 SkeletalAnimator::evaluateChannel(const BakedChannel& channel, float animationTimeInTicks, uint32_t* inOut_keyCursors)
+	{
+		//components without keys contribute an identity matrix, as they did before
+		aiVector3D position = interpolatePosition(channel, animationTimeInTicks, inOut_keyCursors[0]);
+		aiQuaternion rotation = interpolateRotation(channel, animationTimeInTicks, inOut_keyCursors[1]);
+		aiVector3D scale = interpolateScale(channel, animationTimeInTicks, inOut_keyCursors[2]);
+
+		return composeTransform(
+			channel.positionKeys.size() > 0 ? &position : nullptr,
+			channel.rotationKeys.size() > 0 ? &rotation : nullptr,
+			channel.scalingKeys.size() > 0 ? &scale : nullptr
+		);
+	}
+
+	aiVector3D SkeletalAnimator::interpolatePosition(const BakedChannel& channel, float animationTimeInTicks, uint32_t& inOut_cursor)
+	{
+		return lerpVectorKeys(channel.positionKeys, animationTimeInTicks, inOut_cursor, aiVector3D(0.f, 0.f, 0.f));
+	}
+
+	aiVector3D SkeletalAnimator::interpolateScale(const BakedChannel& channel, float animationTimeInTicks, uint32_t& inOut_cursor)
+	{
+		return lerpVectorKeys(channel.scalingKeys, animationTimeInTicks, inOut_cursor, aiVector3D(1.f, 1.f, 1.f));
+	}
+
+	aiQuaternion SkeletalAnimator::interpolateRotation(const BakedChannel& channel, float animationTimeInTicks, uint32_t& inOut_cursor)
+	{
+		const std::vector<aiQuatKey>& keys = channel.rotationKeys;
+		if (keys.size() == 1)
+		{
+			return keys[0].mValue;
+		}
+		if (keys.size() > 0)
+		{
+			glm::uvec2 keyIdxs = findKeys(keys.data(), uint32_t(keys.size()), animationTimeInTicks, inOut_cursor);
+			const aiQuatKey& firstKey = keys[keyIdxs.r];
+			const aiQuatKey& secondKey = keys[keyIdxs.g];
+			float interpAlpha = interpolationAlpha(firstKey, secondKey, animationTimeInTicks);
+
+			aiQuaternion outInterpolatedQuat;
+			aiQuaternion::Interpolate(outInterpolatedQuat, firstKey.mValue, secondKey.mValue, interpAlpha);
+			return outInterpolatedQuat;
+		}
+		return aiQuaternion{}; //identity
+	}
+
+	aiMatrix4x4 SkeletalAnimator::composeTransform(const aiVector3D* position, const aiQuaternion* rotation, const aiVector3D* scale)
+	{
+		aiMatrix4x4 translationMatrix;
+		if (position)
+		{
+			aiMatrix4x4::Translation(*position, translationMatrix);
+		}
+
+		aiMatrix4x4 rotationMatrix; //identity, so the last column and last row are already (0,0,0,1)
+		if (rotation)
+		{
+			const aiMatrix3x3 rotation3x3 = rotation->GetMatrix();
+			rotationMatrix.a1 = rotation3x3.a1; rotationMatrix.a2 = rotation3x3.a2; rotationMatrix.a3 = rotation3x3.a3;
+			rotationMatrix.b1 = rotation3x3.b1; rotationMatrix.b2 = rotation3x3.b2; rotationMatrix.b3 = rotation3x3.b3;
+			rotationMatrix.c1 = rotation3x3.c1; rotationMatrix.c2 = rotation3x3.c2; rotationMatrix.c3 = rotation3x3.c3;
+		}
+
+		aiMatrix4x4 scaleMatrix;
+		if (scale)
+		{
+			aiMatrix4x4::Scaling(*scale, scaleMatrix);
+		}
+
+		return translationMatrix * rotationMatrix * scaleMatrix;
+	}
+
+	void SkeletalAnimator::bakeSamples(float inSamplesPerSecond)
+	{
+		samplesPerSecond = inSamplesPerSecond > 0.f ? inSamplesPerSecond : 0.f;
+
+		for (size_t animIdx = 0; animIdx < animations.size(); ++animIdx)
+		{
+			const BakedAnimation& anim = animations[animIdx];
+			ResolvedAnimation& resolved = resolvedAnimations[animIdx];
+			resolved.samples.clear();
+			resolved.numSamples = 0;
+			resolved.ticksPerSample = 0.f;
+
+			if (!hasSamples() || anim.duration <= 0.0 || anim.ticksPerSecond <= 0.0)
+			{
+				continue;
+			}
+
+			//stretch the interval slightly so the last sample lands exactly on the end of the animation
+			const double durationSecs = anim.duration / anim.ticksPerSecond;
+			const uint32_t numIntervals = std::max<uint32_t>(1, uint32_t(std::ceil(durationSecs * samplesPerSecond)));
+			resolved.numSamples = numIntervals + 1;
+			resolved.ticksPerSample = static_cast<float>(anim.duration / numIntervals);
+
+			resolved.samples.resize(anim.channels.size() * resolved.numSamples);
+			for (size_t channelIdx = 0; channelIdx < anim.channels.size(); ++channelIdx)
+			{
+				const BakedChannel& channel = anim.channels[channelIdx];
+				uint32_t keyCursors[3] = { 0, 0, 0 };
+				ChannelSample* channelSamples = &resolved.samples[channelIdx * resolved.numSamples];
+
+				for (uint32_t sampleIdx = 0; sampleIdx < resolved.numSamples; ++sampleIdx)
+				{
+					const float sampleTime = static_cast<float>(anim.duration * sampleIdx / numIntervals);
+					channelSamples[sampleIdx].position = interpolatePosition(channel, sampleTime, keyCursors[0]);
+					channelSamples[sampleIdx].rotation = interpolateRotation(channel, sampleTime, keyCursors[1]);
+					channelSamples[sampleIdx].scale = interpolateScale(channel, sampleTime, keyCursors[2]);
+				}
+			}
+		}
+	}
+
+	aiMatrix4x4 SkeletalAnimator::evaluateSampledChannel(const ResolvedAnimation& resolved, size_t channelIdx, float animationTimeInTicks) const
+	{
+		const ChannelSample* channelSamples = &resolved.samples[channelIdx * resolved.numSamples];
+
+		float samplePosition = animationTimeInTicks / resolved.ticksPerSample;
+		samplePosition = samplePosition < 0.f ? 0.f : samplePosition;
+		uint32_t firstSample = std::min(uint32_t(samplePosition), resolved.numSamples - 1);
+		uint32_t secondSample = std::min(firstSample + 1, resolved.numSamples - 1);
+		float interpAlpha = std::min(samplePosition - float(firstSample), 1.f);
+
+		const ChannelSample& first = channelSamples[firstSample];
+		const ChannelSample& second = channelSamples[secondSample];
+
+		aiVector3D position = first.position + interpAlpha * (second.position - first.position);
+		aiVector3D scale = first.scale + interpAlpha * (second.scale - first.scale);
+		aiQuaternion rotation;
+		aiQuaternion::Interpolate(rotation, first.rotation, second.rotation, interpAlpha);
+
+		//components without keys were sampled as their identity values, so composing them is harmless
+		return composeTransform(&position, &rotation, &scale);
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+
+#include <glm.hpp>
+#include "SABakedModel.h"
+
+namespace SA
+{
+	/** Per playing instance; remembers which keys each channel used last frame so the next frame usually finds its keys without searching. */
+	struct AnimationCursor
+	{
+		uint32_t animId = std::numeric_limits<uint32_t>::max();
+		std::vector<uint32_t> keyCursors; //3 per channel: position, rotation, scaling
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Evaluates baked skeletal animations.
+	//
+	// Nodes are stored parent-before-child, so the whole hierarchy is updated in one linear pass. Which channel
+	// drives each node is resolved once at initialization rather than looked up by name every frame. Keys are
+	// found from the per-instance cursor (usually the same or next key pair as last frame) and otherwise by
+	// binary search. Optionally every channel can be pre-sampled at a fixed rate, in which case evaluation is a
+	// lerp/slerp between two samples regardless of how many keys the source animation has.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class SkeletalAnimator
+	{
+	public:
+		void initialize(std::vector<BakedNode> nodes, std::vector<BakedAnimation> animations);
+
+		/** Computes the global (model space) transform of every node, indexed like getNodes(). */
+		void evaluate(uint32_t animId, float animationTimeInTicks, AnimationCursor& cursor, std::vector<aiMatrix4x4>& outNodeGlobalTransforms) const;
+
+		/** Pre-samples every animation; samplesPerSecond is in animation seconds. Passing 0 removes the samples. */
+		void bakeSamples(float samplesPerSecond);
+		bool hasSamples() const { return samplesPerSecond > 0.f; }
+
+		size_t getNumAnimations() const { return animations.size(); }
+		const BakedAnimation& getAnimation(uint32_t animId) const { return animations[animId]; }
+		const std::vector<BakedNode>& getNodes() const { return nodes; }
+		int32_t findNode(const char* name) const;
+
+		/** Returns the pair of keys surrounding time; the same pair the original linear scan picked. inOut_cursor is the first key of the last pair found. */
+		template<typename KEY_TYPE>
+		static glm::uvec2 findKeys(const KEY_TYPE* keys, uint32_t numKeys, float animationTimeInTicks, uint32_t& inOut_cursor);
+
+		/** Local transform of a node driven by channel, from its keys. */
+		static aiMatrix4x4 evaluateChannel(const BakedChannel& channel, float animationTimeInTicks, uint32_t* inOut_keyCursors);
+
+	private:
+		struct ChannelSample
+		{
+			aiVector3D position;
+			aiQuaternion rotation;
+			aiVector3D scale;
+		};
+
+		struct ResolvedAnimation
+		{
+			std::vector<int32_t> channelForNode;	//-1 for nodes that keep their bind transform
+			float ticksPerSample = 0.f;
+			uint32_t numSamples = 0;
+			std::vector<ChannelSample> samples;		//numSamples per channel, channel major
+		};
+
+		static aiVector3D interpolatePosition(const BakedChannel& channel, float animationTimeInTicks, uint32_t& inOut_cursor);
+		static aiQuaternion interpolateRotation(const BakedChannel& channel, float animationTimeInTicks, uint32_t& inOut_cursor);
+		static aiVector3D interpolateScale(const BakedChannel& channel, float animationTimeInTicks, uint32_t& inOut_cursor);
+		static aiMatrix4x4 composeTransform(const aiVector3D* position, const aiQuaternion* rotation, const aiVector3D* scale);
+
+		aiMatrix4x4 evaluateSampledChannel(const ResolvedAnimation& resolved, size_t channelIdx, float animationTimeInTicks) const;
+
+	private:
+		std::vector<BakedNode> nodes;
+		std::vector<BakedAnimation> animations;
+		std::vector<ResolvedAnimation> resolvedAnimations;
+		float samplesPerSecond = 0.f;
+	};
+
+	// --------------- template definitions --------------------
+	template<typename KEY_TYPE>
+	glm::uvec2 SkeletalAnimator::findKeys(const KEY_TYPE* keys, uint32_t numKeys, float animationTimeInTicks, uint32_t& inOut_cursor)
+	{
+		if (numKeys < 2)
+		{
+			return glm::uvec2(0, 0);
+		}
+
+		//the pair starting at k surrounds time when keys[k] < time <= keys[k+1]; the first pair also accepts time <= keys[0]
+		const uint32_t lastPair = numKeys - 2;
+		auto pairSurroundsTime = [&](uint32_t k)
+		{
+			return (k == 0 || keys[k].mTime < animationTimeInTicks) && (keys[k + 1].mTime >= animationTimeInTicks || k == lastPair);
+		};
+
+		//animations mostly move forward a little each frame, so try the previous pair and the one after it first
+		uint32_t cursor = std::min(inOut_cursor, lastPair);
+		if (pairSurroundsTime(cursor))
+		{
+			inOut_cursor = cursor;
+			return glm::uvec2(cursor, cursor + 1);
+		}
+		if (cursor < lastPair && pairSurroundsTime(cursor + 1))
+		{
+			inOut_cursor = cursor + 1;
+			return glm::uvec2(cursor + 1, cursor + 2);
+		}
+
+		//first key at or after time; the pair starts one before it
+		const KEY_TYPE* firstNotBefore = std::lower_bound(keys, keys + numKeys, animationTimeInTicks,
+			[](const KEY_TYPE& key, float time) { return key.mTime < time; });
+		uint32_t pairStart = uint32_t(firstNotBefore - keys);
+		pairStart = pairStart > 0 ? pairStart - 1 : 0;
+		pairStart = std::min(pairStart, lastPair);
+
+		inOut_cursor = pairStart;
+		return glm::uvec2(pairStart, pairStart + 1);
+	}
+}
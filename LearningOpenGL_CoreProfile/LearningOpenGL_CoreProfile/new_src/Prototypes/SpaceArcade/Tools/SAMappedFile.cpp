@@ -0,0 +1,125 @@
+#include "SAMappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace SA
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& filepath)
+	{
+		close();
+
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		fileHandle = file;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			close();
+			return false;
+		}
+		mappingHandle = mapping;
+
+		data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!data)
+		{
+			close();
+			return false;
+		}
+		size = size_t(fileSize.QuadPart);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (data)
+		{
+			UnmapViewOfFile(data);
+			data = nullptr;
+		}
+		if (mappingHandle)
+		{
+			CloseHandle(mappingHandle);
+			mappingHandle = nullptr;
+		}
+		if (fileHandle)
+		{
+			CloseHandle(fileHandle);
+			fileHandle = nullptr;
+		}
+		size = 0;
+	}
+#else
+	bool MappedFile::open(const std::string& filepath)
+	{
+		close();
+
+		fileDescriptor = ::open(filepath.c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStats;
+		if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+		{
+			close();
+			return false;
+		}
+
+		void* mapped = mmap(nullptr, size_t(fileStats.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (mapped == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+		data = static_cast<const uint8_t*>(mapped);
+		size = size_t(fileStats.st_size);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (data)
+		{
+			munmap(const_cast<uint8_t*>(data), size);
+			data = nullptr;
+		}
+		if (fileDescriptor >= 0)
+		{
+			::close(fileDescriptor);
+			fileDescriptor = -1;
+		}
+		size = 0;
+	}
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Read-only memory mapping of a whole file. The mapping lives as long as the object.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class MappedFile : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		bool open(const std::string& filepath);
+		void close();
+
+		bool isOpen() const { return data != nullptr; }
+		const uint8_t* getData() const { return data; }
+		size_t getSize() const { return size; }
+
+	private:
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#else
+		int fileDescriptor = -1;
+#endif
+	};
+}